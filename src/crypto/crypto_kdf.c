@@ -37,6 +37,10 @@ typedef struct {
   int (*EVP_PKEY_CTX_ctrl)(void* ctx, int keytype, int optype, int cmd, int p1, void* p2);
   int (*EVP_PKEY_CTX_ctrl_str)(void* ctx, const char* type, const char* value);
 
+  // scrypt (OpenSSL 1.1.0+)
+  int (*EVP_PBE_scrypt)(const char* pass, size_t passlen, const unsigned char* salt, size_t saltlen, uint64_t N,
+                        uint64_t r, uint64_t p, uint64_t maxmem, unsigned char* key, size_t keylen);
+
   // Hash functions for KDF
   const void* (*EVP_sha1)(void);
   const void* (*EVP_sha256)(void);
@@ -83,6 +87,9 @@ static bool load_kdf_functions(void) {
   openssl_kdf_funcs.EVP_PKEY_CTX_ctrl = JSRT_DLSYM(openssl_handle, "EVP_PKEY_CTX_ctrl");
   openssl_kdf_funcs.EVP_PKEY_CTX_ctrl_str = JSRT_DLSYM(openssl_handle, "EVP_PKEY_CTX_ctrl_str");
 
+  // Load scrypt (optional)
+  openssl_kdf_funcs.EVP_PBE_scrypt = JSRT_DLSYM(openssl_handle, "EVP_PBE_scrypt");
+
   kdf_funcs_loaded = true;
 
   bool hkdf_available = openssl_kdf_funcs.EVP_PKEY_CTX_new_id && openssl_kdf_funcs.EVP_PKEY_derive_init &&
@@ -291,12 +298,99 @@ int jsrt_crypto_hkdf_derive_key(jsrt_hkdf_params_t* params, const uint8_t* input
   return 0;
 }
 
+// scrypt key derivation
+int jsrt_crypto_scrypt_derive_key(jsrt_scrypt_params_t* params, const uint8_t* password, size_t password_length,
+                                  size_t key_length, uint8_t** derived_key) {
+  if (!load_kdf_functions() || !openssl_kdf_funcs.EVP_PBE_scrypt) {
+    JSRT_Debug("JSRT_Crypto_KDF: scrypt functions not available");
+    return -1;
+  }
+
+  *derived_key = malloc(key_length);
+  if (!*derived_key) {
+    JSRT_Debug("JSRT_Crypto_KDF: Failed to allocate scrypt output buffer");
+    return -1;
+  }
+
+  int result = openssl_kdf_funcs.EVP_PBE_scrypt((const char*)password, password_length, params->salt,
+                                                params->salt_length, params->cost, params->block_size,
+                                                params->parallel, params->maxmem, *derived_key, key_length);
+  if (result != 1) {
+    free(*derived_key);
+    *derived_key = NULL;
+    JSRT_Debug("JSRT_Crypto_KDF: scrypt derivation failed (N=%llu, r=%llu, p=%llu)",
+               (unsigned long long)params->cost, (unsigned long long)params->block_size,
+               (unsigned long long)params->parallel);
+    return -1;
+  }
+
+  return 0;
+}
+
+// Threadpool side of jsrt_crypto_kdf_async_operation_new: output_length carries the requested size in
+static int jsrt_crypto_kdf_async_work(JSRTCryptoAsyncOperation* op) {
+  jsrt_kdf_params_t* params = op->job_data;
+  size_t key_length = op->output_length;
+  int result = -1;
+
+  switch (params->algorithm) {
+    case JSRT_KDF_PBKDF2:
+      result = jsrt_crypto_pbkdf2_derive_key(&params->params.pbkdf2, op->input_data, op->input_length, key_length,
+                                             &op->output_data);
+      break;
+    case JSRT_KDF_HKDF:
+      result = jsrt_crypto_hkdf_derive_key(&params->params.hkdf, op->input_data, op->input_length, key_length,
+                                           &op->output_data);
+      break;
+    case JSRT_KDF_SCRYPT:
+      result = jsrt_crypto_scrypt_derive_key(&params->params.scrypt, op->input_data, op->input_length, key_length,
+                                             &op->output_data);
+      break;
+  }
+
+  return (result == 0 && op->output_data) ? 0 : -1;
+}
+
+static void jsrt_crypto_kdf_job_free(void* job_data) {
+  jsrt_crypto_kdf_params_free(job_data);
+}
+
+JSRTCryptoAsyncOperation* jsrt_crypto_kdf_async_operation_new(jsrt_kdf_params_t* params, const uint8_t* key_material,
+                                                              size_t key_material_length, size_t key_length) {
+  // Resolve the OpenSSL symbols here so threadpool threads only ever read them
+  load_kdf_functions();
+
+  JSRTCryptoAsyncOperation* op = jsrt_crypto_async_operation_new();
+  if (!op) {
+    jsrt_crypto_kdf_params_free(params);
+    return NULL;
+  }
+
+  op->operation_type = JSRT_CRYPTO_OP_DERIVE_BITS;
+  op->job_data = params;
+  op->free_job_data = jsrt_crypto_kdf_job_free;
+  op->work = jsrt_crypto_kdf_async_work;
+  op->output_length = key_length;
+  op->input_data = jsrt_crypto_copy_bytes(key_material, key_material_length);
+  op->input_length = key_material_length;
+  op->error_message = strdup(params->algorithm == JSRT_KDF_HKDF     ? "HKDF derivation failed"
+                             : params->algorithm == JSRT_KDF_SCRYPT ? "scrypt derivation failed"
+                                                                    : "Key derivation failed");
+  if (!op->input_data) {
+    jsrt_crypto_async_operation_free(op);
+    return NULL;
+  }
+  return op;
+}
+
 // Helper functions
 jsrt_kdf_algorithm_t jsrt_crypto_parse_kdf_algorithm(const char* algorithm_name) {
   if (strcmp(algorithm_name, "PBKDF2") == 0) {
     return JSRT_KDF_PBKDF2;
   } else if (strcmp(algorithm_name, "HKDF") == 0) {
     return JSRT_KDF_HKDF;
+  } else if (strcmp(algorithm_name, "scrypt") == 0) {
+    return JSRT_KDF_SCRYPT;
   } else {
     return (jsrt_kdf_algorithm_t)-1;  // Invalid
   }
@@ -308,6 +402,8 @@ const char* jsrt_crypto_kdf_algorithm_to_string(jsrt_kdf_algorithm_t alg) {
       return "PBKDF2";
     case JSRT_KDF_HKDF:
       return "HKDF";
+    case JSRT_KDF_SCRYPT:
+      return "scrypt";
     default:
       return "Unknown";
   }
@@ -320,6 +416,8 @@ bool jsrt_crypto_is_kdf_algorithm_supported(jsrt_kdf_algorithm_t alg) {
     case JSRT_KDF_HKDF:
       return load_kdf_functions() && openssl_kdf_funcs.EVP_PKEY_CTX_new_id && openssl_kdf_funcs.EVP_PKEY_derive_init &&
              openssl_kdf_funcs.EVP_PKEY_derive && openssl_kdf_funcs.EVP_PKEY_CTX_ctrl;
+    case JSRT_KDF_SCRYPT:
+      return load_kdf_functions() && openssl_kdf_funcs.EVP_PBE_scrypt != NULL;
     default:
       return false;
   }
@@ -335,6 +433,9 @@ void jsrt_crypto_kdf_params_free(jsrt_kdf_params_t* params) {
         free(params->params.hkdf.salt);
         free(params->params.hkdf.info);
         break;
+      case JSRT_KDF_SCRYPT:
+        free(params->params.scrypt.salt);
+        break;
     }
     free(params);
   }
@@ -9,7 +9,7 @@
 #include "crypto_subtle.h"
 
 // Key derivation algorithm types
-typedef enum { JSRT_KDF_PBKDF2 = 0, JSRT_KDF_HKDF } jsrt_kdf_algorithm_t;
+typedef enum { JSRT_KDF_PBKDF2 = 0, JSRT_KDF_HKDF, JSRT_KDF_SCRYPT } jsrt_kdf_algorithm_t;
 
 // PBKDF2 parameters
 typedef struct {
@@ -28,12 +28,23 @@ typedef struct {
   size_t info_length;                      // Info length
 } jsrt_hkdf_params_t;
 
+// scrypt parameters
+typedef struct {
+  uint8_t* salt;        // Salt value
+  size_t salt_length;   // Salt length
+  uint64_t cost;        // CPU/memory cost (N), power of two
+  uint64_t block_size;  // Block size (r)
+  uint64_t parallel;    // Parallelization (p)
+  uint64_t maxmem;      // Memory upper bound in bytes
+} jsrt_scrypt_params_t;
+
 // KDF parameters union
 typedef struct {
   jsrt_kdf_algorithm_t algorithm;
   union {
     jsrt_pbkdf2_params_t pbkdf2;
     jsrt_hkdf_params_t hkdf;
+    jsrt_scrypt_params_t scrypt;
   } params;
 } jsrt_kdf_params_t;
 
@@ -47,6 +58,15 @@ int jsrt_crypto_pbkdf2_derive_key(jsrt_pbkdf2_params_t* params, const uint8_t* p
 int jsrt_crypto_hkdf_derive_key(jsrt_hkdf_params_t* params, const uint8_t* input_key_material,
                                 size_t input_key_material_length, size_t key_length, uint8_t** derived_key);
 
+// scrypt key derivation (OpenSSL 1.1.0+)
+int jsrt_crypto_scrypt_derive_key(jsrt_scrypt_params_t* params, const uint8_t* password, size_t password_length,
+                                  size_t key_length, uint8_t** derived_key);
+
+// Threadpool derivation: takes ownership of params (heap allocated, salt/info included) and copies the
+// key material. Settles with an ArrayBuffer of key_length bytes unless op->complete is overridden.
+JSRTCryptoAsyncOperation* jsrt_crypto_kdf_async_operation_new(jsrt_kdf_params_t* params, const uint8_t* key_material,
+                                                              size_t key_material_length, size_t key_length);
+
 // Helper functions
 jsrt_kdf_algorithm_t jsrt_crypto_parse_kdf_algorithm(const char* algorithm_name);
 const char* jsrt_crypto_kdf_algorithm_to_string(jsrt_kdf_algorithm_t alg);
@@ -11,6 +11,7 @@
 #include <string.h>
 #include <uv.h>
 
+#include "../util/base64.h"
 #include "../util/debug.h"
 #include "crypto.h"
 #include "crypto_digest.h"
@@ -29,103 +30,6 @@ extern HMODULE openssl_handle;
 #define JSRT_DLSYM(handle, name) dlsym(handle, name)
 #endif
 
-// Base64URL encoding table (RFC 7515 - differs from standard Base64)
-static const char base64url_encode_table[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
-
-// Base64URL decoding table
-static const uint8_t base64url_decode_table[256] = {
-    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
-    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
-    255, 62,  255, 255, 52,  53,  54,  55,  56,  57,  58,  59,  60,  61,  255, 255, 255, 255, 255, 255, 255, 0,
-    1,   2,   3,   4,   5,   6,   7,   8,   9,   10,  11,  12,  13,  14,  15,  16,  17,  18,  19,  20,  21,  22,
-    23,  24,  25,  255, 255, 255, 255, 63,  255, 26,  27,  28,  29,  30,  31,  32,  33,  34,  35,  36,  37,  38,
-    39,  40,  41,  42,  43,  44,  45,  46,  47,  48,  49,  50,  51,  255, 255, 255, 255, 255, 255, 255, 255, 255,
-    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
-    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
-    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
-    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
-    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
-    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255};
-
-// Base64URL encode function (no padding)
-static char* base64url_encode(const uint8_t* input, size_t input_len, size_t* output_len) {
-  if (!input || input_len == 0) {
-    if (output_len)
-      *output_len = 0;
-    return NULL;
-  }
-
-  *output_len = 4 * ((input_len + 2) / 3);
-  char* output = malloc(*output_len + 1);
-  if (!output)
-    return NULL;
-
-  size_t j = 0;
-  for (size_t i = 0; i < input_len; i += 3) {
-    uint32_t octet_a = input[i];
-    uint32_t octet_b = (i + 1 < input_len) ? input[i + 1] : 0;
-    uint32_t octet_c = (i + 2 < input_len) ? input[i + 2] : 0;
-
-    uint32_t triple = (octet_a << 16) + (octet_b << 8) + octet_c;
-
-    output[j++] = base64url_encode_table[(triple >> 18) & 63];
-    output[j++] = base64url_encode_table[(triple >> 12) & 63];
-    if (i + 1 < input_len) {
-      output[j++] = base64url_encode_table[(triple >> 6) & 63];
-    }
-    if (i + 2 < input_len) {
-      output[j++] = base64url_encode_table[triple & 63];
-    }
-  }
-
-  *output_len = j;  // Actual length without padding
-  output[j] = '\0';
-  return output;
-}
-
-// Base64URL decode function (no padding expected)
-static uint8_t* base64url_decode(const char* input, size_t input_len, size_t* output_len) {
-  if (!input || input_len == 0) {
-    if (output_len)
-      *output_len = 0;
-    return NULL;
-  }
-
-  // Calculate output length
-  *output_len = input_len * 3 / 4;
-  if (input_len % 4 == 2)
-    *output_len += 1;
-  else if (input_len % 4 == 3)
-    *output_len += 2;
-
-  uint8_t* output = malloc(*output_len + 1);
-  if (!output)
-    return NULL;
-
-  size_t output_pos = 0;
-  uint32_t accumulator = 0;
-  int bits_accumulated = 0;
-
-  for (size_t i = 0; i < input_len; i++) {
-    uint8_t value = base64url_decode_table[(unsigned char)input[i]];
-    if (value == 255) {  // Invalid character
-      free(output);
-      return NULL;
-    }
-
-    accumulator = (accumulator << 6) | value;
-    bits_accumulated += 6;
-
-    if (bits_accumulated >= 8) {
-      output[output_pos++] = (accumulator >> (bits_accumulated - 8)) & 255;
-      bits_accumulated -= 8;
-    }
-  }
-
-  *output_len = output_pos;
-  return output;
-}
-
 // Algorithm name to enum mapping
 static const struct {
   const char* name;
@@ -272,12 +176,27 @@ JSRTCryptoAsyncOperation* jsrt_crypto_async_operation_new(void) {
   JSRTCryptoAsyncOperation* op = malloc(sizeof(JSRTCryptoAsyncOperation));
   if (op) {
     memset(op, 0, sizeof(JSRTCryptoAsyncOperation));
+    op->promise = JS_UNDEFINED;
+    op->resolve_func = JS_UNDEFINED;
+    op->reject_func = JS_UNDEFINED;
+    op->callback = JS_UNDEFINED;
+    op->retained = JS_UNDEFINED;
   }
   return op;
 }
 
 void jsrt_crypto_async_operation_free(JSRTCryptoAsyncOperation* op) {
   if (op) {
+    if (op->ctx) {
+      JS_FreeValue(op->ctx, op->promise);
+      JS_FreeValue(op->ctx, op->resolve_func);
+      JS_FreeValue(op->ctx, op->reject_func);
+      JS_FreeValue(op->ctx, op->callback);
+      JS_FreeValue(op->ctx, op->retained);
+    }
+    if (op->free_job_data) {
+      op->free_job_data(op->job_data);
+    }
     free(op->input_data);
     free(op->output_data);
     free(op->error_message);
@@ -288,6 +207,111 @@ void jsrt_crypto_async_operation_free(JSRTCryptoAsyncOperation* op) {
   }
 }
 
+uint8_t* jsrt_crypto_copy_bytes(const uint8_t* data, size_t length) {
+  // Always hand out a real allocation so empty inputs stay distinguishable from failures
+  uint8_t* copy = malloc(length > 0 ? length : 1);
+  if (copy && length > 0) {
+    memcpy(copy, data, length);
+  }
+  return copy;
+}
+
+static void jsrt_crypto_free_array_buffer(JSRuntime* rt, void* opaque, void* ptr) {
+  free(ptr);
+}
+
+// Threadpool side: only C memory owned by the operation is touched here
+static void jsrt_crypto_async_work(uv_work_t* req) {
+  JSRTCryptoAsyncOperation* op = (JSRTCryptoAsyncOperation*)req->data;
+  op->error_code = op->work(op);
+}
+
+// Loop side: build the result and settle the promise or invoke the callback
+static void jsrt_crypto_async_after_work(uv_work_t* req, int status) {
+  JSRTCryptoAsyncOperation* op = (JSRTCryptoAsyncOperation*)req->data;
+  JSContext* ctx = op->ctx;
+  JSRT_Runtime* rt = JS_GetContextOpaque(ctx);
+
+  JSValue error = JS_UNDEFINED;
+  JSValue value = JS_UNDEFINED;
+  if (status == UV_ECANCELED) {
+    error = jsrt_crypto_throw_error(ctx, "AbortError", "Operation was cancelled");
+  } else if (op->error_code != 0) {
+    error =
+        jsrt_crypto_throw_error(ctx, "OperationError", op->error_message ? op->error_message : "Operation failed");
+  } else if (op->complete) {
+    value = op->complete(ctx, op);
+    if (JS_IsException(value)) {
+      error = JS_GetException(ctx);
+      value = JS_UNDEFINED;
+    }
+  } else {
+    value = JS_NewArrayBuffer(ctx, op->output_data, op->output_length, jsrt_crypto_free_array_buffer, NULL, false);
+    op->output_data = NULL;
+  }
+
+  JSValue ret;
+  bool failed = !JS_IsUndefined(error);
+  if (!JS_IsUndefined(op->callback)) {
+    JSValue args[2] = {failed ? error : JS_NULL, value};
+    ret = JS_Call(ctx, op->callback, JS_UNDEFINED, failed ? 1 : 2, args);
+  } else {
+    ret = JS_Call(ctx, failed ? op->reject_func : op->resolve_func, JS_UNDEFINED, 1, failed ? &error : &value);
+  }
+  if (JS_IsException(ret)) {
+    JSRT_RuntimeAddExceptionValue(rt, JS_GetException(ctx));
+  }
+  JS_FreeValue(ctx, ret);
+  JS_FreeValue(ctx, error);
+  JS_FreeValue(ctx, value);
+
+  jsrt_crypto_async_operation_free(op);
+
+  // Promise reactions must run before the loop goes back to waiting
+  JSRT_RuntimeDrainMicrotasks(rt);
+}
+
+static int jsrt_crypto_async_submit(JSContext* ctx, JSRTCryptoAsyncOperation* op) {
+  JSRT_Runtime* rt = JS_GetContextOpaque(ctx);
+  op->work_req.data = op;
+  return uv_queue_work(rt->uv_loop, &op->work_req, jsrt_crypto_async_work, jsrt_crypto_async_after_work);
+}
+
+JSValue jsrt_crypto_async_queue(JSContext* ctx, JSRTCryptoAsyncOperation* op) {
+  op->ctx = ctx;
+
+  JSValue resolving_funcs[2];
+  JSValue promise = JS_NewPromiseCapability(ctx, resolving_funcs);
+  if (JS_IsException(promise)) {
+    jsrt_crypto_async_operation_free(op);
+    return promise;
+  }
+  op->resolve_func = resolving_funcs[0];
+  op->reject_func = resolving_funcs[1];
+
+  int r = jsrt_crypto_async_submit(ctx, op);
+  if (r != 0) {
+    JSValue error = jsrt_crypto_throw_error(ctx, "OperationError", uv_strerror(r));
+    JSValue ret = JS_Call(ctx, op->reject_func, JS_UNDEFINED, 1, &error);
+    JS_FreeValue(ctx, ret);
+    JS_FreeValue(ctx, error);
+    jsrt_crypto_async_operation_free(op);
+  }
+  return promise;
+}
+
+JSValue jsrt_crypto_async_queue_callback(JSContext* ctx, JSRTCryptoAsyncOperation* op, JSValueConst callback) {
+  op->ctx = ctx;
+  op->callback = JS_DupValue(ctx, callback);
+
+  int r = jsrt_crypto_async_submit(ctx, op);
+  if (r != 0) {
+    jsrt_crypto_async_operation_free(op);
+    return JS_ThrowInternalError(ctx, "failed to queue crypto work: %s", uv_strerror(r));
+  }
+  return JS_UNDEFINED;
+}
+
 // Create a resolved Promise with the given value
 static JSValue create_resolved_promise(JSContext* ctx, JSValue value) {
   JSValue global = JS_GetGlobalObject(ctx);
@@ -328,7 +352,187 @@ static JSValue create_rejected_promise(JSContext* ctx, JSValue error) {
   return promise;
 }
 
-// crypto.subtle.digest implementation - synchronous for now
+//==============================================================================
+// Threadpool jobs: inputs are copied off the JS heap before queueing
+//==============================================================================
+
+static int jsrt_subtle_digest_work(JSRTCryptoAsyncOperation* op) {
+  return jsrt_crypto_digest_data(op->algorithm, op->input_data, op->input_length, &op->output_data,
+                                 &op->output_length);
+}
+
+// AES-CBC/GCM/CTR: job_data is a jsrt_symmetric_params_t owning copies of key, IV, AAD and counter
+static int jsrt_subtle_symmetric_work(JSRTCryptoAsyncOperation* op) {
+  jsrt_symmetric_params_t* params = op->job_data;
+  if (op->operation_type == JSRT_CRYPTO_OP_ENCRYPT) {
+    return jsrt_crypto_aes_encrypt(params, op->input_data, op->input_length, &op->output_data, &op->output_length);
+  }
+  return jsrt_crypto_aes_decrypt(params, op->input_data, op->input_length, &op->output_data, &op->output_length);
+}
+
+static void jsrt_subtle_symmetric_job_free(void* job_data) {
+  jsrt_crypto_symmetric_params_free(job_data);
+}
+
+static JSValue jsrt_subtle_queue_symmetric(JSContext* ctx, int operation_type, const jsrt_symmetric_params_t* src,
+                                           const uint8_t* data, size_t data_size, const char* error_message) {
+  JSRTCryptoAsyncOperation* op = jsrt_crypto_async_operation_new();
+  jsrt_symmetric_params_t* params = calloc(1, sizeof(jsrt_symmetric_params_t));
+  if (!op || !params) {
+    jsrt_crypto_async_operation_free(op);
+    free(params);
+    JSValue error = jsrt_crypto_throw_error(ctx, "OperationError", "Memory allocation failed");
+    return create_rejected_promise(ctx, error);
+  }
+
+  op->operation_type = operation_type;
+  op->work = jsrt_subtle_symmetric_work;
+  op->job_data = params;
+  op->free_job_data = jsrt_subtle_symmetric_job_free;
+  op->error_message = strdup(error_message);
+
+  params->algorithm = src->algorithm;
+  params->key_length = src->key_length;
+  params->key_data = jsrt_crypto_copy_bytes(src->key_data, src->key_length);
+  bool copied = params->key_data != NULL;
+
+  switch (src->algorithm) {
+    case JSRT_SYMMETRIC_AES_CBC:
+      params->params.cbc.iv_length = src->params.cbc.iv_length;
+      params->params.cbc.iv = jsrt_crypto_copy_bytes(src->params.cbc.iv, src->params.cbc.iv_length);
+      copied = copied && params->params.cbc.iv;
+      break;
+    case JSRT_SYMMETRIC_AES_GCM:
+      params->params.gcm = src->params.gcm;
+      params->params.gcm.iv = jsrt_crypto_copy_bytes(src->params.gcm.iv, src->params.gcm.iv_length);
+      params->params.gcm.additional_data =
+          src->params.gcm.additional_data
+              ? jsrt_crypto_copy_bytes(src->params.gcm.additional_data, src->params.gcm.additional_data_length)
+              : NULL;
+      copied = copied && params->params.gcm.iv &&
+               (!src->params.gcm.additional_data || params->params.gcm.additional_data);
+      break;
+    case JSRT_SYMMETRIC_AES_CTR:
+      params->params.ctr = src->params.ctr;
+      params->params.ctr.counter = jsrt_crypto_copy_bytes(src->params.ctr.counter, src->params.ctr.counter_length);
+      copied = copied && params->params.ctr.counter;
+      break;
+  }
+
+  op->input_data = jsrt_crypto_copy_bytes(data, data_size);
+  op->input_length = data_size;
+  if (!copied || !op->input_data) {
+    jsrt_crypto_async_operation_free(op);
+    JSValue error = jsrt_crypto_throw_error(ctx, "OperationError", "Memory allocation failed");
+    return create_rejected_promise(ctx, error);
+  }
+
+  return jsrt_crypto_async_queue(ctx, op);
+}
+
+// RSA encrypt/decrypt/sign/verify: the job owns the EVP_PKEY and copies of label and signature
+typedef struct {
+  jsrt_rsa_params_t params;
+  uint8_t* signature;
+  size_t signature_length;
+  bool verified;
+} jsrt_subtle_rsa_job_t;
+
+static int jsrt_subtle_rsa_work(JSRTCryptoAsyncOperation* op) {
+  jsrt_subtle_rsa_job_t* job = op->job_data;
+  int result = -1;
+
+  switch (op->operation_type) {
+    case JSRT_CRYPTO_OP_ENCRYPT:
+      result = jsrt_crypto_rsa_encrypt(&job->params, op->input_data, op->input_length, &op->output_data,
+                                       &op->output_length);
+      break;
+    case JSRT_CRYPTO_OP_DECRYPT:
+      result = jsrt_crypto_rsa_decrypt(&job->params, op->input_data, op->input_length, &op->output_data,
+                                       &op->output_length);
+      break;
+    case JSRT_CRYPTO_OP_SIGN:
+      result =
+          jsrt_crypto_rsa_sign(&job->params, op->input_data, op->input_length, &op->output_data, &op->output_length);
+      break;
+    case JSRT_CRYPTO_OP_VERIFY:
+      // A bad signature resolves to false rather than rejecting
+      job->verified =
+          jsrt_crypto_rsa_verify(&job->params, op->input_data, op->input_length, job->signature, job->signature_length);
+      return 0;
+    default:
+      break;
+  }
+
+  return (result == 0 && op->output_data) ? 0 : -1;
+}
+
+static JSValue jsrt_subtle_rsa_verify_complete(JSContext* ctx, JSRTCryptoAsyncOperation* op) {
+  jsrt_subtle_rsa_job_t* job = op->job_data;
+  return JS_NewBool(ctx, job->verified);
+}
+
+static void jsrt_subtle_rsa_job_free(void* job_data) {
+  jsrt_subtle_rsa_job_t* job = job_data;
+  if (job) {
+    if (job->params.rsa_key) {
+      jsrt_evp_pkey_free_wrapper(job->params.rsa_key);
+    }
+    if (job->params.algorithm == JSRT_RSA_OAEP) {
+      free(job->params.params.oaep.label);
+    }
+    free(job->signature);
+    free(job);
+  }
+}
+
+// Takes ownership of params->rsa_key, also on failure
+static JSValue jsrt_subtle_queue_rsa(JSContext* ctx, int operation_type, const jsrt_rsa_params_t* params,
+                                     const uint8_t* data, size_t data_size, const uint8_t* signature,
+                                     size_t signature_size, const char* error_message) {
+  JSRTCryptoAsyncOperation* op = jsrt_crypto_async_operation_new();
+  jsrt_subtle_rsa_job_t* job = calloc(1, sizeof(jsrt_subtle_rsa_job_t));
+  if (!op || !job) {
+    jsrt_crypto_async_operation_free(op);
+    free(job);
+    jsrt_evp_pkey_free_wrapper(params->rsa_key);
+    JSValue error = jsrt_crypto_throw_error(ctx, "OperationError", "Memory allocation failed");
+    return create_rejected_promise(ctx, error);
+  }
+
+  op->operation_type = operation_type;
+  op->work = jsrt_subtle_rsa_work;
+  op->complete = operation_type == JSRT_CRYPTO_OP_VERIFY ? jsrt_subtle_rsa_verify_complete : NULL;
+  op->job_data = job;
+  op->free_job_data = jsrt_subtle_rsa_job_free;
+  op->error_message = strdup(error_message);
+
+  job->params = *params;
+  bool copied = true;
+  if (params->algorithm == JSRT_RSA_OAEP) {
+    job->params.params.oaep.label =
+        params->params.oaep.label ? jsrt_crypto_copy_bytes(params->params.oaep.label, params->params.oaep.label_length)
+                                  : NULL;
+    copied = !params->params.oaep.label || job->params.params.oaep.label;
+  }
+  if (signature) {
+    job->signature = jsrt_crypto_copy_bytes(signature, signature_size);
+    job->signature_length = signature_size;
+    copied = copied && job->signature;
+  }
+
+  op->input_data = jsrt_crypto_copy_bytes(data, data_size);
+  op->input_length = data_size;
+  if (!copied || !op->input_data) {
+    jsrt_crypto_async_operation_free(op);
+    JSValue error = jsrt_crypto_throw_error(ctx, "OperationError", "Memory allocation failed");
+    return create_rejected_promise(ctx, error);
+  }
+
+  return jsrt_crypto_async_queue(ctx, op);
+}
+
+// crypto.subtle.digest implementation - hashing runs on the libuv threadpool
 JSValue jsrt_subtle_digest(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
   if (argc < 2) {
     JSValue error = jsrt_crypto_throw_error(ctx, "TypeError", "digest requires 2 arguments");
@@ -385,22 +589,23 @@ JSValue jsrt_subtle_digest(JSContext* ctx, JSValueConst this_val, int argc, JSVa
     return create_rejected_promise(ctx, error);
   }
 
-  // Perform digest operation synchronously
-  uint8_t* digest_output;
-  size_t digest_length;
-
-  int digest_result = jsrt_crypto_digest_data(alg, data, data_size, &digest_output, &digest_length);
-
-  if (digest_result != 0) {
-    JSValue error = jsrt_crypto_throw_error(ctx, "OperationError", "Digest operation failed");
+  // Hash a private copy on the threadpool so the caller may reuse its buffer immediately
+  JSRTCryptoAsyncOperation* op = jsrt_crypto_async_operation_new();
+  if (op) {
+    op->operation_type = JSRT_CRYPTO_OP_DIGEST;
+    op->algorithm = alg;
+    op->work = jsrt_subtle_digest_work;
+    op->error_message = strdup("Digest operation failed");
+    op->input_data = jsrt_crypto_copy_bytes(data, data_size);
+    op->input_length = data_size;
+  }
+  if (!op || !op->input_data) {
+    jsrt_crypto_async_operation_free(op);
+    JSValue error = jsrt_crypto_throw_error(ctx, "OperationError", "Memory allocation failed");
     return create_rejected_promise(ctx, error);
   }
 
-  // Create result ArrayBuffer
-  JSValue result = JS_NewArrayBuffer(ctx, digest_output, digest_length, NULL, NULL, 0);
-
-  // Return resolved promise
-  return create_resolved_promise(ctx, result);
+  return jsrt_crypto_async_queue(ctx, op);
 }
 
 // crypto.subtle.encrypt implementation
@@ -546,24 +751,16 @@ JSValue jsrt_subtle_encrypt(JSContext* ctx, JSValueConst this_val, int argc, JSV
     params->params.cbc.iv = iv_data;
     params->params.cbc.iv_length = iv_size;
 
-    // Perform encryption
-    uint8_t* ciphertext_data;
-    size_t ciphertext_size;
-    int result = jsrt_crypto_aes_encrypt(params, plaintext_data, plaintext_size, &ciphertext_data, &ciphertext_size);
+    // Run the cipher on the threadpool; key, parameters and data are copied first
+    JSValue promise = jsrt_subtle_queue_symmetric(ctx, JSRT_CRYPTO_OP_ENCRYPT, params, plaintext_data, plaintext_size,
+                                                  "Encryption operation failed");
 
     // Clean up
     free(params);
     JS_FreeValue(ctx, key_data_val);
     JS_FreeValue(ctx, iv_val);
 
-    if (result != 0) {
-      JSValue error = jsrt_crypto_throw_error(ctx, "OperationError", "Encryption operation failed");
-      return create_rejected_promise(ctx, error);
-    }
-
-    // Create result ArrayBuffer
-    JSValue result_buffer = JS_NewArrayBuffer(ctx, ciphertext_data, ciphertext_size, NULL, NULL, 0);
-    return create_resolved_promise(ctx, result_buffer);
+    return promise;
   }
 
   // For AES-GCM, get IV and optional additionalData from algorithm parameters
@@ -680,10 +877,9 @@ JSValue jsrt_subtle_encrypt(JSContext* ctx, JSValueConst this_val, int argc, JSV
     params->params.gcm.additional_data_length = additional_data_size;
     params->params.gcm.tag_length = tag_length;
 
-    // Perform encryption
-    uint8_t* ciphertext_data;
-    size_t ciphertext_size;
-    int result = jsrt_crypto_aes_encrypt(params, plaintext_data, plaintext_size, &ciphertext_data, &ciphertext_size);
+    // Run the cipher on the threadpool; key, parameters and data are copied first
+    JSValue promise = jsrt_subtle_queue_symmetric(ctx, JSRT_CRYPTO_OP_ENCRYPT, params, plaintext_data, plaintext_size,
+                                                  "Encryption operation failed");
 
     // Clean up
     free(params);
@@ -692,14 +888,7 @@ JSValue jsrt_subtle_encrypt(JSContext* ctx, JSValueConst this_val, int argc, JSV
     JS_FreeValue(ctx, additionalData_val);
     JS_FreeValue(ctx, tagLength_val);
 
-    if (result != 0) {
-      JSValue error = jsrt_crypto_throw_error(ctx, "OperationError", "Encryption operation failed");
-      return create_rejected_promise(ctx, error);
-    }
-
-    // Create result ArrayBuffer
-    JSValue result_buffer = JS_NewArrayBuffer(ctx, ciphertext_data, ciphertext_size, NULL, NULL, 0);
-    return create_resolved_promise(ctx, result_buffer);
+    return promise;
   }
 
   // For AES-CTR, get counter from algorithm parameters
@@ -768,24 +957,16 @@ JSValue jsrt_subtle_encrypt(JSContext* ctx, JSValueConst this_val, int argc, JSV
     params->params.ctr.counter_length = counter_size;
     params->params.ctr.length = counter_length_bits;
 
-    // Perform encryption
-    uint8_t* ciphertext_data;
-    size_t ciphertext_size;
-    int result = jsrt_crypto_aes_encrypt(params, plaintext_data, plaintext_size, &ciphertext_data, &ciphertext_size);
+    // Run the cipher on the threadpool; key, parameters and data are copied first
+    JSValue promise = jsrt_subtle_queue_symmetric(ctx, JSRT_CRYPTO_OP_ENCRYPT, params, plaintext_data, plaintext_size,
+                                                  "Encryption operation failed");
 
     // Clean up
     free(params);
     JS_FreeValue(ctx, key_data_val);
     JS_FreeValue(ctx, counter_val);
 
-    if (result != 0) {
-      JSValue error = jsrt_crypto_throw_error(ctx, "OperationError", "Encryption operation failed");
-      return create_rejected_promise(ctx, error);
-    }
-
-    // Create result ArrayBuffer
-    JSValue result_buffer = JS_NewArrayBuffer(ctx, ciphertext_data, ciphertext_size, NULL, NULL, 0);
-    return create_resolved_promise(ctx, result_buffer);
+    return promise;
   }
 
   // RSA-OAEP encryption
@@ -870,10 +1051,9 @@ JSValue jsrt_subtle_encrypt(JSContext* ctx, JSValueConst this_val, int argc, JSV
     params.params.oaep.label = label_data;
     params.params.oaep.label_length = label_size;
 
-    // Perform RSA encryption
-    uint8_t* ciphertext_data = NULL;
-    size_t ciphertext_size = 0;
-    int result = jsrt_crypto_rsa_encrypt(&params, plaintext_data, plaintext_size, &ciphertext_data, &ciphertext_size);
+    // Run RSA on the threadpool; the job takes over rsa_key and copies label and data
+    JSValue promise = jsrt_subtle_queue_rsa(ctx, JSRT_CRYPTO_OP_ENCRYPT, &params, plaintext_data, plaintext_size,
+                                            NULL, 0, "RSA encryption failed");
 
     // Cleanup
     JS_FreeCString(ctx, hash_name);
@@ -881,24 +1061,7 @@ JSValue jsrt_subtle_encrypt(JSContext* ctx, JSValueConst this_val, int argc, JSV
     JS_FreeValue(ctx, label_val);
     JS_FreeValue(ctx, key_data_val);
 
-    // Free the created EVP_PKEY
-    if (rsa_key) {
-      if (openssl_handle) {
-        void (*EVP_PKEY_free)(void*) = JSRT_DLSYM(openssl_handle, "EVP_PKEY_free");
-        if (EVP_PKEY_free) {
-          EVP_PKEY_free(rsa_key);
-        }
-      }
-    }
-
-    if (result != 0 || !ciphertext_data) {
-      JSValue error = jsrt_crypto_throw_error(ctx, "OperationError", "RSA encryption failed");
-      return create_rejected_promise(ctx, error);
-    }
-
-    // Create result ArrayBuffer
-    JSValue result_buffer = JS_NewArrayBuffer(ctx, ciphertext_data, ciphertext_size, NULL, NULL, 0);
-    return create_resolved_promise(ctx, result_buffer);
+    return promise;
   }
 
   // RSA-PKCS1-v1_5 encryption
@@ -917,37 +1080,14 @@ JSValue jsrt_subtle_encrypt(JSContext* ctx, JSValueConst this_val, int argc, JSV
     params.hash_algorithm = JSRT_RSA_HASH_SHA256;  // Default hash (not used for PKCS1 v1.5 encryption)
     params.rsa_key = rsa_key;
 
-    // Perform RSA encryption
-    uint8_t* ciphertext_data = NULL;
-    size_t ciphertext_size = 0;
-    int result = jsrt_crypto_rsa_encrypt(&params, plaintext_data, plaintext_size, &ciphertext_data, &ciphertext_size);
+    // Run RSA on the threadpool; the job takes over rsa_key and copies label and data
+    JSValue promise = jsrt_subtle_queue_rsa(ctx, JSRT_CRYPTO_OP_ENCRYPT, &params, plaintext_data, plaintext_size,
+                                            NULL, 0, "RSA-PKCS1-v1_5 encryption failed");
 
     // Cleanup
     JS_FreeValue(ctx, key_data_val);
 
-    // Free the created EVP_PKEY
-    if (rsa_key) {
-#ifdef _WIN32
-      extern HMODULE openssl_handle;
-#else
-      extern void* openssl_handle;
-#endif
-      if (openssl_handle) {
-        void (*EVP_PKEY_free)(void*) = JSRT_DLSYM(openssl_handle, "EVP_PKEY_free");
-        if (EVP_PKEY_free) {
-          EVP_PKEY_free(rsa_key);
-        }
-      }
-    }
-
-    if (result != 0 || !ciphertext_data) {
-      JSValue error = jsrt_crypto_throw_error(ctx, "OperationError", "RSA-PKCS1-v1_5 encryption failed");
-      return create_rejected_promise(ctx, error);
-    }
-
-    // Return the ciphertext as ArrayBuffer
-    JSValue result_buffer = JS_NewArrayBuffer(ctx, ciphertext_data, ciphertext_size, NULL, NULL, 0);
-    return create_resolved_promise(ctx, result_buffer);
+    return promise;
   }
 
   JS_FreeValue(ctx, key_data_val);
@@ -1097,24 +1237,16 @@ JSValue jsrt_subtle_decrypt(JSContext* ctx, JSValueConst this_val, int argc, JSV
     params->params.cbc.iv = iv_data;
     params->params.cbc.iv_length = iv_size;
 
-    // Perform decryption
-    uint8_t* plaintext_data;
-    size_t plaintext_size;
-    int result = jsrt_crypto_aes_decrypt(params, ciphertext_data, ciphertext_size, &plaintext_data, &plaintext_size);
+    // Run the cipher on the threadpool; key, parameters and data are copied first
+    JSValue promise = jsrt_subtle_queue_symmetric(ctx, JSRT_CRYPTO_OP_DECRYPT, params, ciphertext_data, ciphertext_size,
+                                                  "Decryption operation failed");
 
     // Clean up
     free(params);
     JS_FreeValue(ctx, key_data_val);
     JS_FreeValue(ctx, iv_val);
 
-    if (result != 0) {
-      JSValue error = jsrt_crypto_throw_error(ctx, "OperationError", "Decryption operation failed");
-      return create_rejected_promise(ctx, error);
-    }
-
-    // Create result ArrayBuffer
-    JSValue result_buffer = JS_NewArrayBuffer(ctx, plaintext_data, plaintext_size, NULL, NULL, 0);
-    return create_resolved_promise(ctx, result_buffer);
+    return promise;
   }
 
   // For AES-GCM, get IV and optional additionalData from algorithm parameters
@@ -1231,10 +1363,9 @@ JSValue jsrt_subtle_decrypt(JSContext* ctx, JSValueConst this_val, int argc, JSV
     params->params.gcm.additional_data_length = additional_data_size;
     params->params.gcm.tag_length = tag_length;
 
-    // Perform decryption
-    uint8_t* plaintext_data;
-    size_t plaintext_size;
-    int result = jsrt_crypto_aes_decrypt(params, ciphertext_data, ciphertext_size, &plaintext_data, &plaintext_size);
+    // Run the cipher on the threadpool; key, parameters and data are copied first
+    JSValue promise = jsrt_subtle_queue_symmetric(ctx, JSRT_CRYPTO_OP_DECRYPT, params, ciphertext_data, ciphertext_size,
+                                                  "Decryption operation failed");
 
     // Clean up
     free(params);
@@ -1243,14 +1374,7 @@ JSValue jsrt_subtle_decrypt(JSContext* ctx, JSValueConst this_val, int argc, JSV
     JS_FreeValue(ctx, additionalData_val);
     JS_FreeValue(ctx, tagLength_val);
 
-    if (result != 0) {
-      JSValue error = jsrt_crypto_throw_error(ctx, "OperationError", "Decryption operation failed");
-      return create_rejected_promise(ctx, error);
-    }
-
-    // Create result ArrayBuffer
-    JSValue result_buffer = JS_NewArrayBuffer(ctx, plaintext_data, plaintext_size, NULL, NULL, 0);
-    return create_resolved_promise(ctx, result_buffer);
+    return promise;
   }
 
   // For AES-CTR, get counter from algorithm parameters
@@ -1319,24 +1443,16 @@ JSValue jsrt_subtle_decrypt(JSContext* ctx, JSValueConst this_val, int argc, JSV
     params->params.ctr.counter_length = counter_size;
     params->params.ctr.length = counter_length_bits;
 
-    // Perform decryption
-    uint8_t* plaintext_data;
-    size_t plaintext_size;
-    int result = jsrt_crypto_aes_decrypt(params, ciphertext_data, ciphertext_size, &plaintext_data, &plaintext_size);
+    // Run the cipher on the threadpool; key, parameters and data are copied first
+    JSValue promise = jsrt_subtle_queue_symmetric(ctx, JSRT_CRYPTO_OP_DECRYPT, params, ciphertext_data, ciphertext_size,
+                                                  "Decryption operation failed");
 
     // Clean up
     free(params);
     JS_FreeValue(ctx, key_data_val);
     JS_FreeValue(ctx, counter_val);
 
-    if (result != 0) {
-      JSValue error = jsrt_crypto_throw_error(ctx, "OperationError", "Decryption operation failed");
-      return create_rejected_promise(ctx, error);
-    }
-
-    // Create result ArrayBuffer
-    JSValue result_buffer = JS_NewArrayBuffer(ctx, plaintext_data, plaintext_size, NULL, NULL, 0);
-    return create_resolved_promise(ctx, result_buffer);
+    return promise;
   }
 
   // RSA-OAEP decryption
@@ -1421,10 +1537,9 @@ JSValue jsrt_subtle_decrypt(JSContext* ctx, JSValueConst this_val, int argc, JSV
     params.params.oaep.label = label_data;
     params.params.oaep.label_length = label_size;
 
-    // Perform RSA decryption
-    uint8_t* plaintext_data = NULL;
-    size_t plaintext_size = 0;
-    int result = jsrt_crypto_rsa_decrypt(&params, ciphertext_data, ciphertext_size, &plaintext_data, &plaintext_size);
+    // Run RSA on the threadpool; the job takes over rsa_key and copies label and data
+    JSValue promise = jsrt_subtle_queue_rsa(ctx, JSRT_CRYPTO_OP_DECRYPT, &params, ciphertext_data, ciphertext_size,
+                                            NULL, 0, "RSA decryption failed");
 
     // Cleanup
     JS_FreeCString(ctx, hash_name);
@@ -1432,24 +1547,7 @@ JSValue jsrt_subtle_decrypt(JSContext* ctx, JSValueConst this_val, int argc, JSV
     JS_FreeValue(ctx, label_val);
     JS_FreeValue(ctx, key_data_val);
 
-    // Free the created EVP_PKEY
-    if (rsa_key) {
-      if (openssl_handle) {
-        void (*EVP_PKEY_free)(void*) = JSRT_DLSYM(openssl_handle, "EVP_PKEY_free");
-        if (EVP_PKEY_free) {
-          EVP_PKEY_free(rsa_key);
-        }
-      }
-    }
-
-    if (result != 0 || !plaintext_data) {
-      JSValue error = jsrt_crypto_throw_error(ctx, "OperationError", "RSA decryption failed");
-      return create_rejected_promise(ctx, error);
-    }
-
-    // Create result ArrayBuffer
-    JSValue result_buffer = JS_NewArrayBuffer(ctx, plaintext_data, plaintext_size, NULL, NULL, 0);
-    return create_resolved_promise(ctx, result_buffer);
+    return promise;
   }
 
   // RSA-PKCS1-v1_5 decryption
@@ -1468,37 +1566,14 @@ JSValue jsrt_subtle_decrypt(JSContext* ctx, JSValueConst this_val, int argc, JSV
     params.hash_algorithm = JSRT_RSA_HASH_SHA256;  // Default hash (not used for PKCS1 v1.5 encryption)
     params.rsa_key = rsa_key;
 
-    // Perform RSA decryption
-    uint8_t* plaintext_data = NULL;
-    size_t plaintext_size = 0;
-    int result = jsrt_crypto_rsa_decrypt(&params, ciphertext_data, ciphertext_size, &plaintext_data, &plaintext_size);
+    // Run RSA on the threadpool; the job takes over rsa_key and copies label and data
+    JSValue promise = jsrt_subtle_queue_rsa(ctx, JSRT_CRYPTO_OP_DECRYPT, &params, ciphertext_data, ciphertext_size,
+                                            NULL, 0, "RSA-PKCS1-v1_5 decryption failed");
 
     // Cleanup
     JS_FreeValue(ctx, key_data_val);
 
-    // Free the created EVP_PKEY
-    if (rsa_key) {
-#ifdef _WIN32
-      extern HMODULE openssl_handle;
-#else
-      extern void* openssl_handle;
-#endif
-      if (openssl_handle) {
-        void (*EVP_PKEY_free)(void*) = JSRT_DLSYM(openssl_handle, "EVP_PKEY_free");
-        if (EVP_PKEY_free) {
-          EVP_PKEY_free(rsa_key);
-        }
-      }
-    }
-
-    if (result != 0 || !plaintext_data) {
-      JSValue error = jsrt_crypto_throw_error(ctx, "OperationError", "RSA-PKCS1-v1_5 decryption failed");
-      return create_rejected_promise(ctx, error);
-    }
-
-    // Create result ArrayBuffer
-    JSValue result_buffer = JS_NewArrayBuffer(ctx, plaintext_data, plaintext_size, NULL, NULL, 0);
-    return create_resolved_promise(ctx, result_buffer);
+    return promise;
   }
 
   JS_FreeValue(ctx, key_data_val);
@@ -1659,33 +1734,12 @@ JSValue jsrt_subtle_sign(JSContext* ctx, JSValueConst this_val, int argc, JSValu
     params.rsa_key = rsa_private_key;
     params.hash_algorithm = JSRT_RSA_HASH_SHA256;  // Default to SHA-256
 
-    // Perform RSA signature
-    uint8_t* signature_data = NULL;
-    size_t signature_size = 0;
-    int sign_result = jsrt_crypto_rsa_sign(&params, data, data_size, &signature_data, &signature_size);
-
-    // Cleanup the RSA key
-    if (rsa_private_key) {
-      // Note: Need to add proper OpenSSL EVP_PKEY_free here
-
-      if (openssl_handle) {
-        void (*EVP_PKEY_free)(void* pkey) = JSRT_DLSYM(openssl_handle, "EVP_PKEY_free");
-        if (EVP_PKEY_free) {
-          EVP_PKEY_free(rsa_private_key);
-        }
-      }
-    }
+    // Sign on the threadpool; the job takes over rsa_private_key
+    JSValue promise = jsrt_subtle_queue_rsa(ctx, JSRT_CRYPTO_OP_SIGN, &params, data, data_size, NULL, 0,
+                                            "RSA signature failed");
 
     JS_FreeValue(ctx, key_data_val);
-
-    if (sign_result != 0 || !signature_data) {
-      JSValue error = jsrt_crypto_throw_error(ctx, "OperationError", "RSA signature failed");
-      return create_rejected_promise(ctx, error);
-    }
-
-    // Create result ArrayBuffer
-    JSValue result_buffer = JS_NewArrayBuffer(ctx, signature_data, signature_size, NULL, NULL, 0);
-    return create_resolved_promise(ctx, result_buffer);
+    return promise;
   }
 
   // RSA-PSS signature
@@ -1721,31 +1775,12 @@ JSValue jsrt_subtle_sign(JSContext* ctx, JSValueConst this_val, int argc, JSValu
     }
     JS_FreeValue(ctx, salt_length_val);
 
-    // Perform RSA-PSS signature
-    uint8_t* signature_data = NULL;
-    size_t signature_size = 0;
-    int sign_result = jsrt_crypto_rsa_sign(&params, data, data_size, &signature_data, &signature_size);
-
-    // Cleanup the RSA key
-    if (rsa_private_key) {
-      if (openssl_handle) {
-        void (*EVP_PKEY_free)(void* pkey) = JSRT_DLSYM(openssl_handle, "EVP_PKEY_free");
-        if (EVP_PKEY_free) {
-          EVP_PKEY_free(rsa_private_key);
-        }
-      }
-    }
+    // Sign on the threadpool; the job takes over rsa_private_key
+    JSValue promise = jsrt_subtle_queue_rsa(ctx, JSRT_CRYPTO_OP_SIGN, &params, data, data_size, NULL, 0,
+                                            "RSA-PSS signature failed");
 
     JS_FreeValue(ctx, key_data_val);
-
-    if (sign_result != 0 || !signature_data) {
-      JSValue error = jsrt_crypto_throw_error(ctx, "OperationError", "RSA-PSS signature failed");
-      return create_rejected_promise(ctx, error);
-    }
-
-    // Create result ArrayBuffer
-    JSValue result_buffer = JS_NewArrayBuffer(ctx, signature_data, signature_size, NULL, NULL, 0);
-    return create_resolved_promise(ctx, result_buffer);
+    return promise;
   }
 
   // ECDSA signature
@@ -1986,24 +2021,12 @@ JSValue jsrt_subtle_verify(JSContext* ctx, JSValueConst this_val, int argc, JSVa
     params.rsa_key = rsa_public_key;
     params.hash_algorithm = JSRT_RSA_HASH_SHA256;  // Default to SHA-256
 
-    // Perform RSA signature verification
-    bool verification_result = jsrt_crypto_rsa_verify(&params, data, data_size, signature_data, signature_size);
-
-    // Cleanup the RSA key
-    if (rsa_public_key) {
-      if (openssl_handle) {
-        void (*EVP_PKEY_free)(void* pkey) = JSRT_DLSYM(openssl_handle, "EVP_PKEY_free");
-        if (EVP_PKEY_free) {
-          EVP_PKEY_free(rsa_public_key);
-        }
-      }
-    }
+    // Verify on the threadpool; the job takes over rsa_public_key and copies the signature
+    JSValue promise = jsrt_subtle_queue_rsa(ctx, JSRT_CRYPTO_OP_VERIFY, &params, data, data_size, signature_data,
+                                            signature_size, "RSA verification failed");
 
     JS_FreeValue(ctx, key_data_val);
-
-    // Return verification result as boolean
-    JSValue result_bool = JS_NewBool(ctx, verification_result);
-    return create_resolved_promise(ctx, result_bool);
+    return promise;
   }
 
   // RSA-PSS signature verification
@@ -2036,24 +2059,12 @@ JSValue jsrt_subtle_verify(JSContext* ctx, JSValueConst this_val, int argc, JSVa
     }
     JS_FreeValue(ctx, salt_length_val);
 
-    // Perform RSA-PSS signature verification
-    bool verification_result = jsrt_crypto_rsa_verify(&params, data, data_size, signature_data, signature_size);
-
-    // Cleanup the RSA key
-    if (rsa_public_key) {
-      if (openssl_handle) {
-        void (*EVP_PKEY_free)(void* pkey) = JSRT_DLSYM(openssl_handle, "EVP_PKEY_free");
-        if (EVP_PKEY_free) {
-          EVP_PKEY_free(rsa_public_key);
-        }
-      }
-    }
+    // Verify on the threadpool; the job takes over rsa_public_key and copies the signature
+    JSValue promise = jsrt_subtle_queue_rsa(ctx, JSRT_CRYPTO_OP_VERIFY, &params, data, data_size, signature_data,
+                                            signature_size, "RSA-PSS verification failed");
 
     JS_FreeValue(ctx, key_data_val);
-
-    // Return verification result as boolean
-    JSValue result_bool = JS_NewBool(ctx, verification_result);
-    return create_resolved_promise(ctx, result_bool);
+    return promise;
   }
 
   // ECDSA verification
@@ -2118,6 +2129,107 @@ JSValue jsrt_subtle_verify(JSContext* ctx, JSValueConst this_val, int argc, JSVa
   return create_rejected_promise(ctx, error);
 }
 
+// RSA key generation: the job produces DER encodings, the CryptoKeyPair is built back on the loop
+typedef struct {
+  jsrt_crypto_algorithm_t algorithm;
+  int32_t modulus_length;
+  uint32_t public_exponent;
+  jsrt_rsa_hash_algorithm_t hash_algorithm;
+  bool extractable;
+  uint8_t* public_key_data;
+  size_t public_key_size;
+  uint8_t* private_key_data;
+  size_t private_key_size;
+} jsrt_subtle_rsa_keygen_job_t;
+
+static int jsrt_subtle_rsa_keygen_work(JSRTCryptoAsyncOperation* op) {
+  jsrt_subtle_rsa_keygen_job_t* job = op->job_data;
+
+  jsrt_rsa_keypair_t* keypair = NULL;
+  int result =
+      jsrt_crypto_generate_rsa_keypair(job->modulus_length, job->public_exponent, job->hash_algorithm, &keypair);
+  if (result != 0 || !keypair) {
+    return -1;
+  }
+
+  result = jsrt_crypto_rsa_extract_public_key_data(keypair->public_key, &job->public_key_data, &job->public_key_size);
+  if (result == 0) {
+    result =
+        jsrt_crypto_rsa_extract_private_key_data(keypair->private_key, &job->private_key_data, &job->private_key_size);
+  }
+  jsrt_crypto_rsa_keypair_free(keypair);
+
+  if (result != 0) {
+    free(op->error_message);
+    op->error_message = strdup("Failed to extract RSA key data");
+    return -1;
+  }
+  return 0;
+}
+
+// op->retained holds the usages array passed to generateKey
+static JSValue jsrt_subtle_rsa_keygen_complete(JSContext* ctx, JSRTCryptoAsyncOperation* op) {
+  jsrt_subtle_rsa_keygen_job_t* job = op->job_data;
+  uint32_t public_exponent = job->public_exponent;
+
+  // Create CryptoKeyPair object
+  JSValue keypair_obj = JS_NewObject(ctx);
+
+  // Create public key object
+  JSValue public_key_obj = JS_NewObject(ctx);
+  JS_SetPropertyStr(ctx, public_key_obj, "type", JS_NewString(ctx, "public"));
+  JS_SetPropertyStr(ctx, public_key_obj, "extractable", JS_NewBool(ctx, true));  // Public keys are always extractable
+  JS_SetPropertyStr(ctx, public_key_obj, "usages", JS_DupValue(ctx, op->retained));
+
+  // Set algorithm info for public key
+  JSValue public_alg_obj = JS_NewObject(ctx);
+  JS_SetPropertyStr(ctx, public_alg_obj, "name", JS_NewString(ctx, jsrt_crypto_algorithm_to_string(job->algorithm)));
+  JS_SetPropertyStr(ctx, public_alg_obj, "modulusLength", JS_NewInt32(ctx, job->modulus_length));
+
+  // Set public exponent as Uint8Array
+  JSValue exp_array = JS_NewArrayBufferCopy(ctx, (uint8_t*)&public_exponent, 4);
+  JS_SetPropertyStr(ctx, public_alg_obj, "publicExponent", exp_array);
+
+  JSValue hash_obj = JS_NewObject(ctx);
+  JS_SetPropertyStr(ctx, hash_obj, "name",
+                    JS_NewString(ctx, jsrt_crypto_rsa_hash_algorithm_to_string(job->hash_algorithm)));
+  JS_SetPropertyStr(ctx, public_alg_obj, "hash", hash_obj);
+
+  JS_SetPropertyStr(ctx, public_key_obj, "algorithm", public_alg_obj);
+
+  // Store the raw key data
+  JSValue public_key_buffer = JS_NewArrayBufferCopy(ctx, job->public_key_data, job->public_key_size);
+  JS_SetPropertyStr(ctx, public_key_obj, "__keyData", public_key_buffer);
+
+  // Create private key object
+  JSValue private_key_obj = JS_NewObject(ctx);
+  JS_SetPropertyStr(ctx, private_key_obj, "type", JS_NewString(ctx, "private"));
+  JS_SetPropertyStr(ctx, private_key_obj, "extractable", JS_NewBool(ctx, job->extractable));
+  JS_SetPropertyStr(ctx, private_key_obj, "usages", JS_DupValue(ctx, op->retained));
+
+  // Set algorithm info for private key (same as public key)
+  JS_SetPropertyStr(ctx, private_key_obj, "algorithm", JS_DupValue(ctx, public_alg_obj));
+
+  // Store the raw key data
+  JSValue private_key_buffer = JS_NewArrayBufferCopy(ctx, job->private_key_data, job->private_key_size);
+  JS_SetPropertyStr(ctx, private_key_obj, "__keyData", private_key_buffer);
+
+  // Set the key pair
+  JS_SetPropertyStr(ctx, keypair_obj, "publicKey", public_key_obj);
+  JS_SetPropertyStr(ctx, keypair_obj, "privateKey", private_key_obj);
+
+  return keypair_obj;
+}
+
+static void jsrt_subtle_rsa_keygen_job_free(void* job_data) {
+  jsrt_subtle_rsa_keygen_job_t* job = job_data;
+  if (job) {
+    free(job->public_key_data);
+    free(job->private_key_data);
+    free(job);
+  }
+}
+
 JSValue jsrt_subtle_generateKey(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
   if (argc < 3) {
     JSValue error = jsrt_crypto_throw_error(ctx, "TypeError", "generateKey requires 3 arguments");
@@ -2282,80 +2394,34 @@ JSValue jsrt_subtle_generateKey(JSContext* ctx, JSValueConst this_val, int argc,
       return create_rejected_promise(ctx, error);
     }
 
-    // Generate RSA key pair
-    jsrt_rsa_keypair_t* keypair = NULL;
-    int result = jsrt_crypto_generate_rsa_keypair(modulus_length, public_exponent, hash_alg, &keypair);
-
     JS_FreeCString(ctx, hash_name);
     JS_FreeValue(ctx, hash_val);
 
-    if (result != 0 || !keypair) {
-      JSValue error = jsrt_crypto_throw_error(ctx, "OperationError", "Failed to generate RSA key pair");
-      return create_rejected_promise(ctx, error);
-    }
-
-    // Extract public and private key data
-    uint8_t *public_key_data = NULL, *private_key_data = NULL;
-    size_t public_key_size = 0, private_key_size = 0;
-
-    if (jsrt_crypto_rsa_extract_public_key_data(keypair->public_key, &public_key_data, &public_key_size) != 0 ||
-        jsrt_crypto_rsa_extract_private_key_data(keypair->private_key, &private_key_data, &private_key_size) != 0) {
-      jsrt_crypto_rsa_keypair_free(keypair);
-      JSValue error = jsrt_crypto_throw_error(ctx, "OperationError", "Failed to extract RSA key data");
+    // Prime generation is the slowest operation here, keep it off the event loop
+    JSRTCryptoAsyncOperation* op = jsrt_crypto_async_operation_new();
+    jsrt_subtle_rsa_keygen_job_t* job = calloc(1, sizeof(jsrt_subtle_rsa_keygen_job_t));
+    if (!op || !job) {
+      jsrt_crypto_async_operation_free(op);
+      free(job);
+      JSValue error = jsrt_crypto_throw_error(ctx, "OperationError", "Memory allocation failed");
       return create_rejected_promise(ctx, error);
     }
 
-    // Create CryptoKeyPair object
-    JSValue keypair_obj = JS_NewObject(ctx);
-
-    // Create public key object
-    JSValue public_key_obj = JS_NewObject(ctx);
-    JS_SetPropertyStr(ctx, public_key_obj, "type", JS_NewString(ctx, "public"));
-    JS_SetPropertyStr(ctx, public_key_obj, "extractable", JS_NewBool(ctx, true));  // Public keys are always extractable
-    JS_SetPropertyStr(ctx, public_key_obj, "usages", JS_DupValue(ctx, argv[2]));
+    job->algorithm = alg;
+    job->modulus_length = modulus_length;
+    job->public_exponent = public_exponent;
+    job->hash_algorithm = hash_alg;
+    job->extractable = extractable;
 
-    // Set algorithm info for public key
-    JSValue public_alg_obj = JS_NewObject(ctx);
-    JS_SetPropertyStr(ctx, public_alg_obj, "name", JS_NewString(ctx, jsrt_crypto_algorithm_to_string(alg)));
-    JS_SetPropertyStr(ctx, public_alg_obj, "modulusLength", JS_NewInt32(ctx, modulus_length));
-
-    // Set public exponent as Uint8Array
-    JSValue exp_array = JS_NewArrayBufferCopy(ctx, (uint8_t*)&public_exponent, 4);
-    JS_SetPropertyStr(ctx, public_alg_obj, "publicExponent", exp_array);
-
-    JSValue hash_obj = JS_NewObject(ctx);
-    JS_SetPropertyStr(ctx, hash_obj, "name", JS_NewString(ctx, jsrt_crypto_rsa_hash_algorithm_to_string(hash_alg)));
-    JS_SetPropertyStr(ctx, public_alg_obj, "hash", hash_obj);
-
-    JS_SetPropertyStr(ctx, public_key_obj, "algorithm", public_alg_obj);
-
-    // Store the raw key data
-    JSValue public_key_buffer = JS_NewArrayBufferCopy(ctx, public_key_data, public_key_size);
-    JS_SetPropertyStr(ctx, public_key_obj, "__keyData", public_key_buffer);
-
-    // Create private key object
-    JSValue private_key_obj = JS_NewObject(ctx);
-    JS_SetPropertyStr(ctx, private_key_obj, "type", JS_NewString(ctx, "private"));
-    JS_SetPropertyStr(ctx, private_key_obj, "extractable", JS_NewBool(ctx, extractable));
-    JS_SetPropertyStr(ctx, private_key_obj, "usages", JS_DupValue(ctx, argv[2]));
-
-    // Set algorithm info for private key (same as public key)
-    JS_SetPropertyStr(ctx, private_key_obj, "algorithm", JS_DupValue(ctx, public_alg_obj));
-
-    // Store the raw key data
-    JSValue private_key_buffer = JS_NewArrayBufferCopy(ctx, private_key_data, private_key_size);
-    JS_SetPropertyStr(ctx, private_key_obj, "__keyData", private_key_buffer);
-
-    // Set the key pair
-    JS_SetPropertyStr(ctx, keypair_obj, "publicKey", public_key_obj);
-    JS_SetPropertyStr(ctx, keypair_obj, "privateKey", private_key_obj);
-
-    // Cleanup
-    jsrt_crypto_rsa_keypair_free(keypair);
-    free(public_key_data);
-    free(private_key_data);
-
-    return create_resolved_promise(ctx, keypair_obj);
+    op->operation_type = JSRT_CRYPTO_OP_GENERATE_KEY;
+    op->algorithm = alg;
+    op->work = jsrt_subtle_rsa_keygen_work;
+    op->complete = jsrt_subtle_rsa_keygen_complete;
+    op->job_data = job;
+    op->free_job_data = jsrt_subtle_rsa_keygen_job_free;
+    op->retained = JS_DupValue(ctx, argv[2]);
+    op->error_message = strdup("Failed to generate RSA key pair");
+    return jsrt_crypto_async_queue(ctx, op);
   }
 
   // EC key generation (ECDSA/ECDH)
@@ -2641,6 +2707,46 @@ JSValue jsrt_subtle_exportKey(JSContext* ctx, JSValueConst this_val, int argc, J
   }
 }
 
+// PBKDF2 for deriveKey/deriveBits; salt and key material are copied
+static JSRTCryptoAsyncOperation* jsrt_subtle_pbkdf2_operation_new(jsrt_crypto_algorithm_t hash_alg,
+                                                                  const uint8_t* salt, size_t salt_size,
+                                                                  uint32_t iterations, const uint8_t* key_data,
+                                                                  size_t key_data_size, size_t length_bytes) {
+  jsrt_kdf_params_t* kdf_params = calloc(1, sizeof(jsrt_kdf_params_t));
+  if (!kdf_params) {
+    return NULL;
+  }
+
+  kdf_params->algorithm = JSRT_KDF_PBKDF2;
+  kdf_params->params.pbkdf2.hash_algorithm = hash_alg;
+  kdf_params->params.pbkdf2.salt = jsrt_crypto_copy_bytes(salt, salt_size);
+  kdf_params->params.pbkdf2.salt_length = salt_size;
+  kdf_params->params.pbkdf2.iterations = iterations;
+  if (!kdf_params->params.pbkdf2.salt) {
+    jsrt_crypto_kdf_params_free(kdf_params);
+    return NULL;
+  }
+
+  return jsrt_crypto_kdf_async_operation_new(kdf_params, key_data, key_data_size, length_bytes);
+}
+
+// deriveKey completion: op->retained is [derivedKeyAlgorithm, extractable, usages]
+static JSValue jsrt_subtle_derived_key_complete(JSContext* ctx, JSRTCryptoAsyncOperation* op) {
+  JSValue crypto_key = JS_NewObject(ctx);
+  JS_SetPropertyStr(ctx, crypto_key, "type", JS_NewString(ctx, "secret"));
+  JS_SetPropertyStr(ctx, crypto_key, "extractable", JS_GetPropertyUint32(ctx, op->retained, 1));
+  JS_SetPropertyStr(ctx, crypto_key, "usages", JS_GetPropertyUint32(ctx, op->retained, 2));
+  JS_SetPropertyStr(ctx, crypto_key, "algorithm", JS_GetPropertyUint32(ctx, op->retained, 0));
+
+  // Store the derived key data as ArrayBuffer
+  JSValue key_buffer =
+      JS_NewArrayBuffer(ctx, op->output_data, op->output_length, jsrt_crypto_free_array_buffer, NULL, false);
+  op->output_data = NULL;
+  JS_SetPropertyStr(ctx, crypto_key, "__keyData", key_buffer);
+
+  return crypto_key;
+}
+
 JSValue jsrt_subtle_deriveKey(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
   if (argc < 5) {
     JSValue error = jsrt_crypto_throw_error(ctx, "TypeError", "deriveKey requires 5 arguments");
@@ -2747,46 +2853,27 @@ JSValue jsrt_subtle_deriveKey(JSContext* ctx, JSValueConst this_val, int argc, J
 
     size_t key_length_bytes = key_length_bits / 8;
 
-    // Set up PBKDF2 parameters
-    jsrt_pbkdf2_params_t pbkdf2_params = {0};
-    pbkdf2_params.hash_algorithm = hash_alg;
-    pbkdf2_params.salt = salt_data;
-    pbkdf2_params.salt_length = salt_size;
-    pbkdf2_params.iterations = iterations;
-
-    // Derive the key
-    uint8_t* derived_key_data;
-    int result = jsrt_crypto_pbkdf2_derive_key(&pbkdf2_params, base_key_data, base_key_data_size, key_length_bytes,
-                                               &derived_key_data);
+    // Derive on the threadpool; the CryptoKey is assembled once the bits are ready
+    JSRTCryptoAsyncOperation* op = jsrt_subtle_pbkdf2_operation_new(
+        hash_alg, salt_data, salt_size, iterations, base_key_data, base_key_data_size, key_length_bytes);
 
     // Clean up
     JS_FreeValue(ctx, salt_val);
     JS_FreeValue(ctx, base_key_data_val);
 
-    if (result != 0) {
-      JSValue error = jsrt_crypto_throw_error(ctx, "OperationError", "Key derivation failed");
+    if (!op) {
+      JSValue error = jsrt_crypto_throw_error(ctx, "OperationError", "Memory allocation failed");
       return create_rejected_promise(ctx, error);
     }
 
-    // Get extractable flag (fourth argument)
-    bool extractable = JS_ToBool(ctx, argv[3]);
-
-    // Create CryptoKey object
-    JSValue crypto_key = JS_NewObject(ctx);
-    JS_SetPropertyStr(ctx, crypto_key, "type", JS_NewString(ctx, "secret"));
-    JS_SetPropertyStr(ctx, crypto_key, "extractable", JS_NewBool(ctx, extractable));
-
-    // Set usages (fifth argument)
-    JS_SetPropertyStr(ctx, crypto_key, "usages", JS_DupValue(ctx, argv[4]));
-
-    // Set algorithm
-    JS_SetPropertyStr(ctx, crypto_key, "algorithm", JS_DupValue(ctx, argv[2]));
-
-    // Store the derived key data as ArrayBuffer
-    JSValue key_buffer = JS_NewArrayBuffer(ctx, derived_key_data, key_length_bytes, NULL, NULL, 0);
-    JS_SetPropertyStr(ctx, crypto_key, "__keyData", key_buffer);
-
-    return create_resolved_promise(ctx, crypto_key);
+    // [derivedKeyAlgorithm, extractable, usages]
+    op->operation_type = JSRT_CRYPTO_OP_DERIVE_KEY;
+    op->complete = jsrt_subtle_derived_key_complete;
+    op->retained = JS_NewArray(ctx);
+    JS_SetPropertyUint32(ctx, op->retained, 0, JS_DupValue(ctx, argv[2]));
+    JS_SetPropertyUint32(ctx, op->retained, 1, JS_NewBool(ctx, JS_ToBool(ctx, argv[3])));
+    JS_SetPropertyUint32(ctx, op->retained, 2, JS_DupValue(ctx, argv[4]));
+    return jsrt_crypto_async_queue(ctx, op);
   }
 
   JSValue error = jsrt_crypto_throw_error(ctx, "NotSupportedError", "Algorithm not supported for key derivation");
@@ -2880,33 +2967,118 @@ static JSValue jsrt_subtle_derive_hkdf_bits(JSContext* ctx, JSValueConst algorit
   }
   JS_FreeValue(ctx, info_val);
 
-  // Perform HKDF
-  uint8_t* derived_key = NULL;
-  int result = jsrt_crypto_hkdf_derive_key(&hkdf_params, key_data, key_data_size, length_bytes, &derived_key);
+  // Derive on the threadpool; salt and info are already private copies and move into the job
+  jsrt_kdf_params_t* kdf_params = calloc(1, sizeof(jsrt_kdf_params_t));
+  JSRTCryptoAsyncOperation* op = NULL;
+  if (kdf_params) {
+    kdf_params->algorithm = JSRT_KDF_HKDF;
+    kdf_params->params.hkdf = hkdf_params;
+    op = jsrt_crypto_kdf_async_operation_new(kdf_params, key_data, key_data_size, length_bytes);
+  } else {
+    free(hkdf_params.salt);
+    free(hkdf_params.info);
+  }
 
   // Cleanup
   JS_FreeValue(ctx, key_data_val);
-  free(hkdf_params.salt);
-  free(hkdf_params.info);
 
-  if (result != 0 || !derived_key) {
-    JSValue error = jsrt_crypto_throw_error(ctx, "OperationError", "HKDF derivation failed");
+  if (!op) {
+    JSValue error = jsrt_crypto_throw_error(ctx, "OperationError", "Memory allocation failed");
     return create_rejected_promise(ctx, error);
   }
 
-  // Create ArrayBuffer for result
-  JSValue result_buffer = JS_NewArrayBufferCopy(ctx, derived_key, length_bytes);
-  free(derived_key);
-
-  return create_resolved_promise(ctx, result_buffer);
+  return jsrt_crypto_async_queue(ctx, op);
 }
 
 // Helper function for PBKDF2 deriveBits
 static JSValue jsrt_subtle_derive_pbkdf2_bits(JSContext* ctx, JSValueConst algorithm, JSValueConst base_key,
                                               JSValueConst length_arg) {
-  // TODO: Implement PBKDF2 deriveBits if needed
-  JSValue error = jsrt_crypto_throw_error(ctx, "NotSupportedError", "PBKDF2 deriveBits not yet implemented");
-  return create_rejected_promise(ctx, error);
+  // Get password bytes from CryptoKey object
+  JSValue key_data_val = JS_GetPropertyStr(ctx, base_key, "__keyData");
+  size_t key_data_size;
+  uint8_t* key_data = JS_GetArrayBuffer(ctx, &key_data_size, key_data_val);
+  if (!key_data) {
+    JS_FreeValue(ctx, key_data_val);
+    JSValue error = jsrt_crypto_throw_error(ctx, "InvalidAccessError", "Invalid CryptoKey object");
+    return create_rejected_promise(ctx, error);
+  }
+
+  // Get length parameter (in bits)
+  uint32_t length_bits = 0;
+  if (JS_IsUndefined(length_arg) || JS_IsNull(length_arg) || JS_ToUint32(ctx, &length_bits, length_arg) < 0 ||
+      length_bits == 0 || length_bits % 8 != 0) {
+    JS_FreeValue(ctx, key_data_val);
+    JSValue error = jsrt_crypto_throw_error(ctx, "OperationError", "PBKDF2 length must be a multiple of 8");
+    return create_rejected_promise(ctx, error);
+  }
+
+  // Get salt - ArrayBuffer or TypedArray
+  JSValue salt_val = JS_GetPropertyStr(ctx, algorithm, "salt");
+  size_t salt_size = 0;
+  uint8_t* salt_data = JS_GetArrayBuffer(ctx, &salt_size, salt_val);
+  if (!salt_data && JS_IsObject(salt_val)) {
+    JSValue salt_buffer_val = JS_GetPropertyStr(ctx, salt_val, "buffer");
+    size_t buffer_size;
+    uint8_t* buffer_data = JS_GetArrayBuffer(ctx, &buffer_size, salt_buffer_val);
+    if (buffer_data) {
+      JSValue offset_val = JS_GetPropertyStr(ctx, salt_val, "byteOffset");
+      JSValue length_val = JS_GetPropertyStr(ctx, salt_val, "byteLength");
+      uint32_t offset = 0, length = 0;
+      JS_ToUint32(ctx, &offset, offset_val);
+      JS_ToUint32(ctx, &length, length_val);
+      if ((size_t)offset + length <= buffer_size) {
+        salt_data = buffer_data + offset;
+        salt_size = length;
+      }
+      JS_FreeValue(ctx, offset_val);
+      JS_FreeValue(ctx, length_val);
+    }
+    JS_FreeValue(ctx, salt_buffer_val);
+  }
+  if (!salt_data) {
+    JS_FreeValue(ctx, salt_val);
+    JS_FreeValue(ctx, key_data_val);
+    JSValue error = jsrt_crypto_throw_error(ctx, "TypeError", "PBKDF2 requires a salt BufferSource");
+    return create_rejected_promise(ctx, error);
+  }
+
+  // Get iterations
+  JSValue iterations_val = JS_GetPropertyStr(ctx, algorithm, "iterations");
+  uint32_t iterations = 0;
+  JS_ToUint32(ctx, &iterations, iterations_val);
+  JS_FreeValue(ctx, iterations_val);
+  if (iterations == 0) {
+    JS_FreeValue(ctx, salt_val);
+    JS_FreeValue(ctx, key_data_val);
+    JSValue error = jsrt_crypto_throw_error(ctx, "OperationError", "PBKDF2 iterations must be greater than zero");
+    return create_rejected_promise(ctx, error);
+  }
+
+  // Get hash algorithm - string or object with name property
+  JSValue hash_val = JS_GetPropertyStr(ctx, algorithm, "hash");
+  jsrt_crypto_algorithm_t hash_alg = jsrt_crypto_parse_algorithm(ctx, hash_val);
+  JS_FreeValue(ctx, hash_val);
+  if (hash_alg != JSRT_CRYPTO_ALG_SHA1 && hash_alg != JSRT_CRYPTO_ALG_SHA256 && hash_alg != JSRT_CRYPTO_ALG_SHA384 &&
+      hash_alg != JSRT_CRYPTO_ALG_SHA512) {
+    JS_FreeValue(ctx, salt_val);
+    JS_FreeValue(ctx, key_data_val);
+    JSValue error = jsrt_crypto_throw_error(ctx, "NotSupportedError", "Unsupported PBKDF2 hash algorithm");
+    return create_rejected_promise(ctx, error);
+  }
+
+  // Iterations dominate the cost, so this always runs on the threadpool
+  JSRTCryptoAsyncOperation* op = jsrt_subtle_pbkdf2_operation_new(hash_alg, salt_data, salt_size, iterations,
+                                                                  key_data, key_data_size, length_bits / 8);
+
+  JS_FreeValue(ctx, salt_val);
+  JS_FreeValue(ctx, key_data_val);
+
+  if (!op) {
+    JSValue error = jsrt_crypto_throw_error(ctx, "OperationError", "Memory allocation failed");
+    return create_rejected_promise(ctx, error);
+  }
+
+  return jsrt_crypto_async_queue(ctx, op);
 }
 
 JSValue jsrt_subtle_deriveBits(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
@@ -3336,25 +3508,31 @@ static JSValue bigint_to_base64url_string(JSContext* ctx, const uint8_t* data, s
     len--;
   }
 
-  size_t encoded_len;
-  char* encoded = base64url_encode(data, len, &encoded_len);
+  char* encoded = malloc(JSRT_Base64EncodedLength(len, false) + 1);
   if (!encoded) {
     return JS_ThrowOutOfMemory(ctx);
   }
+  size_t encoded_len = JSRT_Base64Encode(data, len, encoded, JSRT_BASE64_URL, false);
 
   JSValue result = JS_NewStringLen(ctx, encoded, encoded_len);
   free(encoded);
   return result;
 }
 
-// Helper function to decode base64url string to bytes
+// Helper function to decode base64url string to bytes (RFC 7515: no whitespace, padding optional)
 static uint8_t* base64url_string_to_bigint(JSContext* ctx, JSValue str_val, size_t* out_len) {
-  const char* str = JS_ToCString(ctx, str_val);
+  size_t str_len;
+  const char* str = JS_ToCStringLen(ctx, &str_len, str_val);
   if (!str)
     return NULL;
 
-  size_t str_len = strlen(str);
-  uint8_t* result = base64url_decode(str, str_len, out_len);
+  *out_len = str_len / 4 * 3 + 3;
+  uint8_t* result = malloc(*out_len);
+  if (result && (!JSRT_Base64Decode(str, str_len, result, out_len, JSRT_BASE64_URL, JSRT_BASE64_STRICT) ||
+                 *out_len == 0)) {
+    free(result);
+    result = NULL;
+  }
 
   JS_FreeCString(ctx, str);
   return result;
@@ -53,7 +53,15 @@ typedef struct {
 } JSRTCryptoKey;
 
 // Async operation context
-typedef struct {
+typedef struct JSRTCryptoAsyncOperation JSRTCryptoAsyncOperation;
+
+// Runs on a libuv threadpool thread: may only touch memory owned by the operation, returns 0 on success
+typedef int (*jsrt_crypto_async_work_fn)(JSRTCryptoAsyncOperation* op);
+
+// Runs on the event loop thread once the work is done: builds the value the operation settles with
+typedef JSValue (*jsrt_crypto_async_complete_fn)(JSContext* ctx, JSRTCryptoAsyncOperation* op);
+
+struct JSRTCryptoAsyncOperation {
   JSContext* ctx;
   JSValue promise;
   JSValue resolve_func;
@@ -69,7 +77,9 @@ typedef struct {
     JSRT_CRYPTO_OP_VERIFY,
     JSRT_CRYPTO_OP_GENERATE_KEY,
     JSRT_CRYPTO_OP_IMPORT_KEY,
-    JSRT_CRYPTO_OP_EXPORT_KEY
+    JSRT_CRYPTO_OP_EXPORT_KEY,
+    JSRT_CRYPTO_OP_DERIVE_BITS,
+    JSRT_CRYPTO_OP_DERIVE_KEY
   } operation_type;
 
   // Common operation data
@@ -101,10 +111,18 @@ typedef struct {
     } keygen;
   } op_data;
 
+  // Threadpool dispatch
+  jsrt_crypto_async_work_fn work;
+  jsrt_crypto_async_complete_fn complete;  // NULL settles with output_data as an ArrayBuffer
+  void* job_data;                          // Inputs copied off the JS heap
+  void (*free_job_data)(void* job_data);
+  JSValue callback;  // Node.js style callback(err, result), undefined when settling the promise
+  JSValue retained;  // JS values the completion needs (usages, algorithm objects)
+
   // Error information
-  char* error_message;
+  char* error_message;  // Reported when work returns non-zero
   int error_code;
-} JSRTCryptoAsyncOperation;
+};
 
 // Utility functions
 jsrt_crypto_algorithm_t jsrt_crypto_parse_algorithm(JSContext* ctx, JSValue algorithm);
@@ -134,4 +152,9 @@ void jsrt_crypto_key_free(JSRTCryptoKey* key);
 JSRTCryptoAsyncOperation* jsrt_crypto_async_operation_new(void);
 void jsrt_crypto_async_operation_free(JSRTCryptoAsyncOperation* op);
 
+// Threadpool execution: both take ownership of op, also when they fail
+JSValue jsrt_crypto_async_queue(JSContext* ctx, JSRTCryptoAsyncOperation* op);
+JSValue jsrt_crypto_async_queue_callback(JSContext* ctx, JSRTCryptoAsyncOperation* op, JSValueConst callback);
+uint8_t* jsrt_crypto_copy_bytes(const uint8_t* data, size_t length);
+
 #endif
\ No newline at end of file
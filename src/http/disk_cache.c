@@ -0,0 +1,501 @@
+#include "disk_cache.h"
+#include "../util/base64.h"
+#include "../util/debug.h"
+#include "../util/file.h"
+#include "../util/sha256.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#ifdef _WIN32
+#include <direct.h>
+#include <process.h>
+#define jsrt_getpid _getpid
+#define jsrt_mkdir(path) _mkdir(path)
+#else
+#include <unistd.h>
+#define jsrt_getpid getpid
+#define jsrt_mkdir(path) mkdir(path, 0755)
+#endif
+
+#ifndef JSRT_VERSION
+#define JSRT_VERSION "dev"
+#endif
+
+#ifndef QUICKJS_VERSION
+#define QUICKJS_VERSION "unknown"
+#endif
+
+#define DEFAULT_CACHE_DIR ".jsrt/http-cache"
+#define DEFAULT_CACHE_TTL 3600
+#define INTEGRITY_PREFIX "sha256-"
+#define HEX_DIGEST_SIZE (JSRT_SHA256_DIGEST_LENGTH * 2 + 1)
+
+struct JSRT_HttpDiskCache {
+  char* directory;
+  time_t ttl;  // seconds an entry is used without revalidation
+};
+
+// <directory>/<sub>/<name><suffix>
+static char* cache_path(JSRT_HttpDiskCache* cache, const char* sub, const char* name, const char* suffix) {
+  size_t len = strlen(cache->directory) + strlen(sub) + strlen(name) + strlen(suffix) + 3;
+  char* path = malloc(len);
+  if (path) {
+    snprintf(path, len, "%s/%s/%s%s", cache->directory, sub, name, suffix);
+  }
+  return path;
+}
+
+static char* entry_path(JSRT_HttpDiskCache* cache, const char* url, const char* sub, const char* suffix) {
+  char key[HEX_DIGEST_SIZE];
+  JSRT_Sha256Hex(url, strlen(url), key);
+  return cache_path(cache, sub, key, suffix);
+}
+
+// content/<hex digest> for an integrity string, or NULL if it is not a well-formed sha256 one
+static char* content_path(JSRT_HttpDiskCache* cache, const char* integrity) {
+  static const char digits[] = "0123456789abcdef";
+  size_t prefix_len = strlen(INTEGRITY_PREFIX);
+  if (strncmp(integrity, INTEGRITY_PREFIX, prefix_len) != 0) {
+    return NULL;
+  }
+
+  uint8_t digest[JSRT_SHA256_DIGEST_LENGTH];
+  size_t digest_len = sizeof(digest);
+  const char* encoded = integrity + prefix_len;
+  if (!JSRT_Base64Decode(encoded, strlen(encoded), digest, &digest_len, JSRT_BASE64_STANDARD, JSRT_BASE64_STRICT) ||
+      digest_len != sizeof(digest)) {
+    return NULL;
+  }
+
+  char hex[HEX_DIGEST_SIZE];
+  for (int i = 0; i < JSRT_SHA256_DIGEST_LENGTH; i++) {
+    hex[i * 2] = digits[digest[i] >> 4];
+    hex[i * 2 + 1] = digits[digest[i] & 0xf];
+  }
+  hex[HEX_DIGEST_SIZE - 1] = '\0';
+  return cache_path(cache, "content", hex, "");
+}
+
+static void compute_integrity(const char* data, size_t size, char integrity[JSRT_HTTP_INTEGRITY_SIZE]) {
+  uint8_t digest[JSRT_SHA256_DIGEST_LENGTH];
+  JSRT_Sha256Digest(data, size, digest);
+
+  size_t prefix_len = strlen(INTEGRITY_PREFIX);
+  memcpy(integrity, INTEGRITY_PREFIX, prefix_len);
+  size_t written = JSRT_Base64Encode(digest, sizeof(digest), integrity + prefix_len, JSRT_BASE64_STANDARD, true);
+  integrity[prefix_len + written] = '\0';
+}
+
+static bool make_directory(const char* path) {
+  struct stat st;
+  if (stat(path, &st) == 0) {
+    return S_ISDIR(st.st_mode);
+  }
+
+  char* parent = strdup(path);
+  if (!parent) {
+    return false;
+  }
+  char* sep = strrchr(parent, '/');
+  if (sep && sep != parent) {
+    *sep = '\0';
+    if (!make_directory(parent)) {
+      free(parent);
+      return false;
+    }
+  }
+  free(parent);
+
+  return jsrt_mkdir(path) == 0 || (errno == EEXIST && stat(path, &st) == 0 && S_ISDIR(st.st_mode));
+}
+
+// Write `head` then `data` to a temporary file and rename it over path. No fsync: a file torn by a
+// crash fails the SHA-256 check of its content on the next read and is fetched or compiled again.
+static bool write_atomic(const char* path, const void* head, size_t head_size, const void* data, size_t size) {
+  size_t tmp_len = strlen(path) + 32;
+  char* tmp_path = malloc(tmp_len);
+  if (!tmp_path) {
+    return false;
+  }
+  snprintf(tmp_path, tmp_len, "%s.tmp.%ld", path, (long)jsrt_getpid());
+
+  FILE* f = fopen(tmp_path, "wb");
+  if (!f) {
+    free(tmp_path);
+    return false;
+  }
+  bool ok = fwrite(head, 1, head_size, f) == head_size && fwrite(data, 1, size, f) == size;
+  ok = fclose(f) == 0 && ok;
+
+#ifdef _WIN32
+  // rename() does not replace an existing file on Windows
+  if (ok) {
+    remove(path);
+  }
+#endif
+  if (!ok || rename(tmp_path, path) != 0) {
+    remove(tmp_path);
+    ok = false;
+  }
+
+  free(tmp_path);
+  return ok;
+}
+
+// Validators go into a line-based file; refuse anything that would break a line
+static bool is_single_line(const char* value) {
+  return !value || !strpbrk(value, "\r\n");
+}
+
+static bool write_entry(JSRT_HttpDiskCache* cache, const JSRT_HttpDiskCacheEntry* entry) {
+  if (!is_single_line(entry->etag) || !is_single_line(entry->last_modified)) {
+    return false;
+  }
+
+  char* path = entry_path(cache, entry->url, "entries", "");
+  if (!path) {
+    return false;
+  }
+
+  const char* etag = entry->etag ? entry->etag : "";
+  const char* last_modified = entry->last_modified ? entry->last_modified : "";
+  const char* format = "url=%s\nintegrity=%s\netag=%s\nlast_modified=%s\nvalidated_at=%lld\n";
+  int len = snprintf(NULL, 0, format, entry->url, entry->integrity, etag, last_modified,
+                     (long long)entry->validated_at);
+  char* text = len >= 0 ? malloc((size_t)len + 1) : NULL;
+  bool ok = false;
+  if (text) {
+    snprintf(text, (size_t)len + 1, format, entry->url, entry->integrity, etag, last_modified,
+             (long long)entry->validated_at);
+    ok = write_atomic(path, "", 0, text, (size_t)len);
+    free(text);
+  }
+
+  free(path);
+  return ok;
+}
+
+// Value of `key=` on its own line in text, copied, or NULL
+static char* entry_field(const char* text, const char* key) {
+  size_t key_len = strlen(key);
+  for (const char* line = text; line && *line; line = strchr(line, '\n'), line = line ? line + 1 : NULL) {
+    if (strncmp(line, key, key_len) == 0 && line[key_len] == '=') {
+      const char* value = line + key_len + 1;
+      size_t value_len = strcspn(value, "\n");
+      char* copy = malloc(value_len + 1);
+      if (copy) {
+        memcpy(copy, value, value_len);
+        copy[value_len] = '\0';
+      }
+      return copy;
+    }
+  }
+  return NULL;
+}
+
+// Empty validators are stored as empty lines; read them back as absent
+static char* entry_optional_field(const char* text, const char* key) {
+  char* value = entry_field(text, key);
+  if (value && !*value) {
+    free(value);
+    value = NULL;
+  }
+  return value;
+}
+
+JSRT_HttpDiskCache* jsrt_http_disk_cache_open(void) {
+  char* directory = NULL;
+  const char* dir_env = getenv("JSRT_HTTP_MODULES_CACHE_DIR");
+  if (dir_env) {
+    if (!*dir_env) {
+      return NULL;
+    }
+    directory = strdup(dir_env);
+  } else {
+    const char* home = getenv("HOME");
+    if (!home) {
+      home = getenv("USERPROFILE");  // Windows fallback
+    }
+    if (!home) {
+      return NULL;
+    }
+    size_t len = strlen(home) + strlen(DEFAULT_CACHE_DIR) + 2;
+    directory = malloc(len);
+    if (directory) {
+      snprintf(directory, len, "%s/%s", home, DEFAULT_CACHE_DIR);
+    }
+  }
+  if (!directory) {
+    return NULL;
+  }
+
+  JSRT_HttpDiskCache* cache = malloc(sizeof(JSRT_HttpDiskCache));
+  if (!cache) {
+    free(directory);
+    return NULL;
+  }
+  cache->directory = directory;
+  cache->ttl = DEFAULT_CACHE_TTL;
+
+  const char* ttl_env = getenv("JSRT_HTTP_MODULES_CACHE_TTL");
+  if (ttl_env) {
+    cache->ttl = (time_t)atol(ttl_env);
+  }
+
+  static const char* const subdirs[] = {"entries", "content", "code"};
+  for (size_t i = 0; i < sizeof(subdirs) / sizeof(subdirs[0]); i++) {
+    char* path = cache_path(cache, subdirs[i], "", "");
+    bool ok = path && make_directory(path);
+    free(path);
+    if (!ok) {
+      JSRT_Debug("jsrt_http_disk_cache_open: cannot create '%s/%s' (errno %d)", directory, subdirs[i], errno);
+      jsrt_http_disk_cache_close(cache);
+      return NULL;
+    }
+  }
+
+  JSRT_Debug("jsrt_http_disk_cache_open: using '%s'", directory);
+  return cache;
+}
+
+void jsrt_http_disk_cache_close(JSRT_HttpDiskCache* cache) {
+  if (!cache) {
+    return;
+  }
+  free(cache->directory);
+  free(cache);
+}
+
+bool jsrt_http_disk_cache_get(JSRT_HttpDiskCache* cache, const char* url, JSRT_HttpDiskCacheEntry* entry) {
+  memset(entry, 0, sizeof(*entry));
+  if (!cache || !url) {
+    return false;
+  }
+
+  char* path = entry_path(cache, url, "entries", "");
+  if (!path) {
+    return false;
+  }
+  JSRT_ReadFileResult text = JSRT_ReadFile(path);
+  if (text.error != JSRT_READ_FILE_OK) {
+    free(path);
+    return false;
+  }
+
+  char* stored_url = entry_field(text.data, "url");
+  char* integrity = entry_field(text.data, "integrity");
+  char* validated_at = entry_field(text.data, "validated_at");
+  char* source_path = NULL;
+  JSRT_ReadFileResult source = JSRT_ReadFileResultDefault();
+  bool ok = false;
+
+  // The URL check guards against the (theoretical) case of two URLs sharing a key
+  if (!stored_url || strcmp(stored_url, url) != 0 || !integrity || strlen(integrity) >= JSRT_HTTP_INTEGRITY_SIZE ||
+      !validated_at) {
+    JSRT_Debug("jsrt_http_disk_cache_get: malformed entry '%s' for '%s'", path, url);
+    goto done;
+  }
+
+  source_path = content_path(cache, integrity);
+  if (!source_path) {
+    goto done;
+  }
+  source = JSRT_ReadFile(source_path);
+  if (source.error != JSRT_READ_FILE_OK) {
+    goto done;
+  }
+
+  char actual[JSRT_HTTP_INTEGRITY_SIZE];
+  compute_integrity(source.data, source.size, actual);
+  if (strcmp(actual, integrity) != 0) {
+    JSRT_Debug("jsrt_http_disk_cache_get: integrity mismatch for '%s', discarding", url);
+    remove(source_path);
+    goto done;
+  }
+
+  entry->url = stored_url;
+  stored_url = NULL;
+  snprintf(entry->integrity, sizeof(entry->integrity), "%s", integrity);
+  entry->etag = entry_optional_field(text.data, "etag");
+  entry->last_modified = entry_optional_field(text.data, "last_modified");
+  entry->validated_at = (time_t)atoll(validated_at);
+  entry->data = source.data;
+  entry->size = source.size;
+  source.data = NULL;
+  ok = true;
+
+done:
+  if (!ok) {
+    remove(path);
+  }
+  JSRT_ReadFileResultFree(&source);
+  JSRT_ReadFileResultFree(&text);
+  free(source_path);
+  free(validated_at);
+  free(integrity);
+  free(stored_url);
+  free(path);
+  return ok;
+}
+
+bool jsrt_http_disk_cache_is_fresh(JSRT_HttpDiskCache* cache, const JSRT_HttpDiskCacheEntry* entry) {
+  return cache && entry && time(NULL) - entry->validated_at < cache->ttl;
+}
+
+bool jsrt_http_disk_cache_put(JSRT_HttpDiskCache* cache, const char* url, const char* data, size_t size,
+                              const char* etag, const char* last_modified, JSRT_HttpDiskCacheEntry* entry) {
+  if (!cache || !url || !data) {
+    return false;
+  }
+
+  JSRT_HttpDiskCacheEntry stored = {0};
+  stored.url = (char*)url;
+  compute_integrity(data, size, stored.integrity);
+  stored.etag = (char*)etag;
+  stored.last_modified = (char*)last_modified;
+  stored.validated_at = time(NULL);
+
+  // Content first, so an entry never points at a source that is not there yet. A blob that already
+  // exists holds the same bytes (it is named by their hash), and reads verify it anyway.
+  char* source_path = content_path(cache, stored.integrity);
+  struct stat st;
+  bool ok = source_path &&
+            ((stat(source_path, &st) == 0 && (size_t)st.st_size == size) ||
+             write_atomic(source_path, "", 0, data, size)) &&
+            write_entry(cache, &stored);
+  free(source_path);
+  if (!ok) {
+    JSRT_Debug("jsrt_http_disk_cache_put: failed to store '%s'", url);
+    return false;
+  }
+
+  // A new source makes any bytecode compiled from the old one useless
+  char* code_path = entry_path(cache, url, "code", ".jsc");
+  if (code_path) {
+    remove(code_path);
+    free(code_path);
+  }
+
+  if (entry) {
+    jsrt_http_disk_cache_entry_free(entry);
+    entry->url = strdup(url);
+    memcpy(entry->integrity, stored.integrity, sizeof(entry->integrity));
+    entry->etag = etag ? strdup(etag) : NULL;
+    entry->last_modified = last_modified ? strdup(last_modified) : NULL;
+    entry->validated_at = stored.validated_at;
+  }
+  return true;
+}
+
+bool jsrt_http_disk_cache_revalidated(JSRT_HttpDiskCache* cache, JSRT_HttpDiskCacheEntry* entry, const char* etag,
+                                      const char* last_modified) {
+  if (!cache || !entry || !entry->url) {
+    return false;
+  }
+
+  if (etag) {
+    free(entry->etag);
+    entry->etag = strdup(etag);
+  }
+  if (last_modified) {
+    free(entry->last_modified);
+    entry->last_modified = strdup(last_modified);
+  }
+  entry->validated_at = time(NULL);
+  return write_entry(cache, entry);
+}
+
+// First line of a bytecode file, up to the digest of the bytecode after it: only code from this exact
+// build and source is loaded
+static char* code_header_prefix(const JSRT_HttpDiskCacheEntry* entry) {
+  const char* format = "jsrt=%s quickjs=%s integrity=%s code=";
+  int len = snprintf(NULL, 0, format, JSRT_VERSION, QUICKJS_VERSION, entry->integrity);
+  char* prefix = len >= 0 ? malloc((size_t)len + 1) : NULL;
+  if (prefix) {
+    snprintf(prefix, (size_t)len + 1, format, JSRT_VERSION, QUICKJS_VERSION, entry->integrity);
+  }
+  return prefix;
+}
+
+uint8_t* jsrt_http_disk_cache_get_code(JSRT_HttpDiskCache* cache, const JSRT_HttpDiskCacheEntry* entry,
+                                       size_t* size) {
+  if (!cache || !entry || !entry->url) {
+    return NULL;
+  }
+
+  char* path = entry_path(cache, entry->url, "code", ".jsc");
+  char* prefix = code_header_prefix(entry);
+  JSRT_ReadFileResult file = JSRT_ReadFileResultDefault();
+  uint8_t* code = NULL;
+
+  if (path && prefix) {
+    file = JSRT_ReadFile(path);
+  }
+
+  // QuickJS does not validate bytecode, so a torn or corrupted file must never reach JS_ReadObject:
+  // the payload has to match the SHA-256 recorded in the header
+  size_t prefix_len = prefix ? strlen(prefix) : 0;
+  size_t header_len = prefix_len + HEX_DIGEST_SIZE;  // Digest plus the newline that ends the header
+  if (file.error == JSRT_READ_FILE_OK && file.data && file.size > header_len &&
+      memcmp(file.data, prefix, prefix_len) == 0 && file.data[header_len - 1] == '\n') {
+    char actual[HEX_DIGEST_SIZE];
+    JSRT_Sha256Hex(file.data + header_len, file.size - header_len, actual);
+    if (memcmp(actual, file.data + prefix_len, HEX_DIGEST_SIZE - 1) == 0) {
+      *size = file.size - header_len;
+      code = malloc(*size);
+      if (code) {
+        memcpy(code, file.data + header_len, *size);
+      }
+    }
+  }
+  if (!code && file.data) {
+    JSRT_Debug("jsrt_http_disk_cache_get_code: stale or corrupt bytecode for '%s'", entry->url);
+    remove(path);
+  }
+
+  JSRT_ReadFileResultFree(&file);
+  free(prefix);
+  free(path);
+  return code;
+}
+
+bool jsrt_http_disk_cache_put_code(JSRT_HttpDiskCache* cache, const JSRT_HttpDiskCacheEntry* entry,
+                                   const uint8_t* code, size_t size) {
+  if (!cache || !entry || !entry->url || !code) {
+    return false;
+  }
+
+  char* path = entry_path(cache, entry->url, "code", ".jsc");
+  char* prefix = code_header_prefix(entry);
+  char* header = NULL;
+  if (prefix) {
+    size_t prefix_len = strlen(prefix);
+    header = malloc(prefix_len + HEX_DIGEST_SIZE + 1);
+    if (header) {
+      memcpy(header, prefix, prefix_len);
+      JSRT_Sha256Hex(code, size, header + prefix_len);
+      memcpy(header + prefix_len + HEX_DIGEST_SIZE - 1, "\n", 2);
+    }
+  }
+  bool ok = path && header && write_atomic(path, header, strlen(header), code, size);
+  free(header);
+  free(prefix);
+  free(path);
+  return ok;
+}
+
+void jsrt_http_disk_cache_entry_free(JSRT_HttpDiskCacheEntry* entry) {
+  if (!entry) {
+    return;
+  }
+  free(entry->url);
+  free(entry->etag);
+  free(entry->last_modified);
+  free(entry->data);
+  memset(entry, 0, sizeof(*entry));
+}
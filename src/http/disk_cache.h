@@ -0,0 +1,65 @@
+#ifndef __JSRT_HTTP_DISK_CACHE_H__
+#define __JSRT_HTTP_DISK_CACHE_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <time.h>
+
+// Persistent cache of HTTP-loaded modules, shared between processes.
+//
+// Layout under the cache directory (default ~/.jsrt/http-cache):
+//   entries/<sha256(url)>       url, integrity, etag, last_modified and validated_at as key=value lines
+//   content/<sha256(source)>    module source, content-addressed so identical files are stored once
+//   code/<sha256(url)>.jsc      QuickJS bytecode compiled from that source, after a header line with
+//                               the build, the source integrity and a SHA-256 of the bytecode
+//
+// Every file is written under a temporary name and renamed into place. Sources are checked against
+// their lockfile-style integrity ("sha256-<base64>") on read, so a torn or edited file is a miss.
+
+// "sha256-" + 44 base64 characters + terminator
+#define JSRT_HTTP_INTEGRITY_SIZE 52
+
+typedef struct JSRT_HttpDiskCache JSRT_HttpDiskCache;
+
+typedef struct {
+  char* url;
+  char integrity[JSRT_HTTP_INTEGRITY_SIZE];
+  char* etag;
+  char* last_modified;
+  time_t validated_at;  // last time the server sent or confirmed this copy
+  char* data;           // NUL-terminated source, NULL when not loaded
+  size_t size;
+} JSRT_HttpDiskCacheEntry;
+
+// Open the cache in JSRT_HTTP_MODULES_CACHE_DIR, or ~/.jsrt/http-cache when unset.
+// Returns NULL when the variable is set to an empty string or the directory cannot be created.
+JSRT_HttpDiskCache* jsrt_http_disk_cache_open(void);
+
+void jsrt_http_disk_cache_close(JSRT_HttpDiskCache* cache);
+
+// Load the entry and source for url; false on a miss or when the source fails its integrity check
+bool jsrt_http_disk_cache_get(JSRT_HttpDiskCache* cache, const char* url, JSRT_HttpDiskCacheEntry* entry);
+
+// Whether the entry was validated within JSRT_HTTP_MODULES_CACHE_TTL and can be used without a request
+bool jsrt_http_disk_cache_is_fresh(JSRT_HttpDiskCache* cache, const JSRT_HttpDiskCacheEntry* entry);
+
+// Store a downloaded source. On success `entry` (if not NULL) describes the new copy, without its data.
+bool jsrt_http_disk_cache_put(JSRT_HttpDiskCache* cache, const char* url, const char* data, size_t size,
+                              const char* etag, const char* last_modified, JSRT_HttpDiskCacheEntry* entry);
+
+// Record a 304 Not Modified answer: the copy is fresh again, with any validators the server updated
+bool jsrt_http_disk_cache_revalidated(JSRT_HttpDiskCache* cache, JSRT_HttpDiskCacheEntry* entry, const char* etag,
+                                      const char* last_modified);
+
+// Bytecode compiled from the entry's source by this jsrt/QuickJS build, or NULL. The bytecode has
+// matched its recorded SHA-256, since JS_ReadObject trusts its input. Caller frees.
+uint8_t* jsrt_http_disk_cache_get_code(JSRT_HttpDiskCache* cache, const JSRT_HttpDiskCacheEntry* entry,
+                                       size_t* size);
+
+bool jsrt_http_disk_cache_put_code(JSRT_HttpDiskCache* cache, const JSRT_HttpDiskCacheEntry* entry,
+                                   const uint8_t* code, size_t size);
+
+void jsrt_http_disk_cache_entry_free(JSRT_HttpDiskCacheEntry* entry);
+
+#endif
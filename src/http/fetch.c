@@ -3,11 +3,15 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <strings.h>
 #include <uv.h>
 #include "../crypto/crypto.h"
+#include "../std/streams.h"
+#include "../util/conn_pool.h"
 #include "../util/debug.h"
 #include "../util/http_request.h"
 #include "../util/jsutils.h"
+#include "../util/read_slab.h"
 #include "../util/ssl_client.h"
 #include "../util/url_parser.h"
 #include "../util/user_agent.h"
@@ -19,13 +23,40 @@ typedef struct jsrt_header_entry {
   struct jsrt_header_entry* next;
 } jsrt_header_entry_t;
 
+// Plain-HTTP connections are pooled per origin; HTTPS connections are closed after one request
+#define JSRT_FETCH_POOL_MAX_FREE_SOCKETS 16
+#define JSRT_FETCH_POOL_IDLE_TIMEOUT_MS 4000
+
+// Unread body chunks (one socket read each) queued before reading from the socket pauses
+#define JSRT_FETCH_BODY_HIGH_WATER_MARK 1
+
+struct jsrt_fetch_context;
+
+// TCP connection to an origin; a pooled connection outlives the requests it serves
 typedef struct {
   JSRT_Runtime* rt;
   uv_tcp_t tcp_handle;
   uv_connect_t connect_req;
-  uv_write_t write_req;
   uv_getaddrinfo_t dns_req;
 
+  char* pool_key;                     // "host:port" when the connection belongs to rt->http_pool
+  struct jsrt_fetch_context* active;  // Request using the connection (NULL while idle in the pool)
+  int tcp_initialized;
+  int closing;
+} jsrt_fetch_conn_t;
+
+// Write request that owns the serialized HTTP request until libuv is done with it
+typedef struct {
+  uv_write_t req;
+  char* buffer;
+} jsrt_fetch_write_t;
+
+typedef struct jsrt_fetch_context {
+  JSRT_Runtime* rt;
+  jsrt_fetch_conn_t* conn;
+  char* pool_key;
+
+  char* url;
   char* host;
   int port;
   char* path;
@@ -38,9 +69,6 @@ typedef struct {
 
   jsrt_http_parser_t* parser;
 
-  char* request_buffer;
-  size_t request_len;
-
   char* response_buffer;
   size_t response_size;
   size_t response_capacity;
@@ -48,13 +76,22 @@ typedef struct {
   JSValue resolve_func;
   JSValue reject_func;
 
-  int connection_closed;
+  // Response body, streamed to JS once the headers are in
+  JSValue body_stream;
+  int responded;     // fetch() already resolved with the Response
+  int backpressure;  // The body stream queue filled up during the current read
+  int paused;        // Reading stopped until the body stream pulls again
+
+  int reused;    // Running on an idle pooled connection
+  int retried;   // Already retried once after a stale pooled connection
+  int received;  // Any response bytes seen on the current connection
 
   // SSL/TLS support
   jsrt_ssl_client_t* ssl_client;
 } jsrt_fetch_context_t;
 
 static int headers_copy_from_jsobject(JSContext* ctx, JSValue headers_map, JSValueConst source);
+static JSValue headers_create(JSContext* ctx, JSValueConst init);
 
 typedef enum {
   JSRT_HEADERS_ITERATOR_KEYS,
@@ -121,11 +158,12 @@ static void fetch_context_free(jsrt_fetch_context_t* ctx) {
     ctx->ssl_client = NULL;
   }
 
+  free(ctx->pool_key);
+  free(ctx->url);
   free(ctx->host);
   free(ctx->path);
   free(ctx->method);
   free(ctx->body);
-  free(ctx->request_buffer);
   free(ctx->response_buffer);
 
   if (ctx->headers) {
@@ -137,6 +175,14 @@ static void fetch_context_free(jsrt_fetch_context_t* ctx) {
   }
 
   if (ctx->rt && ctx->rt->ctx) {
+    if (!JS_IsUndefined(ctx->body_stream)) {
+      // No-op if the body already ended; otherwise readers learn the connection is gone
+      JSValue error = JS_NewError(ctx->rt->ctx);
+      JS_SetPropertyStr(ctx->rt->ctx, error, "message", JS_NewString(ctx->rt->ctx, "terminated"));
+      JSRT_ReadableStreamError(ctx->rt->ctx, ctx->body_stream, error);
+      JS_FreeValue(ctx->rt->ctx, error);
+      JS_FreeValue(ctx->rt->ctx, ctx->body_stream);
+    }
     if (!JS_IsUndefined(ctx->resolve_func)) {
       JS_FreeValue(ctx->rt->ctx, ctx->resolve_func);
     }
@@ -148,122 +194,572 @@ static void fetch_context_free(jsrt_fetch_context_t* ctx) {
   free(ctx);
 }
 
-static void on_close(uv_handle_t* handle) {
-  jsrt_fetch_context_t* ctx = (jsrt_fetch_context_t*)handle->data;
-  if (ctx) {
-    fetch_context_free(ctx);
+static void fetch_conn_on_close(uv_handle_t* handle) {
+  jsrt_fetch_conn_t* conn = (jsrt_fetch_conn_t*)handle->data;
+  free(conn->pool_key);
+  free(conn);
+}
+
+static void fetch_conn_close(jsrt_fetch_conn_t* conn) {
+  if (conn->closing)
+    return;
+
+  conn->closing = 1;
+  conn->active = NULL;
+  if (conn->tcp_initialized) {
+    uv_close((uv_handle_t*)&conn->tcp_handle, fetch_conn_on_close);
+  } else {
+    free(conn->pool_key);
+    free(conn);
+  }
+}
+
+static void fetch_pool_close(void* conn, void* opaque) {
+  fetch_conn_close((jsrt_fetch_conn_t*)conn);
+}
+
+// Detach the request from its connection, then park the connection in the pool or close it
+static void fetch_finish(jsrt_fetch_context_t* ctx, int reusable) {
+  jsrt_fetch_conn_t* conn = ctx->conn;
+  JSRT_ConnPool* pool = ctx->rt->http_pool;
+  char* pool_key = ctx->pool_key;
+  ctx->pool_key = NULL;
+  fetch_context_free(ctx);
+
+  if (conn) {
+    conn->active = NULL;
+  }
+
+  // The pool is gone once the runtime is shutting down
+  if (!pool_key || !pool) {
+    free(pool_key);
+    if (conn) {
+      fetch_conn_close(conn);
+    }
+    return;
+  }
+
+  if (conn && reusable && !conn->closing) {
+    // Idle connections must not keep the loop alive
+    uv_unref((uv_handle_t*)&conn->tcp_handle);
+    JSRT_ConnPoolRelease(pool, pool_key, conn, true);
+  } else {
+    JSRT_ConnPoolRelease(pool, pool_key, conn, false);
+    if (conn) {
+      fetch_conn_close(conn);
+    }
+  }
+  free(pool_key);
+}
+
+// Reject fetch(), or error the body stream once the Response was already handed out
+static void fetch_reject(jsrt_fetch_context_t* ctx, const char* message) {
+  JSContext* js_ctx = ctx->rt->ctx;
+  JSValue error = JS_NewError(js_ctx);
+  JS_SetPropertyStr(js_ctx, error, "message", JS_NewString(js_ctx, message));
+  if (ctx->responded) {
+    JSRT_ReadableStreamError(js_ctx, ctx->body_stream, error);
+  } else {
+    JS_Call(js_ctx, ctx->reject_func, JS_UNDEFINED, 1, &error);
+  }
+  JS_FreeValue(js_ctx, error);
+}
+
+static void fetch_fail(jsrt_fetch_context_t* ctx, const char* message) {
+  fetch_reject(ctx, message);
+  fetch_finish(ctx, 0);
+}
+
+static void fetch_acquire_connection(jsrt_fetch_context_t* ctx);
+
+// Methods that may be sent twice (RFC 9110 9.2.2): the server could have handled the first attempt
+static int fetch_method_idempotent(const char* method) {
+  static const char* const idempotent[] = {"GET", "HEAD", "OPTIONS", "PUT", "DELETE", "TRACE"};
+  for (size_t i = 0; i < sizeof(idempotent) / sizeof(idempotent[0]); i++) {
+    if (strcasecmp(method, idempotent[i]) == 0) {
+      return 1;
+    }
+  }
+  return 0;
+}
+
+// A pooled connection may have been closed by the server while idle; retry once on a fresh one
+static int fetch_retry_stale(jsrt_fetch_context_t* ctx) {
+  if (!ctx->reused || ctx->retried || ctx->received || !ctx->rt->http_pool || !fetch_method_idempotent(ctx->method)) {
+    return 0;
+  }
+
+  JSRT_Debug("JSRT_Fetch: pooled connection to %s:%d went stale, retrying", ctx->host, ctx->port);
+  jsrt_fetch_conn_t* conn = ctx->conn;
+  ctx->conn = NULL;
+  ctx->reused = 0;
+  ctx->retried = 1;
+
+  JSRT_ConnPoolRelease(ctx->rt->http_pool, ctx->pool_key, conn, false);
+  fetch_conn_close(conn);
+  fetch_acquire_connection(ctx);
+  return 1;
+}
+
+typedef enum {
+  JSRT_FETCH_BODY_TEXT,
+  JSRT_FETCH_BODY_JSON,
+  JSRT_FETCH_BODY_ARRAY_BUFFER,
+} jsrt_fetch_body_kind_t;
+
+static void alloc_buffer(uv_handle_t* handle, size_t suggested_size, uv_buf_t* buf);
+static void on_read(uv_stream_t* stream, ssize_t nread, const uv_buf_t* buf);
+
+// Stop reading until the body stream pulls; a paused response must not keep the loop alive
+static void fetch_pause(jsrt_fetch_context_t* ctx) {
+  uv_read_stop((uv_stream_t*)&ctx->conn->tcp_handle);
+  uv_unref((uv_handle_t*)&ctx->conn->tcp_handle);
+  ctx->paused = 1;
+}
+
+// A reader drained the body stream: resume reading from the socket
+static void fetch_body_pull(JSContext* js_ctx, void* opaque) {
+  jsrt_fetch_context_t* ctx = (jsrt_fetch_context_t*)opaque;
+  if (!ctx->paused || !ctx->conn) {
+    return;
+  }
+
+  ctx->paused = 0;
+  uv_ref((uv_handle_t*)&ctx->conn->tcp_handle);
+  int ret = uv_read_start((uv_stream_t*)&ctx->conn->tcp_handle, alloc_buffer, on_read);
+  if (ret != 0) {
+    char error_msg[256];
+    snprintf(error_msg, sizeof(error_msg), "Read start failed: %s", uv_strerror(ret));
+    fetch_fail(ctx, error_msg);
+  }
+}
+
+// The body was cancelled: the rest of it is never read, so the connection cannot be reused
+static void fetch_body_cancel(JSContext* js_ctx, void* opaque) {
+  fetch_finish((jsrt_fetch_context_t*)opaque, 0);
+}
+
+static const JSRT_ReadableStreamNativeSource fetch_body_source = {
+    .pull = fetch_body_pull,
+    .cancel = fetch_body_cancel,
+};
+
+// Headers with the same name are combined into one comma-separated value
+static JSValue fetch_response_headers(JSContext* ctx, jsrt_http_message_t* message) {
+  JSValue init = JS_NewObject(ctx);
+  if (JS_IsException(init)) {
+    return init;
+  }
+
+  for (jsrt_http_header_t* header = message->headers.first; header; header = header->next) {
+    size_t len = strlen(header->name);
+    char* name = malloc(len + 1);
+    if (!name) {
+      continue;
+    }
+    for (size_t i = 0; i < len; i++) {
+      name[i] = (char)tolower((unsigned char)header->name[i]);
+    }
+    name[len] = '\0';
+
+    JSValue previous = JS_GetPropertyStr(ctx, init, name);
+    if (JS_IsString(previous)) {
+      const char* previous_str = JS_ToCString(ctx, previous);
+      size_t combined_len = strlen(previous_str) + strlen(header->value) + 3;
+      char* combined = malloc(combined_len);
+      if (combined) {
+        snprintf(combined, combined_len, "%s, %s", previous_str, header->value);
+        JS_SetPropertyStr(ctx, init, name, JS_NewString(ctx, combined));
+        free(combined);
+      }
+      JS_FreeCString(ctx, previous_str);
+    } else {
+      JS_SetPropertyStr(ctx, init, name, JS_NewString(ctx, header->value));
+    }
+    JS_FreeValue(ctx, previous);
+    free(name);
+  }
+
+  JSValue headers = headers_create(ctx, init);
+  JS_FreeValue(ctx, init);
+  return headers;
+}
+
+// Copy the bytes of every chunk into data (when non-NULL) and return the total length
+static size_t response_body_join(JSContext* ctx, JSValueConst chunks, uint32_t count, uint8_t* data) {
+  size_t total = 0;
+  for (uint32_t i = 0; i < count; i++) {
+    JSValue chunk = JS_GetPropertyUint32(ctx, chunks, i);
+    size_t byte_offset = 0, byte_length = 0, size = 0;
+    JSValue array_buffer = JS_GetTypedArrayBuffer(ctx, chunk, &byte_offset, &byte_length, NULL);
+    uint8_t* bytes = JS_IsException(array_buffer) ? NULL : JS_GetArrayBuffer(ctx, &size, array_buffer);
+    if (bytes) {
+      if (data) {
+        memcpy(data + total, bytes + byte_offset, byte_length);
+      }
+      total += byte_length;
+    } else {
+      JS_FreeValue(ctx, JS_GetException(ctx));
+    }
+    JS_FreeValue(ctx, array_buffer);
+    JS_FreeValue(ctx, chunk);
+  }
+  return total;
+}
+
+static void response_body_settle(JSContext* ctx, JSValueConst chunks, JSValueConst resolve, JSValueConst reject,
+                                 jsrt_fetch_body_kind_t kind) {
+  uint32_t count = 0;
+  JSValue length_val = JS_GetPropertyStr(ctx, chunks, "length");
+  JS_ToUint32(ctx, &count, length_val);
+  JS_FreeValue(ctx, length_val);
+
+  // The extra byte NUL-terminates the text for JS_ParseJSON
+  size_t total = response_body_join(ctx, chunks, count, NULL);
+  uint8_t* data = malloc(total + 1);
+  JSValue result;
+  if (!data) {
+    result = JS_ThrowOutOfMemory(ctx);
+  } else {
+    response_body_join(ctx, chunks, count, data);
+    data[total] = '\0';
+    if (kind == JSRT_FETCH_BODY_TEXT) {
+      result = JS_NewStringLen(ctx, (const char*)data, total);
+    } else if (kind == JSRT_FETCH_BODY_JSON) {
+      result = JS_ParseJSON(ctx, (const char*)data, total, "<response>");
+    } else {
+      result = JS_NewArrayBufferCopy(ctx, data, total);
+    }
+    free(data);
+  }
+
+  if (JS_IsException(result)) {
+    JSValue error = JS_GetException(ctx);
+    JS_FreeValue(ctx, JS_Call(ctx, reject, JS_UNDEFINED, 1, &error));
+    JS_FreeValue(ctx, error);
+  } else {
+    JS_FreeValue(ctx, JS_Call(ctx, resolve, JS_UNDEFINED, 1, &result));
+    JS_FreeValue(ctx, result);
+  }
+}
+
+static void response_body_read_next(JSContext* ctx, JSValueConst* data, int kind);
+
+// One reader.read() settled; data is [reader, chunks, resolve, reject] and magic the body kind
+static JSValue response_body_on_read(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv, int magic,
+                                     JSValue* data) {
+  JSValueConst result = argc > 0 ? argv[0] : JS_UNDEFINED;
+  JSValue done = JS_GetPropertyStr(ctx, result, "done");
+  int is_done = JS_ToBool(ctx, done);
+  JS_FreeValue(ctx, done);
+
+  if (is_done) {
+    response_body_settle(ctx, data[1], data[2], data[3], (jsrt_fetch_body_kind_t)magic);
+    return JS_UNDEFINED;
+  }
+
+  uint32_t count = 0;
+  JSValue length_val = JS_GetPropertyStr(ctx, data[1], "length");
+  JS_ToUint32(ctx, &count, length_val);
+  JS_FreeValue(ctx, length_val);
+  JS_SetPropertyUint32(ctx, data[1], count, JS_GetPropertyStr(ctx, result, "value"));
+
+  response_body_read_next(ctx, (JSValueConst*)data, magic);
+  return JS_UNDEFINED;
+}
+
+static void response_body_read_next(JSContext* ctx, JSValueConst* data, int kind) {
+  JSValue read = JS_GetPropertyStr(ctx, data[0], "read");
+  JSValue promise = JS_Call(ctx, read, data[0], 0, NULL);
+  JS_FreeValue(ctx, read);
+  if (JS_IsException(promise)) {
+    JSValue error = JS_GetException(ctx);
+    JS_FreeValue(ctx, JS_Call(ctx, data[3], JS_UNDEFINED, 1, &error));
+    JS_FreeValue(ctx, error);
+    return;
+  }
+
+  JSValue then = JS_GetPropertyStr(ctx, promise, "then");
+  JSValue callbacks[] = {JS_NewCFunctionData(ctx, response_body_on_read, 1, kind, 4, data), JS_DupValue(ctx, data[3])};
+  JS_FreeValue(ctx, JS_Call(ctx, then, promise, 2, callbacks));
+  JS_FreeValue(ctx, callbacks[0]);
+  JS_FreeValue(ctx, callbacks[1]);
+  JS_FreeValue(ctx, then);
+  JS_FreeValue(ctx, promise);
+}
+
+// text(), json() and arrayBuffer() read the body stream to the end; magic is the body kind
+static JSValue response_consume_body(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv, int magic) {
+  JSValue resolving_funcs[2];
+  JSValue promise = JS_NewPromiseCapability(ctx, resolving_funcs);
+  if (JS_IsException(promise)) {
+    return promise;
   }
+
+  JSValue body_used = JS_GetPropertyStr(ctx, this_val, "bodyUsed");
+  JSValue body = JS_GetPropertyStr(ctx, this_val, "body");
+  JSValue reader = JS_UNDEFINED;
+  if (JS_ToBool(ctx, body_used)) {
+    JS_ThrowTypeError(ctx, "Body has already been consumed");
+  } else {
+    JS_SetPropertyStr(ctx, this_val, "bodyUsed", JS_TRUE);
+    JSValue get_reader = JS_GetPropertyStr(ctx, body, "getReader");
+    reader = JS_Call(ctx, get_reader, body, 0, NULL);
+    JS_FreeValue(ctx, get_reader);
+  }
+
+  if (JS_IsUndefined(reader) || JS_IsException(reader)) {
+    JSValue error = JS_GetException(ctx);
+    JS_FreeValue(ctx, JS_Call(ctx, resolving_funcs[1], JS_UNDEFINED, 1, &error));
+    JS_FreeValue(ctx, error);
+  } else {
+    JSValue data[] = {reader, JS_NewArray(ctx), resolving_funcs[0], resolving_funcs[1]};
+    response_body_read_next(ctx, data, magic);
+    JS_FreeValue(ctx, data[1]);
+  }
+
+  JS_FreeValue(ctx, reader);
+  JS_FreeValue(ctx, body);
+  JS_FreeValue(ctx, body_used);
+  JS_FreeValue(ctx, resolving_funcs[0]);
+  JS_FreeValue(ctx, resolving_funcs[1]);
+  return promise;
+}
+
+static JSValue fetch_response_new(JSContext* js_ctx, jsrt_fetch_context_t* ctx, jsrt_http_message_t* message) {
+  JSValue headers = fetch_response_headers(js_ctx, message);
+  if (JS_IsException(headers)) {
+    return headers;
+  }
+
+  JSValue obj = JS_NewObject(js_ctx);
+  if (JS_IsException(obj)) {
+    JS_FreeValue(js_ctx, headers);
+    return obj;
+  }
+
+  int status = message->status_code;
+  JS_SetPropertyStr(js_ctx, obj, "status", JS_NewInt32(js_ctx, status));
+  JS_SetPropertyStr(js_ctx, obj, "ok", JS_NewBool(js_ctx, status >= 200 && status < 300));
+  JS_SetPropertyStr(js_ctx, obj, "statusText",
+                    JS_NewString(js_ctx, message->status_message ? message->status_message : ""));
+  JS_SetPropertyStr(js_ctx, obj, "url", JS_NewString(js_ctx, ctx->url ? ctx->url : ""));
+  JS_SetPropertyStr(js_ctx, obj, "headers", headers);
+  JS_SetPropertyStr(js_ctx, obj, "body", JS_DupValue(js_ctx, ctx->body_stream));
+  JS_SetPropertyStr(js_ctx, obj, "bodyUsed", JS_FALSE);
+
+  JS_SetPropertyStr(js_ctx, obj, "text",
+                    JS_NewCFunctionMagic(js_ctx, response_consume_body, "text", 0, JS_CFUNC_generic_magic,
+                                         JSRT_FETCH_BODY_TEXT));
+  JS_SetPropertyStr(js_ctx, obj, "json",
+                    JS_NewCFunctionMagic(js_ctx, response_consume_body, "json", 0, JS_CFUNC_generic_magic,
+                                         JSRT_FETCH_BODY_JSON));
+  JS_SetPropertyStr(js_ctx, obj, "arrayBuffer",
+                    JS_NewCFunctionMagic(js_ctx, response_consume_body, "arrayBuffer", 0, JS_CFUNC_generic_magic,
+                                         JSRT_FETCH_BODY_ARRAY_BUFFER));
+  return obj;
+}
+
+// Parser hook: the status line and headers are in, so resolve fetch() and stream the body from here on
+static int fetch_on_headers(jsrt_http_parser_t* parser) {
+  jsrt_fetch_context_t* ctx = (jsrt_fetch_context_t*)parser->user_data;
+  jsrt_http_message_t* message = parser->current_message;
+
+  // Interim 1xx responses are followed by the final one
+  if (message->status_code < 200 || ctx->responded) {
+    return 0;
+  }
+
+  JSContext* js_ctx = ctx->rt->ctx;
+  ctx->body_stream = JSRT_ReadableStreamNewNative(js_ctx, &fetch_body_source, ctx, JSRT_FETCH_BODY_HIGH_WATER_MARK);
+  JSValue response = JS_IsException(ctx->body_stream) ? JS_EXCEPTION : fetch_response_new(js_ctx, ctx, message);
+  if (JS_IsException(response)) {
+    JS_FreeValue(js_ctx, JS_GetException(js_ctx));
+    if (JS_IsException(ctx->body_stream)) {
+      ctx->body_stream = JS_UNDEFINED;
+    }
+    return -1;
+  }
+
+  ctx->responded = 1;
+  JS_FreeValue(js_ctx, JS_Call(js_ctx, ctx->resolve_func, JS_UNDEFINED, 1, &response));
+  JS_FreeValue(js_ctx, response);
+
+  // Responses to HEAD never carry a body, whatever Content-Length says
+  return strcasecmp(ctx->method, "HEAD") == 0 ? 1 : 0;
+}
+
+// Parser hook: queue each body chunk on the stream as a Uint8Array
+static int fetch_on_body(jsrt_http_parser_t* parser, const char* at, size_t length) {
+  jsrt_fetch_context_t* ctx = (jsrt_fetch_context_t*)parser->user_data;
+  if (!ctx->responded) {
+    return 0;
+  }
+
+  JSContext* js_ctx = ctx->rt->ctx;
+  JSValue array_buffer = JS_NewArrayBufferCopy(js_ctx, (const uint8_t*)at, length);
+  JSValue chunk = JS_IsException(array_buffer) ? JS_EXCEPTION
+                                               : JS_NewTypedArray(js_ctx, 1, &array_buffer, JS_TYPED_ARRAY_UINT8);
+  JS_FreeValue(js_ctx, array_buffer);
+  if (JS_IsException(chunk)) {
+    JS_FreeValue(js_ctx, JS_GetException(js_ctx));
+    return -1;
+  }
+
+  if (JSRT_ReadableStreamEnqueue(js_ctx, ctx->body_stream, chunk) <= 0) {
+    ctx->backpressure = 1;
+  }
+  JS_FreeValue(js_ctx, chunk);
+  return 0;
+}
+
+// The whole response arrived: end the body stream and hand the connection back
+static void fetch_complete(jsrt_fetch_context_t* ctx, int reusable) {
+  JSRT_ReadableStreamClose(ctx->rt->ctx, ctx->body_stream);
+  fetch_finish(ctx, reusable);
 }
 
 static void on_read(uv_stream_t* stream, ssize_t nread, const uv_buf_t* buf) {
-  jsrt_fetch_context_t* ctx = (jsrt_fetch_context_t*)stream->data;
+  jsrt_fetch_conn_t* conn = (jsrt_fetch_conn_t*)stream->data;
+  jsrt_fetch_context_t* ctx = conn->active;
+
+  if (!ctx) {
+    // Anything arriving on an idle connection (usually EOF) means it can no longer be reused
+    JSRT_ReadSlabRelease((uv_handle_t*)stream, buf, 0);
+    if (nread != 0 && !conn->closing) {
+      if (conn->pool_key && conn->rt->http_pool) {
+        JSRT_ConnPoolRemoveIdle(conn->rt->http_pool, conn->pool_key, conn);
+      }
+      fetch_conn_close(conn);
+    }
+    return;
+  }
 
-  if (!ctx || !ctx->rt || !ctx->rt->ctx) {
-    if (buf->base)
-      free(buf->base);
+  if (!ctx->rt || !ctx->rt->ctx) {
+    JSRT_ReadSlabRelease((uv_handle_t*)stream, buf, 0);
     return;
   }
 
   if (nread < 0) {
+    JSRT_ReadSlabRelease((uv_handle_t*)stream, buf, 0);
+    if (fetch_retry_stale(ctx)) {
+      return;
+    }
+
     if (nread == UV_EOF) {
-      // Force complete parsing on EOF
-      if (ctx->parser && ctx->parser->current_message) {
-        // Try to finish parsing with empty data to trigger completion
-        jsrt_http_parser_execute(ctx->parser, "", 0);
-
-        if (ctx->parser->current_message->status_code > 0) {
-          // We have a valid response, mark as complete if not already
-          if (!ctx->parser->current_message->complete) {
-            ctx->parser->current_message->complete = 1;
-          }
-          JSValue response_obj = jsrt_http_message_to_js(ctx->rt->ctx, ctx->parser->current_message);
-          JS_Call(ctx->rt->ctx, ctx->resolve_func, JS_UNDEFINED, 1, &response_obj);
-          JS_FreeValue(ctx->rt->ctx, response_obj);
-        } else {
-          JSValue error = JS_NewError(ctx->rt->ctx);
-          JS_SetPropertyStr(ctx->rt->ctx, error, "message", JS_NewString(ctx->rt->ctx, "Incomplete HTTP response"));
-          JS_Call(ctx->rt->ctx, ctx->reject_func, JS_UNDEFINED, 1, &error);
-          JS_FreeValue(ctx->rt->ctx, error);
-        }
-      } else {
-        JSValue error = JS_NewError(ctx->rt->ctx);
-        JS_SetPropertyStr(ctx->rt->ctx, error, "message", JS_NewString(ctx->rt->ctx, "No HTTP response received"));
-        JS_Call(ctx->rt->ctx, ctx->reject_func, JS_UNDEFINED, 1, &error);
-        JS_FreeValue(ctx->rt->ctx, error);
+      // A body without Content-Length or chunked framing ends with the connection
+      jsrt_http_parser_finish(ctx->parser);
+      jsrt_http_message_t* message = ctx->parser->current_message;
+      if (ctx->responded && message && message->complete) {
+        fetch_complete(ctx, 0);
+        return;
       }
+      fetch_reject(ctx, ctx->responded ? "Incomplete HTTP response" : "No HTTP response received");
     } else {
-      JSValue error = JS_NewError(ctx->rt->ctx);
       char error_msg[256];
       snprintf(error_msg, sizeof(error_msg), "Read error: %s", uv_strerror(nread));
-      JS_SetPropertyStr(ctx->rt->ctx, error, "message", JS_NewString(ctx->rt->ctx, error_msg));
-      JS_Call(ctx->rt->ctx, ctx->reject_func, JS_UNDEFINED, 1, &error);
-      JS_FreeValue(ctx->rt->ctx, error);
+      fetch_reject(ctx, error_msg);
     }
 
-    uv_close((uv_handle_t*)&ctx->tcp_handle, on_close);
-    if (buf->base)
-      free(buf->base);
+    fetch_finish(ctx, 0);
     return;
   }
 
   if (nread > 0) {
+    ctx->received = 1;
+    ctx->backpressure = 0;
     jsrt_http_error_t result = jsrt_http_parser_execute(ctx->parser, buf->base, nread);
+    JSRT_ReadSlabRelease((uv_handle_t*)stream, buf, 0);
 
     if (result != JSRT_HTTP_OK && result != JSRT_HTTP_ERROR_INCOMPLETE) {
-      JSValue error = JS_NewError(ctx->rt->ctx);
-      JS_SetPropertyStr(ctx->rt->ctx, error, "message", JS_NewString(ctx->rt->ctx, "HTTP parsing error"));
-      JS_Call(ctx->rt->ctx, ctx->reject_func, JS_UNDEFINED, 1, &error);
-      JS_FreeValue(ctx->rt->ctx, error);
-      uv_close((uv_handle_t*)&ctx->tcp_handle, on_close);
-    } else if (ctx->parser->current_message && ctx->parser->current_message->complete) {
-      JSValue response_obj = jsrt_http_message_to_js(ctx->rt->ctx, ctx->parser->current_message);
-      JS_Call(ctx->rt->ctx, ctx->resolve_func, JS_UNDEFINED, 1, &response_obj);
-      JS_FreeValue(ctx->rt->ctx, response_obj);
-      uv_close((uv_handle_t*)&ctx->tcp_handle, on_close);
+      fetch_fail(ctx, "HTTP parsing error");
+    } else if (ctx->responded && ctx->parser->current_message && ctx->parser->current_message->complete) {
+      fetch_complete(ctx, llhttp_should_keep_alive(&ctx->parser->parser));
+    } else if (ctx->backpressure) {
+      fetch_pause(ctx);
     }
+    return;
   }
 
-  if (buf->base)
-    free(buf->base);
+  JSRT_ReadSlabRelease((uv_handle_t*)stream, buf, 0);
 }
 
 static void alloc_buffer(uv_handle_t* handle, size_t suggested_size, uv_buf_t* buf) {
-  buf->base = malloc(suggested_size);
-  buf->len = suggested_size;
+  JSRT_ReadSlabAlloc(handle, suggested_size, buf);
 }
 
 static void on_write(uv_write_t* req, int status) {
-  if (status != 0) {
-    jsrt_fetch_context_t* ctx = (jsrt_fetch_context_t*)req->handle->data;
-    if (ctx && ctx->rt && ctx->rt->ctx) {
-      JSValue error = JS_NewError(ctx->rt->ctx);
-      char error_msg[256];
-      snprintf(error_msg, sizeof(error_msg), "Write failed: %s", uv_strerror(status));
-      JS_SetPropertyStr(ctx->rt->ctx, error, "message", JS_NewString(ctx->rt->ctx, error_msg));
-      JS_Call(ctx->rt->ctx, ctx->reject_func, JS_UNDEFINED, 1, &error);
-      JS_FreeValue(ctx->rt->ctx, error);
-      uv_close((uv_handle_t*)&ctx->tcp_handle, on_close);
+  jsrt_fetch_write_t* write = (jsrt_fetch_write_t*)req;
+  jsrt_fetch_conn_t* conn = (jsrt_fetch_conn_t*)req->handle->data;
+  free(write->buffer);
+  free(write);
+
+  if (status == 0 || status == UV_ECANCELED || !conn->active) {
+    return;
+  }
+
+  jsrt_fetch_context_t* ctx = conn->active;
+  if (ctx->rt && ctx->rt->ctx && !fetch_retry_stale(ctx)) {
+    char error_msg[256];
+    snprintf(error_msg, sizeof(error_msg), "Write failed: %s", uv_strerror(status));
+    fetch_fail(ctx, error_msg);
+  }
+}
+
+static int fetch_has_header(jsrt_header_entry_t* headers, const char* name) {
+  for (; headers; headers = headers->next) {
+    if (strcasecmp(headers->name, name) == 0) {
+      return 1;
     }
   }
+  return 0;
+}
+
+// Serialize the request and write it to the request's connection
+static void fetch_send_request(jsrt_fetch_context_t* ctx) {
+  // Pooled connections ask the server to keep the connection open
+  if (ctx->pool_key && !fetch_has_header(ctx->headers, "Connection")) {
+    jsrt_http_header_add((jsrt_http_header_entry_t**)&ctx->headers, "Connection", "keep-alive");
+  }
+
+  jsrt_fetch_write_t* write = malloc(sizeof(jsrt_fetch_write_t));
+  if (!write) {
+    fetch_fail(ctx, "Out of memory");
+    return;
+  }
+
+  write->buffer =
+      build_http_request(ctx->method, ctx->path, ctx->host, ctx->port, ctx->body, ctx->body_len, ctx->headers);
+  if (!write->buffer) {
+    free(write);
+    fetch_fail(ctx, "Failed to build HTTP request");
+    return;
+  }
+
+  uv_buf_t write_buf = uv_buf_init(write->buffer, strlen(write->buffer));
+  int ret = uv_write(&write->req, (uv_stream_t*)&ctx->conn->tcp_handle, &write_buf, 1, on_write);
+  if (ret != 0) {
+    free(write->buffer);
+    free(write);
+    char error_msg[256];
+    snprintf(error_msg, sizeof(error_msg), "Write failed: %s", uv_strerror(ret));
+    fetch_fail(ctx, error_msg);
+  }
 }
 
 static void on_connect(uv_connect_t* req, int status) {
-  jsrt_fetch_context_t* ctx = (jsrt_fetch_context_t*)req->data;
+  jsrt_fetch_conn_t* conn = (jsrt_fetch_conn_t*)req->data;
+  jsrt_fetch_context_t* ctx = conn->active;
 
   if (!ctx || !ctx->rt || !ctx->rt->ctx) {
-    if (ctx)
-      fetch_context_free(ctx);
+    fetch_conn_close(conn);
     return;
   }
 
   if (status != 0) {
-    JSValue error = JS_NewError(ctx->rt->ctx);
     char error_msg[256];
     snprintf(error_msg, sizeof(error_msg), "Connection failed: %s", uv_strerror(status));
-    JS_SetPropertyStr(ctx->rt->ctx, error, "message", JS_NewString(ctx->rt->ctx, error_msg));
-    JS_Call(ctx->rt->ctx, ctx->reject_func, JS_UNDEFINED, 1, &error);
-    JS_FreeValue(ctx->rt->ctx, error);
-    fetch_context_free(ctx);
+    fetch_fail(ctx, error_msg);
     return;
   }
 
@@ -271,157 +767,195 @@ static void on_connect(uv_connect_t* req, int status) {
   if (ctx->is_https) {
     // Initialize SSL global functions first
     if (!jsrt_ssl_global_init()) {
-      JSValue error = JS_NewError(ctx->rt->ctx);
-      JS_SetPropertyStr(ctx->rt->ctx, error, "message", JS_NewString(ctx->rt->ctx, "SSL/TLS functions not available"));
-      JS_Call(ctx->rt->ctx, ctx->reject_func, JS_UNDEFINED, 1, &error);
-      JS_FreeValue(ctx->rt->ctx, error);
-      fetch_context_free(ctx);
+      fetch_fail(ctx, "SSL/TLS functions not available");
       return;
     }
 
     // Create SSL client
     ctx->ssl_client = jsrt_ssl_client_new();
     if (!ctx->ssl_client) {
-      JSValue error = JS_NewError(ctx->rt->ctx);
-      JS_SetPropertyStr(ctx->rt->ctx, error, "message", JS_NewString(ctx->rt->ctx, "Failed to create SSL client"));
-      JS_Call(ctx->rt->ctx, ctx->reject_func, JS_UNDEFINED, 1, &error);
-      JS_FreeValue(ctx->rt->ctx, error);
-      fetch_context_free(ctx);
+      fetch_fail(ctx, "Failed to create SSL client");
       return;
     }
 
     // Get the file descriptor from the TCP handle
     int fd;
-    int ret = uv_fileno((uv_handle_t*)&ctx->tcp_handle, (uv_os_fd_t*)&fd);
+    int ret = uv_fileno((uv_handle_t*)&conn->tcp_handle, (uv_os_fd_t*)&fd);
     if (ret != 0) {
-      JSValue error = JS_NewError(ctx->rt->ctx);
       char error_msg[256];
       snprintf(error_msg, sizeof(error_msg), "Failed to get socket descriptor: %s", uv_strerror(ret));
-      JS_SetPropertyStr(ctx->rt->ctx, error, "message", JS_NewString(ctx->rt->ctx, error_msg));
-      JS_Call(ctx->rt->ctx, ctx->reject_func, JS_UNDEFINED, 1, &error);
-      JS_FreeValue(ctx->rt->ctx, error);
-      fetch_context_free(ctx);
+      fetch_fail(ctx, error_msg);
       return;
     }
 
     // Setup SSL client for this connection
     if (jsrt_ssl_client_setup(ctx->ssl_client, fd, ctx->host) != 0) {
-      JSValue error = JS_NewError(ctx->rt->ctx);
-      JS_SetPropertyStr(ctx->rt->ctx, error, "message", JS_NewString(ctx->rt->ctx, "Failed to setup SSL client"));
-      JS_Call(ctx->rt->ctx, ctx->reject_func, JS_UNDEFINED, 1, &error);
-      JS_FreeValue(ctx->rt->ctx, error);
-      fetch_context_free(ctx);
+      fetch_fail(ctx, "Failed to setup SSL client");
       return;
     }
 
     // Perform SSL handshake
     int handshake_ret = jsrt_ssl_client_handshake(ctx->ssl_client);
     if (handshake_ret != 1) {
-      JSValue error = JS_NewError(ctx->rt->ctx);
-      JS_SetPropertyStr(ctx->rt->ctx, error, "message", JS_NewString(ctx->rt->ctx, "SSL handshake failed"));
-      JS_Call(ctx->rt->ctx, ctx->reject_func, JS_UNDEFINED, 1, &error);
-      JS_FreeValue(ctx->rt->ctx, error);
-      fetch_context_free(ctx);
+      fetch_fail(ctx, "SSL handshake failed");
       return;
     }
 
     JSRT_Debug("JSRT_Fetch: SSL handshake successful for %s:%d", ctx->host, ctx->port);
   }
 
-  int ret = uv_read_start((uv_stream_t*)&ctx->tcp_handle, alloc_buffer, on_read);
+  int ret = uv_read_start((uv_stream_t*)&conn->tcp_handle, alloc_buffer, on_read);
   if (ret != 0) {
-    JSValue error = JS_NewError(ctx->rt->ctx);
     char error_msg[256];
     snprintf(error_msg, sizeof(error_msg), "Read start failed: %s", uv_strerror(ret));
-    JS_SetPropertyStr(ctx->rt->ctx, error, "message", JS_NewString(ctx->rt->ctx, error_msg));
-    JS_Call(ctx->rt->ctx, ctx->reject_func, JS_UNDEFINED, 1, &error);
-    JS_FreeValue(ctx->rt->ctx, error);
-    fetch_context_free(ctx);
-    return;
-  }
-
-  ctx->request_buffer =
-      build_http_request(ctx->method, ctx->path, ctx->host, ctx->port, ctx->body, ctx->body_len, ctx->headers);
-  if (!ctx->request_buffer) {
-    JSValue error = JS_NewError(ctx->rt->ctx);
-    JS_SetPropertyStr(ctx->rt->ctx, error, "message", JS_NewString(ctx->rt->ctx, "Failed to build HTTP request"));
-    JS_Call(ctx->rt->ctx, ctx->reject_func, JS_UNDEFINED, 1, &error);
-    JS_FreeValue(ctx->rt->ctx, error);
-    fetch_context_free(ctx);
+    fetch_fail(ctx, error_msg);
     return;
   }
 
-  ctx->request_len = strlen(ctx->request_buffer);
-  uv_buf_t write_buf = uv_buf_init(ctx->request_buffer, ctx->request_len);
-
-  ret = uv_write(&ctx->write_req, (uv_stream_t*)&ctx->tcp_handle, &write_buf, 1, on_write);
-  if (ret != 0) {
-    JSValue error = JS_NewError(ctx->rt->ctx);
-    char error_msg[256];
-    snprintf(error_msg, sizeof(error_msg), "Write failed: %s", uv_strerror(ret));
-    JS_SetPropertyStr(ctx->rt->ctx, error, "message", JS_NewString(ctx->rt->ctx, error_msg));
-    JS_Call(ctx->rt->ctx, ctx->reject_func, JS_UNDEFINED, 1, &error);
-    JS_FreeValue(ctx->rt->ctx, error);
-    fetch_context_free(ctx);
-  }
+  fetch_send_request(ctx);
 }
 
 static void on_resolve(uv_getaddrinfo_t* req, int status, struct addrinfo* res) {
-  jsrt_fetch_context_t* ctx = (jsrt_fetch_context_t*)req->data;
+  jsrt_fetch_conn_t* conn = (jsrt_fetch_conn_t*)req->data;
+  jsrt_fetch_context_t* ctx = conn->active;
 
   if (!ctx || !ctx->rt || !ctx->rt->ctx) {
-    if (ctx)
-      fetch_context_free(ctx);
+    fetch_conn_close(conn);
     if (res)
       uv_freeaddrinfo(res);
     return;
   }
 
   if (status != 0) {
-    JSValue error = JS_NewError(ctx->rt->ctx);
     char error_msg[256];
     snprintf(error_msg, sizeof(error_msg), "DNS resolution failed: %s", uv_strerror(status));
-    JS_SetPropertyStr(ctx->rt->ctx, error, "message", JS_NewString(ctx->rt->ctx, error_msg));
-    JS_Call(ctx->rt->ctx, ctx->reject_func, JS_UNDEFINED, 1, &error);
-    JS_FreeValue(ctx->rt->ctx, error);
-    fetch_context_free(ctx);
+    fetch_fail(ctx, error_msg);
     if (res)
       uv_freeaddrinfo(res);
     return;
   }
 
-  int ret = uv_tcp_init(ctx->rt->uv_loop, &ctx->tcp_handle);
+  int ret = uv_tcp_init(ctx->rt->uv_loop, &conn->tcp_handle);
   if (ret != 0) {
-    JSValue error = JS_NewError(ctx->rt->ctx);
     char error_msg[256];
     snprintf(error_msg, sizeof(error_msg), "TCP initialization failed: %s", uv_strerror(ret));
-    JS_SetPropertyStr(ctx->rt->ctx, error, "message", JS_NewString(ctx->rt->ctx, error_msg));
-    JS_Call(ctx->rt->ctx, ctx->reject_func, JS_UNDEFINED, 1, &error);
-    JS_FreeValue(ctx->rt->ctx, error);
-    fetch_context_free(ctx);
+    fetch_fail(ctx, error_msg);
     if (res)
       uv_freeaddrinfo(res);
     return;
   }
 
-  ctx->tcp_handle.data = ctx;
-  ctx->connect_req.data = ctx;
+  conn->tcp_initialized = 1;
+  conn->tcp_handle.data = conn;
+  conn->connect_req.data = conn;
 
-  ret = uv_tcp_connect(&ctx->connect_req, &ctx->tcp_handle, (const struct sockaddr*)res->ai_addr, on_connect);
+  ret = uv_tcp_connect(&conn->connect_req, &conn->tcp_handle, (const struct sockaddr*)res->ai_addr, on_connect);
   if (ret != 0) {
-    JSValue error = JS_NewError(ctx->rt->ctx);
     char error_msg[256];
     snprintf(error_msg, sizeof(error_msg), "TCP connect failed: %s", uv_strerror(ret));
-    JS_SetPropertyStr(ctx->rt->ctx, error, "message", JS_NewString(ctx->rt->ctx, error_msg));
-    JS_Call(ctx->rt->ctx, ctx->reject_func, JS_UNDEFINED, 1, &error);
-    JS_FreeValue(ctx->rt->ctx, error);
-    fetch_context_free(ctx);
+    fetch_fail(ctx, error_msg);
   }
 
   if (res)
     uv_freeaddrinfo(res);
 }
 
+// Open a new connection for the request, starting with DNS resolution
+static void fetch_open_connection(jsrt_fetch_context_t* ctx) {
+  jsrt_fetch_conn_t* conn = calloc(1, sizeof(jsrt_fetch_conn_t));
+  if (conn && ctx->pool_key) {
+    conn->pool_key = strdup(ctx->pool_key);
+    if (!conn->pool_key) {
+      free(conn);
+      conn = NULL;
+    }
+  }
+  if (!conn) {
+    fetch_fail(ctx, "Out of memory");
+    return;
+  }
+
+  conn->rt = ctx->rt;
+  conn->active = ctx;
+  conn->dns_req.data = conn;
+  ctx->conn = conn;
+
+  struct addrinfo hints;
+  memset(&hints, 0, sizeof(hints));
+  hints.ai_family = AF_INET;
+  hints.ai_socktype = SOCK_STREAM;
+
+  char port_str[16];
+  snprintf(port_str, sizeof(port_str), "%d", ctx->port);
+
+  int ret = uv_getaddrinfo(ctx->rt->uv_loop, &conn->dns_req, on_resolve, ctx->host, port_str, &hints);
+  if (ret != 0) {
+    char error_msg[256];
+    snprintf(error_msg, sizeof(error_msg), "DNS resolution start failed: %s", uv_strerror(ret));
+    fetch_fail(ctx, error_msg);
+  }
+}
+
+// The pool handed this request an idle connection to reuse, or a slot for a new one
+static void fetch_on_pool_ready(void* pooled, void* data) {
+  jsrt_fetch_context_t* ctx = (jsrt_fetch_context_t*)data;
+  if (!pooled) {
+    fetch_open_connection(ctx);
+    return;
+  }
+
+  jsrt_fetch_conn_t* conn = (jsrt_fetch_conn_t*)pooled;
+  JSRT_Debug("JSRT_Fetch: reusing pooled connection to %s", conn->pool_key);
+  uv_ref((uv_handle_t*)&conn->tcp_handle);
+  conn->active = ctx;
+  ctx->conn = conn;
+  ctx->reused = 1;
+  ctx->received = 0;
+  fetch_send_request(ctx);
+}
+
+static void fetch_acquire_connection(jsrt_fetch_context_t* ctx) {
+  JSRT_Runtime* rt = ctx->rt;
+  if (ctx->is_https) {
+    fetch_open_connection(ctx);
+    return;
+  }
+
+  if (!rt->http_pool) {
+    JSRT_ConnPoolOptions options = {
+        .max_sockets = 0,
+        .max_free_sockets = JSRT_FETCH_POOL_MAX_FREE_SOCKETS,
+        .idle_timeout_ms = JSRT_FETCH_POOL_IDLE_TIMEOUT_MS,
+    };
+    rt->http_pool = JSRT_ConnPoolNew(rt->uv_loop, &options, fetch_pool_close, NULL);
+    if (!rt->http_pool) {
+      fetch_open_connection(ctx);
+      return;
+    }
+  }
+
+  if (!ctx->pool_key) {
+    char key[512];
+    snprintf(key, sizeof(key), "%s:%d", ctx->host, ctx->port);
+    ctx->pool_key = strdup(key);
+    if (!ctx->pool_key) {
+      fetch_fail(ctx, "Out of memory");
+      return;
+    }
+  }
+
+  void* pooled = NULL;
+  int ret = JSRT_ConnPoolAcquire(rt->http_pool, ctx->pool_key, &pooled, fetch_on_pool_ready, ctx);
+  if (ret < 0) {
+    // No slot was taken, so the pool must not be released for this request
+    free(ctx->pool_key);
+    ctx->pool_key = NULL;
+    fetch_fail(ctx, "Out of memory");
+  } else if (ret > 0) {
+    fetch_on_pool_ready(pooled, ctx);
+  }
+}
+
 // Headers class implementation
 static JSValue headers_get(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
   if (argc < 1) {
@@ -1254,7 +1788,9 @@ JSValue jsrt_fetch(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst
   fetch_ctx->rt = JS_GetContextOpaque(ctx);
   fetch_ctx->resolve_func = JS_DupValue(ctx, resolving_funcs[0]);
   fetch_ctx->reject_func = JS_DupValue(ctx, resolving_funcs[1]);
+  fetch_ctx->body_stream = JS_UNDEFINED;
   fetch_ctx->method = strdup("GET");
+  fetch_ctx->url = strdup(url);
 
   if (parse_url(url, &fetch_ctx->host, &fetch_ctx->port, &fetch_ctx->path, &fetch_ctx->is_https) != 0) {
     JSValue error = JS_NewError(ctx);
@@ -1355,27 +1891,11 @@ JSValue jsrt_fetch(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst
     fetch_context_free(fetch_ctx);
     goto cleanup;
   }
+  fetch_ctx->parser->user_data = fetch_ctx;
+  fetch_ctx->parser->on_headers = fetch_on_headers;
+  fetch_ctx->parser->on_body = fetch_on_body;
 
-  fetch_ctx->dns_req.data = fetch_ctx;
-
-  struct addrinfo hints;
-  memset(&hints, 0, sizeof(hints));
-  hints.ai_family = AF_INET;
-  hints.ai_socktype = SOCK_STREAM;
-
-  char port_str[16];
-  snprintf(port_str, sizeof(port_str), "%d", fetch_ctx->port);
-
-  int ret = uv_getaddrinfo(fetch_ctx->rt->uv_loop, &fetch_ctx->dns_req, on_resolve, fetch_ctx->host, port_str, &hints);
-  if (ret != 0) {
-    JSValue error = JS_NewError(ctx);
-    char error_msg[256];
-    snprintf(error_msg, sizeof(error_msg), "DNS resolution start failed: %s", uv_strerror(ret));
-    JS_SetPropertyStr(ctx, error, "message", JS_NewString(ctx, error_msg));
-    JS_Call(ctx, fetch_ctx->reject_func, JS_UNDEFINED, 1, &error);
-    JS_FreeValue(ctx, error);
-    fetch_context_free(fetch_ctx);
-  }
+  fetch_acquire_connection(fetch_ctx);
 
 cleanup:
   JS_FreeValue(ctx, resolving_funcs[0]);
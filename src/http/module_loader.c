@@ -2,7 +2,10 @@
 #include "../../deps/quickjs/quickjs.h"
 #include "../util/debug.h"
 #include "../util/http_client.h"
+#include "../util/macro.h"
 #include "cache.h"
+#include "disk_cache.h"
+#include "prefetch.h"
 #include "security.h"
 
 #include <stdio.h>
@@ -10,7 +13,14 @@
 #include <string.h>
 
 // Global HTTP module cache
-static JSRT_HttpCache* g_http_cache = NULL;
+static JSRT_THREAD_LOCAL JSRT_HttpCache* g_http_cache = NULL;
+
+// Persistent cache shared with other processes; NULL when disabled
+static JSRT_THREAD_LOCAL JSRT_HttpDiskCache* g_http_disk_cache = NULL;
+static JSRT_THREAD_LOCAL bool g_http_disk_cache_opened = false;
+
+// Downloads the static imports of loaded modules ahead of QuickJS; NULL when disabled
+static JSRT_THREAD_LOCAL JSRT_HttpPrefetch* g_http_prefetch = NULL;
 
 // Helper function to clean HTTP response content for JavaScript parsing
 static char* clean_js_content(const char* source, size_t source_len, size_t* cleaned_len) {
@@ -63,8 +73,9 @@ static char* clean_js_content(const char* source, size_t source_len, size_t* cle
   return cleaned;
 }
 
-// Helper function to compile module from string
-static JSModuleDef* compile_module_from_string(JSContext* ctx, const char* url, const char* source, size_t source_len) {
+// Helper function to compile module from string; with a disk cache entry, its bytecode is saved for the next run
+static JSModuleDef* compile_module_from_string(JSContext* ctx, const char* url, const char* source, size_t source_len,
+                                               const JSRT_HttpDiskCacheEntry* disk_entry) {
   // Clean the source content first
   size_t cleaned_len;
   char* cleaned_source = clean_js_content(source, source_len, &cleaned_len);
@@ -83,12 +94,46 @@ static JSModuleDef* compile_module_from_string(JSContext* ctx, const char* url,
     return NULL;
   }
 
+  if (disk_entry) {
+    size_t code_size = 0;
+    uint8_t* code = JS_WriteObject(ctx, &code_size, func_val, JS_WRITE_OBJ_BYTECODE);
+    if (code) {
+      jsrt_http_disk_cache_put_code(g_http_disk_cache, disk_entry, code, code_size);
+      js_free(ctx, code);
+    }
+  }
+
   JSModuleDef* module = JS_VALUE_GET_PTR(func_val);
   JS_FreeValue(ctx, func_val);
 
   return module;
 }
 
+// Load a module from the disk cache, from its bytecode when that is usable and from source otherwise
+static JSModuleDef* load_module_from_disk_cache(JSContext* ctx, const char* url, const JSRT_HttpDiskCacheEntry* entry) {
+  size_t code_size = 0;
+  uint8_t* code = jsrt_http_disk_cache_get_code(g_http_disk_cache, entry, &code_size);
+  if (code) {
+    JSValue func_val = JS_ReadObject(ctx, code, code_size, JS_READ_OBJ_BYTECODE);
+    free(code);
+    if (!JS_IsException(func_val) && JS_VALUE_GET_TAG(func_val) == JS_TAG_MODULE) {
+      JSRT_Debug("jsrt_load_http_module: loaded bytecode from disk cache for '%s'", url);
+      JSModuleDef* module = JS_VALUE_GET_PTR(func_val);
+      JS_FreeValue(ctx, func_val);
+      return module;
+    }
+    // Unreadable bytecode: drop the error and compile the verified source instead
+    if (JS_IsException(func_val)) {
+      JS_FreeValue(ctx, JS_GetException(ctx));
+    } else {
+      JS_FreeValue(ctx, func_val);
+    }
+  }
+
+  JSRT_Debug("jsrt_load_http_module: compiling disk cached source for '%s'", url);
+  return compile_module_from_string(ctx, url, entry->data, entry->size, entry);
+}
+
 // Helper function to wrap CommonJS content as ES module
 static char* wrap_as_commonjs_module(const char* source) {
   size_t source_len = strlen(source);
@@ -123,13 +168,60 @@ void jsrt_http_module_init(void) {
 
     g_http_cache = jsrt_http_cache_create(cache_size);
   }
+
+  if (!g_http_disk_cache_opened) {
+    g_http_disk_cache = jsrt_http_disk_cache_open();
+    g_http_disk_cache_opened = true;
+
+    // JSRT_HTTP_MODULES_PREFETCH=0 downloads imports one at a time, as QuickJS asks for them
+    const char* prefetch_env = getenv("JSRT_HTTP_MODULES_PREFETCH");
+    if (!prefetch_env || strcmp(prefetch_env, "0") != 0) {
+      g_http_prefetch = jsrt_http_prefetch_new(g_http_cache, g_http_disk_cache);
+    }
+  }
 }
 
 void jsrt_http_module_cleanup(void) {
+  jsrt_http_prefetch_free(g_http_prefetch);
+  g_http_prefetch = NULL;
   if (g_http_cache) {
     jsrt_http_cache_free(g_http_cache);
     g_http_cache = NULL;
   }
+  jsrt_http_disk_cache_close(g_http_disk_cache);
+  g_http_disk_cache = NULL;
+  g_http_disk_cache_opened = false;
+}
+
+// Resolve "." and ".." segments of a URL path in place (RFC 3986 section 5.2.4); path starts with '/'
+static void remove_dot_segments(char* path) {
+  char* out = path;
+  const char* in = path;
+  while (*in) {
+    const char* segment = in + 1;
+    size_t len = strcspn(segment, "/");
+    bool last = segment[len] == '\0';
+    if (len == 1 && segment[0] == '.') {
+      if (last) {
+        *out++ = '/';
+      }
+    } else if (len == 2 && segment[0] == '.' && segment[1] == '.') {
+      // Drop the previous segment, never going above the root
+      while (out > path && *--out != '/') {
+      }
+      if (last) {
+        *out++ = '/';
+      }
+    } else {
+      memmove(out, in, len + 1);
+      out += len + 1;
+    }
+    in = segment + len;
+  }
+  if (out == path) {
+    *out++ = '/';
+  }
+  *out = '\0';
 }
 
 char* jsrt_resolve_http_relative_import(const char* base_url, const char* relative_path) {
@@ -142,43 +234,60 @@ char* jsrt_resolve_http_relative_import(const char* base_url, const char* relati
     return strdup(relative_path);
   }
 
-  // Handle relative paths
-  if (relative_path[0] == '.' && (relative_path[1] == '/' || (relative_path[1] == '.' && relative_path[2] == '/'))) {
-    // Find the last '/' in base_url to get directory
-    const char* last_slash = strrchr(base_url, '/');
-    if (!last_slash) {
-      return NULL;
-    }
-
-    size_t base_dir_len = last_slash - base_url + 1;
-    size_t relative_len = strlen(relative_path);
-    size_t result_len = base_dir_len + relative_len + 1;
-
-    char* result = malloc(result_len);
-    if (!result) {
-      return NULL;
-    }
-
-    // Copy base directory
-    strncpy(result, base_url, base_dir_len);
-    result[base_dir_len] = '\0';
+  // Only "./", "../" and root-relative "/" are URLs; bare specifiers are left to the caller
+  bool root_relative = relative_path[0] == '/' && relative_path[1] != '/';
+  bool relative =
+      relative_path[0] == '.' && (relative_path[1] == '/' || (relative_path[1] == '.' && relative_path[2] == '/'));
+  if (!root_relative && !relative) {
+    return NULL;
+  }
 
-    // Append relative path, skipping "./"
-    const char* rel_start = relative_path;
-    if (rel_start[0] == '.' && rel_start[1] == '/') {
-      rel_start += 2;
+  const char* authority = strstr(base_url, "://");
+  if (!authority) {
+    return NULL;
+  }
+  authority += 3;
+  size_t origin_len = (size_t)(authority - base_url) + strcspn(authority, "/?#");
+
+  // Directory of the base path, without its query or fragment
+  const char* base_path = base_url + origin_len;
+  size_t base_dir_len = 0;
+  if (relative) {
+    size_t base_path_len = strcspn(base_path, "?#");
+    for (size_t i = base_path_len; i > 0; i--) {
+      if (base_path[i - 1] == '/') {
+        base_dir_len = i;
+        break;
+      }
     }
+  }
 
-    strcat(result, rel_start);
+  // The specifier's own query and fragment are kept, but take no part in dot segment removal
+  size_t relative_len = strlen(relative_path);
+  size_t relative_path_len = strcspn(relative_path, "?#");
 
-    // TODO: Handle "../" properly for going up directories
-    // For now, just return the basic concatenation
+  char* result = malloc(origin_len + 1 + base_dir_len + relative_len + 1);
+  if (!result) {
+    return NULL;
+  }
 
-    return result;
+  memcpy(result, base_url, origin_len);
+  char* path = result + origin_len;
+  size_t pos = 0;
+  if (relative) {
+    if (base_dir_len == 0) {
+      path[pos++] = '/';
+    } else {
+      memcpy(path, base_path, base_dir_len);
+      pos = base_dir_len;
+    }
   }
+  memcpy(path + pos, relative_path, relative_path_len);
+  path[pos + relative_path_len] = '\0';
+  remove_dot_segments(path);
+  strcat(path, relative_path + relative_path_len);
 
-  // If not a relative path, return as-is
-  return strdup(relative_path);
+  return result;
 }
 
 JSModuleDef* jsrt_load_http_module(JSContext* ctx, const char* url) {
@@ -217,16 +326,69 @@ JSModuleDef* jsrt_load_http_module(JSContext* ctx, const char* url) {
   JSRT_HttpCacheEntry* cached = jsrt_http_cache_get(g_http_cache, url);
   if (cached && !jsrt_http_cache_is_expired(cached)) {
     JSRT_Debug("jsrt_load_http_module: loading from cache for '%s'", url);
-    return compile_module_from_string(ctx, url, cached->data, cached->size);
+    jsrt_http_prefetch_graph(g_http_prefetch, url, cached->data, cached->size);
+    return compile_module_from_string(ctx, url, cached->data, cached->size, NULL);
   }
 
-  // Download module
-  JSRT_Debug("jsrt_load_http_module: downloading from '%s'", url);
-  JSRT_HttpResponse response = JSRT_HttpGetWithOptions(url, "jsrt/1.0", 30000);
+  // Then the disk cache: a fresh copy is used as-is, a stale one is revalidated with its validators
+  JSRT_HttpDiskCacheEntry disk_entry = {0};
+  bool on_disk = jsrt_http_disk_cache_get(g_http_disk_cache, url, &disk_entry);
+  JSModuleDef* module = NULL;
+  if (on_disk && jsrt_http_disk_cache_is_fresh(g_http_disk_cache, &disk_entry)) {
+    jsrt_http_prefetch_graph(g_http_prefetch, url, disk_entry.data, disk_entry.size);
+    module = load_module_from_disk_cache(ctx, url, &disk_entry);
+    goto done;
+  }
+
+  // The prefetcher may have downloaded (or revalidated) the module already, while fetching an importer's graph
+  JSRT_HttpResponse response = {0};
+  bool prefetched = jsrt_http_prefetch_take(g_http_prefetch, url, &response);
+  if (prefetched && response.status == 304 && !on_disk) {
+    // The copy it revalidated is gone
+    JSRT_HttpResponseFree(&response);
+    prefetched = false;
+  }
+
+  if (prefetched) {
+    JSRT_Debug("jsrt_load_http_module: using prefetched response for '%s'", url);
+  } else {
+    jsrt_http_header_entry_t* headers = NULL;
+    if (on_disk && disk_entry.etag) {
+      jsrt_http_header_add(&headers, "If-None-Match", disk_entry.etag);
+    }
+    if (on_disk && disk_entry.last_modified) {
+      jsrt_http_header_add(&headers, "If-Modified-Since", disk_entry.last_modified);
+    }
+
+    // Download module
+    JSRT_Debug("jsrt_load_http_module: downloading from '%s'%s", url, headers ? " (conditional)" : "");
+    response = JSRT_HttpGetWithHeaders(url, headers);
+    jsrt_http_free_headers(headers);
+  }
+
+  if (on_disk && response.error == JSRT_HTTP_OK && response.status == 304) {
+    JSRT_Debug("jsrt_load_http_module: '%s' not modified", url);
+    jsrt_http_disk_cache_revalidated(g_http_disk_cache, &disk_entry, response.etag, response.last_modified);
+    JSRT_HttpResponseFree(&response);
+    jsrt_http_prefetch_graph(g_http_prefetch, url, disk_entry.data, disk_entry.size);
+    module = load_module_from_disk_cache(ctx, url, &disk_entry);
+    goto done;
+  }
+
+  // Offline: a stale copy beats failing the import
+  if (on_disk && response.error != JSRT_HTTP_OK) {
+    JSRT_Debug("jsrt_load_http_module: network error %d, using stale disk copy of '%s'", response.error, url);
+    JSRT_HttpResponseFree(&response);
+    jsrt_http_prefetch_graph(g_http_prefetch, url, disk_entry.data, disk_entry.size);
+    module = load_module_from_disk_cache(ctx, url, &disk_entry);
+    goto done;
+  }
 
   if (response.error != JSRT_HTTP_OK || response.status != 200) {
+    int status = response.status;
     JSRT_HttpResponseFree(&response);
-    JS_ThrowReferenceError(ctx, "Failed to load module from %s: HTTP %d", url, response.status);
+    jsrt_http_disk_cache_entry_free(&disk_entry);
+    JS_ThrowReferenceError(ctx, "Failed to load module from %s: HTTP %d", url, status);
     return NULL;
   }
 
@@ -235,6 +397,7 @@ JSModuleDef* jsrt_load_http_module(JSContext* ctx, const char* url) {
       jsrt_http_validate_response_content(response.content_type, response.body_size);
   if (content_result != JSRT_HTTP_SECURITY_OK) {
     JSRT_HttpResponseFree(&response);
+    jsrt_http_disk_cache_entry_free(&disk_entry);
     const char* error_msg = "Content validation failed";
     if (content_result == JSRT_HTTP_SECURITY_SIZE_TOO_LARGE) {
       error_msg = "Module too large";
@@ -247,12 +410,20 @@ JSModuleDef* jsrt_load_http_module(JSContext* ctx, const char* url) {
 
   // Cache the response
   jsrt_http_cache_put(g_http_cache, url, response.body, response.body_size, response.etag, response.last_modified);
+  bool stored = response.body && jsrt_http_disk_cache_put(g_http_disk_cache, url, response.body, response.body_size,
+                                                          response.etag, response.last_modified, &disk_entry);
+
+  // Fetch its imports before QuickJS asks for them one by one
+  jsrt_http_prefetch_graph(g_http_prefetch, url, response.body, response.body_size);
 
   // Compile module
-  JSModuleDef* module = compile_module_from_string(ctx, url, response.body, response.body_size);
+  module = compile_module_from_string(ctx, url, response.body, response.body_size, stored ? &disk_entry : NULL);
 
   JSRT_HttpResponseFree(&response);
 
+done:
+  jsrt_http_disk_cache_entry_free(&disk_entry);
+
   if (!module) {
     JS_ThrowSyntaxError(ctx, "Failed to compile module from %s", url);
     return NULL;
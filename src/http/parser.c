@@ -276,7 +276,7 @@ static int on_headers_complete(llhttp_t* parser) {
     message->method = jsrt_strdup(llhttp_method_name(parser->method));
   }
 
-  return 0;
+  return jsrt_parser->on_headers ? jsrt_parser->on_headers(jsrt_parser) : 0;
 }
 
 static int on_body(llhttp_t* parser, const char* at, size_t length) {
@@ -286,6 +286,10 @@ static int on_body(llhttp_t* parser, const char* at, size_t length) {
   if (!message)
     return -1;
 
+  if (jsrt_parser->on_body) {
+    return jsrt_parser->on_body(jsrt_parser, at, length);
+  }
+
   if (!message->body.data) {
     message->body.data = malloc(4096);
     message->body.capacity = 4096;
@@ -320,6 +324,8 @@ jsrt_http_parser_t* jsrt_http_parser_create(JSContext* ctx, jsrt_http_type_t typ
   parser->ctx = ctx;
   parser->current_message = NULL;
   parser->user_data = NULL;
+  parser->on_headers = NULL;
+  parser->on_body = NULL;
 
   llhttp_type_t llhttp_type = type == JSRT_HTTP_REQUEST ? HTTP_REQUEST : HTTP_RESPONSE;
   llhttp_init(&parser->parser, llhttp_type, &parser->settings);
@@ -349,12 +355,7 @@ void jsrt_http_parser_destroy(jsrt_http_parser_t* parser) {
   free(parser);
 }
 
-jsrt_http_error_t jsrt_http_parser_execute(jsrt_http_parser_t* parser, const char* data, size_t len) {
-  if (!parser || !data)
-    return JSRT_HTTP_ERROR_INVALID_DATA;
-
-  llhttp_errno_t err = llhttp_execute(&parser->parser, data, len);
-
+static jsrt_http_error_t jsrt_http_parser_check(jsrt_http_parser_t* parser, llhttp_errno_t err) {
   if (err != HPE_OK) {
     if (parser->current_message) {
       parser->current_message->error = 1;
@@ -372,6 +373,20 @@ jsrt_http_error_t jsrt_http_parser_execute(jsrt_http_parser_t* parser, const cha
   return JSRT_HTTP_OK;
 }
 
+jsrt_http_error_t jsrt_http_parser_execute(jsrt_http_parser_t* parser, const char* data, size_t len) {
+  if (!parser || !data)
+    return JSRT_HTTP_ERROR_INVALID_DATA;
+
+  return jsrt_http_parser_check(parser, llhttp_execute(&parser->parser, data, len));
+}
+
+jsrt_http_error_t jsrt_http_parser_finish(jsrt_http_parser_t* parser) {
+  if (!parser)
+    return JSRT_HTTP_ERROR_INVALID_DATA;
+
+  return jsrt_http_parser_check(parser, llhttp_finish(&parser->parser));
+}
+
 static JSValue response_text_method(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
   JSValue body = JS_GetPropertyStr(ctx, this_val, "_body");
   if (!JS_IsString(body)) {
@@ -58,17 +58,28 @@ typedef struct {
   char* _current_header_value;
 } jsrt_http_message_t;
 
-typedef struct {
+typedef struct jsrt_http_parser jsrt_http_parser_t;
+
+// Streaming hooks: a headers hook returning 1 tells llhttp the message has no body (e.g. HEAD);
+// when a body hook is set the body is handed over chunk by chunk instead of being buffered
+typedef int (*jsrt_http_headers_cb)(jsrt_http_parser_t* parser);
+typedef int (*jsrt_http_body_cb)(jsrt_http_parser_t* parser, const char* at, size_t length);
+
+struct jsrt_http_parser {
   llhttp_t parser;
   llhttp_settings_t settings;
   jsrt_http_message_t* current_message;
   JSContext* ctx;
   void* user_data;
-} jsrt_http_parser_t;
+  jsrt_http_headers_cb on_headers;
+  jsrt_http_body_cb on_body;
+};
 
 jsrt_http_parser_t* jsrt_http_parser_create(JSContext* ctx, jsrt_http_type_t type);
 void jsrt_http_parser_destroy(jsrt_http_parser_t* parser);
 jsrt_http_error_t jsrt_http_parser_execute(jsrt_http_parser_t* parser, const char* data, size_t len);
+// Signal EOF for messages whose body ends when the connection closes
+jsrt_http_error_t jsrt_http_parser_finish(jsrt_http_parser_t* parser);
 
 jsrt_http_message_t* jsrt_http_message_create(void);
 void jsrt_http_message_destroy(jsrt_http_message_t* message);
@@ -0,0 +1,767 @@
+// parser.h goes first: http_client.h (via prefetch.h) redefines its JSRT_HTTP_* error names as macros
+#include "parser.h"
+
+#include "prefetch.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <uv.h>
+
+#include "../module/detector/content_analyzer.h"
+#include "../util/conn_pool.h"
+#include "../util/debug.h"
+#include "../util/ssl_client.h"
+#include "../util/url_parser.h"
+#include "module_loader.h"
+#include "security.h"
+
+#define JSRT_HTTP_PREFETCH_BUCKETS 256
+#define JSRT_HTTP_PREFETCH_MAX_SOCKETS 6  // Connections per origin, as browsers do for HTTP/1.1
+#define JSRT_HTTP_PREFETCH_MAX_REDIRECTS 10
+#define JSRT_HTTP_PREFETCH_READ_SIZE (64 * 1024)
+
+// Every module URL the prefetcher has come across
+typedef struct JSRT_HttpPrefetchEntry {
+  char* url;
+  bool scanned;  // Its imports have been scheduled
+  bool ready;    // response waits for the loader
+  JSRT_HttpResponse response;
+  struct JSRT_HttpPrefetchEntry* next;
+} JSRT_HttpPrefetchEntry;
+
+struct JSRT_HttpPrefetch {
+  JSRT_HttpCache* cache;
+  JSRT_HttpDiskCache* disk_cache;
+  JSRT_HttpPrefetchEntry* buckets[JSRT_HTTP_PREFETCH_BUCKETS];
+};
+
+// One jsrt_http_prefetch_graph call: a private loop that runs until every download has finished
+typedef struct {
+  JSRT_HttpPrefetch* prefetch;
+  uv_loop_t loop;
+  JSRT_ConnPool* pool;  // Plain HTTP connections, created on first use
+  int pending;          // Downloads in flight
+  bool ssl_checked;
+  bool ssl_available;
+} JSRT_HttpPrefetchRun;
+
+typedef struct JSRT_HttpPrefetchJob JSRT_HttpPrefetchJob;
+
+typedef struct {
+  uv_write_t req;
+  char* buffer;
+} JSRT_HttpPrefetchWrite;
+
+// Keep-alive TCP connection to one origin; it outlives the downloads it serves
+typedef struct {
+  JSRT_HttpPrefetchRun* run;
+  uv_tcp_t tcp;
+  uv_connect_t connect_req;
+  uv_getaddrinfo_t dns_req;
+  struct addrinfo* addresses;  // Resolved addresses, kept until one of them accepts the connection
+  struct addrinfo* address;    // The one being tried
+  char* pool_key;
+  JSRT_HttpPrefetchJob* job;  // Download using the connection (NULL while idle in the pool)
+  bool resolving;
+  bool tcp_initialized;
+  bool closing;
+  char read_buffer[JSRT_HTTP_PREFETCH_READ_SIZE];
+} JSRT_HttpPrefetchConn;
+
+struct JSRT_HttpPrefetchJob {
+  JSRT_HttpPrefetchRun* run;
+  JSRT_HttpPrefetchEntry* entry;
+  char* request_url;  // entry->url, or where a redirect led
+  int redirects;
+  jsrt_http_header_entry_t* headers;  // Validators of the stale disk copy
+  char* stale_data;                   // That copy, scanned instead of the body on 304 Not Modified
+  size_t stale_size;
+
+  // Plain HTTP on the run's loop
+  char* host;
+  int port;
+  char* path;
+  char* pool_key;  // Set while the job holds a pool slot
+  JSRT_HttpPrefetchConn* conn;
+  jsrt_http_parser_t* parser;
+  bool reused;    // Running on an idle pooled connection
+  bool received;  // Any response bytes seen on the current connection
+
+  // HTTPS with the blocking client on the threadpool
+  uv_work_t work;
+  JSRT_HttpResponse response;
+};
+
+static size_t prefetch_hash(const char* url) {
+  size_t hash = 5381;
+  for (const unsigned char* p = (const unsigned char*)url; *p; p++) {
+    hash = ((hash << 5) + hash) + *p;
+  }
+  return hash % JSRT_HTTP_PREFETCH_BUCKETS;
+}
+
+static JSRT_HttpPrefetchEntry* prefetch_lookup(JSRT_HttpPrefetch* prefetch, const char* url) {
+  for (JSRT_HttpPrefetchEntry* entry = prefetch->buckets[prefetch_hash(url)]; entry; entry = entry->next) {
+    if (strcmp(entry->url, url) == 0) {
+      return entry;
+    }
+  }
+  return NULL;
+}
+
+// Takes ownership of url
+static JSRT_HttpPrefetchEntry* prefetch_insert(JSRT_HttpPrefetch* prefetch, char* url) {
+  JSRT_HttpPrefetchEntry* entry = calloc(1, sizeof(JSRT_HttpPrefetchEntry));
+  if (!entry) {
+    free(url);
+    return NULL;
+  }
+  size_t bucket = prefetch_hash(url);
+  entry->url = url;
+  entry->next = prefetch->buckets[bucket];
+  prefetch->buckets[bucket] = entry;
+  return entry;
+}
+
+JSRT_HttpPrefetch* jsrt_http_prefetch_new(JSRT_HttpCache* cache, JSRT_HttpDiskCache* disk_cache) {
+  JSRT_HttpPrefetch* prefetch = calloc(1, sizeof(JSRT_HttpPrefetch));
+  if (prefetch) {
+    prefetch->cache = cache;
+    prefetch->disk_cache = disk_cache;
+  }
+  return prefetch;
+}
+
+void jsrt_http_prefetch_free(JSRT_HttpPrefetch* prefetch) {
+  if (!prefetch) {
+    return;
+  }
+  for (size_t i = 0; i < JSRT_HTTP_PREFETCH_BUCKETS; i++) {
+    JSRT_HttpPrefetchEntry* entry = prefetch->buckets[i];
+    while (entry) {
+      JSRT_HttpPrefetchEntry* next = entry->next;
+      JSRT_HttpResponseFree(&entry->response);
+      free(entry->url);
+      free(entry);
+      entry = next;
+    }
+  }
+  free(prefetch);
+}
+
+bool jsrt_http_prefetch_take(JSRT_HttpPrefetch* prefetch, const char* url, JSRT_HttpResponse* response) {
+  JSRT_HttpPrefetchEntry* entry = prefetch && url ? prefetch_lookup(prefetch, url) : NULL;
+  if (!entry || !entry->ready) {
+    return false;
+  }
+  *response = entry->response;
+  memset(&entry->response, 0, sizeof(entry->response));
+  entry->ready = false;
+  return true;
+}
+
+static void prefetch_scan(JSRT_HttpPrefetchRun* run, const char* url, const char* source, size_t size);
+static void prefetch_job_start(JSRT_HttpPrefetchJob* job);
+
+static void prefetch_job_free(JSRT_HttpPrefetchJob* job) {
+  jsrt_http_free_headers(job->headers);
+  jsrt_http_parser_destroy(job->parser);
+  free(job->request_url);
+  free(job->stale_data);
+  free(job->host);
+  free(job->path);
+  free(job->pool_key);
+  free(job);
+}
+
+// A download ended: keep a usable response for the loader and move on to the imports it names
+static void prefetch_job_done(JSRT_HttpPrefetchJob* job, JSRT_HttpResponse* response) {
+  JSRT_HttpPrefetchRun* run = job->run;
+  JSRT_HttpPrefetchEntry* entry = job->entry;
+  run->pending--;
+
+  if (response->error == JSRT_HTTP_OK && response->status == 200 && response->body &&
+      jsrt_http_validate_response_content(response->content_type, response->body_size) == JSRT_HTTP_SECURITY_OK) {
+    JSRT_Debug("jsrt_http_prefetch: fetched '%s' (%zu bytes)", entry->url, response->body_size);
+    entry->response = *response;
+    entry->ready = true;
+    entry->scanned = true;
+    prefetch_scan(run, entry->url, response->body, response->body_size);
+  } else if (response->error == JSRT_HTTP_OK && response->status == 304 && job->stale_data) {
+    JSRT_Debug("jsrt_http_prefetch: '%s' not modified", entry->url);
+    entry->response = *response;
+    entry->ready = true;
+    entry->scanned = true;
+    prefetch_scan(run, entry->url, job->stale_data, job->stale_size);
+  } else {
+    // Left to the loader, which reports the error if the module is really needed
+    JSRT_Debug("jsrt_http_prefetch: dropping '%s' (error %d, HTTP %d)", entry->url, response->error,
+               response->status);
+    JSRT_HttpResponseFree(response);
+  }
+
+  prefetch_job_free(job);
+}
+
+static void prefetch_job_fail(JSRT_HttpPrefetchJob* job, int error) {
+  JSRT_HttpResponse response = {0};
+  response.error = error;
+  prefetch_job_done(job, &response);
+}
+
+// HTTPS: the tree has no non-blocking TLS, so each download is a blocking request on the threadpool
+
+static void prefetch_https_work(uv_work_t* req) {
+  JSRT_HttpPrefetchJob* job = req->data;
+  job->response = JSRT_HttpGetWithHeaders(job->request_url, job->headers);
+}
+
+static void prefetch_https_after_work(uv_work_t* req, int status) {
+  JSRT_HttpPrefetchJob* job = req->data;
+  if (status != 0) {
+    JSRT_HttpResponseFree(&job->response);
+    prefetch_job_fail(job, JSRT_HTTP_ERROR_NETWORK);
+    return;
+  }
+  JSRT_HttpResponse response = job->response;
+  memset(&job->response, 0, sizeof(job->response));
+  prefetch_job_done(job, &response);
+}
+
+// Plain HTTP on the run's loop
+
+static void prefetch_conn_on_close(uv_handle_t* handle) {
+  JSRT_HttpPrefetchConn* conn = handle->data;
+  free(conn->pool_key);
+  free(conn);
+}
+
+static void prefetch_conn_close(JSRT_HttpPrefetchConn* conn) {
+  if (conn->closing) {
+    return;
+  }
+  conn->closing = true;
+  conn->job = NULL;
+  if (conn->addresses) {
+    uv_freeaddrinfo(conn->addresses);
+    conn->addresses = NULL;
+  }
+  // While DNS resolution is pending, its callback frees the connection
+  if (conn->tcp_initialized) {
+    uv_close((uv_handle_t*)&conn->tcp, prefetch_conn_on_close);
+  } else if (!conn->resolving) {
+    free(conn->pool_key);
+    free(conn);
+  }
+}
+
+static void prefetch_pool_close(void* conn, void* opaque) {
+  prefetch_conn_close((JSRT_HttpPrefetchConn*)conn);
+}
+
+// Detach the job from its connection, then park the connection in the pool or close it
+static void prefetch_release(JSRT_HttpPrefetchJob* job, bool reusable) {
+  JSRT_HttpPrefetchConn* conn = job->conn;
+  char* pool_key = job->pool_key;
+  job->conn = NULL;
+  job->pool_key = NULL;
+  if (conn) {
+    conn->job = NULL;
+  }
+
+  if (conn && reusable && !conn->closing) {
+    // Idle connections must not keep the run's loop alive
+    uv_unref((uv_handle_t*)&conn->tcp);
+    JSRT_ConnPoolRelease(job->run->pool, pool_key, conn, true);
+  } else {
+    if (pool_key) {
+      JSRT_ConnPoolRelease(job->run->pool, pool_key, conn, false);
+    }
+    if (conn) {
+      prefetch_conn_close(conn);
+    }
+  }
+  free(pool_key);
+}
+
+static void prefetch_http_fail(JSRT_HttpPrefetchJob* job) {
+  prefetch_release(job, false);
+  prefetch_job_fail(job, JSRT_HTTP_ERROR_NETWORK);
+}
+
+static void prefetch_acquire(JSRT_HttpPrefetchJob* job);
+
+// A pooled connection may have been closed by the server while idle: retry on another one. Other idle
+// connections may be stale too, but every retry uses one up, and a failure on a new connection is final.
+static bool prefetch_retry_stale(JSRT_HttpPrefetchJob* job) {
+  if (!job->reused || job->received) {
+    return false;
+  }
+  prefetch_release(job, false);
+  jsrt_http_parser_destroy(job->parser);
+  job->parser = NULL;
+  prefetch_acquire(job);
+  return true;
+}
+
+static char* prefetch_header_dup(jsrt_http_message_t* message, const char* name) {
+  const char* value = jsrt_http_headers_get(&message->headers, name);
+  return value ? strdup(value) : NULL;
+}
+
+// The whole response arrived: follow a redirect or hand the response on
+static void prefetch_http_complete(JSRT_HttpPrefetchJob* job, bool reusable) {
+  jsrt_http_message_t* message = job->parser->current_message;
+  int status = message->status_code;
+  const char* location = jsrt_http_headers_get(&message->headers, "Location");
+
+  if (status >= 300 && status < 400 && status != 304 && location) {
+    char* target = jsrt_resolve_http_relative_import(job->request_url, location);
+    prefetch_release(job, reusable);
+    if (!target || job->redirects >= JSRT_HTTP_PREFETCH_MAX_REDIRECTS ||
+        jsrt_http_validate_url(target) != JSRT_HTTP_SECURITY_OK) {
+      free(target);
+      prefetch_job_fail(job, JSRT_HTTP_ERROR_REDIRECT_LOOP);
+      return;
+    }
+    JSRT_Debug("jsrt_http_prefetch: '%s' redirects to '%s'", job->request_url, target);
+    free(job->request_url);
+    job->request_url = target;
+    job->redirects++;
+    prefetch_job_start(job);
+    return;
+  }
+
+  JSRT_HttpResponse response = {0};
+  response.status = status;
+  response.status_text = message->status_message ? strdup(message->status_message) : NULL;
+  response.content_type = prefetch_header_dup(message, "Content-Type");
+  response.etag = prefetch_header_dup(message, "ETag");
+  response.last_modified = prefetch_header_dup(message, "Last-Modified");
+  response.body = malloc(message->body.size + 1);
+  if (response.body) {
+    if (message->body.size > 0) {
+      memcpy(response.body, message->body.data, message->body.size);
+    }
+    response.body[message->body.size] = '\0';
+    response.body_size = message->body.size;
+  } else {
+    response.error = JSRT_HTTP_ERROR_OUT_OF_MEMORY;
+  }
+
+  prefetch_release(job, reusable);
+  prefetch_job_done(job, &response);
+}
+
+// The module size cap applies while the body arrives, so an oversized or endless body is cut off early
+static bool prefetch_body_too_large(jsrt_http_message_t* message) {
+  JSRT_HttpConfig* config = jsrt_http_config_init();
+  return message && config && message->body.size > config->max_module_size;
+}
+
+static void prefetch_alloc(uv_handle_t* handle, size_t suggested_size, uv_buf_t* buf) {
+  JSRT_HttpPrefetchConn* conn = handle->data;
+  *buf = uv_buf_init(conn->read_buffer, sizeof(conn->read_buffer));
+}
+
+static void prefetch_on_read(uv_stream_t* stream, ssize_t nread, const uv_buf_t* buf) {
+  JSRT_HttpPrefetchConn* conn = stream->data;
+  JSRT_HttpPrefetchJob* job = conn->job;
+
+  if (!job) {
+    // Anything arriving on an idle connection (usually EOF) means it can no longer be reused
+    if (nread != 0 && !conn->closing) {
+      JSRT_ConnPoolRemoveIdle(conn->run->pool, conn->pool_key, conn);
+      prefetch_conn_close(conn);
+    }
+    return;
+  }
+
+  if (nread < 0) {
+    if (prefetch_retry_stale(job)) {
+      return;
+    }
+    if (nread == UV_EOF) {
+      // A body without Content-Length or chunked framing ends with the connection
+      jsrt_http_parser_finish(job->parser);
+      if (job->parser->current_message && job->parser->current_message->complete) {
+        prefetch_http_complete(job, false);
+        return;
+      }
+    }
+    prefetch_http_fail(job);
+    return;
+  }
+
+  if (nread > 0) {
+    job->received = true;
+    jsrt_http_error_t result = jsrt_http_parser_execute(job->parser, buf->base, nread);
+    if (result == JSRT_HTTP_ERROR_PROTOCOL || result == JSRT_HTTP_ERROR_INVALID_DATA) {
+      prefetch_http_fail(job);
+    } else if (prefetch_body_too_large(job->parser->current_message)) {
+      JSRT_Debug("jsrt_http_prefetch: '%s' exceeds the module size limit", job->request_url);
+      prefetch_release(job, false);
+      prefetch_job_fail(job, JSRT_HTTP_ERROR_HTTP_ERROR);
+    } else if (job->parser->current_message && job->parser->current_message->complete) {
+      prefetch_http_complete(job, llhttp_should_keep_alive(&job->parser->parser));
+    }
+  }
+}
+
+static void prefetch_on_write(uv_write_t* req, int status) {
+  JSRT_HttpPrefetchWrite* write = (JSRT_HttpPrefetchWrite*)req;
+  JSRT_HttpPrefetchConn* conn = req->handle->data;
+  free(write->buffer);
+  free(write);
+
+  JSRT_HttpPrefetchJob* job = conn->job;
+  if (status != 0 && status != UV_ECANCELED && job && !prefetch_retry_stale(job)) {
+    prefetch_http_fail(job);
+  }
+}
+
+static void prefetch_send_request(JSRT_HttpPrefetchJob* job) {
+  job->parser = jsrt_http_parser_create(NULL, JSRT_HTTP_RESPONSE);
+  jsrt_http_header_entry_t* headers = NULL;
+  for (jsrt_http_header_entry_t* header = job->headers; header; header = header->next) {
+    jsrt_http_header_add(&headers, header->name, header->value);
+  }
+  jsrt_http_header_add(&headers, "Connection", "keep-alive");
+  JSRT_HttpPrefetchWrite* write = malloc(sizeof(JSRT_HttpPrefetchWrite));
+  if (write) {
+    write->buffer = jsrt_http_build_request("GET", job->path, job->host, job->port, NULL, 0, headers);
+  }
+  jsrt_http_free_headers(headers);
+  if (!job->parser || !write || !write->buffer) {
+    free(write);
+    prefetch_http_fail(job);
+    return;
+  }
+
+  uv_buf_t buf = uv_buf_init(write->buffer, strlen(write->buffer));
+  if (uv_write(&write->req, (uv_stream_t*)&job->conn->tcp, &buf, 1, prefetch_on_write) != 0) {
+    free(write->buffer);
+    free(write);
+    if (!prefetch_retry_stale(job)) {
+      prefetch_http_fail(job);
+    }
+  }
+}
+
+static void prefetch_connect_next(JSRT_HttpPrefetchConn* conn);
+
+static void prefetch_on_close_retry(uv_handle_t* handle) {
+  prefetch_connect_next(handle->data);
+}
+
+static void prefetch_on_connect(uv_connect_t* req, int status) {
+  JSRT_HttpPrefetchConn* conn = req->data;
+  JSRT_HttpPrefetchJob* job = conn->job;
+  if (!job) {
+    prefetch_conn_close(conn);
+    return;
+  }
+
+  if (status != 0) {
+    if (conn->address && conn->address->ai_next) {
+      // Try the host's next address, e.g. IPv4 after IPv6 was refused, on a fresh handle
+      conn->address = conn->address->ai_next;
+      conn->tcp_initialized = false;
+      uv_close((uv_handle_t*)&conn->tcp, prefetch_on_close_retry);
+      return;
+    }
+    prefetch_http_fail(job);
+    return;
+  }
+
+  uv_freeaddrinfo(conn->addresses);
+  conn->addresses = NULL;
+  conn->address = NULL;
+  if (uv_read_start((uv_stream_t*)&conn->tcp, prefetch_alloc, prefetch_on_read) != 0) {
+    prefetch_http_fail(job);
+    return;
+  }
+  prefetch_send_request(job);
+}
+
+// Connect to conn->address, on a new handle
+static void prefetch_connect_next(JSRT_HttpPrefetchConn* conn) {
+  if (uv_tcp_init(&conn->run->loop, &conn->tcp) != 0) {
+    prefetch_http_fail(conn->job);
+    return;
+  }
+  conn->tcp_initialized = true;
+  conn->tcp.data = conn;
+  conn->connect_req.data = conn;
+  if (uv_tcp_connect(&conn->connect_req, &conn->tcp, conn->address->ai_addr, prefetch_on_connect) != 0) {
+    prefetch_http_fail(conn->job);
+  }
+}
+
+static void prefetch_on_resolve(uv_getaddrinfo_t* req, int status, struct addrinfo* res) {
+  JSRT_HttpPrefetchConn* conn = req->data;
+  conn->resolving = false;
+  conn->addresses = res;
+  conn->address = res;
+  if (conn->closing) {
+    uv_freeaddrinfo(res);
+    free(conn->pool_key);
+    free(conn);
+    return;
+  }
+  if (status != 0 || !res) {
+    prefetch_http_fail(conn->job);
+    return;
+  }
+  prefetch_connect_next(conn);
+}
+
+// Open a new connection for the job, starting with DNS resolution of IPv4 and IPv6 addresses
+static void prefetch_open_connection(JSRT_HttpPrefetchJob* job) {
+  JSRT_HttpPrefetchConn* conn = calloc(1, sizeof(JSRT_HttpPrefetchConn));
+  if (conn) {
+    conn->pool_key = strdup(job->pool_key);
+    if (!conn->pool_key) {
+      free(conn);
+      conn = NULL;
+    }
+  }
+  if (!conn) {
+    prefetch_http_fail(job);
+    return;
+  }
+
+  conn->run = job->run;
+  conn->job = job;
+  conn->dns_req.data = conn;
+  job->conn = conn;
+  job->reused = false;
+  job->received = false;
+
+  struct addrinfo hints;
+  memset(&hints, 0, sizeof(hints));
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+
+  char port_str[16];
+  snprintf(port_str, sizeof(port_str), "%d", job->port);
+
+  conn->resolving = true;
+  if (uv_getaddrinfo(&job->run->loop, &conn->dns_req, prefetch_on_resolve, job->host, port_str, &hints) != 0) {
+    conn->resolving = false;
+    prefetch_http_fail(job);
+  }
+}
+
+// The pool handed the job an idle connection to reuse, or a slot for a new one
+static void prefetch_on_pool_ready(void* pooled, void* waiter) {
+  JSRT_HttpPrefetchJob* job = waiter;
+  if (!pooled) {
+    prefetch_open_connection(job);
+    return;
+  }
+
+  JSRT_HttpPrefetchConn* conn = pooled;
+  uv_ref((uv_handle_t*)&conn->tcp);
+  conn->job = job;
+  job->conn = conn;
+  job->reused = true;
+  job->received = false;
+  prefetch_send_request(job);
+}
+
+static void prefetch_acquire(JSRT_HttpPrefetchJob* job) {
+  JSRT_HttpPrefetchRun* run = job->run;
+  if (!run->pool) {
+    JSRT_ConnPoolOptions options = {
+        .max_sockets = JSRT_HTTP_PREFETCH_MAX_SOCKETS,
+        .max_free_sockets = JSRT_HTTP_PREFETCH_MAX_SOCKETS,
+        .idle_timeout_ms = 0,
+    };
+    run->pool = JSRT_ConnPoolNew(&run->loop, &options, prefetch_pool_close, NULL);
+    if (!run->pool) {
+      prefetch_job_fail(job, JSRT_HTTP_ERROR_OUT_OF_MEMORY);
+      return;
+    }
+  }
+
+  char key[512];
+  snprintf(key, sizeof(key), "%s:%d", job->host, job->port);
+  job->pool_key = strdup(key);
+  if (!job->pool_key) {
+    prefetch_job_fail(job, JSRT_HTTP_ERROR_OUT_OF_MEMORY);
+    return;
+  }
+
+  void* pooled = NULL;
+  int ret = JSRT_ConnPoolAcquire(run->pool, job->pool_key, &pooled, prefetch_on_pool_ready, job);
+  if (ret < 0) {
+    // No slot was taken, so none may be released for this job
+    free(job->pool_key);
+    job->pool_key = NULL;
+    prefetch_job_fail(job, JSRT_HTTP_ERROR_OUT_OF_MEMORY);
+  } else if (ret > 0) {
+    prefetch_on_pool_ready(pooled, job);
+  }
+}
+
+// Start (or, after a redirect, restart) the download of job->request_url
+static void prefetch_job_start(JSRT_HttpPrefetchJob* job) {
+  JSRT_HttpPrefetchRun* run = job->run;
+  jsrt_url_t parsed;
+  if (jsrt_url_parse(job->request_url, &parsed) != 0) {
+    prefetch_job_fail(job, JSRT_HTTP_ERROR_INVALID_URL);
+    return;
+  }
+  bool is_https = parsed.is_secure;
+  free(job->host);
+  free(job->path);
+  job->host = strdup(parsed.host);
+  job->path = strdup(parsed.path);
+  job->port = parsed.port;
+  jsrt_url_free(&parsed);
+  jsrt_http_parser_destroy(job->parser);
+  job->parser = NULL;
+  if (!job->host || !job->path) {
+    prefetch_job_fail(job, JSRT_HTTP_ERROR_OUT_OF_MEMORY);
+    return;
+  }
+
+  if (!is_https) {
+    prefetch_acquire(job);
+    return;
+  }
+
+  // Load OpenSSL here rather than racing to do it from several worker threads
+  if (!run->ssl_checked) {
+    run->ssl_available = jsrt_ssl_global_init();
+    run->ssl_checked = true;
+  }
+  job->work.data = job;
+  if (!run->ssl_available ||
+      uv_queue_work(&run->loop, &job->work, prefetch_https_work, prefetch_https_after_work) != 0) {
+    prefetch_job_fail(job, JSRT_HTTP_ERROR_SSL_ERROR);
+  }
+}
+
+// Schedule the download of a module URL met for the first time, unless it is cached already
+static void prefetch_visit(JSRT_HttpPrefetchRun* run, char* url) {
+  JSRT_HttpPrefetch* prefetch = run->prefetch;
+  if (prefetch_lookup(prefetch, url) || jsrt_http_validate_url(url) != JSRT_HTTP_SECURITY_OK) {
+    free(url);
+    return;
+  }
+  JSRT_HttpPrefetchEntry* entry = prefetch_insert(prefetch, url);
+  if (!entry) {
+    return;
+  }
+
+  JSRT_HttpCacheEntry* cached = jsrt_http_cache_get(prefetch->cache, entry->url);
+  if (cached && !jsrt_http_cache_is_expired(cached)) {
+    entry->scanned = true;
+    prefetch_scan(run, entry->url, cached->data, cached->size);
+    return;
+  }
+
+  JSRT_HttpDiskCacheEntry disk_entry = {0};
+  bool on_disk = jsrt_http_disk_cache_get(prefetch->disk_cache, entry->url, &disk_entry);
+  if (on_disk && jsrt_http_disk_cache_is_fresh(prefetch->disk_cache, &disk_entry)) {
+    entry->scanned = true;
+    prefetch_scan(run, entry->url, disk_entry.data, disk_entry.size);
+    jsrt_http_disk_cache_entry_free(&disk_entry);
+    return;
+  }
+
+  JSRT_HttpPrefetchJob* job = calloc(1, sizeof(JSRT_HttpPrefetchJob));
+  if (!job || !(job->request_url = strdup(entry->url))) {
+    free(job);
+    jsrt_http_disk_cache_entry_free(&disk_entry);
+    return;
+  }
+  job->run = run;
+  job->entry = entry;
+  if (on_disk) {
+    // Revalidate the stale copy, as the loader would
+    if (disk_entry.etag) {
+      jsrt_http_header_add(&job->headers, "If-None-Match", disk_entry.etag);
+    }
+    if (disk_entry.last_modified) {
+      jsrt_http_header_add(&job->headers, "If-Modified-Since", disk_entry.last_modified);
+    }
+    job->stale_data = disk_entry.data;
+    job->stale_size = disk_entry.size;
+    disk_entry.data = NULL;
+  }
+  jsrt_http_disk_cache_entry_free(&disk_entry);
+
+  JSRT_Debug("jsrt_http_prefetch: downloading '%s'%s", entry->url, job->headers ? " (conditional)" : "");
+  run->pending++;
+  prefetch_job_start(job);
+}
+
+typedef struct {
+  JSRT_HttpPrefetchRun* run;
+  const char* base_url;
+} JSRT_HttpPrefetchScan;
+
+static void prefetch_on_specifier(const char* specifier, size_t length, void* opaque) {
+  JSRT_HttpPrefetchScan* scan = opaque;
+  char* name = malloc(length + 1);
+  if (!name) {
+    return;
+  }
+  memcpy(name, specifier, length);
+  name[length] = '\0';
+
+  // Resolved exactly as the module normalizer will; bare specifiers are not fetched over HTTP
+  char* url = jsrt_resolve_http_relative_import(scan->base_url, name);
+  free(name);
+  if (url) {
+    prefetch_visit(scan->run, url);
+  }
+}
+
+static void prefetch_scan(JSRT_HttpPrefetchRun* run, const char* url, const char* source, size_t size) {
+  JSRT_HttpPrefetchScan scan = {run, url};
+  jsrt_scan_import_specifiers(source, size, prefetch_on_specifier, &scan);
+}
+
+void jsrt_http_prefetch_graph(JSRT_HttpPrefetch* prefetch, const char* url, const char* source, size_t size) {
+  if (!prefetch || !url || !source) {
+    return;
+  }
+
+  JSRT_HttpPrefetchEntry* entry = prefetch_lookup(prefetch, url);
+  if (!entry) {
+    char* key = strdup(url);
+    entry = key ? prefetch_insert(prefetch, key) : NULL;
+  }
+  if (!entry || entry->scanned) {
+    return;
+  }
+  entry->scanned = true;
+
+  JSRT_HttpPrefetchRun run = {0};
+  run.prefetch = prefetch;
+  if (uv_loop_init(&run.loop) != 0) {
+    return;
+  }
+
+  prefetch_scan(&run, url, source, size);
+  if (run.pending > 0) {
+    JSRT_Debug("jsrt_http_prefetch: fetching the import graph of '%s'", url);
+    uv_run(&run.loop, UV_RUN_DEFAULT);
+  }
+
+  if (run.pool) {
+    JSRT_ConnPoolStats stats;
+    JSRT_ConnPoolGetStats(run.pool, &stats);
+    JSRT_Debug("jsrt_http_prefetch: %llu connections opened, %llu reused", (unsigned long long)stats.created,
+               (unsigned long long)stats.reused);
+    JSRT_ConnPoolFree(run.pool);
+  }
+  // Let the idle connections finish closing
+  uv_run(&run.loop, UV_RUN_DEFAULT);
+  uv_loop_close(&run.loop);
+}
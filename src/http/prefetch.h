@@ -0,0 +1,36 @@
+#ifndef __JSRT_HTTP_PREFETCH_H__
+#define __JSRT_HTTP_PREFETCH_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "../util/http_client.h"
+#include "cache.h"
+#include "disk_cache.h"
+
+// Prefetcher for the static import graph of HTTP-loaded ES modules.
+//
+// QuickJS asks for a module's imports one at a time, so without help every remote module costs a
+// blocking round trip. When the loader has a module's source it passes it to jsrt_http_prefetch_graph,
+// which scans it for static import specifiers, downloads every remote module that is not cached yet,
+// scans those in turn and returns once the reachable graph is fetched. Downloads run concurrently on
+// a private libuv loop, so no JavaScript runs meanwhile: plain HTTP shares keep-alive connections per
+// origin, HTTPS uses the blocking client on the threadpool. Responses wait in the prefetcher until the
+// loader takes them; failed downloads are dropped and the loader requests them again itself.
+
+typedef struct JSRT_HttpPrefetch JSRT_HttpPrefetch;
+
+// Modules found in either cache are scanned without a request; stale disk copies are revalidated
+JSRT_HttpPrefetch* jsrt_http_prefetch_new(JSRT_HttpCache* cache, JSRT_HttpDiskCache* disk_cache);
+
+void jsrt_http_prefetch_free(JSRT_HttpPrefetch* prefetch);
+
+// Fetch everything url (whose source is given) statically imports, directly or not, before returning.
+// Each module is scanned once per prefetcher, so calling this again for a module in the graph is cheap.
+void jsrt_http_prefetch_graph(JSRT_HttpPrefetch* prefetch, const char* url, const char* source, size_t size);
+
+// Hand over the prefetched response for url: a 200, or a 304 when a stale disk copy was revalidated.
+// Returns false when nothing is waiting for url; the caller then owns and frees the response.
+bool jsrt_http_prefetch_take(JSRT_HttpPrefetch* prefetch, const char* url, JSRT_HttpResponse* response);
+
+#endif
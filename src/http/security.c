@@ -2,6 +2,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include "../util/macro.h"
 #include "../util/user_agent.h"
 
 // Default allowed domains
@@ -9,7 +10,7 @@ static const char* DEFAULT_ALLOWED_DOMAINS[] = {"esm.run",          "esm.sh",
                                                 "cdn.jsdelivr.net", "unpkg.com", NULL};
 
 // Global configuration instance
-static JSRT_HttpConfig* g_http_config = NULL;
+static JSRT_THREAD_LOCAL JSRT_HttpConfig* g_http_config = NULL;
 
 // Helper function to parse comma-separated domains
 static char** parse_domains_string(const char* domains_str, size_t* count) {
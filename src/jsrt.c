@@ -16,6 +16,7 @@
 
 #include "build.h"
 #include "module/module.h"
+#include "node/module/error_stack.h"
 #include "runtime.h"
 #include "util/file.h"
 #include "util/http_client.h"
@@ -152,7 +153,9 @@ static int jsrt_cli_run_commonjs(JSRT_Runtime* rt, const char* eval_name, const
 
   const char* code_start = code;
   size_t code_length = length;
+  int line_offset = 1;  // "(function() {" line
   if (length >= 2 && code[0] == '#' && code[1] == '!') {
+    line_offset--;  // The dropped shebang line
     const char* newline = memchr(code, '\n', length);
     if (newline) {
       code_start = newline + 1;
@@ -170,14 +173,13 @@ static int jsrt_cli_run_commonjs(JSRT_Runtime* rt, const char* eval_name, const
     return -1;
   }
 
-  // CommonJS wrapper with line number fix registration
-  // Must match the format in commonjs_loader.c (2 lines before module code)
+  // CommonJS wrapper; Error.stack subtracts the wrapper line from this file's line numbers
   snprintf(wrapper, wrapper_size,
            "(function() {\n"
-           "globalThis.__jsrt_cjs_modules&&globalThis.__jsrt_cjs_modules.add('%s');\n"
            "%s\n"
            "})",
-           filename_value, code_start);
+           code_start);
+  jsrt_error_stack_set_line_offset(filename_value, line_offset);
 
   JSValue func = JS_Eval(ctx, wrapper, strlen(wrapper), filename_value, JS_EVAL_TYPE_GLOBAL);
   free(wrapper);
@@ -6,6 +6,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include "../util/module_debug.h"
+#include "../resolver/resolver_cache.h"
 #include "../util/module_errors.h"
 #include "module_cache.h"
 
@@ -39,6 +40,12 @@ JSRT_ModuleLoader* jsrt_module_loader_create(JSContext* ctx) {
     return NULL;
   }
 
+  // Resolution caches are optional; resolution falls back to plain stat() without them
+  loader->resolver = jsrt_module_resolver_create(ctx);
+  if (!loader->resolver) {
+    MODULE_DEBUG_ERROR("Failed to create module resolver cache");
+  }
+
   // Initialize configuration with defaults
   loader->enable_cache = 1;
   loader->enable_http_imports = 0;  // Disabled by default for security
@@ -89,10 +96,11 @@ void jsrt_module_loader_free(JSRT_ModuleLoader* loader) {
     loader->cache = NULL;
   }
 
-  // Free resolver (Phase 2)
-  // if (loader->resolver) {
-  //   jsrt_module_resolver_free(loader->resolver);
-  // }
+  // Free resolver caches
+  if (loader->resolver) {
+    jsrt_module_resolver_free(loader->resolver);
+    loader->resolver = NULL;
+  }
 
   // Free detector (Phase 3)
   // if (loader->detector) {
@@ -158,6 +166,7 @@ void jsrt_module_loader_reset_stats(JSRT_ModuleLoader* loader) {
   loader->loads_failed = 0;
   loader->cache_hits = 0;
   loader->cache_misses = 0;
+  jsrt_module_resolver_reset_stats(loader->resolver);
 
   MODULE_DEBUG("Statistics reset complete");
 }
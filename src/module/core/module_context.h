@@ -33,7 +33,7 @@ typedef struct JSRT_ModuleLoader {
 
   // Core components (to be implemented in later phases)
   JSRT_ModuleCache* cache;        // Module cache
-  JSRT_ModuleResolver* resolver;  // Module resolver (Phase 2)
+  JSRT_ModuleResolver* resolver;  // Resolution caches: stat, package.json, specifier memo
   JSRT_ModuleDetector* detector;  // Type detector (Phase 3)
 
   JSRT_ModuleRequestType current_request_type;
@@ -17,6 +17,7 @@
 #include "../protocols/protocol_dispatcher.h"
 #include "../resolver/path_resolver.h"
 #include "../resolver/path_util.h"
+#include "../resolver/resolver_cache.h"
 #include "../util/module_debug.h"
 #include "../util/module_errors.h"
 #include "module_cache.h"
@@ -262,6 +263,7 @@ int jsrt_invalidate_module(JSRT_ModuleLoader* loader, const char* specifier) {
   }
 
   int result = jsrt_module_cache_remove(loader->cache, cache_key);
+  jsrt_module_resolver_invalidate(loader->resolver, cache_key);
   free(cache_key);
 
   if (result == 0) {
@@ -289,5 +291,6 @@ void jsrt_invalidate_all_modules(JSRT_ModuleLoader* loader) {
 
   MODULE_DEBUG_LOADER("Invalidating all modules");
   jsrt_module_cache_clear(loader->cache);
+  jsrt_module_resolver_clear(loader->resolver);
   MODULE_DEBUG_LOADER("All modules invalidated");
 }
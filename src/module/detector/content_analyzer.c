@@ -300,3 +300,196 @@ JSRT_ModuleFormat jsrt_analyze_content_format(const char* content, size_t length
   MODULE_DEBUG_DETECTOR("Content analysis result: Unknown (no patterns found)");
   return JSRT_MODULE_FORMAT_UNKNOWN;
 }
+
+/**
+ * Read an identifier at the current position
+ * Returns its length (0 if there is none) and advances past it
+ */
+static size_t read_identifier(LexerState* state, const char** start) {
+  *start = &state->content[state->pos];
+  size_t begin = state->pos;
+  if (!is_identifier_start(peek(state))) {
+    return 0;
+  }
+  while (is_identifier_part(peek(state))) {
+    advance(state);
+  }
+  return state->pos - begin;
+}
+
+static bool identifier_is(const char* start, size_t length, const char* keyword) {
+  return strlen(keyword) == length && strncmp(start, keyword, length) == 0;
+}
+
+/**
+ * Report the string literal at the current position as a specifier
+ * Returns false if there is no '...' or "..." literal here
+ */
+static bool report_specifier(LexerState* state, JSRT_ImportSpecifierCallback callback, void* opaque) {
+  char quote = peek(state);
+  if (quote != '"' && quote != '\'') {
+    return false;
+  }
+
+  size_t begin = state->pos + 1;
+  skip_string(state, quote);
+  if (state->pos == 0 || state->content[state->pos - 1] != quote || state->pos - 1 < begin) {
+    return true;  // Unterminated
+  }
+
+  size_t length = state->pos - 1 - begin;
+  const char* specifier = &state->content[begin];
+  if (length > 0 && !memchr(specifier, '\\', length)) {
+    MODULE_DEBUG_DETECTOR("Found import specifier '%.*s'", (int)length, specifier);
+    callback(specifier, length, opaque);
+  }
+  return true;
+}
+
+/**
+ * Skip a { ... } binding list, including quoted names
+ */
+static void skip_braces(LexerState* state) {
+  advance(state);  // skip {
+  while (true) {
+    skip_whitespace_and_comments(state);
+    char c = peek(state);
+    if (c == '\0') {
+      return;
+    }
+    if (c == '"' || c == '\'') {
+      skip_string(state, c);
+      continue;
+    }
+    advance(state);
+    if (c == '}') {
+      return;
+    }
+  }
+}
+
+/**
+ * After `from`, report the specifier; false if `from` is not followed by a string
+ */
+static bool scan_from_clause(LexerState* state, JSRT_ImportSpecifierCallback callback, void* opaque) {
+  skip_whitespace_and_comments(state);
+  return report_specifier(state, callback, opaque);
+}
+
+/**
+ * Scan what follows an `import` keyword
+ */
+static void scan_import(LexerState* state, JSRT_ImportSpecifierCallback callback, void* opaque) {
+  skip_whitespace_and_comments(state);
+
+  // import "x"
+  if (report_specifier(state, callback, opaque)) {
+    return;
+  }
+
+  // Bindings: default name, { ... }, * as ns, separated by commas, up to `from`
+  while (true) {
+    skip_whitespace_and_comments(state);
+    char c = peek(state);
+    if (c == '{') {
+      skip_braces(state);
+    } else if (c == '*' || c == ',') {
+      advance(state);
+    } else {
+      // import(...) and import.meta end up here too
+      const char* word;
+      size_t length = read_identifier(state, &word);
+      if (length == 0) {
+        return;
+      }
+      // `import from from "x"` binds a default export named "from"
+      if (identifier_is(word, length, "from") && scan_from_clause(state, callback, opaque)) {
+        return;
+      }
+    }
+  }
+}
+
+/**
+ * Scan what follows an `export` keyword; only re-exports have a specifier
+ */
+static void scan_export(LexerState* state, JSRT_ImportSpecifierCallback callback, void* opaque) {
+  skip_whitespace_and_comments(state);
+  char c = peek(state);
+  if (c == '*') {
+    advance(state);
+    skip_whitespace_and_comments(state);
+    const char* word;
+    size_t length = read_identifier(state, &word);
+    if (identifier_is(word, length, "as")) {
+      // export * as ns / export * as "name"
+      skip_whitespace_and_comments(state);
+      if (peek(state) == '"' || peek(state) == '\'') {
+        skip_string(state, peek(state));
+      } else {
+        read_identifier(state, &word);
+      }
+      skip_whitespace_and_comments(state);
+      length = read_identifier(state, &word);
+    }
+    if (identifier_is(word, length, "from")) {
+      scan_from_clause(state, callback, opaque);
+    }
+    return;
+  }
+
+  if (c == '{') {
+    skip_braces(state);
+    skip_whitespace_and_comments(state);
+    const char* word;
+    size_t length = read_identifier(state, &word);
+    if (identifier_is(word, length, "from")) {
+      scan_from_clause(state, callback, opaque);
+    }
+  }
+}
+
+/**
+ * Scan content for static import specifiers
+ */
+void jsrt_scan_import_specifiers(const char* content, size_t length, JSRT_ImportSpecifierCallback callback,
+                                 void* opaque) {
+  if (!content || length == 0 || !callback) {
+    return;
+  }
+
+  LexerState state = {
+      .content = content, .length = length, .pos = 0, .has_esm_pattern = false, .has_cjs_pattern = false};
+  bool after_dot = false;
+
+  while (state.pos < state.length) {
+    skip_whitespace_and_comments(&state);
+
+    char c = peek(&state);
+    if (c == '\0') {
+      break;
+    }
+
+    if (c == '"' || c == '\'' || c == '`') {
+      skip_string(&state, c);
+      after_dot = false;
+      continue;
+    }
+
+    // Consume whole identifiers so that e.g. `reimport` or `obj.import` never match
+    if (is_identifier_start(c)) {
+      const char* word;
+      size_t word_length = read_identifier(&state, &word);
+      if (!after_dot && identifier_is(word, word_length, "import")) {
+        scan_import(&state, callback, opaque);
+      } else if (!after_dot && identifier_is(word, word_length, "export")) {
+        scan_export(&state, callback, opaque);
+      }
+      after_dot = false;
+      continue;
+    }
+
+    after_dot = c == '.';
+    advance(&state);
+  }
+}
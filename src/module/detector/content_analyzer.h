@@ -37,6 +37,31 @@ extern "C" {
  */
 JSRT_ModuleFormat jsrt_analyze_content_format(const char* content, size_t length);
 
+/**
+ * Called for each static import specifier; `specifier` points into the
+ * scanned content and is not NUL-terminated
+ */
+typedef void (*JSRT_ImportSpecifierCallback)(const char* specifier, size_t length, void* opaque);
+
+/**
+ * Find the specifiers of static imports and re-exports
+ *
+ * Reports the string after:
+ * - import "x" / import x, { y } from "x" / import * as ns from "x"
+ * - export * from "x" / export * as ns from "x" / export { y } from "x"
+ *
+ * Dynamic import() and import.meta are skipped, as are specifiers with
+ * escape sequences. Like format detection this is a lexical scan, so it
+ * serves as a hint (e.g. for prefetching), not as the module's real graph.
+ *
+ * @param content Source to scan
+ * @param length Content length in bytes
+ * @param callback Receives each specifier in source order
+ * @param opaque Passed through to callback
+ */
+void jsrt_scan_import_specifiers(const char* content, size_t length, JSRT_ImportSpecifierCallback callback,
+                                 void* opaque);
+
 #ifdef __cplusplus
 }
 #endif
@@ -40,6 +40,22 @@ bool jsrt_is_babel_package(const char* resolved_path) {
   return false;
 }
 
+// Babel wrapper header: creates a robust 't' object that handles circular dependencies
+#define BABEL_WRAPPER_PREFIX                                                   \
+  "(function(exports, require, module, __filename, __dirname) {\n"             \
+  "var t = new Proxy(exports, {\n"                                             \
+  "  get: function(target, prop) {\n"                                          \
+  "    if (prop in target) {\n"                                                \
+  "      return target[prop];\n"                                               \
+  "    }\n"                                                                    \
+  "    // Handle lazy access to functions that might not be initialized yet\n" \
+  "    if (typeof prop === 'string' && prop.startsWith('is')) {\n"             \
+  "      return function() { return false; }; // Default implementation\n"     \
+  "    }\n"                                                                    \
+  "    return undefined;\n"                                                    \
+  "  }\n"                                                                      \
+  "});\n"
+
 /**
  * Create babel-specific wrapper code with global 't' variable
  */
@@ -61,24 +77,7 @@ static char* create_babel_wrapper_code(const char* content, const char* resolved
 
   // Babel-specific wrapper with enhanced global 't' variable definition
   // This creates a more robust 't' object that handles circular dependencies
-  int written = snprintf(wrapper, wrapper_size,
-                         "(function(exports, require, module, __filename, __dirname) {\n"
-                         "globalThis.__jsrt_cjs_modules&&globalThis.__jsrt_cjs_modules.add(__filename);\n"
-                         // Create a robust 't' object that handles circular dependencies
-                         "var t = new Proxy(exports, {\n"
-                         "  get: function(target, prop) {\n"
-                         "    if (prop in target) {\n"
-                         "      return target[prop];\n"
-                         "    }\n"
-                         "    // Handle lazy access to functions that might not be initialized yet\n"
-                         "    if (typeof prop === 'string' && prop.startsWith('is')) {\n"
-                         "      return function() { return false; }; // Default implementation\n"
-                         "    }\n"
-                         "    return undefined;\n"
-                         "  }\n"
-                         "});\n"
-                         "%s\n})",
-                         content);
+  int written = snprintf(wrapper, wrapper_size, BABEL_WRAPPER_PREFIX "%s\n})", content);
 
   // Check if snprintf was truncated
   if (written < 0 || (size_t)written >= wrapper_size) {
@@ -92,12 +91,7 @@ static char* create_babel_wrapper_code(const char* content, const char* resolved
     if (!wrapper) {
       return NULL;
     }
-    written = snprintf(wrapper, wrapper_size,
-                       "(function(exports, require, module, __filename, __dirname) {\n"
-                       "globalThis.__jsrt_cjs_modules&&globalThis.__jsrt_cjs_modules.add(__filename);\n"
-                       "var t = exports;  // Define global 't' for babel packages\n"
-                       "%s\n})",
-                       content);
+    written = snprintf(wrapper, wrapper_size, BABEL_WRAPPER_PREFIX "%s\n})", content);
     if (written < 0 || (size_t)written >= wrapper_size) {
       free(wrapper);
       return NULL;
@@ -121,6 +115,23 @@ char* jsrt_create_enhanced_wrapper_code(const char* content, const char* resolve
   }
 }
 
+/**
+ * Number of lines the wrapper adds before the module code
+ */
+int jsrt_enhanced_wrapper_line_offset(const char* resolved_path) {
+  if (!jsrt_is_babel_package(resolved_path)) {
+    return JSRT_COMMONJS_WRAPPER_LINES;
+  }
+
+  int lines = 0;
+  for (const char* p = BABEL_WRAPPER_PREFIX; *p; p++) {
+    if (*p == '\n') {
+      lines++;
+    }
+  }
+  return lines;
+}
+
 /**
  * Load babel package with special handling
  */
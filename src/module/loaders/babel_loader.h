@@ -22,6 +22,11 @@ bool jsrt_is_babel_package(const char* resolved_path);
  */
 char* jsrt_create_enhanced_wrapper_code(const char* content, const char* resolved_path);
 
+/**
+ * Number of lines the enhanced wrapper adds before the module code
+ */
+int jsrt_enhanced_wrapper_line_offset(const char* resolved_path);
+
 /**
  * Load babel package with special handling
  */
@@ -6,6 +6,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include "../../node/module/compile_cache.h"
+#include "../../node/module/error_stack.h"
 #include "../../node/node_modules.h"
 #include "../../runtime.h"  // For JSRT_Runtime
 #include "babel_loader.h"
@@ -27,6 +28,7 @@ JSRT_ReadFileResult jsrt_hook_result_to_file_result(JSRTHookLoadResult* hook_res
 #include "../resolver/path_util.h"
 #include "../util/module_debug.h"
 #include "../util/module_errors.h"
+#include "../../util/macro.h"
 
 // Loading stack for circular dependency detection
 #define MAX_LOADING_DEPTH 100
@@ -36,7 +38,7 @@ typedef struct {
   int count;
 } LoadingStack;
 
-static LoadingStack loading_stack = {{NULL}, 0};
+static JSRT_THREAD_LOCAL LoadingStack loading_stack = {{NULL}, 0};
 
 /**
  * Check if module is currently being loaded
@@ -154,12 +156,10 @@ char* create_wrapper_code(const char* content, const char* resolved_path) {
     return NULL;
   }
 
-  // CommonJS wrapper with line number fix registration
-  // Register module path for Error.stack line number adjustment (handled by error_stack_fix_cjs.js)
-  // The registration line ensures this file's path is tracked for line number adjustment
+  // The wrapper adds JSRT_COMMONJS_WRAPPER_LINES lines before the module code;
+  // Error.stack subtracts them (see jsrt_error_stack_set_line_offset)
   int written = snprintf(wrapper, wrapper_size,
                          "(function(exports, require, module, __filename, __dirname) {\n"
-                         "globalThis.__jsrt_cjs_modules&&globalThis.__jsrt_cjs_modules.add(__filename);\n"
                          "%s\n})",
                          content);
 
@@ -177,7 +177,6 @@ char* create_wrapper_code(const char* content, const char* resolved_path) {
     }
     written = snprintf(wrapper, wrapper_size,
                        "(function(exports, require, module, __filename, __dirname) {\n"
-                       "globalThis.__jsrt_cjs_modules&&globalThis.__jsrt_cjs_modules.add(__filename);\n"
                        "%s\n})",
                        content);
     if (written < 0 || (size_t)written >= wrapper_size) {
@@ -342,6 +341,8 @@ JSValue jsrt_load_commonjs_module(JSContext* ctx, JSRT_ModuleLoader* loader, con
     }
   }
 
+  jsrt_error_stack_set_line_offset(resolved_path, jsrt_enhanced_wrapper_line_offset(resolved_path));
+
   JSValue func = JS_EvalFunction(ctx, compiled_bytecode);
   compiled_bytecode = JS_UNDEFINED;
 
@@ -91,6 +91,9 @@ int jsrt_push_loading_commonjs(JSRT_ModuleLoader* loader, const char* resolved_p
  */
 int jsrt_pop_loading_commonjs(JSRT_ModuleLoader* loader);
 
+// Lines create_wrapper_code() adds before the module code
+#define JSRT_COMMONJS_WRAPPER_LINES 1
+
 /**
  * Create CommonJS wrapper code
  *
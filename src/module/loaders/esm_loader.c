@@ -457,6 +457,8 @@ extern bool JSRT_IsNodeModule(const char* name);
 extern bool is_absolute_path(const char* path);
 extern bool is_relative_path(const char* path);
 #endif
+extern bool jsrt_is_http_url(const char* url);
+extern char* jsrt_resolve_http_relative_import(const char* base_url, const char* relative_path);
 
 char* jsrt_esm_normalize_callback(JSContext* ctx, const char* module_base_name, const char* module_name, void* opaque) {
   MODULE_DEBUG_RESOLVER("=== ESM Normalize: '%s' from base '%s' ===", module_name,
@@ -481,6 +483,15 @@ char* jsrt_esm_normalize_callback(JSContext* ctx, const char* module_base_name,
   }
 #endif
 
+  // Relative and root-relative imports inside a remote module resolve against its URL, not the cwd
+  if (module_base_name && jsrt_is_http_url(module_base_name)) {
+    char* url = jsrt_resolve_http_relative_import(module_base_name, module_name);
+    if (url) {
+      MODULE_DEBUG_RESOLVER("Resolved '%s' against remote base to '%s'", module_name, url);
+      return url;
+    }
+  }
+
   // CRITICAL FIX: Convert relative base path to absolute path
   // When QuickJS loads a module directly (e.g., jsrt test.mjs), it may pass
   // a relative filename as module_base_name. For bare specifiers like 'hono',
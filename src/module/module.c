@@ -38,6 +38,7 @@ static char* jsrt_realpath(const char* path, char* resolved_path) {
 #include "../util/debug.h"
 #include "../util/file.h"
 #include "../util/json.h"
+#include "../util/macro.h"
 #include "../util/path.h"
 #include "loaders/commonjs_loader.h"  // For new CommonJS loader
 #include "loaders/esm_loader.h"       // For new ES module loader bridge
@@ -771,8 +772,9 @@ char* JSRT_StdModuleNormalize(JSContext* ctx, const char* module_base_name, cons
   }
 
   // Handle relative imports from HTTP modules
-  if (jsrt_is_http_url(module_base_name) && module_name[0] == '.' &&
-      (module_name[1] == '/' || (module_name[1] == '.' && module_name[2] == '/'))) {
+  if (jsrt_is_http_url(module_base_name) &&
+      ((module_name[0] == '/' && module_name[1] != '/') ||
+       (module_name[0] == '.' && (module_name[1] == '/' || (module_name[1] == '.' && module_name[2] == '/'))))) {
     char* resolved = jsrt_resolve_http_relative_import(module_base_name, module_name);
     if (resolved) {
       JSRT_HttpSecurityResult security_result = jsrt_http_validate_url(resolved);
@@ -1095,14 +1097,14 @@ typedef struct {
   JSValue exports;
 } RequireModuleCache;
 
-static RequireModuleCache* module_cache = NULL;
-static size_t module_cache_size = 0;
-static size_t module_cache_capacity = 0;
+static JSRT_THREAD_LOCAL RequireModuleCache* module_cache = NULL;
+static JSRT_THREAD_LOCAL size_t module_cache_size = 0;
+static JSRT_THREAD_LOCAL size_t module_cache_capacity = 0;
 
 // Current module path context for relative require resolution
-static char* current_module_path = NULL;
-static char* entry_module_path = NULL;
-static JSRT_Runtime* global_runtime = NULL;  // Store runtime for updating global require()
+static JSRT_THREAD_LOCAL char* current_module_path = NULL;
+static JSRT_THREAD_LOCAL char* entry_module_path = NULL;
+static JSRT_THREAD_LOCAL JSRT_Runtime* global_runtime = NULL;  // Store runtime for updating global require()
 
 static int get_not_found_strings(const char* module_display, const char* require_display, bool include_require_section,
                                  char** message_out, char** stack_out) {
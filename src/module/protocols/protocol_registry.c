@@ -5,6 +5,7 @@
 #include "protocol_registry.h"
 #include <stdlib.h>
 #include <string.h>
+#include "../../util/macro.h"
 #include "../util/module_debug.h"
 
 // Platform-specific threading
@@ -34,8 +35,8 @@ typedef struct {
   bool in_use;
 } ProtocolRegistryEntry;
 
-// Global registry with mutex protection
-static struct {
+// Per-runtime registry with mutex protection
+static JSRT_THREAD_LOCAL struct {
   ProtocolRegistryEntry entries[MAX_PROTOCOLS];
   size_t count;
   bool initialized;
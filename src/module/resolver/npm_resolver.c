@@ -7,20 +7,13 @@
 #include <stdlib.h>
 #include <string.h>
 
-#ifdef _WIN32
-#include <io.h>
-#define F_OK 0
-#define access _access
-#else
-#include <unistd.h>
-#endif
-
 #include "../../util/file.h"
 #include "../util/module_debug.h"
 #include "package_json.h"
 #include "path_util.h"
+#include "resolver_cache.h"
 
-char* jsrt_find_node_modules(const char* start_dir, const char* package_name) {
+char* jsrt_find_node_modules(JSContext* ctx, const char* start_dir, const char* package_name) {
   if (!start_dir || !package_name) {
     MODULE_DEBUG_RESOLVER("Cannot find node_modules: NULL start_dir or package_name");
     return NULL;
@@ -49,7 +42,7 @@ char* jsrt_find_node_modules(const char* start_dir, const char* package_name) {
       break;
 
     // Check if the package directory exists
-    if (access(package_path, F_OK) == 0) {
+    if (jsrt_resolver_stat(ctx, package_path) != JSRT_RESOLVER_STAT_MISSING) {
       MODULE_DEBUG_RESOLVER("Found package at '%s'", package_path);
       result = package_path;
       break;
@@ -273,7 +266,7 @@ char* jsrt_resolve_npm_module(JSContext* ctx, const char* module_name, const cha
   MODULE_DEBUG_RESOLVER("Parsed as package='%s', subpath='%s'", package_name, subpath ? subpath : "(none)");
 
   // Find the package directory
-  char* package_dir = jsrt_find_node_modules(start_dir, package_name);
+  char* package_dir = jsrt_find_node_modules(ctx, start_dir, package_name);
   free(start_dir);
   free(package_name);
 
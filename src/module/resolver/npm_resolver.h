@@ -17,12 +17,13 @@ extern "C" {
 /**
  * Find node_modules directory containing a package
  * Walks up directory tree looking for node_modules/package_name
+ * @param ctx JavaScript context (for the resolver's stat cache, can be NULL)
  * @param start_dir Starting directory for search
  * @param package_name Package name to find
  * @return Full path to package directory, or NULL if not found
  * @note Caller must free returned string
  */
-char* jsrt_find_node_modules(const char* start_dir, const char* package_name);
+char* jsrt_find_node_modules(JSContext* ctx, const char* start_dir, const char* package_name);
 
 /**
  * Resolve package main entry point
@@ -11,6 +11,7 @@
 #include "../../util/json.h"
 #include "../util/module_debug.h"
 #include "path_util.h"
+#include "resolver_cache.h"
 
 // Helper to get string property from JSON object
 static char* get_string_property(JSContext* ctx, JSValue obj, const char* prop_name) {
@@ -36,12 +37,7 @@ static char* get_string_property(JSContext* ctx, JSValue obj, const char* prop_n
   return result;
 }
 
-JSRT_PackageJson* jsrt_parse_package_json_file(JSContext* ctx, const char* json_path) {
-  if (!ctx || !json_path) {
-    MODULE_DEBUG_RESOLVER("Cannot parse package.json: NULL ctx or path");
-    return NULL;
-  }
-
+static JSRT_PackageJson* parse_package_json_file_uncached(JSContext* ctx, const char* json_path) {
   MODULE_DEBUG_RESOLVER("Parsing package.json from '%s'", json_path);
 
   // Read file
@@ -70,6 +66,7 @@ JSRT_PackageJson* jsrt_parse_package_json_file(JSContext* ctx, const char* json_
   }
 
   pkg->ctx = ctx;
+  pkg->ref_count = 1;
 
   // Get directory path
   pkg->dir_path = jsrt_get_parent_directory(json_path);
@@ -104,6 +101,30 @@ JSRT_PackageJson* jsrt_parse_package_json_file(JSContext* ctx, const char* json_
   return pkg;
 }
 
+JSRT_PackageJson* jsrt_parse_package_json_file(JSContext* ctx, const char* json_path) {
+  if (!ctx || !json_path) {
+    MODULE_DEBUG_RESOLVER("Cannot parse package.json: NULL ctx or path");
+    return NULL;
+  }
+
+  JSRT_ModuleResolver* resolver = jsrt_module_resolver_get(ctx);
+  char* dir_path = resolver ? jsrt_get_parent_directory(json_path) : NULL;
+  if (!dir_path) {
+    return parse_package_json_file_uncached(ctx, json_path);
+  }
+
+  JSRT_PackageJson* pkg = NULL;
+  if (jsrt_module_resolver_get_package(resolver, dir_path, &pkg)) {
+    MODULE_DEBUG_RESOLVER("package.json cache hit for '%s'", dir_path);
+  } else {
+    pkg = parse_package_json_file_uncached(ctx, json_path);
+    jsrt_module_resolver_put_package(resolver, dir_path, pkg);
+  }
+
+  free(dir_path);
+  return pkg;
+}
+
 JSRT_PackageJson* jsrt_parse_package_json(JSContext* ctx, const char* dir_path) {
   if (!ctx || !dir_path) {
     MODULE_DEBUG_RESOLVER("Cannot parse package.json: NULL ctx or dir_path");
@@ -124,10 +145,8 @@ JSRT_PackageJson* jsrt_parse_package_json(JSContext* ctx, const char* dir_path)
     if (!json_path)
       break;
 
-    // Check if package.json exists
-    JSRT_ReadFileResult test_result = JSRT_ReadFile(json_path);
-    if (test_result.error == JSRT_READ_FILE_OK) {
-      JSRT_ReadFileResultFree(&test_result);
+    // Check if package.json exists (through the resolver's stat cache)
+    if (jsrt_resolver_stat(ctx, json_path) == JSRT_RESOLVER_STAT_FILE) {
       MODULE_DEBUG_RESOLVER("Found package.json at '%s'", json_path);
 
       // Parse it
@@ -136,7 +155,6 @@ JSRT_PackageJson* jsrt_parse_package_json(JSContext* ctx, const char* dir_path)
       break;
     }
 
-    JSRT_ReadFileResultFree(&test_result);
     free(json_path);
 
     // Move up one directory
@@ -160,7 +178,7 @@ JSRT_PackageJson* jsrt_parse_package_json(JSContext* ctx, const char* dir_path)
 }
 
 void jsrt_package_json_free(JSRT_PackageJson* pkg) {
-  if (!pkg)
+  if (!pkg || --pkg->ref_count > 0)
     return;
 
   free(pkg->type);
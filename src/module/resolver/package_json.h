@@ -25,6 +25,7 @@ typedef struct {
   JSValue imports;  // Imports map (JSON object)
   char* dir_path;   // Directory containing package.json
   JSContext* ctx;   // Context for JSValue lifecycle
+  int ref_count;    // Shared with the resolver's package.json cache
 } JSRT_PackageJson;
 
 /**
@@ -39,6 +40,7 @@ JSRT_PackageJson* jsrt_parse_package_json(JSContext* ctx, const char* dir_path);
 
 /**
  * Parse package.json from exact path
+ * Results are cached per directory by the runtime's module resolver
  * @param ctx JavaScript context
  * @param json_path Exact path to package.json file
  * @return Parsed package.json (caller must free with jsrt_package_json_free)
@@ -47,7 +49,7 @@ JSRT_PackageJson* jsrt_parse_package_json(JSContext* ctx, const char* dir_path);
 JSRT_PackageJson* jsrt_parse_package_json_file(JSContext* ctx, const char* json_path);
 
 /**
- * Free a package.json structure
+ * Release a package.json structure (freed once the cache no longer holds it)
  * @param pkg Package.json to free
  */
 void jsrt_package_json_free(JSRT_PackageJson* pkg);
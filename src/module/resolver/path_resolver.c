@@ -7,16 +7,6 @@
 #include <stdlib.h>
 #include <string.h>
 
-#ifdef _WIN32
-#include <io.h>
-#include <sys/stat.h>
-#define S_ISDIR(m) (((m) & S_IFMT) == S_IFDIR)
-#define S_ISREG(m) (((m) & S_IFMT) == S_IFREG)
-#else
-#include <sys/stat.h>
-#include <unistd.h>
-#endif
-
 #include "../../node/module/hooks.h"
 #include "../../runtime.h"
 #include "../../util/file.h"
@@ -24,35 +14,20 @@
 #include "npm_resolver.h"
 #include "package_json.h"
 #include "path_util.h"
+#include "resolver_cache.h"
 #include "specifier.h"
 
 // Helper to check if a path is a directory
-static bool is_directory(const char* path) {
-  if (!path)
-    return false;
-
-  struct stat st;
-  if (stat(path, &st) != 0) {
-    return false;
-  }
-  return S_ISDIR(st.st_mode);
+static bool is_directory(JSContext* ctx, const char* path) {
+  return jsrt_resolver_stat(ctx, path) == JSRT_RESOLVER_STAT_DIRECTORY;
 }
 
-// Helper to check if a file exists (and is a regular file)
-static bool file_exists(const char* path) {
-  if (!path)
-    return false;
-
-  struct stat st;
-  if (stat(path, &st) != 0) {
-    return false;
-  }
-
-  // Only return true for regular files, not directories
-  return S_ISREG(st.st_mode);
+// Helper to check if a file exists (and is a regular file, not a directory)
+static bool file_exists(JSContext* ctx, const char* path) {
+  return jsrt_resolver_stat(ctx, path) == JSRT_RESOLVER_STAT_FILE;
 }
 
-char* jsrt_try_extensions(const char* base_path) {
+char* jsrt_try_extensions(JSContext* ctx, const char* base_path) {
   if (!base_path) {
     MODULE_DEBUG_RESOLVER("Cannot try extensions: NULL base_path");
     return NULL;
@@ -72,7 +47,7 @@ char* jsrt_try_extensions(const char* base_path) {
 
     snprintf(full_path, total_len, "%s%s", base_path, ext);
 
-    if (file_exists(full_path)) {
+    if (file_exists(ctx, full_path)) {
       MODULE_DEBUG_RESOLVER("Found file with extension '%s': %s", ext, full_path);
       return full_path;
     }
@@ -84,7 +59,7 @@ char* jsrt_try_extensions(const char* base_path) {
   return NULL;
 }
 
-char* jsrt_try_directory_index(const char* dir_path) {
+char* jsrt_try_directory_index(JSContext* ctx, const char* dir_path) {
   if (!dir_path) {
     MODULE_DEBUG_RESOLVER("Cannot try directory index: NULL dir_path");
     return NULL;
@@ -100,7 +75,7 @@ char* jsrt_try_directory_index(const char* dir_path) {
     if (!index_path)
       continue;
 
-    if (file_exists(index_path)) {
+    if (file_exists(ctx, index_path)) {
       MODULE_DEBUG_RESOLVER("Found directory index: %s", index_path);
       return index_path;
     }
@@ -189,6 +164,23 @@ JSRT_ResolvedPath* jsrt_resolve_path(JSContext* ctx, const char* specifier, cons
     MODULE_DEBUG_RESOLVER("Resolve hooks did not return a result, continuing with normal resolution");
   }
 
+  // Repeated requests from the same directory skip the filesystem entirely
+  JSRT_ModuleResolver* resolver = jsrt_module_resolver_get(ctx);
+  if (resolver) {
+    JSRT_SpecifierType memo_type;
+    char* memo_path = jsrt_module_resolver_get_resolved(resolver, specifier, base_path, is_esm, &memo_type);
+    if (memo_path) {
+      JSRT_ResolvedPath* memo_result = (JSRT_ResolvedPath*)calloc(1, sizeof(JSRT_ResolvedPath));
+      if (memo_result) {
+        MODULE_DEBUG_RESOLVER("Resolution cache hit: %s", memo_path);
+        memo_result->resolved_path = memo_path;
+        memo_result->type = memo_type;
+        return memo_result;
+      }
+      free(memo_path);
+    }
+  }
+
   // Parse the specifier
   JSRT_ModuleSpecifier* spec = jsrt_parse_specifier(specifier);
   if (!spec) {
@@ -269,6 +261,7 @@ JSRT_ResolvedPath* jsrt_resolve_path(JSContext* ctx, const char* specifier, cons
   if (!resolved) {
     MODULE_DEBUG_RESOLVER("Path resolution failed");
     jsrt_resolved_path_free(result);
+    jsrt_module_resolver_forget_missing(resolver);
     return NULL;
   }
 
@@ -277,18 +270,18 @@ JSRT_ResolvedPath* jsrt_resolve_path(JSContext* ctx, const char* specifier, cons
     // **CRITICAL**: Try extensions FIRST before checking if it's a directory
     // This handles cases where both 'http.js' (file) and 'http/' (directory) exist
     // The file should take priority over the directory for relative requires
-    if (file_exists(resolved)) {
+    if (file_exists(ctx, resolved)) {
       // It's a regular file that exists exactly as specified
       MODULE_DEBUG_RESOLVER("Resolved path exists as exact file: %s", resolved);
       result->resolved_path = resolved;
     } else {
       // Try to find a file with extensions (this is the key fix)
-      char* with_ext = jsrt_try_extensions(resolved);
+      char* with_ext = jsrt_try_extensions(ctx, resolved);
       if (with_ext) {
         MODULE_DEBUG_RESOLVER("Resolved path with extension: %s", with_ext);
         free(resolved);
         result->resolved_path = with_ext;
-      } else if (is_directory(resolved)) {
+      } else if (is_directory(ctx, resolved)) {
         // If no file with extension found, check if it's a directory
         MODULE_DEBUG_RESOLVER("Resolved path is a directory: %s", resolved);
 
@@ -300,7 +293,7 @@ JSRT_ResolvedPath* jsrt_resolve_path(JSContext* ctx, const char* specifier, cons
           result->resolved_path = package_main;
         } else {
           // Fallback to directory index
-          char* dir_index = jsrt_try_directory_index(resolved);
+          char* dir_index = jsrt_try_directory_index(ctx, resolved);
           if (dir_index) {
             MODULE_DEBUG_RESOLVER("Resolved directory via index file: %s", dir_index);
             free(resolved);
@@ -312,7 +305,7 @@ JSRT_ResolvedPath* jsrt_resolve_path(JSContext* ctx, const char* specifier, cons
         }
       } else {
         // Try as directory index (handles case where 'http' resolves to 'http/index.js')
-        char* dir_index = jsrt_try_directory_index(resolved);
+        char* dir_index = jsrt_try_directory_index(ctx, resolved);
         if (dir_index) {
           MODULE_DEBUG_RESOLVER("Resolved as directory index: %s", dir_index);
           free(resolved);
@@ -325,6 +318,16 @@ JSRT_ResolvedPath* jsrt_resolve_path(JSContext* ctx, const char* specifier, cons
         }
       }
     }
+
+    // Only resolutions that found a file are memoized; a miss may be fixed by creating the file,
+    // so forget the negative stat results that led to it
+    if (resolver) {
+      if (file_exists(ctx, result->resolved_path)) {
+        jsrt_module_resolver_put_resolved(resolver, specifier, base_path, is_esm, result->type, result->resolved_path);
+      } else {
+        jsrt_module_resolver_forget_missing(resolver);
+      }
+    }
   } else {
     // URL or builtin - use as-is
     result->resolved_path = resolved;
@@ -30,7 +30,8 @@ typedef struct {
 
 /**
  * Resolve a module specifier to an absolute path or URL
- * This is the main entry point for path resolution
+ * This is the main entry point for path resolution; file results are
+ * memoized per requesting directory by the runtime's module resolver
  * @param ctx JavaScript context (for package.json parsing)
  * @param specifier Module specifier string
  * @param base_path Base path for relative resolution (requesting module's path)
@@ -47,19 +48,21 @@ void jsrt_resolved_path_free(JSRT_ResolvedPath* path);
 
 /**
  * Try file extensions (.js, .mjs, .cjs) on a base path
+ * @param ctx JavaScript context (for the resolver's stat cache, can be NULL)
  * @param base_path Base path without extension
  * @return Path with extension if file exists, or NULL if none found
  * @note Caller must free returned string
  */
-char* jsrt_try_extensions(const char* base_path);
+char* jsrt_try_extensions(JSContext* ctx, const char* base_path);
 
 /**
  * Try directory index files (index.js, index.mjs, index.cjs)
+ * @param ctx JavaScript context (for the resolver's stat cache, can be NULL)
  * @param dir_path Directory path
  * @return Path to index file if exists, or NULL if none found
  * @note Caller must free returned string
  */
-char* jsrt_try_directory_index(const char* dir_path);
+char* jsrt_try_directory_index(JSContext* ctx, const char* dir_path);
 
 /**
  * Validate and normalize a URL specifier
@@ -0,0 +1,415 @@
+/**
+ * Module Resolver Cache Implementation
+ *
+ * Three string-keyed hash tables (FNV-1a, chaining) owned by the module
+ * loader. Entries live until they are invalidated or the loader is freed; a
+ * table that reaches JSRT_RESOLVER_CACHE_MAX_ENTRIES is simply emptied.
+ */
+
+#include "resolver_cache.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+#define S_ISDIR(m) (((m) & S_IFMT) == S_IFDIR)
+#define S_ISREG(m) (((m) & S_IFMT) == S_IFREG)
+#endif
+
+#include "../../runtime.h"
+#include "../util/module_debug.h"
+#include "path_util.h"
+
+#define JSRT_RESOLVER_CACHE_INITIAL_CAPACITY 256
+#define JSRT_RESOLVER_CACHE_MAX_ENTRIES 65536
+
+// FNV-1a hash constants
+#define FNV_OFFSET_BASIS 14695981039346656037ULL
+#define FNV_PRIME 1099511628211ULL
+
+struct JSRT_ResolverCacheEntry {
+  char* key;
+  uint64_t hash;
+  int type;               // Stat cache: JSRT_ResolverStatType; memo: JSRT_SpecifierType
+  char* path;             // Memo: resolved path
+  JSRT_PackageJson* pkg;  // Package cache: parsed package.json (NULL if the directory has none)
+  struct JSRT_ResolverCacheEntry* next;
+};
+
+static uint64_t hash_string(const char* str) {
+  uint64_t hash = FNV_OFFSET_BASIS;
+  while (*str) {
+    hash ^= (uint64_t)(unsigned char)(*str++);
+    hash *= FNV_PRIME;
+  }
+  return hash;
+}
+
+static void entry_free(JSRT_ResolverCacheEntry* entry) {
+  free(entry->key);
+  free(entry->path);
+  jsrt_package_json_free(entry->pkg);
+  free(entry);
+}
+
+static bool table_init(JSRT_ResolverCacheTable* table) {
+  table->buckets = calloc(JSRT_RESOLVER_CACHE_INITIAL_CAPACITY, sizeof(JSRT_ResolverCacheEntry*));
+  table->capacity = JSRT_RESOLVER_CACHE_INITIAL_CAPACITY;
+  table->size = 0;
+  return table->buckets != NULL;
+}
+
+static void table_clear(JSRT_ResolverCacheTable* table) {
+  if (!table->buckets) {
+    return;
+  }
+
+  for (size_t i = 0; i < table->capacity; i++) {
+    JSRT_ResolverCacheEntry* entry = table->buckets[i];
+    while (entry) {
+      JSRT_ResolverCacheEntry* next = entry->next;
+      entry_free(entry);
+      entry = next;
+    }
+    table->buckets[i] = NULL;
+  }
+  table->size = 0;
+}
+
+static void table_free(JSRT_ResolverCacheTable* table) {
+  table_clear(table);
+  free(table->buckets);
+  table->buckets = NULL;
+  table->capacity = 0;
+}
+
+static JSRT_ResolverCacheEntry* table_find(JSRT_ResolverCacheTable* table, const char* key) {
+  uint64_t hash = hash_string(key);
+  JSRT_ResolverCacheEntry* entry = table->buckets[hash & (table->capacity - 1)];
+  while (entry) {
+    if (entry->hash == hash && strcmp(entry->key, key) == 0) {
+      return entry;
+    }
+    entry = entry->next;
+  }
+  return NULL;
+}
+
+// Double the bucket count once the load factor reaches 1 (entries keep their hash)
+static void table_grow(JSRT_ResolverCacheTable* table) {
+  size_t new_capacity = table->capacity * 2;
+  JSRT_ResolverCacheEntry** new_buckets = calloc(new_capacity, sizeof(JSRT_ResolverCacheEntry*));
+  if (!new_buckets) {
+    return;  // Keep the current, more crowded buckets
+  }
+
+  for (size_t i = 0; i < table->capacity; i++) {
+    JSRT_ResolverCacheEntry* entry = table->buckets[i];
+    while (entry) {
+      JSRT_ResolverCacheEntry* next = entry->next;
+      size_t index = entry->hash & (new_capacity - 1);
+      entry->next = new_buckets[index];
+      new_buckets[index] = entry;
+      entry = next;
+    }
+  }
+
+  free(table->buckets);
+  table->buckets = new_buckets;
+  table->capacity = new_capacity;
+}
+
+// Insert a new, empty entry for key (the caller has checked that key is not present)
+static JSRT_ResolverCacheEntry* table_insert(JSRT_ResolverCacheTable* table, const char* key) {
+  if (table->size >= JSRT_RESOLVER_CACHE_MAX_ENTRIES) {
+    MODULE_DEBUG_CACHE("Resolver cache table full, clearing %zu entries", table->size);
+    table_clear(table);
+  } else if (table->size >= table->capacity) {
+    table_grow(table);
+  }
+
+  JSRT_ResolverCacheEntry* entry = calloc(1, sizeof(JSRT_ResolverCacheEntry));
+  if (!entry) {
+    return NULL;
+  }
+  entry->key = strdup(key);
+  if (!entry->key) {
+    free(entry);
+    return NULL;
+  }
+  entry->hash = hash_string(key);
+
+  size_t index = entry->hash & (table->capacity - 1);
+  entry->next = table->buckets[index];
+  table->buckets[index] = entry;
+  table->size++;
+  return entry;
+}
+
+// Remove every entry for which match() returns true
+static void table_remove_if(JSRT_ResolverCacheTable* table, bool (*match)(JSRT_ResolverCacheEntry*, const void*),
+                            const void* arg) {
+  for (size_t i = 0; i < table->capacity; i++) {
+    JSRT_ResolverCacheEntry** link = &table->buckets[i];
+    while (*link) {
+      JSRT_ResolverCacheEntry* entry = *link;
+      if (match(entry, arg)) {
+        *link = entry->next;
+        entry_free(entry);
+        table->size--;
+      } else {
+        link = &entry->next;
+      }
+    }
+  }
+}
+
+JSRT_ModuleResolver* jsrt_module_resolver_create(JSContext* ctx) {
+  JSRT_ModuleResolver* resolver = calloc(1, sizeof(JSRT_ModuleResolver));
+  if (!resolver) {
+    MODULE_DEBUG_ERROR("Failed to allocate module resolver: out of memory");
+    return NULL;
+  }
+
+  resolver->ctx = ctx;
+  if (!table_init(&resolver->stats) || !table_init(&resolver->packages) || !table_init(&resolver->resolved)) {
+    MODULE_DEBUG_ERROR("Failed to allocate module resolver tables: out of memory");
+    jsrt_module_resolver_free(resolver);
+    return NULL;
+  }
+
+  MODULE_DEBUG_CACHE("Module resolver cache created at %p", (void*)resolver);
+  return resolver;
+}
+
+void jsrt_module_resolver_free(JSRT_ModuleResolver* resolver) {
+  if (!resolver) {
+    return;
+  }
+
+  MODULE_DEBUG_CACHE("Freeing module resolver cache (stat %llu/%llu, package.json %llu/%llu, resolve %llu/%llu)",
+                     (unsigned long long)resolver->stat_hits, (unsigned long long)resolver->stat_misses,
+                     (unsigned long long)resolver->package_hits, (unsigned long long)resolver->package_misses,
+                     (unsigned long long)resolver->resolve_hits, (unsigned long long)resolver->resolve_misses);
+
+  table_free(&resolver->stats);
+  table_free(&resolver->packages);
+  table_free(&resolver->resolved);
+  free(resolver);
+}
+
+JSRT_ModuleResolver* jsrt_module_resolver_get(JSContext* ctx) {
+  if (!ctx) {
+    return NULL;
+  }
+
+  JSRT_Runtime* rt = JS_GetContextOpaque(ctx);
+  if (!rt || !rt->module_loader) {
+    return NULL;
+  }
+  return rt->module_loader->resolver;
+}
+
+static JSRT_ResolverStatType stat_uncached(const char* path) {
+  struct stat st;
+  if (stat(path, &st) != 0) {
+    return JSRT_RESOLVER_STAT_MISSING;
+  }
+  if (S_ISREG(st.st_mode)) {
+    return JSRT_RESOLVER_STAT_FILE;
+  }
+  if (S_ISDIR(st.st_mode)) {
+    return JSRT_RESOLVER_STAT_DIRECTORY;
+  }
+  return JSRT_RESOLVER_STAT_OTHER;
+}
+
+JSRT_ResolverStatType jsrt_resolver_stat(JSContext* ctx, const char* path) {
+  if (!path) {
+    return JSRT_RESOLVER_STAT_MISSING;
+  }
+
+  JSRT_ModuleResolver* resolver = jsrt_module_resolver_get(ctx);
+  if (!resolver) {
+    return stat_uncached(path);
+  }
+
+  JSRT_ResolverCacheEntry* entry = table_find(&resolver->stats, path);
+  if (entry) {
+    resolver->stat_hits++;
+    return (JSRT_ResolverStatType)entry->type;
+  }
+
+  resolver->stat_misses++;
+  JSRT_ResolverStatType type = stat_uncached(path);
+  entry = table_insert(&resolver->stats, path);
+  if (entry) {
+    entry->type = type;
+  }
+  return type;
+}
+
+bool jsrt_module_resolver_get_package(JSRT_ModuleResolver* resolver, const char* dir_path, JSRT_PackageJson** pkg) {
+  JSRT_ResolverCacheEntry* entry = table_find(&resolver->packages, dir_path);
+  if (!entry) {
+    resolver->package_misses++;
+    return false;
+  }
+
+  resolver->package_hits++;
+  if (entry->pkg) {
+    entry->pkg->ref_count++;
+  }
+  *pkg = entry->pkg;
+  return true;
+}
+
+void jsrt_module_resolver_put_package(JSRT_ModuleResolver* resolver, const char* dir_path, JSRT_PackageJson* pkg) {
+  if (table_find(&resolver->packages, dir_path)) {
+    return;
+  }
+
+  JSRT_ResolverCacheEntry* entry = table_insert(&resolver->packages, dir_path);
+  if (entry && pkg) {
+    pkg->ref_count++;
+    entry->pkg = pkg;
+  }
+}
+
+// Memo key: request kind, directory of the requesting module and specifier.
+// Resolution only depends on the requesting module's directory, so siblings share entries.
+static char* make_resolved_key(const char* specifier, const char* base_path, bool is_esm) {
+  char* base_dir = NULL;
+  if (!jsrt_is_absolute_path(specifier)) {
+    if (!base_path) {
+      return NULL;  // Relative to the current directory, which can change
+    }
+    base_dir = jsrt_get_parent_directory(base_path);
+    if (!base_dir || !jsrt_is_absolute_path(base_dir)) {
+      free(base_dir);
+      return NULL;
+    }
+  }
+
+  size_t key_len = (base_dir ? strlen(base_dir) : 0) + strlen(specifier) + 4;
+  char* key = malloc(key_len);
+  if (key) {
+    snprintf(key, key_len, "%c\n%s\n%s", is_esm ? 'e' : 'c', base_dir ? base_dir : "", specifier);
+  }
+  free(base_dir);
+  return key;
+}
+
+char* jsrt_module_resolver_get_resolved(JSRT_ModuleResolver* resolver, const char* specifier, const char* base_path,
+                                        bool is_esm, JSRT_SpecifierType* type) {
+  char* key = make_resolved_key(specifier, base_path, is_esm);
+  if (!key) {
+    return NULL;
+  }
+
+  JSRT_ResolverCacheEntry* entry = table_find(&resolver->resolved, key);
+  free(key);
+  if (!entry) {
+    resolver->resolve_misses++;
+    return NULL;
+  }
+
+  resolver->resolve_hits++;
+  *type = (JSRT_SpecifierType)entry->type;
+  return strdup(entry->path);
+}
+
+void jsrt_module_resolver_put_resolved(JSRT_ModuleResolver* resolver, const char* specifier, const char* base_path,
+                                       bool is_esm, JSRT_SpecifierType type, const char* resolved_path) {
+  char* key = make_resolved_key(specifier, base_path, is_esm);
+  if (!key) {
+    return;
+  }
+
+  char* path = table_find(&resolver->resolved, key) ? NULL : strdup(resolved_path);
+  JSRT_ResolverCacheEntry* entry = path ? table_insert(&resolver->resolved, key) : NULL;
+  if (entry) {
+    entry->type = type;
+    entry->path = path;
+  } else {
+    free(path);
+  }
+  free(key);
+}
+
+static bool match_key(JSRT_ResolverCacheEntry* entry, const void* arg) {
+  return strcmp(entry->key, (const char*)arg) == 0;
+}
+
+static bool match_resolved_path(JSRT_ResolverCacheEntry* entry, const void* arg) {
+  return entry->path && strcmp(entry->path, (const char*)arg) == 0;
+}
+
+static bool match_missing_stat(JSRT_ResolverCacheEntry* entry, const void* arg) {
+  (void)arg;
+  return entry->type == JSRT_RESOLVER_STAT_MISSING;
+}
+
+static bool match_missing_package(JSRT_ResolverCacheEntry* entry, const void* arg) {
+  (void)arg;
+  return entry->pkg == NULL;
+}
+
+void jsrt_module_resolver_invalidate(JSRT_ModuleResolver* resolver, const char* path) {
+  if (!resolver || !path) {
+    return;
+  }
+
+  MODULE_DEBUG_CACHE("Invalidating resolver cache for: %s", path);
+
+  table_remove_if(&resolver->stats, match_key, path);
+  table_remove_if(&resolver->packages, match_key, path);
+  table_remove_if(&resolver->resolved, match_resolved_path, path);
+
+  // A changed package.json invalidates its directory's entry
+  char* dir = jsrt_get_parent_directory(path);
+  if (dir) {
+    const char* base = path + strlen(path);
+    while (base > path && !jsrt_is_path_separator(base[-1])) {
+      base--;
+    }
+    if (strcmp(base, "package.json") == 0) {
+      table_remove_if(&resolver->packages, match_key, dir);
+    }
+    free(dir);
+  }
+}
+
+void jsrt_module_resolver_forget_missing(JSRT_ModuleResolver* resolver) {
+  if (!resolver) {
+    return;
+  }
+
+  table_remove_if(&resolver->stats, match_missing_stat, NULL);
+  table_remove_if(&resolver->packages, match_missing_package, NULL);
+}
+
+void jsrt_module_resolver_clear(JSRT_ModuleResolver* resolver) {
+  if (!resolver) {
+    return;
+  }
+
+  MODULE_DEBUG_CACHE("Clearing resolver cache");
+  table_clear(&resolver->stats);
+  table_clear(&resolver->packages);
+  table_clear(&resolver->resolved);
+}
+
+void jsrt_module_resolver_reset_stats(JSRT_ModuleResolver* resolver) {
+  if (!resolver) {
+    return;
+  }
+
+  resolver->stat_hits = 0;
+  resolver->stat_misses = 0;
+  resolver->package_hits = 0;
+  resolver->package_misses = 0;
+  resolver->resolve_hits = 0;
+  resolver->resolve_misses = 0;
+}
@@ -0,0 +1,167 @@
+/**
+ * Module Resolver Cache
+ *
+ * Per-loader caches that let module resolution skip repeated filesystem work:
+ * - stat cache: positive and negative results of stat() for candidate paths
+ * - package.json cache: parsed package.json keyed by directory, shared by
+ *   the resolver and the format detector
+ * - resolution memo: (base directory, specifier) -> resolved file path
+ */
+
+#ifndef JSRT_MODULE_RESOLVER_CACHE_H
+#define JSRT_MODULE_RESOLVER_CACHE_H
+
+#include <quickjs.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "../core/module_context.h"
+#include "package_json.h"
+#include "specifier.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Result of a cached stat() call
+ */
+typedef enum {
+  JSRT_RESOLVER_STAT_MISSING = 0,  // Path does not exist
+  JSRT_RESOLVER_STAT_FILE = 1,     // Regular file
+  JSRT_RESOLVER_STAT_DIRECTORY = 2,
+  JSRT_RESOLVER_STAT_OTHER = 3  // Exists, but neither file nor directory
+} JSRT_ResolverStatType;
+
+typedef struct JSRT_ResolverCacheEntry JSRT_ResolverCacheEntry;
+
+/**
+ * Hash table with chaining, used for all three caches
+ */
+typedef struct {
+  JSRT_ResolverCacheEntry** buckets;
+  size_t capacity;  // Number of buckets (power of two)
+  size_t size;      // Number of entries
+} JSRT_ResolverCacheTable;
+
+/**
+ * Module resolver state attached to a JSRT_ModuleLoader
+ */
+struct JSRT_ModuleResolver {
+  JSContext* ctx;
+
+  JSRT_ResolverCacheTable stats;     // path -> JSRT_ResolverStatType
+  JSRT_ResolverCacheTable packages;  // directory -> JSRT_PackageJson* (NULL if none)
+  JSRT_ResolverCacheTable resolved;  // memo key -> resolved path
+
+  // Statistics
+  uint64_t stat_hits;
+  uint64_t stat_misses;
+  uint64_t package_hits;
+  uint64_t package_misses;
+  uint64_t resolve_hits;
+  uint64_t resolve_misses;
+};
+
+/**
+ * Create a resolver cache
+ * @param ctx JavaScript context (owner of cached package.json values)
+ * @return New resolver, or NULL on allocation failure
+ */
+JSRT_ModuleResolver* jsrt_module_resolver_create(JSContext* ctx);
+
+/**
+ * Free a resolver cache and all entries
+ * @param resolver Resolver to free (can be NULL)
+ */
+void jsrt_module_resolver_free(JSRT_ModuleResolver* resolver);
+
+/**
+ * Get the resolver of the runtime that owns ctx
+ * @return Resolver, or NULL if ctx has no module loader (caching is then skipped)
+ */
+JSRT_ModuleResolver* jsrt_module_resolver_get(JSContext* ctx);
+
+/**
+ * stat() a path through the resolver's stat cache
+ * @param ctx JavaScript context (can be NULL for an uncached stat)
+ * @param path Path to check
+ * @return Type of the path, JSRT_RESOLVER_STAT_MISSING if it doesn't exist
+ */
+JSRT_ResolverStatType jsrt_resolver_stat(JSContext* ctx, const char* path);
+
+/**
+ * Look up a parsed package.json by directory
+ * @param resolver The resolver
+ * @param dir_path Directory containing package.json
+ * @param pkg Output: new reference to the cached package.json (NULL if the directory has none)
+ * @return true if the directory is cached
+ */
+bool jsrt_module_resolver_get_package(JSRT_ModuleResolver* resolver, const char* dir_path, JSRT_PackageJson** pkg);
+
+/**
+ * Cache a parsed package.json (or its absence) for a directory
+ * @param resolver The resolver
+ * @param dir_path Directory containing package.json
+ * @param pkg Parsed package.json, or NULL; the cache takes its own reference
+ */
+void jsrt_module_resolver_put_package(JSRT_ModuleResolver* resolver, const char* dir_path, JSRT_PackageJson* pkg);
+
+/**
+ * Look up a memoized resolution
+ * @param resolver The resolver
+ * @param specifier Module specifier
+ * @param base_path Requesting module's path
+ * @param is_esm Whether resolving for ESM
+ * @param type Output: specifier type of the memoized resolution
+ * @return Resolved path (caller must free), or NULL if not memoized
+ */
+char* jsrt_module_resolver_get_resolved(JSRT_ModuleResolver* resolver, const char* specifier, const char* base_path,
+                                        bool is_esm, JSRT_SpecifierType* type);
+
+/**
+ * Memoize a resolution that ended at an existing file
+ * @param resolver The resolver
+ * @param specifier Module specifier
+ * @param base_path Requesting module's path
+ * @param is_esm Whether resolving for ESM
+ * @param type Specifier type
+ * @param resolved_path Resolved file path
+ */
+void jsrt_module_resolver_put_resolved(JSRT_ModuleResolver* resolver, const char* specifier, const char* base_path,
+                                       bool is_esm, JSRT_SpecifierType type, const char* resolved_path);
+
+/**
+ * Drop everything cached about a path: its stat result, the package.json of
+ * the directory (if path is one, or is a package.json) and memoized
+ * resolutions that lead to it
+ * @param resolver The resolver
+ * @param path File or directory path
+ */
+void jsrt_module_resolver_invalidate(JSRT_ModuleResolver* resolver, const char* path);
+
+/**
+ * Drop negative stat and package.json results, so paths that were missing
+ * are looked up again (called when a resolution fails)
+ * @param resolver The resolver
+ */
+void jsrt_module_resolver_forget_missing(JSRT_ModuleResolver* resolver);
+
+/**
+ * Drop all cached entries
+ * @param resolver The resolver
+ */
+void jsrt_module_resolver_clear(JSRT_ModuleResolver* resolver);
+
+/**
+ * Reset resolver statistics
+ * @param resolver The resolver
+ */
+void jsrt_module_resolver_reset_stats(JSRT_ModuleResolver* resolver);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // JSRT_MODULE_RESOLVER_CACHE_H
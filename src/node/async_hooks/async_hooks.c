@@ -10,9 +10,10 @@
 #include <string.h>
 #include "../../runtime.h"
 #include "../../util/debug.h"
+#include "../../util/macro.h"
 
 // Global async ID counter
-static async_id_t next_async_id = 1;
+static JSRT_THREAD_LOCAL async_id_t next_async_id = 1;
 
 // Forward declarations for AsyncLocalStorage methods
 static JSValue js_async_local_storage_run(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv);
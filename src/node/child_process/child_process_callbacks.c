@@ -162,12 +162,12 @@ void on_process_exit(uv_process_t* handle, int64_t exit_status, int term_signal)
 
 // Stdout allocation callback
 void on_stdout_alloc(uv_handle_t* handle, size_t suggested_size, uv_buf_t* buf) {
-  buf->base = malloc(suggested_size);
-  buf->len = suggested_size;
+  JSRT_ReadSlabAlloc(handle, suggested_size, buf);
 }
 
 // Stdout read callback
 void on_stdout_read(uv_stream_t* stream, ssize_t nread, const uv_buf_t* buf) {
+  bool read_buffer_owned = true;  // Cleared once the slab slice is handed to a JS Buffer
   uv_pipe_t* pipe = (uv_pipe_t*)stream;
   JSChildProcess* child = (JSChildProcess*)pipe->data;
 
@@ -232,54 +232,40 @@ void on_stdout_read(uv_stream_t* stream, ssize_t nread, const uv_buf_t* buf) {
     memcpy(child->stdout_buffer + child->stdout_size, buf->base, nread);
     child->stdout_size += nread;
   } else {
-    // Normal mode: emit 'data' event
-    JSValue buffer_module = JSRT_LoadNodeModuleCommonJS(ctx, "buffer");
-    if (!JS_IsException(buffer_module)) {
-      JSValue buffer_class = JS_GetPropertyStr(ctx, buffer_module, "Buffer");
-      if (!JS_IsException(buffer_class)) {
-        JSValue from_func = JS_GetPropertyStr(ctx, buffer_class, "from");
-        if (JS_IsFunction(ctx, from_func)) {
-          // Create ArrayBuffer copy from received data
-          JSValue array_buffer = JS_NewArrayBufferCopy(ctx, (const uint8_t*)buf->base, nread);
-
-          // Convert to Buffer
-          JSValue argv_buf[] = {array_buffer};
-          JSValue data_buffer = JS_Call(ctx, from_func, buffer_class, 1, argv_buf);
-
-          // Emit 'data' event on stdout stream
-          if (!JS_IsUndefined(child->stdout_stream)) {
-            JSValue data_argv[] = {data_buffer};
-            emit_event(ctx, child->stdout_stream, "data", 1, data_argv);
-            JS_FreeValue(ctx, data_argv[0]);
-          }
-
-          JS_FreeValue(ctx, array_buffer);
-        }
-        JS_FreeValue(ctx, from_func);
-      }
-      JS_FreeValue(ctx, buffer_class);
-      JS_FreeValue(ctx, buffer_module);
+    // Normal mode: emit 'data' with a Buffer view over the read slab
+    JSValue array_buffer = JSRT_ReadSlabTake((uv_handle_t*)stream, buf, nread);
+    read_buffer_owned = false;
+    JSValue data_buffer = jsrt_node_buffer_view(ctx, array_buffer, 0, nread);
+    JS_FreeValue(ctx, array_buffer);
+
+    // Emit 'data' event on stdout stream
+    if (JS_IsException(data_buffer)) {
+      JS_FreeValue(ctx, JS_GetException(ctx));
+    } else if (!JS_IsUndefined(child->stdout_stream)) {
+      JSValue data_argv[] = {data_buffer};
+      emit_event(ctx, child->stdout_stream, "data", 1, data_argv);
     }
+    JS_FreeValue(ctx, data_buffer);
   }
 
   // Clear callback flag
   child->in_callback = false;
 
 cleanup:
-  // Always free the buffer
-  if (buf && buf->base) {
-    free(buf->base);
+  // Return the slab slice unless a Buffer took it over
+  if (read_buffer_owned) {
+    JSRT_ReadSlabRelease((uv_handle_t*)stream, buf, 0);
   }
 }
 
 // Stderr allocation callback
 void on_stderr_alloc(uv_handle_t* handle, size_t suggested_size, uv_buf_t* buf) {
-  buf->base = malloc(suggested_size);
-  buf->len = suggested_size;
+  JSRT_ReadSlabAlloc(handle, suggested_size, buf);
 }
 
 // Stderr read callback
 void on_stderr_read(uv_stream_t* stream, ssize_t nread, const uv_buf_t* buf) {
+  bool read_buffer_owned = true;  // Cleared once the slab slice is handed to a JS Buffer
   uv_pipe_t* pipe = (uv_pipe_t*)stream;
   JSChildProcess* child = (JSChildProcess*)pipe->data;
 
@@ -344,43 +330,29 @@ void on_stderr_read(uv_stream_t* stream, ssize_t nread, const uv_buf_t* buf) {
     memcpy(child->stderr_buffer + child->stderr_size, buf->base, nread);
     child->stderr_size += nread;
   } else {
-    // Normal mode: emit 'data' event
-    JSValue buffer_module = JSRT_LoadNodeModuleCommonJS(ctx, "buffer");
-    if (!JS_IsException(buffer_module)) {
-      JSValue buffer_class = JS_GetPropertyStr(ctx, buffer_module, "Buffer");
-      if (!JS_IsException(buffer_class)) {
-        JSValue from_func = JS_GetPropertyStr(ctx, buffer_class, "from");
-        if (JS_IsFunction(ctx, from_func)) {
-          // Create ArrayBuffer copy from received data
-          JSValue array_buffer = JS_NewArrayBufferCopy(ctx, (const uint8_t*)buf->base, nread);
-
-          // Convert to Buffer
-          JSValue argv_buf[] = {array_buffer};
-          JSValue data_buffer = JS_Call(ctx, from_func, buffer_class, 1, argv_buf);
-
-          // Emit 'data' event on stderr stream
-          if (!JS_IsUndefined(child->stderr_stream)) {
-            JSValue data_argv[] = {data_buffer};
-            emit_event(ctx, child->stderr_stream, "data", 1, data_argv);
-            JS_FreeValue(ctx, data_argv[0]);
-          }
-
-          JS_FreeValue(ctx, array_buffer);
-        }
-        JS_FreeValue(ctx, from_func);
-      }
-      JS_FreeValue(ctx, buffer_class);
-      JS_FreeValue(ctx, buffer_module);
+    // Normal mode: emit 'data' with a Buffer view over the read slab
+    JSValue array_buffer = JSRT_ReadSlabTake((uv_handle_t*)stream, buf, nread);
+    read_buffer_owned = false;
+    JSValue data_buffer = jsrt_node_buffer_view(ctx, array_buffer, 0, nread);
+    JS_FreeValue(ctx, array_buffer);
+
+    // Emit 'data' event on stderr stream
+    if (JS_IsException(data_buffer)) {
+      JS_FreeValue(ctx, JS_GetException(ctx));
+    } else if (!JS_IsUndefined(child->stderr_stream)) {
+      JSValue data_argv[] = {data_buffer};
+      emit_event(ctx, child->stderr_stream, "data", 1, data_argv);
     }
+    JS_FreeValue(ctx, data_buffer);
   }
 
   // Clear callback flag
   child->in_callback = false;
 
 cleanup:
-  // Always free the buffer
-  if (buf && buf->base) {
-    free(buf->base);
+  // Return the slab slice unless a Buffer took it over
+  if (read_buffer_owned) {
+    JSRT_ReadSlabRelease((uv_handle_t*)stream, buf, 0);
   }
 }
 
@@ -21,7 +21,9 @@ JSValue js_child_process_send(JSContext* ctx, JSValueConst this_val, int argc, J
   }
 
   JSValue message = argv[0];
+  JSValue send_handle = JS_UNDEFINED;
   JSValue callback = JS_UNDEFINED;
+  bool keep_open = false;
 
   // Extract callback from various positions:
   // send(message, callback)
@@ -30,15 +32,20 @@ JSValue js_child_process_send(JSContext* ctx, JSValueConst this_val, int argc, J
   if (argc >= 2 && JS_IsFunction(ctx, argv[argc - 1])) {
     callback = argv[argc - 1];
   }
+  if (argc >= 2 && !JS_IsFunction(ctx, argv[1])) {
+    send_handle = argv[1];
+  }
+  if (argc >= 3 && JS_IsObject(argv[2]) && !JS_IsFunction(ctx, argv[2])) {
+    JSValue keep_open_val = JS_GetPropertyStr(ctx, argv[2], "keepOpen");
+    keep_open = JS_ToBool(ctx, keep_open_val);
+    JS_FreeValue(ctx, keep_open_val);
+  }
 
-  // TODO: sendHandle support (file descriptors, sockets) - Phase 7
-  // For now, we only support JSON-serializable messages
-
-  // Send the message
-  int result = send_ipc_message(child->ipc_channel, message, callback);
+  // Send the message; only TCP servers and sockets can go along as handles
+  int result = send_ipc_message(child->ipc_channel, message, send_handle, keep_open, callback);
 
   if (result < 0) {
-    return JS_FALSE;
+    return JS_EXCEPTION;
   }
 
   return JS_TRUE;
@@ -128,6 +135,42 @@ JSValue js_child_process_fork(JSContext* ctx, JSValueConst this_val, int argc, J
     // execArgv - Node.js V8 flags, ignore for jsrt
   }
 
+  // serialization: 'json' (default) or 'advanced'; the child picks it up from its environment
+  JSValue serialization_val = JS_IsUndefined(options_val) ? JS_UNDEFINED
+                                                          : JS_GetPropertyStr(ctx, options_val, "serialization");
+  int serialization = jsrt_ipc_serialization(ctx, serialization_val);
+  JS_FreeValue(ctx, serialization_val);
+  if (serialization < 0) {
+    JS_FreeValue(ctx, fork_options);
+    JS_FreeCString(ctx, module_path);
+    return JS_EXCEPTION;
+  }
+  if (serialization == JSRT_IPC_SERIALIZATION_ADVANCED) {
+    JSValue global = JS_GetGlobalObject(ctx);
+    JSValue base_env = JS_GetPropertyStr(ctx, fork_options, "env");
+    if (JS_IsUndefined(base_env)) {
+      JSValue process = JS_GetPropertyStr(ctx, global, "process");
+      base_env = JS_GetPropertyStr(ctx, process, "env");
+      JS_FreeValue(ctx, process);
+    }
+    JSValue object_ctor = JS_GetPropertyStr(ctx, global, "Object");
+    JSValue assign = JS_GetPropertyStr(ctx, object_ctor, "assign");
+    JSValue assign_args[2] = {JS_NewObject(ctx), base_env};
+    JSValue env = JS_Call(ctx, assign, object_ctor, 2, assign_args);
+    JS_FreeValue(ctx, assign_args[0]);
+    JS_FreeValue(ctx, base_env);
+    JS_FreeValue(ctx, assign);
+    JS_FreeValue(ctx, object_ctor);
+    JS_FreeValue(ctx, global);
+    if (JS_IsException(env)) {
+      JS_FreeValue(ctx, fork_options);
+      JS_FreeCString(ctx, module_path);
+      return JS_EXCEPTION;
+    }
+    JS_SetPropertyStr(ctx, env, "NODE_CHANNEL_SERIALIZATION_MODE", JS_NewString(ctx, "advanced"));
+    JS_SetPropertyStr(ctx, fork_options, "env", env);
+  }
+
   // Configure stdio for IPC
   // stdio: ['pipe', 'pipe', 'pipe', 'ipc'] or ['inherit', 'inherit', 'inherit', 'ipc'] if silent
   JSValue silent_val = JS_GetPropertyStr(ctx, fork_options, "silent");
@@ -194,6 +237,7 @@ JSValue js_child_process_fork(JSContext* ctx, JSValueConst this_val, int argc, J
   // Just verify it exists
   if (child_data->ipc_channel) {
     child_data->connected = true;
+    child_data->ipc_channel->serialization = serialization;
 
     // Set connected property
     JS_SetPropertyStr(ctx, child, "connected", JS_TRUE);
@@ -6,6 +6,7 @@
 #include <string.h>
 #include <uv.h>
 #include "../../runtime.h"
+#include "../../util/read_slab.h"
 #include "../node_modules.h"
 
 // Type tag for cleanup callback identification
@@ -109,9 +110,15 @@ struct JSSendRequest {
 
 // IPC Queue Entry (for message backpressure)
 struct IPCQueueEntry {
+  uv_write_t req;  // In flight once the entry leaves the queue
+  uv_buf_t buf;
   char* data;
   size_t length;
   JSValue callback;
+  JSValue send_handle;       // net.Server or net.Socket passed along, kept alive until written
+  uv_stream_t* handle;       // Its TCP handle, for uv_write2()
+  bool keep_open;            // Leave a sent net.Socket open (options.keepOpen)
+  IPCChannelState* channel;  // Channel the entry is written on
   IPCQueueEntry* next;
 };
 
@@ -121,13 +128,10 @@ struct IPCChannelState {
   JSChildProcess* child;
   bool reading;
   bool connected;
+  JSRT_IPCSerialization serialization;  // fork() option, agreed with the child through its environment
 
   // Read state (for partial messages)
-  char* read_buffer;
-  size_t read_buffer_size;
-  size_t read_buffer_capacity;
-  uint32_t expected_length;
-  bool reading_header;
+  JSRT_IPCReadBuffer read_buffer;
 
   // Write queue (for backpressure)
   IPCQueueEntry* queue_head;
@@ -177,7 +181,7 @@ JSValue create_stderr_stream(JSContext* ctx, uv_pipe_t* pipe);
 // ===== IPC Functions (child_process_ipc.c) =====
 IPCChannelState* create_ipc_channel(JSContext* ctx, JSChildProcess* child, uv_loop_t* loop);
 int start_ipc_reading(IPCChannelState* state);
-int send_ipc_message(IPCChannelState* state, JSValue message, JSValue callback);
+int send_ipc_message(IPCChannelState* state, JSValue message, JSValue send_handle, bool keep_open, JSValue callback);
 void disconnect_ipc_channel(IPCChannelState* state);
 
 // ===== Callbacks (child_process_callbacks.c) =====
@@ -6,14 +6,20 @@
 extern void js_std_dump_error(JSContext* ctx);
 
 // IPC message format:
-// [4 bytes: message length (uint32_t, little-endian)]
-// [N bytes: JSON-serialized message body]
+// [4 bytes: header (uint32_t, little-endian)]
+//   bits 0-29: message length
+//   bit 30: a listening net.Server handle was sent with the message (uv_write2)
+//   bit 31: a connected net.Socket handle was sent with the message
+// [N bytes: message body, JSON text or V8 serializer output (serialization: 'advanced')]
+#define IPC_HEADER_SIZE 4
+#define IPC_LENGTH_MASK 0x3fffffffu
+#define IPC_HANDLE_SERVER 0x40000000u
+#define IPC_HANDLE_SOCKET 0x80000000u
 
 // Forward declarations
 static void on_ipc_read(uv_stream_t* stream, ssize_t nread, const uv_buf_t* buf);
 static void on_ipc_write(uv_write_t* req, int status);
 static void on_ipc_close(uv_handle_t* handle);
-static void process_ipc_message(IPCChannelState* state, const char* data, size_t length);
 static void flush_ipc_queue(IPCChannelState* state);
 
 // Allocation callback for libuv
@@ -22,6 +28,163 @@ static void alloc_buffer(uv_handle_t* handle, size_t suggested_size, uv_buf_t* b
   buf->len = suggested_size;
 }
 
+// ===== Message encoding, shared with process.send() in the child =====
+
+int jsrt_ipc_serialization(JSContext* ctx, JSValueConst val) {
+  if (JS_IsUndefined(val)) {
+    return JSRT_IPC_SERIALIZATION_JSON;
+  }
+  const char* name = JS_ToCString(ctx, val);
+  if (!name) {
+    return -1;
+  }
+  int serialization = -1;
+  if (strcmp(name, "json") == 0) {
+    serialization = JSRT_IPC_SERIALIZATION_JSON;
+  } else if (strcmp(name, "advanced") == 0) {
+    serialization = JSRT_IPC_SERIALIZATION_ADVANCED;
+  } else {
+    JS_ThrowTypeError(ctx, "The property 'options.serialization' must be one of: 'json', 'advanced'. Received '%s'",
+                      name);
+  }
+  JS_FreeCString(ctx, name);
+  return serialization;
+}
+
+char* jsrt_ipc_encode(JSContext* ctx, JSValueConst message, JSValueConst send_handle,
+                      JSRT_IPCSerialization serialization, size_t* length, uv_stream_t** handle) {
+  uint32_t flags = 0;
+  *handle = NULL;
+  if (!JS_IsUndefined(send_handle) && !JS_IsNull(send_handle)) {
+    bool is_server = false;
+    *handle = jsrt_net_get_handle(ctx, send_handle, &is_server);
+    if (!*handle) {
+      JS_ThrowTypeError(ctx, "This handle type cannot be sent");
+      return NULL;
+    }
+    flags = is_server ? IPC_HANDLE_SERVER : IPC_HANDLE_SOCKET;
+  }
+
+  const char* body;
+  size_t body_length;
+  uint8_t* serialized = NULL;
+  JSValue json_str = JS_UNDEFINED;
+  if (serialization == JSRT_IPC_SERIALIZATION_ADVANCED) {
+    serialized = jsrt_v8_serialize(ctx, message, &body_length);
+    body = (const char*)serialized;
+  } else {
+    json_str = JS_JSONStringify(ctx, message, JS_UNDEFINED, JS_UNDEFINED);
+    body = JS_IsException(json_str) ? NULL : JS_ToCStringLen(ctx, &body_length, json_str);
+  }
+  if (!body) {
+    JS_FreeValue(ctx, json_str);
+    return NULL;
+  }
+
+  char* frame = NULL;
+  if (body_length > IPC_LENGTH_MASK) {
+    JS_ThrowRangeError(ctx, "IPC message is too large");
+  } else if ((frame = malloc(IPC_HEADER_SIZE + body_length))) {
+    uint32_t header = (uint32_t)body_length | flags;
+    memcpy(frame, &header, IPC_HEADER_SIZE);
+    memcpy(frame + IPC_HEADER_SIZE, body, body_length);
+    *length = IPC_HEADER_SIZE + body_length;
+  } else {
+    JS_ThrowOutOfMemory(ctx);
+  }
+
+  if (serialized) {
+    js_free(ctx, serialized);
+  } else {
+    JS_FreeCString(ctx, body);
+  }
+  JS_FreeValue(ctx, json_str);
+  return frame;
+}
+
+// Message body from a frame; the byte after it must be writable (it is borrowed as the NUL JS_ParseJSON needs)
+static JSValue decode_ipc_message(JSContext* ctx, char* data, size_t length, JSRT_IPCSerialization serialization) {
+  if (serialization == JSRT_IPC_SERIALIZATION_ADVANCED) {
+    return jsrt_v8_deserialize(ctx, (const uint8_t*)data, length);
+  }
+  char saved = data[length];
+  data[length] = '\0';
+  JSValue message = JS_ParseJSON(ctx, data, length, "<ipc>");
+  data[length] = saved;
+  return message;
+}
+
+void jsrt_ipc_read(JSContext* ctx, JSRT_IPCReadBuffer* buffer, uv_stream_t* pipe, JSRT_IPCSerialization serialization,
+                   const char* data, size_t len, JSRT_IPCMessageFunc on_message, void* opaque) {
+  // One spare byte past the data, for decode_ipc_message()
+  size_t needed = buffer->size + len + 1;
+  if (needed > buffer->capacity) {
+    size_t new_capacity = buffer->capacity ? buffer->capacity * 2 : 8192;
+    while (new_capacity < needed) {
+      new_capacity *= 2;
+    }
+    char* new_data = realloc(buffer->data, new_capacity);
+    if (!new_data) {
+      JSRT_Debug("Failed to grow IPC read buffer");
+      return;
+    }
+    buffer->data = new_data;
+    buffer->capacity = new_capacity;
+  }
+  memcpy(buffer->data + buffer->size, data, len);
+  buffer->size += len;
+
+  // Hand over every complete message, then move what is left to the front once
+  size_t offset = 0;
+  bool keep_reading = true;
+  while (keep_reading && buffer->size - offset >= IPC_HEADER_SIZE) {
+    uint32_t header;
+    memcpy(&header, buffer->data + offset, IPC_HEADER_SIZE);
+    size_t length = header & IPC_LENGTH_MASK;
+    if (buffer->size - offset - IPC_HEADER_SIZE < length) {
+      break;
+    }
+    char* body = buffer->data + offset + IPC_HEADER_SIZE;
+    offset += IPC_HEADER_SIZE + length;
+
+    // A sent handle is queued on the pipe by the time the bytes it came with are read
+    JSValue handle = JS_UNDEFINED;
+    if ((header & (IPC_HANDLE_SERVER | IPC_HANDLE_SOCKET)) && uv_pipe_pending_count((uv_pipe_t*)pipe) > 0 &&
+        uv_pipe_pending_type((uv_pipe_t*)pipe) == UV_TCP) {
+      handle = jsrt_net_accept_handle(ctx, pipe, header & IPC_HANDLE_SERVER);
+      if (JS_IsException(handle)) {
+        JSRT_Debug("Failed to accept IPC handle");
+        js_std_dump_error(ctx);
+        handle = JS_UNDEFINED;
+      }
+    }
+
+    JSValue message = decode_ipc_message(ctx, body, length, serialization);
+    if (JS_IsException(message)) {
+      JSRT_Debug("Failed to decode IPC message: length=%zu", length);
+      js_std_dump_error(ctx);
+    } else {
+      keep_reading = on_message(opaque, message, handle);
+    }
+    JS_FreeValue(ctx, message);
+    JS_FreeValue(ctx, handle);
+  }
+
+  if (offset > 0) {
+    memmove(buffer->data, buffer->data + offset, buffer->size - offset);
+    buffer->size -= offset;
+  }
+}
+
+void jsrt_ipc_read_buffer_free(JSRT_IPCReadBuffer* buffer) {
+  free(buffer->data);
+  buffer->data = NULL;
+  buffer->size = 0;
+  buffer->capacity = 0;
+}
+
+// ===== Parent side of the channel =====
+
 // Create IPC channel
 IPCChannelState* create_ipc_channel(JSContext* ctx, JSChildProcess* child, uv_loop_t* loop) {
   IPCChannelState* state = js_mallocz(ctx, sizeof(IPCChannelState));
@@ -46,13 +209,7 @@ IPCChannelState* create_ipc_channel(JSContext* ctx, JSChildProcess* child, uv_lo
   state->pipe->data = state;
   state->child = child;
   state->connected = true;
-  state->reading_header = true;
-  state->expected_length = 0;
-
-  // Allocate initial read buffer
-  state->read_buffer_capacity = 8192;
-  state->read_buffer = malloc(state->read_buffer_capacity);
-  state->read_buffer_size = 0;
+  state->serialization = JSRT_IPC_SERIALIZATION_JSON;
 
   return state;
 }
@@ -76,6 +233,17 @@ int start_ipc_reading(IPCChannelState* state) {
   return result;
 }
 
+// Emit 'message' (message, handle) on the ChildProcess
+static bool on_ipc_message(void* opaque, JSValueConst message, JSValueConst handle) {
+  IPCChannelState* state = opaque;
+  JSValue event_args[] = {JS_DupValue(state->child->ctx, message), JS_DupValue(state->child->ctx, handle)};
+  emit_event(state->child->ctx, state->child->child_obj, "message", JS_IsUndefined(handle) ? 1 : 2, event_args);
+  JS_FreeValue(state->child->ctx, event_args[0]);
+  JS_FreeValue(state->child->ctx, event_args[1]);
+  // Stop at a disconnect() made by the listener
+  return state->connected;
+}
+
 // IPC read callback
 static void on_ipc_read(uv_stream_t* stream, ssize_t nread, const uv_buf_t* buf) {
   IPCChannelState* state = (IPCChannelState*)stream->data;
@@ -120,149 +288,56 @@ static void on_ipc_read(uv_stream_t* stream, ssize_t nread, const uv_buf_t* buf)
     return;
   }
 
-  // Append to read buffer
-  size_t needed = state->read_buffer_size + nread;
-  if (needed > state->read_buffer_capacity) {
-    // Grow buffer
-    size_t new_capacity = state->read_buffer_capacity * 2;
-    while (new_capacity < needed) {
-      new_capacity *= 2;
-    }
-    char* new_buffer = realloc(state->read_buffer, new_capacity);
-    if (!new_buffer) {
-      free(buf->base);
-      return;
-    }
-    state->read_buffer = new_buffer;
-    state->read_buffer_capacity = new_capacity;
-  }
-
-  memcpy(state->read_buffer + state->read_buffer_size, buf->base, nread);
-  state->read_buffer_size += nread;
+  jsrt_ipc_read(state->child->ctx, &state->read_buffer, stream, state->serialization, buf->base, nread, on_ipc_message,
+                state);
   free(buf->base);
-
-  // Process complete messages
-  while (state->read_buffer_size > 0) {
-    if (state->reading_header) {
-      // Need at least 4 bytes for length header
-      if (state->read_buffer_size < 4) {
-        break;
-      }
-
-      // Read length (little-endian uint32_t)
-      uint32_t length;
-      memcpy(&length, state->read_buffer, 4);
-
-      state->expected_length = length;
-      state->reading_header = false;
-
-      // Remove header from buffer
-      memmove(state->read_buffer, state->read_buffer + 4, state->read_buffer_size - 4);
-      state->read_buffer_size -= 4;
-    } else {
-      // Reading message body
-      if (state->read_buffer_size < state->expected_length) {
-        // Not enough data yet
-        break;
-      }
-
-      // We have a complete message
-      process_ipc_message(state, state->read_buffer, state->expected_length);
-
-      // Remove message from buffer
-      size_t remaining = state->read_buffer_size - state->expected_length;
-      if (remaining > 0) {
-        memmove(state->read_buffer, state->read_buffer + state->expected_length, remaining);
-      }
-      state->read_buffer_size = remaining;
-      state->reading_header = true;
-      state->expected_length = 0;
-    }
-  }
 }
 
-// Process a complete IPC message
-static void process_ipc_message(IPCChannelState* state, const char* data, size_t length) {
-  JSContext* ctx = state->child->ctx;
-
-  // Parse JSON message
-  // JS_ParseJSON requires null-terminated string, so create one
-  char* null_terminated = malloc(length + 1);
-  if (!null_terminated) {
-    JSRT_Debug("Failed to allocate memory for IPC message");
-    return;
-  }
-  memcpy(null_terminated, data, length);
-  null_terminated[length] = '\0';
-
-  JSRT_Debug("Parsing IPC message: length=%zu, data='%s'", length, null_terminated);
-  JSValue message = JS_ParseJSON(ctx, null_terminated, length, "<ipc>");
-  free(null_terminated);
-
-  if (JS_IsException(message)) {
-    JSRT_Debug("Failed to parse IPC message");
-    js_std_dump_error(ctx);
-    JS_FreeValue(ctx, message);
-    return;
-  }
-
-  // Emit 'message' event
-  JSValue event_args[] = {message};
-  emit_event(ctx, state->child->child_obj, "message", 1, event_args);
-
-  JS_FreeValue(ctx, message);
+JSValue jsrt_ipc_write_error(JSContext* ctx, int status) {
+  return create_spawn_error(ctx, status, NULL, "write");
 }
 
-// Serialize JSValue to JSON
-static char* serialize_message(JSContext* ctx, JSValue message, size_t* out_length) {
-  // Convert to JSON string
-  JSValue json_str = JS_JSONStringify(ctx, message, JS_UNDEFINED, JS_UNDEFINED);
-  if (JS_IsException(json_str)) {
-    return NULL;
-  }
-
-  size_t length;
-  const char* str = JS_ToCStringLen(ctx, &length, json_str);
-  JS_FreeValue(ctx, json_str);
-
-  if (!str) {
-    return NULL;
-  }
-
-  // Duplicate string (JS_FreeCString will be called on str)
-  char* result = malloc(length);
-  if (!result) {
-    JS_FreeCString(ctx, str);
-    return NULL;
-  }
-
-  memcpy(result, str, length);
-  *out_length = length;
-
-  JS_FreeCString(ctx, str);
-  return result;
+static void free_ipc_queue_entry(JSContext* ctx, IPCQueueEntry* entry) {
+  free(entry->data);
+  JS_FreeValue(ctx, entry->callback);
+  JS_FreeValue(ctx, entry->send_handle);
+  free(entry);
 }
 
-// Write callback
+// Write callback: the message (and any handle) has been handed to the kernel
 static void on_ipc_write(uv_write_t* req, int status) {
-  IPCChannelState* state = (IPCChannelState*)req->data;
+  IPCQueueEntry* entry = (IPCQueueEntry*)req->data;
+  IPCChannelState* state = entry->channel;
 
-  // Free write request and buffer
-  uv_buf_t* buf = (uv_buf_t*)(req + 1);
-  free(buf->base);
-  free(req);
-
-  if (!state) {
-    return;
+  if (status < 0) {
+    JSRT_Debug("IPC write error: %s", uv_strerror(status));
   }
 
+  // uv_close() cancels writes in flight before on_ipc_close() runs, so the channel is still alive here
+  JSContext* ctx = state->child->ctx;
   state->writing = false;
 
-  if (status < 0) {
-    JSRT_Debug("IPC write error: %s", uv_strerror(status));
-    return;
+  // A sent socket now belongs to the receiver, as in Node.js
+  if (status == 0 && entry->handle && !entry->keep_open && entry->handle->type == UV_TCP) {
+    bool is_server = false;
+    if (jsrt_net_get_handle(ctx, entry->send_handle, &is_server) && !is_server) {
+      JSValue destroy = JS_GetPropertyStr(ctx, entry->send_handle, "destroy");
+      JSValue result = JS_Call(ctx, destroy, entry->send_handle, 0, NULL);
+      JS_FreeValue(ctx, result);
+      JS_FreeValue(ctx, destroy);
+    }
+  }
+
+  // Call callback if provided
+  if (!JS_IsUndefined(entry->callback)) {
+    JSValue result_val = status == 0 ? JS_UNDEFINED : jsrt_ipc_write_error(ctx, status);
+    JSValue cb_result = JS_Call(ctx, entry->callback, JS_UNDEFINED, 1, &result_val);
+    JS_FreeValue(ctx, cb_result);
+    JS_FreeValue(ctx, result_val);
   }
 
+  free_ipc_queue_entry(ctx, entry);
+
   // Flush queue if there are pending messages
   flush_ipc_queue(state);
 }
@@ -280,76 +355,61 @@ static void flush_ipc_queue(IPCChannelState* state) {
     state->queue_tail = NULL;
   }
 
-  // Allocate write request with buffer embedded
-  uv_write_t* req = malloc(sizeof(uv_write_t) + sizeof(uv_buf_t));
-  uv_buf_t* buf = (uv_buf_t*)(req + 1);
-
-  buf->base = entry->data;
-  buf->len = entry->length;
-  req->data = state;
-
+  entry->buf = uv_buf_init(entry->data, (unsigned int)entry->length);
+  entry->req.data = entry;
+  entry->channel = state;
   state->writing = true;
 
-  int result = uv_write(req, (uv_stream_t*)state->pipe, buf, 1, on_ipc_write);
+  int result;
+  if (entry->handle) {
+    result = uv_write2(&entry->req, (uv_stream_t*)state->pipe, &entry->buf, 1, entry->handle, on_ipc_write);
+  } else {
+    result = uv_write(&entry->req, (uv_stream_t*)state->pipe, &entry->buf, 1, on_ipc_write);
+  }
   if (result < 0) {
     JSRT_Debug("uv_write failed: %s", uv_strerror(result));
-    free(entry->data);
-    free(req);
     state->writing = false;
-  }
 
-  // Call callback if provided
-  if (!JS_IsUndefined(entry->callback)) {
     JSContext* ctx = state->child->ctx;
-    JSValue result_val = result == 0 ? JS_UNDEFINED : JS_NewInt32(ctx, result);
-    JSValue cb_result = JS_Call(ctx, entry->callback, JS_UNDEFINED, 1, &result_val);
-    JS_FreeValue(ctx, cb_result);
-    JS_FreeValue(ctx, result_val);
-    JS_FreeValue(ctx, entry->callback);
+    if (!JS_IsUndefined(entry->callback)) {
+      JSValue result_val = JS_NewInt32(ctx, result);
+      JSValue cb_result = JS_Call(ctx, entry->callback, JS_UNDEFINED, 1, &result_val);
+      JS_FreeValue(ctx, cb_result);
+    }
+    free_ipc_queue_entry(ctx, entry);
   }
-
-  free(entry);
 }
 
 // Send message on IPC channel
-int send_ipc_message(IPCChannelState* state, JSValue message, JSValue callback) {
+int send_ipc_message(IPCChannelState* state, JSValue message, JSValue send_handle, bool keep_open, JSValue callback) {
   if (!state || !state->connected) {
     return -1;
   }
 
   JSContext* ctx = state->child->ctx;
 
-  // Serialize message
-  size_t body_length;
-  char* body = serialize_message(ctx, message, &body_length);
-  if (!body) {
-    return -1;
-  }
-
-  // Build message with length header
-  size_t total_length = 4 + body_length;
-  char* full_message = malloc(total_length);
-  if (!full_message) {
-    free(body);
+  // Serialize message, with its length header
+  size_t length;
+  uv_stream_t* handle;
+  char* frame = jsrt_ipc_encode(ctx, message, send_handle, state->serialization, &length, &handle);
+  if (!frame) {
     return -1;
   }
 
-  // Write length header (little-endian)
-  uint32_t length_header = (uint32_t)body_length;
-  memcpy(full_message, &length_header, 4);
-  memcpy(full_message + 4, body, body_length);
-  free(body);
-
   // Queue message
-  IPCQueueEntry* entry = malloc(sizeof(IPCQueueEntry));
+  IPCQueueEntry* entry = calloc(1, sizeof(IPCQueueEntry));
   if (!entry) {
-    free(full_message);
+    free(frame);
+    JS_ThrowOutOfMemory(ctx);
     return -1;
   }
 
-  entry->data = full_message;
-  entry->length = total_length;
+  entry->data = frame;
+  entry->length = length;
   entry->callback = JS_DupValue(ctx, callback);
+  entry->send_handle = handle ? JS_DupValue(ctx, send_handle) : JS_UNDEFINED;
+  entry->handle = handle;
+  entry->keep_open = keep_open;
   entry->next = NULL;
 
   // Add to queue
@@ -377,20 +437,13 @@ static void on_ipc_close(uv_handle_t* handle) {
   JSChildProcess* child = state->child;
 
   // Free read buffer
-  if (state->read_buffer) {
-    free(state->read_buffer);
-    state->read_buffer = NULL;
-  }
+  jsrt_ipc_read_buffer_free(&state->read_buffer);
 
   // Free write queue
   while (state->queue_head) {
     IPCQueueEntry* entry = state->queue_head;
     state->queue_head = entry->next;
-    free(entry->data);
-    if (!JS_IsUndefined(entry->callback)) {
-      JS_FreeValue(ctx, entry->callback);
-    }
-    free(entry);
+    free_ipc_queue_entry(ctx, entry);
   }
 
   // Free pipe
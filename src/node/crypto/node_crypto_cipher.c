@@ -48,16 +48,7 @@ static JSValue js_node_cipher_update(JSContext* ctx, JSValueConst this_val, int
 
   // Get data buffer
   size_t data_len;
-  uint8_t* data = JS_GetArrayBuffer(ctx, &data_len, argv[0]);
-
-  if (!data) {
-    // Try to get as typed array
-    JSValue buffer = JS_GetPropertyStr(ctx, argv[0], "buffer");
-    if (!JS_IsUndefined(buffer)) {
-      data = JS_GetArrayBuffer(ctx, &data_len, buffer);
-      JS_FreeValue(ctx, buffer);
-    }
-  }
+  uint8_t* data = jsrt_node_buffer_source_bytes(ctx, argv[0], &data_len);
 
   if (!data) {
     return JS_ThrowTypeError(ctx, "data must be a Buffer or TypedArray");
@@ -281,16 +272,7 @@ static JSValue js_node_cipher_set_aad(JSContext* ctx, JSValueConst this_val, int
 
   // Get AAD buffer
   size_t aad_len;
-  uint8_t* aad = JS_GetArrayBuffer(ctx, &aad_len, argv[0]);
-
-  if (!aad) {
-    // Try to get as typed array
-    JSValue buffer = JS_GetPropertyStr(ctx, argv[0], "buffer");
-    if (!JS_IsUndefined(buffer)) {
-      aad = JS_GetArrayBuffer(ctx, &aad_len, buffer);
-      JS_FreeValue(ctx, buffer);
-    }
-  }
+  uint8_t* aad = jsrt_node_buffer_source_bytes(ctx, argv[0], &aad_len);
 
   if (!aad) {
     return JS_ThrowTypeError(ctx, "AAD must be a Buffer or TypedArray");
@@ -383,16 +365,7 @@ static JSValue js_node_cipher_set_auth_tag(JSContext* ctx, JSValueConst this_val
 
   // Get auth tag buffer
   size_t tag_len;
-  uint8_t* tag = JS_GetArrayBuffer(ctx, &tag_len, argv[0]);
-
-  if (!tag) {
-    // Try to get as typed array
-    JSValue buffer = JS_GetPropertyStr(ctx, argv[0], "buffer");
-    if (!JS_IsUndefined(buffer)) {
-      tag = JS_GetArrayBuffer(ctx, &tag_len, buffer);
-      JS_FreeValue(ctx, buffer);
-    }
-  }
+  uint8_t* tag = jsrt_node_buffer_source_bytes(ctx, argv[0], &tag_len);
 
   if (!tag) {
     return JS_ThrowTypeError(ctx, "Auth tag must be a Buffer or TypedArray");
@@ -483,14 +456,7 @@ JSValue js_crypto_create_cipheriv(JSContext* ctx, JSValueConst this_val, int arg
 
   // Get key
   size_t key_len;
-  uint8_t* key_data = JS_GetArrayBuffer(ctx, &key_len, argv[1]);
-  if (!key_data) {
-    JSValue buffer = JS_GetPropertyStr(ctx, argv[1], "buffer");
-    if (!JS_IsUndefined(buffer)) {
-      key_data = JS_GetArrayBuffer(ctx, &key_len, buffer);
-      JS_FreeValue(ctx, buffer);
-    }
-  }
+  uint8_t* key_data = jsrt_node_buffer_source_bytes(ctx, argv[1], &key_len);
 
   if (!key_data ||
       (key_len != JSRT_AES_128_KEY_SIZE && key_len != JSRT_AES_192_KEY_SIZE && key_len != JSRT_AES_256_KEY_SIZE)) {
@@ -499,14 +465,7 @@ JSValue js_crypto_create_cipheriv(JSContext* ctx, JSValueConst this_val, int arg
 
   // Get IV
   size_t iv_len;
-  uint8_t* iv_data = JS_GetArrayBuffer(ctx, &iv_len, argv[2]);
-  if (!iv_data) {
-    JSValue buffer = JS_GetPropertyStr(ctx, argv[2], "buffer");
-    if (!JS_IsUndefined(buffer)) {
-      iv_data = JS_GetArrayBuffer(ctx, &iv_len, buffer);
-      JS_FreeValue(ctx, buffer);
-    }
-  }
+  uint8_t* iv_data = jsrt_node_buffer_source_bytes(ctx, argv[2], &iv_len);
 
   if (!iv_data) {
     return JS_ThrowTypeError(ctx, "Invalid IV");
@@ -634,14 +593,7 @@ JSValue js_crypto_create_decipheriv(JSContext* ctx, JSValueConst this_val, int a
 
   // Get key
   size_t key_len;
-  uint8_t* key_data = JS_GetArrayBuffer(ctx, &key_len, argv[1]);
-  if (!key_data) {
-    JSValue buffer = JS_GetPropertyStr(ctx, argv[1], "buffer");
-    if (!JS_IsUndefined(buffer)) {
-      key_data = JS_GetArrayBuffer(ctx, &key_len, buffer);
-      JS_FreeValue(ctx, buffer);
-    }
-  }
+  uint8_t* key_data = jsrt_node_buffer_source_bytes(ctx, argv[1], &key_len);
 
   if (!key_data ||
       (key_len != JSRT_AES_128_KEY_SIZE && key_len != JSRT_AES_192_KEY_SIZE && key_len != JSRT_AES_256_KEY_SIZE)) {
@@ -650,14 +602,7 @@ JSValue js_crypto_create_decipheriv(JSContext* ctx, JSValueConst this_val, int a
 
   // Get IV
   size_t iv_len;
-  uint8_t* iv_data = JS_GetArrayBuffer(ctx, &iv_len, argv[2]);
-  if (!iv_data) {
-    JSValue buffer = JS_GetPropertyStr(ctx, argv[2], "buffer");
-    if (!JS_IsUndefined(buffer)) {
-      iv_data = JS_GetArrayBuffer(ctx, &iv_len, buffer);
-      JS_FreeValue(ctx, buffer);
-    }
-  }
+  uint8_t* iv_data = jsrt_node_buffer_source_bytes(ctx, argv[2], &iv_len);
 
   if (!iv_data) {
     return JS_ThrowTypeError(ctx, "Invalid IV");
@@ -99,10 +99,13 @@ static uint8_t* decode_input(JSContext* ctx, JSValue input, const char* encoding
         }
       }
     } else if (strcmp(encoding, "base64") == 0) {
-      // Simplified base64 decode (basic implementation)
-      // For production, use a proper base64 library
-      JS_FreeCString(ctx, str);
-      return NULL;  // Not implemented for brevity
+      // Same rules as Buffer.from(str, 'base64')
+      size_t str_len = strlen(str);
+      data_len = JSRT_Base64DecodedLength(str, str_len, JSRT_BASE64_STANDARD, JSRT_BASE64_LOOSE);
+      data = js_malloc(ctx, data_len ? data_len : 1);
+      if (data) {
+        JSRT_Base64Decode(str, str_len, data, &data_len, JSRT_BASE64_STANDARD, JSRT_BASE64_LOOSE);
+      }
     }
 
     JS_FreeCString(ctx, str);
@@ -39,16 +39,7 @@ static JSValue js_node_hash_update(JSContext* ctx, JSValueConst this_val, int ar
 
   // Get data buffer
   size_t data_len;
-  uint8_t* data = JS_GetArrayBuffer(ctx, &data_len, argv[0]);
-
-  if (!data) {
-    // Try to get as typed array
-    JSValue buffer = JS_GetPropertyStr(ctx, argv[0], "buffer");
-    if (!JS_IsUndefined(buffer)) {
-      data = JS_GetArrayBuffer(ctx, &data_len, buffer);
-      JS_FreeValue(ctx, buffer);
-    }
-  }
+  uint8_t* data = jsrt_node_buffer_source_bytes(ctx, argv[0], &data_len);
 
   if (!data) {
     return JS_ThrowTypeError(ctx, "data must be a Buffer or TypedArray");
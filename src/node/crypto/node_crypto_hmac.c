@@ -41,16 +41,7 @@ static JSValue js_node_hmac_update(JSContext* ctx, JSValueConst this_val, int ar
 
   // Get data buffer
   size_t data_len;
-  uint8_t* data = JS_GetArrayBuffer(ctx, &data_len, argv[0]);
-
-  if (!data) {
-    // Try to get as typed array
-    JSValue buffer = JS_GetPropertyStr(ctx, argv[0], "buffer");
-    if (!JS_IsUndefined(buffer)) {
-      data = JS_GetArrayBuffer(ctx, &data_len, buffer);
-      JS_FreeValue(ctx, buffer);
-    }
-  }
+  uint8_t* data = jsrt_node_buffer_source_bytes(ctx, argv[0], &data_len);
 
   if (!data) {
     return JS_ThrowTypeError(ctx, "data must be a Buffer or TypedArray");
@@ -201,16 +192,7 @@ JSValue js_crypto_create_hmac(JSContext* ctx, JSValueConst this_val, int argc, J
 
   // Get key data
   size_t key_len;
-  uint8_t* key_data = JS_GetArrayBuffer(ctx, &key_len, argv[1]);
-
-  if (!key_data) {
-    // Try to get as typed array
-    JSValue buffer = JS_GetPropertyStr(ctx, argv[1], "buffer");
-    if (!JS_IsUndefined(buffer)) {
-      key_data = JS_GetArrayBuffer(ctx, &key_len, buffer);
-      JS_FreeValue(ctx, buffer);
-    }
-  }
+  uint8_t* key_data = jsrt_node_buffer_source_bytes(ctx, argv[1], &key_len);
 
   if (!key_data) {
     return JS_ThrowTypeError(ctx, "key must be a Buffer or TypedArray");
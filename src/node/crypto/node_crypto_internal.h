@@ -13,7 +13,9 @@
 #include "../../crypto/crypto_rsa.h"
 #include "../../crypto/crypto_subtle.h"
 #include "../../crypto/crypto_symmetric.h"
+#include "../../util/base64.h"
 #include "../../util/debug.h"
+#include "../node_modules.h"
 
 // Forward declarations for class IDs
 extern JSClassID js_node_hash_class_id;
@@ -153,27 +155,12 @@ JSValue js_crypto_get_curves(JSContext* ctx, JSValueConst this_val, int argc, JS
 // Constants
 JSValue create_crypto_constants(JSContext* ctx);
 
-// Utility function: Simple base64 encoding from binary data
+// Utility function: base64 encoding from binary data (NUL-terminated, free() the result)
 static inline char* node_crypto_base64_encode(const uint8_t* data, size_t len) {
-  static const char base64_table[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
-  size_t output_len = 4 * ((len + 2) / 3);
-  char* output = malloc(output_len + 1);
+  char* output = malloc(JSRT_Base64EncodedLength(len, true) + 1);
   if (!output)
     return NULL;
-
-  size_t j = 0;
-  for (size_t i = 0; i < len; i += 3) {
-    uint32_t octet_a = i < len ? data[i] : 0;
-    uint32_t octet_b = i + 1 < len ? data[i + 1] : 0;
-    uint32_t octet_c = i + 2 < len ? data[i + 2] : 0;
-    uint32_t triple = (octet_a << 16) + (octet_b << 8) + octet_c;
-
-    output[j++] = base64_table[(triple >> 18) & 63];
-    output[j++] = base64_table[(triple >> 12) & 63];
-    output[j++] = i + 1 < len ? base64_table[(triple >> 6) & 63] : '=';
-    output[j++] = i + 2 < len ? base64_table[triple & 63] : '=';
-  }
-  output[output_len] = '\0';
+  output[JSRT_Base64Encode(data, len, output, JSRT_BASE64_STANDARD, true)] = '\0';
   return output;
 }
 
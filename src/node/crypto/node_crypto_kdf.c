@@ -2,8 +2,12 @@
 #include "node_crypto_internal.h"
 
 //==============================================================================
-// Key Derivation Functions (Node.js pbkdf2, hkdf)
+// Key Derivation Functions (Node.js pbkdf2, hkdf, scrypt)
 // Phase 6: KDF Implementation
+//
+// The *Sync variants derive on the calling thread. The callback variants copy
+// their inputs and derive on the libuv threadpool, so long iteration counts
+// never stall the event loop.
 //==============================================================================
 
 // Helper function to parse hash algorithm name
@@ -28,16 +32,7 @@ static jsrt_crypto_algorithm_t parse_hash_algorithm(const char* hash_name) {
 // Helper to convert JSValue to buffer data
 static int get_buffer_data(JSContext* ctx, JSValueConst val, uint8_t** data, size_t* len) {
   size_t buffer_len;
-  uint8_t* buffer = JS_GetArrayBuffer(ctx, &buffer_len, val);
-
-  if (!buffer) {
-    // Try to get as typed array
-    JSValue buffer_prop = JS_GetPropertyStr(ctx, val, "buffer");
-    if (!JS_IsUndefined(buffer_prop)) {
-      buffer = JS_GetArrayBuffer(ctx, &buffer_len, buffer_prop);
-      JS_FreeValue(ctx, buffer_prop);
-    }
-  }
+  uint8_t* buffer = jsrt_node_buffer_source_bytes(ctx, val, &buffer_len);
 
   if (!buffer) {
     // Try as string (UTF-8)
@@ -57,7 +52,7 @@ static int get_buffer_data(JSContext* ctx, JSValueConst val, uint8_t** data, siz
 
   // Copy buffer data
   *len = buffer_len;
-  *data = malloc(buffer_len);
+  *data = malloc(buffer_len > 0 ? buffer_len : 1);
   if (!*data) {
     return -1;
   }
@@ -65,114 +60,158 @@ static int get_buffer_data(JSContext* ctx, JSValueConst val, uint8_t** data, siz
   return 1;  // Indicates allocated memory
 }
 
+static void kdf_free_array_buffer(JSRuntime* rt, void* opaque, void* ptr) {
+  free(ptr);
+}
+
+// Wrap derived bytes (ownership is taken) in a Uint8Array
+static JSValue kdf_new_uint8_array(JSContext* ctx, uint8_t* derived_key, size_t keylen) {
+  JSValue array_buffer = JS_NewArrayBuffer(ctx, derived_key, keylen, kdf_free_array_buffer, NULL, false);
+  if (JS_IsException(array_buffer)) {
+    free(derived_key);
+    return array_buffer;
+  }
+
+  JSValue global = JS_GetGlobalObject(ctx);
+  JSValue uint8_array_ctor = JS_GetPropertyStr(ctx, global, "Uint8Array");
+  JSValue result_array = JS_CallConstructor(ctx, uint8_array_ctor, 1, &array_buffer);
+
+  JS_FreeValue(ctx, uint8_array_ctor);
+  JS_FreeValue(ctx, global);
+  JS_FreeValue(ctx, array_buffer);
+
+  return result_array;
+}
+
+// Threadpool completion: hand the derived bytes to the callback as a Uint8Array
+static JSValue kdf_async_complete(JSContext* ctx, JSRTCryptoAsyncOperation* op) {
+  uint8_t* derived_key = op->output_data;
+  op->output_data = NULL;
+  return kdf_new_uint8_array(ctx, derived_key, op->output_length);
+}
+
+// Queue a parsed derivation; params and secret ownership move here
+static JSValue kdf_queue(JSContext* ctx, jsrt_kdf_params_t* params, uint8_t* secret, size_t secret_len, int32_t keylen,
+                         JSValueConst callback) {
+  JSRTCryptoAsyncOperation* op = jsrt_crypto_kdf_async_operation_new(params, secret, secret_len, keylen);
+  free(secret);
+  if (!op) {
+    return JS_ThrowOutOfMemory(ctx);
+  }
+
+  op->complete = kdf_async_complete;
+  return jsrt_crypto_async_queue_callback(ctx, op, callback);
+}
+
+// Derive synchronously from parsed parameters; params and secret are released
+static JSValue kdf_derive_sync(JSContext* ctx, jsrt_kdf_params_t* params, uint8_t* secret, size_t secret_len,
+                               int32_t keylen, const char* error_message) {
+  uint8_t* derived_key = NULL;
+  int result = -1;
+
+  switch (params->algorithm) {
+    case JSRT_KDF_PBKDF2:
+      result = jsrt_crypto_pbkdf2_derive_key(&params->params.pbkdf2, secret, secret_len, keylen, &derived_key);
+      break;
+    case JSRT_KDF_HKDF:
+      result = jsrt_crypto_hkdf_derive_key(&params->params.hkdf, secret, secret_len, keylen, &derived_key);
+      break;
+    case JSRT_KDF_SCRYPT:
+      result = jsrt_crypto_scrypt_derive_key(&params->params.scrypt, secret, secret_len, keylen, &derived_key);
+      break;
+  }
+
+  free(secret);
+  jsrt_crypto_kdf_params_free(params);
+
+  if (result != 0 || !derived_key) {
+    free(derived_key);
+    return JS_ThrowInternalError(ctx, "%s", error_message);
+  }
+
+  return kdf_new_uint8_array(ctx, derived_key, keylen);
+}
+
 //==============================================================================
 // PBKDF2 Implementation
 //==============================================================================
 
-// crypto.pbkdf2Sync(password, salt, iterations, keylen, digest)
-JSValue js_crypto_pbkdf2_sync(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
-  if (argc < 5) {
-    return JS_ThrowTypeError(ctx, "pbkdf2Sync requires 5 arguments: password, salt, iterations, keylen, digest");
-  }
-
-  // Get password
-  uint8_t* password = NULL;
-  size_t password_len = 0;
-  int password_allocated = get_buffer_data(ctx, argv[0], &password, &password_len);
-  if (password_allocated < 0) {
-    return JS_ThrowTypeError(ctx, "password must be a string or Buffer");
+// Parse (password, salt, iterations, keylen, digest); throws and returns NULL on bad input
+static jsrt_kdf_params_t* parse_pbkdf2_args(JSContext* ctx, JSValueConst* argv, uint8_t** password,
+                                            size_t* password_len, int32_t* keylen) {
+  if (get_buffer_data(ctx, argv[0], password, password_len) < 0) {
+    JS_ThrowTypeError(ctx, "password must be a string or Buffer");
+    return NULL;
   }
 
-  // Get salt
   uint8_t* salt = NULL;
   size_t salt_len = 0;
-  int salt_allocated = get_buffer_data(ctx, argv[1], &salt, &salt_len);
-  if (salt_allocated < 0) {
-    if (password_allocated > 0)
-      free(password);
-    return JS_ThrowTypeError(ctx, "salt must be a string or Buffer");
+  if (get_buffer_data(ctx, argv[1], &salt, &salt_len) < 0) {
+    free(*password);
+    JS_ThrowTypeError(ctx, "salt must be a string or Buffer");
+    return NULL;
   }
 
-  // Get iterations
   int32_t iterations;
   if (JS_ToInt32(ctx, &iterations, argv[2]) < 0 || iterations <= 0) {
-    if (password_allocated > 0)
-      free(password);
-    if (salt_allocated > 0)
-      free(salt);
-    return JS_ThrowTypeError(ctx, "iterations must be a positive number");
+    free(*password);
+    free(salt);
+    JS_ThrowTypeError(ctx, "iterations must be a positive number");
+    return NULL;
   }
 
-  // Get keylen
-  int32_t keylen;
-  if (JS_ToInt32(ctx, &keylen, argv[3]) < 0 || keylen <= 0) {
-    if (password_allocated > 0)
-      free(password);
-    if (salt_allocated > 0)
-      free(salt);
-    return JS_ThrowTypeError(ctx, "keylen must be a positive number");
+  if (JS_ToInt32(ctx, keylen, argv[3]) < 0 || *keylen <= 0) {
+    free(*password);
+    free(salt);
+    JS_ThrowTypeError(ctx, "keylen must be a positive number");
+    return NULL;
   }
 
-  // Get digest algorithm
   const char* digest_name = JS_ToCString(ctx, argv[4]);
   if (!digest_name) {
-    if (password_allocated > 0)
-      free(password);
-    if (salt_allocated > 0)
-      free(salt);
-    return JS_EXCEPTION;
+    free(*password);
+    free(salt);
+    return NULL;
   }
 
   jsrt_crypto_algorithm_t hash_alg = parse_hash_algorithm(digest_name);
   JS_FreeCString(ctx, digest_name);
 
-  if (hash_alg == JSRT_CRYPTO_ALG_UNKNOWN) {
-    if (password_allocated > 0)
-      free(password);
-    if (salt_allocated > 0)
-      free(salt);
-    return JS_ThrowTypeError(ctx, "Unsupported digest algorithm");
+  jsrt_kdf_params_t* params = hash_alg != JSRT_CRYPTO_ALG_UNKNOWN ? calloc(1, sizeof(jsrt_kdf_params_t)) : NULL;
+  if (!params) {
+    free(*password);
+    free(salt);
+    if (hash_alg == JSRT_CRYPTO_ALG_UNKNOWN) {
+      JS_ThrowTypeError(ctx, "Unsupported digest algorithm");
+    } else {
+      JS_ThrowOutOfMemory(ctx);
+    }
+    return NULL;
   }
 
-  // Setup PBKDF2 parameters
-  jsrt_pbkdf2_params_t params;
-  params.hash_algorithm = hash_alg;
-  params.salt = salt;
-  params.salt_length = salt_len;
-  params.iterations = iterations;
-
-  // Derive key
-  uint8_t* derived_key = NULL;
-  int result = jsrt_crypto_pbkdf2_derive_key(&params, password, password_len, keylen, &derived_key);
-
-  // Clean up input data
-  if (password_allocated > 0)
-    free(password);
-  if (salt_allocated > 0)
-    free(salt);
+  params->algorithm = JSRT_KDF_PBKDF2;
+  params->params.pbkdf2.hash_algorithm = hash_alg;
+  params->params.pbkdf2.salt = salt;
+  params->params.pbkdf2.salt_length = salt_len;
+  params->params.pbkdf2.iterations = iterations;
+  return params;
+}
 
-  if (result != 0 || !derived_key) {
-    if (derived_key)
-      free(derived_key);
-    return JS_ThrowInternalError(ctx, "PBKDF2 key derivation failed");
+// crypto.pbkdf2Sync(password, salt, iterations, keylen, digest)
+JSValue js_crypto_pbkdf2_sync(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
+  if (argc < 5) {
+    return JS_ThrowTypeError(ctx, "pbkdf2Sync requires 5 arguments: password, salt, iterations, keylen, digest");
   }
 
-  // Create Uint8Array result
-  JSValue array_buffer = JS_NewArrayBuffer(ctx, derived_key, keylen, NULL, NULL, false);
-  if (JS_IsException(array_buffer)) {
-    free(derived_key);
-    return array_buffer;
+  uint8_t* password = NULL;
+  size_t password_len = 0;
+  int32_t keylen = 0;
+  jsrt_kdf_params_t* params = parse_pbkdf2_args(ctx, argv, &password, &password_len, &keylen);
+  if (!params) {
+    return JS_EXCEPTION;
   }
 
-  JSValue global = JS_GetGlobalObject(ctx);
-  JSValue uint8_array_ctor = JS_GetPropertyStr(ctx, global, "Uint8Array");
-  JSValue result_array = JS_CallConstructor(ctx, uint8_array_ctor, 1, &array_buffer);
-
-  JS_FreeValue(ctx, uint8_array_ctor);
-  JS_FreeValue(ctx, global);
-  JS_FreeValue(ctx, array_buffer);
-
-  return result_array;
+  return kdf_derive_sync(ctx, params, password, password_len, keylen, "PBKDF2 key derivation failed");
 }
 
 // crypto.pbkdf2(password, salt, iterations, keylen, digest, callback)
@@ -185,180 +224,100 @@ JSValue js_crypto_pbkdf2(JSContext* ctx, JSValueConst this_val, int argc, JSValu
     return JS_ThrowTypeError(ctx, "callback must be a function");
   }
 
-  // Call sync version
-  JSValue result = js_crypto_pbkdf2_sync(ctx, this_val, 5, argv);
-
-  // Invoke callback asynchronously using setTimeout trick
-  JSValue callback = JS_DupValue(ctx, argv[5]);
-
-  if (JS_IsException(result)) {
-    // Error case - call callback with error
-    JSValue error = result;
-    JSValue global = JS_GetGlobalObject(ctx);
-    JSValue set_timeout = JS_GetPropertyStr(ctx, global, "setTimeout");
-
-    if (JS_IsFunction(ctx, set_timeout)) {
-      // Create wrapper function that calls callback(error)
-      const char* wrapper_code = "(callback, error) => callback(error)";
-      JSValue wrapper = JS_Eval(ctx, wrapper_code, strlen(wrapper_code), "<pbkdf2>", 0);
-
-      if (JS_IsFunction(ctx, wrapper)) {
-        JSValue bound_args[] = {callback, error};
-        JSValue bound = JS_Call(ctx, wrapper, JS_UNDEFINED, 2, bound_args);
-
-        JSValue timeout_args[] = {bound, JS_NewInt32(ctx, 0)};
-        JS_Call(ctx, set_timeout, JS_UNDEFINED, 2, timeout_args);
-
-        JS_FreeValue(ctx, bound);
-        JS_FreeValue(ctx, timeout_args[1]);
-      }
-      JS_FreeValue(ctx, wrapper);
-    }
-
-    JS_FreeValue(ctx, set_timeout);
-    JS_FreeValue(ctx, global);
-    JS_FreeValue(ctx, callback);
-    JS_FreeValue(ctx, error);
-    return JS_UNDEFINED;
-  }
-
-  // Success case - call callback(null, result)
-  JSValue global = JS_GetGlobalObject(ctx);
-  JSValue set_timeout = JS_GetPropertyStr(ctx, global, "setTimeout");
-
-  if (JS_IsFunction(ctx, set_timeout)) {
-    // Create wrapper function that calls callback(null, result)
-    const char* wrapper_code = "(callback, result) => callback(null, result)";
-    JSValue wrapper = JS_Eval(ctx, wrapper_code, strlen(wrapper_code), "<pbkdf2>", 0);
-
-    if (JS_IsFunction(ctx, wrapper)) {
-      JSValue bound_args[] = {callback, result};
-      JSValue bound = JS_Call(ctx, wrapper, JS_UNDEFINED, 2, bound_args);
-
-      JSValue timeout_args[] = {bound, JS_NewInt32(ctx, 0)};
-      JS_Call(ctx, set_timeout, JS_UNDEFINED, 2, timeout_args);
-
-      JS_FreeValue(ctx, bound);
-      JS_FreeValue(ctx, timeout_args[1]);
-    }
-    JS_FreeValue(ctx, wrapper);
+  uint8_t* password = NULL;
+  size_t password_len = 0;
+  int32_t keylen = 0;
+  jsrt_kdf_params_t* params = parse_pbkdf2_args(ctx, argv, &password, &password_len, &keylen);
+  if (!params) {
+    return JS_EXCEPTION;
   }
 
-  JS_FreeValue(ctx, set_timeout);
-  JS_FreeValue(ctx, global);
-  JS_FreeValue(ctx, callback);
-  JS_FreeValue(ctx, result);
-
-  return JS_UNDEFINED;
+  return kdf_queue(ctx, params, password, password_len, keylen, argv[5]);
 }
 
 //==============================================================================
 // HKDF Implementation
 //==============================================================================
 
-// crypto.hkdfSync(digest, ikm, salt, info, keylen)
-JSValue js_crypto_hkdf_sync(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
-  if (argc < 5) {
-    return JS_ThrowTypeError(ctx, "hkdfSync requires 5 arguments: digest, ikm, salt, info, keylen");
-  }
-
-  // Get digest algorithm
+// Parse (digest, ikm, salt, info, keylen); throws and returns NULL on bad input
+static jsrt_kdf_params_t* parse_hkdf_args(JSContext* ctx, JSValueConst* argv, uint8_t** ikm, size_t* ikm_len,
+                                          int32_t* keylen) {
   const char* digest_name = JS_ToCString(ctx, argv[0]);
   if (!digest_name) {
-    return JS_EXCEPTION;
+    return NULL;
   }
 
   jsrt_crypto_algorithm_t hash_alg = parse_hash_algorithm(digest_name);
   JS_FreeCString(ctx, digest_name);
 
   if (hash_alg == JSRT_CRYPTO_ALG_UNKNOWN) {
-    return JS_ThrowTypeError(ctx, "Unsupported digest algorithm");
+    JS_ThrowTypeError(ctx, "Unsupported digest algorithm");
+    return NULL;
   }
 
-  // Get ikm (input key material)
-  uint8_t* ikm = NULL;
-  size_t ikm_len = 0;
-  int ikm_allocated = get_buffer_data(ctx, argv[1], &ikm, &ikm_len);
-  if (ikm_allocated < 0) {
-    return JS_ThrowTypeError(ctx, "ikm must be a string or Buffer");
+  if (get_buffer_data(ctx, argv[1], ikm, ikm_len) < 0) {
+    JS_ThrowTypeError(ctx, "ikm must be a string or Buffer");
+    return NULL;
   }
 
-  // Get salt
   uint8_t* salt = NULL;
   size_t salt_len = 0;
-  int salt_allocated = get_buffer_data(ctx, argv[2], &salt, &salt_len);
-  if (salt_allocated < 0) {
-    if (ikm_allocated > 0)
-      free(ikm);
-    return JS_ThrowTypeError(ctx, "salt must be a string or Buffer");
+  if (get_buffer_data(ctx, argv[2], &salt, &salt_len) < 0) {
+    free(*ikm);
+    JS_ThrowTypeError(ctx, "salt must be a string or Buffer");
+    return NULL;
   }
 
-  // Get info
   uint8_t* info = NULL;
   size_t info_len = 0;
-  int info_allocated = get_buffer_data(ctx, argv[3], &info, &info_len);
-  if (info_allocated < 0) {
-    if (ikm_allocated > 0)
-      free(ikm);
-    if (salt_allocated > 0)
-      free(salt);
-    return JS_ThrowTypeError(ctx, "info must be a string or Buffer");
-  }
-
-  // Get keylen
-  int32_t keylen;
-  if (JS_ToInt32(ctx, &keylen, argv[4]) < 0 || keylen <= 0) {
-    if (ikm_allocated > 0)
-      free(ikm);
-    if (salt_allocated > 0)
-      free(salt);
-    if (info_allocated > 0)
-      free(info);
-    return JS_ThrowTypeError(ctx, "keylen must be a positive number");
-  }
-
-  // Setup HKDF parameters
-  jsrt_hkdf_params_t params;
-  params.hash_algorithm = hash_alg;
-  params.salt = salt;
-  params.salt_length = salt_len;
-  params.info = info;
-  params.info_length = info_len;
-
-  // Derive key
-  uint8_t* derived_key = NULL;
-  int result = jsrt_crypto_hkdf_derive_key(&params, ikm, ikm_len, keylen, &derived_key);
+  if (get_buffer_data(ctx, argv[3], &info, &info_len) < 0) {
+    free(*ikm);
+    free(salt);
+    JS_ThrowTypeError(ctx, "info must be a string or Buffer");
+    return NULL;
+  }
 
-  // Clean up input data
-  if (ikm_allocated > 0)
-    free(ikm);
-  if (salt_allocated > 0)
+  if (JS_ToInt32(ctx, keylen, argv[4]) < 0 || *keylen <= 0) {
+    free(*ikm);
     free(salt);
-  if (info_allocated > 0)
     free(info);
-
-  if (result != 0 || !derived_key) {
-    if (derived_key)
-      free(derived_key);
-    return JS_ThrowInternalError(ctx, "HKDF key derivation failed");
+    JS_ThrowTypeError(ctx, "keylen must be a positive number");
+    return NULL;
   }
 
-  // Create Uint8Array result
-  JSValue array_buffer = JS_NewArrayBuffer(ctx, derived_key, keylen, NULL, NULL, false);
-  if (JS_IsException(array_buffer)) {
-    free(derived_key);
-    return array_buffer;
+  jsrt_kdf_params_t* params = calloc(1, sizeof(jsrt_kdf_params_t));
+  if (!params) {
+    free(*ikm);
+    free(salt);
+    free(info);
+    JS_ThrowOutOfMemory(ctx);
+    return NULL;
   }
 
-  JSValue global = JS_GetGlobalObject(ctx);
-  JSValue uint8_array_ctor = JS_GetPropertyStr(ctx, global, "Uint8Array");
-  JSValue result_array = JS_CallConstructor(ctx, uint8_array_ctor, 1, &array_buffer);
+  params->algorithm = JSRT_KDF_HKDF;
+  params->params.hkdf.hash_algorithm = hash_alg;
+  params->params.hkdf.salt = salt;
+  params->params.hkdf.salt_length = salt_len;
+  params->params.hkdf.info = info;
+  params->params.hkdf.info_length = info_len;
+  return params;
+}
 
-  JS_FreeValue(ctx, uint8_array_ctor);
-  JS_FreeValue(ctx, global);
-  JS_FreeValue(ctx, array_buffer);
+// crypto.hkdfSync(digest, ikm, salt, info, keylen)
+JSValue js_crypto_hkdf_sync(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
+  if (argc < 5) {
+    return JS_ThrowTypeError(ctx, "hkdfSync requires 5 arguments: digest, ikm, salt, info, keylen");
+  }
 
-  return result_array;
+  uint8_t* ikm = NULL;
+  size_t ikm_len = 0;
+  int32_t keylen = 0;
+  jsrt_kdf_params_t* params = parse_hkdf_args(ctx, argv, &ikm, &ikm_len, &keylen);
+  if (!params) {
+    return JS_EXCEPTION;
+  }
+
+  return kdf_derive_sync(ctx, params, ikm, ikm_len, keylen, "HKDF key derivation failed");
 }
 
 // crypto.hkdf(digest, ikm, salt, info, keylen, callback)
@@ -371,84 +330,122 @@ JSValue js_crypto_hkdf(JSContext* ctx, JSValueConst this_val, int argc, JSValueC
     return JS_ThrowTypeError(ctx, "callback must be a function");
   }
 
-  // Call sync version
-  JSValue result = js_crypto_hkdf_sync(ctx, this_val, 5, argv);
-
-  // Invoke callback asynchronously using setTimeout trick
-  JSValue callback = JS_DupValue(ctx, argv[5]);
-
-  if (JS_IsException(result)) {
-    // Error case - call callback with error
-    JSValue error = result;
-    JSValue global = JS_GetGlobalObject(ctx);
-    JSValue set_timeout = JS_GetPropertyStr(ctx, global, "setTimeout");
-
-    if (JS_IsFunction(ctx, set_timeout)) {
-      // Create wrapper function that calls callback(error)
-      const char* wrapper_code = "(callback, error) => callback(error)";
-      JSValue wrapper = JS_Eval(ctx, wrapper_code, strlen(wrapper_code), "<hkdf>", 0);
+  uint8_t* ikm = NULL;
+  size_t ikm_len = 0;
+  int32_t keylen = 0;
+  jsrt_kdf_params_t* params = parse_hkdf_args(ctx, argv, &ikm, &ikm_len, &keylen);
+  if (!params) {
+    return JS_EXCEPTION;
+  }
 
-      if (JS_IsFunction(ctx, wrapper)) {
-        JSValue bound_args[] = {callback, error};
-        JSValue bound = JS_Call(ctx, wrapper, JS_UNDEFINED, 2, bound_args);
+  return kdf_queue(ctx, params, ikm, ikm_len, keylen, argv[5]);
+}
 
-        JSValue timeout_args[] = {bound, JS_NewInt32(ctx, 0)};
-        JS_Call(ctx, set_timeout, JS_UNDEFINED, 2, timeout_args);
+//==============================================================================
+// Scrypt Implementation (EVP_PBE_scrypt, OpenSSL 1.1.0+)
+//==============================================================================
 
-        JS_FreeValue(ctx, bound);
-        JS_FreeValue(ctx, timeout_args[1]);
+// Read a numeric scrypt option under either of its Node.js names
+static int get_scrypt_option(JSContext* ctx, JSValueConst options, const char* name, const char* alias,
+                             uint64_t* value) {
+  const char* names[2] = {name, alias};
+  for (int i = 0; i < 2; i++) {
+    JSValue val = JS_GetPropertyStr(ctx, options, names[i]);
+    if (JS_IsException(val)) {
+      return -1;
+    }
+    if (!JS_IsUndefined(val)) {
+      int64_t n;
+      int r = JS_ToInt64(ctx, &n, val);
+      JS_FreeValue(ctx, val);
+      if (r < 0) {
+        return -1;
+      }
+      if (n <= 0) {
+        JS_ThrowRangeError(ctx, "scrypt option %s must be a positive number", names[i]);
+        return -1;
       }
-      JS_FreeValue(ctx, wrapper);
+      *value = (uint64_t)n;
+      return 0;
     }
-
-    JS_FreeValue(ctx, set_timeout);
-    JS_FreeValue(ctx, global);
-    JS_FreeValue(ctx, callback);
-    JS_FreeValue(ctx, error);
-    return JS_UNDEFINED;
   }
+  return 0;
+}
 
-  // Success case - call callback(null, result)
-  JSValue global = JS_GetGlobalObject(ctx);
-  JSValue set_timeout = JS_GetPropertyStr(ctx, global, "setTimeout");
-
-  if (JS_IsFunction(ctx, set_timeout)) {
-    // Create wrapper function that calls callback(null, result)
-    const char* wrapper_code = "(callback, result) => callback(null, result)";
-    JSValue wrapper = JS_Eval(ctx, wrapper_code, strlen(wrapper_code), "<hkdf>", 0);
+// Parse (password, salt, keylen[, options]); throws and returns NULL on bad input
+static jsrt_kdf_params_t* parse_scrypt_args(JSContext* ctx, int argc, JSValueConst* argv, uint8_t** password,
+                                            size_t* password_len, int32_t* keylen) {
+  // Node.js defaults
+  uint64_t cost = 16384, block_size = 8, parallel = 1, maxmem = 32 * 1024 * 1024;
+
+  if (argc > 3 && JS_IsObject(argv[3])) {
+    if (get_scrypt_option(ctx, argv[3], "N", "cost", &cost) < 0 ||
+        get_scrypt_option(ctx, argv[3], "r", "blockSize", &block_size) < 0 ||
+        get_scrypt_option(ctx, argv[3], "p", "parallelization", &parallel) < 0 ||
+        get_scrypt_option(ctx, argv[3], "maxmem", "maxmem", &maxmem) < 0) {
+      return NULL;
+    }
+  }
 
-    if (JS_IsFunction(ctx, wrapper)) {
-      JSValue bound_args[] = {callback, result};
-      JSValue bound = JS_Call(ctx, wrapper, JS_UNDEFINED, 2, bound_args);
+  if (cost < 2 || (cost & (cost - 1)) != 0) {
+    JS_ThrowRangeError(ctx, "scrypt cost (N) must be a power of two greater than 1");
+    return NULL;
+  }
 
-      JSValue timeout_args[] = {bound, JS_NewInt32(ctx, 0)};
-      JS_Call(ctx, set_timeout, JS_UNDEFINED, 2, timeout_args);
+  if (JS_ToInt32(ctx, keylen, argv[2]) < 0 || *keylen <= 0) {
+    JS_ThrowTypeError(ctx, "keylen must be a positive number");
+    return NULL;
+  }
 
-      JS_FreeValue(ctx, bound);
-      JS_FreeValue(ctx, timeout_args[1]);
-    }
-    JS_FreeValue(ctx, wrapper);
+  if (get_buffer_data(ctx, argv[0], password, password_len) < 0) {
+    JS_ThrowTypeError(ctx, "password must be a string or Buffer");
+    return NULL;
   }
 
-  JS_FreeValue(ctx, set_timeout);
-  JS_FreeValue(ctx, global);
-  JS_FreeValue(ctx, callback);
-  JS_FreeValue(ctx, result);
+  uint8_t* salt = NULL;
+  size_t salt_len = 0;
+  if (get_buffer_data(ctx, argv[1], &salt, &salt_len) < 0) {
+    free(*password);
+    JS_ThrowTypeError(ctx, "salt must be a string or Buffer");
+    return NULL;
+  }
 
-  return JS_UNDEFINED;
+  jsrt_kdf_params_t* params = calloc(1, sizeof(jsrt_kdf_params_t));
+  if (!params) {
+    free(*password);
+    free(salt);
+    JS_ThrowOutOfMemory(ctx);
+    return NULL;
+  }
+
+  params->algorithm = JSRT_KDF_SCRYPT;
+  params->params.scrypt.salt = salt;
+  params->params.scrypt.salt_length = salt_len;
+  params->params.scrypt.cost = cost;
+  params->params.scrypt.block_size = block_size;
+  params->params.scrypt.parallel = parallel;
+  params->params.scrypt.maxmem = maxmem;
+  return params;
 }
 
-//==============================================================================
-// Scrypt Implementation (Check OpenSSL availability)
-//==============================================================================
+// crypto.scryptSync(password, salt, keylen[, options])
+JSValue js_crypto_scrypt_sync(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
+  if (argc < 3) {
+    return JS_ThrowTypeError(ctx, "scryptSync requires at least 3 arguments: password, salt, keylen");
+  }
 
-// Scrypt is not implemented yet - OpenSSL 3.x support needs investigation
-// For now, provide stub functions that throw "not implemented" error
+  uint8_t* password = NULL;
+  size_t password_len = 0;
+  int32_t keylen = 0;
+  jsrt_kdf_params_t* params = parse_scrypt_args(ctx, argc, argv, &password, &password_len, &keylen);
+  if (!params) {
+    return JS_EXCEPTION;
+  }
 
-JSValue js_crypto_scrypt_sync(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
-  return JS_ThrowInternalError(ctx, "scrypt is not yet implemented");
+  return kdf_derive_sync(ctx, params, password, password_len, keylen, "scrypt key derivation failed");
 }
 
+// crypto.scrypt(password, salt, keylen[, options], callback)
 JSValue js_crypto_scrypt(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
   if (argc < 4) {
     return JS_ThrowTypeError(ctx, "scrypt requires at least 4 arguments");
@@ -458,34 +455,13 @@ JSValue js_crypto_scrypt(JSContext* ctx, JSValueConst this_val, int argc, JSValu
     return JS_ThrowTypeError(ctx, "callback must be a function");
   }
 
-  // Call callback with error asynchronously
-  JSValue callback = JS_DupValue(ctx, argv[argc - 1]);
-  JSValue error = JS_ThrowInternalError(ctx, "scrypt is not yet implemented");
-
-  JSValue global = JS_GetGlobalObject(ctx);
-  JSValue set_timeout = JS_GetPropertyStr(ctx, global, "setTimeout");
-
-  if (JS_IsFunction(ctx, set_timeout)) {
-    const char* wrapper_code = "(callback, error) => callback(error)";
-    JSValue wrapper = JS_Eval(ctx, wrapper_code, strlen(wrapper_code), "<scrypt>", 0);
-
-    if (JS_IsFunction(ctx, wrapper)) {
-      JSValue bound_args[] = {callback, error};
-      JSValue bound = JS_Call(ctx, wrapper, JS_UNDEFINED, 2, bound_args);
-
-      JSValue timeout_args[] = {bound, JS_NewInt32(ctx, 0)};
-      JS_Call(ctx, set_timeout, JS_UNDEFINED, 2, timeout_args);
-
-      JS_FreeValue(ctx, bound);
-      JS_FreeValue(ctx, timeout_args[1]);
-    }
-    JS_FreeValue(ctx, wrapper);
+  uint8_t* password = NULL;
+  size_t password_len = 0;
+  int32_t keylen = 0;
+  jsrt_kdf_params_t* params = parse_scrypt_args(ctx, argc - 1, argv, &password, &password_len, &keylen);
+  if (!params) {
+    return JS_EXCEPTION;
   }
 
-  JS_FreeValue(ctx, set_timeout);
-  JS_FreeValue(ctx, global);
-  JS_FreeValue(ctx, callback);
-  JS_FreeValue(ctx, error);
-
-  return JS_UNDEFINED;
+  return kdf_queue(ctx, params, password, password_len, keylen, argv[argc - 1]);
 }
@@ -46,16 +46,7 @@ static JSValue js_node_sign_update(JSContext* ctx, JSValueConst this_val, int ar
 
   // Get data buffer
   size_t data_len;
-  uint8_t* data = JS_GetArrayBuffer(ctx, &data_len, argv[0]);
-
-  if (!data) {
-    // Try to get as typed array
-    JSValue buffer = JS_GetPropertyStr(ctx, argv[0], "buffer");
-    if (!JS_IsUndefined(buffer)) {
-      data = JS_GetArrayBuffer(ctx, &data_len, buffer);
-      JS_FreeValue(ctx, buffer);
-    }
-  }
+  uint8_t* data = jsrt_node_buffer_source_bytes(ctx, argv[0], &data_len);
 
   if (!data) {
     return JS_ThrowTypeError(ctx, "data must be a Buffer or TypedArray");
@@ -293,16 +284,7 @@ static JSValue js_node_verify_update(JSContext* ctx, JSValueConst this_val, int
 
   // Get data buffer
   size_t data_len;
-  uint8_t* data = JS_GetArrayBuffer(ctx, &data_len, argv[0]);
-
-  if (!data) {
-    // Try to get as typed array
-    JSValue buffer = JS_GetPropertyStr(ctx, argv[0], "buffer");
-    if (!JS_IsUndefined(buffer)) {
-      data = JS_GetArrayBuffer(ctx, &data_len, buffer);
-      JS_FreeValue(ctx, buffer);
-    }
-  }
+  uint8_t* data = jsrt_node_buffer_source_bytes(ctx, argv[0], &data_len);
 
   if (!data) {
     return JS_ThrowTypeError(ctx, "data must be a Buffer or TypedArray");
@@ -361,15 +343,7 @@ static JSValue js_node_verify_verify(JSContext* ctx, JSValueConst this_val, int
 
   // Get signature data
   size_t sig_len;
-  uint8_t* sig_data = JS_GetArrayBuffer(ctx, &sig_len, argv[1]);
-  if (!sig_data) {
-    // Try to get as typed array
-    JSValue buffer = JS_GetPropertyStr(ctx, argv[1], "buffer");
-    if (!JS_IsUndefined(buffer)) {
-      sig_data = JS_GetArrayBuffer(ctx, &sig_len, buffer);
-      JS_FreeValue(ctx, buffer);
-    }
-  }
+  uint8_t* sig_data = jsrt_node_buffer_source_bytes(ctx, argv[1], &sig_len);
 
   if (!sig_data) {
     JS_FreeValue(ctx, key_data_val);
@@ -9,8 +9,7 @@
 
 // Allocation callback for receiving data (based on net module's on_socket_alloc)
 void on_dgram_alloc(uv_handle_t* handle, size_t suggested_size, uv_buf_t* buf) {
-  buf->base = malloc(suggested_size);
-  buf->len = suggested_size;
+  JSRT_ReadSlabAlloc(handle, suggested_size, buf);
 }
 
 // Send callback (based on net module's on_socket_write_complete pattern)
@@ -61,6 +60,7 @@ void on_dgram_send(uv_udp_send_t* req, int status) {
 
 // Receive callback (based on net module's on_socket_read pattern but adapted for UDP)
 void on_dgram_recv(uv_udp_t* handle, ssize_t nread, const uv_buf_t* buf, const struct sockaddr* addr, unsigned flags) {
+  bool read_buffer_owned = true;  // Cleared once the slab slice is handed to a JS Buffer
   JSDgramSocket* socket = (JSDgramSocket*)handle->data;
 
   if (!socket || !socket->ctx || socket->destroyed) {
@@ -133,45 +133,34 @@ void on_dgram_recv(uv_udp_t* handle, ssize_t nread, const uv_buf_t* buf, const s
   socket->messages_received++;
   socket->bytes_received += nread;
 
-  // Create Buffer from received data (using node:buffer module)
-  JSValue buffer_module = JSRT_LoadNodeModuleCommonJS(ctx, "buffer");
-  if (!JS_IsException(buffer_module)) {
-    JSValue buffer_class = JS_GetPropertyStr(ctx, buffer_module, "Buffer");
-    if (!JS_IsException(buffer_class)) {
-      JSValue from_func = JS_GetPropertyStr(ctx, buffer_class, "from");
-      if (JS_IsFunction(ctx, from_func)) {
-        // Create ArrayBuffer copy from received data
-        JSValue array_buffer = JS_NewArrayBufferCopy(ctx, (const uint8_t*)buf->base, nread);
-
-        // Convert to Buffer
-        JSValue argv_buf[] = {array_buffer};
-        JSValue msg_buffer = JS_Call(ctx, from_func, buffer_class, 1, argv_buf);
-
-        // Emit 'message' event
-        JSValue argv[] = {JS_NewString(ctx, "message"), msg_buffer, rinfo};
-        JSValue emit_func = JS_GetPropertyStr(ctx, socket->socket_obj, "emit");
-        if (JS_IsFunction(ctx, emit_func)) {
-          JS_Call(ctx, emit_func, socket->socket_obj, 3, argv);
-        }
-        JS_FreeValue(ctx, emit_func);
-        JS_FreeValue(ctx, argv[0]);
-        JS_FreeValue(ctx, argv[1]);
-        JS_FreeValue(ctx, argv[2]);
-
-        JS_FreeValue(ctx, array_buffer);
-      }
-      JS_FreeValue(ctx, from_func);
+  // Expose the datagram as a Buffer view over the read slab
+  JSValue array_buffer = JSRT_ReadSlabTake((uv_handle_t*)handle, buf, nread);
+  read_buffer_owned = false;
+  JSValue msg_buffer = jsrt_node_buffer_view(ctx, array_buffer, 0, nread);
+  JS_FreeValue(ctx, array_buffer);
+
+  if (JS_IsException(msg_buffer)) {
+    JS_FreeValue(ctx, JS_GetException(ctx));
+    JS_FreeValue(ctx, rinfo);
+  } else {
+    // Emit 'message' event
+    JSValue argv[] = {JS_NewString(ctx, "message"), msg_buffer, rinfo};
+    JSValue emit_func = JS_GetPropertyStr(ctx, socket->socket_obj, "emit");
+    if (JS_IsFunction(ctx, emit_func)) {
+      JS_Call(ctx, emit_func, socket->socket_obj, 3, argv);
     }
-    JS_FreeValue(ctx, buffer_class);
-    JS_FreeValue(ctx, buffer_module);
+    JS_FreeValue(ctx, emit_func);
+    JS_FreeValue(ctx, argv[0]);
+    JS_FreeValue(ctx, argv[1]);
+    JS_FreeValue(ctx, argv[2]);
   }
 
   // Clear callback flag
   socket->in_callback = false;
 
 cleanup:
-  // Always free the buffer allocated in on_dgram_alloc
-  if (buf && buf->base) {
-    free(buf->base);
+  // Return the slice from on_dgram_alloc unless a Buffer took it over
+  if (read_buffer_owned) {
+    JSRT_ReadSlabRelease((uv_handle_t*)handle, buf, 0);
   }
 }
@@ -5,6 +5,7 @@
 #include <string.h>
 #include <uv.h>
 #include "../../runtime.h"
+#include "../../util/read_slab.h"
 #include "../node_modules.h"
 
 // Class ID for Socket
@@ -82,15 +82,7 @@ JSValue js_dgram_socket_send(JSContext* ctx, JSValueConst this_val, int argc, JS
       JS_FreeValue(ctx, is_buffer_func);
 
       if (is_buffer) {
-        msg_data = JS_GetArrayBuffer(ctx, &msg_len, msg);
-        if (!msg_data) {
-          // Try getting from Buffer's underlying ArrayBuffer
-          JSValue ab = JS_GetPropertyStr(ctx, msg, "buffer");
-          if (!JS_IsException(ab)) {
-            msg_data = JS_GetArrayBuffer(ctx, &msg_len, ab);
-          }
-          JS_FreeValue(ctx, ab);
-        }
+        msg_data = jsrt_node_buffer_source_bytes(ctx, msg, &msg_len);
       }
     }
     JS_FreeValue(ctx, buffer_class);
@@ -2,6 +2,7 @@
 #include "../runtime.h"
 #include "../std/assert.h"
 #include "../util/debug.h"
+#include "../util/macro.h"
 #include "node_modules.h"
 
 // Diagnostics Channel implementation - provides diagnostic channels for observability
@@ -24,7 +25,7 @@ typedef struct {
   size_t size;
 } ChannelMap;
 
-static ChannelMap* global_channel_map = NULL;
+static JSRT_THREAD_LOCAL ChannelMap* global_channel_map = NULL;
 
 // Initialize global channel map
 static ChannelMap* get_channel_map(JSContext* ctx) {
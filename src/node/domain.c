@@ -10,6 +10,7 @@
 #include <string.h>
 #include "../runtime.h"
 #include "../util/debug.h"
+#include "../util/macro.h"
 
 // Forward declare the class ID
 static JSClassID js_domain_class_id;
@@ -27,7 +28,7 @@ typedef struct {
 } JSDomain;
 
 // Global domain context
-static JSDomain* current_domain = NULL;
+static JSRT_THREAD_LOCAL JSDomain* current_domain = NULL;
 
 // ============================================================================
 // Domain Constructor and Factory Functions
@@ -1,9 +1,10 @@
 #include "events_internal.h"
+#include "../../util/macro.h"
 
 // Define the error monitor symbol
-static JSAtom error_monitor_atom = JS_ATOM_NULL;
-static JSAtom capture_rejections_atom = JS_ATOM_NULL;
-static JSAtom nodejs_rejection_atom = JS_ATOM_NULL;
+static JSRT_THREAD_LOCAL JSAtom error_monitor_atom = JS_ATOM_NULL;
+static JSRT_THREAD_LOCAL JSAtom capture_rejections_atom = JS_ATOM_NULL;
+static JSRT_THREAD_LOCAL JSAtom nodejs_rejection_atom = JS_ATOM_NULL;
 
 // Initialize error handling symbols
 void init_error_handling_symbols(JSContext* ctx) {
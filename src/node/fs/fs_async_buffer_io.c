@@ -388,62 +388,3 @@ JSValue js_fs_rm_async(JSContext* ctx, JSValueConst this_val, int argc, JSValueC
 
   return JS_UNDEFINED;
 }
-
-// ============================================================================
-// cp: Recursive copy (async wrapper - simplified for now)
-// ============================================================================
-
-// fs.cp(src, dest, options, callback) - async recursive copy
-JSValue js_fs_cp_async(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
-  if (argc < 3) {
-    return JS_ThrowTypeError(ctx, "cp requires src, dest, and callback");
-  }
-
-  const char* src = JS_ToCString(ctx, argv[0]);
-  if (!src) {
-    return JS_EXCEPTION;
-  }
-
-  const char* dest = JS_ToCString(ctx, argv[1]);
-  if (!dest) {
-    JS_FreeCString(ctx, src);
-    return JS_EXCEPTION;
-  }
-
-  JSValue callback = argv[2];
-  if (argc >= 4) {
-    callback = argv[3];  // cp(src, dest, options, callback)
-  }
-
-  if (!JS_IsFunction(ctx, callback)) {
-    JS_FreeCString(ctx, src);
-    JS_FreeCString(ctx, dest);
-    return JS_ThrowTypeError(ctx, "callback must be a function");
-  }
-
-  // Call sync cpSync and report result asynchronously
-  JSValue sync_args[3] = {argv[0], argv[1], argc >= 4 ? argv[2] : JS_UNDEFINED};
-  JSValue result = js_fs_cp_sync(ctx, this_val, argc >= 4 ? 3 : 2, sync_args);
-
-  if (JS_IsException(result)) {
-    // Extract error and call callback
-    JSValue exception = JS_GetException(ctx);
-    JSValue args[1] = {exception};
-    JSValue ret = JS_Call(ctx, callback, JS_UNDEFINED, 1, args);
-    JS_FreeValue(ctx, ret);
-    JS_FreeValue(ctx, exception);
-    JS_FreeCString(ctx, src);
-    JS_FreeCString(ctx, dest);
-    return JS_UNDEFINED;
-  }
-
-  // Success
-  JSValue args[1] = {JS_NULL};
-  JSValue ret = JS_Call(ctx, callback, JS_UNDEFINED, 1, args);
-  JS_FreeValue(ctx, ret);
-  JS_FreeValue(ctx, result);
-  JS_FreeCString(ctx, src);
-  JS_FreeCString(ctx, dest);
-
-  return JS_UNDEFINED;
-}
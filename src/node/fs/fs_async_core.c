@@ -2068,220 +2068,25 @@ JSValue js_fs_write_async(JSContext* ctx, JSValueConst this_val, int argc, JSVal
 }
 
 // ============================================================================
-// copyFile: Multi-step async operation (open src → open dest → fstat → read → write → close both) (Task 2.15)
+// copyFile: uv_fs_copyfile tries a reflink (FICLONE) and then copies in the kernel
+// (copy_file_range/sendfile), so file data never passes through a userspace buffer
 // ============================================================================
 
-// Forward declarations for copyFile callbacks
-static void copyfile_read_cb(uv_fs_t* req);
-
-// Completion callback - closes both fds
-static void copyfile_cleanup_cb(uv_fs_t* req) {
-  fs_async_work_t* work = (fs_async_work_t*)req;
-  JSContext* ctx = work->ctx;
-
-  // Copy completed successfully
-  JSValue args[1] = {JS_NULL};
-  JSValue ret = JS_Call(ctx, work->callback, JS_UNDEFINED, 1, args);
-  JS_FreeValue(ctx, ret);
-
-  fs_async_work_free(work);
-}
-
-// Step 6: Close destination fd
-static void copyfile_close_dest_cb(uv_fs_t* req) {
-  fs_async_work_t* work = (fs_async_work_t*)req;
-  uv_loop_t* loop = fs_get_uv_loop(work->ctx);
-
-  // Now close source fd (stored in mode field)
-  uv_fs_req_cleanup(req);
-  uv_fs_close(loop, req, work->mode, copyfile_cleanup_cb);
-}
-
-// Step 5: After write, close dest fd
-static void copyfile_write_cb(uv_fs_t* req) {
-  fs_async_work_t* work = (fs_async_work_t*)req;
-  JSContext* ctx = work->ctx;
-  uv_loop_t* loop = fs_get_uv_loop(ctx);
-
-  if (req->result < 0) {
-    // Write error - close both fds
-    int err = -req->result;
-    uv_fs_t close_req;
-    uv_fs_close(loop, &close_req, work->flags, NULL);  // dest fd
-    uv_fs_req_cleanup(&close_req);
-    uv_fs_close(loop, &close_req, work->mode, NULL);  // src fd
-    uv_fs_req_cleanup(&close_req);
-
-    JSValue error = create_fs_error(ctx, err, "write", work->path2);
-    JSValue args[1] = {error};
-    JSValue ret = JS_Call(ctx, work->callback, JS_UNDEFINED, 1, args);
-    JS_FreeValue(ctx, ret);
-    JS_FreeValue(ctx, error);
-    fs_async_work_free(work);
-    return;
-  }
-
-  // Read next chunk from source (continue loop)
-  uv_buf_t iov = uv_buf_init(work->buffer, 8192);  // 8KB chunks
-  uv_fs_req_cleanup(req);
-  uv_fs_read(loop, req, work->mode, &iov, 1, work->offset, copyfile_read_cb);
-}
-
-// Step 4: Read chunk from source
-static void copyfile_read_cb(uv_fs_t* req) {
-  fs_async_work_t* work = (fs_async_work_t*)req;
-  JSContext* ctx = work->ctx;
-  uv_loop_t* loop = fs_get_uv_loop(ctx);
-
-  if (req->result < 0) {
-    // Read error - close both fds
-    int err = -req->result;
-    uv_fs_t close_req;
-    uv_fs_close(loop, &close_req, work->flags, NULL);  // dest fd
-    uv_fs_req_cleanup(&close_req);
-    uv_fs_close(loop, &close_req, work->mode, NULL);  // src fd
-    uv_fs_req_cleanup(&close_req);
-
-    JSValue error = create_fs_error(ctx, err, "read", work->path);
-    JSValue args[1] = {error};
-    JSValue ret = JS_Call(ctx, work->callback, JS_UNDEFINED, 1, args);
-    JS_FreeValue(ctx, ret);
-    JS_FreeValue(ctx, error);
-    fs_async_work_free(work);
-    return;
-  }
-
-  if (req->result == 0) {
-    // EOF - all data copied, close destination fd
-    uv_fs_req_cleanup(req);
-    uv_fs_close(loop, req, work->flags, copyfile_close_dest_cb);
-    return;
-  }
-
-  // Write the chunk to destination
-  size_t bytes_read = (size_t)req->result;
-  work->offset += bytes_read;  // Track position
-  uv_buf_t iov = uv_buf_init(work->buffer, (unsigned int)bytes_read);
-  uv_fs_req_cleanup(req);
-  uv_fs_write(loop, req, work->flags, &iov, 1, -1, copyfile_write_cb);  // -1 = append
-}
-
-// Step 3: After fstat, start reading
-static void copyfile_fstat_cb(uv_fs_t* req) {
-  fs_async_work_t* work = (fs_async_work_t*)req;
-  JSContext* ctx = work->ctx;
-  uv_loop_t* loop = fs_get_uv_loop(ctx);
-
-  if (req->result < 0) {
-    // Stat error - close both fds
-    int err = -req->result;
-    uv_fs_t close_req;
-    uv_fs_close(loop, &close_req, work->flags, NULL);  // dest fd
-    uv_fs_req_cleanup(&close_req);
-    uv_fs_close(loop, &close_req, work->mode, NULL);  // src fd
-    uv_fs_req_cleanup(&close_req);
-
-    JSValue error = create_fs_error(ctx, err, "fstat", work->path);
-    JSValue args[1] = {error};
-    JSValue ret = JS_Call(ctx, work->callback, JS_UNDEFINED, 1, args);
-    JS_FreeValue(ctx, ret);
-    JS_FreeValue(ctx, error);
-    fs_async_work_free(work);
-    return;
-  }
-
-  // Get file size
-  uv_stat_t* statbuf = uv_fs_get_statbuf(req);
-  work->buffer_size = (size_t)statbuf->st_size;
-  work->offset = 0;  // Start at beginning
-
-  // Allocate buffer for copying (8KB chunks)
-  work->buffer = malloc(8192);
-  work->owns_buffer = 1;  // We allocated this buffer, must free it
-  if (!work->buffer) {
-    // Allocation failed - close both fds
-    uv_fs_t close_req;
-    uv_fs_close(loop, &close_req, work->flags, NULL);
-    uv_fs_req_cleanup(&close_req);
-    uv_fs_close(loop, &close_req, work->mode, NULL);
-    uv_fs_req_cleanup(&close_req);
-
-    JSValue error = JS_NewError(ctx);
-    JS_SetPropertyStr(ctx, error, "message", JS_NewString(ctx, "Failed to allocate buffer"));
-    JSValue args[1] = {error};
-    JSValue ret = JS_Call(ctx, work->callback, JS_UNDEFINED, 1, args);
-    JS_FreeValue(ctx, ret);
-    JS_FreeValue(ctx, error);
-    fs_async_work_free(work);
-    return;
-  }
-
-  // Start reading from source file
-  uv_buf_t iov = uv_buf_init(work->buffer, 8192);
-  uv_fs_req_cleanup(req);
-  uv_fs_read(loop, req, work->mode, &iov, 1, 0, copyfile_read_cb);  // Read from offset 0
-}
-
-// Step 2: Open destination file
-static void copyfile_open_dest_cb(uv_fs_t* req) {
-  fs_async_work_t* work = (fs_async_work_t*)req;
-  JSContext* ctx = work->ctx;
-  uv_loop_t* loop = fs_get_uv_loop(ctx);
-
-  if (req->result < 0) {
-    // Dest open error - close source fd
-    int err = -req->result;
-    uv_fs_t close_req;
-    uv_fs_close(loop, &close_req, work->mode, NULL);  // mode holds src fd
-    uv_fs_req_cleanup(&close_req);
-
-    JSValue error = create_fs_error(ctx, err, "open", work->path2);
-    JSValue args[1] = {error};
-    JSValue ret = JS_Call(ctx, work->callback, JS_UNDEFINED, 1, args);
-    JS_FreeValue(ctx, ret);
-    JS_FreeValue(ctx, error);
-    fs_async_work_free(work);
-    return;
+// fs.copyFile(src, dest[, mode], callback) - True async with libuv
+JSValue js_fs_copy_file_async(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
+  if (argc < 3) {
+    return JS_ThrowTypeError(ctx, "copyFile requires src, dest, and callback");
   }
 
-  // Store dest fd in flags field
-  work->flags = (int)req->result;
-
-  // Step 3: Get source file size
-  uv_fs_req_cleanup(req);
-  uv_fs_fstat(loop, req, work->mode, copyfile_fstat_cb);  // mode holds src fd
-}
-
-// Step 1: Open source file
-static void copyfile_open_src_cb(uv_fs_t* req) {
-  fs_async_work_t* work = (fs_async_work_t*)req;
-  JSContext* ctx = work->ctx;
-  uv_loop_t* loop = fs_get_uv_loop(ctx);
-
-  if (req->result < 0) {
-    // Source open error
-    int err = -req->result;
-    JSValue error = create_fs_error(ctx, err, "open", work->path);
-    JSValue args[1] = {error};
-    JSValue ret = JS_Call(ctx, work->callback, JS_UNDEFINED, 1, args);
-    JS_FreeValue(ctx, ret);
-    JS_FreeValue(ctx, error);
-    fs_async_work_free(work);
-    return;
+  // copyFile(src, dest, callback) or copyFile(src, dest, mode, callback)
+  JSValueConst callback = argc >= 4 ? argv[3] : argv[2];
+  if (!JS_IsFunction(ctx, callback)) {
+    return JS_ThrowTypeError(ctx, "callback must be a function");
   }
 
-  // Store source fd in mode field (reuse)
-  work->mode = (int)req->result;
-
-  // Step 2: Open destination file
-  uv_fs_req_cleanup(req);
-  uv_fs_open(loop, req, work->path2, O_WRONLY | O_CREAT | O_TRUNC, 0644, copyfile_open_dest_cb);
-}
-
-// fs.copyFile(src, dest, callback) - True async with libuv
-JSValue js_fs_copy_file_async(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
-  if (argc < 3) {
-    return JS_ThrowTypeError(ctx, "copyFile requires src, dest, and callback");
+  int flags = 0;
+  if (argc >= 4 && !JS_IsUndefined(argv[2]) && JS_ToInt32(ctx, &flags, argv[2]) < 0) {
+    return JS_EXCEPTION;
   }
 
   const char* src = JS_ToCString(ctx, argv[0]);
@@ -2295,12 +2100,6 @@ JSValue js_fs_copy_file_async(JSContext* ctx, JSValueConst this_val, int argc, J
     return JS_EXCEPTION;
   }
 
-  if (!JS_IsFunction(ctx, argv[2])) {
-    JS_FreeCString(ctx, src);
-    JS_FreeCString(ctx, dest);
-    return JS_ThrowTypeError(ctx, "callback must be a function");
-  }
-
   // Allocate work request
   fs_async_work_t* work = fs_async_work_new(ctx);
   if (!work) {
@@ -2309,25 +2108,19 @@ JSValue js_fs_copy_file_async(JSContext* ctx, JSValueConst this_val, int argc, J
     return JS_ThrowOutOfMemory(ctx);
   }
 
-  // Initialize work request
-  work->callback = JS_DupValue(ctx, argv[2]);
+  work->callback = JS_DupValue(ctx, callback);
   work->path = strdup(src);    // source path
   work->path2 = strdup(dest);  // destination path
-  work->buffer = NULL;         // Will be allocated after fstat
-  work->buffer_size = 0;
-  work->flags = 0;  // Will hold dest fd
-  work->mode = 0;   // Will hold src fd
-  work->offset = 0;
+  work->flags = flags;
 
   JS_FreeCString(ctx, src);
   JS_FreeCString(ctx, dest);
 
-  // Start async operation: Step 1 - open source file
   uv_loop_t* loop = fs_get_uv_loop(ctx);
-  int result = uv_fs_open(loop, &work->req, work->path, O_RDONLY, 0, copyfile_open_src_cb);
+  int result = uv_fs_copyfile(loop, &work->req, work->path, work->path2, flags, fs_async_complete_void);
 
   if (result < 0) {
-    JSValue error = create_fs_error(ctx, -result, "open", work->path);
+    JSValue error = create_fs_error(ctx, -result, "copyfile", work->path);
     JSValue args[1] = {error};
     JSValue ret = JS_Call(ctx, work->callback, JS_UNDEFINED, 1, args);
     JS_FreeValue(ctx, ret);
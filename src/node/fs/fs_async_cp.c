@@ -0,0 +1,410 @@
+#include <limits.h>
+#include "fs_async_libuv.h"
+
+// ============================================================================
+// cp: recursive copy on the threadpool
+//
+// Every directory entry is copied by its own chain of libuv requests, so all
+// threadpool workers copy a large tree at once instead of one file at a time.
+// Regular files go through uv_fs_copyfile, which tries a reflink (FICLONE) and
+// then copies in the kernel (copy_file_range/sendfile).
+// ============================================================================
+
+typedef struct {
+  JSContext* ctx;
+  JSValue callback;  // fs.cp() callback, or JS_UNDEFINED for fs.promises.cp()
+  JSValue resolve;
+  JSValue reject;
+  int copy_flags;  // UV_FS_COPYFILE_* for regular files
+  bool recursive;
+  bool force;
+  int pending;                // Entries still being copied
+  int error;                  // First error (negative libuv code), 0 if none
+  const char* error_syscall;  // Static string
+  char* error_path;
+  uv_work_t deferred;  // Reports an error found before any copy started
+} fs_cp_job_t;
+
+typedef struct {
+  uv_fs_t req;  // libuv fs request (MUST be first for casting)
+  fs_cp_job_t* job;
+  char* src;
+  char* dest;
+  uint64_t mode;   // st_mode of src
+  bool top_level;  // The path passed to cp(); only it is checked against an existing dest
+} fs_cp_entry_t;
+
+static void fs_cp_entry_start(fs_cp_entry_t* entry);
+
+static void fs_cp_job_free(fs_cp_job_t* job) {
+  JS_FreeValue(job->ctx, job->callback);
+  JS_FreeValue(job->ctx, job->resolve);
+  JS_FreeValue(job->ctx, job->reject);
+  free(job->error_path);
+  free(job);
+}
+
+static void fs_cp_job_finish(fs_cp_job_t* job) {
+  JSContext* ctx = job->ctx;
+  JSValue error = JS_NULL;
+  if (job->error < 0) {
+    error = create_fs_error(ctx, -job->error, job->error_syscall, job->error_path);
+  }
+
+  JSValue ret;
+  if (JS_IsFunction(ctx, job->callback)) {
+    ret = JS_Call(ctx, job->callback, JS_UNDEFINED, 1, &error);
+  } else if (job->error < 0) {
+    ret = JS_Call(ctx, job->reject, JS_UNDEFINED, 1, &error);
+  } else {
+    ret = JS_Call(ctx, job->resolve, JS_UNDEFINED, 0, NULL);
+  }
+  JS_FreeValue(ctx, ret);
+  JS_FreeValue(ctx, error);
+  fs_cp_job_free(job);
+}
+
+static fs_cp_entry_t* fs_cp_entry_new(fs_cp_job_t* job, const char* src, const char* dest) {
+  fs_cp_entry_t* entry = calloc(1, sizeof(fs_cp_entry_t));
+  if (!entry) {
+    return NULL;
+  }
+
+  entry->job = job;
+  entry->src = strdup(src);
+  entry->dest = strdup(dest);
+  if (!entry->src || !entry->dest) {
+    free(entry->src);
+    free(entry->dest);
+    free(entry);
+    return NULL;
+  }
+
+  job->pending++;
+  return entry;
+}
+
+// An entry is complete (result < 0 records the job's first error); the last one finishes the job
+static void fs_cp_entry_done(fs_cp_entry_t* entry, int result, const char* syscall, const char* path) {
+  fs_cp_job_t* job = entry->job;
+
+  if (result < 0 && job->error == 0) {
+    job->error = result;
+    job->error_syscall = syscall;
+    job->error_path = strdup(path);
+  }
+
+  uv_fs_req_cleanup(&entry->req);
+  free(entry->src);
+  free(entry->dest);
+  free(entry);
+
+  if (--job->pending == 0) {
+    fs_cp_job_finish(job);
+  }
+}
+
+static void fs_cp_on_copied(uv_fs_t* req) {
+  fs_cp_entry_t* entry = (fs_cp_entry_t*)req;
+  int result = (int)req->result;
+  fs_cp_entry_done(entry, result, "copyfile", entry->src);
+}
+
+static void fs_cp_on_symlink(uv_fs_t* req) {
+  fs_cp_entry_t* entry = (fs_cp_entry_t*)req;
+  int result = (int)req->result;
+  fs_cp_entry_done(entry, result, "symlink", entry->dest);
+}
+
+static void fs_cp_on_readlink(uv_fs_t* req) {
+  fs_cp_entry_t* entry = (fs_cp_entry_t*)req;
+  if (req->result < 0) {
+    fs_cp_entry_done(entry, (int)req->result, "readlink", entry->src);
+    return;
+  }
+
+  char* target = strdup((const char*)req->ptr);
+  uv_fs_req_cleanup(req);
+  if (!target) {
+    fs_cp_entry_done(entry, UV_ENOMEM, "readlink", entry->src);
+    return;
+  }
+
+  int result = uv_fs_symlink(req->loop, req, target, entry->dest, 0, fs_cp_on_symlink);
+  free(target);
+  if (result < 0) {
+    fs_cp_entry_done(entry, result, "symlink", entry->dest);
+  }
+}
+
+// Start a child entry for every directory member, then complete the directory itself
+static void fs_cp_on_scandir(uv_fs_t* req) {
+  fs_cp_entry_t* entry = (fs_cp_entry_t*)req;
+  fs_cp_job_t* job = entry->job;
+  if (req->result < 0) {
+    fs_cp_entry_done(entry, (int)req->result, "scandir", entry->src);
+    return;
+  }
+
+  uv_dirent_t dirent;
+  while (job->error == 0 && uv_fs_scandir_next(req, &dirent) != UV_EOF) {
+    char src_path[PATH_MAX];
+    char dest_path[PATH_MAX];
+    int src_len = snprintf(src_path, sizeof(src_path), "%s/%s", entry->src, dirent.name);
+    int dest_len = snprintf(dest_path, sizeof(dest_path), "%s/%s", entry->dest, dirent.name);
+    if (src_len >= (int)sizeof(src_path) || dest_len >= (int)sizeof(dest_path)) {
+      fs_cp_entry_done(entry, UV_ENAMETOOLONG, "cp", entry->src);
+      return;
+    }
+
+    fs_cp_entry_t* child = fs_cp_entry_new(job, src_path, dest_path);
+    if (!child) {
+      fs_cp_entry_done(entry, UV_ENOMEM, "cp", entry->src);
+      return;
+    }
+    fs_cp_entry_start(child);
+  }
+
+  fs_cp_entry_done(entry, 0, NULL, NULL);
+}
+
+static void fs_cp_on_mkdir(uv_fs_t* req) {
+  fs_cp_entry_t* entry = (fs_cp_entry_t*)req;
+  if (req->result < 0 && req->result != UV_EEXIST) {
+    fs_cp_entry_done(entry, (int)req->result, "mkdir", entry->dest);
+    return;
+  }
+
+  uv_fs_req_cleanup(req);
+  int result = uv_fs_scandir(req->loop, req, entry->src, 0, fs_cp_on_scandir);
+  if (result < 0) {
+    fs_cp_entry_done(entry, result, "scandir", entry->src);
+  }
+}
+
+// Copy entry according to the type of src
+static void fs_cp_entry_copy(fs_cp_entry_t* entry) {
+  fs_cp_job_t* job = entry->job;
+  uv_loop_t* loop = fs_get_uv_loop(job->ctx);
+  int result = 0;
+  const char* syscall = "cp";
+  const char* path = entry->src;
+
+  uv_fs_req_cleanup(&entry->req);
+  if (S_ISDIR(entry->mode)) {
+    if (!job->recursive) {
+      fs_cp_entry_done(entry, UV_EISDIR, "cp", entry->src);
+      return;
+    }
+    syscall = "mkdir";
+    path = entry->dest;
+    result = uv_fs_mkdir(loop, &entry->req, entry->dest, (int)(entry->mode & 0777), fs_cp_on_mkdir);
+  } else if (S_ISREG(entry->mode)) {
+    syscall = "copyfile";
+    result = uv_fs_copyfile(loop, &entry->req, entry->src, entry->dest, job->copy_flags, fs_cp_on_copied);
+#ifndef _WIN32
+  } else if (S_ISLNK(entry->mode)) {
+    syscall = "readlink";
+    result = uv_fs_readlink(loop, &entry->req, entry->src, fs_cp_on_readlink);
+#endif
+  } else {
+    // Sockets, FIFOs and devices are skipped, as in cpSync()
+    fs_cp_entry_done(entry, 0, NULL, NULL);
+    return;
+  }
+
+  if (result < 0) {
+    fs_cp_entry_done(entry, result, syscall, path);
+  }
+}
+
+static void fs_cp_on_dest_lstat(uv_fs_t* req) {
+  fs_cp_entry_t* entry = (fs_cp_entry_t*)req;
+  if (req->result == 0) {
+    fs_cp_entry_done(entry, UV_EEXIST, "cp", entry->dest);
+    return;
+  }
+  fs_cp_entry_copy(entry);
+}
+
+static void fs_cp_on_lstat(uv_fs_t* req) {
+  fs_cp_entry_t* entry = (fs_cp_entry_t*)req;
+  if (req->result < 0) {
+    fs_cp_entry_done(entry, (int)req->result, "lstat", entry->src);
+    return;
+  }
+
+  entry->mode = uv_fs_get_statbuf(req)->st_mode;
+
+  // Without force an existing destination is an error (children overwrite, as in cpSync())
+  if (entry->top_level && !entry->job->force) {
+    uv_fs_req_cleanup(req);
+    int result = uv_fs_lstat(req->loop, req, entry->dest, fs_cp_on_dest_lstat);
+    if (result < 0) {
+      fs_cp_entry_done(entry, result, "lstat", entry->dest);
+    }
+    return;
+  }
+
+  fs_cp_entry_copy(entry);
+}
+
+static void fs_cp_entry_start(fs_cp_entry_t* entry) {
+  int result = uv_fs_lstat(fs_get_uv_loop(entry->job->ctx), &entry->req, entry->src, fs_cp_on_lstat);
+  if (result < 0) {
+    fs_cp_entry_done(entry, result, "lstat", entry->src);
+  }
+}
+
+// Nothing runs on the threadpool: the round trip only delays the callback past cp()'s return
+static void fs_cp_deferred_work(uv_work_t* req) {
+  (void)req;
+}
+
+static void fs_cp_deferred_done(uv_work_t* req, int status) {
+  (void)status;
+  fs_cp_job_finish((fs_cp_job_t*)req->data);
+}
+
+// Absolute form of path without ".", ".." or repeated slashes, as path.resolve(). NULL on failure
+static char* fs_cp_resolve(const char* path) {
+  char cwd[PATH_MAX] = "";
+  if (path[0] != '/') {
+    size_t cwd_len = sizeof(cwd);
+    if (uv_cwd(cwd, &cwd_len) < 0) {
+      return NULL;
+    }
+  }
+
+  size_t size = strlen(cwd) + strlen(path) + 3;
+  char* joined = malloc(size);
+  char* resolved = malloc(size);
+  if (!joined || !resolved) {
+    free(joined);
+    free(resolved);
+    return NULL;
+  }
+  snprintf(joined, size, "%s/%s", cwd, path);
+
+  size_t len = 0;
+  for (const char* p = joined; *p;) {
+    while (*p == '/') {
+      p++;
+    }
+    const char* segment = p;
+    while (*p && *p != '/') {
+      p++;
+    }
+    size_t segment_len = (size_t)(p - segment);
+    if (segment_len == 0 || (segment_len == 1 && segment[0] == '.')) {
+      continue;
+    }
+    if (segment_len == 2 && segment[0] == '.' && segment[1] == '.') {
+      while (len > 0 && resolved[--len] != '/') {
+      }
+      continue;
+    }
+    resolved[len++] = '/';
+    memcpy(resolved + len, segment, segment_len);
+    len += segment_len;
+  }
+  if (len == 0) {
+    resolved[len++] = '/';
+  }
+  resolved[len] = '\0';
+
+  free(joined);
+  return resolved;
+}
+
+JSValue fs_cp_async_start(JSContext* ctx, int argc, JSValueConst* argv, JSValue callback, JSValue resolve,
+                          JSValue reject) {
+  fs_cp_job_t* job = calloc(1, sizeof(fs_cp_job_t));
+  if (!job) {
+    JS_FreeValue(ctx, callback);
+    JS_FreeValue(ctx, resolve);
+    JS_FreeValue(ctx, reject);
+    return JS_ThrowOutOfMemory(ctx);
+  }
+
+  job->ctx = ctx;
+  job->callback = callback;
+  job->resolve = resolve;
+  job->reject = reject;
+
+  // Parse options
+  if (argc > 2 && JS_IsObject(argv[2])) {
+    JSValue recursive_val = JS_GetPropertyStr(ctx, argv[2], "recursive");
+    if (JS_IsBool(recursive_val)) {
+      job->recursive = JS_ToBool(ctx, recursive_val);
+    }
+    JS_FreeValue(ctx, recursive_val);
+
+    JSValue force_val = JS_GetPropertyStr(ctx, argv[2], "force");
+    if (JS_IsBool(force_val)) {
+      job->force = JS_ToBool(ctx, force_val);
+    }
+    JS_FreeValue(ctx, force_val);
+
+    JSValue mode_val = JS_GetPropertyStr(ctx, argv[2], "mode");
+    if (JS_IsNumber(mode_val)) {
+      JS_ToInt32(ctx, &job->copy_flags, mode_val);
+    }
+    JS_FreeValue(ctx, mode_val);
+  }
+
+  const char* src = JS_ToCString(ctx, argv[0]);
+  const char* dest = src ? JS_ToCString(ctx, argv[1]) : NULL;
+  if (!dest) {
+    JS_FreeCString(ctx, src);
+    fs_cp_job_free(job);
+    return JS_EXCEPTION;
+  }
+
+  // Copying a directory into itself would never terminate. Compare resolved paths, so that `a` and
+  // `./a/b` are caught as well
+  char* resolved_src = fs_cp_resolve(src);
+  char* resolved_dest = fs_cp_resolve(dest);
+  bool into_itself = false;
+  if (resolved_src && resolved_dest) {
+    size_t src_len = strlen(resolved_src);
+    into_itself = strncmp(resolved_dest, resolved_src, src_len) == 0 &&
+                  (src_len == 1 || resolved_dest[src_len] == '/' || resolved_dest[src_len] == '\0');
+  }
+
+  fs_cp_entry_t* entry = resolved_src && resolved_dest && !into_itself ? fs_cp_entry_new(job, src, dest) : NULL;
+  free(resolved_src);
+  free(resolved_dest);
+  if (!entry) {
+    // Report through the callback/promise like any other copy failure, never before cp() returns
+    job->error = into_itself ? UV_EINVAL : UV_ENOMEM;
+    job->error_syscall = "cp";
+    job->error_path = strdup(dest);
+    job->deferred.data = job;
+    if (uv_queue_work(fs_get_uv_loop(ctx), &job->deferred, fs_cp_deferred_work, fs_cp_deferred_done) < 0) {
+      fs_cp_job_finish(job);
+    }
+  } else {
+    entry->top_level = true;
+    fs_cp_entry_start(entry);
+  }
+
+  JS_FreeCString(ctx, src);
+  JS_FreeCString(ctx, dest);
+  return JS_UNDEFINED;
+}
+
+// fs.cp(src, dest[, options], callback)
+JSValue js_fs_cp_async(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
+  if (argc < 3) {
+    return JS_ThrowTypeError(ctx, "cp requires src, dest, and callback");
+  }
+
+  JSValueConst callback = argc >= 4 ? argv[3] : argv[2];
+  if (!JS_IsFunction(ctx, callback)) {
+    return JS_ThrowTypeError(ctx, "callback must be a function");
+  }
+
+  JSValueConst cp_args[3] = {argv[0], argv[1], argc >= 4 ? argv[2] : JS_UNDEFINED};
+  return fs_cp_async_start(ctx, 3, cp_args, JS_DupValue(ctx, callback), JS_UNDEFINED, JS_UNDEFINED);
+}
@@ -8,6 +8,13 @@ uv_loop_t* fs_get_uv_loop(JSContext* ctx) {
   return jsrt_rt->uv_loop;
 }
 
+int fs_copyfile_sync(JSContext* ctx, const char* src, const char* dest, int flags) {
+  uv_fs_t req;
+  int result = uv_fs_copyfile(fs_get_uv_loop(ctx), &req, src, dest, flags, NULL);
+  uv_fs_req_cleanup(&req);
+  return result;
+}
+
 // Allocate and initialize async work structure with proper JSValue initialization
 fs_async_work_t* fs_async_work_new(JSContext* ctx) {
   fs_async_work_t* work = calloc(1, sizeof(fs_async_work_t));
@@ -133,6 +140,9 @@ void fs_async_complete_void(uv_fs_t* req) {
       case UV_FS_ACCESS:
         syscall = "access";
         break;
+      case UV_FS_COPYFILE:
+        syscall = "copyfile";
+        break;
       default:
         break;
     }
@@ -42,4 +42,14 @@ void fs_async_complete_statfs(uv_fs_t* req);   // statfs with filesystem statist
 // Helper to get uv_loop from context
 uv_loop_t* fs_get_uv_loop(JSContext* ctx);
 
+// Copy one file on the calling thread with uv_fs_copyfile (reflink first, then copy_file_range/sendfile).
+// flags are UV_FS_COPYFILE_* (the fs.constants.COPYFILE_* values); returns 0 or a negative libuv error.
+int fs_copyfile_sync(JSContext* ctx, const char* src, const char* dest, int flags);
+
+// Recursive copy for fs.cp()/fs.promises.cp() (fs_async_cp.c), spread over the threadpool.
+// Completion calls callback(err) when it is a function and resolve()/reject(err) otherwise;
+// takes ownership of all three values. argv is (src, dest[, options]).
+JSValue fs_cp_async_start(JSContext* ctx, int argc, JSValueConst* argv, JSValue callback, JSValue resolve,
+                          JSValue reject);
+
 #endif  // JSRT_NODE_FS_ASYNC_LIBUV_H
@@ -1,8 +1,5 @@
 #include "fs_common.h"
 
-// Forward declaration
-static JSValue js_buffer_to_string_simple(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv);
-
 // Helper function to create directories recursively
 int mkdir_recursive(const char* path, mode_t mode) {
   char* path_copy = strdup(path);
@@ -79,59 +76,9 @@ const char* errno_to_node_code(int err) {
   }
 }
 
-// Helper to create a Buffer object with proper _isBuffer flag
+// Helper to create a Buffer holding a copy of data
 JSValue create_buffer_from_data(JSContext* ctx, const uint8_t* data, size_t size) {
-  // Create an ArrayBuffer with the data
-  JSValue array_buffer = JS_NewArrayBufferCopy(ctx, data, size);
-  if (JS_IsException(array_buffer)) {
-    return JS_EXCEPTION;
-  }
-
-  // Create Uint8Array from ArrayBuffer
-  JSValue global = JS_GetGlobalObject(ctx);
-  JSValue uint8_array_ctor = JS_GetPropertyStr(ctx, global, "Uint8Array");
-  JSValue uint8_array = JS_CallConstructor(ctx, uint8_array_ctor, 1, &array_buffer);
-
-  // Add Buffer-specific properties
-  if (!JS_IsException(uint8_array)) {
-    // Add a special marker to identify this as a Buffer
-    JS_SetPropertyStr(ctx, uint8_array, "_isBuffer", JS_TRUE);
-
-    // Add toString method (simplified version)
-    JSValue toString_func = JS_NewCFunction(ctx, js_buffer_to_string_simple, "toString", 1);
-    JS_SetPropertyStr(ctx, uint8_array, "toString", toString_func);
-  }
-
-  JS_FreeValue(ctx, array_buffer);
-  JS_FreeValue(ctx, uint8_array_ctor);
-  JS_FreeValue(ctx, global);
-  return uint8_array;
-}
-
-// Simple toString implementation for Buffer
-static JSValue js_buffer_to_string_simple(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
-  size_t size;
-  uint8_t* data = JS_GetArrayBuffer(ctx, &size, this_val);
-  if (!data) {
-    // Try to get as TypedArray
-    size_t byte_offset;
-    JSValue array_buffer = JS_GetTypedArrayBuffer(ctx, this_val, &byte_offset, &size, NULL);
-    if (!JS_IsException(array_buffer)) {
-      size_t buffer_size;
-      uint8_t* buffer = JS_GetArrayBuffer(ctx, &buffer_size, array_buffer);
-      JS_FreeValue(ctx, array_buffer);
-      if (buffer) {
-        data = buffer + byte_offset;
-      }
-    }
-  }
-
-  if (!data) {
-    return JS_ThrowTypeError(ctx, "Invalid buffer");
-  }
-
-  // Convert bytes to string (assuming UTF-8)
-  return JS_NewStringLen(ctx, (const char*)data, size);
+  return jsrt_node_buffer_from_data(ctx, data, size);
 }
 
 // Helper to create Node.js fs error
@@ -1,4 +1,4 @@
-#include "fs_common.h"
+#include "fs_async_libuv.h"
 
 // Forward declarations for async functions (libuv-based in fs_async_core.c)
 extern JSValue js_fs_read_file_async(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv);
@@ -170,6 +170,10 @@ JSValue JSRT_InitNodeFs(JSContext* ctx) {
   JS_SetPropertyStr(ctx, constants, "R_OK", JS_NewInt32(ctx, R_OK));
   JS_SetPropertyStr(ctx, constants, "W_OK", JS_NewInt32(ctx, W_OK));
   JS_SetPropertyStr(ctx, constants, "X_OK", JS_NewInt32(ctx, X_OK));
+  // copyFile()/cp() modes, passed straight through to uv_fs_copyfile()
+  JS_SetPropertyStr(ctx, constants, "COPYFILE_EXCL", JS_NewInt32(ctx, UV_FS_COPYFILE_EXCL));
+  JS_SetPropertyStr(ctx, constants, "COPYFILE_FICLONE", JS_NewInt32(ctx, UV_FS_COPYFILE_FICLONE));
+  JS_SetPropertyStr(ctx, constants, "COPYFILE_FICLONE_FORCE", JS_NewInt32(ctx, UV_FS_COPYFILE_FICLONE_FORCE));
   JS_SetPropertyStr(ctx, fs_module, "constants", constants);
 
   // Phase 3: Promise API namespace
@@ -2512,8 +2512,19 @@ JSValue js_fs_promises_cp(JSContext* ctx, JSValueConst this_val, int argc, JSVal
     return JS_ThrowTypeError(ctx, "cp requires src and dest");
   }
 
-  // Call cpSync and wrap in Promise
-  return run_sync_as_promise(ctx, js_fs_cp_sync, argc, argv);
+  JSValue resolving_funcs[2];
+  JSValue promise = JS_NewPromiseCapability(ctx, resolving_funcs);
+  if (JS_IsException(promise)) {
+    return JS_EXCEPTION;
+  }
+
+  // Copied on the threadpool; resolve/reject are released when the copy completes
+  JSValue result = fs_cp_async_start(ctx, argc, argv, JS_UNDEFINED, resolving_funcs[0], resolving_funcs[1]);
+  if (JS_IsException(result)) {
+    JS_FreeValue(ctx, promise);
+    return JS_EXCEPTION;
+  }
+  return promise;
 }
 
 // ============================================================================
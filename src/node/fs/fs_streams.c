@@ -3,6 +3,11 @@
  *
  * This module provides streaming file I/O compatible with Node.js fs.createReadStream()
  * and fs.createWriteStream() APIs, with full pipe() support and backpressure handling.
+ *
+ * All file I/O runs on the libuv threadpool, so a slow disk never blocks the event loop.
+ * A read stream keeps at most highWaterMark bytes read ahead of its consumer and hands
+ * each read buffer to JS without copying it; a write stream gathers the chunks queued
+ * while a write is in flight into a single vectored write.
  */
 
 #include <errno.h>
@@ -10,251 +15,579 @@
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
+#include <uv.h>
+#include "../../util/buffer_pin.h"
 #include "../stream/stream_internal.h"
+#include "fs_async_libuv.h"
 #include "fs_common.h"
 
 // Forward declaration
 extern void js_std_dump_error(JSContext* ctx);
 
-// ReadStream context - stores file descriptor and read state
+// Reads shorter than 1/8 of the read buffer are copied so the buffer can be reused right away
+#define FS_READ_COPY_DIVISOR 8
+
+// Read buffers shared by a read stream and the Buffers it handed to JS
 typedef struct {
-  int fd;
-  bool auto_close;
-  bool closed;
-  char* path;
-  uint64_t bytes_read;
-  uint64_t start;
-  uint64_t end;
-  uint64_t pos;
-} FSReadStreamContext;
+  int refs;        // One for the stream, one per handed-out buffer still alive
+  size_t size;     // Capacity of every buffer (the stream's highWaterMark)
+  uint8_t* spare;  // A buffer JS released, kept for the next read
+} FSReadBufferPool;
 
-// WriteStream context - stores file descriptor and write state
+// A chunk passed to write(); its bytes stay owned by JS until the write completes
 typedef struct {
-  int fd;
+  JSValue pinned;    // ArrayBuffer or view backing a binary chunk (JS_UNDEFINED otherwise)
+  const char* cstr;  // JS_ToCStringLen result backing a string chunk
+  JSValue callback;  // write() callback (JS_UNDEFINED if none)
+  uv_buf_t buf;
+  const void* store;  // Store behind pinned, kept from being detached (JSRT_BufferPin) until the write completes
+} FSWriteChunk;
+
+// State shared by read and write streams, stored in the stream's "__fs_context" holder
+typedef struct {
+  uv_fs_t req;     // The single read, write or close in flight
+  JSContext* ctx;  // QuickJS context
+  JSValue stream;  // Held while req is in flight so the stream outlives it
+  uv_file fd;
   bool auto_close;
+  bool busy;     // req is in flight
+  bool closing;  // Close requested or started
   bool closed;
   char* path;
+  int64_t pos;  // File offset of the next read/write, -1 to use the current position
+
+  // Read stream
+  FSReadBufferPool* pool;
+  uint8_t* read_buf;  // Target of the read in flight
+  int64_t end;        // Exclusive end offset, -1 for no limit
+  uint64_t bytes_read;
+
+  // Write stream
+  FSWriteChunk* queue;  // Chunks written while another write was in flight
+  size_t queue_count;
+  size_t queue_capacity;
+  FSWriteChunk* inflight;  // Chunks covered by the write in flight
+  size_t inflight_count;
+  uv_buf_t* bufs;        // iovecs for inflight, advanced past partial writes
+  size_t buf_index;      // First iovec not yet fully written
+  size_t pending_bytes;  // Queued plus in-flight bytes (writableLength)
   uint64_t bytes_written;
-  uint64_t start;
-  uint64_t pos;
-} FSWriteStreamContext;
+  bool ending;  // end() was called
+} FSStreamContext;
+
+static JSClassID js_fs_stream_context_class_id;
+
+static void fs_read_buffer_pool_unref(FSReadBufferPool* pool) {
+  if (--pool->refs == 0) {
+    free(pool->spare);
+    free(pool);
+  }
+}
 
-// Free FSReadStreamContext
-static void free_read_context(FSReadStreamContext* ctx) {
-  if (!ctx)
+// ArrayBuffer free function: keep one released buffer for reuse while the stream still reads. A
+// detached buffer is finalized later with ptr == NULL, after its reference was already dropped.
+static void fs_read_buffer_free(JSRuntime* rt, void* opaque, void* ptr) {
+  FSReadBufferPool* pool = opaque;
+  if (!ptr) {
     return;
-  if (ctx->path) {
-    free(ctx->path);
   }
-  if (ctx->fd >= 0 && ctx->auto_close && !ctx->closed) {
-    close(ctx->fd);
+  if (!pool->spare && pool->refs > 1) {
+    pool->spare = ptr;
+  } else {
+    free(ptr);
+  }
+  fs_read_buffer_pool_unref(pool);
+}
+
+static void fs_write_chunk_free(JSContext* ctx, FSWriteChunk* chunk) {
+  JSRT_BufferUnpin(chunk->store);
+  JS_FreeValue(ctx, chunk->pinned);
+  JS_FreeValue(ctx, chunk->callback);
+  if (chunk->cstr) {
+    JS_FreeCString(ctx, chunk->cstr);
   }
-  free(ctx);
 }
 
-// Free FSWriteStreamContext
-static void free_write_context(FSWriteStreamContext* ctx) {
-  if (!ctx)
+static void js_fs_stream_context_finalizer(JSRuntime* rt, JSValue val) {
+  FSStreamContext* fs = JS_GetOpaque(val, js_fs_stream_context_class_id);
+  if (!fs) {
     return;
-  if (ctx->path) {
-    free(ctx->path);
   }
-  if (ctx->fd >= 0 && ctx->auto_close && !ctx->closed) {
-    close(ctx->fd);
+
+  // Never reached while busy: the request holds the stream, which holds this object.
+  // Write chunks are only queued while busy, so the queue is empty here.
+  if (fs->fd >= 0 && fs->auto_close && !fs->closed) {
+    close(fs->fd);
+  }
+  free(fs->queue);
+  if (fs->pool) {
+    fs_read_buffer_pool_unref(fs->pool);
   }
-  free(ctx);
+  free(fs->path);
+  free(fs);
 }
 
-// Read method for ReadStream - reads from file
-static JSValue js_fs_read_stream_read(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
-  // Get stream data
-  JSStreamData* stream = js_stream_get_data(ctx, this_val, js_readable_class_id);
-  if (!stream) {
-    return JS_ThrowTypeError(ctx, "Not a readable stream");
+static JSClassDef js_fs_stream_context_class = {
+    "FSStreamContext",
+    .finalizer = js_fs_stream_context_finalizer,
+};
+
+// Initialize the context holder class (once per runtime)
+static void ensure_fs_stream_context_class_initialized(JSContext* ctx) {
+  JS_NewClassID(&js_fs_stream_context_class_id);
+  if (!JS_IsRegisteredClass(JS_GetRuntime(ctx), js_fs_stream_context_class_id)) {
+    JS_NewClass(JS_GetRuntime(ctx), js_fs_stream_context_class_id, &js_fs_stream_context_class);
+  }
+}
+
+static FSStreamContext* fs_stream_get_context(JSContext* ctx, JSValueConst stream) {
+  JSValue holder = JS_GetPropertyStr(ctx, stream, "__fs_context");
+  FSStreamContext* fs = JS_GetOpaque(holder, js_fs_stream_context_class_id);
+  JS_FreeValue(ctx, holder);
+  return fs;
+}
+
+// Start tracking a request on fs->req; the stream stays alive until fs_stream_end_request
+static void fs_stream_begin_request(FSStreamContext* fs, JSValueConst stream) {
+  fs->stream = JS_DupValue(fs->ctx, stream);
+  fs->busy = true;
+}
+
+// Returns the stream held by the finished request; the caller frees it
+static JSValue fs_stream_end_request(FSStreamContext* fs) {
+  JSValue stream = fs->stream;
+  fs->stream = JS_UNDEFINED;
+  fs->busy = false;
+  uv_fs_req_cleanup(&fs->req);
+  return stream;
+}
+
+static void fs_stream_emit_error(JSContext* ctx, JSValueConst stream, int err, const char* syscall,
+                                 const char* path) {
+  JSValue error = create_fs_error(ctx, err, syscall, path);
+  stream_emit(ctx, stream, "error", 1, &error);
+  JS_FreeValue(ctx, error);
+}
+
+static void fs_stream_on_close(uv_fs_t* req) {
+  FSStreamContext* fs = (FSStreamContext*)req;
+  JSContext* ctx = fs->ctx;
+  int result = (int)req->result;
+  JSValue stream = fs_stream_end_request(fs);
+
+  JSStreamData* data = js_stream_get_data(ctx, stream, js_readable_class_id);
+  if (!data) {
+    data = js_stream_get_data(ctx, stream, js_writable_class_id);
+  }
+
+  if (result < 0) {
+    fs_stream_emit_error(ctx, stream, -result, "close", fs->path);
+  }
+
+  // A write stream finishes once its data is flushed and the descriptor is closed
+  if (fs->ending && data && !data->writable_finished) {
+    data->writable_finished = true;
+    stream_emit(ctx, stream, "finish", 0, NULL);
+  }
+
+  if (data && data->options.emitClose) {
+    stream_emit(ctx, stream, "close", 0, NULL);
+  }
+  JS_FreeValue(ctx, stream);
+}
+
+// Close the descriptor on the threadpool (autoClose); 'close' is emitted once it is done
+static void fs_stream_close(FSStreamContext* fs, JSValueConst stream) {
+  fs->closing = true;
+  if (fs->busy || fs->closed || fs->fd < 0 || !fs->auto_close) {
+    return;
+  }
+
+  fs->closed = true;
+  fs_stream_begin_request(fs, stream);
+  int result = uv_fs_close(fs_get_uv_loop(fs->ctx), &fs->req, fs->fd, fs_stream_on_close);
+  if (result < 0) {
+    JSValue held = fs_stream_end_request(fs);
+    fs_stream_emit_error(fs->ctx, held, -result, "close", fs->path);
+    JS_FreeValue(fs->ctx, held);
+  }
+}
+
+// Read stream
+
+static void fs_read_stream_start(FSStreamContext* fs, JSValueConst stream);
+
+// Keep the read buffer for the next read unless JS already returned a spare one
+static void fs_read_stream_recycle(FSStreamContext* fs) {
+  if (!fs->read_buf) {
+    return;
+  }
+  if (!fs->pool->spare) {
+    fs->pool->spare = fs->read_buf;
+  } else {
+    free(fs->read_buf);
   }
+  fs->read_buf = NULL;
+}
 
-  // Get file context from stream's private data (stored as property)
-  JSValue ctx_val = JS_GetPropertyStr(ctx, this_val, "__fs_context");
-  if (JS_IsUndefined(ctx_val)) {
-    return JS_NULL;
+// Wrap the bytes just read as a Buffer (or a string once an encoding is set)
+static JSValue fs_read_stream_take_chunk(JSContext* ctx, FSStreamContext* fs, JSStreamData* data, size_t len) {
+  if (data->options.encoding) {
+    JSValue str = JS_NewStringLen(ctx, (const char*)fs->read_buf, len);
+    fs_read_stream_recycle(fs);
+    return str;
   }
 
-  FSReadStreamContext* fs_ctx = JS_GetOpaque(ctx_val, 0);
-  JS_FreeValue(ctx, ctx_val);
+  // Short reads would pin a mostly empty buffer, so copy them and keep the buffer
+  if (len < fs->pool->size / FS_READ_COPY_DIVISOR) {
+    JSValue chunk = create_buffer_from_data(ctx, fs->read_buf, len);
+    fs_read_stream_recycle(fs);
+    return chunk;
+  }
 
-  if (!fs_ctx || fs_ctx->fd < 0 || fs_ctx->closed) {
-    return JS_NULL;
+  JSValue array_buffer = JS_NewArrayBuffer(ctx, fs->read_buf, len, fs_read_buffer_free, fs->pool, false);
+  if (JS_IsException(array_buffer)) {
+    return JS_EXCEPTION;
   }
+  fs->pool->refs++;
+  fs->read_buf = NULL;
 
-  // If we have buffered data, return it first
-  if (stream->buffer_size > 0) {
-    JSValue data = stream->buffered_data[0];
-    // Shift buffer
-    for (size_t i = 1; i < stream->buffer_size; i++) {
-      stream->buffered_data[i - 1] = stream->buffered_data[i];
+  JSValue chunk = jsrt_node_buffer_view(ctx, array_buffer, 0, len);
+  JS_FreeValue(ctx, array_buffer);
+  return chunk;
+}
+
+static void fs_read_stream_push_end(FSStreamContext* fs, JSValueConst stream) {
+  JSValue eof = JS_NULL;
+  JS_FreeValue(fs->ctx, js_readable_push(fs->ctx, stream, 1, &eof));
+  fs_stream_close(fs, stream);
+}
+
+static void fs_read_stream_on_read(uv_fs_t* req) {
+  FSStreamContext* fs = (FSStreamContext*)req;
+  JSContext* ctx = fs->ctx;
+  ssize_t result = req->result;
+  JSValue stream = fs_stream_end_request(fs);
+  JSStreamData* data = js_stream_get_data(ctx, stream, js_readable_class_id);
+  bool delivered = result > 0 && data && !data->destroyed && !fs->closing;
+
+  // Only a chunk goes to JS; otherwise give the buffer back before anything below can start the next read
+  if (!delivered) {
+    fs_read_stream_recycle(fs);
+  }
+
+  if (!data || data->destroyed || fs->closing) {
+    fs_stream_close(fs, stream);
+  } else if (result < 0) {
+    fs_stream_emit_error(ctx, stream, (int)-result, "read", fs->path);
+    fs_stream_close(fs, stream);
+  } else if (result == 0) {
+    fs_read_stream_push_end(fs, stream);
+  } else {
+    fs->pos += result;
+    fs->bytes_read += result;
+    JS_SetPropertyStr(ctx, stream, "bytesRead", JS_NewInt64(ctx, (int64_t)fs->bytes_read));
+
+    JSValue chunk = fs_read_stream_take_chunk(ctx, fs, data, (size_t)result);
+    if (JS_IsException(chunk)) {
+      fs_read_stream_recycle(fs);
+      JSValue error = JS_GetException(ctx);
+      stream_emit(ctx, stream, "error", 1, &error);
+      JS_FreeValue(ctx, error);
+      fs_stream_close(fs, stream);
+    } else {
+      JS_FreeValue(ctx, js_readable_push(ctx, stream, 1, &chunk));
+      JS_FreeValue(ctx, chunk);
+
+      // Keep reading only while the consumer keeps up; otherwise read() or resume() asks again
+      if (fs->end >= 0 && fs->pos >= fs->end) {
+        fs_read_stream_push_end(fs, stream);
+      } else if (data->flowing && data->buffer_size == 0) {
+        fs_read_stream_start(fs, stream);
+      }
     }
-    stream->buffer_size--;
-    return data;
   }
 
-  // Read from file
-  size_t chunk_size = stream->options.highWaterMark > 0 ? stream->options.highWaterMark : 65536;
+  JS_FreeValue(ctx, stream);
+}
+
+// Issue the next read unless one is in flight or unread data is already buffered
+static void fs_read_stream_start(FSStreamContext* fs, JSValueConst stream) {
+  JSStreamData* data = js_stream_get_data(fs->ctx, stream, js_readable_class_id);
+  if (!data || fs->busy || fs->closing || data->ended || data->destroyed || data->buffer_size > 0) {
+    return;
+  }
 
-  // Check if we've reached the end position
-  if (fs_ctx->end > 0 && fs_ctx->pos >= fs_ctx->end) {
-    // Close file if autoClose is true
-    if (fs_ctx->auto_close && !fs_ctx->closed) {
-      close(fs_ctx->fd);
-      fs_ctx->closed = true;
+  size_t len = fs->pool->size;
+  if (fs->end >= 0) {
+    if (fs->pos >= fs->end) {
+      fs_read_stream_push_end(fs, stream);
+      return;
+    }
+    if ((uint64_t)(fs->end - fs->pos) < len) {
+      len = (size_t)(fs->end - fs->pos);
     }
-    stream->ended = true;
-    stream_emit(ctx, this_val, "end", 0, NULL);
-    return JS_NULL;
   }
 
-  // Limit chunk size to not exceed end position
-  if (fs_ctx->end > 0) {
-    uint64_t remaining = fs_ctx->end - fs_ctx->pos;
-    if (chunk_size > remaining) {
-      chunk_size = remaining;
+  if (fs->pool->spare) {
+    fs->read_buf = fs->pool->spare;
+    fs->pool->spare = NULL;
+  } else {
+    fs->read_buf = malloc(fs->pool->size);
+    if (!fs->read_buf) {
+      JSValue error = JS_NewError(fs->ctx);
+      JS_SetPropertyStr(fs->ctx, error, "message", JS_NewString(fs->ctx, "Out of memory"));
+      stream_emit(fs->ctx, stream, "error", 1, &error);
+      JS_FreeValue(fs->ctx, error);
+      return;
     }
   }
 
-  uint8_t* buffer = malloc(chunk_size);
-  if (!buffer) {
-    return JS_ThrowOutOfMemory(ctx);
+  uv_buf_t iov = uv_buf_init((char*)fs->read_buf, (unsigned int)len);
+  fs_stream_begin_request(fs, stream);
+  int result = uv_fs_read(fs_get_uv_loop(fs->ctx), &fs->req, fs->fd, &iov, 1, fs->pos, fs_read_stream_on_read);
+  if (result < 0) {
+    JSValue held = fs_stream_end_request(fs);
+    fs_read_stream_recycle(fs);
+    fs_stream_emit_error(fs->ctx, held, -result, "read", fs->path);
+    fs_stream_close(fs, held);
+    JS_FreeValue(fs->ctx, held);
   }
+}
 
-  ssize_t bytes_read = read(fs_ctx->fd, buffer, chunk_size);
+// ReadStream._read(size) - called by the Readable whenever it wants more data
+static JSValue js_fs_read_stream_read(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
+  FSStreamContext* fs = fs_stream_get_context(ctx, this_val);
+  if (fs) {
+    fs_read_stream_start(fs, this_val);
+  }
+  return JS_UNDEFINED;
+}
 
-  if (bytes_read < 0) {
-    // Error reading
-    free(buffer);
-    JSValue error = JS_NewError(ctx);
-    JS_SetPropertyStr(ctx, error, "message", JS_NewString(ctx, strerror(errno)));
-    JS_SetPropertyStr(ctx, error, "errno", JS_NewInt32(ctx, errno));
-    stream_emit(ctx, this_val, "error", 1, &error);
-    JS_FreeValue(ctx, error);
+// Write stream
+
+static void fs_write_stream_flush(FSStreamContext* fs, JSValueConst stream);
+
+static void fs_write_stream_finish_inflight(FSStreamContext* fs, JSValueConst error) {
+  JSContext* ctx = fs->ctx;
+  FSWriteChunk* chunks = fs->inflight;
+  size_t count = fs->inflight_count;
 
-    // Close file
-    if (fs_ctx->auto_close && !fs_ctx->closed) {
-      close(fs_ctx->fd);
-      fs_ctx->closed = true;
+  fs->inflight = NULL;
+  fs->inflight_count = 0;
+  free(fs->bufs);
+  fs->bufs = NULL;
+  fs->buf_index = 0;
+
+  for (size_t i = 0; i < count; i++) {
+    fs->pending_bytes -= chunks[i].buf.len;
+    if (JS_IsFunction(ctx, chunks[i].callback)) {
+      int cb_argc = JS_IsUndefined(error) ? 0 : 1;
+      JSValue result = JS_Call(ctx, chunks[i].callback, JS_UNDEFINED, cb_argc, &error);
+      if (JS_IsException(result)) {
+        js_std_dump_error(ctx);
+      }
+      JS_FreeValue(ctx, result);
     }
-    return JS_NULL;
+    fs_write_chunk_free(ctx, &chunks[i]);
   }
+  free(chunks);
+}
 
-  if (bytes_read == 0) {
-    // EOF reached
-    free(buffer);
-    if (fs_ctx->auto_close && !fs_ctx->closed) {
-      close(fs_ctx->fd);
-      fs_ctx->closed = true;
-    }
-    stream->ended = true;
-    stream_emit(ctx, this_val, "end", 0, NULL);
-    return JS_NULL;
+static void fs_write_stream_on_write(uv_fs_t* req) {
+  FSStreamContext* fs = (FSStreamContext*)req;
+  JSContext* ctx = fs->ctx;
+  ssize_t result = req->result;
+  JSValue stream = fs_stream_end_request(fs);
+  JSStreamData* data = js_stream_get_data(ctx, stream, js_writable_class_id);
+
+  if (result < 0) {
+    JSValue error = create_fs_error(ctx, (int)-result, "write", fs->path);
+    fs_write_stream_finish_inflight(fs, error);
+    stream_emit(ctx, stream, "error", 1, &error);
+    JS_FreeValue(ctx, error);
+    fs_stream_close(fs, stream);
+    JS_FreeValue(ctx, stream);
+    return;
   }
 
-  // Update position
-  fs_ctx->pos += bytes_read;
-  fs_ctx->bytes_read += bytes_read;
+  fs->bytes_written += result;
+  if (fs->pos >= 0) {
+    fs->pos += result;
+  }
+  JS_SetPropertyStr(ctx, stream, "bytesWritten", JS_NewInt64(ctx, (int64_t)fs->bytes_written));
+
+  // Skip the iovecs that were written completely and resubmit the rest of a partial write
+  size_t nbufs = fs->inflight_count;
+  size_t written = (size_t)result;
+  while (fs->buf_index < nbufs && written >= fs->bufs[fs->buf_index].len) {
+    written -= fs->bufs[fs->buf_index].len;
+    fs->buf_index++;
+  }
+  if (fs->buf_index < nbufs) {
+    fs->bufs[fs->buf_index].base += written;
+    fs->bufs[fs->buf_index].len -= written;
+    fs_stream_begin_request(fs, stream);
+    int rc = uv_fs_write(fs_get_uv_loop(ctx), &fs->req, fs->fd, fs->bufs + fs->buf_index,
+                         (unsigned int)(nbufs - fs->buf_index), fs->pos, fs_write_stream_on_write);
+    if (rc >= 0) {
+      JS_FreeValue(ctx, stream);
+      return;
+    }
+    JS_FreeValue(ctx, fs_stream_end_request(fs));
+    JSValue error = create_fs_error(ctx, -rc, "write", fs->path);
+    fs_write_stream_finish_inflight(fs, error);
+    stream_emit(ctx, stream, "error", 1, &error);
+    JS_FreeValue(ctx, error);
+    fs_stream_close(fs, stream);
+    JS_FreeValue(ctx, stream);
+    return;
+  }
 
-  // Create buffer value
-  JSValue data = JS_NewArrayBufferCopy(ctx, buffer, bytes_read);
-  free(buffer);
+  fs_write_stream_finish_inflight(fs, JS_UNDEFINED);
+  fs_write_stream_flush(fs, stream);
 
-  return data;
+  if (!fs->busy && data && data->need_drain && fs->pending_bytes == 0) {
+    data->need_drain = false;
+    stream_emit(ctx, stream, "drain", 0, NULL);
+  }
+  JS_FreeValue(ctx, stream);
 }
 
-// Write method for WriteStream - writes to file
-static JSValue js_fs_write_stream_write(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
-  if (argc < 1) {
-    return JS_ThrowTypeError(ctx, "write() requires at least 1 argument");
+// Write everything queued so far as one request, or close once end() has drained the queue
+static void fs_write_stream_flush(FSStreamContext* fs, JSValueConst stream) {
+  JSContext* ctx = fs->ctx;
+  if (fs->busy) {
+    return;
   }
 
-  // Get stream data
-  JSStreamData* stream = js_stream_get_data(ctx, this_val, js_writable_class_id);
-  if (!stream) {
-    return JS_ThrowTypeError(ctx, "Not a writable stream");
+  if (fs->queue_count == 0) {
+    if (fs->ending) {
+      JSStreamData* data = js_stream_get_data(ctx, stream, js_writable_class_id);
+      if (fs->auto_close && !fs->closed) {
+        fs_stream_close(fs, stream);
+      } else if (data && !data->writable_finished) {
+        data->writable_finished = true;
+        stream_emit(ctx, stream, "finish", 0, NULL);
+      }
+    }
+    return;
   }
 
-  if (stream->writable_ended) {
-    return JS_ThrowTypeError(ctx, "write after end");
+  uv_buf_t* bufs = malloc(sizeof(uv_buf_t) * fs->queue_count);
+  for (size_t i = 0; bufs && i < fs->queue_count; i++) {
+    bufs[i] = fs->queue[i].buf;
   }
 
-  // Get file context
-  JSValue ctx_val = JS_GetPropertyStr(ctx, this_val, "__fs_context");
-  if (JS_IsUndefined(ctx_val)) {
-    return JS_NewBool(ctx, false);
-  }
+  fs->inflight = fs->queue;
+  fs->inflight_count = fs->queue_count;
+  fs->bufs = bufs;
+  fs->buf_index = 0;
+  fs->queue = NULL;
+  fs->queue_count = 0;
+  fs->queue_capacity = 0;
 
-  FSWriteStreamContext* fs_ctx = JS_GetOpaque(ctx_val, 0);
-  JS_FreeValue(ctx, ctx_val);
+  if (!bufs) {
+    JSValue error = JS_NewError(ctx);
+    JS_SetPropertyStr(ctx, error, "message", JS_NewString(ctx, "Out of memory"));
+    fs_write_stream_finish_inflight(fs, error);
+    stream_emit(ctx, stream, "error", 1, &error);
+    JS_FreeValue(ctx, error);
+    return;
+  }
 
-  if (!fs_ctx || fs_ctx->fd < 0 || fs_ctx->closed) {
-    return JS_NewBool(ctx, false);
+  fs_stream_begin_request(fs, stream);
+  int result = uv_fs_write(fs_get_uv_loop(ctx), &fs->req, fs->fd, bufs, (unsigned int)fs->inflight_count, fs->pos,
+                           fs_write_stream_on_write);
+  if (result < 0) {
+    JSValue held = fs_stream_end_request(fs);
+    JSValue error = create_fs_error(ctx, -result, "write", fs->path);
+    fs_write_stream_finish_inflight(fs, error);
+    stream_emit(ctx, held, "error", 1, &error);
+    JS_FreeValue(ctx, error);
+    fs_stream_close(fs, held);
+    JS_FreeValue(ctx, held);
   }
+}
 
-  // Convert chunk to buffer
-  size_t size;
-  uint8_t* data = NULL;
-  bool is_buffer = false;
+// Queue chunk without copying it: binary chunks are pinned, strings keep their UTF-8 C string
+static int fs_write_stream_queue(JSContext* ctx, FSStreamContext* fs, JSValueConst chunk, JSValueConst callback) {
+  FSWriteChunk entry = {JS_UNDEFINED, NULL, JS_UNDEFINED, {0}};
+  size_t len = 0;
 
-  // Try to get as ArrayBuffer first
-  data = JS_GetArrayBuffer(ctx, &size, argv[0]);
-  if (data) {
-    is_buffer = true;
+  uint8_t* bytes = jsrt_node_buffer_source_bytes(ctx, chunk, &len);
+  if (bytes) {
+    entry.pinned = JS_DupValue(ctx, chunk);
+    entry.store = JSRT_BufferPinValue(ctx, chunk);
+    entry.buf = uv_buf_init((char*)bytes, (unsigned int)len);
   } else {
-    // If not a buffer, convert to string
-    const char* str = JS_ToCString(ctx, argv[0]);
-    if (!str) {
-      return JS_EXCEPTION;
+    entry.cstr = JS_ToCStringLen(ctx, &len, chunk);
+    if (!entry.cstr) {
+      return -1;
+    }
+    entry.buf = uv_buf_init((char*)entry.cstr, (unsigned int)len);
+  }
+
+  if (fs->queue_count >= fs->queue_capacity) {
+    size_t new_capacity = fs->queue_capacity == 0 ? 8 : fs->queue_capacity * 2;
+    FSWriteChunk* new_queue = realloc(fs->queue, sizeof(FSWriteChunk) * new_capacity);
+    if (!new_queue) {
+      fs_write_chunk_free(ctx, &entry);
+      JS_ThrowOutOfMemory(ctx);
+      return -1;
     }
-    size = strlen(str);
-    data = (uint8_t*)str;
-    is_buffer = false;
+    fs->queue = new_queue;
+    fs->queue_capacity = new_capacity;
   }
 
-  // Write to file
-  ssize_t bytes_written = write(fs_ctx->fd, data, size);
+  entry.callback = JS_DupValue(ctx, callback);
+  fs->queue[fs->queue_count++] = entry;
+  fs->pending_bytes += len;
+  return 0;
+}
 
-  // Free string if we converted
-  if (!is_buffer) {
-    JS_FreeCString(ctx, (const char*)data);
+// Write method for WriteStream - queues the chunk and returns false past highWaterMark
+static JSValue js_fs_write_stream_write(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
+  if (argc < 1) {
+    return JS_ThrowTypeError(ctx, "write() requires at least 1 argument");
   }
 
-  if (bytes_written < 0) {
-    // Error writing
-    JSValue error = JS_NewError(ctx);
-    JS_SetPropertyStr(ctx, error, "message", JS_NewString(ctx, strerror(errno)));
-    JS_SetPropertyStr(ctx, error, "errno", JS_NewInt32(ctx, errno));
-    stream_emit(ctx, this_val, "error", 1, &error);
-    JS_FreeValue(ctx, error);
-    return JS_NewBool(ctx, false);
+  // Get stream data
+  JSStreamData* stream = js_stream_get_data(ctx, this_val, js_writable_class_id);
+  if (!stream) {
+    return JS_ThrowTypeError(ctx, "Not a writable stream");
   }
 
-  // Update position and bytes written
-  fs_ctx->pos += bytes_written;
-  fs_ctx->bytes_written += bytes_written;
+  if (stream->writable_ended) {
+    return JS_ThrowTypeError(ctx, "write after end");
+  }
 
-  // Emit 'bytesWritten' update
-  JS_SetPropertyStr(ctx, this_val, "bytesWritten", JS_NewInt64(ctx, fs_ctx->bytes_written));
+  FSStreamContext* fs = fs_stream_get_context(ctx, this_val);
+  if (!fs || fs->fd < 0 || fs->closing) {
+    return JS_NewBool(ctx, false);
+  }
 
-  // Call callback if provided (3rd argument)
+  // write(chunk, [encoding], [callback])
+  JSValue callback = JS_UNDEFINED;
   if (argc >= 3 && JS_IsFunction(ctx, argv[2])) {
-    JSValue result = JS_Call(ctx, argv[2], JS_UNDEFINED, 0, NULL);
-    if (JS_IsException(result)) {
-      js_std_dump_error(ctx);
-    }
-    JS_FreeValue(ctx, result);
+    callback = argv[2];
+  } else if (argc >= 2 && JS_IsFunction(ctx, argv[1])) {
+    callback = argv[1];
   }
 
-  // Return true (no backpressure for file writes)
-  return JS_NewBool(ctx, true);
+  if (fs_write_stream_queue(ctx, fs, argv[0], callback) < 0) {
+    return JS_EXCEPTION;
+  }
+  fs_write_stream_flush(fs, this_val);
+
+  bool ok = fs->pending_bytes < (size_t)stream->options.highWaterMark;
+  if (!ok) {
+    stream->need_drain = true;
+  }
+  return JS_NewBool(ctx, ok);
 }
 
-// End method for WriteStream
+// End method for WriteStream - 'finish' follows once queued writes are flushed and the file is closed
 static JSValue js_fs_write_stream_end(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
   // Get stream data
   JSStreamData* stream = js_stream_get_data(ctx, this_val, js_writable_class_id);
@@ -266,34 +599,82 @@ static JSValue js_fs_write_stream_end(JSContext* ctx, JSValueConst this_val, int
     return JS_UNDEFINED;
   }
 
-  // Write final chunk if provided
-  if (argc > 0 && !JS_IsUndefined(argv[0]) && !JS_IsNull(argv[0])) {
-    js_fs_write_stream_write(ctx, this_val, argc, argv);
+  FSStreamContext* fs = fs_stream_get_context(ctx, this_val);
+  if (!fs) {
+    return JS_ThrowTypeError(ctx, "Not a file write stream");
+  }
+
+  // end([chunk], [encoding], [callback])
+  JSValue callback = JS_UNDEFINED;
+  int chunk_argc = 0;
+  for (int i = 0; i < argc; i++) {
+    if (JS_IsFunction(ctx, argv[i])) {
+      callback = argv[i];
+      break;
+    }
+    chunk_argc = i + 1;
   }
 
-  // Get file context and close file
-  JSValue ctx_val = JS_GetPropertyStr(ctx, this_val, "__fs_context");
-  if (!JS_IsUndefined(ctx_val)) {
-    FSWriteStreamContext* fs_ctx = JS_GetOpaque(ctx_val, 0);
-    if (fs_ctx && fs_ctx->fd >= 0 && fs_ctx->auto_close && !fs_ctx->closed) {
-      close(fs_ctx->fd);
-      fs_ctx->closed = true;
+  // Write final chunk if provided
+  if (chunk_argc > 0 && !JS_IsUndefined(argv[0]) && !JS_IsNull(argv[0])) {
+    JSValue result = js_fs_write_stream_write(ctx, this_val, chunk_argc, argv);
+    if (JS_IsException(result)) {
+      return result;
     }
-    JS_FreeValue(ctx, ctx_val);
+    JS_FreeValue(ctx, result);
+  }
+
+  if (JS_IsFunction(ctx, callback)) {
+    JSValue args[2] = {JS_NewString(ctx, "finish"), JS_DupValue(ctx, callback)};
+    JSValue result = js_stream_once(ctx, this_val, 2, args);
+    JS_FreeValue(ctx, args[0]);
+    JS_FreeValue(ctx, args[1]);
+    JS_FreeValue(ctx, result);
   }
 
+  stream->writable = false;
   stream->writable_ended = true;
-  stream->writable_finished = true;
+  JS_SetPropertyStr(ctx, this_val, "writable", JS_NewBool(ctx, false));
+
+  fs->ending = true;
+  fs_write_stream_flush(fs, this_val);
+  return JS_DupValue(ctx, this_val);
+}
+
+// writeStream.writableLength - bytes queued or being written
+static JSValue js_fs_write_stream_get_length(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
+  FSStreamContext* fs = fs_stream_get_context(ctx, this_val);
+  return JS_NewInt64(ctx, fs ? (int64_t)fs->pending_bytes : 0);
+}
 
-  // Emit 'finish' event
-  stream_emit(ctx, this_val, "finish", 0, NULL);
+// Create the context holder and attach it to the stream
+static FSStreamContext* fs_stream_attach_context(JSContext* ctx, JSValueConst stream, uv_file fd, const char* path,
+                                                 bool auto_close) {
+  ensure_fs_stream_context_class_initialized(ctx);
 
-  // Emit 'close' event if emitClose option is true
-  if (stream->options.emitClose) {
-    stream_emit(ctx, this_val, "close", 0, NULL);
+  JSValue holder = JS_NewObjectClass(ctx, js_fs_stream_context_class_id);
+  if (JS_IsException(holder)) {
+    return NULL;
   }
 
-  return JS_UNDEFINED;
+  FSStreamContext* fs = calloc(1, sizeof(FSStreamContext));
+  if (!fs) {
+    JS_FreeValue(ctx, holder);
+    JS_ThrowOutOfMemory(ctx);
+    return NULL;
+  }
+
+  fs->ctx = ctx;
+  fs->stream = JS_UNDEFINED;
+  fs->fd = fd;
+  fs->auto_close = auto_close;
+  fs->path = strdup(path);
+  fs->end = -1;
+  JS_SetOpaque(holder, fs);
+
+  // Stored as a hidden property so the context is freed with the stream
+  JS_DefinePropertyValueStr(ctx, stream, "__fs_context", holder, JS_PROP_CONFIGURABLE);
+  return fs;
 }
 
 // fs.createReadStream(path[, options])
@@ -311,9 +692,10 @@ JSValue js_fs_create_read_stream(JSContext* ctx, JSValueConst this_val, int argc
   int flags = O_RDONLY;
   mode_t mode = 0666;
   bool auto_close = true;
-  uint64_t start = 0;
-  uint64_t end = 0;             // 0 means no limit
+  int64_t start = 0;
+  int64_t end = -1;             // -1 means no limit
   int high_water_mark = 65536;  // Default 64KB
+  JSValue encoding = JS_UNDEFINED;
 
   if (argc > 1 && JS_IsObject(argv[1])) {
     JSValue flags_val = JS_GetPropertyStr(ctx, argv[1], "flags");
@@ -348,7 +730,7 @@ JSValue js_fs_create_read_stream(JSContext* ctx, JSValueConst this_val, int argc
     JSValue start_val = JS_GetPropertyStr(ctx, argv[1], "start");
     if (!JS_IsUndefined(start_val)) {
       int64_t start_int;
-      if (JS_ToInt64(ctx, &start_int, start_val) == 0) {
+      if (JS_ToInt64(ctx, &start_int, start_val) == 0 && start_int > 0) {
         start = start_int;
       }
     }
@@ -357,7 +739,7 @@ JSValue js_fs_create_read_stream(JSContext* ctx, JSValueConst this_val, int argc
     JSValue end_val = JS_GetPropertyStr(ctx, argv[1], "end");
     if (!JS_IsUndefined(end_val)) {
       int64_t end_int;
-      if (JS_ToInt64(ctx, &end_int, end_val) == 0) {
+      if (JS_ToInt64(ctx, &end_int, end_val) == 0 && end_int >= 0) {
         end = end_int + 1;  // end is inclusive in Node.js
       }
     }
@@ -366,32 +748,33 @@ JSValue js_fs_create_read_stream(JSContext* ctx, JSValueConst this_val, int argc
     JSValue hwm_val = JS_GetPropertyStr(ctx, argv[1], "highWaterMark");
     if (!JS_IsUndefined(hwm_val)) {
       int32_t hwm_int;
-      if (JS_ToInt32(ctx, &hwm_int, hwm_val) == 0) {
+      if (JS_ToInt32(ctx, &hwm_int, hwm_val) == 0 && hwm_int > 0) {
         high_water_mark = hwm_int;
       }
     }
     JS_FreeValue(ctx, hwm_val);
+
+    encoding = JS_GetPropertyStr(ctx, argv[1], "encoding");
+  } else if (argc > 1 && JS_IsString(argv[1])) {
+    encoding = JS_DupValue(ctx, argv[1]);
   }
 
   // Open file
   int fd = open(path, flags, mode);
   if (fd < 0) {
+    JSValue error = create_fs_error(ctx, errno, "open", path);
+    JS_FreeValue(ctx, encoding);
     JS_FreeCString(ctx, path);
-    return create_fs_error(ctx, errno, "open", path);
-  }
-
-  // Seek to start position if specified
-  if (start > 0) {
-    if (lseek(fd, start, SEEK_SET) < 0) {
-      close(fd);
-      JS_FreeCString(ctx, path);
-      return create_fs_error(ctx, errno, "lseek", path);
-    }
+    return JS_Throw(ctx, error);
   }
 
   // Create Readable stream with options
   JSValue options = JS_NewObject(ctx);
   JS_SetPropertyStr(ctx, options, "highWaterMark", JS_NewInt32(ctx, high_water_mark));
+  if (JS_IsString(encoding)) {
+    JS_SetPropertyStr(ctx, options, "encoding", JS_DupValue(ctx, encoding));
+  }
+  JS_FreeValue(ctx, encoding);
 
   JSValue argv_stream[1] = {options};
   JSValue read_stream = js_readable_constructor(ctx, JS_UNDEFINED, 1, argv_stream);
@@ -403,31 +786,25 @@ JSValue js_fs_create_read_stream(JSContext* ctx, JSValueConst this_val, int argc
     return read_stream;
   }
 
-  // Create and attach file context
-  FSReadStreamContext* fs_ctx = calloc(1, sizeof(FSReadStreamContext));
-  if (!fs_ctx) {
-    close(fd);
+  FSStreamContext* fs = fs_stream_attach_context(ctx, read_stream, fd, path, auto_close);
+  FSReadBufferPool* pool = fs ? calloc(1, sizeof(FSReadBufferPool)) : NULL;
+  if (!pool) {
+    if (!fs) {
+      close(fd);
+    }
     JS_FreeCString(ctx, path);
     JS_FreeValue(ctx, read_stream);
-    return JS_ThrowOutOfMemory(ctx);
+    return fs ? JS_ThrowOutOfMemory(ctx) : JS_EXCEPTION;
   }
 
-  fs_ctx->fd = fd;
-  fs_ctx->auto_close = auto_close;
-  fs_ctx->closed = false;
-  fs_ctx->path = strdup(path);
-  fs_ctx->bytes_read = 0;
-  fs_ctx->start = start;
-  fs_ctx->end = end;
-  fs_ctx->pos = start;
-
-  // Store context as property (will be freed by stream finalizer)
-  JSValue ctx_obj = JS_NewObjectClass(ctx, 0);
-  JS_SetOpaque(ctx_obj, fs_ctx);
-  JS_SetPropertyStr(ctx, read_stream, "__fs_context", ctx_obj);
+  pool->refs = 1;
+  pool->size = (size_t)high_water_mark;
+  fs->pool = pool;
+  fs->pos = start;
+  fs->end = end;
 
-  // Override read method
-  JS_SetPropertyStr(ctx, read_stream, "read", JS_NewCFunction(ctx, js_fs_read_stream_read, "read", 1));
+  // The Readable calls _read whenever its consumer wants more data
+  JS_SetPropertyStr(ctx, read_stream, "_read", JS_NewCFunction(ctx, js_fs_read_stream_read, "_read", 1));
 
   // Set additional properties
   JS_SetPropertyStr(ctx, read_stream, "path", JS_NewString(ctx, path));
@@ -454,7 +831,8 @@ JSValue js_fs_create_write_stream(JSContext* ctx, JSValueConst this_val, int arg
   int flags = O_WRONLY | O_CREAT | O_TRUNC;
   mode_t mode = 0666;
   bool auto_close = true;
-  uint64_t start = 0;
+  int64_t start = -1;  // -1 writes at the current position (needed for append mode)
+  int high_water_mark = 16384;
 
   if (argc > 1 && JS_IsObject(argv[1])) {
     JSValue flags_val = JS_GetPropertyStr(ctx, argv[1], "flags");
@@ -478,6 +856,8 @@ JSValue js_fs_create_write_stream(JSContext* ctx, JSValueConst this_val, int arg
           flags = O_RDWR | O_CREAT | O_APPEND;
         else if (strcmp(flags_str, "ax+") == 0 || strcmp(flags_str, "xa+") == 0)
           flags = O_RDWR | O_CREAT | O_EXCL | O_APPEND;
+        else if (strcmp(flags_str, "r+") == 0)
+          flags = O_RDWR;
         JS_FreeCString(ctx, flags_str);
       }
     }
@@ -501,63 +881,60 @@ JSValue js_fs_create_write_stream(JSContext* ctx, JSValueConst this_val, int arg
     JSValue start_val = JS_GetPropertyStr(ctx, argv[1], "start");
     if (!JS_IsUndefined(start_val)) {
       int64_t start_int;
-      if (JS_ToInt64(ctx, &start_int, start_val) == 0) {
+      if (JS_ToInt64(ctx, &start_int, start_val) == 0 && start_int >= 0) {
         start = start_int;
       }
     }
     JS_FreeValue(ctx, start_val);
+
+    JSValue hwm_val = JS_GetPropertyStr(ctx, argv[1], "highWaterMark");
+    if (!JS_IsUndefined(hwm_val)) {
+      int32_t hwm_int;
+      if (JS_ToInt32(ctx, &hwm_int, hwm_val) == 0 && hwm_int >= 0) {
+        high_water_mark = hwm_int;
+      }
+    }
+    JS_FreeValue(ctx, hwm_val);
   }
 
   // Open file
   int fd = open(path, flags, mode);
   if (fd < 0) {
+    JSValue error = create_fs_error(ctx, errno, "open", path);
     JS_FreeCString(ctx, path);
-    return create_fs_error(ctx, errno, "open", path);
-  }
-
-  // Seek to start position if specified
-  if (start > 0) {
-    if (lseek(fd, start, SEEK_SET) < 0) {
-      close(fd);
-      JS_FreeCString(ctx, path);
-      return create_fs_error(ctx, errno, "lseek", path);
-    }
+    return JS_Throw(ctx, error);
   }
 
   // Create Writable stream
-  JSValue write_stream = js_writable_constructor(ctx, JS_UNDEFINED, 0, NULL);
+  JSValue options = JS_NewObject(ctx);
+  JS_SetPropertyStr(ctx, options, "highWaterMark", JS_NewInt32(ctx, high_water_mark));
+  JSValue write_stream = js_writable_constructor(ctx, JS_UNDEFINED, 1, &options);
+  JS_FreeValue(ctx, options);
   if (JS_IsException(write_stream)) {
     close(fd);
     JS_FreeCString(ctx, path);
     return write_stream;
   }
 
-  // Create and attach file context
-  FSWriteStreamContext* fs_ctx = calloc(1, sizeof(FSWriteStreamContext));
-  if (!fs_ctx) {
+  FSStreamContext* fs = fs_stream_attach_context(ctx, write_stream, fd, path, auto_close);
+  if (!fs) {
     close(fd);
     JS_FreeCString(ctx, path);
     JS_FreeValue(ctx, write_stream);
-    return JS_ThrowOutOfMemory(ctx);
+    return JS_EXCEPTION;
   }
-
-  fs_ctx->fd = fd;
-  fs_ctx->auto_close = auto_close;
-  fs_ctx->closed = false;
-  fs_ctx->path = strdup(path);
-  fs_ctx->bytes_written = 0;
-  fs_ctx->start = start;
-  fs_ctx->pos = start;
-
-  // Store context as property
-  JSValue ctx_obj = JS_NewObjectClass(ctx, 0);
-  JS_SetOpaque(ctx_obj, fs_ctx);
-  JS_SetPropertyStr(ctx, write_stream, "__fs_context", ctx_obj);
+  fs->pos = start;
 
   // Override write and end methods
   JS_SetPropertyStr(ctx, write_stream, "write", JS_NewCFunction(ctx, js_fs_write_stream_write, "write", 3));
   JS_SetPropertyStr(ctx, write_stream, "end", JS_NewCFunction(ctx, js_fs_write_stream_end, "end", 3));
 
+  JSAtom length_atom = JS_NewAtom(ctx, "writableLength");
+  JS_DefinePropertyGetSet(ctx, write_stream, length_atom,
+                          JS_NewCFunction(ctx, js_fs_write_stream_get_length, "get writableLength", 0), JS_UNDEFINED,
+                          JS_PROP_CONFIGURABLE);
+  JS_FreeAtom(ctx, length_atom);
+
   // Set additional properties
   JS_SetPropertyStr(ctx, write_stream, "path", JS_NewString(ctx, path));
   JS_SetPropertyStr(ctx, write_stream, "fd", JS_NewInt32(ctx, fd));
@@ -258,10 +258,10 @@ static JSValue js_fs_dir_close_sync(JSContext* ctx, JSValueConst this_val, int a
   return JS_UNDEFINED;
 }
 
-// Initialize Dir class (called once)
+// Initialize Dir class (once per runtime)
 static void ensure_dir_class_initialized(JSContext* ctx) {
-  if (js_dir_class_id == 0) {
-    JS_NewClassID(&js_dir_class_id);
+  JS_NewClassID(&js_dir_class_id);
+  if (!JS_IsRegisteredClass(JS_GetRuntime(ctx), js_dir_class_id)) {
     JS_NewClass(JS_GetRuntime(ctx), js_dir_class_id, &js_dir_class);
   }
 }
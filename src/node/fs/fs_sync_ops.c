@@ -1,26 +1,17 @@
+#include "fs_async_libuv.h"
 #include "fs_common.h"
 
-// Helper function to copy file using buffer
-static int copy_file_content(FILE* src, FILE* dest) {
-  char buffer[8192];
-  size_t bytes_read, bytes_written;
-
-  while ((bytes_read = fread(buffer, 1, sizeof(buffer), src)) > 0) {
-    bytes_written = fwrite(buffer, 1, bytes_read, dest);
-    if (bytes_written != bytes_read) {
-      return -1;
-    }
-  }
-
-  return ferror(src) ? -1 : 0;
-}
-
-// fs.copyFileSync(src, dest[, mode])
+// fs.copyFileSync(src, dest[, mode]) - mode takes COPYFILE_EXCL/COPYFILE_FICLONE/COPYFILE_FICLONE_FORCE
 JSValue js_fs_copy_file_sync(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
   if (argc < 2) {
     return JS_ThrowTypeError(ctx, "src and dest are required");
   }
 
+  int flags = 0;
+  if (argc > 2 && !JS_IsUndefined(argv[2]) && JS_ToInt32(ctx, &flags, argv[2]) < 0) {
+    return JS_EXCEPTION;
+  }
+
   const char* src = JS_ToCString(ctx, argv[0]);
   if (!src) {
     return JS_EXCEPTION;
@@ -32,39 +23,15 @@ JSValue js_fs_copy_file_sync(JSContext* ctx, JSValueConst this_val, int argc, JS
     return JS_EXCEPTION;
   }
 
-  // Check if source file exists
-  FILE* src_file = fopen(src, "rb");
-  if (!src_file) {
-    JSValue error = create_fs_error(ctx, errno, "open", src);
-    JS_FreeCString(ctx, src);
-    JS_FreeCString(ctx, dest);
-    return JS_Throw(ctx, error);
-  }
-
-  // Create destination file
-  FILE* dest_file = fopen(dest, "wb");
-  if (!dest_file) {
-    fclose(src_file);
-    JSValue error = create_fs_error(ctx, errno, "open", dest);
-    JS_FreeCString(ctx, src);
-    JS_FreeCString(ctx, dest);
-    return JS_Throw(ctx, error);
-  }
-
-  // Copy file content
-  if (copy_file_content(src_file, dest_file) < 0) {
-    fclose(src_file);
-    fclose(dest_file);
-    unlink(dest);  // Remove partially copied file
-    JSValue error = create_fs_error(ctx, errno, "write", dest);
+  // Reflink or in-kernel copy; the data never passes through a userspace buffer
+  int result = fs_copyfile_sync(ctx, src, dest, flags);
+  if (result < 0) {
+    JSValue error = create_fs_error(ctx, -result, "copyfile", src);
     JS_FreeCString(ctx, src);
     JS_FreeCString(ctx, dest);
     return JS_Throw(ctx, error);
   }
 
-  fclose(src_file);
-  fclose(dest_file);
-
   JS_FreeCString(ctx, src);
   JS_FreeCString(ctx, dest);
 
@@ -1,4 +1,5 @@
 #include <limits.h>
+#include "fs_async_libuv.h"
 #include "fs_common.h"
 
 // Windows compatibility: lstat doesn't exist, use stat instead
@@ -69,7 +70,8 @@ static int rmdir_recursive(const char* path) {
 }
 
 // Internal helper function to copy directory recursively with depth tracking
-static int copydir_recursive_internal(JSContext* ctx, const char* src, const char* dest, mode_t mode, int depth) {
+static int copydir_recursive_internal(JSContext* ctx, const char* src, const char* dest, mode_t mode, int copy_flags,
+                                      int depth) {
   // Protect against excessively deep directory trees
   if (depth > 128) {
     errno = ELOOP;  // Too many levels of symbolic links
@@ -117,37 +119,14 @@ static int copydir_recursive_internal(JSContext* ctx, const char* src, const cha
     if (lstat(src_path, &st) == 0) {
       if (S_ISDIR(st.st_mode)) {
         // Recursively copy subdirectory with incremented depth
-        result = copydir_recursive_internal(ctx, src_path, dest_path, st.st_mode & 0777, depth + 1);
+        result = copydir_recursive_internal(ctx, src_path, dest_path, st.st_mode & 0777, copy_flags, depth + 1);
       } else if (S_ISREG(st.st_mode)) {
-        // Copy regular file
-        FILE* src_file = fopen(src_path, "rb");
-        if (!src_file) {
+        // Copy regular file (reflink or in-kernel copy; permissions are preserved)
+        int copy_result = fs_copyfile_sync(ctx, src_path, dest_path, copy_flags);
+        if (copy_result < 0) {
+          errno = -copy_result;
           result = -1;
-          continue;
         }
-
-        FILE* dest_file = fopen(dest_path, "wb");
-        if (!dest_file) {
-          fclose(src_file);
-          result = -1;
-          continue;
-        }
-
-        // Copy file contents
-        char buffer[8192];
-        size_t bytes;
-        while ((bytes = fread(buffer, 1, sizeof(buffer), src_file)) > 0) {
-          if (fwrite(buffer, 1, bytes, dest_file) != bytes) {
-            result = -1;
-            break;
-          }
-        }
-
-        fclose(src_file);
-        fclose(dest_file);
-
-        // Copy permissions
-        chmod(dest_path, st.st_mode & 0777);
       } else if (S_ISLNK(st.st_mode)) {
 #ifndef _WIN32
         // Copy symlink (not supported on Windows)
@@ -173,8 +152,8 @@ static int copydir_recursive_internal(JSContext* ctx, const char* src, const cha
 }
 
 // Public wrapper that starts at depth 0
-static int copydir_recursive(JSContext* ctx, const char* src, const char* dest, mode_t mode) {
-  return copydir_recursive_internal(ctx, src, dest, mode, 0);
+static int copydir_recursive(JSContext* ctx, const char* src, const char* dest, mode_t mode, int copy_flags) {
+  return copydir_recursive_internal(ctx, src, dest, mode, copy_flags, 0);
 }
 
 // fs.rmSync(path, options)
@@ -261,6 +240,7 @@ JSValue js_fs_cp_sync(JSContext* ctx, JSValueConst this_val, int argc, JSValueCo
 
   bool recursive = false;
   bool force = false;
+  int copy_flags = 0;  // fs.constants.COPYFILE_* for file copies
 
   // Parse options
   if (argc > 2 && JS_IsObject(argv[2])) {
@@ -275,6 +255,12 @@ JSValue js_fs_cp_sync(JSContext* ctx, JSValueConst this_val, int argc, JSValueCo
       force = JS_ToBool(ctx, force_val);
     }
     JS_FreeValue(ctx, force_val);
+
+    JSValue mode_val = JS_GetPropertyStr(ctx, argv[2], "mode");
+    if (JS_IsNumber(mode_val)) {
+      JS_ToInt32(ctx, &copy_flags, mode_val);
+    }
+    JS_FreeValue(ctx, mode_val);
   }
 
   // Check if source exists
@@ -305,42 +291,13 @@ JSValue js_fs_cp_sync(JSContext* ctx, JSValueConst this_val, int argc, JSValueCo
       return JS_Throw(ctx, create_fs_error(ctx, EISDIR, "cp", src));
     }
 
-    result = copydir_recursive(ctx, src, dest, src_st.st_mode & 0777);
+    result = copydir_recursive(ctx, src, dest, src_st.st_mode & 0777, copy_flags);
   } else if (S_ISREG(src_st.st_mode)) {
-    // Copy regular file
-    FILE* src_file = fopen(src, "rb");
-    if (!src_file) {
-      JSValue error = create_fs_error(ctx, errno, "cp", src);
-      JS_FreeCString(ctx, src);
-      JS_FreeCString(ctx, dest);
-      return JS_Throw(ctx, error);
-    }
-
-    FILE* dest_file = fopen(dest, "wb");
-    if (!dest_file) {
-      fclose(src_file);
-      JSValue error = create_fs_error(ctx, errno, "cp", dest);
-      JS_FreeCString(ctx, src);
-      JS_FreeCString(ctx, dest);
-      return JS_Throw(ctx, error);
-    }
-
-    // Copy file contents
-    char buffer[8192];
-    size_t bytes;
-    while ((bytes = fread(buffer, 1, sizeof(buffer), src_file)) > 0) {
-      if (fwrite(buffer, 1, bytes, dest_file) != bytes) {
-        result = -1;
-        break;
-      }
-    }
-
-    fclose(src_file);
-    fclose(dest_file);
-
-    // Copy permissions
-    if (result == 0) {
-      chmod(dest, src_st.st_mode & 0777);
+    // Copy regular file (reflink or in-kernel copy; permissions are preserved)
+    int copy_result = fs_copyfile_sync(ctx, src, dest, copy_flags);
+    if (copy_result < 0) {
+      errno = -copy_result;
+      result = -1;
     }
   } else if (S_ISLNK(src_st.st_mode)) {
 #ifndef _WIN32
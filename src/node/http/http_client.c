@@ -242,6 +242,18 @@ int client_on_message_complete(llhttp_t* parser) {
       }
     }
 
+    if (socket_conn && socket_conn->connected && !socket_conn->destroyed && llhttp_should_keep_alive(parser) &&
+        js_http_agent_keeps_alive(client_req)) {
+      // Keep the connection open for the agent's next request to this origin
+      JS_SetPropertyStr(ctx, socket_val, "_clientRequest", JS_UNDEFINED);
+      uv_unref((uv_handle_t*)&socket_conn->handle);
+      JS_FreeValue(ctx, client_req->socket);
+      client_req->socket = JS_UNDEFINED;
+      js_http_agent_release(client_req, socket_conn, true);
+      JS_FreeValue(ctx, socket_val);
+      return 0;
+    }
+
     JSValue end_method = JS_GetPropertyStr(ctx, socket_val, "end");
     if (JS_IsFunction(ctx, end_method)) {
       JSValue result = JS_Call(ctx, end_method, socket_val, 0, NULL);
@@ -263,6 +275,7 @@ int client_on_message_complete(llhttp_t* parser) {
     JS_FreeValue(ctx, socket_val);
   }
 
+  js_http_agent_release(client_req, NULL, false);
   return 0;
 }
 
@@ -363,46 +376,59 @@ JSValue js_http_client_request_remove_header(JSContext* ctx, JSValueConst this_v
   return JS_UNDEFINED;
 }
 
-// Phase 4.3: Helper to write data to socket with optional chunked encoding
-static void write_to_socket(JSHTTPClientRequest* client_req, const char* data, size_t data_len) {
-  if (!client_req || !client_req->ctx || JS_IsUndefined(client_req->socket)) {
+// Write bytes to the socket, or hold them until the agent hands this request a socket
+static void write_raw(JSHTTPClientRequest* client_req, const char* data, size_t data_len) {
+  if (client_req->waiting_for_socket) {
+    size_t needed = client_req->pending_output_size + data_len;
+    if (needed > client_req->pending_output_capacity) {
+      size_t new_capacity = client_req->pending_output_capacity ? client_req->pending_output_capacity * 2 : 1024;
+      while (new_capacity < needed) {
+        new_capacity *= 2;
+      }
+      char* new_buffer = realloc(client_req->pending_output, new_capacity);
+      if (!new_buffer) {
+        return;
+      }
+      client_req->pending_output = new_buffer;
+      client_req->pending_output_capacity = new_capacity;
+    }
+    memcpy(client_req->pending_output + client_req->pending_output_size, data, data_len);
+    client_req->pending_output_size = needed;
+    return;
+  }
+
+  if (JS_IsUndefined(client_req->socket)) {
     return;
   }
 
   JSContext* ctx = client_req->ctx;
   JSValue write_method = JS_GetPropertyStr(ctx, client_req->socket, "write");
-
   if (JS_IsFunction(ctx, write_method)) {
-    if (client_req->use_chunked && client_req->headers_sent && data_len > 0) {
-      // Write chunk size in hex + CRLF
-      char chunk_header[32];
-      snprintf(chunk_header, sizeof(chunk_header), "%zx\r\n", data_len);
-
-      JSValue header_str = JS_NewString(ctx, chunk_header);
-      JSValue result = JS_Call(ctx, write_method, client_req->socket, 1, &header_str);
-      JS_FreeValue(ctx, result);
-      JS_FreeValue(ctx, header_str);
+    JSValue data_str = JS_NewStringLen(ctx, data, data_len);
+    JSValue result = JS_Call(ctx, write_method, client_req->socket, 1, &data_str);
+    JS_FreeValue(ctx, result);
+    JS_FreeValue(ctx, data_str);
+  }
+  JS_FreeValue(ctx, write_method);
+}
 
-      // Write chunk data
-      JSValue data_str = JS_NewStringLen(ctx, data, data_len);
-      result = JS_Call(ctx, write_method, client_req->socket, 1, &data_str);
-      JS_FreeValue(ctx, result);
-      JS_FreeValue(ctx, data_str);
+// Phase 4.3: Helper to write data to socket with optional chunked encoding
+static void write_to_socket(JSHTTPClientRequest* client_req, const char* data, size_t data_len) {
+  if (!client_req || !client_req->ctx || (JS_IsUndefined(client_req->socket) && !client_req->waiting_for_socket)) {
+    return;
+  }
 
-      // Write trailing CRLF
-      JSValue crlf = JS_NewString(ctx, "\r\n");
-      result = JS_Call(ctx, write_method, client_req->socket, 1, &crlf);
-      JS_FreeValue(ctx, result);
-      JS_FreeValue(ctx, crlf);
-    } else {
-      // Write data directly (not chunked or before headers sent)
-      JSValue data_str = JS_NewStringLen(ctx, data, data_len);
-      JSValue result = JS_Call(ctx, write_method, client_req->socket, 1, &data_str);
-      JS_FreeValue(ctx, result);
-      JS_FreeValue(ctx, data_str);
-    }
+  if (client_req->use_chunked && client_req->headers_sent && data_len > 0) {
+    // Write chunk size in hex + CRLF, the chunk data, then the trailing CRLF
+    char chunk_header[32];
+    snprintf(chunk_header, sizeof(chunk_header), "%zx\r\n", data_len);
+    write_raw(client_req, chunk_header, strlen(chunk_header));
+    write_raw(client_req, data, data_len);
+    write_raw(client_req, "\r\n", 2);
+  } else {
+    // Write data directly (not chunked or before headers sent)
+    write_raw(client_req, data, data_len);
   }
-  JS_FreeValue(ctx, write_method);
 }
 
 // Helper to send request line and headers
@@ -537,14 +563,7 @@ JSValue js_http_client_request_end(JSContext* ctx, JSValueConst this_val, int ar
   // Phase 4.3: Send chunked encoding terminator if using chunked
   if (client_req->use_chunked) {
     // Send terminator directly to bypass chunked encoding wrapper
-    JSValue write_method = JS_GetPropertyStr(ctx, client_req->socket, "write");
-    if (JS_IsFunction(ctx, write_method)) {
-      JSValue terminator = JS_NewString(ctx, "0\r\n\r\n");
-      JSValue result = JS_Call(ctx, write_method, client_req->socket, 1, &terminator);
-      JS_FreeValue(ctx, result);
-      JS_FreeValue(ctx, terminator);
-    }
-    JS_FreeValue(ctx, write_method);
+    write_raw(client_req, "0\r\n\r\n", 5);
   }
 
   client_req->finished = true;
@@ -587,6 +606,7 @@ JSValue js_http_client_request_abort(JSContext* ctx, JSValueConst this_val, int
     client_req->stream->writable_finished = true;
   }
   client_req->finished = true;
+  js_http_agent_cancel(client_req);
 
   // Destroy socket immediately
   if (!JS_IsUndefined(client_req->socket)) {
@@ -843,6 +863,7 @@ JSValue js_http_client_request_destroy(JSContext* ctx, JSValueConst this_val, in
   client_req->stream->writable_ended = true;
   client_req->stream->writable_finished = true;
   client_req->finished = true;
+  js_http_agent_cancel(client_req);
 
   if (!JS_IsUndefined(client_req->socket)) {
     JSValue destroy_method = JS_GetPropertyStr(ctx, client_req->socket, "destroy");
@@ -917,12 +938,15 @@ void js_http_client_request_finalizer(JSRuntime* rt, JSValue val) {
     free(client_req->current_header_field);
     free(client_req->current_header_value);
     free(client_req->body_buffer);
+    free(client_req->pool_key);
+    free(client_req->pending_output);
 
     // Free JSValues
     JS_FreeValueRT(rt, client_req->socket);
     JS_FreeValueRT(rt, client_req->headers);
     JS_FreeValueRT(rt, client_req->options);
     JS_FreeValueRT(rt, client_req->response_obj);
+    JS_FreeValueRT(rt, client_req->agent_obj);
 
     free(client_req);
   }
@@ -958,6 +982,7 @@ JSValue js_http_client_request_constructor(JSContext* ctx, JSValueConst new_targ
   client_req->port = 80;
   client_req->path = strdup("/");
   client_req->protocol = strdup("http:");
+  client_req->agent_obj = JS_UNDEFINED;
 
   // Phase 4.3: Initialize Writable stream data
   client_req->stream = calloc(1, sizeof(JSStreamData));
@@ -1,3 +1,4 @@
+#include <ctype.h>
 #include "../../runtime.h"
 #include "../stream/stream_internal.h"
 #include "http_internal.h"
@@ -29,8 +30,9 @@ JSValue js_http_request_constructor(JSContext* ctx, JSValueConst new_target, int
 
   req->ctx = ctx;
   req->request_obj = JS_DupValue(ctx, obj);
-  req->headers = JS_NewObject(ctx);
-  req->rawHeaders = JS_NewArray(ctx);
+  // Built from header_list when first read (see js_http_incoming_get_headers)
+  req->headers = JS_UNDEFINED;
+  req->rawHeaders = JS_UNDEFINED;
 
   // Phase 5.1.2: Initialize timeout fields
   req->timeout_timer = NULL;
@@ -88,8 +90,19 @@ JSValue js_http_request_constructor(JSContext* ctx, JSValueConst new_target, int
   JS_SetPropertyStr(ctx, obj, "method", JS_NewString(ctx, "GET"));
   JS_SetPropertyStr(ctx, obj, "url", JS_NewString(ctx, "/"));
   JS_SetPropertyStr(ctx, obj, "httpVersion", JS_NewString(ctx, "1.1"));
-  JS_SetPropertyStr(ctx, obj, "headers", JS_DupValue(ctx, req->headers));
-  JS_SetPropertyStr(ctx, obj, "rawHeaders", JS_DupValue(ctx, req->rawHeaders));
+
+  JSAtom headers_atom = JS_NewAtom(ctx, "headers");
+  JS_DefinePropertyGetSet(ctx, obj, headers_atom, JS_NewCFunction(ctx, js_http_incoming_get_headers, "get headers", 0),
+                          JS_NewCFunction(ctx, js_http_incoming_set_headers, "set headers", 1),
+                          JS_PROP_CONFIGURABLE | JS_PROP_ENUMERABLE);
+  JS_FreeAtom(ctx, headers_atom);
+
+  JSAtom raw_headers_atom = JS_NewAtom(ctx, "rawHeaders");
+  JS_DefinePropertyGetSet(ctx, obj, raw_headers_atom,
+                          JS_NewCFunction(ctx, js_http_incoming_get_raw_headers, "get rawHeaders", 0),
+                          JS_NewCFunction(ctx, js_http_incoming_set_raw_headers, "set rawHeaders", 1),
+                          JS_PROP_CONFIGURABLE | JS_PROP_ENUMERABLE);
+  JS_FreeAtom(ctx, raw_headers_atom);
 
   // Phase 4: Add Readable stream properties
   JSAtom readable_atom = JS_NewAtom(ctx, "readable");
@@ -137,6 +150,132 @@ JSValue js_http_request_constructor(JSContext* ctx, JSValueConst new_target, int
   return obj;
 }
 
+void js_http_header_list_free(JSHttpHeaderList* list) {
+  free(list->data);
+  free(list->slots);
+  memset(list, 0, sizeof(*list));
+}
+
+// Build the `headers` object: lowercased names, repeated headers collected into an array
+static JSValue js_http_headers_from_list(JSContext* ctx, const JSHttpHeaderList* list) {
+  JSValue headers = JS_NewObject(ctx);
+  if (JS_IsException(headers)) {
+    return headers;
+  }
+
+  char stack_name[64];
+  for (uint32_t i = 0; i < list->count; i++) {
+    const JSHttpHeaderSlot* slot = &list->slots[i];
+    char* name = slot->name_length <= sizeof(stack_name) ? stack_name : malloc(slot->name_length);
+    if (!name) {
+      JS_FreeValue(ctx, headers);
+      return JS_ThrowOutOfMemory(ctx);
+    }
+    const char* raw_name = list->data + slot->name_offset;
+    for (uint32_t j = 0; j < slot->name_length; j++) {
+      name[j] = tolower((unsigned char)raw_name[j]);
+    }
+    JSAtom atom = JS_NewAtomLen(ctx, name, slot->name_length);
+    if (name != stack_name) {
+      free(name);
+    }
+    if (atom == JS_ATOM_NULL) {
+      JS_FreeValue(ctx, headers);
+      return JS_EXCEPTION;
+    }
+
+    JSValue value = JS_NewStringLen(ctx, list->data + slot->value_offset, slot->value_length);
+    JSValue existing = JS_GetProperty(ctx, headers, atom);
+    if (JS_IsUndefined(existing)) {
+      JS_SetProperty(ctx, headers, atom, value);
+    } else if (JS_IsArray(ctx, existing)) {
+      // Third or later occurrence: append
+      uint32_t length = 0;
+      JSValue length_val = JS_GetPropertyStr(ctx, existing, "length");
+      JS_ToUint32(ctx, &length, length_val);
+      JS_FreeValue(ctx, length_val);
+      JS_SetPropertyUint32(ctx, existing, length, value);
+      JS_FreeValue(ctx, existing);
+    } else {
+      // Second occurrence: convert to an array
+      JSValue array = JS_NewArray(ctx);
+      JS_SetPropertyUint32(ctx, array, 0, existing);
+      JS_SetPropertyUint32(ctx, array, 1, value);
+      JS_SetProperty(ctx, headers, atom, array);
+    }
+    JS_FreeAtom(ctx, atom);
+  }
+
+  return headers;
+}
+
+// Build the `rawHeaders` array: [name1, value1, name2, value2, ...] as received
+static JSValue js_http_raw_headers_from_list(JSContext* ctx, const JSHttpHeaderList* list) {
+  JSValue raw_headers = JS_NewArray(ctx);
+  if (JS_IsException(raw_headers)) {
+    return raw_headers;
+  }
+
+  for (uint32_t i = 0; i < list->count; i++) {
+    const JSHttpHeaderSlot* slot = &list->slots[i];
+    JS_SetPropertyUint32(ctx, raw_headers, i * 2,
+                         JS_NewStringLen(ctx, list->data + slot->name_offset, slot->name_length));
+    JS_SetPropertyUint32(ctx, raw_headers, i * 2 + 1,
+                         JS_NewStringLen(ctx, list->data + slot->value_offset, slot->value_length));
+  }
+
+  return raw_headers;
+}
+
+// Lazy header properties: most handlers never read headers, so they are only converted to JS on demand
+JSValue js_http_incoming_get_headers(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
+  JSHttpRequest* req = JS_GetOpaque(this_val, js_http_request_class_id);
+  if (!req) {
+    return JS_UNDEFINED;
+  }
+  if (JS_IsUndefined(req->headers)) {
+    JSValue headers = js_http_headers_from_list(ctx, &req->header_list);
+    if (JS_IsException(headers)) {
+      return headers;
+    }
+    req->headers = headers;
+  }
+  return JS_DupValue(ctx, req->headers);
+}
+
+JSValue js_http_incoming_set_headers(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
+  JSHttpRequest* req = JS_GetOpaque(this_val, js_http_request_class_id);
+  if (req && argc > 0) {
+    JS_FreeValue(ctx, req->headers);
+    req->headers = JS_DupValue(ctx, argv[0]);
+  }
+  return JS_UNDEFINED;
+}
+
+JSValue js_http_incoming_get_raw_headers(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
+  JSHttpRequest* req = JS_GetOpaque(this_val, js_http_request_class_id);
+  if (!req) {
+    return JS_UNDEFINED;
+  }
+  if (JS_IsUndefined(req->rawHeaders)) {
+    JSValue raw_headers = js_http_raw_headers_from_list(ctx, &req->header_list);
+    if (JS_IsException(raw_headers)) {
+      return raw_headers;
+    }
+    req->rawHeaders = raw_headers;
+  }
+  return JS_DupValue(ctx, req->rawHeaders);
+}
+
+JSValue js_http_incoming_set_raw_headers(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
+  JSHttpRequest* req = JS_GetOpaque(this_val, js_http_request_class_id);
+  if (req && argc > 0) {
+    JS_FreeValue(ctx, req->rawHeaders);
+    req->rawHeaders = JS_DupValue(ctx, argv[0]);
+  }
+  return JS_UNDEFINED;
+}
+
 // Phase 4.4: Readable stream property getters and destroy()
 JSValue js_http_incoming_readable(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
   JSHttpRequest* req = JS_GetOpaque(this_val, js_http_request_class_id);
@@ -697,12 +836,7 @@ void js_http_incoming_end(JSContext* ctx, JSValue incoming_msg) {
 
   JSRT_Runtime* runtime = JS_GetContextOpaque(ctx);
   if (runtime) {
-    JSRuntime* qjs_runtime = JS_GetRuntime(ctx);
-    while (JS_IsJobPending(qjs_runtime)) {
-      if (!JSRT_RuntimeRunTicket(runtime)) {
-        break;
-      }
-    }
+    JSRT_RuntimeDrainMicrotasks(runtime);
   }
 }
 
@@ -789,6 +923,7 @@ void js_http_request_finalizer(JSRuntime* rt, JSValue val) {
     free(req->http_version);
     JS_FreeValueRT(rt, req->headers);
     JS_FreeValueRT(rt, req->rawHeaders);
+    js_http_header_list_free(&req->header_list);
     JS_FreeValueRT(rt, req->socket);
 
     // Phase 5.1.2: Clean up timeout timer
@@ -62,6 +62,8 @@
 #include <uv.h>
 #include "../../../deps/llhttp/build/llhttp.h"
 #include "../../runtime.h"
+#include "../../util/conn_pool.h"
+#include "../net/net_internal.h"
 #include "../node_modules.h"
 #include "../stream/stream_internal.h"  // Phase 4: Stream integration
 
@@ -88,6 +90,9 @@ extern JSClassID js_http_response_class_id;
 /** @brief Class ID for http.ClientRequest objects */
 extern JSClassID js_http_client_request_class_id;
 
+/** @brief Class ID for http.Agent objects */
+extern JSClassID js_http_agent_class_id;
+
 /** @} */
 
 /**
@@ -110,6 +115,33 @@ extern JSClassID js_http_client_request_class_id;
 
 /** @} */
 
+/**
+ * @brief One parsed header, stored as offsets into JSHttpHeaderList::data
+ */
+typedef struct {
+  uint32_t name_offset;  /**< Offset of the header name */
+  uint32_t name_length;  /**< Length of the header name */
+  uint32_t value_offset; /**< Offset of the header value */
+  uint32_t value_length; /**< Length of the header value */
+} JSHttpHeaderSlot;
+
+/**
+ * @brief Compact header storage for a parsed request
+ *
+ * The llhttp callbacks append header names and values to one byte buffer
+ * (joining pieces split across reads) and record them in a slot array.
+ * IncomingMessage builds its JS `headers`/`rawHeaders` from this only when
+ * they are first read, so handlers that never look at headers pay no JS cost.
+ */
+typedef struct {
+  char* data;              /**< Names and values back to back (not NUL-terminated) */
+  size_t data_size;        /**< Bytes used in data */
+  size_t data_capacity;    /**< Bytes allocated for data */
+  JSHttpHeaderSlot* slots; /**< Headers in arrival order */
+  uint32_t count;          /**< Number of headers */
+  uint32_t capacity;       /**< Slots allocated */
+} JSHttpHeaderList;
+
 /**
  * @brief HTTP connection state for server-side request parsing
  *
@@ -120,7 +152,8 @@ extern JSClassID js_http_client_request_class_id;
  * ## Lifecycle
  *
  * 1. Created when net.Server emits 'connection' event
- * 2. Attached to socket's 'data' event handler
+ * 2. Fed straight from the socket's libuv read buffer (net read hook), or
+ *    attached to the socket's 'data' event for sockets that are not net.Socket
  * 3. Parses incoming data incrementally via llhttp callbacks
  * 4. Emits 'request' event on server with IncomingMessage/ServerResponse pair
  * 5. Supports keep-alive for multiple requests on same connection
@@ -153,11 +186,11 @@ typedef struct {
   bool request_complete;      /**< Whether current request parsing is complete */
 
   /** @name Header Accumulation
-   * Buffers for incremental header parsing
+   * Compact storage for incremental header parsing, moved to the request at headers complete
    * @{
    */
-  char* current_header_field; /**< Current header field name being accumulated */
-  char* current_header_value; /**< Current header value being accumulated */
+  JSHttpHeaderList headers; /**< Headers of the message being parsed */
+  bool in_header_field;     /**< A header name is being accumulated (it may span reads) */
   /** @} */
 
   /** @name URL Accumulation
@@ -301,15 +334,16 @@ typedef struct {
  * @see js_http_incoming_set_timeout() for timeout management
  */
 typedef struct {
-  JSContext* ctx;       /**< QuickJS context */
-  JSValue request_obj;  /**< JavaScript IncomingMessage object */
-  char* method;         /**< HTTP method (GET, POST, etc.) */
-  char* url;            /**< Request URL path */
-  char* http_version;   /**< HTTP version string (e.g., "1.1") */
-  JSValue headers;      /**< Request headers object */
-  JSValue rawHeaders;   /**< Raw headers array [name1, value1, name2, value2, ...] */
-  JSValue socket;       /**< Associated net.Socket object */
-  JSStreamData* stream; /**< Readable stream implementation (Phase 4) */
+  JSContext* ctx;               /**< QuickJS context */
+  JSValue request_obj;          /**< JavaScript IncomingMessage object */
+  char* method;                 /**< HTTP method (GET, POST, etc.) */
+  char* url;                    /**< Request URL path */
+  char* http_version;           /**< HTTP version string (e.g., "1.1") */
+  JSValue headers;              /**< Request headers object (JS_UNDEFINED until first read) */
+  JSValue rawHeaders;           /**< Raw headers array [name1, value1, ...] (JS_UNDEFINED until first read) */
+  JSHttpHeaderList header_list; /**< Parsed headers the JS values are built from */
+  JSValue socket;               /**< Associated net.Socket object */
+  JSStreamData* stream;         /**< Readable stream implementation (Phase 4) */
 
   /** @name Timeout Handling (Phase 5.1.2)
    * Per-request timeout support
@@ -375,6 +409,7 @@ typedef struct {
   char* status_message; /**< HTTP status message (e.g., "OK", "Not Found") */
   JSValue headers;      /**< Response headers object */
   bool use_chunked;     /**< Use chunked transfer encoding */
+  bool no_body;         /**< 1xx, 204 or 304: no body and no framing headers */
   JSStreamData* stream; /**< Writable stream implementation (Phase 4.2) */
 } JSHttpResponse;
 
@@ -429,6 +464,13 @@ typedef struct {
  * - Does NOT auto-destroy the request
  * - Application should call req.destroy() on timeout
  *
+ * ## Agent Pooling
+ *
+ * Requests made through an http.Agent take a socket slot from the agent's pool:
+ * - An idle keep-alive socket to the same host:port is reused when available
+ * - Past maxSockets the request waits, buffering its output in pending_output
+ * - On a keep-alive response the socket goes back to the pool instead of closing
+ *
  * ## Stream Interface (Phase 4.3)
  *
  * ClientRequest implements Writable stream:
@@ -486,8 +528,37 @@ typedef struct {
   JSStreamData* stream; /**< Writable stream implementation */
   bool use_chunked;     /**< Use chunked encoding for request body */
   /** @} */
+
+  /** @name Agent Pooling
+   * Socket slot held in the agent's connection pool
+   * @{
+   */
+  JSValue agent_obj;              /**< http.Agent used for the request (JS_UNDEFINED for agent: false) */
+  char* pool_key;                 /**< "host:port" origin key in the agent's pool */
+  bool holds_pool_slot;           /**< Counted as an active socket by the agent's pool */
+  bool waiting_for_socket;        /**< Queued in the agent's pool until a socket is free */
+  char* pending_output;           /**< Request bytes written while waiting for a socket */
+  size_t pending_output_size;     /**< Bytes in pending_output */
+  size_t pending_output_capacity; /**< Capacity of pending_output */
+  /** @} */
 } JSHTTPClientRequest;
 
+/**
+ * @brief http.Agent state
+ *
+ * Each agent owns a per-origin pool of net.Socket connections (entries are the
+ * sockets' JSNetConnection). Idle sockets are unref'd so they never keep the
+ * process alive, and they are closed after the agent's timeout. Agents are
+ * kept on a per-thread list so their pools are torn down while the event loop
+ * still runs (see jsrt_http_agents_cleanup()).
+ */
+typedef struct JSHTTPAgent {
+  JSContext* ctx;           /**< QuickJS context */
+  JSRT_ConnPool* pool;      /**< Socket pool (NULL once the runtime is shutting down) */
+  bool keep_alive;          /**< Keep sockets open for later requests */
+  struct JSHTTPAgent* next; /**< Next agent on the per-thread list */
+} JSHTTPAgent;
+
 /**
  * @brief HTTP request handler data structure
  *
@@ -635,6 +706,21 @@ JSValue js_http_incoming_readable_high_water_mark(JSContext* ctx, JSValueConst t
 /** @brief Getter for IncomingMessage.destroyed property */
 JSValue js_http_incoming_destroyed(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv);
 
+/** @brief Getter for IncomingMessage.headers (built from the parsed header list on first access) */
+JSValue js_http_incoming_get_headers(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv);
+
+/** @brief Setter for IncomingMessage.headers */
+JSValue js_http_incoming_set_headers(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv);
+
+/** @brief Getter for IncomingMessage.rawHeaders (built from the parsed header list on first access) */
+JSValue js_http_incoming_get_raw_headers(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv);
+
+/** @brief Setter for IncomingMessage.rawHeaders */
+JSValue js_http_incoming_set_raw_headers(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv);
+
+/** @brief Frees the buffers of a header list and resets it to empty */
+void js_http_header_list_free(JSHttpHeaderList* list);
+
 /** @brief Destroys the IncomingMessage stream */
 JSValue js_http_incoming_destroy(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv);
 
@@ -749,6 +835,9 @@ int on_status(llhttp_t* parser, const char* at, size_t length);
 /** @brief Called when header field name is parsed (may be called multiple times) */
 int on_header_field(llhttp_t* parser, const char* at, size_t length);
 
+/** @brief Called once a header field name is complete */
+int on_header_field_complete(llhttp_t* parser);
+
 /** @brief Called when header field value is parsed (may be called multiple times) */
 int on_header_value(llhttp_t* parser, const char* at, size_t length);
 
@@ -816,7 +905,7 @@ JSValue js_http_net_connection_handler(JSContext* ctx, JSValueConst this_val, in
 /** @brief Simple (legacy) socket 'data' event handler */
 JSValue js_http_simple_data_handler(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv);
 
-/** @brief llhttp-based socket 'data' event handler (current) */
+/** @brief llhttp-based socket 'data' event handler (sockets without a native read hook) */
 JSValue js_http_llhttp_data_handler(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv, int magic,
                                     JSValueConst* func_data);
 
@@ -868,9 +957,38 @@ JSValue js_http_request(JSContext* ctx, JSValueConst this_val, int argc, JSValue
  */
 JSValue js_http_get(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv);
 
-/** @brief Constructor for http.Agent (connection pooling - stub) */
+/**
+ * @brief Constructor for http.Agent
+ * @param argv Arguments: [options] (keepAlive, maxSockets, maxFreeSockets, timeout)
+ */
 JSValue js_http_agent_constructor(JSContext* ctx, JSValueConst new_target, int argc, JSValueConst* argv);
 
+/** @brief Finalizer for http.Agent objects */
+void js_http_agent_finalizer(JSRuntime* rt, JSValue val);
+
+/**
+ * @brief Whether a finished request may hand its socket back to the agent for reuse
+ */
+bool js_http_agent_keeps_alive(JSHTTPClientRequest* client_req);
+
+/**
+ * @brief Returns the request's socket slot to its agent's pool
+ *
+ * With reusable set, socket_conn goes idle (or straight to a queued request);
+ * otherwise only the slot is released and the caller closes the socket.
+ */
+void js_http_agent_release(JSHTTPClientRequest* client_req, JSNetConnection* socket_conn, bool reusable);
+
+/** @brief Drops a request still waiting for a socket from its agent's queue */
+void js_http_agent_cancel(JSHTTPClientRequest* client_req);
+
+/**
+ * @brief Closes the idle sockets of every agent on this thread
+ *
+ * Called from JSRT_RuntimeFree() before the event loop is torn down.
+ */
+void jsrt_http_agents_cleanup(void);
+
 /** @} */
 
 /**
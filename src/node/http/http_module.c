@@ -1,6 +1,8 @@
 #include <ctype.h>
+#include <math.h>
 #include <stdint.h>
 #include "../../util/debug.h"
+#include "../../util/macro.h"
 #include "../net/net_internal.h"
 #include "http_client.h"
 #include "http_internal.h"
@@ -12,6 +14,10 @@ JSClassID js_http_response_class_id;
 JSClassID js_http_client_request_class_id;
 JSClassID js_http_agent_class_id;
 
+// http.Agent defaults: Node's globalAgent keeps free sockets for 5 seconds
+#define JSRT_HTTP_AGENT_MAX_FREE_SOCKETS 256
+#define JSRT_HTTP_AGENT_TIMEOUT_MS 5000
+
 // Helper function to add EventEmitter methods and proper inheritance
 void setup_event_emitter_inheritance(JSContext* ctx, JSValue obj) {
   JSValue events_module = JSRT_LoadNodeModuleCommonJS(ctx, "events");
@@ -143,39 +149,39 @@ static int parse_url_components(JSContext* ctx, const char* url_str, char** host
   return 0;
 }
 
-// Socket data handler for client response parsing
-static JSValue http_client_socket_data_handler(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv,
-                                               int magic, JSValueConst* func_data) {
-  if (argc < 1 || !func_data) {
-    return JS_UNDEFINED;
-  }
-
-  int64_t raw_ptr = 0;
-  if (JS_ToInt64(ctx, &raw_ptr, func_data[0])) {
+// Socket data handler for client response parsing; the socket's current request owns the parser
+static JSValue http_client_socket_data_handler(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
+  if (argc < 1) {
     return JS_UNDEFINED;
   }
 
-  JSHTTPClientRequest* client_req = (JSHTTPClientRequest*)(uintptr_t)raw_ptr;
+  JSValue client_req_val = JS_GetPropertyStr(ctx, this_val, "_clientRequest");
+  JSHTTPClientRequest* client_req = JS_GetOpaque(client_req_val, js_http_client_request_class_id);
   if (!client_req) {
+    // Data on an idle keep-alive socket can't belong to any request, so the socket is unusable
+    JS_FreeValue(ctx, client_req_val);
+    JSValue result = js_socket_destroy(ctx, this_val, 0, NULL);
+    JS_FreeValue(ctx, result);
     return JS_UNDEFINED;
   }
 
   JSRT_Debug_Truncated("[debug] client handler req=%p argc=%d\n", client_req, argc);
 
   // Parse received data with llhttp
-  size_t data_len;
-  uint8_t* data = JS_GetArrayBuffer(ctx, &data_len, argv[0]);
+  size_t data_len = 0;
+  uint8_t* data = jsrt_node_buffer_source_bytes(ctx, argv[0], &data_len);
   if (data) {
     llhttp_execute(&client_req->parser, (const char*)data, data_len);
   } else {
     // Try to get string data
-    const char* str_data = JS_ToCString(ctx, argv[0]);
+    const char* str_data = JS_ToCStringLen(ctx, &data_len, argv[0]);
     if (str_data) {
-      llhttp_execute(&client_req->parser, str_data, strlen(str_data));
+      llhttp_execute(&client_req->parser, str_data, data_len);
       JS_FreeCString(ctx, str_data);
     }
   }
 
+  JS_FreeValue(ctx, client_req_val);
   return JS_UNDEFINED;
 }
 
@@ -208,6 +214,259 @@ static JSValue http_client_socket_connect_handler(JSContext* ctx, JSValueConst t
   return JS_UNDEFINED;
 }
 
+// Agents on this thread, so their pools can be closed before the event loop goes away
+static JSRT_THREAD_LOCAL JSHTTPAgent* g_http_agents = NULL;
+
+bool js_http_agent_keeps_alive(JSHTTPClientRequest* client_req) {
+  JSHTTPAgent* agent = JS_GetOpaque(client_req->agent_obj, js_http_agent_class_id);
+  return client_req->holds_pool_slot && agent && agent->pool && agent->keep_alive;
+}
+
+void js_http_agent_release(JSHTTPClientRequest* client_req, JSNetConnection* socket_conn, bool reusable) {
+  if (!client_req->holds_pool_slot) {
+    return;
+  }
+  client_req->holds_pool_slot = false;
+
+  JSHTTPAgent* agent = JS_GetOpaque(client_req->agent_obj, js_http_agent_class_id);
+  if (!agent || !agent->pool) {
+    return;
+  }
+  JSRT_ConnPoolRelease(agent->pool, client_req->pool_key, socket_conn, reusable && socket_conn);
+}
+
+void js_http_agent_cancel(JSHTTPClientRequest* client_req) {
+  if (!client_req->waiting_for_socket) {
+    return;
+  }
+  client_req->waiting_for_socket = false;
+
+  JSHTTPAgent* agent = JS_GetOpaque(client_req->agent_obj, js_http_agent_class_id);
+  if (agent && agent->pool) {
+    JSRT_ConnPoolCancel(agent->pool, client_req->pool_key, client_req);
+  }
+  // Drop the reference taken while the request was queued
+  JS_FreeValue(client_req->ctx, client_req->request_obj);
+}
+
+// Pool close callback: the socket timed out idle, exceeded maxFreeSockets or the agent is going away
+static void http_agent_close_socket(void* conn, void* opaque) {
+  JSNetConnection* socket_conn = (JSNetConnection*)conn;
+  if (socket_conn->destroyed || JS_IsUndefined(socket_conn->socket_obj)) {
+    return;
+  }
+
+  JSContext* ctx = socket_conn->ctx;
+  JSValue socket = JS_DupValue(ctx, socket_conn->socket_obj);
+  JSValue result = js_socket_destroy(ctx, socket, 0, NULL);
+  JS_FreeValue(ctx, result);
+  JS_FreeValue(ctx, socket);
+}
+
+// Socket 'close' for agent sockets: forget the socket if idle, else release the slot of its request
+static JSValue http_agent_socket_close_handler(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv,
+                                               int magic, JSValueConst* func_data) {
+  JSHTTPAgent* agent = JS_GetOpaque(func_data[0], js_http_agent_class_id);
+  JSNetConnection* socket_conn = JS_GetOpaque(this_val, js_socket_class_id);
+  if (!agent || !agent->pool || !socket_conn) {
+    return JS_UNDEFINED;
+  }
+
+  const char* key = JS_ToCString(ctx, func_data[1]);
+  if (!key) {
+    return JS_EXCEPTION;
+  }
+
+  if (!JSRT_ConnPoolRemoveIdle(agent->pool, key, socket_conn)) {
+    JSValue client_req_val = JS_GetPropertyStr(ctx, this_val, "_clientRequest");
+    JSHTTPClientRequest* client_req = JS_GetOpaque(client_req_val, js_http_client_request_class_id);
+    if (client_req) {
+      js_http_agent_release(client_req, NULL, false);
+    }
+    JS_FreeValue(ctx, client_req_val);
+  }
+
+  JS_FreeCString(ctx, key);
+  return JS_UNDEFINED;
+}
+
+// Resolve the agent of a request: options.agent, http.globalAgent by default, none for agent: false
+static JSValue http_request_get_agent(JSContext* ctx, JSValueConst options) {
+  if (JS_IsObject(options)) {
+    JSValue agent_val = JS_GetPropertyStr(ctx, options, "agent");
+    if (JS_IsBool(agent_val) && !JS_ToBool(ctx, agent_val)) {
+      return JS_UNDEFINED;
+    }
+    if (JS_GetOpaque(agent_val, js_http_agent_class_id)) {
+      return agent_val;
+    }
+    JS_FreeValue(ctx, agent_val);
+  }
+
+  JSValue http_module = JSRT_LoadNodeModuleCommonJS(ctx, "http");
+  if (JS_IsException(http_module)) {
+    JS_FreeValue(ctx, JS_GetException(ctx));
+    return JS_UNDEFINED;
+  }
+  JSValue global_agent = JS_GetPropertyStr(ctx, http_module, "globalAgent");
+  JS_FreeValue(ctx, http_module);
+  if (!JS_GetOpaque(global_agent, js_http_agent_class_id)) {
+    JS_FreeValue(ctx, global_agent);
+    return JS_UNDEFINED;
+  }
+  return global_agent;
+}
+
+// Attach a socket to a request; output written while the request waited for it is sent now
+static void http_client_assign_socket(JSContext* ctx, JSHTTPClientRequest* req_data, JSValueConst socket) {
+  req_data->socket = JS_DupValue(ctx, socket);
+  JSNetConnection* socket_conn = JS_GetOpaque(socket, js_socket_class_id);
+  if (socket_conn) {
+    socket_conn->is_http_client = true;
+    if (!JS_IsUndefined(socket_conn->client_request_obj)) {
+      JS_FreeValue(ctx, socket_conn->client_request_obj);
+    }
+    socket_conn->client_request_obj = JS_DupValue(ctx, req_data->request_obj);
+  }
+
+  // Store client request reference on socket for data handler
+  JS_SetPropertyStr(ctx, socket, "_clientRequest", JS_DupValue(ctx, req_data->request_obj));
+
+  if (req_data->pending_output_size > 0) {
+    JSValue data = JS_NewArrayBufferCopy(ctx, (const uint8_t*)req_data->pending_output, req_data->pending_output_size);
+    JSValue result = js_socket_write(ctx, socket, 1, &data);
+    JS_FreeValue(ctx, result);
+    JS_FreeValue(ctx, data);
+    free(req_data->pending_output);
+    req_data->pending_output = NULL;
+    req_data->pending_output_size = 0;
+    req_data->pending_output_capacity = 0;
+  }
+}
+
+// Create a net.Socket for the request and start connecting it
+static JSValue http_client_create_socket(JSContext* ctx, JSHTTPClientRequest* req_data) {
+  JSValue net_module = JSRT_LoadNodeModuleCommonJS(ctx, "net");
+  if (JS_IsException(net_module)) {
+    return net_module;
+  }
+
+  JSValue socket_constructor = JS_GetPropertyStr(ctx, net_module, "Socket");
+  JSValue socket = JS_CallConstructor(ctx, socket_constructor, 0, NULL);
+  JS_FreeValue(ctx, socket_constructor);
+  JS_FreeValue(ctx, net_module);
+
+  if (JS_IsException(socket)) {
+    return socket;
+  }
+
+  http_client_assign_socket(ctx, req_data, socket);
+
+  // Set up socket event handlers
+  JSValue on_method = JS_GetPropertyStr(ctx, socket, "on");
+  if (JS_IsFunction(ctx, on_method)) {
+    // on('data') - parse HTTP response
+    JSValue data_handler = JS_NewCFunction(ctx, http_client_socket_data_handler, "dataHandler", 1);
+    JSValue args[] = {JS_NewString(ctx, "data"), data_handler};
+    JSValue result = JS_Call(ctx, on_method, socket, 2, args);
+    if (JS_IsException(result)) {
+      JSValue exception = JS_GetException(ctx);
+      const char* err = JS_ToCString(ctx, exception);
+      JSRT_Debug_Truncated("[debug] failed to attach data handler: %s\n", err ? err : "<unknown>");
+      JS_FreeCString(ctx, err);
+      JS_FreeValue(ctx, exception);
+    }
+    JS_FreeValue(ctx, result);
+    JS_FreeValue(ctx, args[0]);
+    // data_handler is now owned by event system
+
+    // on('ready') - emit 'socket' event on request (socket emits 'ready' not 'connect')
+    JSValue connect_handler = JS_NewCFunction(ctx, http_client_socket_connect_handler, "connectHandler", 0);
+    JSValue connect_args[] = {JS_NewString(ctx, "ready"), connect_handler};
+    result = JS_Call(ctx, on_method, socket, 2, connect_args);
+    JS_FreeValue(ctx, result);
+    JS_FreeValue(ctx, connect_args[0]);
+
+    // on('close') - keep the agent's pool in sync with the socket
+    if (req_data->holds_pool_slot) {
+      JSValue close_data[] = {JS_DupValue(ctx, req_data->agent_obj), JS_NewString(ctx, req_data->pool_key)};
+      JSValue close_handler = JS_NewCFunctionData(ctx, http_agent_socket_close_handler, 0, 0, 2, close_data);
+      JS_FreeValue(ctx, close_data[0]);
+      JS_FreeValue(ctx, close_data[1]);
+      JSValue close_args[] = {JS_NewString(ctx, "close"), close_handler};
+      result = JS_Call(ctx, on_method, socket, 2, close_args);
+      JS_FreeValue(ctx, result);
+      JS_FreeValue(ctx, close_args[0]);
+    }
+  }
+  JS_FreeValue(ctx, on_method);
+
+  // Connect socket
+  JSValue connect_method = JS_GetPropertyStr(ctx, socket, "connect");
+  if (JS_IsFunction(ctx, connect_method)) {
+    JSValue connect_args[] = {JS_NewInt32(ctx, req_data->port),
+                              JS_NewString(ctx, req_data->host ? req_data->host : "localhost")};
+    JSValue result = JS_Call(ctx, connect_method, socket, 2, connect_args);
+    JS_FreeValue(ctx, result);
+    JS_FreeValue(ctx, connect_args[0]);
+    JS_FreeValue(ctx, connect_args[1]);
+  }
+  JS_FreeValue(ctx, connect_method);
+
+  return socket;
+}
+
+// Microtask emitting 'socket' for a request that got an already connected keep-alive socket
+static JSValue http_client_reused_socket_job(JSContext* ctx, int argc, JSValueConst* argv) {
+  return http_client_socket_connect_handler(ctx, argv[0], 0, NULL);
+}
+
+// Give the request a socket: the idle pooled one, or a new connection when pooled is NULL
+static int http_client_use_socket(JSContext* ctx, JSHTTPClientRequest* req_data, JSNetConnection* pooled) {
+  if (!pooled) {
+    JSValue socket = http_client_create_socket(ctx, req_data);
+    if (JS_IsException(socket)) {
+      return -1;
+    }
+    JS_FreeValue(ctx, socket);
+    return 0;
+  }
+
+  JSValue socket = JS_DupValue(ctx, pooled->socket_obj);
+  JSRT_Debug_Truncated("[debug] reusing keep-alive socket %p for %s\n", pooled, req_data->pool_key);
+  uv_ref((uv_handle_t*)&pooled->handle);
+  http_client_assign_socket(ctx, req_data, socket);
+  JS_EnqueueJob(ctx, http_client_reused_socket_job, 1, (JSValueConst*)&socket);
+  JS_FreeValue(ctx, socket);
+  return 0;
+}
+
+// The agent's pool has a socket slot (and maybe an idle socket) for a queued request
+static void http_client_on_pool_ready(void* conn, void* waiter) {
+  JSHTTPClientRequest* req_data = (JSHTTPClientRequest*)waiter;
+  JSContext* ctx = req_data->ctx;
+
+  req_data->waiting_for_socket = false;
+  req_data->holds_pool_slot = true;
+
+  if (http_client_use_socket(ctx, req_data, (JSNetConnection*)conn) < 0) {
+    js_http_agent_release(req_data, NULL, false);
+    JSValue error = JS_GetException(ctx);
+    JSValue emit = JS_GetPropertyStr(ctx, req_data->request_obj, "emit");
+    if (JS_IsFunction(ctx, emit)) {
+      JSValue args[] = {JS_NewString(ctx, "error"), error};
+      JSValue result = JS_Call(ctx, emit, req_data->request_obj, 2, args);
+      JS_FreeValue(ctx, result);
+      JS_FreeValue(ctx, args[0]);
+    }
+    JS_FreeValue(ctx, emit);
+    JS_FreeValue(ctx, error);
+  }
+
+  // Drop the reference taken while the request was queued
+  JS_FreeValue(ctx, req_data->request_obj);
+}
+
 // HTTP request function (full implementation)
 JSValue js_http_request(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
   if (argc < 1) {
@@ -364,92 +623,50 @@ JSValue js_http_request(JSContext* ctx, JSValueConst this_val, int argc, JSValue
   }
   JS_FreeValue(ctx, host_header);
 
-  // Set Connection: close by default (no keep-alive for now)
+  JSValue agent_obj = http_request_get_agent(ctx, options);
+  JSHTTPAgent* agent = JS_GetOpaque(agent_obj, js_http_agent_class_id);
+  if (agent && !agent->pool) {
+    agent = NULL;
+  }
+
+  // Ask the server to keep the connection open only when the agent will pool it
   JSValue connection_header = JS_GetPropertyStr(ctx, req_data->headers, "connection");
   if (JS_IsUndefined(connection_header)) {
-    JS_SetPropertyStr(ctx, req_data->headers, "connection", JS_NewString(ctx, "close"));
+    JS_SetPropertyStr(ctx, req_data->headers, "connection",
+                      JS_NewString(ctx, agent && agent->keep_alive ? "keep-alive" : "close"));
   }
   JS_FreeValue(ctx, connection_header);
 
-  // Create TCP socket and connect
-  JSValue net_module = JSRT_LoadNodeModuleCommonJS(ctx, "net");
-  if (JS_IsException(net_module)) {
-    JS_FreeValue(ctx, client_req);
-    if (!JS_IsUndefined(options))
-      JS_FreeValue(ctx, options);
-    return net_module;
-  }
-
-  JSValue socket_constructor = JS_GetPropertyStr(ctx, net_module, "Socket");
-  JSValue socket = JS_CallConstructor(ctx, socket_constructor, 0, NULL);
-  JS_FreeValue(ctx, socket_constructor);
-  JS_FreeValue(ctx, net_module);
-
-  if (JS_IsException(socket)) {
-    JS_FreeValue(ctx, client_req);
-    if (!JS_IsUndefined(options))
-      JS_FreeValue(ctx, options);
-    return socket;
-  }
-
-  // Store socket in ClientRequest
-  req_data->socket = JS_DupValue(ctx, socket);
-  JSNetConnection* socket_conn = JS_GetOpaque(socket, js_socket_class_id);
-  if (socket_conn) {
-    socket_conn->is_http_client = true;
-    if (!JS_IsUndefined(socket_conn->client_request_obj)) {
-      JS_FreeValue(ctx, socket_conn->client_request_obj);
+  int acquired = 1;
+  void* pooled = NULL;
+  if (agent) {
+    char pool_key[512];
+    snprintf(pool_key, sizeof(pool_key), "%s:%d", req_data->host ? req_data->host : "localhost", req_data->port);
+    req_data->pool_key = strdup(pool_key);
+    if (req_data->pool_key) {
+      req_data->agent_obj = JS_DupValue(ctx, agent_obj);
+      acquired = JSRT_ConnPoolAcquire(agent->pool, req_data->pool_key, &pooled, http_client_on_pool_ready, req_data);
+      if (acquired > 0) {
+        req_data->holds_pool_slot = true;
+      } else if (acquired == 0) {
+        // Past maxSockets: wait for a socket, keeping the request alive meanwhile
+        req_data->waiting_for_socket = true;
+        JS_DupValue(ctx, req_data->request_obj);
+      }
     }
-    socket_conn->client_request_obj = JS_DupValue(ctx, client_req);
   }
+  JS_FreeValue(ctx, agent_obj);
 
   // Create IncomingMessage for response
   req_data->response_obj = js_http_request_constructor(ctx, JS_UNDEFINED, 0, NULL);
 
-  // Set up socket event handlers
-  JSValue on_method = JS_GetPropertyStr(ctx, socket, "on");
-  if (JS_IsFunction(ctx, on_method)) {
-    // Store client request reference on socket for data handler
-    JS_SetPropertyStr(ctx, socket, "_clientRequest", JS_DupValue(ctx, client_req));
-
-    // on('data') - parse HTTP response
-    JSValue handler_data = JS_NewInt64(ctx, (int64_t)(uintptr_t)req_data);
-    JSValue data_handler = JS_NewCFunctionData(ctx, http_client_socket_data_handler, 1, 0, 1, &handler_data);
-    JS_FreeValue(ctx, handler_data);
-    JSValue args[] = {JS_NewString(ctx, "data"), data_handler};
-    JSValue result = JS_Call(ctx, on_method, socket, 2, args);
-    if (JS_IsException(result)) {
-      JSValue exception = JS_GetException(ctx);
-      const char* err = JS_ToCString(ctx, exception);
-      JSRT_Debug_Truncated("[debug] failed to attach data handler: %s\n", err ? err : "<unknown>");
-      JS_FreeCString(ctx, err);
-      JS_FreeValue(ctx, exception);
-    }
-    JS_FreeValue(ctx, result);
-    JS_FreeValue(ctx, args[0]);
-    // data_handler is now owned by event system
-
-    // on('ready') - emit 'socket' event on request (socket emits 'ready' not 'connect')
-    JSValue connect_handler = JS_NewCFunction(ctx, http_client_socket_connect_handler, "connectHandler", 0);
-    JSValue connect_args[] = {JS_NewString(ctx, "ready"), connect_handler};
-    result = JS_Call(ctx, on_method, socket, 2, connect_args);
-    JS_FreeValue(ctx, result);
-    JS_FreeValue(ctx, connect_args[0]);
-  }
-  JS_FreeValue(ctx, on_method);
-
-  // Connect socket
-  JSValue connect_method = JS_GetPropertyStr(ctx, socket, "connect");
-  if (JS_IsFunction(ctx, connect_method)) {
-    JSValue connect_args[] = {JS_NewInt32(ctx, req_data->port),
-                              JS_NewString(ctx, req_data->host ? req_data->host : "localhost")};
-    JSValue result = JS_Call(ctx, connect_method, socket, 2, connect_args);
-    JS_FreeValue(ctx, result);
-    JS_FreeValue(ctx, connect_args[0]);
-    JS_FreeValue(ctx, connect_args[1]);
+  if (acquired != 0 && http_client_use_socket(ctx, req_data, (JSNetConnection*)pooled) < 0) {
+    js_http_agent_release(req_data, NULL, false);
+    JS_FreeValue(ctx, client_req);
+    if (!JS_IsUndefined(options))
+      JS_FreeValue(ctx, options);
+    return JS_EXCEPTION;
   }
-  JS_FreeValue(ctx, connect_method);
-  JS_FreeValue(ctx, socket);
 
   // Register callback if provided (last argument)
   int callback_idx = argc - 1;
@@ -491,33 +708,141 @@ JSValue js_http_get(JSContext* ctx, JSValueConst this_val, int argc, JSValueCons
   return client_req;
 }
 
+// agent.getStats() - counters of the agent's socket pool
+static JSValue js_http_agent_get_stats(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
+  JSHTTPAgent* agent = JS_GetOpaque(this_val, js_http_agent_class_id);
+  if (!agent) {
+    return JS_ThrowTypeError(ctx, "Invalid Agent object");
+  }
+
+  JSRT_ConnPoolStats stats = {0};
+  if (agent->pool) {
+    JSRT_ConnPoolGetStats(agent->pool, &stats);
+  }
+
+  JSValue obj = JS_NewObject(ctx);
+  JS_SetPropertyStr(ctx, obj, "created", JS_NewInt64(ctx, (int64_t)stats.created));
+  JS_SetPropertyStr(ctx, obj, "reused", JS_NewInt64(ctx, (int64_t)stats.reused));
+  JS_SetPropertyStr(ctx, obj, "timedOut", JS_NewInt64(ctx, (int64_t)stats.timed_out));
+  JS_SetPropertyStr(ctx, obj, "evicted", JS_NewInt64(ctx, (int64_t)stats.evicted));
+  JS_SetPropertyStr(ctx, obj, "active", JS_NewUint32(ctx, stats.active));
+  JS_SetPropertyStr(ctx, obj, "idle", JS_NewUint32(ctx, stats.idle));
+  JS_SetPropertyStr(ctx, obj, "waiting", JS_NewUint32(ctx, stats.waiting));
+  return obj;
+}
+
+// agent.destroy() - close the idle sockets; sockets serving requests close when they finish
+static JSValue js_http_agent_destroy(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
+  JSHTTPAgent* agent = JS_GetOpaque(this_val, js_http_agent_class_id);
+  if (agent && agent->pool) {
+    JSRT_ConnPoolCloseIdle(agent->pool);
+  }
+  return JS_UNDEFINED;
+}
+
+// Read a non-negative count option; Infinity (or any non-finite value) means unlimited (0)
+static int http_agent_count_option(JSContext* ctx, JSValueConst options, const char* name, int* out) {
+  JSValue value = JS_GetPropertyStr(ctx, options, name);
+  int found = 0;
+  double number;
+  if (JS_IsNumber(value) && JS_ToFloat64(ctx, &number, value) == 0 && number >= 0) {
+    *out = number < INT32_MAX ? (int)number : 0;
+    found = 1;
+  }
+  JS_FreeValue(ctx, value);
+  return found;
+}
+
 // HTTP Agent constructor for connection pooling
 JSValue js_http_agent_constructor(JSContext* ctx, JSValueConst new_target, int argc, JSValueConst* argv) {
-  JSValue agent = JS_NewObject(ctx);
+  JSValueConst options = argc > 0 && JS_IsObject(argv[0]) ? argv[0] : JS_UNDEFINED;
+
+  JSRT_ConnPoolOptions pool_options = {
+      .max_sockets = 0,
+      .max_free_sockets = JSRT_HTTP_AGENT_MAX_FREE_SOCKETS,
+      .idle_timeout_ms = JSRT_HTTP_AGENT_TIMEOUT_MS,
+  };
+  bool keep_alive = false;
+
+  if (JS_IsObject(options)) {
+    JSValue keep_alive_val = JS_GetPropertyStr(ctx, options, "keepAlive");
+    if (JS_IsBool(keep_alive_val)) {
+      keep_alive = JS_ToBool(ctx, keep_alive_val);
+    }
+    JS_FreeValue(ctx, keep_alive_val);
+
+    http_agent_count_option(ctx, options, "maxSockets", &pool_options.max_sockets);
+    http_agent_count_option(ctx, options, "maxFreeSockets", &pool_options.max_free_sockets);
+    int timeout_ms;
+    if (http_agent_count_option(ctx, options, "timeout", &timeout_ms)) {
+      pool_options.idle_timeout_ms = (uint64_t)timeout_ms;
+    }
+  }
+
+  JSValue agent = JS_NewObjectClass(ctx, js_http_agent_class_id);
+  if (JS_IsException(agent)) {
+    return agent;
+  }
+
+  JSHTTPAgent* agent_data = calloc(1, sizeof(JSHTTPAgent));
+  if (!agent_data) {
+    JS_FreeValue(ctx, agent);
+    return JS_ThrowOutOfMemory(ctx);
+  }
+
+  JSRT_Runtime* rt = JS_GetContextOpaque(ctx);
+  agent_data->ctx = ctx;
+  agent_data->keep_alive = keep_alive;
+  agent_data->pool = JSRT_ConnPoolNew(rt->uv_loop, &pool_options, http_agent_close_socket, agent_data);
+  if (!agent_data->pool) {
+    free(agent_data);
+    JS_FreeValue(ctx, agent);
+    return JS_ThrowOutOfMemory(ctx);
+  }
+  agent_data->next = g_http_agents;
+  g_http_agents = agent_data;
+  JS_SetOpaque(agent, agent_data);
 
   // Set default properties
-  JS_SetPropertyStr(ctx, agent, "maxSockets", JS_NewInt32(ctx, 5));
-  JS_SetPropertyStr(ctx, agent, "maxFreeSockets", JS_NewInt32(ctx, 256));
-  JS_SetPropertyStr(ctx, agent, "timeout", JS_NewInt32(ctx, 30000));  // 30 seconds
-  JS_SetPropertyStr(ctx, agent, "keepAlive", JS_TRUE);
+  JS_SetPropertyStr(ctx, agent, "maxSockets",
+                    pool_options.max_sockets > 0 ? JS_NewInt32(ctx, pool_options.max_sockets)
+                                                 : JS_NewFloat64(ctx, INFINITY));
+  JS_SetPropertyStr(ctx, agent, "maxFreeSockets", JS_NewInt32(ctx, pool_options.max_free_sockets));
+  JS_SetPropertyStr(ctx, agent, "timeout", JS_NewInt64(ctx, (int64_t)pool_options.idle_timeout_ms));
+  JS_SetPropertyStr(ctx, agent, "keepAlive", JS_NewBool(ctx, keep_alive));
   JS_SetPropertyStr(ctx, agent, "protocol", JS_NewString(ctx, "http:"));
 
-  // Parse options if provided
-  if (argc > 0 && JS_IsObject(argv[0])) {
-    JSValue maxSockets = JS_GetPropertyStr(ctx, argv[0], "maxSockets");
-    if (JS_IsNumber(maxSockets)) {
-      JS_SetPropertyStr(ctx, agent, "maxSockets", JS_DupValue(ctx, maxSockets));
-    }
-    JS_FreeValue(ctx, maxSockets);
+  JS_SetPropertyStr(ctx, agent, "getStats", JS_NewCFunction(ctx, js_http_agent_get_stats, "getStats", 0));
+  JS_SetPropertyStr(ctx, agent, "destroy", JS_NewCFunction(ctx, js_http_agent_destroy, "destroy", 0));
 
-    JSValue keepAlive = JS_GetPropertyStr(ctx, argv[0], "keepAlive");
-    if (JS_IsBool(keepAlive)) {
-      JS_SetPropertyStr(ctx, agent, "keepAlive", JS_DupValue(ctx, keepAlive));
+  return agent;
+}
+
+void js_http_agent_finalizer(JSRuntime* rt, JSValue val) {
+  JSHTTPAgent* agent = JS_GetOpaque(val, js_http_agent_class_id);
+  if (!agent) {
+    return;
+  }
+
+  for (JSHTTPAgent** link = &g_http_agents; *link; link = &(*link)->next) {
+    if (*link == agent) {
+      *link = agent->next;
+      break;
     }
-    JS_FreeValue(ctx, keepAlive);
   }
 
-  return agent;
+  // Idle sockets keep their agent reachable through their 'close' listeners, so the pool is empty here
+  JSRT_ConnPoolFree(agent->pool);
+  free(agent);
+}
+
+void jsrt_http_agents_cleanup(void) {
+  for (JSHTTPAgent* agent = g_http_agents; agent; agent = agent->next) {
+    // Clear the pointer first: closing a socket emits 'close', whose handler checks the pool
+    JSRT_ConnPool* pool = agent->pool;
+    agent->pool = NULL;
+    JSRT_ConnPoolFree(pool);
+  }
 }
 
 // Class definitions
@@ -541,6 +866,11 @@ static JSClassDef js_http_client_request_class = {
     .finalizer = js_http_client_request_finalizer,
 };
 
+static JSClassDef js_http_agent_class = {
+    "Agent",
+    .finalizer = js_http_agent_finalizer,
+};
+
 // Module initialization
 JSValue JSRT_InitNodeHttp(JSContext* ctx) {
   JSValue http_module = JS_NewObject(ctx);
@@ -550,12 +880,14 @@ JSValue JSRT_InitNodeHttp(JSContext* ctx) {
   JS_NewClassID(&js_http_response_class_id);
   JS_NewClassID(&js_http_request_class_id);
   JS_NewClassID(&js_http_client_request_class_id);
+  JS_NewClassID(&js_http_agent_class_id);
 
   // Create class definitions
   JS_NewClass(JS_GetRuntime(ctx), js_http_server_class_id, &js_http_server_class);
   JS_NewClass(JS_GetRuntime(ctx), js_http_response_class_id, &js_http_response_class);
   JS_NewClass(JS_GetRuntime(ctx), js_http_request_class_id, &js_http_request_class);
   JS_NewClass(JS_GetRuntime(ctx), js_http_client_request_class_id, &js_http_client_request_class);
+  JS_NewClass(JS_GetRuntime(ctx), js_http_agent_class_id, &js_http_agent_class);
 
   // Create constructors
   JSValue server_ctor = JS_NewCFunction2(ctx, js_http_server_constructor, "Server", 0, JS_CFUNC_constructor, 0);
@@ -618,11 +950,10 @@ JSValue JSRT_InitNodeHttp(JSContext* ctx) {
   JS_SetPropertyStr(ctx, http_module, "STATUS_CODES", status_codes);
 
   // Global agent with connection pooling
-  JSValue globalAgent = js_http_agent_constructor(ctx, JS_UNDEFINED, 0, NULL);
-  JS_SetPropertyStr(ctx, globalAgent, "maxSockets", JS_NewInt32(ctx, 5));
-  JS_SetPropertyStr(ctx, globalAgent, "maxFreeSockets", JS_NewInt32(ctx, 256));
-  JS_SetPropertyStr(ctx, globalAgent, "keepAlive", JS_TRUE);
-  JS_SetPropertyStr(ctx, globalAgent, "protocol", JS_NewString(ctx, "http:"));
+  JSValue global_agent_options = JS_NewObject(ctx);
+  JS_SetPropertyStr(ctx, global_agent_options, "keepAlive", JS_TRUE);
+  JSValue globalAgent = js_http_agent_constructor(ctx, JS_UNDEFINED, 1, &global_agent_options);
+  JS_FreeValue(ctx, global_agent_options);
   JS_SetPropertyStr(ctx, http_module, "globalAgent", globalAgent);
 
   return http_module;
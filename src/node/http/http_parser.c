@@ -1,8 +1,10 @@
 #include <ctype.h>
 #include <stdbool.h>
 #include <stdint.h>
+#include "../net/net_internal.h"
 #include "http_incoming.h"
 #include "http_internal.h"
+#include "../../util/macro.h"
 
 // HTTP Parser implementation with full llhttp integration
 // Adapted from src/http/parser.c with node:http specific enhancements
@@ -13,7 +15,7 @@ typedef struct ConnectionNode {
   struct ConnectionNode* next;
 } ConnectionNode;
 
-static ConnectionNode* g_active_connections = NULL;
+static JSRT_THREAD_LOCAL ConnectionNode* g_active_connections = NULL;
 
 static void track_connection(JSHttpConnection* conn) {
   ConnectionNode* node = malloc(sizeof(ConnectionNode));
@@ -37,6 +39,15 @@ static void untrack_connection(JSHttpConnection* conn) {
   }
 }
 
+// Route the socket's received bytes back to 'data' events (connection closed or upgraded)
+static void http_connection_detach_read_hook(JSHttpConnection* conn) {
+  JSNetConnection* net_conn = JS_GetOpaque(conn->socket, js_socket_class_id);
+  if (net_conn && net_conn->read_hook_opaque == conn) {
+    net_conn->read_hook = NULL;
+    net_conn->read_hook_opaque = NULL;
+  }
+}
+
 static void cleanup_connection(JSHttpConnection* conn) {
   if (!conn)
     return;
@@ -50,6 +61,9 @@ static void cleanup_connection(JSHttpConnection* conn) {
 
   untrack_connection(conn);
 
+  // Stop the socket from feeding a parser that no longer exists
+  http_connection_detach_read_hook(conn);
+
   // Free all connection resources
   JS_FreeValue(conn->ctx, conn->server);
   JS_FreeValue(conn->ctx, conn->socket);
@@ -60,8 +74,7 @@ static void cleanup_connection(JSHttpConnection* conn) {
     JS_FreeValue(conn->ctx, conn->current_response);
   }
 
-  free(conn->current_header_field);
-  free(conn->current_header_value);
+  js_http_header_list_free(&conn->headers);
   free(conn->url_buffer);
   free(conn->body_buffer);
 
@@ -97,21 +110,6 @@ static char* jsrt_strndup(const char* str, size_t n) {
   return copy;
 }
 
-// Utility: Convert string to lowercase for case-insensitive header storage
-static char* str_to_lower(const char* str) {
-  if (!str)
-    return NULL;
-  size_t len = strlen(str);
-  char* lower = malloc(len + 1);
-  if (!lower)
-    return NULL;
-  for (size_t i = 0; i < len; i++) {
-    lower[i] = tolower((unsigned char)str[i]);
-  }
-  lower[len] = '\0';
-  return lower;
-}
-
 // Utility: Append to dynamic buffer
 static int buffer_append(char** buffer, size_t* size, size_t* capacity, const char* data, size_t len) {
   if (!buffer || !data || len == 0)
@@ -137,6 +135,24 @@ static int buffer_append(char** buffer, size_t* size, size_t* capacity, const ch
   return 0;
 }
 
+// Utility: First header named `name` (case-insensitive), or NULL
+static const JSHttpHeaderSlot* header_list_find(const JSHttpHeaderList* list, const char* name) {
+  size_t name_len = strlen(name);
+  for (uint32_t i = 0; i < list->count; i++) {
+    const JSHttpHeaderSlot* slot = &list->slots[i];
+    if (slot->name_length == name_len && strncasecmp(list->data + slot->name_offset, name, name_len) == 0) {
+      return slot;
+    }
+  }
+  return NULL;
+}
+
+// Utility: Case-insensitive comparison of a header value
+static bool header_value_equals(const JSHttpHeaderList* list, const JSHttpHeaderSlot* slot, const char* value) {
+  size_t value_len = strlen(value);
+  return slot->value_length == value_len && strncasecmp(list->data + slot->value_offset, value, value_len) == 0;
+}
+
 // Timeout callback for server connections
 static void connection_timeout_callback(uv_timer_t* timer) {
   JSHttpConnection* conn = (JSHttpConnection*)timer->data;
@@ -194,10 +210,8 @@ int on_message_begin(llhttp_t* parser) {
   }
 
   // Reset parsing state
-  free(conn->current_header_field);
-  conn->current_header_field = NULL;
-  free(conn->current_header_value);
-  conn->current_header_value = NULL;
+  js_http_header_list_free(&conn->headers);
+  conn->in_header_field = false;
   free(conn->url_buffer);
   conn->url_buffer = NULL;
   conn->url_buffer_size = 0;
@@ -251,86 +265,56 @@ int on_status(llhttp_t* parser, const char* at, size_t length) {
   return 0;
 }
 
-// llhttp callback: Header field
+// llhttp callback: Header field (may be called multiple times for one name)
 int on_header_field(llhttp_t* parser, const char* at, size_t length) {
   JSHttpConnection* conn = (JSHttpConnection*)parser->data;
-  JSContext* ctx = conn->ctx;
-
-  // If we have a complete previous header (field + value), store it
-  if (conn->current_header_field && conn->current_header_value) {
-    JSHttpRequest* req = JS_GetOpaque(conn->current_request, js_http_request_class_id);
-    if (req) {
-      // Add to rawHeaders array [field, value, field, value, ...]
-      JSValue length_val = JS_GetPropertyStr(ctx, req->rawHeaders, "length");
-      uint32_t length = 0;
-      JS_ToUint32(ctx, &length, length_val);
-      JS_FreeValue(ctx, length_val);
-
-      JS_SetPropertyUint32(ctx, req->rawHeaders, length, JS_NewString(ctx, conn->current_header_field));
-      JS_SetPropertyUint32(ctx, req->rawHeaders, length + 1, JS_NewString(ctx, conn->current_header_value));
-
-      // Normalize header name to lowercase
-      char* lower_name = str_to_lower(conn->current_header_field);
-      if (lower_name) {
-        // Check if header already exists (multi-value header)
-        JSValue existing = JS_GetPropertyStr(ctx, req->headers, lower_name);
-        if (!JS_IsUndefined(existing)) {
-          // Multi-value header: convert to array or append to array
-          if (JS_IsArray(ctx, existing)) {
-            // Already an array, append
-            JSValue new_value = JS_NewString(ctx, conn->current_header_value);
-            JSValue push = JS_GetPropertyStr(ctx, existing, "push");
-            JSValue args[] = {new_value};
-            JS_Call(ctx, push, existing, 1, args);
-            JS_FreeValue(ctx, push);
-            JS_FreeValue(ctx, new_value);
-          } else {
-            // Convert to array
-            JSValue array = JS_NewArray(ctx);
-            JS_SetPropertyUint32(ctx, array, 0, JS_DupValue(ctx, existing));
-            JSValue new_value = JS_NewString(ctx, conn->current_header_value);
-            JS_SetPropertyUint32(ctx, array, 1, new_value);
-            JS_SetPropertyStr(ctx, req->headers, lower_name, array);
-          }
-        } else {
-          // First occurrence of this header
-          JS_SetPropertyStr(ctx, req->headers, lower_name, JS_NewString(ctx, conn->current_header_value));
-        }
-        JS_FreeValue(ctx, existing);
-        free(lower_name);
-      }
+  JSHttpHeaderList* list = &conn->headers;
+
+  // The first piece of a name starts a new header slot
+  if (!conn->in_header_field) {
+    if (list->count == list->capacity) {
+      uint32_t new_capacity = list->capacity == 0 ? 16 : list->capacity * 2;
+      JSHttpHeaderSlot* slots = realloc(list->slots, new_capacity * sizeof(JSHttpHeaderSlot));
+      if (!slots)
+        return -1;
+      list->slots = slots;
+      list->capacity = new_capacity;
     }
-
-    free(conn->current_header_field);
-    free(conn->current_header_value);
-    conn->current_header_field = NULL;
-    conn->current_header_value = NULL;
+    JSHttpHeaderSlot* slot = &list->slots[list->count++];
+    memset(slot, 0, sizeof(*slot));
+    slot->name_offset = (uint32_t)list->data_size;
+    conn->in_header_field = true;
   }
 
-  // Start accumulating new header field
-  conn->current_header_field = jsrt_strndup(at, length);
-  return conn->current_header_field ? 0 : -1;
+  if (buffer_append(&list->data, &list->data_size, &list->data_capacity, at, length) != 0)
+    return -1;
+  list->slots[list->count - 1].name_length += (uint32_t)length;
+  return 0;
 }
 
-// llhttp callback: Header value
-int on_header_value(llhttp_t* parser, const char* at, size_t length) {
+// llhttp callback: Header field complete
+int on_header_field_complete(llhttp_t* parser) {
   JSHttpConnection* conn = (JSHttpConnection*)parser->data;
+  conn->in_header_field = false;
+  return 0;
+}
 
-  // Accumulate header value (may be called multiple times)
-  if (!conn->current_header_value) {
-    conn->current_header_value = jsrt_strndup(at, length);
-    return conn->current_header_value ? 0 : -1;
-  } else {
-    // Append to existing value
-    size_t old_len = strlen(conn->current_header_value);
-    char* new_value = realloc(conn->current_header_value, old_len + length + 1);
-    if (!new_value)
-      return -1;
-    memcpy(new_value + old_len, at, length);
-    new_value[old_len + length] = '\0';
-    conn->current_header_value = new_value;
+// llhttp callback: Header value (may be called multiple times)
+int on_header_value(llhttp_t* parser, const char* at, size_t length) {
+  JSHttpConnection* conn = (JSHttpConnection*)parser->data;
+  JSHttpHeaderList* list = &conn->headers;
+  if (list->count == 0 || length == 0)
     return 0;
+
+  // Value pieces arrive back to back, right after the name
+  JSHttpHeaderSlot* slot = &list->slots[list->count - 1];
+  if (slot->value_length == 0) {
+    slot->value_offset = (uint32_t)list->data_size;
   }
+  if (buffer_append(&list->data, &list->data_size, &list->data_capacity, at, length) != 0)
+    return -1;
+  slot->value_length += (uint32_t)length;
+  return 0;
 }
 
 // llhttp callback: Headers complete
@@ -338,51 +322,6 @@ int on_headers_complete(llhttp_t* parser) {
   JSHttpConnection* conn = (JSHttpConnection*)parser->data;
   JSContext* ctx = conn->ctx;
 
-  // Store final header if present
-  if (conn->current_header_field && conn->current_header_value) {
-    JSHttpRequest* req = JS_GetOpaque(conn->current_request, js_http_request_class_id);
-    if (req) {
-      // Add to rawHeaders array
-      JSValue length_val = JS_GetPropertyStr(ctx, req->rawHeaders, "length");
-      uint32_t length = 0;
-      JS_ToUint32(ctx, &length, length_val);
-      JS_FreeValue(ctx, length_val);
-
-      JS_SetPropertyUint32(ctx, req->rawHeaders, length, JS_NewString(ctx, conn->current_header_field));
-      JS_SetPropertyUint32(ctx, req->rawHeaders, length + 1, JS_NewString(ctx, conn->current_header_value));
-
-      char* lower_name = str_to_lower(conn->current_header_field);
-      if (lower_name) {
-        JSValue existing = JS_GetPropertyStr(ctx, req->headers, lower_name);
-        if (!JS_IsUndefined(existing)) {
-          if (JS_IsArray(ctx, existing)) {
-            JSValue new_value = JS_NewString(ctx, conn->current_header_value);
-            JSValue push = JS_GetPropertyStr(ctx, existing, "push");
-            JSValue args[] = {new_value};
-            JS_Call(ctx, push, existing, 1, args);
-            JS_FreeValue(ctx, push);
-            JS_FreeValue(ctx, new_value);
-          } else {
-            JSValue array = JS_NewArray(ctx);
-            JS_SetPropertyUint32(ctx, array, 0, JS_DupValue(ctx, existing));
-            JSValue new_value = JS_NewString(ctx, conn->current_header_value);
-            JS_SetPropertyUint32(ctx, array, 1, new_value);
-            JS_SetPropertyStr(ctx, req->headers, lower_name, array);
-          }
-        } else {
-          JS_SetPropertyStr(ctx, req->headers, lower_name, JS_NewString(ctx, conn->current_header_value));
-        }
-        JS_FreeValue(ctx, existing);
-        free(lower_name);
-      }
-    }
-
-    free(conn->current_header_field);
-    free(conn->current_header_value);
-    conn->current_header_field = NULL;
-    conn->current_header_value = NULL;
-  }
-
   // Set request metadata
   JSHttpRequest* req = JS_GetOpaque(conn->current_request, js_http_request_class_id);
   if (req) {
@@ -424,60 +363,31 @@ int on_headers_complete(llhttp_t* parser) {
       JS_SetPropertyStr(ctx, conn->current_request, "httpVersion", JS_NewString(ctx, req->http_version));
     }
 
-    // Check Connection header for keep-alive
-    JSValue conn_header = JS_GetPropertyStr(ctx, req->headers, "connection");
-    bool connection_processed = false;
-
-    if (!JS_IsUndefined(conn_header)) {
-      // Handle array case (multiple Connection headers)
-      if (JS_IsArray(ctx, conn_header)) {
-        // Get the first element
-        JSValue first_elem = JS_GetPropertyUint32(ctx, conn_header, 0);
-        if (JS_IsString(first_elem)) {
-          const char* conn_str = JS_ToCString(ctx, first_elem);
-          if (conn_str) {
-            conn->keep_alive = (strcasecmp(conn_str, "keep-alive") == 0);
-            conn->should_close = (strcasecmp(conn_str, "close") == 0);
-            connection_processed = true;
-            JS_FreeCString(ctx, conn_str);
-          }
-        }
-        JS_FreeValue(ctx, first_elem);
-      }
-      // Handle string case (single Connection header)
-      else if (JS_IsString(conn_header)) {
-        const char* conn_str = JS_ToCString(ctx, conn_header);
-        if (conn_str) {
-          conn->keep_alive = (strcasecmp(conn_str, "keep-alive") == 0);
-          conn->should_close = (strcasecmp(conn_str, "close") == 0);
-          connection_processed = true;
-          JS_FreeCString(ctx, conn_str);
-        }
-      }
-    }
-
-    if (!connection_processed) {
+    // Connection, Expect and Upgrade are checked on the compact header list, without building JS headers
+    const JSHttpHeaderList* headers = &conn->headers;
+    const JSHttpHeaderSlot* conn_header = header_list_find(headers, "connection");
+    if (conn_header) {
+      conn->keep_alive = header_value_equals(headers, conn_header, "keep-alive");
+      conn->should_close = header_value_equals(headers, conn_header, "close");
+    } else {
       // HTTP/1.1 defaults to keep-alive, HTTP/1.0 defaults to close
       conn->keep_alive = (parser->http_major == 1 && parser->http_minor == 1);
       conn->should_close = !conn->keep_alive;
     }
-    JS_FreeValue(ctx, conn_header);
-
-    // Check for Expect: 100-continue
-    JSValue expect_header = JS_GetPropertyStr(ctx, req->headers, "expect");
-    const char* expect_str = JS_ToCString(ctx, expect_header);
-    if (expect_str) {
-      conn->expect_continue = (strcasecmp(expect_str, "100-continue") == 0);
-      JS_FreeCString(ctx, expect_str);
-    } else {
-      conn->expect_continue = false;
-    }
-    JS_FreeValue(ctx, expect_header);
 
-    // Check for Upgrade header
-    JSValue upgrade_header = JS_GetPropertyStr(ctx, req->headers, "upgrade");
-    conn->is_upgrade = !JS_IsUndefined(upgrade_header);
-    JS_FreeValue(ctx, upgrade_header);
+    const JSHttpHeaderSlot* expect_header = header_list_find(headers, "expect");
+    conn->expect_continue = expect_header && header_value_equals(headers, expect_header, "100-continue");
+    conn->is_upgrade = header_list_find(headers, "upgrade") != NULL;
+
+    // Hand the headers to the request; IncomingMessage builds its JS headers from them on demand
+    js_http_header_list_free(&req->header_list);
+    req->header_list = conn->headers;
+    memset(&conn->headers, 0, sizeof(conn->headers));
+  }
+
+  // After an upgrade the socket belongs to the 'upgrade' handler, which reads it through 'data' events
+  if (conn->is_upgrade) {
+    http_connection_detach_read_hook(conn);
   }
 
   if (!conn->request_emitted) {
@@ -715,6 +625,62 @@ JSValue js_http_simple_data_handler(JSContext* ctx, JSValueConst this_val, int a
   return JS_UNDEFINED;
 }
 
+// Feed received bytes to llhttp; the connection may be freed when this returns
+static void http_connection_execute(JSHttpConnection* conn, const char* data, size_t data_len) {
+  JSContext* ctx = conn->ctx;
+
+  // CRITICAL: Set parsing flag to prevent cleanup during parse
+  conn->parsing_in_progress = true;
+
+  // Parse with llhttp
+  llhttp_errno_t err = llhttp_execute(&conn->parser, data, data_len);
+
+  // CRITICAL: Clear parsing flag and check for deferred cleanup
+  conn->parsing_in_progress = false;
+  if (conn->cleanup_deferred) {
+    cleanup_connection(conn);
+    return;
+  }
+
+  if (err != HPE_OK && err != HPE_PAUSED && err != HPE_PAUSED_UPGRADE) {
+    // Parse error - emit error event on server
+    JSValue emit = JS_GetPropertyStr(ctx, conn->server, "emit");
+    if (JS_IsFunction(ctx, emit)) {
+      JSValue error = JS_NewError(ctx);
+      const char* err_msg = llhttp_errno_name(err);
+      JS_SetPropertyStr(ctx, error, "message", JS_NewString(ctx, err_msg ? err_msg : "HTTP parse error"));
+
+      JSValue args[] = {JS_NewString(ctx, "clientError"), error, JS_DupValue(ctx, conn->socket)};
+      JSValue result = JS_Call(ctx, emit, conn->server, 3, args);
+      JS_FreeValue(ctx, result);
+      JS_FreeValue(ctx, args[0]);
+      JS_FreeValue(ctx, args[1]);
+      JS_FreeValue(ctx, args[2]);
+    }
+    JS_FreeValue(ctx, emit);
+
+    // CRITICAL FIX #1.2: Reset parser state for potential reuse
+    llhttp_init(&conn->parser, HTTP_REQUEST, &conn->settings);
+    conn->parser.data = conn;
+
+    // Mark connection for cleanup
+    conn->should_close = true;
+
+    // Close connection on error
+    JSValue end_method = JS_GetPropertyStr(ctx, conn->socket, "end");
+    if (JS_IsFunction(ctx, end_method)) {
+      JSValue result = JS_Call(ctx, end_method, conn->socket, 0, NULL);
+      JS_FreeValue(ctx, result);
+    }
+    JS_FreeValue(ctx, end_method);
+  }
+}
+
+// Native read hook - parses straight from the socket's libuv read buffer
+static void http_connection_on_read(void* opaque, const char* data, size_t len) {
+  http_connection_execute((JSHttpConnection*)opaque, data, len);
+}
+
 // HTTP connection handler with llhttp parser
 void js_http_connection_handler(JSContext* ctx, JSValue server, JSValue socket) {
   // Allocate connection state
@@ -769,6 +735,7 @@ void js_http_connection_handler(JSContext* ctx, JSValue server, JSValue socket)
   conn->settings.on_url = on_url;
   conn->settings.on_status = on_status;
   conn->settings.on_header_field = on_header_field;
+  conn->settings.on_header_field_complete = on_header_field_complete;
   conn->settings.on_header_value = on_header_value;
   conn->settings.on_headers_complete = on_headers_complete;
   conn->settings.on_body = on_body;
@@ -779,9 +746,14 @@ void js_http_connection_handler(JSContext* ctx, JSValue server, JSValue socket)
   llhttp_init(&conn->parser, HTTP_REQUEST, &conn->settings);
   conn->parser.data = conn;
 
-  // Set up socket 'data' listener
-  JSValue on_method = JS_GetPropertyStr(ctx, socket, "on");
-  if (JS_IsFunction(ctx, on_method)) {
+  // net.Socket connections are parsed directly from the libuv read buffer; anything else
+  // that looks like a socket is fed through its 'data' events
+  JSNetConnection* net_conn = JS_GetOpaque(socket, js_socket_class_id);
+  JSValue on_method = net_conn ? JS_UNDEFINED : JS_GetPropertyStr(ctx, socket, "on");
+  if (net_conn) {
+    net_conn->read_hook = http_connection_on_read;
+    net_conn->read_hook_opaque = conn;
+  } else if (JS_IsFunction(ctx, on_method)) {
     // Create data handler that parses with llhttp
     JSValue handler_data = JS_NewInt64(ctx, (int64_t)(uintptr_t)conn);
     JSValue data_handler = JS_NewCFunctionData(ctx, js_http_llhttp_data_handler, 1, 0, 1, &handler_data);
@@ -840,7 +812,7 @@ void js_http_connection_handler(JSContext* ctx, JSValue server, JSValue socket)
   JS_FreeValue(ctx, emit);
 }
 
-// llhttp data handler - parses incoming socket data
+// llhttp data handler - parses socket 'data' events (sockets without a native read hook)
 JSValue js_http_llhttp_data_handler(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv, int magic,
                                     JSValueConst* func_data) {
   if (argc < 1 || !func_data)
@@ -855,68 +827,23 @@ JSValue js_http_llhttp_data_handler(JSContext* ctx, JSValueConst this_val, int a
   if (!conn)
     return JS_UNDEFINED;
 
-  // Get data buffer
-  size_t data_len;
-  const char* data;
+  // Get data buffer: Buffer chunks are parsed in place, strings via their C string
+  size_t data_len = 0;
+  const char* cstr = NULL;
+  const char* data = (const char*)jsrt_node_buffer_source_bytes(ctx, argv[0], &data_len);
 
-  if (JS_IsString(argv[0])) {
-    data = JS_ToCStringLen(ctx, &data_len, argv[0]);
-  } else {
-    // Handle Buffer/Uint8Array
-    data = JS_ToCString(ctx, argv[0]);
-    data_len = data ? strlen(data) : 0;
+  if (!data) {
+    cstr = JS_ToCStringLen(ctx, &data_len, argv[0]);
+    data = cstr;
   }
 
   if (!data)
     return JS_UNDEFINED;
 
-  // CRITICAL: Set parsing flag to prevent cleanup during parse
-  conn->parsing_in_progress = true;
-
-  // Parse with llhttp
-  llhttp_errno_t err = llhttp_execute(&conn->parser, data, data_len);
-
-  // CRITICAL: Clear parsing flag and check for deferred cleanup
-  conn->parsing_in_progress = false;
-  if (conn->cleanup_deferred) {
-    JS_FreeCString(ctx, data);
-    cleanup_connection(conn);
-    return JS_UNDEFINED;
-  }
-
-  if (err != HPE_OK && err != HPE_PAUSED && err != HPE_PAUSED_UPGRADE) {
-    // Parse error - emit error event on server
-    JSValue emit = JS_GetPropertyStr(ctx, conn->server, "emit");
-    if (JS_IsFunction(ctx, emit)) {
-      JSValue error = JS_NewError(ctx);
-      const char* err_msg = llhttp_errno_name(err);
-      JS_SetPropertyStr(ctx, error, "message", JS_NewString(ctx, err_msg ? err_msg : "HTTP parse error"));
-
-      JSValue args[] = {JS_NewString(ctx, "clientError"), error, JS_DupValue(ctx, conn->socket)};
-      JSValue result = JS_Call(ctx, emit, conn->server, 3, args);
-      JS_FreeValue(ctx, result);
-      JS_FreeValue(ctx, args[0]);
-      JS_FreeValue(ctx, args[1]);
-      JS_FreeValue(ctx, args[2]);
-    }
-    JS_FreeValue(ctx, emit);
-
-    // CRITICAL FIX #1.2: Reset parser state for potential reuse
-    llhttp_init(&conn->parser, HTTP_REQUEST, &conn->settings);
-    conn->parser.data = conn;
-
-    // Mark connection for cleanup
-    conn->should_close = true;
-
-    // Close connection on error
-    JSValue end_method = JS_GetPropertyStr(ctx, conn->socket, "end");
-    if (JS_IsFunction(ctx, end_method)) {
-      JS_Call(ctx, end_method, conn->socket, 0, NULL);
-    }
-    JS_FreeValue(ctx, end_method);
-  }
+  http_connection_execute(conn, data, data_len);
 
-  JS_FreeCString(ctx, data);
+  if (cstr)
+    JS_FreeCString(ctx, cstr);
   return JS_UNDEFINED;
 }
 
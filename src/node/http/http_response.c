@@ -1,5 +1,8 @@
 #include <ctype.h>
+#include <time.h>
+#include "../../util/buffer_pin.h"
 #include "../../util/debug.h"
+#include "../../util/macro.h"
 #include "../../util/user_agent.h"
 #include "http_internal.h"
 
@@ -30,6 +33,7 @@ JSValue js_http_response_write_head(JSContext* ctx, JSValueConst this_val, int a
 
   if (argc > 2 && JS_IsObject(argv[2])) {
     // Set headers from object
+    JS_FreeValue(ctx, res->headers);
     res->headers = JS_DupValue(ctx, argv[2]);
   }
 
@@ -57,38 +61,325 @@ static int http_response_buffer_chunk(JSContext* ctx, JSStreamData* stream, JSVa
   return 0;
 }
 
-static void http_response_write_to_socket(JSHttpResponse* res, const char* data, size_t data_len) {
-  if (!res || data_len == 0 || JS_IsUndefined(res->socket)) {
+// Growable byte buffer for the status line, header block and chunk size lines
+typedef struct {
+  char* data;
+  size_t size;
+  size_t capacity;
+} HttpResponseBuffer;
+
+static bool http_response_buffer_append(HttpResponseBuffer* buf, const char* data, size_t len) {
+  if (buf->size + len > buf->capacity) {
+    size_t new_capacity = buf->capacity == 0 ? 512 : buf->capacity * 2;
+    while (new_capacity < buf->size + len) {
+      new_capacity *= 2;
+    }
+    char* new_data = realloc(buf->data, new_capacity);
+    if (!new_data) {
+      return false;
+    }
+    buf->data = new_data;
+    buf->capacity = new_capacity;
+  }
+  memcpy(buf->data + buf->size, data, len);
+  buf->size += len;
+  return true;
+}
+
+static bool http_response_buffer_append_str(HttpResponseBuffer* buf, const char* str) {
+  return http_response_buffer_append(buf, str, strlen(str));
+}
+
+// Response output: the pieces of one write()/end() (header block, chunk framing, body) are queued
+// on the net.Socket's write batch and reach the kernel as a single writev. Other socket objects get
+// one socket.write() with the pieces concatenated.
+typedef struct {
+  JSHttpResponse* res;
+  JSNetConnection* conn;    // Native socket, or NULL to use socket.write()
+  HttpResponseBuffer copy;  // Concatenated output for socket.write()
+  bool discard;             // No usable socket: output is dropped
+} HttpResponseOutput;
+
+static void http_response_output_init(HttpResponseOutput* out, JSHttpResponse* res) {
+  memset(out, 0, sizeof(*out));
+  out->res = res;
+  if (JS_IsUndefined(res->socket)) {
+    out->discard = true;
     return;
   }
+  out->conn = JS_GetOpaque(res->socket, js_socket_class_id);
+  if (out->conn && (out->conn->destroyed || !out->conn->connected)) {
+    out->discard = true;
+  }
+}
+
+// Queue a piece of output; `owner` keeps the bytes alive until they are written and is released here
+// when the bytes are copied or dropped
+static void http_response_output_add(HttpResponseOutput* out, const char* data, size_t len, JSNetWriteChunk* owner) {
+  JSContext* ctx = out->res->ctx;
+  if (len > 0 && !out->discard) {
+    if (out->conn) {
+      if (js_net_connection_enqueue_write(out->conn, data, len, owner)) {
+        out->conn->bytes_written += len;
+        return;
+      }
+      out->discard = true;
+    } else if (!http_response_buffer_append(&out->copy, data, len)) {
+      out->discard = true;
+    }
+  }
+  js_net_write_chunk_free(ctx, owner);
+}
+
+static void http_response_output_add_static(HttpResponseOutput* out, const char* str) {
+  JSNetWriteChunk owner = {JS_UNDEFINED, NULL, NULL};
+  http_response_output_add(out, str, strlen(str), &owner);
+}
 
+// Send the queued output: the socket's batch is flushed at the end of the tick (or by socket.end())
+static void http_response_output_commit(HttpResponseOutput* out) {
+  JSHttpResponse* res = out->res;
   JSContext* ctx = res->ctx;
-  JSValue write_method = JS_GetPropertyStr(ctx, res->socket, "write");
-  if (JS_IsFunction(ctx, write_method)) {
-    if (res->use_chunked) {
-      if (data_len > 0) {
-        char chunk_header[32];
-        snprintf(chunk_header, sizeof(chunk_header), "%zx\r\n", data_len);
-
-        JSValue chunk_start = JS_NewString(ctx, chunk_header);
-        JS_Call(ctx, write_method, res->socket, 1, &chunk_start);
-        JS_FreeValue(ctx, chunk_start);
-
-        JSValue body_data = JS_NewStringLen(ctx, data, data_len);
-        JS_Call(ctx, write_method, res->socket, 1, &body_data);
-        JS_FreeValue(ctx, body_data);
-
-        JSValue chunk_end = JS_NewString(ctx, "\r\n");
-        JS_Call(ctx, write_method, res->socket, 1, &chunk_end);
-        JS_FreeValue(ctx, chunk_end);
+
+  if (out->conn) {
+    if (out->conn->connected) {
+      js_net_connection_schedule_flush(out->conn);
+    }
+  } else if (!out->discard && out->copy.size > 0) {
+    JSValue write_method = JS_GetPropertyStr(ctx, res->socket, "write");
+    if (JS_IsFunction(ctx, write_method)) {
+      JSValue data = JS_NewStringLen(ctx, out->copy.data, out->copy.size);
+      JSValue result = JS_Call(ctx, write_method, res->socket, 1, &data);
+      JS_FreeValue(ctx, result);
+      JS_FreeValue(ctx, data);
+    }
+    JS_FreeValue(ctx, write_method);
+  }
+  free(out->copy.data);
+  out->copy.data = NULL;
+}
+
+// Date header value (IMF-fixdate), formatted at most once per second
+static const char* http_response_date(void) {
+  static const char* const days[] = {"Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat"};
+  static const char* const months[] = {"Jan", "Feb", "Mar", "Apr", "May", "Jun",
+                                       "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
+  static JSRT_THREAD_LOCAL char date[32];
+  static JSRT_THREAD_LOCAL time_t date_time = 0;
+
+  time_t now = time(NULL);
+  if (now != date_time) {
+    struct tm tm;
+#ifdef _WIN32
+    gmtime_s(&tm, &now);
+#else
+    gmtime_r(&now, &tm);
+#endif
+    snprintf(date, sizeof(date), "%s, %02d %s %04d %02d:%02d:%02d GMT", days[tm.tm_wday], tm.tm_mday,
+             months[tm.tm_mon], tm.tm_year + 1900, tm.tm_hour, tm.tm_min, tm.tm_sec);
+    date_time = now;
+  }
+  return date;
+}
+
+// Server header value, generated once per thread
+static const char* http_response_server_name(JSContext* ctx) {
+  static JSRT_THREAD_LOCAL char server_name[64];
+  if (server_name[0] == '\0') {
+    char* user_agent = jsrt_generate_user_agent(ctx);
+    snprintf(server_name, sizeof(server_name), "%s", user_agent ? user_agent : jsrt_get_static_user_agent());
+    free(user_agent);
+  }
+  return server_name;
+}
+
+static bool http_response_header_is(const char* name, const char* expected) {
+  return strcasecmp(name, expected) == 0;
+}
+
+// Append "Name: value\r\n", capitalizing the name (first letter and after hyphens)
+static bool http_response_append_header(HttpResponseBuffer* buf, const char* name, const char* value,
+                                        size_t value_len) {
+  size_t name_len = strlen(name);
+  if (!http_response_buffer_append(buf, name, name_len)) {
+    return false;
+  }
+  char* out_name = buf->data + buf->size - name_len;
+  bool capitalize = true;
+  for (size_t i = 0; i < name_len; i++) {
+    if (capitalize) {
+      out_name[i] = toupper((unsigned char)out_name[i]);
+    }
+    capitalize = out_name[i] == '-';
+  }
+  return http_response_buffer_append(buf, ": ", 2) && http_response_buffer_append(buf, value, value_len) &&
+         http_response_buffer_append(buf, "\r\n", 2);
+}
+
+// Append the status line and header block. `body_len` is the length of the whole body when end()
+// sends it together with the headers (sent as Content-Length), or -1 if more writes may follow.
+static bool http_response_append_head(JSContext* ctx, JSHttpResponse* res, HttpResponseBuffer* buf,
+                                      int64_t body_len) {
+  char line[64];
+  bool ok = true;
+
+  if (res->status_code == 0)
+    res->status_code = 200;
+  if (!res->status_message)
+    res->status_message = strdup("OK");
+
+  snprintf(line, sizeof(line), "HTTP/1.1 %d ", res->status_code);
+  ok = http_response_buffer_append_str(buf, line) &&
+       http_response_buffer_append_str(buf, res->status_message ? res->status_message : "OK") &&
+       http_response_buffer_append(buf, "\r\n", 2);
+
+  bool has_content_length = false;
+  bool has_transfer_encoding = false;
+  bool has_connection = false;
+  bool has_date = false;
+  bool has_server = false;
+
+  JSPropertyEnum* props;
+  uint32_t prop_count;
+  if (ok && JS_GetOwnPropertyNames(ctx, &props, &prop_count, res->headers, JS_GPN_STRING_MASK) == 0) {
+    for (uint32_t i = 0; i < prop_count; i++) {
+      const char* name = JS_AtomToCString(ctx, props[i].atom);
+      JSValue val = JS_GetProperty(ctx, res->headers, props[i].atom);
+      if (name && ok) {
+        has_content_length |= http_response_header_is(name, "content-length");
+        has_transfer_encoding |= http_response_header_is(name, "transfer-encoding");
+        has_connection |= http_response_header_is(name, "connection");
+        has_date |= http_response_header_is(name, "date");
+        has_server |= http_response_header_is(name, "server");
+
+        // Array values (e.g. Set-Cookie) become one header line per element
+        bool is_array = JS_IsArray(ctx, val) > 0;
+        uint32_t count = 1;
+        if (is_array) {
+          JSValue length = JS_GetPropertyStr(ctx, val, "length");
+          JS_ToUint32(ctx, &count, length);
+          JS_FreeValue(ctx, length);
+        }
+        for (uint32_t j = 0; j < count && ok; j++) {
+          JSValue item = is_array ? JS_GetPropertyUint32(ctx, val, j) : JS_DupValue(ctx, val);
+          size_t value_len = 0;
+          const char* value = JS_ToCStringLen(ctx, &value_len, item);
+          if (value) {
+            ok = http_response_append_header(buf, name, value, value_len);
+            JS_FreeCString(ctx, value);
+          } else {
+            JS_FreeValue(ctx, JS_GetException(ctx));
+          }
+          JS_FreeValue(ctx, item);
+        }
       }
+      if (name)
+        JS_FreeCString(ctx, name);
+      JS_FreeValue(ctx, val);
+    }
+    for (uint32_t i = 0; i < prop_count; i++) {
+      JS_FreeAtom(ctx, props[i].atom);
+    }
+    js_free(ctx, props);
+  }
+
+  // These statuses never carry a body, so they get no framing headers either, as in Node.js
+  int status = res->status_code;
+  res->no_body = (status >= 100 && status < 200) || status == 204 || status == 304;
+
+  // Without Content-Length the body is chunked, unless end() knows the whole body up front
+  res->use_chunked = !res->no_body && !has_content_length && (has_transfer_encoding || body_len < 0);
+  if (ok && !res->no_body && !has_content_length && !res->use_chunked) {
+    snprintf(line, sizeof(line), "Content-Length: %lld\r\n", (long long)body_len);
+    ok = http_response_buffer_append_str(buf, line);
+  }
+  if (ok && res->use_chunked && !has_transfer_encoding) {
+    ok = http_response_buffer_append_str(buf, "Transfer-Encoding: chunked\r\n");
+  }
+
+  // The socket is closed after every response, so tell keep-alive clients not to pool it
+  if (ok && !has_connection) {
+    ok = http_response_buffer_append_str(buf, "Connection: close\r\n");
+  }
+  if (ok && !has_date) {
+    ok = http_response_buffer_append_str(buf, "Date: ") && http_response_buffer_append_str(buf, http_response_date()) &&
+         http_response_buffer_append(buf, "\r\n", 2);
+  }
+  if (ok && !has_server) {
+    ok = http_response_buffer_append_str(buf, "Server: ") &&
+         http_response_buffer_append_str(buf, http_response_server_name(ctx)) &&
+         http_response_buffer_append(buf, "\r\n", 2);
+  }
+
+  return ok && http_response_buffer_append(buf, "\r\n", 2);
+}
+
+// Queue one body chunk, preceded by the header block if it has not been sent. Binary chunks are
+// written from their backing store and strings from their C string, without a copy. With is_end
+// the chunked body is terminated, and a body passed to end() before the headers went out is sent
+// with a Content-Length instead.
+// Returns the body length, or -1 with an exception pending.
+static int64_t http_response_send(JSContext* ctx, JSHttpResponse* res, JSValueConst chunk, bool is_end) {
+  const char* data = NULL;
+  size_t len = 0;
+  JSNetWriteChunk owner = {JS_UNDEFINED, NULL, NULL};
+  if (!JS_IsUndefined(chunk) && !JS_IsNull(chunk)) {
+    data = (const char*)jsrt_node_buffer_source_bytes(ctx, chunk, &len);
+    if (data) {
+      owner.pinned = JS_DupValue(ctx, chunk);
+      owner.store = JSRT_BufferPinValue(ctx, chunk);
     } else {
-      JSValue body_data = JS_NewStringLen(ctx, data, data_len);
-      JS_Call(ctx, write_method, res->socket, 1, &body_data);
-      JS_FreeValue(ctx, body_data);
+      owner.cstr = JS_ToCStringLen(ctx, &len, chunk);
+      if (!owner.cstr) {
+        return -1;
+      }
+      data = owner.cstr;
     }
   }
-  JS_FreeValue(ctx, write_method);
+
+  // Header block and chunk size line share one buffer, so a chunk costs at most three iovecs
+  HttpResponseBuffer prefix = {NULL, 0, 0};
+  bool ok = true;
+  if (!res->headers_sent) {
+    ok = http_response_append_head(ctx, res, &prefix, is_end ? (int64_t)len : -1);
+    res->headers_sent = true;
+    JS_SetPropertyStr(ctx, res->response_obj, "headersSent", JS_TRUE);
+  }
+  if (res->no_body && len > 0) {
+    // Node.js drops body writes to responses that cannot have one
+    js_net_write_chunk_free(ctx, &owner);
+    owner = (JSNetWriteChunk){JS_UNDEFINED, NULL, NULL};
+    data = NULL;
+    len = 0;
+  }
+  if (ok && res->use_chunked && len > 0) {
+    char size_line[24];
+    snprintf(size_line, sizeof(size_line), "%zx\r\n", len);
+    ok = http_response_buffer_append_str(&prefix, size_line);
+  }
+  if (!ok) {
+    free(prefix.data);
+    js_net_write_chunk_free(ctx, &owner);
+    JS_ThrowOutOfMemory(ctx);
+    return -1;
+  }
+
+  HttpResponseOutput out;
+  http_response_output_init(&out, res);
+
+  JSNetWriteChunk prefix_owner = {JS_UNDEFINED, NULL, prefix.data};
+  http_response_output_add(&out, prefix.data, prefix.size, &prefix_owner);
+  http_response_output_add(&out, data, len, &owner);
+  if (res->use_chunked) {
+    if (is_end) {
+      http_response_output_add_static(&out, len > 0 ? "\r\n0\r\n\r\n" : "0\r\n\r\n");
+    } else if (len > 0) {
+      http_response_output_add_static(&out, "\r\n");
+    }
+  }
+
+  http_response_output_commit(&out);
+  return (int64_t)len;
 }
 
 static void http_response_update_backpressure(JSHttpResponse* res, size_t bytes_written, bool* can_write_more) {
@@ -133,24 +424,29 @@ static void http_response_process_write_callbacks(JSContext* ctx, JSHttpResponse
   res->stream->write_callback_count = 0;
 }
 
-static void http_response_flush_buffer(JSHttpResponse* res) {
+// Send chunks buffered while corked
+static int http_response_flush_buffer(JSHttpResponse* res) {
   if (!res || !res->stream || res->stream->buffer_size == 0) {
-    return;
+    return 0;
   }
 
   JSContext* ctx = res->ctx;
-  for (size_t i = 0; i < res->stream->buffer_size; i++) {
+  int result = 0;
+  size_t count = res->stream->buffer_size;
+  res->stream->buffer_size = 0;
+  for (size_t i = 0; i < count; i++) {
     JSValue chunk_val = res->stream->buffered_data[i];
-    const char* data = JS_ToCString(ctx, chunk_val);
-    if (data) {
-      size_t data_len = strlen(data);
-      http_response_write_to_socket(res, data, data_len);
-      http_response_update_backpressure(res, data_len, NULL);
-      JS_FreeCString(ctx, data);
+    if (result == 0) {
+      int64_t written = http_response_send(ctx, res, chunk_val, false);
+      if (written < 0) {
+        result = -1;
+      } else {
+        http_response_update_backpressure(res, (size_t)written, NULL);
+      }
     }
     JS_FreeValue(ctx, chunk_val);
   }
-  res->stream->buffer_size = 0;
+  return result;
 }
 
 // Response write method
@@ -169,155 +465,25 @@ JSValue js_http_response_write(JSContext* ctx, JSValueConst this_val, int argc,
     return JS_ThrowTypeError(ctx, "Response has been destroyed");
   }
 
-  if (!res->headers_sent) {
-    // Send headers first (implicit writeHead)
-    if (res->status_code == 0)
-      res->status_code = 200;
-    if (!res->status_message)
-      res->status_message = strdup("OK");
-
-    // CRITICAL FIX #1.3: Build headers with dynamic allocation to prevent buffer overflow
-    size_t buffer_capacity = 4096;
-    size_t buffer_size = 0;
-    char* header_buffer = malloc(buffer_capacity);
-    if (!header_buffer) {
-      return JS_ThrowOutOfMemory(ctx);
-    }
-
-    // Helper macro for safe append
-#define APPEND_HEADER(fmt, ...)                                                                            \
-  do {                                                                                                     \
-    int needed = snprintf(NULL, 0, fmt, __VA_ARGS__);                                                      \
-    if (needed < 0) {                                                                                      \
-      free(header_buffer);                                                                                 \
-      return JS_ThrowInternalError(ctx, "Header formatting error");                                        \
-    }                                                                                                      \
-    if (buffer_size + needed + 1 > buffer_capacity) {                                                      \
-      size_t new_capacity = (buffer_size + needed + 1) * 2;                                                \
-      char* new_buffer = realloc(header_buffer, new_capacity);                                             \
-      if (!new_buffer) {                                                                                   \
-        free(header_buffer);                                                                               \
-        return JS_ThrowOutOfMemory(ctx);                                                                   \
-      }                                                                                                    \
-      header_buffer = new_buffer;                                                                          \
-      buffer_capacity = new_capacity;                                                                      \
-    }                                                                                                      \
-    buffer_size += snprintf(header_buffer + buffer_size, buffer_capacity - buffer_size, fmt, __VA_ARGS__); \
-  } while (0)
-
-    // Status line
-    APPEND_HEADER("HTTP/1.1 %d %s\r\n", res->status_code, res->status_message);
-
-    // Check if we need chunked encoding (no Content-Length set)
-    JSValue content_length = JS_GetPropertyStr(ctx, res->headers, "content-length");
-    if (JS_IsUndefined(content_length)) {
-      res->use_chunked = true;
-    }
-    JS_FreeValue(ctx, content_length);
-
-    // Write custom headers
-    JSPropertyEnum* props;
-    uint32_t prop_count;
-    if (JS_GetOwnPropertyNames(ctx, &props, &prop_count, res->headers, JS_GPN_STRING_MASK) == 0) {
-      for (uint32_t i = 0; i < prop_count; i++) {
-        JSValue key = JS_AtomToString(ctx, props[i].atom);
-        JSValue val = JS_GetProperty(ctx, res->headers, props[i].atom);
-
-        const char* key_str = JS_ToCString(ctx, key);
-        const char* val_str = JS_ToCString(ctx, val);
-
-        if (key_str && val_str) {
-          // Capitalize header name (first letter + after hyphens)
-          char header_name[256];
-          size_t j = 0;
-          bool capitalize = true;
-          while (key_str[j] && j < sizeof(header_name) - 1) {
-            if (capitalize) {
-              header_name[j] = toupper((unsigned char)key_str[j]);
-              capitalize = false;
-            } else {
-              header_name[j] = key_str[j];
-            }
-            if (key_str[j] == '-')
-              capitalize = true;
-            j++;
-          }
-          header_name[j] = '\0';
-
-          APPEND_HEADER("%s: %s\r\n", header_name, val_str);
-        }
-
-        if (key_str)
-          JS_FreeCString(ctx, key_str);
-        if (val_str)
-          JS_FreeCString(ctx, val_str);
-        JS_FreeValue(ctx, key);
-        JS_FreeValue(ctx, val);
-      }
-      js_free(ctx, props);
-    }
+  JSValueConst chunk = argc > 0 ? argv[0] : JS_UNDEFINED;
 
-    // Add chunked encoding header if needed
-    if (res->use_chunked) {
-      APPEND_HEADER("%s", "Transfer-Encoding: chunked\r\n");
-    }
-
-    // Add Server header and finalize
-    char* server_header = jsrt_generate_user_agent(ctx);
-    APPEND_HEADER("Server: %s\r\n\r\n", server_header);
-    free(server_header);
-
-#undef APPEND_HEADER
-
-    // Write headers to socket
-    if (!JS_IsUndefined(res->socket)) {
-      JSValue write_method = JS_GetPropertyStr(ctx, res->socket, "write");
-      if (JS_IsFunction(ctx, write_method)) {
-        JSValue header_data = JS_NewStringLen(ctx, header_buffer, buffer_size);
-        JS_Call(ctx, write_method, res->socket, 1, &header_data);
-        JS_FreeValue(ctx, header_data);
-      }
-      JS_FreeValue(ctx, write_method);
+  // Phase 4.2: While corked, keep the chunk; uncork() or end() sends it
+  if (argc > 0 && res->stream && res->stream->writable_corked > 0) {
+    if (http_response_buffer_chunk(ctx, res->stream, JS_DupValue(ctx, chunk)) < 0) {
+      return JS_ThrowOutOfMemory(ctx);
     }
-
-    free(header_buffer);
-    res->headers_sent = true;
+    return JS_NewBool(ctx, true);
   }
 
-  // Write body data
-  bool can_write_more = true;  // Phase 4.2: Track back-pressure
-  size_t bytes_written = 0;
-
-  if (argc > 0) {
-    const char* data = JS_ToCString(ctx, argv[0]);
-    if (data && !JS_IsUndefined(res->socket)) {
-      size_t data_len = strlen(data);
-      bytes_written = data_len;
-
-      // Phase 4.2: Check if corked - if so, buffer and return
-      if (res->stream && res->stream->writable_corked > 0) {
-        JSValue chunk_value = JS_NewStringLen(ctx, data, data_len);
-        if (JS_IsException(chunk_value)) {
-          JS_FreeCString(ctx, data);
-          return JS_EXCEPTION;
-        }
-        if (http_response_buffer_chunk(ctx, res->stream, chunk_value) < 0) {
-          JS_FreeCString(ctx, data);
-          return JS_ThrowOutOfMemory(ctx);
-        }
-        JS_FreeCString(ctx, data);
-        return JS_NewBool(ctx, true);
-      }
-
-      http_response_write_to_socket(res, data, data_len);
-      JS_FreeCString(ctx, data);
-
-      // Phase 4.2: Check for back-pressure
-      http_response_update_backpressure(res, bytes_written, &can_write_more);
-    }
+  // Implicit writeHead on the first write; headers and body go out together
+  int64_t bytes_written = http_response_send(ctx, res, chunk, false);
+  if (bytes_written < 0) {
+    return JS_EXCEPTION;
   }
 
   // Phase 4.2: Return false if back-pressure detected, true otherwise
+  bool can_write_more = true;
+  http_response_update_backpressure(res, (size_t)bytes_written, &can_write_more);
   return JS_NewBool(ctx, can_write_more);
 }
 
@@ -337,30 +503,18 @@ JSValue js_http_response_end(JSContext* ctx, JSValueConst this_val, int argc, JS
     return JS_ThrowTypeError(ctx, "Response has been destroyed");
   }
 
-  if (argc > 0) {
-    // Write final data
-    js_http_response_write(ctx, this_val, argc, argv);
-  }
-
-  // Ensure headers are sent even for empty response
-  if (!res->headers_sent) {
-    js_http_response_write(ctx, this_val, 0, NULL);
-  }
-
+  // Chunks held back by cork() go first
   if (res->stream) {
     res->stream->writable_corked = 0;
-    http_response_flush_buffer(res);
+    if (http_response_flush_buffer(res) < 0) {
+      return JS_EXCEPTION;
+    }
   }
 
-  // Send chunked terminator if using chunked encoding
-  if (res->use_chunked && !JS_IsUndefined(res->socket)) {
-    JSValue write_method = JS_GetPropertyStr(ctx, res->socket, "write");
-    if (JS_IsFunction(ctx, write_method)) {
-      JSValue terminator = JS_NewString(ctx, "0\r\n\r\n");
-      JS_Call(ctx, write_method, res->socket, 1, &terminator);
-      JS_FreeValue(ctx, terminator);
-    }
-    JS_FreeValue(ctx, write_method);
+  // Final data, headers (if still unsent) and the chunked terminator are queued as one writev
+  JSValueConst chunk = argc > 0 && !JS_IsFunction(ctx, argv[0]) ? argv[0] : JS_UNDEFINED;
+  if (http_response_send(ctx, res, chunk, true) < 0) {
+    return JS_EXCEPTION;
   }
 
   // Mark as finished
@@ -535,15 +689,10 @@ JSValue js_http_response_write_continue(JSContext* ctx, JSValueConst this_val, i
   // Send 100 Continue status line
   const char* continue_response = "HTTP/1.1 100 Continue\r\n\r\n";
 
-  if (!JS_IsUndefined(res->socket)) {
-    JSValue write_method = JS_GetPropertyStr(ctx, res->socket, "write");
-    if (JS_IsFunction(ctx, write_method)) {
-      JSValue data = JS_NewString(ctx, continue_response);
-      JS_Call(ctx, write_method, res->socket, 1, &data);
-      JS_FreeValue(ctx, data);
-    }
-    JS_FreeValue(ctx, write_method);
-  }
+  HttpResponseOutput out;
+  http_response_output_init(&out, res);
+  http_response_output_add_static(&out, continue_response);
+  http_response_output_commit(&out);
 
   return JS_UNDEFINED;
 }
@@ -558,15 +707,10 @@ JSValue js_http_response_write_processing(JSContext* ctx, JSValueConst this_val,
   // Send 102 Processing status line
   const char* processing_response = "HTTP/1.1 102 Processing\r\n\r\n";
 
-  if (!JS_IsUndefined(res->socket)) {
-    JSValue write_method = JS_GetPropertyStr(ctx, res->socket, "write");
-    if (JS_IsFunction(ctx, write_method)) {
-      JSValue data = JS_NewString(ctx, processing_response);
-      JS_Call(ctx, write_method, res->socket, 1, &data);
-      JS_FreeValue(ctx, data);
-    }
-    JS_FreeValue(ctx, write_method);
-  }
+  HttpResponseOutput out;
+  http_response_output_init(&out, res);
+  http_response_output_add_static(&out, processing_response);
+  http_response_output_commit(&out);
 
   return JS_UNDEFINED;
 }
@@ -651,6 +795,7 @@ JSValue js_http_response_constructor(JSContext* ctx, JSValueConst new_target, in
   res->finished = false;
   res->status_code = 0;
   res->use_chunked = false;
+  res->no_body = false;
   res->headers = JS_NewObject(ctx);
 
   // Phase 4.2: Initialize Writable stream data
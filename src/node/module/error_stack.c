@@ -6,20 +6,24 @@
 #include "error_stack.h"
 
 #include <ctype.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <uv.h>
 
 #include "module_api.h"
 #include "sourcemap.h"
+#include "util/dbuf.h"
 #include "util/debug.h"
+#include "util/macro.h"
 
 // ============================================================================
 // Node.js Error.captureStackTrace Implementation
 // ============================================================================
 
 // Global stack trace limit configuration
-static int32_t g_stack_trace_limit = 10;
+static JSRT_THREAD_LOCAL int32_t g_stack_trace_limit = 10;
 
 // Forward declarations for CallSite methods
 static JSValue js_create_callsite_object(JSContext* ctx, const char* file_name, int line_number, int column_number,
@@ -140,7 +144,7 @@ static JSValue js_error_capture_stack_trace(JSContext* ctx, JSValueConst this_va
 }
 
 // Global source map cache reference (set during initialization)
-static JSRT_SourceMapCache* g_source_map_cache = NULL;
+static JSRT_THREAD_LOCAL JSRT_SourceMapCache* g_source_map_cache = NULL;
 
 /**
  * Parse a stack frame line and extract file, line, column
@@ -435,61 +439,345 @@ JSValue jsrt_transform_error_stack(JSContext* ctx, JSRT_SourceMapCache* cache, c
   return result_val;
 }
 
+// ============================================================================
+// CommonJS Line Offsets and Relative Paths
+// ============================================================================
+
+// A CommonJS module path and the number of wrapper lines preceding its code
+typedef struct JSRT_ErrorStackModule {
+  struct JSRT_ErrorStackModule* next;
+  uint64_t hash;
+  int line_offset;
+  size_t path_len;
+  char path[];
+} JSRT_ErrorStackModule;
+
+#define JSRT_ERROR_STACK_INITIAL_CAPACITY 64
+
+// FNV-1a hash constants
+#define FNV_OFFSET_BASIS 14695981039346656037ULL
+#define FNV_PRIME 1099511628211ULL
+
+static JSRT_THREAD_LOCAL JSRT_ErrorStackModule** g_module_buckets = NULL;
+static JSRT_THREAD_LOCAL size_t g_module_capacity = 0;  // Number of buckets (power of two)
+static JSRT_THREAD_LOCAL size_t g_module_count = 0;
+
+// Working directory with a trailing '/', stripped from stack frame paths
+static JSRT_THREAD_LOCAL char* g_stack_cwd = NULL;
+static JSRT_THREAD_LOCAL size_t g_stack_cwd_len = 0;
+
+// The engine's own Error constructor, called by the wrapper on every new Error()
+static JSRT_THREAD_LOCAL JSValue g_original_error;
+static JSRT_THREAD_LOCAL bool g_has_original_error = false;
+
+static uint64_t hash_path(const char* path, size_t len) {
+  uint64_t hash = FNV_OFFSET_BASIS;
+  for (size_t i = 0; i < len; i++) {
+    hash ^= (uint64_t)(unsigned char)path[i];
+    hash *= FNV_PRIME;
+  }
+  return hash;
+}
+
+static JSRT_ErrorStackModule* find_module(const char* path, size_t len) {
+  if (g_module_count == 0) {
+    return NULL;
+  }
+  uint64_t hash = hash_path(path, len);
+  JSRT_ErrorStackModule* entry = g_module_buckets[hash & (g_module_capacity - 1)];
+  while (entry) {
+    if (entry->hash == hash && entry->path_len == len && memcmp(entry->path, path, len) == 0) {
+      return entry;
+    }
+    entry = entry->next;
+  }
+  return NULL;
+}
+
+static bool grow_modules(void) {
+  size_t capacity = g_module_capacity ? g_module_capacity * 2 : JSRT_ERROR_STACK_INITIAL_CAPACITY;
+  JSRT_ErrorStackModule** buckets = calloc(capacity, sizeof(*buckets));
+  if (!buckets) {
+    return false;
+  }
+  for (size_t i = 0; i < g_module_capacity; i++) {
+    JSRT_ErrorStackModule* entry = g_module_buckets[i];
+    while (entry) {
+      JSRT_ErrorStackModule* next = entry->next;
+      size_t index = entry->hash & (capacity - 1);
+      entry->next = buckets[index];
+      buckets[index] = entry;
+      entry = next;
+    }
+  }
+  free(g_module_buckets);
+  g_module_buckets = buckets;
+  g_module_capacity = capacity;
+  return true;
+}
+
+void jsrt_error_stack_set_line_offset(const char* path, int line_offset) {
+  if (!path) {
+    return;
+  }
+
+  size_t len = strlen(path);
+  JSRT_ErrorStackModule* entry = find_module(path, len);
+  if (entry) {
+    entry->line_offset = line_offset;
+    return;
+  }
+
+  if (g_module_count >= g_module_capacity && !grow_modules()) {
+    return;
+  }
+
+  entry = malloc(sizeof(*entry) + len + 1);
+  if (!entry) {
+    return;
+  }
+  entry->hash = hash_path(path, len);
+  entry->line_offset = line_offset;
+  entry->path_len = len;
+  memcpy(entry->path, path, len + 1);
+
+  size_t index = entry->hash & (g_module_capacity - 1);
+  entry->next = g_module_buckets[index];
+  g_module_buckets[index] = entry;
+  g_module_count++;
+}
+
+// Parse the digits in [start, end); returns -1 if the span is not a number
+static long parse_number(const char* start, const char* end) {
+  if (start >= end || end - start > 9) {
+    return -1;
+  }
+  long value = 0;
+  for (const char* p = start; p < end; p++) {
+    if (!isdigit((unsigned char)*p)) {
+      return -1;
+    }
+    value = value * 10 + (*p - '0');
+  }
+  return value;
+}
+
 /**
- * Wrapper Error constructor that transforms stack traces
- * Calls original Error constructor, then transforms the stack using source maps
+ * Append one "    at ..." frame to out, with the line number corrected for
+ * the CommonJS wrapper and the working directory removed from the path
  */
-static JSValue jsrt_error_wrapper(JSContext* ctx, JSValueConst new_target, int argc, JSValueConst* argv) {
-  // Get the original Error constructor
-  JSValue global = JS_GetGlobalObject(ctx);
-  JSValue original_error = JS_GetPropertyStr(ctx, global, "__OriginalError__");
-  JS_FreeValue(ctx, global);
+static void rewrite_stack_frame(DynBuf* out, const char* line, size_t len) {
+  const char* end = line + len;
+  const char* loc = line + 7;  // After "    at "
+  const char* loc_end = end;
+
+  // "    at name (file:line:col)" or "    at file:line:col"
+  if (loc_end > loc && loc_end[-1] == ')') {
+    loc_end--;
+    const char* paren = loc_end;
+    while (paren > loc && paren[-1] != '(') {
+      paren--;
+    }
+    if (paren > loc) {
+      loc = paren;
+    }
+  }
 
-  if (!JS_IsFunction(ctx, original_error)) {
-    JS_FreeValue(ctx, original_error);
-    return JS_ThrowTypeError(ctx, "Original Error constructor not found");
+  // Split "file:line[:col]" from the right, so drive letters and URLs survive
+  const char* file_end = NULL;
+  const char* num_start = NULL;
+  const char* num_end = NULL;
+  const char* colon = loc_end;
+  while (colon > loc && colon[-1] != ':') {
+    colon--;
+  }
+  if (colon > loc && parse_number(colon, loc_end) >= 0) {
+    num_start = colon;
+    num_end = loc_end;
+    file_end = colon - 1;
+    const char* prev = file_end;
+    while (prev > loc && prev[-1] != ':') {
+      prev--;
+    }
+    if (prev > loc && parse_number(prev, file_end) >= 0) {
+      num_start = prev;
+      num_end = file_end;
+      file_end = prev - 1;
+    }
   }
 
-  // Call original Error constructor
-  JSValue error_obj;
-  if (JS_IsUndefined(new_target)) {
-    // Called as function: Error(msg)
-    error_obj = JS_CallConstructor(ctx, original_error, argc, argv);
+  if (!file_end) {
+    dbuf_put(out, (const uint8_t*)line, len);
+    return;
+  }
+
+  long line_number = parse_number(num_start, num_end);
+  JSRT_ErrorStackModule* module = find_module(loc, file_end - loc);
+  const char* file = loc;
+  if (g_stack_cwd && (size_t)(file_end - file) > g_stack_cwd_len &&
+      memcmp(file, g_stack_cwd, g_stack_cwd_len) == 0) {
+    file += g_stack_cwd_len;
+  }
+
+  if (!module && file == loc) {
+    dbuf_put(out, (const uint8_t*)line, len);
+    return;
+  }
+
+  dbuf_put(out, (const uint8_t*)line, loc - line);
+  dbuf_put(out, (const uint8_t*)file, file_end - file);
+  if (module) {
+    line_number -= module->line_offset;
+    dbuf_printf(out, ":%ld", line_number > 0 ? line_number : 1);
   } else {
-    // Called as constructor: new Error(msg)
-    error_obj = JS_CallConstructor(ctx, original_error, argc, argv);
+    dbuf_put(out, (const uint8_t*)file_end, num_end - file_end);
   }
+  dbuf_put(out, (const uint8_t*)num_end, end - num_end);
+}
 
-  JS_FreeValue(ctx, original_error);
+/**
+ * Rewrite a captured stack: drop the frame of the Error wrapper itself, then
+ * fix CommonJS line numbers and make paths relative to the working directory
+ */
+static JSValue rewrite_stack(JSContext* ctx, const char* stack, size_t len) {
+  DynBuf out;
+  dbuf_init2(&out, JS_GetRuntime(ctx), (DynBufReallocFunc*)js_realloc_rt);
+
+  const char* p = stack;
+  const char* end = stack + len;
+  bool first_frame = true;
+  while (p < end) {
+    const char* eol = memchr(p, '\n', end - p);
+    size_t line_len = eol ? (size_t)(eol - p) : (size_t)(end - p);
+
+    if (line_len > 7 && memcmp(p, "    at ", 7) == 0) {
+      bool skip = first_frame && line_len == 21 && memcmp(p, "    at Error (native)", 21) == 0;
+      first_frame = false;
+      if (skip) {
+        p += eol ? line_len + 1 : line_len;
+        continue;
+      }
+      rewrite_stack_frame(&out, p, line_len);
+    } else {
+      dbuf_put(&out, (const uint8_t*)p, line_len);
+    }
 
-  if (JS_IsException(error_obj)) {
-    return error_obj;
+    if (eol) {
+      dbuf_putc(&out, '\n');
+      p = eol + 1;
+    } else {
+      p = end;
+    }
+  }
+
+  if (out.error) {
+    dbuf_free(&out);
+    return JS_ThrowOutOfMemory(ctx);
   }
+  JSValue result = JS_NewStringLen(ctx, (const char*)out.buf, out.size);
+  dbuf_free(&out);
+  return result;
+}
+
+/**
+ * Build the final Error.stack from the one QuickJS captured
+ */
+static JSValue format_error_stack(JSContext* ctx, JSValueConst raw_stack) {
+  JSValue stack = JS_DupValue(ctx, raw_stack);
 
-  // Transform the stack if source maps are enabled
   if (g_source_map_cache) {
     bool enabled = false, node_modules = false, generated_code = false;
     jsrt_source_map_cache_get_config(g_source_map_cache, &enabled, &node_modules, &generated_code);
-
     if (enabled) {
-      // Get the current stack
-      JSValue stack_val = JS_GetPropertyStr(ctx, error_obj, "stack");
-      if (!JS_IsUndefined(stack_val) && !JS_IsException(stack_val)) {
-        const char* stack_str = JS_ToCString(ctx, stack_val);
-        if (stack_str) {
-          // Transform the stack
-          JSValue transformed = jsrt_transform_error_stack(ctx, g_source_map_cache, stack_str);
-
-          // Replace the stack property
-          JS_SetPropertyStr(ctx, error_obj, "stack", transformed);
-
-          JS_FreeCString(ctx, stack_str);
-        }
+      const char* stack_str = JS_ToCString(ctx, stack);
+      if (stack_str) {
+        JS_FreeValue(ctx, stack);
+        stack = jsrt_transform_error_stack(ctx, g_source_map_cache, stack_str);
+        JS_FreeCString(ctx, stack_str);
       }
-      JS_FreeValue(ctx, stack_val);
     }
   }
 
+  size_t len;
+  const char* stack_str = JS_ToCStringLen(ctx, &len, stack);
+  JS_FreeValue(ctx, stack);
+  if (!stack_str) {
+    return JS_EXCEPTION;
+  }
+  JSValue result = rewrite_stack(ctx, stack_str, len);
+  JS_FreeCString(ctx, stack_str);
+  return result;
+}
+
+/**
+ * Accessor installed as the own "stack" property of new errors, so the stack
+ * is only rewritten when it is read. The same function serves as getter
+ * (argc == 0) and setter (argc == 1); either one replaces the accessor with a
+ * plain data property. func_data[0] holds the stack captured by QuickJS.
+ */
+static JSValue js_error_lazy_stack(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv, int magic,
+                                   JSValue* func_data) {
+  if (!JS_IsObject(this_val)) {
+    return JS_UNDEFINED;
+  }
+
+  int flags = JS_PROP_WRITABLE | JS_PROP_CONFIGURABLE;
+  if (argc > 0) {
+    if (JS_DefinePropertyValueStr(ctx, this_val, "stack", JS_DupValue(ctx, argv[0]), flags) < 0) {
+      return JS_EXCEPTION;
+    }
+    return JS_UNDEFINED;
+  }
+
+  JSValue stack = format_error_stack(ctx, func_data[0]);
+  if (JS_IsException(stack)) {
+    return stack;
+  }
+  if (JS_DefinePropertyValueStr(ctx, this_val, "stack", JS_DupValue(ctx, stack), flags) < 0) {
+    JS_FreeValue(ctx, stack);
+    return JS_EXCEPTION;
+  }
+  return stack;
+}
+
+/**
+ * Wrapper Error constructor
+ * Calls the original Error constructor, then defers stack rewriting (source
+ * maps, CommonJS line offsets, relative paths) until .stack is read
+ */
+static JSValue jsrt_error_wrapper(JSContext* ctx, JSValueConst new_target, int argc, JSValueConst* argv) {
+  if (!g_has_original_error) {
+    return JS_ThrowTypeError(ctx, "Original Error constructor not found");
+  }
+  JSValueConst original_error = g_original_error;
+
+  // Called as function (Error(msg)) or as constructor, possibly from a subclass
+  JSValue error_obj;
+  if (JS_IsUndefined(new_target)) {
+    error_obj = JS_CallConstructor(ctx, original_error, argc, argv);
+  } else {
+    error_obj = JS_CallConstructor2(ctx, original_error, new_target, argc, argv);
+  }
+
+  if (JS_IsException(error_obj)) {
+    return error_obj;
+  }
+
+  JSValue stack_val = JS_GetPropertyStr(ctx, error_obj, "stack");
+  if (JS_IsString(stack_val)) {
+    JSValue accessor = JS_NewCFunctionData(ctx, js_error_lazy_stack, 0, 0, 1, &stack_val);
+    if (!JS_IsException(accessor)) {
+      JSAtom stack_atom = JS_NewAtom(ctx, "stack");
+      JS_DefineProperty(ctx, error_obj, stack_atom, JS_UNDEFINED, accessor, accessor,
+                        JS_PROP_HAS_GET | JS_PROP_HAS_SET | JS_PROP_HAS_CONFIGURABLE | JS_PROP_CONFIGURABLE);
+      JS_FreeAtom(ctx, stack_atom);
+      JS_FreeValue(ctx, accessor);
+    } else {
+      JS_FreeValue(ctx, JS_GetException(ctx));
+    }
+  }
+  JS_FreeValue(ctx, stack_val);
+
   return error_obj;
 }
 
@@ -497,12 +785,27 @@ static JSValue jsrt_error_wrapper(JSContext* ctx, JSValueConst new_target, int a
  * Initialize error stack integration
  */
 bool jsrt_error_stack_init(JSContext* ctx, JSRT_SourceMapCache* cache) {
-  if (!ctx || !cache) {
+  if (!ctx) {
     return false;
   }
 
   g_source_map_cache = cache;
 
+  char cwd[4096];
+  size_t cwd_len = sizeof(cwd) - 1;
+  if (uv_cwd(cwd, &cwd_len) == 0 && cwd_len > 0) {
+    free(g_stack_cwd);
+    g_stack_cwd = malloc(cwd_len + 2);
+    if (g_stack_cwd) {
+      memcpy(g_stack_cwd, cwd, cwd_len);
+      if (cwd[cwd_len - 1] != '/') {
+        g_stack_cwd[cwd_len++] = '/';
+      }
+      g_stack_cwd[cwd_len] = '\0';
+      g_stack_cwd_len = cwd_len;
+    }
+  }
+
   // Get the global object
   JSValue global = JS_GetGlobalObject(ctx);
 
@@ -516,13 +819,21 @@ bool jsrt_error_stack_init(JSContext* ctx, JSRT_SourceMapCache* cache) {
 
   // Save the original Error constructor
   JS_SetPropertyStr(ctx, global, "__OriginalError__", JS_DupValue(ctx, original_error));
+  if (g_has_original_error) {
+    JS_FreeValue(ctx, g_original_error);
+  }
+  g_original_error = JS_DupValue(ctx, original_error);
+  g_has_original_error = true;
 
-  // Create wrapper Error constructor
-  JSValue wrapper = JS_NewCFunction2(ctx, jsrt_error_wrapper, "Error", 1, JS_CFUNC_constructor, 0);
+  // Create wrapper Error constructor, callable with or without new
+  JSValue wrapper = JS_NewCFunction2(ctx, jsrt_error_wrapper, "Error", 1, JS_CFUNC_constructor_or_func, 0);
 
-  // Copy properties from original Error to wrapper
+  // Share the prototype and static properties of the original Error
   JSValue error_proto = JS_GetPropertyStr(ctx, original_error, "prototype");
+  JS_DefinePropertyValueStr(ctx, error_proto, "constructor", JS_DupValue(ctx, wrapper),
+                            JS_PROP_WRITABLE | JS_PROP_CONFIGURABLE);
   JS_SetPropertyStr(ctx, wrapper, "prototype", error_proto);
+  JS_SetPrototype(ctx, wrapper, original_error);
 
   // Add missing Node.js Error methods
   JSValue capture_stack_trace_func = JS_NewCFunction(ctx, js_error_capture_stack_trace, "captureStackTrace", 2);
@@ -538,7 +849,36 @@ bool jsrt_error_stack_init(JSContext* ctx, JSRT_SourceMapCache* cache) {
   JS_FreeValue(ctx, original_error);
   JS_FreeValue(ctx, global);
 
-  JSRT_Debug("Error stack integration initialized with source map support");
+  JSRT_Debug("Error stack integration initialized");
 
   return true;
 }
+
+/**
+ * Release error stack state of the current runtime
+ */
+void jsrt_error_stack_cleanup(JSContext* ctx) {
+  if (g_has_original_error) {
+    JS_FreeValue(ctx, g_original_error);
+    g_has_original_error = false;
+  }
+
+  for (size_t i = 0; i < g_module_capacity; i++) {
+    JSRT_ErrorStackModule* entry = g_module_buckets[i];
+    while (entry) {
+      JSRT_ErrorStackModule* next = entry->next;
+      free(entry);
+      entry = next;
+    }
+  }
+  free(g_module_buckets);
+  g_module_buckets = NULL;
+  g_module_capacity = 0;
+  g_module_count = 0;
+
+  free(g_stack_cwd);
+  g_stack_cwd = NULL;
+  g_stack_cwd_len = 0;
+
+  g_source_map_cache = NULL;
+}
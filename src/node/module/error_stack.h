@@ -17,20 +17,39 @@
  * - Stack trace parsing and transformation
  * - Source map lookup and position mapping
  * - Configuration-aware filtering (nodeModules, generatedCode)
- * - Error.stack property override
+ * - CommonJS wrapper line offsets and cwd-relative frame paths
+ * - Error.stack property override, rewritten lazily on first read
  */
 
 /**
  * Initialize error stack integration
- * Installs custom Error.stack getter that transforms stack traces
- * using source maps when available.
+ * Replaces the global Error with a native wrapper whose instances rewrite
+ * their stack on first read: source maps (when enabled), CommonJS line
+ * offsets and paths relative to the working directory.
  *
  * @param ctx QuickJS context
- * @param cache Source map cache
+ * @param cache Source map cache (can be NULL)
  * @return true on success, false on error
  */
 bool jsrt_error_stack_init(JSContext* ctx, JSRT_SourceMapCache* cache);
 
+/**
+ * Record the number of wrapper lines preceding a CommonJS module's code,
+ * subtracted from that file's line numbers in Error.stack
+ *
+ * @param path File name the module was compiled with
+ * @param line_offset Lines added before the module code
+ */
+void jsrt_error_stack_set_line_offset(const char* path, int line_offset);
+
+/**
+ * Release error stack state (line offsets, working directory, the original
+ * Error constructor) of the runtime running on the current thread
+ *
+ * @param ctx QuickJS context passed to jsrt_error_stack_init
+ */
+void jsrt_error_stack_cleanup(JSContext* ctx);
+
 /**
  * Transform error stack trace using source maps
  * Parses the original stack trace, looks up source maps for each frame,
@@ -10,9 +10,11 @@
 #include "../../module/loaders/commonjs_loader.h"
 #include "../../module/resolver/path_resolver.h"
 #include "../../module/resolver/path_util.h"
+#include "../../module/resolver/resolver_cache.h"
 #include "../../runtime.h"
 #include "../../util/debug.h"
 #include "../../util/file.h"
+#include "../../util/macro.h"
 #include "../node_modules.h"
 #include "compile_cache.h"
 #include "hooks.h"
@@ -1301,9 +1303,9 @@ typedef struct {
   time_t mtime;        // Modification time for cache invalidation
 } JSRT_PackageJSONCache;
 
-static JSRT_PackageJSONCache* package_json_cache = NULL;
-static size_t package_json_cache_size = 0;
-static size_t package_json_cache_capacity = 32;
+static JSRT_THREAD_LOCAL JSRT_PackageJSONCache* package_json_cache = NULL;
+static JSRT_THREAD_LOCAL size_t package_json_cache_size = 0;
+static JSRT_THREAD_LOCAL size_t package_json_cache_capacity = 32;
 
 /**
  * Find the nearest package.json file by searching upward from a given path.
@@ -1742,6 +1744,22 @@ static JSValue jsrt_module_get_statistics(JSContext* ctx, JSValueConst this_val,
     JS_SetPropertyStr(ctx, stats, "moduleCache", cache_stats);
   }
 
+  // Resolution caches (stat, package.json, specifier memo)
+  if (loader->resolver) {
+    JSRT_ModuleResolver* resolver = loader->resolver;
+    JSValue resolve_stats = JS_NewObject(ctx);
+    JS_SetPropertyStr(ctx, resolve_stats, "statHits", JS_NewInt64(ctx, resolver->stat_hits));
+    JS_SetPropertyStr(ctx, resolve_stats, "statMisses", JS_NewInt64(ctx, resolver->stat_misses));
+    JS_SetPropertyStr(ctx, resolve_stats, "statEntries", JS_NewInt64(ctx, resolver->stats.size));
+    JS_SetPropertyStr(ctx, resolve_stats, "packageJsonHits", JS_NewInt64(ctx, resolver->package_hits));
+    JS_SetPropertyStr(ctx, resolve_stats, "packageJsonMisses", JS_NewInt64(ctx, resolver->package_misses));
+    JS_SetPropertyStr(ctx, resolve_stats, "packageJsonEntries", JS_NewInt64(ctx, resolver->packages.size));
+    JS_SetPropertyStr(ctx, resolve_stats, "resolveHits", JS_NewInt64(ctx, resolver->resolve_hits));
+    JS_SetPropertyStr(ctx, resolve_stats, "resolveMisses", JS_NewInt64(ctx, resolver->resolve_misses));
+    JS_SetPropertyStr(ctx, resolve_stats, "resolveEntries", JS_NewInt64(ctx, resolver->resolved.size));
+    JS_SetPropertyStr(ctx, stats, "resolveCache", resolve_stats);
+  }
+
   // Get compile cache statistics if available
   JSRT_CompileCacheConfig* compile_cache = jsrt_module_get_compile_cache(ctx);
   if (compile_cache && jsrt_compile_cache_is_enabled(compile_cache)) {
@@ -4,6 +4,7 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "util/base64.h"
 #include "util/debug.h"
 
 // FNV-1a hash function for string keys
@@ -264,35 +265,6 @@ void jsrt_source_map_cache_get_config(JSRT_SourceMapCache* cache, bool* enabled,
   }
 }
 
-// ============================================================================
-// Base64 Decoder for VLQ (Source Map v3)
-// ============================================================================
-
-// Base64 character mapping for Source Map VLQ
-// Valid characters: A-Z, a-z, 0-9, +, /
-static const int8_t base64_decode_table[128] = {
-    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,  // 0-15
-    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,  // 16-31
-    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 62, -1, -1, -1, 63,  // 32-47 ('+' = 62, '/' = 63)
-    52, 53, 54, 55, 56, 57, 58, 59, 60, 61, -1, -1, -1, -1, -1, -1,  // 48-63 ('0'-'9' = 52-61)
-    -1, 0,  1,  2,  3,  4,  5,  6,  7,  8,  9,  10, 11, 12, 13, 14,  // 64-79 ('A'-'O' = 0-14)
-    15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, -1, -1, -1, -1, -1,  // 80-95 ('P'-'Z' = 15-25)
-    -1, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40,  // 96-111 ('a'-'o' = 26-40)
-    41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, -1, -1, -1, -1, -1   // 112-127 ('p'-'z' = 41-51)
-};
-
-/**
- * Decode a single Base64 character to 6-bit value
- * @param c Character to decode
- * @return 6-bit value (0-63) or -1 if invalid
- */
-static inline int8_t decode_base64_char(char c) {
-  if (c < 0 || c >= 128) {
-    return -1;
-  }
-  return base64_decode_table[(unsigned char)c];
-}
-
 // ============================================================================
 // VLQ Decoder (Variable-Length Quantity) for Source Map v3
 // ============================================================================
@@ -333,7 +305,7 @@ static bool decode_vlq_value(const char** str, int32_t* value) {
       return false;
     }
 
-    int8_t digit = decode_base64_char(c);
+    int digit = JSRT_Base64Value((uint8_t)c, JSRT_BASE64_STANDARD);
     if (digit < 0) {
       // Invalid Base64 character
       return false;
@@ -1184,42 +1156,17 @@ static JSValue decode_inline_source_map(JSContext* ctx, const char* data_url) {
 
   // Decode base64
   size_t base64_len = strlen(base64_data);
-  size_t decoded_len = (base64_len * 3) / 4 + 1;  // Conservative estimate
-  char* decoded = js_malloc(ctx, decoded_len);
+  size_t out_pos = base64_len / 4 * 3 + 3;
+  char* decoded = js_malloc(ctx, out_pos);
   if (!decoded) {
     return JS_EXCEPTION;
   }
-
-  // Use QuickJS's JSON.parse to parse the decoded string
-  // First, decode base64 manually
-  const char* b64_chars = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
-  size_t out_pos = 0;
-  uint32_t val = 0;
-  int val_b = -8;
-
-  for (size_t i = 0; i < base64_len; i++) {
-    char c = base64_data[i];
-    if (c == '=' || c == '\n' || c == '\r' || c == ' ') {
-      continue;
-    }
-
-    const char* p = strchr(b64_chars, c);
-    if (!p) {
-      js_free(ctx, decoded);
-      return JS_UNDEFINED;
-    }
-
-    val = (val << 6) | (p - b64_chars);
-    val_b += 6;
-
-    if (val_b >= 0) {
-      decoded[out_pos++] = (val >> val_b) & 0xFF;
-      val_b -= 8;
-    }
+  if (!JSRT_Base64Decode(base64_data, base64_len, (uint8_t*)decoded, &out_pos, JSRT_BASE64_STANDARD,
+                         JSRT_BASE64_FORGIVING)) {
+    js_free(ctx, decoded);
+    return JS_UNDEFINED;
   }
 
-  decoded[out_pos] = '\0';
-
   // Parse JSON
   JSValue json_str = JS_NewStringLen(ctx, decoded, out_pos);
   js_free(ctx, decoded);
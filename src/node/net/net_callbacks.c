@@ -130,6 +130,7 @@ void add_event_emitter_methods(JSContext* ctx, JSValue obj) {
 
 // Data read callback
 void on_socket_read(uv_stream_t* stream, ssize_t nread, const uv_buf_t* buf) {
+  bool read_buffer_owned = true;  // Cleared once the slab slice is handed to a JS Buffer
   JSNetConnection* conn = (JSNetConnection*)stream->data;
   if (!conn || !conn->ctx || conn->destroyed) {
     goto cleanup;
@@ -201,15 +202,28 @@ void on_socket_read(uv_stream_t* stream, ssize_t nread, const uv_buf_t* buf) {
     // Increment bytes read counter
     conn->bytes_read += nread;
 
-    // Emit 'data' event with the buffer content
+    // A native reader parses the bytes in place, without creating a Buffer or emitting 'data'
+    if (conn->read_hook) {
+      conn->read_hook(conn->read_hook_opaque, buf->base, (size_t)nread);
+      conn->in_callback = false;
+      goto cleanup;
+    }
+
+    // Emit 'data' event: a Buffer by default, a string once setEncoding() was called
     JSValue emit = JS_GetPropertyStr(ctx, conn->socket_obj, "emit");
     if (JS_IsFunction(ctx, emit)) {
-      // For now, always return strings to maintain compatibility
-      // TODO: Implement proper Buffer support when encoding is not set
-      // This requires caching the Buffer constructor to avoid module loading during callbacks
-      JSValue data = JS_NewStringLen(ctx, buf->base, nread);
+      JSValue data;
+      if (conn->encoding) {
+        data = JS_NewStringLen(ctx, buf->base, nread);
+      } else {
+        // Expose the bytes as a Buffer view over the read slab
+        JSValue array_buffer = JSRT_ReadSlabTake((uv_handle_t*)stream, buf, nread);
+        data = jsrt_node_buffer_view(ctx, array_buffer, 0, nread);
+        JS_FreeValue(ctx, array_buffer);
+        read_buffer_owned = false;
+      }
       JSValue args[] = {JS_NewString(ctx, "data"), data};
-      JSValue result = JS_Call(ctx, emit, conn->socket_obj, 2, args);
+      JSValue result = JS_IsException(data) ? JS_EXCEPTION : JS_Call(ctx, emit, conn->socket_obj, 2, args);
       if (JS_IsException(result)) {
         JSValue exception = JS_GetException(ctx);
         const char* err_str = JS_ToCString(ctx, exception);
@@ -231,16 +245,15 @@ void on_socket_read(uv_stream_t* stream, ssize_t nread, const uv_buf_t* buf) {
 
 cleanup:
 
-  // Always free the buffer allocated in on_socket_alloc
-  if (buf->base) {
-    free(buf->base);
+  // Return the slab slice from on_socket_alloc unless a Buffer took it over
+  if (read_buffer_owned) {
+    JSRT_ReadSlabRelease((uv_handle_t*)stream, buf, 0);
   }
 }
 
 // Allocation callback for socket reads
 void on_socket_alloc(uv_handle_t* handle, size_t suggested_size, uv_buf_t* buf) {
-  buf->base = malloc(suggested_size);
-  buf->len = suggested_size;
+  JSRT_ReadSlabAlloc(handle, suggested_size, buf);
 }
 
 // Connection callbacks
@@ -331,66 +344,10 @@ void on_connect(uv_connect_t* req, int status) {
     uv_read_start((uv_stream_t*)&conn->handle, on_socket_alloc, on_socket_read);
     JSRT_Debug("on_connect: uv_read_start called");
 
-    // Flush any pending writes queued before the connection completed
-    JSPendingWrite* pending = js_net_connection_detach_pending_writes(conn);
-    bool flush_failed = false;
-    int flush_error_code = 0;
-    const char* flush_error_message = NULL;
-
-    while (pending) {
-      JSPendingWrite* next = pending->next;
-      uv_write_t* write_req = malloc(sizeof(uv_write_t));
-      if (!write_req) {
-        flush_failed = true;
-        flush_error_code = UV_ENOMEM;
-        flush_error_message = uv_strerror(UV_ENOMEM);
-        if (pending->data) {
-          free(pending->data);
-        }
-      } else {
-        write_req->data = pending->data;
-        uv_buf_t buf = uv_buf_init(pending->data, (unsigned int)pending->len);
-        int write_result = uv_write(write_req, (uv_stream_t*)&conn->handle, &buf, 1, on_socket_write_complete);
-        if (write_result < 0) {
-          flush_failed = true;
-          flush_error_code = write_result;
-          flush_error_message = uv_strerror(write_result);
-          free(pending->data);
-          free(write_req);
-        } else {
-          conn->bytes_written += pending->len;
-        }
-      }
-
-      free(pending);
-      pending = next;
-
-      if (flush_failed) {
-        js_net_connection_free_pending_list(pending);
-        pending = NULL;
-      }
-    }
-
-    if (flush_failed) {
-      conn->had_error = true;
-      if (!JS_IsUndefined(conn->socket_obj)) {
-        JSValue emit_err = JS_GetPropertyStr(ctx, conn->socket_obj, "emit");
-        if (JS_IsFunction(ctx, emit_err)) {
-          JSValue error = JS_NewError(ctx);
-          if (flush_error_message) {
-            JS_SetPropertyStr(ctx, error, "message", JS_NewString(ctx, flush_error_message));
-          }
-          if (flush_error_code != 0) {
-            JS_SetPropertyStr(ctx, error, "code", JS_NewString(ctx, uv_err_name(flush_error_code)));
-          }
-
-          JSValue args[] = {JS_NewString(ctx, "error"), error};
-          JS_Call(ctx, emit_err, conn->socket_obj, 2, args);
-          JS_FreeValue(ctx, args[0]);
-          JS_FreeValue(ctx, args[1]);
-        }
-        JS_FreeValue(ctx, emit_err);
-      }
+    // Send everything written before the connection completed as a single writev
+    if (conn->corked == 0) {
+      js_net_connection_flush(conn);
+      js_net_connection_maybe_emit_drain(conn);
     }
 
     // Emit 'connect' event
@@ -430,6 +387,8 @@ void on_connect(uv_connect_t* req, int status) {
     JS_FreeValue(ctx, emit);
 
     if (conn->end_after_connect) {
+      conn->corked = 0;
+      js_net_connection_flush(conn);
       conn->shutdown_req.data = conn;
       uv_shutdown(&conn->shutdown_req, (uv_stream_t*)&conn->handle, on_shutdown);
       conn->connected = false;
@@ -520,27 +479,52 @@ void on_socket_write_complete(uv_write_t* req, int status) {
   // Get the connection from the stream BEFORE freeing req
   JSNetConnection* conn = (JSNetConnection*)req->handle->data;
 
-  // Free the write request
-  if (req->data) {
-    free(req->data);  // Free the copied buffer
-  }
-  free(req);
+  // Release the payload (copied buffer, C string or pinned ArrayBuffer) and the request
+  js_net_write_req_free((JSNetWriteReq*)req->data);
   if (!conn || !conn->ctx || conn->destroyed) {
     return;
   }
 
-  // Check write queue size and emit 'drain' if empty
-  size_t queue_size = uv_stream_get_write_queue_size((uv_stream_t*)&conn->handle);
-  if (queue_size == 0 && !JS_IsUndefined(conn->socket_obj)) {
-    JSContext* ctx = conn->ctx;
-    JSValue emit = JS_GetPropertyStr(ctx, conn->socket_obj, "emit");
-    if (JS_IsFunction(ctx, emit)) {
-      JSValue args[] = {JS_NewString(ctx, "drain")};
-      JS_Call(ctx, emit, conn->socket_obj, 1, args);
-      JS_FreeValue(ctx, args[0]);
-    }
-    JS_FreeValue(ctx, emit);
+  js_net_connection_maybe_emit_drain(conn);
+}
+
+void js_net_connection_flush(JSNetConnection* conn) {
+  int result = js_net_connection_flush_writes(conn);
+  if (result == 0 || JS_IsUndefined(conn->socket_obj)) {
+    return;
   }
+
+  conn->had_error = true;
+  JSContext* ctx = conn->ctx;
+  JSValue emit = JS_GetPropertyStr(ctx, conn->socket_obj, "emit");
+  if (JS_IsFunction(ctx, emit)) {
+    JSValue error = JS_NewError(ctx);
+    JS_SetPropertyStr(ctx, error, "message", JS_NewString(ctx, uv_strerror(result)));
+    JS_SetPropertyStr(ctx, error, "code", JS_NewString(ctx, uv_err_name(result)));
+
+    JSValue args[] = {JS_NewString(ctx, "error"), error};
+    JS_Call(ctx, emit, conn->socket_obj, 2, args);
+    JS_FreeValue(ctx, args[0]);
+    JS_FreeValue(ctx, args[1]);
+  }
+  JS_FreeValue(ctx, emit);
+}
+
+// Emit 'drain' once a write that returned false has been fully handed to the kernel
+void js_net_connection_maybe_emit_drain(JSNetConnection* conn) {
+  if (!conn->need_drain || js_net_connection_writable_length(conn) > 0 || JS_IsUndefined(conn->socket_obj)) {
+    return;
+  }
+
+  conn->need_drain = false;
+  JSContext* ctx = conn->ctx;
+  JSValue emit = JS_GetPropertyStr(ctx, conn->socket_obj, "emit");
+  if (JS_IsFunction(ctx, emit)) {
+    JSValue args[] = {JS_NewString(ctx, "drain")};
+    JS_Call(ctx, emit, conn->socket_obj, 1, args);
+    JS_FreeValue(ctx, args[0]);
+  }
+  JS_FreeValue(ctx, emit);
 }
 
 // Shutdown callback - called after uv_shutdown completes
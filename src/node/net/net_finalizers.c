@@ -1,4 +1,5 @@
 #include "net_internal.h"
+#include "../../util/macro.h"
 
 // Deferred cleanup list - structs to free after loop closes
 typedef struct DeferredCleanup {
@@ -8,7 +9,7 @@ typedef struct DeferredCleanup {
   struct DeferredCleanup* next;
 } DeferredCleanup;
 
-static DeferredCleanup* deferred_cleanup_head = NULL;
+static JSRT_THREAD_LOCAL DeferredCleanup* deferred_cleanup_head = NULL;
 
 static void add_deferred_cleanup(void* ptr, char* string1, char* string2) {
   // Check if this pointer is already in the list to prevent double-free
@@ -5,6 +5,7 @@
 #include <string.h>
 #include <uv.h>
 #include "../../runtime.h"
+#include "../../util/read_slab.h"
 #include "../node_modules.h"
 
 // Class IDs for networking classes
@@ -15,11 +16,27 @@ extern JSClassID js_socket_class_id;
 #define NET_TYPE_SOCKET 0x534F434B  // 'SOCK' in hex
 #define NET_TYPE_SERVER 0x53525652  // 'SRVR' in hex
 
-typedef struct JSPendingWrite {
-  char* data;
-  size_t len;
-  struct JSPendingWrite* next;
-} JSPendingWrite;
+// write() returns false once this many bytes are buffered, and 'drain' follows when they are flushed
+#define JSRT_NET_HIGH_WATER_MARK (16 * 1024)
+
+// Owner of one queued payload: the bytes stay owned by JS until libuv is done with them
+typedef struct {
+  JSValue pinned;     // ArrayBuffer or view backing a binary payload (JS_UNDEFINED otherwise)
+  const char* cstr;   // JS_ToCStringLen result backing a string payload
+  char* owned;        // malloc'd payload (writes made before connect)
+  const void* store;  // Store behind pinned, kept from being detached (JSRT_BufferPin) while libuv reads it
+} JSNetWriteChunk;
+
+// In-flight uv_write covering every chunk gathered since the last flush
+typedef struct {
+  uv_write_t req;
+  JSContext* ctx;
+  unsigned int nchunks;
+  JSNetWriteChunk chunks[];
+} JSNetWriteReq;
+
+// Native consumer of received bytes; `data` is only valid for the duration of the call
+typedef void (*JSNetReadHook)(void* opaque, const char* data, size_t len);
 
 // Connection state
 typedef struct {
@@ -51,8 +68,18 @@ typedef struct {
   bool allow_half_open;  // Allow half-open TCP connections
   bool end_after_connect;
   bool is_http_client;
-  JSPendingWrite* pending_writes_head;
-  JSPendingWrite* pending_writes_tail;
+  // Writes gathered during the current tick (or while corked), flushed together as one writev
+  uv_buf_t* write_bufs;
+  JSNetWriteChunk* write_chunks;
+  unsigned int write_count;
+  unsigned int write_capacity;
+  size_t write_queued_bytes;
+  unsigned int corked;
+  bool flush_scheduled;
+  bool need_drain;
+  // When set, received bytes go to this hook instead of 'data' events (HTTP server parser)
+  JSNetReadHook read_hook;
+  void* read_hook_opaque;
 } JSNetConnection;
 
 // Server state
@@ -86,6 +113,8 @@ void on_socket_timeout(uv_timer_t* timer);
 void on_listen_callback_timer(uv_timer_t* timer);
 void on_socket_write_complete(uv_write_t* req, int status);
 void on_shutdown(uv_shutdown_t* req, int status);
+void js_net_connection_flush(JSNetConnection* conn);
+void js_net_connection_maybe_emit_drain(JSNetConnection* conn);
 
 // Timer cleanup helpers (from net_finalizers.c)
 void socket_timeout_timer_close_callback(uv_handle_t* handle);
@@ -95,6 +124,8 @@ void server_callback_timer_close_callback(uv_handle_t* handle);
 JSValue js_socket_connect(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv);
 JSValue js_socket_write(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv);
 JSValue js_socket_end(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv);
+JSValue js_socket_cork(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv);
+JSValue js_socket_uncork(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv);
 JSValue js_socket_destroy(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv);
 JSValue js_socket_pause(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv);
 JSValue js_socket_resume(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv);
@@ -130,6 +161,7 @@ JSValue js_socket_get_destroyed(JSContext* ctx, JSValueConst this_val, int argc,
 JSValue js_socket_get_pending(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv);
 JSValue js_socket_get_ready_state(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv);
 JSValue js_socket_get_buffer_size(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv);
+JSValue js_socket_get_writable_length(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv);
 
 // Finalizers (from net_finalizers.c)
 void socket_close_callback(uv_handle_t* handle);
@@ -143,11 +175,18 @@ void jsrt_net_cleanup_deferred(void);
 JSValue js_net_create_server(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv);
 JSValue js_net_connect(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv);
 
-// Pending write helpers (from net_socket.c)
+// Write queue helpers (from net_socket.c)
+bool js_net_connection_enqueue_write(JSNetConnection* conn, const char* data, size_t len,
+                                     const JSNetWriteChunk* chunk);
 bool js_net_connection_queue_write(JSNetConnection* conn, const char* data, size_t len);
-JSPendingWrite* js_net_connection_detach_pending_writes(JSNetConnection* conn);
-void js_net_connection_free_pending_list(JSPendingWrite* head);
+int js_net_connection_flush_writes(JSNetConnection* conn);
+void js_net_connection_schedule_flush(JSNetConnection* conn);
+size_t js_net_connection_writable_length(JSNetConnection* conn);
 void js_net_connection_clear_pending_writes(JSNetConnection* conn);
+void js_net_write_chunk_free(JSContext* ctx, JSNetWriteChunk* chunk);
+
+// Write request helpers (from net_socket.c)
+void js_net_write_req_free(JSNetWriteReq* write_req);
 
 // GC protection helpers (from net_finalizers.c)
 void jsrt_net_add_active_socket_ref(JSContext* ctx, JSNetConnection* conn);
@@ -1,5 +1,6 @@
 #include <uv.h>
 #include "net_internal.h"
+#include "../../util/macro.h"
 
 // Class IDs for networking classes (exported, not static)
 JSClassID js_server_class_id;
@@ -12,9 +13,9 @@ typedef struct cleanup_item {
   struct cleanup_item* next;
 } cleanup_item_t;
 
-static cleanup_item_t* cleanup_list_head = NULL;
-static uv_mutex_t cleanup_mutex;
-static bool cleanup_mutex_initialized = false;
+static JSRT_THREAD_LOCAL cleanup_item_t* cleanup_list_head = NULL;
+static JSRT_THREAD_LOCAL uv_mutex_t cleanup_mutex;
+static JSRT_THREAD_LOCAL bool cleanup_mutex_initialized = false;
 
 void net_add_to_cleanup_list(void* ptr) {
   if (!cleanup_mutex_initialized) {
@@ -147,6 +148,79 @@ JSValue js_net_connect(JSContext* ctx, JSValueConst this_val, int argc, JSValueC
   return socket;
 }
 
+// IPC handle passing (child.send(message, handle) and process.send(message, handle))
+uv_stream_t* jsrt_net_get_handle(JSContext* ctx, JSValueConst obj, bool* is_server) {
+  JSNetServer* server = JS_GetOpaque(obj, js_server_class_id);
+  if (server) {
+    *is_server = true;
+    return server->listening && !server->destroyed ? (uv_stream_t*)&server->handle : NULL;
+  }
+
+  JSNetConnection* conn = JS_GetOpaque(obj, js_socket_class_id);
+  if (conn) {
+    *is_server = false;
+    return conn->connected && !conn->destroyed ? (uv_stream_t*)&conn->handle : NULL;
+  }
+  return NULL;
+}
+
+JSValue jsrt_net_accept_handle(JSContext* ctx, uv_stream_t* pipe, bool is_server) {
+  // A process that never required 'net' has not registered the classes yet
+  if (js_server_class_id == 0) {
+    JSValue net_module = JSRT_LoadNodeModuleCommonJS(ctx, "net");
+    if (JS_IsException(net_module)) {
+      return net_module;
+    }
+    JS_FreeValue(ctx, net_module);
+  }
+
+  JSRT_Runtime* rt = JS_GetContextOpaque(ctx);
+  if (is_server) {
+    JSValue obj = js_server_constructor(ctx, JS_UNDEFINED, 0, NULL);
+    JSNetServer* server = JS_GetOpaque(obj, js_server_class_id);
+    if (!server) {
+      return obj;
+    }
+
+    uv_tcp_init(rt->uv_loop, &server->handle);
+    server->handle.data = server;
+    int result = uv_accept(pipe, (uv_stream_t*)&server->handle);
+    if (result == 0) {
+      result = uv_listen((uv_stream_t*)&server->handle, 128, on_connection);
+    }
+    if (result < 0) {
+      uv_close((uv_handle_t*)&server->handle, NULL);
+      server->destroyed = true;
+      JS_FreeValue(ctx, obj);
+      return JS_ThrowInternalError(ctx, "Failed to accept server handle: %s", uv_strerror(result));
+    }
+    server->listening = true;
+    return obj;
+  }
+
+  JSValue obj = js_socket_constructor(ctx, JS_UNDEFINED, 0, NULL);
+  JSNetConnection* conn = JS_GetOpaque(obj, js_socket_class_id);
+  if (!conn) {
+    return obj;
+  }
+
+  uv_tcp_init(rt->uv_loop, &conn->handle);
+  conn->handle.data = conn;
+  int result = uv_accept(pipe, (uv_stream_t*)&conn->handle);
+  if (result < 0) {
+    uv_close((uv_handle_t*)&conn->handle, NULL);
+    conn->destroyed = true;
+    JS_FreeValue(ctx, obj);
+    return JS_ThrowInternalError(ctx, "Failed to accept socket handle: %s", uv_strerror(result));
+  }
+
+  // Same as a connection accepted by a local server (see on_connection)
+  jsrt_net_add_active_socket_ref(ctx, conn);
+  conn->connected = true;
+  uv_read_start((uv_stream_t*)&conn->handle, on_socket_alloc, on_socket_read);
+  return obj;
+}
+
 // IP utility functions
 JSValue js_net_is_ip(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
   if (argc < 1) {
@@ -208,12 +208,15 @@ JSValue js_socket_get_ready_state(JSContext* ctx, JSValueConst this_val, int arg
 }
 
 JSValue js_socket_get_buffer_size(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
+  return js_socket_get_writable_length(ctx, this_val, argc, argv);
+}
+
+// Bytes batched for the next flush plus bytes libuv has not yet handed to the kernel
+JSValue js_socket_get_writable_length(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
   JSNetConnection* conn = JS_GetOpaque(this_val, js_socket_class_id);
-  if (!conn || !conn->connected) {
+  if (!conn || conn->destroyed) {
     return JS_NewInt32(ctx, 0);
   }
 
-  // Get the write queue size from libuv
-  size_t size = uv_stream_get_write_queue_size((uv_stream_t*)&conn->handle);
-  return JS_NewInt64(ctx, size);
+  return JS_NewInt64(ctx, js_net_connection_writable_length(conn));
 }
@@ -1,76 +1,153 @@
+#include "../../util/buffer_pin.h"
 #include "../../util/debug.h"
 #include "net_internal.h"
 
+void js_net_write_chunk_free(JSContext* ctx, JSNetWriteChunk* chunk) {
+  if (chunk->cstr) {
+    JS_FreeCString(ctx, chunk->cstr);
+  }
+  JSRT_BufferUnpin(chunk->store);
+  JS_FreeValue(ctx, chunk->pinned);
+  free(chunk->owned);
+  chunk->pinned = JS_UNDEFINED;
+  chunk->cstr = NULL;
+  chunk->owned = NULL;
+  chunk->store = NULL;
+}
+
+bool js_net_connection_enqueue_write(JSNetConnection* conn, const char* data, size_t len,
+                                     const JSNetWriteChunk* chunk) {
+  if (conn->write_count == conn->write_capacity) {
+    unsigned int capacity = conn->write_capacity ? conn->write_capacity * 2 : 8;
+    uv_buf_t* bufs = realloc(conn->write_bufs, capacity * sizeof(uv_buf_t));
+    if (!bufs) {
+      return false;
+    }
+    conn->write_bufs = bufs;
+
+    JSNetWriteChunk* chunks = realloc(conn->write_chunks, capacity * sizeof(JSNetWriteChunk));
+    if (!chunks) {
+      return false;
+    }
+    conn->write_chunks = chunks;
+    conn->write_capacity = capacity;
+  }
+
+  conn->write_bufs[conn->write_count] = uv_buf_init((char*)data, (unsigned int)len);
+  conn->write_chunks[conn->write_count] = *chunk;
+  conn->write_count++;
+  conn->write_queued_bytes += len;
+  return true;
+}
+
 bool js_net_connection_queue_write(JSNetConnection* conn, const char* data, size_t len) {
   if (!conn || data == NULL) {
     return false;
   }
 
-  // Allocate node for pending write
-  JSPendingWrite* item = malloc(sizeof(JSPendingWrite));
-  if (!item) {
+  // Ensure we always allocate at least one byte to avoid malloc(0)
+  char* copy = malloc(len > 0 ? len : 1);
+  if (!copy) {
     return false;
   }
+  memcpy(copy, data, len);
 
-  // Ensure we always allocate at least one byte to avoid malloc(0)
-  size_t alloc_len = len > 0 ? len : 1;
-  char* copy = malloc(alloc_len);
-  if (!copy) {
-    free(item);
+  JSNetWriteChunk chunk = {JS_UNDEFINED, NULL, copy};
+  if (!js_net_connection_enqueue_write(conn, copy, len, &chunk)) {
+    free(copy);
     return false;
   }
+  return true;
+}
 
-  if (len > 0) {
-    memcpy(copy, data, len);
-  } else {
-    copy[0] = '\0';
+int js_net_connection_flush_writes(JSNetConnection* conn) {
+  if (!conn || conn->write_count == 0) {
+    return 0;
+  }
+
+  JSContext* ctx = conn->ctx;
+  uv_stream_t* stream = (uv_stream_t*)&conn->handle;
+  uv_buf_t* bufs = conn->write_bufs;
+  unsigned int count = conn->write_count;
+  unsigned int first = 0;
+
+  conn->write_count = 0;
+  conn->write_queued_bytes = 0;
+
+  // Nothing ahead of us in libuv: write synchronously and skip the request for whatever the kernel accepts
+  if (uv_stream_get_write_queue_size(stream) == 0) {
+    int written = uv_try_write(stream, bufs, count);
+    if (written > 0) {
+      size_t remaining = (size_t)written;
+      while (first < count && remaining >= bufs[first].len) {
+        remaining -= bufs[first].len;
+        js_net_write_chunk_free(ctx, &conn->write_chunks[first]);
+        first++;
+      }
+      if (remaining > 0) {
+        bufs[first].base += remaining;
+        bufs[first].len -= remaining;
+      }
+    }
   }
 
-  item->data = copy;
-  item->len = len;
-  item->next = NULL;
+  if (first == count) {
+    return 0;
+  }
 
-  if (!conn->pending_writes_head) {
-    conn->pending_writes_head = item;
-    conn->pending_writes_tail = item;
-  } else {
-    conn->pending_writes_tail->next = item;
-    conn->pending_writes_tail = item;
+  // The rest goes out as one writev; the request takes over ownership of the remaining chunks
+  unsigned int nchunks = count - first;
+  JSNetWriteReq* write_req = malloc(sizeof(JSNetWriteReq) + nchunks * sizeof(JSNetWriteChunk));
+  if (!write_req) {
+    for (unsigned int i = first; i < count; i++) {
+      js_net_write_chunk_free(ctx, &conn->write_chunks[i]);
+    }
+    return UV_ENOMEM;
   }
+  write_req->req.data = write_req;
+  write_req->ctx = ctx;
+  write_req->nchunks = nchunks;
+  memcpy(write_req->chunks, conn->write_chunks + first, nchunks * sizeof(JSNetWriteChunk));
 
-  return true;
+  JSRT_Debug_Truncated("[debug] socket flush bufs=%u queued=%u\n", nchunks, count);
+  int result = uv_write(&write_req->req, stream, bufs + first, nchunks, on_socket_write_complete);
+  if (result < 0) {
+    js_net_write_req_free(write_req);
+    return result;
+  }
+  return 0;
 }
 
-JSPendingWrite* js_net_connection_detach_pending_writes(JSNetConnection* conn) {
+size_t js_net_connection_writable_length(JSNetConnection* conn) {
+  return conn->write_queued_bytes + uv_stream_get_write_queue_size((uv_stream_t*)&conn->handle);
+}
+
+void js_net_connection_clear_pending_writes(JSNetConnection* conn) {
   if (!conn) {
-    return NULL;
+    return;
   }
 
-  JSPendingWrite* head = conn->pending_writes_head;
-  conn->pending_writes_head = NULL;
-  conn->pending_writes_tail = NULL;
-  return head;
-}
-
-void js_net_connection_free_pending_list(JSPendingWrite* head) {
-  JSPendingWrite* current = head;
-  while (current) {
-    JSPendingWrite* next = current->next;
-    if (current->data) {
-      free(current->data);
-    }
-    free(current);
-    current = next;
+  for (unsigned int i = 0; i < conn->write_count; i++) {
+    js_net_write_chunk_free(conn->ctx, &conn->write_chunks[i]);
   }
+  free(conn->write_bufs);
+  free(conn->write_chunks);
+  conn->write_bufs = NULL;
+  conn->write_chunks = NULL;
+  conn->write_count = 0;
+  conn->write_capacity = 0;
+  conn->write_queued_bytes = 0;
 }
 
-void js_net_connection_clear_pending_writes(JSNetConnection* conn) {
-  if (!conn) {
+void js_net_write_req_free(JSNetWriteReq* write_req) {
+  if (!write_req) {
     return;
   }
 
-  JSPendingWrite* head = js_net_connection_detach_pending_writes(conn);
-  js_net_connection_free_pending_list(head);
+  for (unsigned int i = 0; i < write_req->nchunks; i++) {
+    js_net_write_chunk_free(write_req->ctx, &write_req->chunks[i]);
+  }
+  free(write_req);
 }
 
 // Socket methods
@@ -205,6 +282,41 @@ JSValue js_socket_connect(JSContext* ctx, JSValueConst this_val, int argc, JSVal
   return this_val;  // Return this for chaining
 }
 
+// Microtask that sends everything written during the current tick as one writev
+static JSValue js_socket_flush_job(JSContext* ctx, int argc, JSValueConst* argv) {
+  JSNetConnection* conn = JS_GetOpaque(argv[0], js_socket_class_id);
+  if (!conn) {
+    return JS_UNDEFINED;
+  }
+
+  conn->flush_scheduled = false;
+  if (conn->destroyed || !conn->connected || conn->corked > 0) {
+    return JS_UNDEFINED;
+  }
+
+  js_net_connection_flush(conn);
+  js_net_connection_maybe_emit_drain(conn);
+  return JS_UNDEFINED;
+}
+
+// Send the write batch from a microtask at the end of the current tick
+void js_net_connection_schedule_flush(JSNetConnection* conn) {
+  if (conn->flush_scheduled || conn->corked > 0 || !conn->connected) {
+    return;
+  }
+
+  JSContext* ctx = conn->ctx;
+
+  // The job holds a reference to the socket until it runs
+  JSValueConst args[] = {conn->socket_obj};
+  if (JS_EnqueueJob(ctx, js_socket_flush_job, 1, args) < 0) {
+    JS_FreeValue(ctx, JS_GetException(ctx));
+    js_net_connection_flush(conn);
+    return;
+  }
+  conn->flush_scheduled = true;
+}
+
 JSValue js_socket_write(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
   JSNetConnection* conn = JS_GetOpaque(this_val, js_socket_class_id);
   if (!conn || conn->destroyed) {
@@ -215,64 +327,52 @@ JSValue js_socket_write(JSContext* ctx, JSValueConst this_val, int argc, JSValue
     return JS_ThrowTypeError(ctx, "write requires data");
   }
 
-  // Convert data to string
-  const char* data = JS_ToCString(ctx, argv[0]);
-  if (!data) {
-    return JS_EXCEPTION;
+  if (!conn->connected && !conn->connecting) {
+    return JS_ThrowTypeError(ctx, "Socket is not connected");
   }
 
-  size_t len = strlen(data);
-  size_t alloc_len = len > 0 ? len : 1;
-
-  if (!conn->connected) {
-    if (conn->connecting) {
-      bool queued = js_net_connection_queue_write(conn, data, len);
-      JS_FreeCString(ctx, data);
-      if (!queued) {
-        return JS_ThrowOutOfMemory(ctx);
-      }
-      return JS_NewBool(ctx, true);
+  // Binary payloads are written straight from their backing store, which stays
+  // referenced and pinned against detaching until the write completes; strings
+  // are written from their C string
+  size_t len = 0;
+  JSNetWriteChunk chunk = {JS_UNDEFINED, NULL, NULL};
+  const char* data = (const char*)jsrt_node_buffer_source_bytes(ctx, argv[0], &len);
+  if (data) {
+    chunk.pinned = JS_DupValue(ctx, argv[0]);
+    chunk.store = JSRT_BufferPinValue(ctx, argv[0]);
+  } else {
+    chunk.cstr = JS_ToCStringLen(ctx, &len, argv[0]);
+    if (!chunk.cstr) {
+      return JS_EXCEPTION;
     }
-
-    JS_FreeCString(ctx, data);
-    return JS_ThrowTypeError(ctx, "Socket is not connected");
+    data = chunk.cstr;
   }
 
-  // Allocate buffer that will persist during async write
-  char* buffer = malloc(alloc_len);
-  if (!buffer) {
-    JS_FreeCString(ctx, data);
-    return JS_ThrowOutOfMemory(ctx);
-  }
-  if (len > 0) {
-    memcpy(buffer, data, len);
+  bool queued;
+  if (conn->connected) {
+    // Gather into the per-tick batch; the flush job or uncork() sends it
+    queued = js_net_connection_enqueue_write(conn, data, len, &chunk);
+    if (!queued) {
+      js_net_write_chunk_free(ctx, &chunk);
+    }
+  } else {
+    // Writes queued before connect are copied; the payload may change before it is sent
+    queued = js_net_connection_queue_write(conn, data, len);
+    js_net_write_chunk_free(ctx, &chunk);
   }
-  JS_FreeCString(ctx, data);
-
-  // Create write request
-  uv_write_t* write_req = malloc(sizeof(uv_write_t));
-  if (!write_req) {
-    free(buffer);
+  if (!queued) {
     return JS_ThrowOutOfMemory(ctx);
   }
-  write_req->data = buffer;  // Store buffer for cleanup
 
-  uv_buf_t buf = uv_buf_init(buffer, len);
-
-  // Perform async write
-  JSRT_Debug_Truncated("[debug] socket write len=%zu connected=%d connecting=%d\n", len, conn->connected,
-                       conn->connecting);
-  int result = uv_write(write_req, (uv_stream_t*)&conn->handle, &buf, 1, on_socket_write_complete);
-
-  if (result < 0) {
-    free(buffer);
-    free(write_req);
-    return JS_ThrowInternalError(ctx, "Write failed: %s", uv_strerror(result));
-  }
-
-  // Increment bytes written counter
+  JSRT_Debug_Truncated("[debug] socket write len=%zu connected=%d connecting=%d queued=%u\n", len, conn->connected,
+                       conn->connecting, conn->write_count);
   conn->bytes_written += len;
+  js_net_connection_schedule_flush(conn);
 
+  if (js_net_connection_writable_length(conn) >= JSRT_NET_HIGH_WATER_MARK) {
+    conn->need_drain = true;
+    return JS_NewBool(ctx, false);
+  }
   return JS_NewBool(ctx, true);
 }
 
@@ -283,7 +383,9 @@ JSValue js_socket_end(JSContext* ctx, JSValueConst this_val, int argc, JSValueCo
   }
 
   if (conn->connected) {
-    // Shutdown the connection
+    // Send whatever is still batched (even if corked), then shutdown the connection
+    conn->corked = 0;
+    js_net_connection_flush(conn);
     conn->shutdown_req.data = conn;
     uv_shutdown(&conn->shutdown_req, (uv_stream_t*)&conn->handle, on_shutdown);
     conn->connected = false;
@@ -294,6 +396,27 @@ JSValue js_socket_end(JSContext* ctx, JSValueConst this_val, int argc, JSValueCo
   return JS_UNDEFINED;
 }
 
+JSValue js_socket_cork(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
+  JSNetConnection* conn = JS_GetOpaque(this_val, js_socket_class_id);
+  if (conn && !conn->destroyed) {
+    conn->corked++;
+  }
+  return JS_UNDEFINED;
+}
+
+JSValue js_socket_uncork(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
+  JSNetConnection* conn = JS_GetOpaque(this_val, js_socket_class_id);
+  if (!conn || conn->destroyed || conn->corked == 0) {
+    return JS_UNDEFINED;
+  }
+
+  // The batch goes out at the end of the current tick, together with any writes that follow
+  if (--conn->corked == 0) {
+    js_net_connection_schedule_flush(conn);
+  }
+  return JS_UNDEFINED;
+}
+
 JSValue js_socket_destroy(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
   JSNetConnection* conn = JS_GetOpaque(this_val, js_socket_class_id);
   if (!conn || conn->destroyed) {
@@ -302,6 +425,13 @@ JSValue js_socket_destroy(JSContext* ctx, JSValueConst this_val, int argc, JSVal
   }
 
   JSRT_Debug_Truncated("[debug] js_socket_destroy conn=%p\n", conn);
+
+  // Batched writes were already accepted by write(); hand them to the kernel before closing, as an
+  // unbatched uv_write would have done
+  if (conn->connected) {
+    js_net_connection_flush_writes(conn);
+  }
+
   conn->destroyed = true;
   conn->connected = false;
   conn->connecting = false;
@@ -581,8 +711,16 @@ JSValue js_socket_constructor(JSContext* ctx, JSValueConst new_target, int argc,
   conn->had_error = false;
   conn->end_after_connect = false;
   conn->is_http_client = false;
-  conn->pending_writes_head = NULL;
-  conn->pending_writes_tail = NULL;
+  conn->write_bufs = NULL;
+  conn->write_chunks = NULL;
+  conn->write_count = 0;
+  conn->write_capacity = 0;
+  conn->write_queued_bytes = 0;
+  conn->corked = 0;
+  conn->flush_scheduled = false;
+  conn->need_drain = false;
+  conn->read_hook = NULL;
+  conn->read_hook_opaque = NULL;
 
   // Parse constructor options if provided
   if (argc > 0 && JS_IsObject(argv[0])) {
@@ -605,6 +743,8 @@ JSValue js_socket_constructor(JSContext* ctx, JSValueConst new_target, int argc,
   JS_SetPropertyStr(ctx, obj, "connect", JS_NewCFunction(ctx, js_socket_connect, "connect", 2));
   JS_SetPropertyStr(ctx, obj, "write", JS_NewCFunction(ctx, js_socket_write, "write", 1));
   JS_SetPropertyStr(ctx, obj, "end", JS_NewCFunction(ctx, js_socket_end, "end", 0));
+  JS_SetPropertyStr(ctx, obj, "cork", JS_NewCFunction(ctx, js_socket_cork, "cork", 0));
+  JS_SetPropertyStr(ctx, obj, "uncork", JS_NewCFunction(ctx, js_socket_uncork, "uncork", 0));
   JS_SetPropertyStr(ctx, obj, "destroy", JS_NewCFunction(ctx, js_socket_destroy, "destroy", 0));
   JS_SetPropertyStr(ctx, obj, "pause", JS_NewCFunction(ctx, js_socket_pause, "pause", 0));
   JS_SetPropertyStr(ctx, obj, "resume", JS_NewCFunction(ctx, js_socket_resume, "resume", 0));
@@ -638,6 +778,7 @@ JSValue js_socket_constructor(JSContext* ctx, JSValueConst new_target, int argc,
   DEFINE_GETTER_PROP("pending", js_socket_get_pending);
   DEFINE_GETTER_PROP("readyState", js_socket_get_ready_state);
   DEFINE_GETTER_PROP("bufferSize", js_socket_get_buffer_size);
+  DEFINE_GETTER_PROP("writableLength", js_socket_get_writable_length);
 
 #undef DEFINE_GETTER_PROP
 
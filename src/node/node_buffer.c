@@ -1,10 +1,68 @@
 #include <stdlib.h>
 #include <string.h>
+#include <strings.h>
+#include "../util/base64.h"
+#include "../util/buffer_pin.h"
 #include "../util/debug.h"
+#include "../util/macro.h"
+#include "../util/unicode.h"
 #include "node_modules.h"
 
-// Forward declarations
-static JSValue js_buffer_to_string(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv);
+// Node.js pool size: allocUnsafe()/from() results smaller than half of it share one slab
+#define JSRT_BUFFER_POOL_SIZE (8 * 1024)
+#define JSRT_BUFFER_POOL_ALIGN 8
+// Largest ArrayBuffer QuickJS will create
+#define JSRT_BUFFER_MAX_LENGTH 0x7fffffff
+
+static const struct {
+  const char* name;
+  JSRT_BufferEncoding encoding;
+} buffer_encodings[] = {
+    {"utf8", JSRT_BUFFER_ENC_UTF8},
+    {"utf-8", JSRT_BUFFER_ENC_UTF8},
+    {"hex", JSRT_BUFFER_ENC_HEX},
+    {"base64", JSRT_BUFFER_ENC_BASE64},
+    {"base64url", JSRT_BUFFER_ENC_BASE64URL},
+    {"latin1", JSRT_BUFFER_ENC_LATIN1},
+    {"binary", JSRT_BUFFER_ENC_LATIN1},
+    {"ascii", JSRT_BUFFER_ENC_ASCII},
+    {"utf16le", JSRT_BUFFER_ENC_UTF16LE},
+    {"utf-16le", JSRT_BUFFER_ENC_UTF16LE},
+    {"ucs2", JSRT_BUFFER_ENC_UTF16LE},
+    {"ucs-2", JSRT_BUFFER_ENC_UTF16LE},
+};
+
+static const char buffer_hex_chars[] = "0123456789abcdef";
+
+// Buffer constructor of the context it was installed in, plus the current allocUnsafe() slab
+typedef struct {
+  JSContext* ctx;
+  JSValue ctor;
+  JSValue uint8_array;   // Instances are Uint8Arrays constructed with Buffer as new.target
+  JSValue array_buffer;  // For Buffer.from(arrayBuffer) detection
+  JSValue pool;          // ArrayBuffer small allocations are sliced from
+  size_t pool_offset;
+} JSRT_BufferState;
+
+static JSRT_THREAD_LOCAL JSRT_BufferState g_buffer;
+
+static JSValue js_buffer_constructor(JSContext* ctx, JSValueConst new_target, int argc, JSValueConst* argv);
+static int buffer_install(JSContext* ctx);
+
+static inline JSValueConst buffer_arg(int argc, JSValueConst* argv, int i) {
+  return i < argc ? argv[i] : JS_UNDEFINED;
+}
+
+// State for ctx, installing Buffer on first use; NULL when Buffer belongs to another context on this thread
+static JSRT_BufferState* buffer_state(JSContext* ctx) {
+  if (g_buffer.ctx == ctx) {
+    return &g_buffer;
+  }
+  if (g_buffer.ctx || buffer_install(ctx) < 0) {
+    return NULL;
+  }
+  return &g_buffer;
+}
 
 // Helper to get buffer data from JSValue
 static uint8_t* get_buffer_data(JSContext* ctx, JSValue obj, size_t* size) {
@@ -25,443 +83,1323 @@ static uint8_t* get_buffer_data(JSContext* ctx, JSValue obj, size_t* size) {
   return buffer + byte_offset;
 }
 
-// Helper to create Uint8Array from ArrayBuffer with Buffer methods
-static JSValue create_uint8_array(JSContext* ctx, JSValue array_buffer) {
-  JSValue global = JS_GetGlobalObject(ctx);
-  JSValue uint8_array_ctor = JS_GetPropertyStr(ctx, global, "Uint8Array");
-  JSValue uint8_array = JS_CallConstructor(ctx, uint8_array_ctor, 1, &array_buffer);
+// Bytes viewed by a Buffer, TypedArray or DataView, honouring byteOffset
+uint8_t* jsrt_node_buffer_bytes(JSContext* ctx, JSValueConst obj, size_t* size) {
+  int type = JS_GetTypedArrayType(obj);
+  if (type == JS_TYPED_ARRAY_UINT8) {
+    return JS_GetUint8Array(ctx, size, obj);
+  }
+  if (type >= 0) {
+    return get_buffer_data(ctx, obj, size);
+  }
+  if (!JS_IsObject(obj)) {
+    return NULL;
+  }
 
-  // Add Buffer-specific methods to the Uint8Array instance
-  if (!JS_IsException(uint8_array)) {
-    // Add toString method that converts bytes to string
-    JSValue toString_func = JS_NewCFunction(ctx, js_buffer_to_string, "toString", 1);
-    JS_SetPropertyStr(ctx, uint8_array, "toString", toString_func);
+  // DataView: no C accessor, go through its properties
+  JSValue array_buffer = JS_GetPropertyStr(ctx, obj, "buffer");
+  JSValue offset_val = JS_GetPropertyStr(ctx, obj, "byteOffset");
+  JSValue length_val = JS_GetPropertyStr(ctx, obj, "byteLength");
+  uint8_t* data = NULL;
+  int64_t offset, length;
+  size_t buffer_size;
+  if (JS_IsObject(array_buffer) && JS_IsNumber(offset_val) && JS_IsNumber(length_val) &&
+      JS_ToInt64(ctx, &offset, offset_val) == 0 && JS_ToInt64(ctx, &length, length_val) == 0) {
+    data = JS_GetArrayBuffer(ctx, &buffer_size, array_buffer);
+    if (data && offset >= 0 && length >= 0 && (uint64_t)(offset + length) <= buffer_size) {
+      data += offset;
+      *size = (size_t)length;
+    } else {
+      data = NULL;
+    }
+  }
+  JS_FreeValue(ctx, array_buffer);
+  JS_FreeValue(ctx, offset_val);
+  JS_FreeValue(ctx, length_val);
+  return data;
+}
 
-    // Add a special marker to identify this as a Buffer
-    JS_SetPropertyStr(ctx, uint8_array, "_isBuffer", JS_TRUE);
+// Bytes of an ArrayBuffer, or viewed by a Buffer, TypedArray or DataView
+uint8_t* jsrt_node_buffer_source_bytes(JSContext* ctx, JSValueConst val, size_t* size) {
+  if (!JS_IsObject(val)) {
+    return NULL;
+  }
+  if (JS_GetTypedArrayType(val) < 0) {
+    uint8_t* data = JS_GetArrayBuffer(ctx, size, val);
+    if (data) {
+      return data;
+    }
+    JS_FreeValue(ctx, JS_GetException(ctx));
   }
+  return jsrt_node_buffer_bytes(ctx, val, size);
+}
 
-  JS_FreeValue(ctx, uint8_array_ctor);
-  JS_FreeValue(ctx, global);
-  return uint8_array;
+// Bytes of `this`, throwing when it is not a Buffer or TypedArray
+static uint8_t* buffer_this(JSContext* ctx, JSValueConst this_val, size_t* size) {
+  uint8_t* data = JS_GetTypedArrayType(this_val) >= 0 ? jsrt_node_buffer_bytes(ctx, this_val, size) : NULL;
+  if (!data) {
+    JS_ThrowTypeError(ctx, "argument must be a buffer");
+  }
+  return data;
 }
 
-// Buffer.prototype.toString([encoding])
-static JSValue js_buffer_to_string(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
-  // Get buffer data
-  size_t buffer_size;
-  uint8_t* buffer_data = get_buffer_data(ctx, this_val, &buffer_size);
+static uint8_t* buffer_arg_bytes(JSContext* ctx, JSValueConst val, const char* name, size_t* size) {
+  uint8_t* data = JS_GetTypedArrayType(val) >= 0 ? jsrt_node_buffer_bytes(ctx, val, size) : NULL;
+  if (!data) {
+    JS_ThrowTypeError(ctx, "The \"%s\" argument must be an instance of Buffer or Uint8Array", name);
+  }
+  return data;
+}
 
-  if (!buffer_data) {
-    return JS_ThrowTypeError(ctx, "Invalid buffer object");
+// Offset argument clamped to [0, len]; negative values count from the end when `relative`
+static int buffer_arg_offset(JSContext* ctx, JSValueConst val, size_t def, size_t len, bool relative, size_t* out) {
+  if (JS_IsUndefined(val)) {
+    *out = def;
+    return 0;
   }
 
-  // For now, just convert bytes to UTF-8 string (ignoring encoding parameter)
-  return JS_NewStringLen(ctx, (const char*)buffer_data, buffer_size);
+  int64_t v;
+  if (JS_ToInt64(ctx, &v, val) < 0) {
+    return -1;
+  }
+  if (v < 0) {
+    v = relative ? v + (int64_t)len : 0;
+    if (v < 0) {
+      v = 0;
+    }
+  }
+  *out = (uint64_t)v > len ? len : (size_t)v;
+  return 0;
 }
 
-// Buffer.alloc(size[, fill[, encoding]])
-static JSValue js_buffer_alloc(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
-  if (argc < 1) {
-    return JS_ThrowTypeError(ctx, "Buffer.alloc() requires at least 1 argument");
+static int buffer_lookup_encoding(const char* name) {
+  for (size_t i = 0; i < countof(buffer_encodings); i++) {
+    if (strcasecmp(name, buffer_encodings[i].name) == 0) {
+      return buffer_encodings[i].encoding;
+    }
+  }
+  return -1;
+}
+
+// Encoding argument, `def` when undefined; throws and returns -1 for unknown names
+static int buffer_encoding_arg(JSContext* ctx, JSValueConst val, JSRT_BufferEncoding def) {
+  if (JS_IsUndefined(val) || JS_IsNull(val)) {
+    return def;
+  }
+
+  const char* name = JS_ToCString(ctx, val);
+  if (!name) {
+    return -1;
+  }
+  int encoding = buffer_lookup_encoding(name);
+  if (encoding < 0) {
+    JS_ThrowTypeError(ctx, "Unknown encoding: %s", name);
+  }
+  JS_FreeCString(ctx, name);
+  return encoding;
+}
+
+static int buffer_hex_value(uint8_t c) {
+  if (c >= '0' && c <= '9') {
+    return c - '0';
+  }
+  c |= 0x20;
+  if (c >= 'a' && c <= 'f') {
+    return c - 'a' + 10;
   }
+  return -1;
+}
+
+// Number of bytes `str` (UTF-8, len bytes) encodes to
+static size_t buffer_encoded_length(const uint8_t* str, size_t len, JSRT_BufferEncoding encoding) {
+  size_t n = 0;
+  switch (encoding) {
+    case JSRT_BUFFER_ENC_UTF8:
+      return len;
+    case JSRT_BUFFER_ENC_HEX:
+      while (2 * n + 1 < len && buffer_hex_value(str[2 * n]) >= 0 && buffer_hex_value(str[2 * n + 1]) >= 0) {
+        n++;
+      }
+      return n;
+    case JSRT_BUFFER_ENC_BASE64:
+    case JSRT_BUFFER_ENC_BASE64URL:
+      // Both alphabets decode, as in Node.js
+      return JSRT_Base64DecodedLength((const char*)str, len, JSRT_BASE64_STANDARD, JSRT_BASE64_LOOSE);
+    case JSRT_BUFFER_ENC_UTF16LE:
+      return JSRT_UTF8UTF16Length(str, len) * 2;
+    default:
+      return JSRT_UTF8UTF16Length(str, len);
+  }
+}
 
-  int32_t size;
-  if (JS_ToInt32(ctx, &size, argv[0]) < 0) {
+// Encodes `str` into at most `cap` bytes of dst; returns the number of bytes written
+static size_t buffer_encode(const uint8_t* str, size_t len, JSRT_BufferEncoding encoding, uint8_t* dst, size_t cap) {
+  size_t n = 0;
+  switch (encoding) {
+    case JSRT_BUFFER_ENC_UTF8:
+      n = len;
+      if (n > cap) {
+        // Never write a partial character
+        n = cap;
+        while (n > 0 && (str[n] & 0xc0) == 0x80) {
+          n--;
+        }
+      }
+      memcpy(dst, str, n);
+      return n;
+    case JSRT_BUFFER_ENC_HEX:
+      for (; n < cap && 2 * n + 1 < len; n++) {
+        int hi = buffer_hex_value(str[2 * n]);
+        int lo = buffer_hex_value(str[2 * n + 1]);
+        if (hi < 0 || lo < 0) {
+          break;
+        }
+        dst[n] = (uint8_t)((hi << 4) | lo);
+      }
+      return n;
+    case JSRT_BUFFER_ENC_BASE64:
+    case JSRT_BUFFER_ENC_BASE64URL:
+      n = cap;
+      JSRT_Base64Decode((const char*)str, len, dst, &n, JSRT_BASE64_STANDARD, JSRT_BASE64_LOOSE);
+      return n;
+    case JSRT_BUFFER_ENC_UTF16LE:
+      return JSRT_UTF8ToUTF16LE(str, len, dst, cap);
+    default:
+      // latin1/ascii keep the low byte of each UTF-16 code unit
+      return JSRT_UTF8ToLatin1(str, len, dst, cap);
+  }
+}
+
+// Decodes len bytes of data to a JS string
+static JSValue buffer_decode(JSContext* ctx, const uint8_t* data, size_t len, JSRT_BufferEncoding encoding) {
+  size_t cap;
+  switch (encoding) {
+    case JSRT_BUFFER_ENC_UTF8:
+      return JS_NewStringLen(ctx, (const char*)data, len);
+    case JSRT_BUFFER_ENC_LATIN1:
+    case JSRT_BUFFER_ENC_ASCII:
+      if (JSRT_ASCIIPrefix(data, len) == len) {
+        return JS_NewStringLen(ctx, (const char*)data, len);
+      }
+      cap = len * 2;
+      break;
+    case JSRT_BUFFER_ENC_HEX:
+      cap = len * 2;
+      break;
+    case JSRT_BUFFER_ENC_BASE64:
+    case JSRT_BUFFER_ENC_BASE64URL:
+      cap = (len + 2) / 3 * 4;
+      break;
+    default:
+      cap = len / 2 * 3;
+      break;
+  }
+
+  uint8_t* out = js_malloc(ctx, cap ? cap : 1);
+  if (!out) {
     return JS_EXCEPTION;
   }
 
-  if (size < 0) {
+  size_t n = 0;
+  switch (encoding) {
+    case JSRT_BUFFER_ENC_LATIN1:
+      n = JSRT_Latin1ToUTF8(data, len, out);
+      break;
+    case JSRT_BUFFER_ENC_ASCII:
+      for (size_t i = 0; i < len; i++) {
+        out[i] = data[i] & 0x7f;
+      }
+      n = len;
+      break;
+    case JSRT_BUFFER_ENC_HEX:
+      for (size_t i = 0; i < len; i++) {
+        out[n++] = buffer_hex_chars[data[i] >> 4];
+        out[n++] = buffer_hex_chars[data[i] & 0x0f];
+      }
+      break;
+    case JSRT_BUFFER_ENC_BASE64:
+    case JSRT_BUFFER_ENC_BASE64URL: {
+      bool url = encoding == JSRT_BUFFER_ENC_BASE64URL;
+      n = JSRT_Base64Encode(data, len, (char*)out, url ? JSRT_BASE64_URL : JSRT_BASE64_STANDARD, !url);
+      break;
+    }
+    default:
+      n = JSRT_UTF16ToUTF8(data, len / 2, false, out);
+      break;
+  }
+
+  JSValue str = JS_NewStringLen(ctx, (const char*)out, n);
+  js_free(ctx, out);
+  return str;
+}
+
+int jsrt_node_buffer_encoding(JSContext* ctx, JSValueConst val) {
+  return buffer_encoding_arg(ctx, val, JSRT_BUFFER_ENC_UTF8);
+}
+
+JSValue jsrt_node_buffer_decode(JSContext* ctx, const uint8_t* data, size_t len, JSRT_BufferEncoding encoding) {
+  return buffer_decode(ctx, data, len, encoding);
+}
+
+static void buffer_free_data(JSRuntime* rt, void* opaque, void* ptr) {
+  js_free_rt(rt, ptr);
+}
+
+static JSValue buffer_new_array_buffer(JSContext* ctx, size_t size, bool zero, uint8_t** data) {
+  if (size > JSRT_BUFFER_MAX_LENGTH) {
     return JS_ThrowRangeError(ctx, "Invalid buffer size");
   }
 
-  // Create ArrayBuffer with zeros
-  uint8_t* data = malloc(size);
-  if (size > 0 && !data) {
-    return JS_ThrowOutOfMemory(ctx);
+  uint8_t* bytes = zero ? js_mallocz(ctx, size ? size : 1) : js_malloc(ctx, size ? size : 1);
+  if (!bytes) {
+    return JS_EXCEPTION;
+  }
+  JSValue array_buffer = JS_NewArrayBuffer(ctx, bytes, size, buffer_free_data, NULL, false);
+  if (JS_IsException(array_buffer)) {
+    js_free(ctx, bytes);
+    return JS_EXCEPTION;
+  }
+  *data = bytes;
+  return array_buffer;
+}
+
+// new Uint8Array(...argv) with Buffer.prototype
+static JSValue buffer_construct(JSContext* ctx, int argc, JSValueConst* argv) {
+  JSRT_BufferState* state = buffer_state(ctx);
+  if (!state) {
+    return JS_NewTypedArray(ctx, argc, argv, JS_TYPED_ARRAY_UINT8);
+  }
+  return JS_CallConstructor2(ctx, state->uint8_array, state->ctor, argc, argv);
+}
+
+// Buffer viewing `length` bytes of array_buffer at byte_offset, sharing its memory
+JSValue jsrt_node_buffer_view(JSContext* ctx, JSValueConst array_buffer, size_t byte_offset, size_t length) {
+  if (JS_IsException(array_buffer)) {
+    return JS_EXCEPTION;
+  }
+
+  JSValue args[] = {JS_DupValue(ctx, array_buffer), JS_NewInt64(ctx, (int64_t)byte_offset),
+                    JS_NewInt64(ctx, (int64_t)length)};
+  JSValue buffer = buffer_construct(ctx, 3, args);
+  JS_FreeValue(ctx, args[0]);
+  return buffer;
+}
+
+// Buffer with its own zero-filled or uninitialized ArrayBuffer
+static JSValue buffer_alloc_slow(JSContext* ctx, size_t size, bool zero, uint8_t** data) {
+  JSValue array_buffer = buffer_new_array_buffer(ctx, size, zero, data);
+  if (JS_IsException(array_buffer)) {
+    return JS_EXCEPTION;
+  }
+  JSValue buffer = jsrt_node_buffer_view(ctx, array_buffer, 0, size);
+  JS_FreeValue(ctx, array_buffer);
+  return buffer;
+}
+
+// Slabs stay pinned for their whole life: detaching one would pull the memory from under every Buffer
+// carved from it, so structuredClone() and postMessage() refuse to transfer them, as Node.js does
+static void buffer_free_pool(JSRuntime* rt, void* opaque, void* ptr) {
+  JSRT_BufferUnpin(ptr);
+  js_free_rt(rt, ptr);
+}
+
+static JSValue buffer_new_pool(JSContext* ctx, uint8_t** data) {
+  uint8_t* bytes = js_malloc(ctx, JSRT_BUFFER_POOL_SIZE);
+  if (!bytes) {
+    return JS_EXCEPTION;
+  }
+  JSValue array_buffer = JS_NewArrayBuffer(ctx, bytes, JSRT_BUFFER_POOL_SIZE, buffer_free_pool, NULL, false);
+  if (JS_IsException(array_buffer)) {
+    js_free(ctx, bytes);
+    return JS_EXCEPTION;
+  }
+  JSRT_BufferPin(bytes);
+  *data = bytes;
+  return array_buffer;
+}
+
+// Uninitialized Buffer; sizes below half the pool are sliced from the shared slab like Node.js does
+static JSValue buffer_alloc_unsafe(JSContext* ctx, size_t size, uint8_t** data) {
+  JSRT_BufferState* state = buffer_state(ctx);
+  if (!state || size >= (JSRT_BUFFER_POOL_SIZE >> 1)) {
+    return buffer_alloc_slow(ctx, size, false, data);
+  }
+
+  size_t pool_size = 0;
+  uint8_t* pool = NULL;
+  if (!JS_IsUndefined(state->pool)) {
+    pool = JS_GetArrayBuffer(ctx, &pool_size, state->pool);
+    if (!pool) {
+      // Pinned slabs are never detached, but start a new one rather than fail if it happens
+      JS_FreeValue(ctx, JS_GetException(ctx));
+    }
+  }
+  if (!pool || state->pool_offset + size > pool_size) {
+    JS_FreeValue(ctx, state->pool);
+    state->pool = buffer_new_pool(ctx, &pool);
+    state->pool_offset = 0;
+    if (JS_IsException(state->pool)) {
+      state->pool = JS_UNDEFINED;
+      return JS_EXCEPTION;
+    }
   }
-  memset(data, 0, size);
 
-  JSValue buffer = JS_NewArrayBuffer(ctx, data, size, NULL, NULL, false);
+  JSValue buffer = jsrt_node_buffer_view(ctx, state->pool, state->pool_offset, size);
   if (JS_IsException(buffer)) {
-    free(data);
     return JS_EXCEPTION;
   }
+  *data = pool + state->pool_offset;
+  state->pool_offset = (state->pool_offset + size + JSRT_BUFFER_POOL_ALIGN - 1) & ~(size_t)(JSRT_BUFFER_POOL_ALIGN - 1);
+  return buffer;
+}
 
-  JSValue uint8_array = create_uint8_array(ctx, buffer);
-  JS_FreeValue(ctx, buffer);
+// Buffer holding a copy of size bytes of data, pooled like Buffer.from()
+JSValue jsrt_node_buffer_from_data(JSContext* ctx, const uint8_t* data, size_t size) {
+  uint8_t* bytes;
+  JSValue buffer = buffer_alloc_unsafe(ctx, size, &bytes);
+  if (!JS_IsException(buffer) && size > 0) {
+    memcpy(bytes, data, size);
+  }
+  return buffer;
+}
 
-  // Fill buffer if fill value provided
-  if (argc > 1 && !JS_IsUndefined(argv[1])) {
-    size_t buf_size;
-    uint8_t* buf_data = get_buffer_data(ctx, uint8_array, &buf_size);
+// Doubles the first n bytes of dst until len bytes are filled
+static void buffer_repeat(uint8_t* dst, size_t n, size_t len) {
+  while (n < len) {
+    size_t chunk = n < len - n ? n : len - n;
+    memcpy(dst + n, dst, chunk);
+    n += chunk;
+  }
+}
 
-    if (buf_data && buf_size > 0) {
-      if (JS_IsString(argv[1])) {
-        const char* fill_str = JS_ToCString(ctx, argv[1]);
-        if (fill_str) {
-          size_t fill_len = strlen(fill_str);
-          if (fill_len > 0) {
-            for (size_t i = 0; i < buf_size; i++) {
-              buf_data[i] = fill_str[i % fill_len];
-            }
-          }
-          JS_FreeCString(ctx, fill_str);
-        }
-      } else {
-        int32_t fill_val;
-        if (JS_ToInt32(ctx, &fill_val, argv[1]) >= 0) {
-          memset(buf_data, fill_val & 0xFF, buf_size);
-        }
+// Fills dst with a byte, the encoded bytes of a string or the contents of another buffer, repeated
+static int buffer_fill(JSContext* ctx, uint8_t* dst, size_t len, JSValueConst value, JSValueConst encoding_val) {
+  if (JS_IsString(value)) {
+    int encoding = buffer_encoding_arg(ctx, encoding_val, JSRT_BUFFER_ENC_UTF8);
+    if (encoding < 0) {
+      return -1;
+    }
+    size_t str_len;
+    const char* str = JS_ToCStringLen(ctx, &str_len, value);
+    if (!str) {
+      return -1;
+    }
+    size_t n = buffer_encode((const uint8_t*)str, str_len, encoding, dst, len);
+    JS_FreeCString(ctx, str);
+    if (n == 0) {
+      if (str_len > 0 && len > 0) {
+        JS_ThrowTypeError(ctx, "The argument 'value' is invalid");
+        return -1;
       }
+      memset(dst, 0, len);
+      return 0;
     }
+    buffer_repeat(dst, n, len);
+    return 0;
   }
 
-  return uint8_array;
+  if (JS_GetTypedArrayType(value) >= 0) {
+    size_t pattern_len;
+    uint8_t* pattern = jsrt_node_buffer_bytes(ctx, value, &pattern_len);
+    if (!pattern) {
+      return -1;
+    }
+    if (pattern_len == 0) {
+      if (len > 0) {
+        JS_ThrowTypeError(ctx, "The argument 'value' is invalid");
+        return -1;
+      }
+      return 0;
+    }
+    size_t n = pattern_len < len ? pattern_len : len;
+    memmove(dst, pattern, n);
+    buffer_repeat(dst, n, len);
+    return 0;
+  }
+
+  int32_t byte = 0;
+  if (!JS_IsUndefined(value) && JS_ToInt32(ctx, &byte, value) < 0) {
+    return -1;
+  }
+  memset(dst, byte & 0xff, len);
+  return 0;
+}
+
+static int buffer_size_arg(JSContext* ctx, JSValueConst val, size_t* size) {
+  double d;
+  if (!JS_IsNumber(val)) {
+    JS_ThrowTypeError(ctx, "The \"size\" argument must be of type number");
+    return -1;
+  }
+  if (JS_ToFloat64(ctx, &d, val) < 0) {
+    return -1;
+  }
+  if (!(d >= 0 && d <= JSRT_BUFFER_MAX_LENGTH)) {
+    JS_ThrowRangeError(ctx, "Invalid buffer size");
+    return -1;
+  }
+  *size = (size_t)d;
+  return 0;
 }
 
-// Buffer.allocUnsafe(size)
-static JSValue js_buffer_alloc_unsafe(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
-  if (argc < 1) {
-    return JS_ThrowTypeError(ctx, "Buffer.allocUnsafe() requires 1 argument");
+static int buffer_compare_bytes(const uint8_t* a, size_t a_len, const uint8_t* b, size_t b_len) {
+  int r = memcmp(a, b, a_len < b_len ? a_len : b_len);
+  if (r != 0) {
+    return r < 0 ? -1 : 1;
   }
+  return a_len < b_len ? -1 : a_len > b_len ? 1 : 0;
+}
 
-  int32_t size;
-  if (JS_ToInt32(ctx, &size, argv[0]) < 0) {
+// Buffer.prototype.toString([encoding[, start[, end]]])
+static JSValue js_buffer_to_string(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
+  size_t len;
+  uint8_t* data = buffer_this(ctx, this_val, &len);
+  if (!data) {
     return JS_EXCEPTION;
   }
 
-  if (size < 0) {
-    return JS_ThrowRangeError(ctx, "Invalid buffer size");
+  int encoding = buffer_encoding_arg(ctx, buffer_arg(argc, argv, 0), JSRT_BUFFER_ENC_UTF8);
+  size_t start, end;
+  if (encoding < 0 || buffer_arg_offset(ctx, buffer_arg(argc, argv, 1), 0, len, false, &start) < 0 ||
+      buffer_arg_offset(ctx, buffer_arg(argc, argv, 2), len, len, false, &end) < 0) {
+    return JS_EXCEPTION;
+  }
+  if (end <= start) {
+    return JS_NewStringLen(ctx, "", 0);
   }
+  return buffer_decode(ctx, data + start, end - start, encoding);
+}
 
-  // Create ArrayBuffer without initializing memory
-  uint8_t* data = malloc(size);
-  if (size > 0 && !data) {
-    return JS_ThrowOutOfMemory(ctx);
+// Buffer.prototype.write(string[, offset[, length]][, encoding])
+static JSValue js_buffer_write(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
+  size_t len;
+  uint8_t* data = buffer_this(ctx, this_val, &len);
+  if (!data) {
+    return JS_EXCEPTION;
+  }
+  if (!JS_IsString(buffer_arg(argc, argv, 0))) {
+    return JS_ThrowTypeError(ctx, "The \"string\" argument must be of type string");
   }
 
-  JSValue buffer = JS_NewArrayBuffer(ctx, data, size, NULL, NULL, false);
-  if (JS_IsException(buffer)) {
-    free(data);
+  size_t offset = 0;
+  size_t max = len;
+  JSValueConst encoding_val = JS_UNDEFINED;
+  if (JS_IsString(buffer_arg(argc, argv, 1))) {
+    encoding_val = argv[1];
+  } else {
+    if (buffer_arg_offset(ctx, buffer_arg(argc, argv, 1), 0, len, false, &offset) < 0) {
+      return JS_EXCEPTION;
+    }
+    if (JS_IsString(buffer_arg(argc, argv, 2))) {
+      encoding_val = argv[2];
+      max = len - offset;
+    } else {
+      if (buffer_arg_offset(ctx, buffer_arg(argc, argv, 2), len - offset, len - offset, false, &max) < 0) {
+        return JS_EXCEPTION;
+      }
+      encoding_val = buffer_arg(argc, argv, 3);
+    }
+  }
+
+  int encoding = buffer_encoding_arg(ctx, encoding_val, JSRT_BUFFER_ENC_UTF8);
+  if (encoding < 0) {
     return JS_EXCEPTION;
   }
+  size_t str_len;
+  const char* str = JS_ToCStringLen(ctx, &str_len, argv[0]);
+  if (!str) {
+    return JS_EXCEPTION;
+  }
+  size_t written = buffer_encode((const uint8_t*)str, str_len, encoding, data + offset, max);
+  JS_FreeCString(ctx, str);
+  return JS_NewInt64(ctx, (int64_t)written);
+}
 
-  JSValue uint8_array = create_uint8_array(ctx, buffer);
-  JS_FreeValue(ctx, buffer);
+// Buffer.prototype.toJSON()
+static JSValue js_buffer_to_json(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
+  size_t len;
+  uint8_t* data = buffer_this(ctx, this_val, &len);
+  if (!data) {
+    return JS_EXCEPTION;
+  }
 
-  return uint8_array;
+  JSValue array = JS_NewArray(ctx);
+  if (JS_IsException(array)) {
+    return JS_EXCEPTION;
+  }
+  for (size_t i = 0; i < len; i++) {
+    JS_SetPropertyUint32(ctx, array, (uint32_t)i, JS_NewInt32(ctx, data[i]));
+  }
+  JSValue result = JS_NewObject(ctx);
+  JS_SetPropertyStr(ctx, result, "type", JS_NewString(ctx, "Buffer"));
+  JS_SetPropertyStr(ctx, result, "data", array);
+  return result;
 }
 
-// Buffer.from(array)
-// Buffer.from(string[, encoding])
-static JSValue js_buffer_from(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
-  if (argc < 1) {
-    return JS_ThrowTypeError(ctx, "Buffer.from() requires at least 1 argument");
+// Buffer.prototype.equals(otherBuffer)
+static JSValue js_buffer_equals(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
+  size_t len, other_len;
+  uint8_t* data = buffer_this(ctx, this_val, &len);
+  if (!data) {
+    return JS_EXCEPTION;
+  }
+  uint8_t* other = buffer_arg_bytes(ctx, buffer_arg(argc, argv, 0), "otherBuffer", &other_len);
+  if (!other) {
+    return JS_EXCEPTION;
   }
+  return JS_NewBool(ctx, len == other_len && memcmp(data, other, len) == 0);
+}
 
-  JSValue arg = argv[0];
+// Buffer.prototype.compare(target[, targetStart[, targetEnd[, sourceStart[, sourceEnd]]]])
+static JSValue js_buffer_compare(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
+  size_t len, target_len;
+  uint8_t* data = buffer_this(ctx, this_val, &len);
+  if (!data) {
+    return JS_EXCEPTION;
+  }
+  uint8_t* target = buffer_arg_bytes(ctx, buffer_arg(argc, argv, 0), "target", &target_len);
+  if (!target) {
+    return JS_EXCEPTION;
+  }
 
-  // Handle string input
-  if (JS_IsString(arg)) {
-    const char* str = JS_ToCString(ctx, arg);
+  size_t target_start, target_end, source_start, source_end;
+  if (buffer_arg_offset(ctx, buffer_arg(argc, argv, 1), 0, target_len, false, &target_start) < 0 ||
+      buffer_arg_offset(ctx, buffer_arg(argc, argv, 2), target_len, target_len, false, &target_end) < 0 ||
+      buffer_arg_offset(ctx, buffer_arg(argc, argv, 3), 0, len, false, &source_start) < 0 ||
+      buffer_arg_offset(ctx, buffer_arg(argc, argv, 4), len, len, false, &source_end) < 0) {
+    return JS_EXCEPTION;
+  }
+  if (target_end < target_start) {
+    target_end = target_start;
+  }
+  if (source_end < source_start) {
+    source_end = source_start;
+  }
+  return JS_NewInt32(ctx, buffer_compare_bytes(data + source_start, source_end - source_start, target + target_start,
+                                               target_end - target_start));
+}
+
+// Index of needle in hay searching forward from `start` (or backward when `last`), -1 when absent
+static int64_t buffer_search(const uint8_t* hay, size_t len, const uint8_t* needle, size_t needle_len, int64_t start,
+                             bool last) {
+  if (start < 0) {
+    start += (int64_t)len;
+  }
+
+  if (!last) {
+    if (start < 0) {
+      start = 0;
+    }
+    if ((uint64_t)start > len) {
+      return needle_len == 0 ? (int64_t)len : -1;
+    }
+    if (needle_len == 0) {
+      return start;
+    }
+    if (needle_len > len) {
+      return -1;
+    }
+    const uint8_t* p = hay + start;
+    const uint8_t* limit = hay + len - needle_len;
+    while (p <= limit) {
+      p = memchr(p, needle[0], (size_t)(limit - p) + 1);
+      if (!p) {
+        return -1;
+      }
+      if (memcmp(p, needle, needle_len) == 0) {
+        return p - hay;
+      }
+      p++;
+    }
+    return -1;
+  }
+
+  if (start < 0) {
+    return -1;
+  }
+  if (needle_len == 0) {
+    return (uint64_t)start < len ? start : (int64_t)len;
+  }
+  if (needle_len > len) {
+    return -1;
+  }
+  size_t i = (uint64_t)start < len - needle_len ? (size_t)start : len - needle_len;
+  for (;;) {
+    if (hay[i] == needle[0] && memcmp(hay + i, needle, needle_len) == 0) {
+      return (int64_t)i;
+    }
+    if (i-- == 0) {
+      return -1;
+    }
+  }
+}
+
+enum { BUFFER_SEARCH_INDEX_OF, BUFFER_SEARCH_LAST_INDEX_OF, BUFFER_SEARCH_INCLUDES };
+
+// Buffer.prototype.indexOf/lastIndexOf/includes(value[, byteOffset][, encoding])
+static JSValue js_buffer_index_of(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv, int magic) {
+  size_t len;
+  uint8_t* data = buffer_this(ctx, this_val, &len);
+  if (!data) {
+    return JS_EXCEPTION;
+  }
+
+  bool last = magic == BUFFER_SEARCH_LAST_INDEX_OF;
+  JSValueConst value = buffer_arg(argc, argv, 0);
+  JSValueConst offset_val = buffer_arg(argc, argv, 1);
+  JSValueConst encoding_val = buffer_arg(argc, argv, 2);
+  if (JS_IsString(offset_val)) {
+    encoding_val = offset_val;
+    offset_val = JS_UNDEFINED;
+  }
+
+  int64_t start = last ? (int64_t)len : 0;
+  if (!JS_IsUndefined(offset_val) && JS_ToInt64(ctx, &start, offset_val) < 0) {
+    return JS_EXCEPTION;
+  }
+
+  int64_t index;
+  if (JS_IsString(value)) {
+    int encoding = buffer_encoding_arg(ctx, encoding_val, JSRT_BUFFER_ENC_UTF8);
+    if (encoding < 0) {
+      return JS_EXCEPTION;
+    }
+    size_t str_len;
+    const char* str = JS_ToCStringLen(ctx, &str_len, value);
     if (!str) {
       return JS_EXCEPTION;
     }
-
-    size_t str_len = strlen(str);
-    JSValue buffer = JS_NewArrayBufferCopy(ctx, (const uint8_t*)str, str_len);
+    if (encoding == JSRT_BUFFER_ENC_UTF8) {
+      index = buffer_search(data, len, (const uint8_t*)str, str_len, start, last);
+    } else {
+      size_t needle_len = buffer_encoded_length((const uint8_t*)str, str_len, encoding);
+      uint8_t* needle = js_malloc(ctx, needle_len ? needle_len : 1);
+      if (!needle) {
+        JS_FreeCString(ctx, str);
+        return JS_EXCEPTION;
+      }
+      buffer_encode((const uint8_t*)str, str_len, encoding, needle, needle_len);
+      index = buffer_search(data, len, needle, needle_len, start, last);
+      js_free(ctx, needle);
+    }
     JS_FreeCString(ctx, str);
-
-    if (JS_IsException(buffer)) {
+  } else if (JS_GetTypedArrayType(value) >= 0) {
+    size_t needle_len;
+    uint8_t* needle = jsrt_node_buffer_bytes(ctx, value, &needle_len);
+    if (!needle) {
+      return JS_EXCEPTION;
+    }
+    index = buffer_search(data, len, needle, needle_len, start, last);
+  } else if (JS_IsNumber(value)) {
+    int32_t v;
+    if (JS_ToInt32(ctx, &v, value) < 0) {
       return JS_EXCEPTION;
     }
+    uint8_t byte = (uint8_t)v;
+    index = buffer_search(data, len, &byte, 1, start, last);
+  } else {
+    return JS_ThrowTypeError(ctx, "The \"value\" argument must be one of type number or string or an instance of "
+                                  "Buffer or Uint8Array");
+  }
 
-    JSValue uint8_array = create_uint8_array(ctx, buffer);
-    JS_FreeValue(ctx, buffer);
-    return uint8_array;
+  if (magic == BUFFER_SEARCH_INCLUDES) {
+    return JS_NewBool(ctx, index >= 0);
   }
+  return JS_NewInt64(ctx, index);
+}
 
-  // Handle array input
-  if (JS_IsArray(ctx, arg)) {
-    JSValue length_val = JS_GetPropertyStr(ctx, arg, "length");
-    int32_t length;
-    if (JS_ToInt32(ctx, &length, length_val) < 0) {
-      JS_FreeValue(ctx, length_val);
-      return JS_EXCEPTION;
-    }
-    JS_FreeValue(ctx, length_val);
+// Buffer.prototype.fill(value[, offset[, end]][, encoding])
+static JSValue js_buffer_fill(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
+  size_t len;
+  uint8_t* data = buffer_this(ctx, this_val, &len);
+  if (!data) {
+    return JS_EXCEPTION;
+  }
 
-    if (length < 0) {
-      return JS_ThrowRangeError(ctx, "Invalid array length");
-    }
+  JSValueConst offset_val = buffer_arg(argc, argv, 1);
+  JSValueConst end_val = buffer_arg(argc, argv, 2);
+  JSValueConst encoding_val = buffer_arg(argc, argv, 3);
+  if (JS_IsString(offset_val)) {
+    encoding_val = offset_val;
+    offset_val = JS_UNDEFINED;
+    end_val = JS_UNDEFINED;
+  } else if (JS_IsString(end_val)) {
+    encoding_val = end_val;
+    end_val = JS_UNDEFINED;
+  }
+
+  size_t offset, end;
+  if (buffer_arg_offset(ctx, offset_val, 0, len, false, &offset) < 0 ||
+      buffer_arg_offset(ctx, end_val, len, len, false, &end) < 0) {
+    return JS_EXCEPTION;
+  }
+  if (end > offset && buffer_fill(ctx, data + offset, end - offset, buffer_arg(argc, argv, 0), encoding_val) < 0) {
+    return JS_EXCEPTION;
+  }
+  return JS_DupValue(ctx, this_val);
+}
+
+// Buffer.prototype.copy(target[, targetStart[, sourceStart[, sourceEnd]]])
+static JSValue js_buffer_copy(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
+  size_t len, target_len;
+  uint8_t* data = buffer_this(ctx, this_val, &len);
+  if (!data) {
+    return JS_EXCEPTION;
+  }
+  uint8_t* target = buffer_arg_bytes(ctx, buffer_arg(argc, argv, 0), "target", &target_len);
+  if (!target) {
+    return JS_EXCEPTION;
+  }
+
+  size_t target_start, source_start, source_end;
+  if (buffer_arg_offset(ctx, buffer_arg(argc, argv, 1), 0, target_len, false, &target_start) < 0 ||
+      buffer_arg_offset(ctx, buffer_arg(argc, argv, 2), 0, len, false, &source_start) < 0 ||
+      buffer_arg_offset(ctx, buffer_arg(argc, argv, 3), len, len, false, &source_end) < 0) {
+    return JS_EXCEPTION;
+  }
+  if (source_end <= source_start) {
+    return JS_NewInt32(ctx, 0);
+  }
+
+  size_t n = source_end - source_start;
+  if (n > target_len - target_start) {
+    n = target_len - target_start;
+  }
+  memmove(target + target_start, data + source_start, n);
+  return JS_NewInt64(ctx, (int64_t)n);
+}
 
-    uint8_t* data = malloc(length);
-    if (length > 0 && !data) {
-      return JS_ThrowOutOfMemory(ctx);
+// Buffer.prototype.slice/subarray([start[, end]]): a Buffer sharing this memory
+static JSValue js_buffer_slice(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
+  size_t len;
+  if (!buffer_this(ctx, this_val, &len)) {
+    return JS_EXCEPTION;
+  }
+
+  size_t start, end;
+  if (buffer_arg_offset(ctx, buffer_arg(argc, argv, 0), 0, len, true, &start) < 0 ||
+      buffer_arg_offset(ctx, buffer_arg(argc, argv, 1), len, len, true, &end) < 0) {
+    return JS_EXCEPTION;
+  }
+  if (end < start) {
+    end = start;
+  }
+
+  size_t byte_offset;
+  JSValue array_buffer = JS_GetTypedArrayBuffer(ctx, this_val, &byte_offset, NULL, NULL);
+  if (JS_IsException(array_buffer)) {
+    return JS_EXCEPTION;
+  }
+  JSValue buffer = jsrt_node_buffer_view(ctx, array_buffer, byte_offset + start, end - start);
+  JS_FreeValue(ctx, array_buffer);
+  return buffer;
+}
+
+// read*/write* magic: low nibble is the width in bytes, the rest are flags
+#define BUFFER_RW_SIGNED 0x10
+#define BUFFER_RW_BE 0x20
+#define BUFFER_RW_FLOAT 0x40
+#define BUFFER_RW_BIGINT 0x80
+#define BUFFER_RW_SIZE(magic) ((magic) & 0x0f)
+
+static int buffer_rw_offset(JSContext* ctx, JSValueConst val, size_t len, int size, size_t* offset) {
+  int64_t v = 0;
+  if (!JS_IsUndefined(val) && JS_ToInt64(ctx, &v, val) < 0) {
+    return -1;
+  }
+  if (v < 0 || (uint64_t)v + (uint64_t)size > len) {
+    JS_ThrowRangeError(ctx, "The value of \"offset\" is out of range. It must be >= 0 and <= %lld. Received %lld",
+                       (long long)len - size, (long long)v);
+    return -1;
+  }
+  *offset = (size_t)v;
+  return 0;
+}
+
+static uint64_t buffer_load(const uint8_t* p, int size, bool big_endian) {
+  uint64_t v = 0;
+  for (int i = 0; i < size; i++) {
+    v |= (uint64_t)p[big_endian ? size - 1 - i : i] << (8 * i);
+  }
+  return v;
+}
+
+static void buffer_store(uint8_t* p, int size, bool big_endian, uint64_t v) {
+  for (int i = 0; i < size; i++) {
+    p[big_endian ? size - 1 - i : i] = (uint8_t)(v >> (8 * i));
+  }
+}
+
+// Buffer.prototype.read{UInt,Int,Float,Double,BigUInt64,BigInt64}*([offset])
+static JSValue js_buffer_read(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv, int magic) {
+  int size = BUFFER_RW_SIZE(magic);
+  size_t len, offset;
+  uint8_t* data = buffer_this(ctx, this_val, &len);
+  if (!data || buffer_rw_offset(ctx, buffer_arg(argc, argv, 0), len, size, &offset) < 0) {
+    return JS_EXCEPTION;
+  }
+
+  uint64_t v = buffer_load(data + offset, size, magic & BUFFER_RW_BE);
+  if (magic & BUFFER_RW_FLOAT) {
+    if (size == 4) {
+      uint32_t bits = (uint32_t)v;
+      float f;
+      memcpy(&f, &bits, sizeof(f));
+      return JS_NewFloat64(ctx, f);
     }
+    double d;
+    memcpy(&d, &v, sizeof(d));
+    return JS_NewFloat64(ctx, d);
+  }
+  if (magic & BUFFER_RW_BIGINT) {
+    return (magic & BUFFER_RW_SIGNED) ? JS_NewBigInt64(ctx, (int64_t)v) : JS_NewBigUint64(ctx, v);
+  }
+  if (magic & BUFFER_RW_SIGNED) {
+    int shift = 64 - 8 * size;
+    return JS_NewInt64(ctx, (int64_t)(v << shift) >> shift);
+  }
+  return JS_NewInt64(ctx, (int64_t)v);
+}
+
+// Buffer.prototype.write{UInt,Int,Float,Double,BigUInt64,BigInt64}*(value[, offset]); returns offset + width
+static JSValue js_buffer_write_number(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv, int magic) {
+  int size = BUFFER_RW_SIZE(magic);
+  size_t len, offset;
+  uint8_t* data = buffer_this(ctx, this_val, &len);
+  if (!data || buffer_rw_offset(ctx, buffer_arg(argc, argv, 1), len, size, &offset) < 0) {
+    return JS_EXCEPTION;
+  }
 
-    for (int32_t i = 0; i < length; i++) {
-      JSValue item = JS_GetPropertyUint32(ctx, arg, i);
-      int32_t val;
-      if (JS_ToInt32(ctx, &val, item) >= 0) {
-        data[i] = val & 0xFF;
+  JSValueConst value = buffer_arg(argc, argv, 0);
+  uint64_t bits;
+  if (magic & BUFFER_RW_BIGINT) {
+    int64_t v;
+    if (JS_ToBigInt64(ctx, &v, value) < 0) {
+      return JS_EXCEPTION;
+    }
+    bits = (uint64_t)v;
+  } else {
+    double d;
+    if (JS_ToFloat64(ctx, &d, value) < 0) {
+      return JS_EXCEPTION;
+    }
+    if (magic & BUFFER_RW_FLOAT) {
+      if (size == 4) {
+        float f = (float)d;
+        uint32_t u;
+        memcpy(&u, &f, sizeof(u));
+        bits = u;
       } else {
-        data[i] = 0;
+        memcpy(&bits, &d, sizeof(bits));
+      }
+    } else {
+      double max = (double)(1ULL << (8 * size - ((magic & BUFFER_RW_SIGNED) ? 1 : 0))) - 1;
+      double min = (magic & BUFFER_RW_SIGNED) ? -max - 1 : 0;
+      if (!(d >= min && d <= max)) {
+        return JS_ThrowRangeError(ctx, "The value of \"value\" is out of range. It must be >= %.0f and <= %.0f", min,
+                                  max);
       }
-      JS_FreeValue(ctx, item);
+      bits = (uint64_t)(int64_t)d;
     }
+  }
 
-    JSValue buffer = JS_NewArrayBuffer(ctx, data, length, NULL, NULL, false);
-    if (JS_IsException(buffer)) {
-      free(data);
-      return JS_EXCEPTION;
-    }
+  buffer_store(data + offset, size, magic & BUFFER_RW_BE, bits);
+  return JS_NewInt64(ctx, (int64_t)(offset + size));
+}
+
+#define BUFFER_RW_DEF(name, magic)                            \
+  JS_CFUNC_MAGIC_DEF("read" name, 1, js_buffer_read, magic), \
+      JS_CFUNC_MAGIC_DEF("write" name, 2, js_buffer_write_number, magic)
+
+static const JSCFunctionListEntry js_buffer_proto_funcs[] = {
+    JS_CFUNC_DEF("toString", 3, js_buffer_to_string),
+    JS_CFUNC_DEF("write", 4, js_buffer_write),
+    JS_CFUNC_DEF("toJSON", 0, js_buffer_to_json),
+    JS_CFUNC_DEF("equals", 1, js_buffer_equals),
+    JS_CFUNC_DEF("compare", 5, js_buffer_compare),
+    JS_CFUNC_MAGIC_DEF("indexOf", 3, js_buffer_index_of, BUFFER_SEARCH_INDEX_OF),
+    JS_CFUNC_MAGIC_DEF("lastIndexOf", 3, js_buffer_index_of, BUFFER_SEARCH_LAST_INDEX_OF),
+    JS_CFUNC_MAGIC_DEF("includes", 3, js_buffer_index_of, BUFFER_SEARCH_INCLUDES),
+    JS_CFUNC_DEF("fill", 4, js_buffer_fill),
+    JS_CFUNC_DEF("copy", 4, js_buffer_copy),
+    JS_CFUNC_DEF("slice", 2, js_buffer_slice),
+    JS_CFUNC_DEF("subarray", 2, js_buffer_slice),
+    BUFFER_RW_DEF("UInt8", 1),
+    BUFFER_RW_DEF("Uint8", 1),
+    BUFFER_RW_DEF("UInt16LE", 2),
+    BUFFER_RW_DEF("Uint16LE", 2),
+    BUFFER_RW_DEF("UInt16BE", 2 | BUFFER_RW_BE),
+    BUFFER_RW_DEF("Uint16BE", 2 | BUFFER_RW_BE),
+    BUFFER_RW_DEF("UInt32LE", 4),
+    BUFFER_RW_DEF("Uint32LE", 4),
+    BUFFER_RW_DEF("UInt32BE", 4 | BUFFER_RW_BE),
+    BUFFER_RW_DEF("Uint32BE", 4 | BUFFER_RW_BE),
+    BUFFER_RW_DEF("Int8", 1 | BUFFER_RW_SIGNED),
+    BUFFER_RW_DEF("Int16LE", 2 | BUFFER_RW_SIGNED),
+    BUFFER_RW_DEF("Int16BE", 2 | BUFFER_RW_SIGNED | BUFFER_RW_BE),
+    BUFFER_RW_DEF("Int32LE", 4 | BUFFER_RW_SIGNED),
+    BUFFER_RW_DEF("Int32BE", 4 | BUFFER_RW_SIGNED | BUFFER_RW_BE),
+    BUFFER_RW_DEF("FloatLE", 4 | BUFFER_RW_FLOAT),
+    BUFFER_RW_DEF("FloatBE", 4 | BUFFER_RW_FLOAT | BUFFER_RW_BE),
+    BUFFER_RW_DEF("DoubleLE", 8 | BUFFER_RW_FLOAT),
+    BUFFER_RW_DEF("DoubleBE", 8 | BUFFER_RW_FLOAT | BUFFER_RW_BE),
+    BUFFER_RW_DEF("BigUInt64LE", 8 | BUFFER_RW_BIGINT),
+    BUFFER_RW_DEF("BigUint64LE", 8 | BUFFER_RW_BIGINT),
+    BUFFER_RW_DEF("BigUInt64BE", 8 | BUFFER_RW_BIGINT | BUFFER_RW_BE),
+    BUFFER_RW_DEF("BigUint64BE", 8 | BUFFER_RW_BIGINT | BUFFER_RW_BE),
+    BUFFER_RW_DEF("BigInt64LE", 8 | BUFFER_RW_BIGINT | BUFFER_RW_SIGNED),
+    BUFFER_RW_DEF("BigInt64BE", 8 | BUFFER_RW_BIGINT | BUFFER_RW_SIGNED | BUFFER_RW_BE),
+};
+
+// Buffer.alloc(size[, fill[, encoding]])
+static JSValue js_buffer_alloc(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
+  size_t size;
+  if (buffer_size_arg(ctx, buffer_arg(argc, argv, 0), &size) < 0) {
+    return JS_EXCEPTION;
+  }
+
+  uint8_t* data;
+  JSValue buffer = buffer_alloc_slow(ctx, size, true, &data);
+  if (JS_IsException(buffer)) {
+    return JS_EXCEPTION;
+  }
 
-    JSValue uint8_array = create_uint8_array(ctx, buffer);
+  JSValueConst fill = buffer_arg(argc, argv, 1);
+  if (!JS_IsUndefined(fill) && size > 0 && buffer_fill(ctx, data, size, fill, buffer_arg(argc, argv, 2)) < 0) {
     JS_FreeValue(ctx, buffer);
-    return uint8_array;
+    return JS_EXCEPTION;
   }
+  return buffer;
+}
 
-  // Handle Uint8Array or other TypedArray input
-  JSValue global = JS_GetGlobalObject(ctx);
-  JSValue uint8_array_ctor = JS_GetPropertyStr(ctx, global, "Uint8Array");
-  if (JS_IsInstanceOf(ctx, arg, uint8_array_ctor) > 0) {
-    // It's already a Uint8Array, just return it as is (or duplicate it)
-    JS_FreeValue(ctx, uint8_array_ctor);
-    JS_FreeValue(ctx, global);
-    return JS_DupValue(ctx, arg);
+// Buffer.allocUnsafe(size) (magic 0) and Buffer.allocUnsafeSlow(size) (magic 1)
+static JSValue js_buffer_alloc_unsafe(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv, int magic) {
+  size_t size;
+  if (buffer_size_arg(ctx, buffer_arg(argc, argv, 0), &size) < 0) {
+    return JS_EXCEPTION;
   }
-  JS_FreeValue(ctx, uint8_array_ctor);
-  JS_FreeValue(ctx, global);
 
-  // Handle ArrayBuffer input
-  JSValue global_obj = JS_GetGlobalObject(ctx);
-  JSValue array_buffer_ctor = JS_GetPropertyStr(ctx, global_obj, "ArrayBuffer");
-  if (JS_IsInstanceOf(ctx, arg, array_buffer_ctor) > 0) {
-    JSValue uint8_array = create_uint8_array(ctx, JS_DupValue(ctx, arg));
-    JS_FreeValue(ctx, array_buffer_ctor);
-    JS_FreeValue(ctx, global_obj);
-    return uint8_array;
+  uint8_t* data;
+  return magic ? buffer_alloc_slow(ctx, size, false, &data) : buffer_alloc_unsafe(ctx, size, &data);
+}
+
+static JSValue buffer_from_string(JSContext* ctx, JSValueConst value, JSValueConst encoding_val) {
+  int encoding = buffer_encoding_arg(ctx, encoding_val, JSRT_BUFFER_ENC_UTF8);
+  if (encoding < 0) {
+    return JS_EXCEPTION;
+  }
+  size_t str_len;
+  const char* str = JS_ToCStringLen(ctx, &str_len, value);
+  if (!str) {
+    return JS_EXCEPTION;
   }
-  JS_FreeValue(ctx, array_buffer_ctor);
-  JS_FreeValue(ctx, global_obj);
 
-  return JS_ThrowTypeError(ctx, "Buffer.from() argument must be a string, array, ArrayBuffer, or TypedArray");
+  size_t len = buffer_encoded_length((const uint8_t*)str, str_len, encoding);
+  uint8_t* data;
+  JSValue buffer = buffer_alloc_unsafe(ctx, len, &data);
+  if (!JS_IsException(buffer)) {
+    buffer_encode((const uint8_t*)str, str_len, encoding, data, len);
+  }
+  JS_FreeCString(ctx, str);
+  return buffer;
 }
 
-// Buffer.isBuffer(obj)
-static JSValue js_buffer_is_buffer(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
-  if (argc < 1) {
-    return JS_FALSE;
+// Arrays, non-byte TypedArrays, other array-likes and toJSON() output ({type: 'Buffer', data: [...]})
+static JSValue buffer_from_array_like(JSContext* ctx, JSValueConst value) {
+  JSValue source = JS_DupValue(ctx, value);
+  if (!JS_IsArray(ctx, value) && JS_GetTypedArrayType(value) < 0) {
+    JSValue type = JS_GetPropertyStr(ctx, value, "type");
+    JSValue data = JS_GetPropertyStr(ctx, value, "data");
+    const char* type_str = JS_IsString(type) ? JS_ToCString(ctx, type) : NULL;
+    if (type_str && strcmp(type_str, "Buffer") == 0 && JS_IsArray(ctx, data)) {
+      JS_FreeValue(ctx, source);
+      source = JS_DupValue(ctx, data);
+    }
+    JS_FreeCString(ctx, type_str);
+    JS_FreeValue(ctx, type);
+    JS_FreeValue(ctx, data);
+  }
+
+  JSValue length_val = JS_GetPropertyStr(ctx, source, "length");
+  int64_t length;
+  if (!JS_IsNumber(length_val) || JS_ToInt64(ctx, &length, length_val) < 0) {
+    JS_FreeValue(ctx, length_val);
+    JS_FreeValue(ctx, source);
+    return JS_ThrowTypeError(ctx,
+                             "The first argument must be of type string or an instance of Buffer, ArrayBuffer, or "
+                             "Array or an Array-like Object.");
+  }
+  JS_FreeValue(ctx, length_val);
+  if (length < 0) {
+    length = 0;
   }
 
-  // Check if it has the Buffer marker
-  JSValue is_buffer_marker = JS_GetPropertyStr(ctx, argv[0], "_isBuffer");
-  bool is_buffer = JS_ToBool(ctx, is_buffer_marker);
-  JS_FreeValue(ctx, is_buffer_marker);
+  uint8_t* data;
+  JSValue buffer = buffer_alloc_unsafe(ctx, (size_t)length, &data);
+  for (int64_t i = 0; i < length && !JS_IsException(buffer); i++) {
+    JSValue item = JS_GetPropertyInt64(ctx, source, i);
+    int32_t v;
+    if (JS_IsException(item) || JS_ToInt32(ctx, &v, item) < 0) {
+      JS_FreeValue(ctx, buffer);
+      buffer = JS_EXCEPTION;
+    } else {
+      data[i] = (uint8_t)v;
+    }
+    JS_FreeValue(ctx, item);
+  }
+  JS_FreeValue(ctx, source);
+  return buffer;
+}
 
-  if (is_buffer) {
-    return JS_TRUE;
+// Buffer.from(string[, encoding]) / (array) / (buffer) / (arrayBuffer[, byteOffset[, length]])
+static JSValue js_buffer_from(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
+  JSValueConst value = buffer_arg(argc, argv, 0);
+  if (JS_IsString(value)) {
+    return buffer_from_string(ctx, value, buffer_arg(argc, argv, 1));
   }
 
-  // Fallback: Check if it's a Uint8Array (our Buffer implementation)
-  JSValue global = JS_GetGlobalObject(ctx);
-  JSValue uint8_array_ctor = JS_GetPropertyStr(ctx, global, "Uint8Array");
-  JS_FreeValue(ctx, global);
+  int type = JS_GetTypedArrayType(value);
+  if (type == JS_TYPED_ARRAY_UINT8 || type == JS_TYPED_ARRAY_UINT8C) {
+    size_t len;
+    uint8_t* data = jsrt_node_buffer_bytes(ctx, value, &len);
+    if (!data) {
+      return JS_EXCEPTION;
+    }
+    return jsrt_node_buffer_from_data(ctx, data, len);
+  }
+  if (!JS_IsObject(value)) {
+    return JS_ThrowTypeError(ctx, "Buffer.from() argument must be a string, array, ArrayBuffer, or TypedArray");
+  }
 
-  if (!JS_IsException(uint8_array_ctor) && !JS_IsUndefined(uint8_array_ctor)) {
-    int is_uint8_array = JS_IsInstanceOf(ctx, argv[0], uint8_array_ctor);
-    JS_FreeValue(ctx, uint8_array_ctor);
-    return JS_NewBool(ctx, is_uint8_array > 0);
+  // ArrayBuffer views share its memory
+  JSRT_BufferState* state = buffer_state(ctx);
+  if (type < 0 && state) {
+    int is_array_buffer = JS_IsInstanceOf(ctx, value, state->array_buffer);
+    if (is_array_buffer < 0) {
+      return JS_EXCEPTION;
+    }
+    if (is_array_buffer) {
+      return buffer_construct(ctx, argc > 3 ? 3 : argc, argv);
+    }
   }
+  return buffer_from_array_like(ctx, value);
+}
 
-  JS_FreeValue(ctx, uint8_array_ctor);
-  return JS_FALSE;
+// Buffer.isBuffer(obj); plain Uint8Arrays count too, as they always have here
+static JSValue js_buffer_is_buffer(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
+  return JS_NewBool(ctx, JS_GetTypedArrayType(buffer_arg(argc, argv, 0)) == JS_TYPED_ARRAY_UINT8);
 }
 
-// Buffer constructor function
-static JSValue js_buffer_constructor(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
-  if (argc < 1) {
-    return JS_ThrowTypeError(ctx, "Buffer constructor requires at least 1 argument");
+// Buffer.isEncoding(encoding)
+static JSValue js_buffer_is_encoding(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
+  if (!JS_IsString(buffer_arg(argc, argv, 0))) {
+    return JS_FALSE;
+  }
+  const char* name = JS_ToCString(ctx, argv[0]);
+  if (!name) {
+    return JS_EXCEPTION;
   }
+  bool known = buffer_lookup_encoding(name) >= 0;
+  JS_FreeCString(ctx, name);
+  return JS_NewBool(ctx, known);
+}
 
-  // For now, delegate to Buffer.from
-  return js_buffer_from(ctx, this_val, argc, argv);
+// Buffer(arg[, encodingOrOffset[, length]]), also reached through Symbol.species from subarray()/map()
+static JSValue js_buffer_constructor(JSContext* ctx, JSValueConst new_target, int argc, JSValueConst* argv) {
+  if (JS_IsNumber(buffer_arg(argc, argv, 0))) {
+    return js_buffer_alloc(ctx, new_target, 1, argv);
+  }
+  return js_buffer_from(ctx, new_target, argc, argv);
 }
 
 // Buffer.byteLength(string[, encoding])
 static JSValue js_buffer_byte_length(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
-  if (argc < 1) {
-    return JS_ThrowTypeError(ctx, "Buffer.byteLength() requires at least 1 argument");
-  }
+  JSValueConst arg = buffer_arg(argc, argv, 0);
 
-  JSValue arg = argv[0];
-
-  // Handle string input
   if (JS_IsString(arg)) {
-    const char* str = JS_ToCString(ctx, arg);
+    int encoding = buffer_encoding_arg(ctx, buffer_arg(argc, argv, 1), JSRT_BUFFER_ENC_UTF8);
+    if (encoding < 0) {
+      return JS_EXCEPTION;
+    }
+    size_t str_len;
+    const char* str = JS_ToCStringLen(ctx, &str_len, arg);
     if (!str) {
       return JS_EXCEPTION;
     }
-
-    size_t byte_length = strlen(str);
+    size_t byte_length = buffer_encoded_length((const uint8_t*)str, str_len, encoding);
     JS_FreeCString(ctx, str);
-
-    return JS_NewInt64(ctx, byte_length);
+    return JS_NewInt64(ctx, (int64_t)byte_length);
   }
 
-  // Handle Buffer/Uint8Array/TypedArray input
   size_t buffer_size;
-  uint8_t* buffer_data = get_buffer_data(ctx, arg, &buffer_size);
-  if (buffer_data) {
-    return JS_NewInt64(ctx, buffer_size);
+  if (JS_IsObject(arg) && jsrt_node_buffer_bytes(ctx, arg, &buffer_size)) {
+    return JS_NewInt64(ctx, (int64_t)buffer_size);
   }
 
-  // Handle ArrayBuffer input
-  JSValue global_obj = JS_GetGlobalObject(ctx);
-  JSValue array_buffer_ctor = JS_GetPropertyStr(ctx, global_obj, "ArrayBuffer");
-  if (JS_IsInstanceOf(ctx, arg, array_buffer_ctor) > 0) {
-    size_t buffer_size;
-    uint8_t* buffer = JS_GetArrayBuffer(ctx, &buffer_size, arg);
-    JS_FreeValue(ctx, array_buffer_ctor);
-    JS_FreeValue(ctx, global_obj);
-
-    if (buffer) {
-      return JS_NewInt64(ctx, buffer_size);
-    }
+  JSRT_BufferState* state = buffer_state(ctx);
+  if (state && JS_IsObject(arg) && JS_IsInstanceOf(ctx, arg, state->array_buffer) > 0 &&
+      JS_GetArrayBuffer(ctx, &buffer_size, arg)) {
+    return JS_NewInt64(ctx, (int64_t)buffer_size);
   }
-  JS_FreeValue(ctx, array_buffer_ctor);
-  JS_FreeValue(ctx, global_obj);
 
   return JS_ThrowTypeError(ctx, "Buffer.byteLength() argument must be a string, Buffer, TypedArray, or ArrayBuffer");
 }
 
 // Buffer.concat(list[, totalLength])
 static JSValue js_buffer_concat(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
-  if (argc < 1) {
-    return JS_ThrowTypeError(ctx, "Buffer.concat() requires at least 1 argument");
-  }
-
-  if (!JS_IsArray(ctx, argv[0])) {
-    return JS_ThrowTypeError(ctx, "First argument must be an array");
+  JSValueConst list = buffer_arg(argc, argv, 0);
+  if (!JS_IsArray(ctx, list)) {
+    return JS_ThrowTypeError(ctx, "The \"list\" argument must be an instance of Array");
   }
 
-  JSValue array = argv[0];
-  JSValue length_val = JS_GetPropertyStr(ctx, array, "length");
-  int32_t array_length;
-  if (JS_ToInt32(ctx, &array_length, length_val) < 0) {
+  JSValue length_val = JS_GetPropertyStr(ctx, list, "length");
+  int64_t count;
+  if (JS_ToInt64(ctx, &count, length_val) < 0) {
     JS_FreeValue(ctx, length_val);
     return JS_EXCEPTION;
   }
   JS_FreeValue(ctx, length_val);
 
-  // Calculate total length if not provided
-  size_t total_length = 0;
-  bool length_provided = false;
-
-  if (argc > 1 && !JS_IsUndefined(argv[1])) {
-    int32_t provided_length;
-    if (JS_ToInt32(ctx, &provided_length, argv[1]) >= 0 && provided_length >= 0) {
-      total_length = provided_length;
-      length_provided = true;
+  // Sum the sizes first; every entry has to be a Buffer or Uint8Array
+  size_t sum = 0;
+  for (int64_t i = 0; i < count; i++) {
+    JSValue item = JS_GetPropertyInt64(ctx, list, i);
+    size_t item_size;
+    uint8_t* item_data = buffer_arg_bytes(ctx, item, "list", &item_size);
+    JS_FreeValue(ctx, item);
+    if (!item_data) {
+      return JS_EXCEPTION;
     }
+    sum += item_size;
   }
 
-  if (!length_provided) {
-    for (int32_t i = 0; i < array_length; i++) {
-      JSValue item = JS_GetPropertyUint32(ctx, array, i);
-      size_t item_size;
-      uint8_t* item_data = get_buffer_data(ctx, item, &item_size);
-      if (item_data) {
-        total_length += item_size;
-      }
-      JS_FreeValue(ctx, item);
-    }
+  size_t total = sum;
+  if (!JS_IsUndefined(buffer_arg(argc, argv, 1)) && buffer_size_arg(ctx, argv[1], &total) < 0) {
+    return JS_EXCEPTION;
   }
 
-  // Create result buffer
-  uint8_t* result_data = malloc(total_length);
-  if (total_length > 0 && !result_data) {
-    return JS_ThrowOutOfMemory(ctx);
+  uint8_t* data;
+  JSValue result = buffer_alloc_unsafe(ctx, total, &data);
+  if (JS_IsException(result)) {
+    return JS_EXCEPTION;
   }
 
   size_t offset = 0;
-  for (int32_t i = 0; i < array_length && offset < total_length; i++) {
-    JSValue item = JS_GetPropertyUint32(ctx, array, i);
+  for (int64_t i = 0; i < count && offset < total; i++) {
+    JSValue item = JS_GetPropertyInt64(ctx, list, i);
     size_t item_size;
-    uint8_t* item_data = get_buffer_data(ctx, item, &item_size);
-
+    uint8_t* item_data = jsrt_node_buffer_bytes(ctx, item, &item_size);
     if (item_data) {
-      size_t copy_size = (offset + item_size > total_length) ? (total_length - offset) : item_size;
-      memcpy(result_data + offset, item_data, copy_size);
-      offset += copy_size;
+      size_t n = item_size < total - offset ? item_size : total - offset;
+      memcpy(data + offset, item_data, n);
+      offset += n;
     }
     JS_FreeValue(ctx, item);
   }
-
-  JSValue result_buffer = JS_NewArrayBuffer(ctx, result_data, total_length, NULL, NULL, false);
-  if (JS_IsException(result_buffer)) {
-    free(result_data);
-    return JS_EXCEPTION;
+  if (offset < total) {
+    memset(data + offset, 0, total - offset);
   }
-
-  JSValue uint8_array = create_uint8_array(ctx, result_buffer);
-  JS_FreeValue(ctx, result_buffer);
-  return uint8_array;
+  return result;
 }
 
-// CommonJS module export
-JSValue JSRT_InitNodeBuffer(JSContext* ctx) {
-  JSValue buffer_obj = JS_NewObject(ctx);
-
-  // Create Buffer constructor function
-  JSValue Buffer = JS_NewCFunction2(ctx, js_buffer_constructor, "Buffer", 1, JS_CFUNC_constructor, 0);
-
-  // Ensure Buffer.prototype exists and inherits from Uint8Array.prototype for instanceof checks
-  JSValue global_obj = JS_GetGlobalObject(ctx);
-  JSValue uint8_array_ctor = JS_GetPropertyStr(ctx, global_obj, "Uint8Array");
-  JSValue uint8_array_proto = JS_UNDEFINED;
-  if (JS_IsFunction(ctx, uint8_array_ctor)) {
-    uint8_array_proto = JS_GetPropertyStr(ctx, uint8_array_ctor, "prototype");
+// Buffer.compare(buf1, buf2)
+static JSValue js_buffer_compare_static(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
+  size_t a_len, b_len;
+  uint8_t* a = buffer_arg_bytes(ctx, buffer_arg(argc, argv, 0), "buf1", &a_len);
+  if (!a) {
+    return JS_EXCEPTION;
   }
-
-  if (JS_IsObject(uint8_array_proto)) {
-    JS_SetPropertyStr(ctx, Buffer, "prototype", JS_DupValue(ctx, uint8_array_proto));
-  } else {
-    JS_SetPropertyStr(ctx, Buffer, "prototype", JS_NewObject(ctx));
+  uint8_t* b = buffer_arg_bytes(ctx, buffer_arg(argc, argv, 1), "buf2", &b_len);
+  if (!b) {
+    return JS_EXCEPTION;
   }
+  return JS_NewInt32(ctx, buffer_compare_bytes(a, a_len, b, b_len));
+}
 
-  if (JS_SetPropertyStr(ctx, global_obj, "Buffer", JS_DupValue(ctx, Buffer)) < 0) {
+static const JSCFunctionListEntry js_buffer_funcs[] = {
+    JS_CFUNC_DEF("alloc", 3, js_buffer_alloc),
+    JS_CFUNC_MAGIC_DEF("allocUnsafe", 1, js_buffer_alloc_unsafe, 0),
+    JS_CFUNC_MAGIC_DEF("allocUnsafeSlow", 1, js_buffer_alloc_unsafe, 1),
+    JS_CFUNC_DEF("from", 3, js_buffer_from),
+    JS_CFUNC_DEF("isBuffer", 1, js_buffer_is_buffer),
+    JS_CFUNC_DEF("isEncoding", 1, js_buffer_is_encoding),
+    JS_CFUNC_DEF("byteLength", 2, js_buffer_byte_length),
+    JS_CFUNC_DEF("concat", 2, js_buffer_concat),
+    JS_CFUNC_DEF("compare", 2, js_buffer_compare_static),
+};
+
+// Creates Buffer (a Uint8Array subclass with the methods above) and makes it global
+static int buffer_install(JSContext* ctx) {
+  JSValue global_obj = JS_GetGlobalObject(ctx);
+  JSValue uint8_array = JS_GetPropertyStr(ctx, global_obj, "Uint8Array");
+  JSValue array_buffer = JS_GetPropertyStr(ctx, global_obj, "ArrayBuffer");
+  JSValue uint8_array_proto = JS_IsFunction(ctx, uint8_array) ? JS_GetPropertyStr(ctx, uint8_array, "prototype")
+                                                              : JS_UNDEFINED;
+  if (!JS_IsObject(uint8_array_proto) || !JS_IsFunction(ctx, array_buffer)) {
     JS_FreeValue(ctx, uint8_array_proto);
-    JS_FreeValue(ctx, uint8_array_ctor);
+    JS_FreeValue(ctx, array_buffer);
+    JS_FreeValue(ctx, uint8_array);
     JS_FreeValue(ctx, global_obj);
-    JS_FreeValue(ctx, Buffer);
-    return JS_EXCEPTION;
+    JS_ThrowTypeError(ctx, "Buffer requires Uint8Array and ArrayBuffer");
+    return -1;
   }
 
+  JSValue proto = JS_NewObjectProto(ctx, uint8_array_proto);
+  JS_SetPropertyFunctionList(ctx, proto, js_buffer_proto_funcs, countof(js_buffer_proto_funcs));
+
+  JSValue Buffer = JS_NewCFunction2(ctx, js_buffer_constructor, "Buffer", 2, JS_CFUNC_constructor_or_func, 0);
+  JS_SetConstructor(ctx, Buffer, proto);
+  // Static side inherits Uint8Array too, so Buffer.of() and Symbol.species work
+  JS_SetPrototype(ctx, Buffer, uint8_array);
+  JS_SetPropertyFunctionList(ctx, Buffer, js_buffer_funcs, countof(js_buffer_funcs));
+  JS_SetPropertyStr(ctx, Buffer, "poolSize", JS_NewInt32(ctx, JSRT_BUFFER_POOL_SIZE));
+  JS_SetPropertyStr(ctx, global_obj, "Buffer", JS_DupValue(ctx, Buffer));
+
+  JS_FreeValue(ctx, proto);
   JS_FreeValue(ctx, uint8_array_proto);
-  JS_FreeValue(ctx, uint8_array_ctor);
   JS_FreeValue(ctx, global_obj);
 
-  // Static methods on Buffer
-  JS_SetPropertyStr(ctx, Buffer, "alloc", JS_NewCFunction(ctx, js_buffer_alloc, "alloc", 3));
-  JS_SetPropertyStr(ctx, Buffer, "allocUnsafe", JS_NewCFunction(ctx, js_buffer_alloc_unsafe, "allocUnsafe", 1));
-  JS_SetPropertyStr(ctx, Buffer, "from", JS_NewCFunction(ctx, js_buffer_from, "from", 2));
-  JS_SetPropertyStr(ctx, Buffer, "isBuffer", JS_NewCFunction(ctx, js_buffer_is_buffer, "isBuffer", 1));
-  JS_SetPropertyStr(ctx, Buffer, "concat", JS_NewCFunction(ctx, js_buffer_concat, "concat", 2));
-  JS_SetPropertyStr(ctx, Buffer, "byteLength", JS_NewCFunction(ctx, js_buffer_byte_length, "byteLength", 2));
+  g_buffer.ctx = ctx;
+  g_buffer.ctor = Buffer;
+  g_buffer.uint8_array = uint8_array;
+  g_buffer.array_buffer = array_buffer;
+  g_buffer.pool = JS_UNDEFINED;
+  g_buffer.pool_offset = 0;
+  return 0;
+}
 
-  // Export Buffer as both named and default export for CommonJS
-  JS_SetPropertyStr(ctx, buffer_obj, "Buffer", JS_DupValue(ctx, Buffer));
-  JS_SetPropertyStr(ctx, buffer_obj, "default", Buffer);
+// Releases the Buffer constructor and pool held for ctx
+void jsrt_node_buffer_cleanup(JSContext* ctx) {
+  if (g_buffer.ctx != ctx) {
+    return;
+  }
+  JS_FreeValue(ctx, g_buffer.pool);
+  JS_FreeValue(ctx, g_buffer.array_buffer);
+  JS_FreeValue(ctx, g_buffer.uint8_array);
+  JS_FreeValue(ctx, g_buffer.ctor);
+  memset(&g_buffer, 0, sizeof(g_buffer));
+}
 
+// CommonJS module export; Buffer is created once per context
+JSValue JSRT_InitNodeBuffer(JSContext* ctx) {
+  JSRT_BufferState* state = buffer_state(ctx);
+  if (!state) {
+    return JS_HasException(ctx) ? JS_EXCEPTION : JS_ThrowTypeError(ctx, "Buffer is not available in this context");
+  }
+
+  JSValue buffer_obj = JS_NewObject(ctx);
+  JS_SetPropertyStr(ctx, buffer_obj, "Buffer", JS_DupValue(ctx, state->ctor));
+  JS_SetPropertyStr(ctx, buffer_obj, "default", JS_DupValue(ctx, state->ctor));
+  JS_SetPropertyStr(ctx, buffer_obj, "kMaxLength", JS_NewInt32(ctx, JSRT_BUFFER_MAX_LENGTH));
   return buffer_obj;
 }
 
 // ES Module initialization
 int js_node_buffer_init(JSContext* ctx, JSModuleDef* m) {
   JSValue buffer_module = JSRT_InitNodeBuffer(ctx);
+  if (JS_IsException(buffer_module)) {
+    return -1;
+  }
 
   // Get the Buffer constructor from the module
   JSValue Buffer = JS_GetPropertyStr(ctx, buffer_module, "Buffer");
@@ -4,6 +4,7 @@
 #include <unistd.h>
 #include <uv.h>
 #include "node_modules.h"
+#include "../util/macro.h"
 
 // Platform-specific includes for OpenSSL
 #ifdef _WIN32
@@ -259,7 +260,7 @@ typedef struct https_connection {
   struct https_connection* next;
 } https_connection_t;
 
-static https_connection_t* connection_pool = NULL;
+static JSRT_THREAD_LOCAL https_connection_t* connection_pool = NULL;
 static int max_pool_size = 5;  // Default max connections per host
 
 // Find or create connection from pool
@@ -3,6 +3,7 @@
 #include "../runtime.h"
 #include "../std/assert.h"
 #include "../util/debug.h"
+#include "../util/macro.h"
 #include "module/module_api.h"
 #include "process/process.h"
 #include "worker_threads.h"
@@ -36,6 +37,8 @@ JSValue JSRT_InitNodeReadline(JSContext* ctx);
 int js_node_readline_init(JSContext* ctx, JSModuleDef* m);
 JSValue JSRT_InitNodeTls(JSContext* ctx);
 int js_node_tls_init(JSContext* ctx, JSModuleDef* m);
+JSValue JSRT_InitNodeV8(JSContext* ctx);
+int js_node_v8_init(JSContext* ctx, JSModuleDef* m);
 
 // Module dependency definitions
 static const char* fs_deps[] = {"buffer", "stream", NULL};
@@ -79,7 +82,7 @@ int js_node_http2_init(JSContext* ctx, JSModuleDef* m) {
 }
 
 // Module registry with dependencies
-static NodeModuleEntry node_modules[] = {
+static JSRT_THREAD_LOCAL NodeModuleEntry node_modules[] = {
     // Foundation modules (no dependencies)
     {"assert", JSRT_InitNodeAssert, js_node_assert_init, NULL, false, {0}},
     {"path", JSRT_InitNodePath, js_node_path_init, NULL, false, {0}},
@@ -135,6 +138,7 @@ static NodeModuleEntry node_modules[] = {
     {"diagnostics_channel", JSRT_InitNodeDiagnosticsChannel, js_node_diagnostics_channel_init, NULL, false, {0}},
     {"readline", JSRT_InitNodeReadline, js_node_readline_init, NULL, false, {0}},
     {"tls", JSRT_InitNodeTls, js_node_tls_init, net_deps, false, {0}},
+    {"v8", JSRT_InitNodeV8, js_node_v8_init, NULL, false, {0}},
 
     {NULL, NULL, NULL, NULL, false}};
 
@@ -479,7 +483,11 @@ JSModuleDef* JSRT_LoadNodeModule(JSContext* ctx, const char* module_name) {
     } else if (strcmp(module_name, "vm") == 0) {
       JS_AddModuleExport(ctx, m, "Script");
       JS_AddModuleExport(ctx, m, "createContext");
+      JS_AddModuleExport(ctx, m, "isContext");
       JS_AddModuleExport(ctx, m, "createScript");
+      JS_AddModuleExport(ctx, m, "runInContext");
+      JS_AddModuleExport(ctx, m, "runInNewContext");
+      JS_AddModuleExport(ctx, m, "runInThisContext");
       JS_AddModuleExport(ctx, m, "default");
     } else if (strcmp(module_name, "constants") == 0) {
       JS_AddModuleExport(ctx, m, "errno");
@@ -498,6 +506,14 @@ JSModuleDef* JSRT_LoadNodeModule(JSContext* ctx, const char* module_name) {
     } else if (strcmp(module_name, "string_decoder") == 0) {
       JS_AddModuleExport(ctx, m, "StringDecoder");
       JS_AddModuleExport(ctx, m, "default");
+    } else if (strcmp(module_name, "v8") == 0) {
+      JS_AddModuleExport(ctx, m, "serialize");
+      JS_AddModuleExport(ctx, m, "deserialize");
+      JS_AddModuleExport(ctx, m, "Serializer");
+      JS_AddModuleExport(ctx, m, "Deserializer");
+      JS_AddModuleExport(ctx, m, "DefaultSerializer");
+      JS_AddModuleExport(ctx, m, "DefaultDeserializer");
+      JS_AddModuleExport(ctx, m, "default");
     } else if (strcmp(module_name, "diagnostics_channel") == 0) {
       JS_AddModuleExport(ctx, m, "channel");
       JS_AddModuleExport(ctx, m, "hasSubscribers");
@@ -514,6 +530,20 @@ JSModuleDef* JSRT_LoadNodeModule(JSContext* ctx, const char* module_name) {
       JS_AddModuleExport(ctx, m, "cursorTo");
       JS_AddModuleExport(ctx, m, "moveCursor");
       JS_AddModuleExport(ctx, m, "default");
+    } else if (strcmp(module_name, "worker_threads") == 0) {
+      JS_AddModuleExport(ctx, m, "Worker");
+      JS_AddModuleExport(ctx, m, "MessageChannel");
+      JS_AddModuleExport(ctx, m, "MessagePort");
+      JS_AddModuleExport(ctx, m, "isMainThread");
+      JS_AddModuleExport(ctx, m, "parentPort");
+      JS_AddModuleExport(ctx, m, "threadId");
+      JS_AddModuleExport(ctx, m, "workerData");
+      JS_AddModuleExport(ctx, m, "resourceLimits");
+      JS_AddModuleExport(ctx, m, "receiveMessageOnPort");
+      JS_AddModuleExport(ctx, m, "getEnvironmentData");
+      JS_AddModuleExport(ctx, m, "setEnvironmentData");
+      JS_AddModuleExport(ctx, m, "SHARE_ENV");
+      JS_AddModuleExport(ctx, m, "default");
     } else if (strcmp(module_name, "tls") == 0) {
       JS_AddModuleExport(ctx, m, "connect");
       JS_AddModuleExport(ctx, m, "createServer");
@@ -3,6 +3,7 @@
 
 #include <quickjs.h>
 #include <stdbool.h>
+#include <uv.h>
 
 // Unified module entry structure
 typedef struct {
@@ -43,11 +44,14 @@ JSValue JSRT_InitNodeWASI(JSContext* ctx);
 JSValue JSRT_InitNodeChildProcess(JSContext* ctx);
 JSValue JSRT_InitNodeModule(JSContext* ctx);
 JSValue JSRT_InitNodeVM(JSContext* ctx);
+// Release vm state of the runtime (call before its context is freed)
+void jsrt_vm_cleanup(JSContext* ctx);
 JSValue JSRT_InitNodeConstants(JSContext* ctx);
 JSValue JSRT_InitNodeStringDecoder(JSContext* ctx);
 JSValue JSRT_InitNodeDiagnosticsChannel(JSContext* ctx);
 JSValue JSRT_InitNodeReadline(JSContext* ctx);
 JSValue JSRT_InitNodeTls(JSContext* ctx);
+JSValue JSRT_InitNodeV8(JSContext* ctx);
 JSValue JSRT_InitResolve(JSContext* ctx);
 
 // Unified process module functions
@@ -87,6 +91,7 @@ int js_node_string_decoder_init(JSContext* ctx, JSModuleDef* m);
 int js_node_diagnostics_channel_init(JSContext* ctx, JSModuleDef* m);
 int js_node_readline_init(JSContext* ctx, JSModuleDef* m);
 int js_node_tls_init(JSContext* ctx, JSModuleDef* m);
+int js_node_v8_init(JSContext* ctx, JSModuleDef* m);
 JSModuleDef* js_init_module_node_url(JSContext* ctx, const char* module_name);
 
 // Main loader for Node.js modules
@@ -105,6 +110,76 @@ const char* JSRT_GetNodeModuleName(int index);
 // Node.js timer functions
 JSValue JSRT_InitNodeTimers(JSContext* ctx);
 void JSRT_AddNodeTimerGlobals(JSContext* ctx);
+// Drop pending setImmediate() callbacks and close the runtime's immediate handles
+void jsrt_node_timers_cleanup(JSContext* ctx);
+
+// Encodings understood by Buffer and StringDecoder
+typedef enum {
+  JSRT_BUFFER_ENC_UTF8,
+  JSRT_BUFFER_ENC_HEX,
+  JSRT_BUFFER_ENC_BASE64,
+  JSRT_BUFFER_ENC_BASE64URL,
+  JSRT_BUFFER_ENC_LATIN1,
+  JSRT_BUFFER_ENC_ASCII,
+  JSRT_BUFFER_ENC_UTF16LE,
+} JSRT_BufferEncoding;
+
+// Buffer viewing `length` bytes of array_buffer at byte_offset without copying (from node_buffer.c)
+JSValue jsrt_node_buffer_view(JSContext* ctx, JSValueConst array_buffer, size_t byte_offset, size_t length);
+// Buffer holding a copy of `size` bytes of data, sliced from the allocUnsafe() pool when small
+JSValue jsrt_node_buffer_from_data(JSContext* ctx, const uint8_t* data, size_t size);
+// Bytes viewed by a Buffer, TypedArray or DataView with byteOffset applied; NULL for anything else
+uint8_t* jsrt_node_buffer_bytes(JSContext* ctx, JSValueConst obj, size_t* size);
+// Same for an ArrayBuffer too, as accepted wherever Node.js takes binary input; NULL without an exception
+// for anything else
+uint8_t* jsrt_node_buffer_source_bytes(JSContext* ctx, JSValueConst val, size_t* size);
+// Encoding named by val, utf8 when undefined; throws and returns -1 for unknown names
+int jsrt_node_buffer_encoding(JSContext* ctx, JSValueConst val);
+// Decodes len bytes of data to a string, as Buffer.prototype.toString() does
+JSValue jsrt_node_buffer_decode(JSContext* ctx, const uint8_t* data, size_t len, JSRT_BufferEncoding encoding);
+// Release the Buffer constructor and pool kept for ctx
+void jsrt_node_buffer_cleanup(JSContext* ctx);
+
+// V8 ValueSerializer format (from v8.c): value as serialize() writes it, header included, in js_malloc'd memory;
+// NULL with an exception pending on failure
+uint8_t* jsrt_v8_serialize(JSContext* ctx, JSValueConst value, size_t* size);
+// Value read from data as deserialize() does; data must stay valid until it returns
+JSValue jsrt_v8_deserialize(JSContext* ctx, const uint8_t* data, size_t size);
+
+// TCP handle behind a listening net.Server or connected net.Socket (from net_module.c), for passing over IPC;
+// NULL for anything else
+uv_stream_t* jsrt_net_get_handle(JSContext* ctx, JSValueConst obj, bool* is_server);
+// net.Server listening on, or net.Socket connected over, the TCP handle pending on an IPC pipe
+JSValue jsrt_net_accept_handle(JSContext* ctx, uv_stream_t* pipe, bool is_server);
+
+// child_process IPC messages (from child_process_ipc.c), shared with process.send() in forked children
+typedef enum {
+  JSRT_IPC_SERIALIZATION_JSON,
+  JSRT_IPC_SERIALIZATION_ADVANCED,  // V8 serializer, as v8.serialize()
+} JSRT_IPCSerialization;
+
+// Bytes received on an IPC pipe that do not make up a whole message yet
+typedef struct {
+  char* data;
+  size_t size;
+  size_t capacity;
+} JSRT_IPCReadBuffer;
+
+// Receives each message with the net.Server or net.Socket sent along with it (or undefined); returns false to stop
+typedef bool (*JSRT_IPCMessageFunc)(void* opaque, JSValueConst message, JSValueConst handle);
+
+// Serialization mode named by val ("json" when undefined); throws and returns -1 for anything else
+int jsrt_ipc_serialization(JSContext* ctx, JSValueConst val);
+// Frame holding message in malloc'd memory, flagged to carry send_handle when it is a net.Server or net.Socket;
+// *handle is set to the stream to pass with uv_write2() (or NULL). NULL with an exception pending on failure
+char* jsrt_ipc_encode(JSContext* ctx, JSValueConst message, JSValueConst send_handle,
+                      JSRT_IPCSerialization serialization, size_t* length, uv_stream_t** handle);
+// Appends len received bytes and hands every complete message to on_message
+void jsrt_ipc_read(JSContext* ctx, JSRT_IPCReadBuffer* buffer, uv_stream_t* pipe, JSRT_IPCSerialization serialization,
+                   const char* data, size_t len, JSRT_IPCMessageFunc on_message, void* opaque);
+void jsrt_ipc_read_buffer_free(JSRT_IPCReadBuffer* buffer);
+// Error for a failed IPC write (code, errno and syscall set), passed to the send() callback
+JSValue jsrt_ipc_write_error(JSContext* ctx, int status);
 
 // Configuration
 typedef struct {
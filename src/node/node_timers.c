@@ -2,79 +2,217 @@
 #include <string.h>
 #include "../runtime.h"
 #include "../util/debug.h"
+#include "../util/macro.h"
 #include "node_modules.h"
 
 // Node.js immediate timer implementation
-// setImmediate schedules a callback to be invoked in the next iteration of the event loop
+// setImmediate schedules a callback to be invoked in the check phase of the next event loop iteration.
+// All immediates of a runtime share one uv_check_t, which runs them, and one uv_idle_t, which keeps the poll
+// phase from blocking (and the loop alive) while ref'ed immediates are waiting.
+
+typedef struct NodeImmediate NodeImmediate;
 
 typedef struct {
-  JSContext* ctx;
+  NodeImmediate* head;
+  NodeImmediate* tail;
+} NodeImmediateList;
+
+struct NodeImmediate {
+  JSValue object;  // The Immediate returned to JS, held while queued
   JSValue callback;
   JSValue* args;
   int argc;
-  uint64_t immediate_id;
-  uv_check_t check_handle;
-  bool is_cleared;
-} NodeImmediate;
+  bool has_ref;
+  NodeImmediateList* list;  // NULL once run or cleared
+  NodeImmediate* prev;
+  NodeImmediate* next;
+};
 
-static uint64_t next_immediate_id = 1;
-static NodeImmediate** immediates = NULL;
-static size_t immediate_count = 0;
-static size_t immediate_capacity = 0;
+struct JSRT_ImmediateQueue {
+  JSContext* ctx;
+  uv_check_t check_handle;
+  uv_idle_t idle_handle;
+  NodeImmediateList pending;  // Run by the next check phase
+  NodeImmediateList running;  // Taken by the check phase in progress
+  size_t ref_count;           // Queued immediates keeping the loop alive
+  int open_handles;
+};
+
+static JSClassID js_immediate_class_id;
+
+static void js_immediate_finalizer(JSRuntime* rt, JSValue val) {
+  // Queued immediates hold their object, so only run or cleared ones get here
+  free(JS_GetOpaque(val, js_immediate_class_id));
+}
 
-// Add immediate to tracking array
-static void add_immediate(NodeImmediate* immediate) {
-  if (immediate_count >= immediate_capacity) {
-    immediate_capacity = immediate_capacity ? immediate_capacity * 2 : 8;
-    immediates = realloc(immediates, immediate_capacity * sizeof(NodeImmediate*));
+static JSClassDef js_immediate_class = {
+    "Immediate",
+    .finalizer = js_immediate_finalizer,
+};
+
+static void immediate_list_push(NodeImmediateList* list, NodeImmediate* immediate) {
+  immediate->list = list;
+  immediate->prev = list->tail;
+  immediate->next = NULL;
+  if (list->tail) {
+    list->tail->next = immediate;
+  } else {
+    list->head = immediate;
   }
-  immediates[immediate_count++] = immediate;
+  list->tail = immediate;
 }
 
-// Remove immediate from tracking array
-static void remove_immediate(uint64_t immediate_id) {
-  for (size_t i = 0; i < immediate_count; i++) {
-    if (immediates[i] && immediates[i]->immediate_id == immediate_id) {
-      immediates[i] = NULL;  // Mark as removed
-      break;
+// Idle callback: nothing to do, an active idle handle only makes the poll phase return at once
+static void immediate_idle_callback(uv_idle_t* idle) {
+}
+
+static void immediate_ref_changed(JSRT_ImmediateQueue* queue, bool ref) {
+  if (ref) {
+    if (queue->ref_count++ == 0) {
+      uv_idle_start(&queue->idle_handle, immediate_idle_callback);
     }
+  } else if (--queue->ref_count == 0) {
+    uv_idle_stop(&queue->idle_handle);
   }
 }
 
-// UV check callback - executes the immediate callback
-static void immediate_check_callback(uv_check_t* check) {
-  NodeImmediate* immediate = (NodeImmediate*)check->data;
+// Take an immediate off its list; the caller owns its callback, arguments and object afterwards
+static void immediate_unlink(JSRT_ImmediateQueue* queue, NodeImmediate* immediate) {
+  NodeImmediateList* list = immediate->list;
+  if (immediate->prev) {
+    immediate->prev->next = immediate->next;
+  } else {
+    list->head = immediate->next;
+  }
+  if (immediate->next) {
+    immediate->next->prev = immediate->prev;
+  } else {
+    list->tail = immediate->prev;
+  }
+  immediate->list = NULL;
+  immediate->prev = NULL;
+  immediate->next = NULL;
+  if (immediate->has_ref) {
+    immediate->has_ref = false;
+    immediate_ref_changed(queue, false);
+  }
+}
 
-  if (immediate->is_cleared) {
+// Release what an unlinked immediate held; the object goes last since it may free the immediate
+static void immediate_release(JSContext* ctx, NodeImmediate* immediate) {
+  JS_FreeValue(ctx, immediate->callback);
+  immediate->callback = JS_UNDEFINED;
+  for (int i = 0; i < immediate->argc; i++) {
+    JS_FreeValue(ctx, immediate->args[i]);
+  }
+  free(immediate->args);
+  immediate->args = NULL;
+  immediate->argc = 0;
+  JSValue object = immediate->object;
+  immediate->object = JS_UNDEFINED;
+  JS_FreeValue(ctx, object);
+}
+
+// UV check callback - runs the immediates queued before this check phase
+static void immediate_check_callback(uv_check_t* check) {
+  JSRT_ImmediateQueue* queue = check->data;
+  if (!queue->pending.head) {
     return;
   }
 
-  JSContext* ctx = immediate->ctx;
+  // Immediates queued by these callbacks wait for the next iteration, as in Node.js
+  queue->running = queue->pending;
+  queue->pending.head = NULL;
+  queue->pending.tail = NULL;
+  for (NodeImmediate* immediate = queue->running.head; immediate; immediate = immediate->next) {
+    immediate->list = &queue->running;
+  }
 
-  // Execute the callback
-  JSValue result = JS_Call(ctx, immediate->callback, JS_UNDEFINED, immediate->argc, immediate->args);
+  JSContext* ctx = queue->ctx;
+  JSRT_Runtime* rt = JS_GetContextOpaque(ctx);
+  NodeImmediate* immediate;
+  while ((immediate = queue->running.head)) {
+    immediate_unlink(queue, immediate);
+
+    JSValue result = JS_Call(ctx, immediate->callback, JS_UNDEFINED, immediate->argc, immediate->args);
+    if (JS_IsException(result)) {
+      JSRT_RuntimeAddExceptionValue(rt, JS_GetException(ctx));
+    }
+    JS_FreeValue(ctx, result);
+    immediate_release(ctx, immediate);
+
+    // Promise reactions and nextTick callbacks run between immediates
+    JSRT_RuntimeDrainMicrotasks(rt);
+  }
+}
+
+// Immediate.prototype.ref() / unref()
+static JSValue js_immediate_set_ref(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv, int magic) {
+  NodeImmediate* immediate = JS_GetOpaque2(ctx, this_val, js_immediate_class_id);
+  if (!immediate) {
+    return JS_EXCEPTION;
+  }
+  bool ref = magic != 0;
+  // Run or cleared immediates have nothing left to keep alive
+  if (immediate->list && immediate->has_ref != ref) {
+    immediate->has_ref = ref;
+    JSRT_Runtime* rt = JS_GetContextOpaque(ctx);
+    immediate_ref_changed(rt->immediates, ref);
+  }
+  return JS_DupValue(ctx, this_val);
+}
 
-  if (JS_IsException(result)) {
-    JSRT_Debug("setImmediate callback threw an exception");
+// Immediate.prototype.hasRef()
+static JSValue js_immediate_has_ref(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
+  NodeImmediate* immediate = JS_GetOpaque2(ctx, this_val, js_immediate_class_id);
+  if (!immediate) {
+    return JS_EXCEPTION;
   }
+  return JS_NewBool(ctx, immediate->has_ref);
+}
 
-  JS_FreeValue(ctx, result);
+static const JSCFunctionListEntry js_immediate_proto_funcs[] = {
+    JS_CFUNC_MAGIC_DEF("ref", 0, js_immediate_set_ref, 1),
+    JS_CFUNC_MAGIC_DEF("unref", 0, js_immediate_set_ref, 0),
+    JS_CFUNC_DEF("hasRef", 0, js_immediate_has_ref),
+};
 
-  // Stop and close the check handle
-  uv_check_stop(check);
-  uv_close((uv_handle_t*)check, NULL);
+static void js_immediate_init_class(JSContext* ctx) {
+  JSRuntime* rt = JS_GetRuntime(ctx);
+  JS_NewClassID(&js_immediate_class_id);
+  if (!JS_IsRegisteredClass(rt, js_immediate_class_id)) {
+    JS_NewClass(rt, js_immediate_class_id, &js_immediate_class);
+  }
+  JSValue proto = JS_NewObject(ctx);
+  JS_SetPropertyFunctionList(ctx, proto, js_immediate_proto_funcs, countof(js_immediate_proto_funcs));
+  JS_SetClassProto(ctx, js_immediate_class_id, proto);
+}
 
-  // Clean up
-  JS_FreeValue(ctx, immediate->callback);
-  for (int i = 0; i < immediate->argc; i++) {
-    JS_FreeValue(ctx, immediate->args[i]);
+static JSRT_ImmediateQueue* immediate_queue_get(JSContext* ctx) {
+  JSRT_Runtime* rt = JS_GetContextOpaque(ctx);
+  if (rt->immediates) {
+    return rt->immediates;
   }
-  free(immediate->args);
 
-  // Remove from tracking
-  remove_immediate(immediate->immediate_id);
+  js_immediate_init_class(ctx);
 
-  free(immediate);
+  JSRT_ImmediateQueue* queue = calloc(1, sizeof(JSRT_ImmediateQueue));
+  if (!queue) {
+    return NULL;
+  }
+  queue->ctx = ctx;
+
+  // The check handle never keeps the loop alive by itself; the idle handle does while ref'ed immediates wait
+  uv_check_init(rt->uv_loop, &queue->check_handle);
+  queue->check_handle.data = queue;
+  uv_check_start(&queue->check_handle, immediate_check_callback);
+  uv_unref((uv_handle_t*)&queue->check_handle);
+  uv_idle_init(rt->uv_loop, &queue->idle_handle);
+  queue->idle_handle.data = queue;
+  queue->open_handles = 2;
+
+  rt->immediates = queue;
+  return queue;
 }
 
 // setImmediate(callback[, ...args])
@@ -87,41 +225,48 @@ static JSValue js_set_immediate(JSContext* ctx, JSValueConst this_val, int argc,
     return JS_ThrowTypeError(ctx, "setImmediate callback must be a function");
   }
 
+  JSRT_ImmediateQueue* queue = immediate_queue_get(ctx);
+  if (!queue) {
+    return JS_ThrowOutOfMemory(ctx);
+  }
+
   // Create immediate structure
-  NodeImmediate* immediate = malloc(sizeof(NodeImmediate));
-  immediate->ctx = ctx;
-  immediate->callback = JS_DupValue(ctx, argv[0]);
-  immediate->immediate_id = next_immediate_id++;
-  immediate->is_cleared = false;
+  NodeImmediate* immediate = calloc(1, sizeof(NodeImmediate));
+  if (!immediate) {
+    return JS_ThrowOutOfMemory(ctx);
+  }
 
   // Copy additional arguments
-  immediate->argc = argc - 1;
-  if (immediate->argc > 0) {
-    immediate->args = malloc(immediate->argc * sizeof(JSValue));
+  if (argc > 1) {
+    immediate->args = malloc((argc - 1) * sizeof(JSValue));
+    if (!immediate->args) {
+      free(immediate);
+      return JS_ThrowOutOfMemory(ctx);
+    }
+    immediate->argc = argc - 1;
     for (int i = 0; i < immediate->argc; i++) {
       immediate->args[i] = JS_DupValue(ctx, argv[i + 1]);
     }
-  } else {
-    immediate->args = NULL;
   }
 
-  // Get runtime and event loop
-  JSRuntime* rt = JS_GetRuntime(ctx);
-  JSRT_Runtime* jsrt_rt = (JSRT_Runtime*)JS_GetRuntimeOpaque(rt);
-  uv_loop_t* loop = jsrt_rt->uv_loop;
-
-  // Initialize UV check handle
-  uv_check_init(loop, &immediate->check_handle);
-  immediate->check_handle.data = immediate;
-
-  // Start the check - this will execute in the next loop iteration
-  uv_check_start(&immediate->check_handle, immediate_check_callback);
+  JSValue obj = JS_NewObjectClass(ctx, js_immediate_class_id);
+  if (JS_IsException(obj)) {
+    for (int i = 0; i < immediate->argc; i++) {
+      JS_FreeValue(ctx, immediate->args[i]);
+    }
+    free(immediate->args);
+    free(immediate);
+    return obj;
+  }
+  JS_SetOpaque(obj, immediate);
+  immediate->object = JS_DupValue(ctx, obj);
+  immediate->callback = JS_DupValue(ctx, argv[0]);
+  immediate->has_ref = true;
 
-  // Track the immediate
-  add_immediate(immediate);
+  immediate_list_push(&queue->pending, immediate);
+  immediate_ref_changed(queue, true);
 
-  // Return the immediate ID (as number for simplicity)
-  return JS_NewInt64(ctx, immediate->immediate_id);
+  return obj;
 }
 
 // clearImmediate(immediate)
@@ -130,24 +275,42 @@ static JSValue js_clear_immediate(JSContext* ctx, JSValueConst this_val, int arg
     return JS_UNDEFINED;
   }
 
-  uint64_t immediate_id;
-  if (JS_ToInt64(ctx, (int64_t*)&immediate_id, argv[0]) < 0) {
-    return JS_UNDEFINED;  // Silently ignore invalid IDs like Node.js
+  // Anything but a waiting Immediate is silently ignored, like Node.js
+  NodeImmediate* immediate = JS_GetOpaque(argv[0], js_immediate_class_id);
+  if (!immediate || !immediate->list) {
+    return JS_UNDEFINED;
   }
 
-  // Find and clear the immediate
-  for (size_t i = 0; i < immediate_count; i++) {
-    if (immediates[i] && immediates[i]->immediate_id == immediate_id) {
-      immediates[i]->is_cleared = true;
-      uv_check_stop(&immediates[i]->check_handle);
-      uv_close((uv_handle_t*)&immediates[i]->check_handle, NULL);
-      break;
-    }
-  }
+  JSRT_Runtime* rt = JS_GetContextOpaque(ctx);
+  immediate_unlink(rt->immediates, immediate);
+  immediate_release(ctx, immediate);
 
   return JS_UNDEFINED;
 }
 
+static void immediate_handle_closed(uv_handle_t* handle) {
+  JSRT_ImmediateQueue* queue = handle->data;
+  if (--queue->open_handles == 0) {
+    free(queue);
+  }
+}
+
+void jsrt_node_timers_cleanup(JSContext* ctx) {
+  JSRT_Runtime* rt = JS_GetContextOpaque(ctx);
+  JSRT_ImmediateQueue* queue = rt->immediates;
+  if (!queue) {
+    return;
+  }
+  NodeImmediate* immediate;
+  while ((immediate = queue->pending.head) || (immediate = queue->running.head)) {
+    immediate_unlink(queue, immediate);
+    immediate_release(ctx, immediate);
+  }
+  rt->immediates = NULL;
+  uv_close((uv_handle_t*)&queue->check_handle, immediate_handle_closed);
+  uv_close((uv_handle_t*)&queue->idle_handle, immediate_handle_closed);
+}
+
 // Promise-based setImmediate implementation
 static JSValue js_timers_promise_set_immediate(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
   // Create promise capability functions
@@ -159,11 +322,13 @@ static JSValue js_timers_promise_set_immediate(JSContext* ctx, JSValueConst this
   JSValue resolve_func = promise_funcs[0];
   JSValue reject_func = promise_funcs[1];
 
-  // Schedule the immediate with resolve callback
-  JSValue immediate_args[1];
+  // Schedule the immediate with resolve callback, resolving to the optional value
+  JSValue immediate_args[2];
   immediate_args[0] = JS_DupValue(ctx, resolve_func);
-  JSValue immediate_result = js_set_immediate(ctx, JS_UNDEFINED, 1, immediate_args);
+  immediate_args[1] = argc > 0 ? JS_DupValue(ctx, argv[0]) : JS_UNDEFINED;
+  JSValue immediate_result = js_set_immediate(ctx, JS_UNDEFINED, 2, immediate_args);
   JS_FreeValue(ctx, immediate_args[0]);
+  JS_FreeValue(ctx, immediate_args[1]);
 
   // If immediate scheduling failed, reject the promise
   if (JS_IsException(immediate_result)) {
@@ -3,6 +3,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include "../../util/debug.h"
+#include "../../util/macro.h"
 #include "process.h"
 
 #ifdef _WIN32
@@ -14,8 +15,8 @@
 #endif
 
 // Global state for advanced features
-static bool g_source_maps_enabled = false;
-static uv_idle_t* g_process_ref_handle = NULL;
+static JSRT_THREAD_LOCAL bool g_source_maps_enabled = false;
+static JSRT_THREAD_LOCAL uv_idle_t* g_process_ref_handle = NULL;
 
 // ============================================================================
 // Task 6.1: process.loadEnvFile(path)
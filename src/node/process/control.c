@@ -1,5 +1,6 @@
 #include <stdlib.h>
 #include <string.h>
+#include "../worker_threads.h"
 #include "process.h"
 
 #ifdef _WIN32
@@ -37,6 +38,11 @@ JSValue js_process_exit(JSContext* ctx, JSValueConst this_val, int argc, JSValue
   // Emit 'exit' event before exiting
   jsrt_process_emit_exit(ctx, exit_code);
 
+  // Inside a Worker only that thread stops; the process keeps running
+  if (jsrt_worker_is_worker_thread()) {
+    return jsrt_worker_exit(ctx, exit_code);
+  }
+
   // Exit the process immediately
   exit(exit_code);
 
@@ -2,6 +2,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include "../../util/debug.h"
+#include "../../util/macro.h"
 #include "process.h"
 
 // Forward declaration from quickjs-libc
@@ -15,12 +16,12 @@ typedef struct EventListener {
 } EventListener;
 
 // Global event state
-static EventListener* g_event_listeners = NULL;
-static JSValue g_process_obj_ref = {0};
-static JSContext* g_ctx = NULL;
+static JSRT_THREAD_LOCAL EventListener* g_event_listeners = NULL;
+static JSRT_THREAD_LOCAL JSValue g_process_obj_ref = {0};
+static JSRT_THREAD_LOCAL JSContext* g_ctx = NULL;
 
 // Uncaught exception capture callback
-static JSValue g_uncaught_exception_capture = {0};
+static JSRT_THREAD_LOCAL JSValue g_uncaught_exception_capture = {0};
 
 // Add event listener
 static void add_event_listener(const char* event_name, JSValue callback) {
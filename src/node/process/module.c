@@ -1,6 +1,7 @@
 #include <string.h>
 #include <sys/time.h>
 #include "process.h"
+#include "../../util/macro.h"
 
 // Global variables for process information
 char** jsrt_argv = NULL;
@@ -9,7 +10,7 @@ char* jsrt_argv0 = NULL;
 struct timeval jsrt_start_time = {0, 0};
 
 // Global process module object - initialize with zero, set to JS_UNDEFINED at runtime
-static JSValue g_process_module = {0};
+static JSRT_THREAD_LOCAL JSValue g_process_module = {0};
 
 // Initialize the unified process module
 JSValue jsrt_init_unified_process_module(JSContext* ctx) {
@@ -9,31 +9,6 @@
 #include <sys/resource.h>
 #endif
 
-// Node.js process.nextTick() implementation
-JSValue js_process_nextTick(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
-  if (argc < 1 || !JS_IsFunction(ctx, argv[0])) {
-    return JS_ThrowTypeError(ctx, "Callback must be a function");
-  }
-
-  // Queue the callback to run on the next iteration of the event loop
-  // For now, use setTimeout with 0 delay as a simple implementation
-  JSValue global = JS_GetGlobalObject(ctx);
-  JSValue setTimeout = JS_GetPropertyStr(ctx, global, "setTimeout");
-
-  if (JS_IsFunction(ctx, setTimeout)) {
-    JSValue args[2] = {argv[0], JS_NewInt32(ctx, 0)};
-    JSValue result = JS_Call(ctx, setTimeout, global, 2, args);
-    JS_FreeValue(ctx, args[1]);
-    JS_FreeValue(ctx, setTimeout);
-    JS_FreeValue(ctx, global);
-    return result;
-  }
-
-  JS_FreeValue(ctx, setTimeout);
-  JS_FreeValue(ctx, global);
-  return JS_ThrowInternalError(ctx, "setTimeout not available");
-}
-
 // Node.js process.memoryUsage() implementation
 JSValue js_process_memoryUsage(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
   JSValue obj = JS_NewObject(ctx);
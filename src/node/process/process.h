@@ -58,7 +58,7 @@ JSValue js_process_exit(JSContext* ctx, JSValueConst this_val, int argc, JSValue
 JSValue js_process_cwd(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv);
 JSValue js_process_chdir(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv);
 
-// Node.js specific features (nodejs.c)
+// Node.js specific features (nodejs.c; nextTick in process_node.c)
 JSValue js_process_nextTick(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv);
 JSValue js_process_memoryUsage(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv);
 
@@ -5,6 +5,7 @@
 #include <sys/stat.h>
 #include <unistd.h>
 #include "../../util/debug.h"
+#include "../node_modules.h"
 #include "process.h"
 
 // Simple event listener storage for process object
@@ -25,14 +26,23 @@ typedef struct {
   // Event listeners for process object
   EventListener* listeners;
 
+  // Message encoding chosen by the parent's fork() (NODE_CHANNEL_SERIALIZATION_MODE)
+  JSRT_IPCSerialization serialization;
+
   // Read buffer for incoming messages
-  char* read_buffer;
-  size_t read_buffer_size;
-  size_t read_buffer_capacity;
-  uint32_t expected_length;
-  bool reading_header;
+  JSRT_IPCReadBuffer read_buffer;
 } ProcessIPCState;
 
+// process.send() in flight
+typedef struct {
+  uv_write_t req;
+  uv_buf_t buf;
+  JSContext* ctx;
+  JSValue send_handle;
+  bool keep_open;
+  JSValue callback;
+} ProcessIPCWrite;
+
 static ProcessIPCState* g_ipc_state = NULL;
 
 // Forward declarations
@@ -77,39 +87,23 @@ static void alloc_buffer(uv_handle_t* handle, size_t suggested_size, uv_buf_t* b
   buf->len = suggested_size;
 }
 
-// Process received IPC message
-static void process_ipc_message(ProcessIPCState* state, const char* data, size_t length) {
-  JSContext* ctx = state->ctx;
-
-  // Parse JSON message
-  // JS_ParseJSON requires null-terminated string
-  char* null_terminated = malloc(length + 1);
-  if (!null_terminated) {
-    JSRT_Debug("Failed to allocate memory for IPC message in child");
-    return;
-  }
-  memcpy(null_terminated, data, length);
-  null_terminated[length] = '\0';
-
-  JSValue message = JS_ParseJSON(ctx, null_terminated, length, "<ipc>");
-  free(null_terminated);
-
-  if (JS_IsException(message)) {
-    JSRT_Debug("Failed to parse IPC message in child");
-    JS_FreeValue(ctx, message);
-    return;
-  }
+// Emit 'message' (message, handle) on the process object
+static bool process_ipc_message(void* opaque, JSValueConst message, JSValueConst handle) {
+  ProcessIPCState* state = opaque;
+  JSValueConst args[] = {message, handle};
+  int arg_count = JS_IsUndefined(handle) ? 1 : 2;
 
   // Emit 'message' event on process object using our simple emitter
   EventListener* listener = state->listeners;
   while (listener) {
     if (strcmp(listener->event_name, "message") == 0) {
-      JSValue result = JS_Call(ctx, listener->callback, state->process_obj, 1, &message);
-      JS_FreeValue(ctx, result);
+      JSValue result = JS_Call(state->ctx, listener->callback, state->process_obj, arg_count, args);
+      JS_FreeValue(state->ctx, result);
     }
     listener = listener->next;
   }
-  JS_FreeValue(ctx, message);
+  // Stop at a process.disconnect() made by a listener
+  return state->connected;
 }
 
 // IPC read callback
@@ -157,70 +151,42 @@ static void on_ipc_read(uv_stream_t* stream, ssize_t nread, const uv_buf_t* buf)
     return;
   }
 
-  // Append to read buffer
-  size_t needed = state->read_buffer_size + nread;
-  if (needed > state->read_buffer_capacity) {
-    size_t new_capacity = state->read_buffer_capacity * 2;
-    while (new_capacity < needed)
-      new_capacity *= 2;
-    char* new_buffer = realloc(state->read_buffer, new_capacity);
-    if (!new_buffer) {
-      free(buf->base);
-      return;
-    }
-    state->read_buffer = new_buffer;
-    state->read_buffer_capacity = new_capacity;
-  }
-
-  memcpy(state->read_buffer + state->read_buffer_size, buf->base, nread);
-  state->read_buffer_size += nread;
+  jsrt_ipc_read(state->ctx, &state->read_buffer, stream, state->serialization, buf->base, nread, process_ipc_message,
+                state);
   free(buf->base);
-
-  // Process complete messages
-  while (state->read_buffer_size > 0) {
-    if (state->reading_header) {
-      if (state->read_buffer_size < 4)
-        break;
-
-      // Read length header
-      uint32_t length;
-      memcpy(&length, state->read_buffer, 4);
-      state->expected_length = length;
-      state->reading_header = false;
-
-      // Remove header
-      memmove(state->read_buffer, state->read_buffer + 4, state->read_buffer_size - 4);
-      state->read_buffer_size -= 4;
-    } else {
-      // Reading body
-      if (state->read_buffer_size < state->expected_length)
-        break;
-
-      // Process message
-      process_ipc_message(state, state->read_buffer, state->expected_length);
-
-      // Remove message
-      size_t remaining = state->read_buffer_size - state->expected_length;
-      if (remaining > 0) {
-        memmove(state->read_buffer, state->read_buffer + state->expected_length, remaining);
-      }
-      state->read_buffer_size = remaining;
-      state->reading_header = true;
-      state->expected_length = 0;
-    }
-  }
 }
 
 // IPC write callback
 static void on_ipc_write(uv_write_t* req, int status) {
-  // Free the buffer
-  uv_buf_t* buf = (uv_buf_t*)(req + 1);
-  free(buf->base);
-  free(req);
+  ProcessIPCWrite* write = (ProcessIPCWrite*)req;
+  JSContext* ctx = write->ctx;
 
   if (status < 0) {
     JSRT_Debug("IPC write error in child: %s", uv_strerror(status));
   }
+
+  // A sent socket now belongs to the receiver, as in Node.js
+  if (status == 0 && !JS_IsUndefined(write->send_handle) && !write->keep_open) {
+    bool is_server = false;
+    if (jsrt_net_get_handle(ctx, write->send_handle, &is_server) && !is_server) {
+      JSValue destroy = JS_GetPropertyStr(ctx, write->send_handle, "destroy");
+      JSValue result = JS_Call(ctx, destroy, write->send_handle, 0, NULL);
+      JS_FreeValue(ctx, result);
+      JS_FreeValue(ctx, destroy);
+    }
+  }
+
+  if (!JS_IsUndefined(write->callback)) {
+    JSValue result_val = status == 0 ? JS_UNDEFINED : jsrt_ipc_write_error(ctx, status);
+    JSValue cb_result = JS_Call(ctx, write->callback, JS_UNDEFINED, 1, &result_val);
+    JS_FreeValue(ctx, cb_result);
+    JS_FreeValue(ctx, result_val);
+  }
+
+  free(write->buf.base);
+  JS_FreeValue(ctx, write->send_handle);
+  JS_FreeValue(ctx, write->callback);
+  free(write);
 }
 
 // process.send(message[, sendHandle][, options][, callback])
@@ -234,44 +200,52 @@ static JSValue js_process_send(JSContext* ctx, JSValueConst this_val, int argc,
   }
 
   JSValue message = argv[0];
-
-  // Serialize message to JSON
-  JSValue json_str = JS_JSONStringify(ctx, message, JS_UNDEFINED, JS_UNDEFINED);
-  if (JS_IsException(json_str)) {
-    return JS_EXCEPTION;
+  JSValue send_handle = JS_UNDEFINED;
+  JSValue callback = JS_UNDEFINED;
+  bool keep_open = false;
+  if (argc >= 2 && JS_IsFunction(ctx, argv[argc - 1])) {
+    callback = argv[argc - 1];
+  }
+  if (argc >= 2 && !JS_IsFunction(ctx, argv[1])) {
+    send_handle = argv[1];
+  }
+  if (argc >= 3 && JS_IsObject(argv[2]) && !JS_IsFunction(ctx, argv[2])) {
+    JSValue keep_open_val = JS_GetPropertyStr(ctx, argv[2], "keepOpen");
+    keep_open = JS_ToBool(ctx, keep_open_val);
+    JS_FreeValue(ctx, keep_open_val);
   }
 
+  // Serialize message, with its length header
   size_t length;
-  const char* str = JS_ToCStringLen(ctx, &length, json_str);
-  JS_FreeValue(ctx, json_str);
-
-  if (!str) {
+  uv_stream_t* handle;
+  char* frame = jsrt_ipc_encode(ctx, message, send_handle, g_ipc_state->serialization, &length, &handle);
+  if (!frame) {
     return JS_EXCEPTION;
   }
 
-  // Build message with length header
-  size_t total_length = 4 + length;
-  char* full_message = malloc(total_length);
-  if (!full_message) {
-    JS_FreeCString(ctx, str);
+  // Send message
+  ProcessIPCWrite* write = malloc(sizeof(ProcessIPCWrite));
+  if (!write) {
+    free(frame);
     return JS_ThrowOutOfMemory(ctx);
   }
+  write->buf = uv_buf_init(frame, (unsigned int)length);
+  write->ctx = ctx;
+  write->send_handle = handle ? JS_DupValue(ctx, send_handle) : JS_UNDEFINED;
+  write->keep_open = keep_open;
+  write->callback = JS_DupValue(ctx, callback);
 
-  uint32_t length_header = (uint32_t)length;
-  memcpy(full_message, &length_header, 4);
-  memcpy(full_message + 4, str, length);
-  JS_FreeCString(ctx, str);
-
-  // Send message
-  uv_write_t* req = malloc(sizeof(uv_write_t) + sizeof(uv_buf_t));
-  uv_buf_t* buf = (uv_buf_t*)(req + 1);
-  buf->base = full_message;
-  buf->len = total_length;
-
-  int result = uv_write(req, (uv_stream_t*)g_ipc_state->pipe, buf, 1, on_ipc_write);
+  int result;
+  if (handle) {
+    result = uv_write2(&write->req, (uv_stream_t*)g_ipc_state->pipe, &write->buf, 1, handle, on_ipc_write);
+  } else {
+    result = uv_write(&write->req, (uv_stream_t*)g_ipc_state->pipe, &write->buf, 1, on_ipc_write);
+  }
   if (result < 0) {
-    free(full_message);
-    free(req);
+    free(frame);
+    JS_FreeValue(ctx, write->send_handle);
+    JS_FreeValue(ctx, write->callback);
+    free(write);
     return JS_FALSE;
   }
 
@@ -392,15 +366,18 @@ void jsrt_process_setup_ipc(JSContext* ctx, JSValue process_obj, JSRT_Runtime* r
   g_ipc_state->ctx = ctx;
   g_ipc_state->process_obj = JS_DupValue(ctx, process_obj);
   g_ipc_state->connected = true;
-  g_ipc_state->reading_header = true;
-  g_ipc_state->read_buffer_capacity = 8192;
-  g_ipc_state->read_buffer = malloc(g_ipc_state->read_buffer_capacity);
+
+  // Like Node.js, the mode is meant for this process only, not for its own children
+  const char* serialization = getenv("NODE_CHANNEL_SERIALIZATION_MODE");
+  g_ipc_state->serialization = serialization && strcmp(serialization, "advanced") == 0
+                                   ? JSRT_IPC_SERIALIZATION_ADVANCED
+                                   : JSRT_IPC_SERIALIZATION_JSON;
+  unsetenv("NODE_CHANNEL_SERIALIZATION_MODE");
 
   // Initialize pipe from existing fd 3
   // Note: fd 3 is already managed by libuv when spawned with IPC, so we just wrap it
   g_ipc_state->pipe = malloc(sizeof(uv_pipe_t));
   if (!g_ipc_state->pipe) {
-    free(g_ipc_state->read_buffer);
     free(g_ipc_state);
     g_ipc_state = NULL;
     return;
@@ -412,7 +389,6 @@ void jsrt_process_setup_ipc(JSContext* ctx, JSValue process_obj, JSRT_Runtime* r
   if (result < 0) {
     JSRT_Debug("Failed to init IPC pipe: %s", uv_strerror(result));
     free(g_ipc_state->pipe);
-    free(g_ipc_state->read_buffer);
     free(g_ipc_state);
     g_ipc_state = NULL;
     return;
@@ -423,7 +399,6 @@ void jsrt_process_setup_ipc(JSContext* ctx, JSValue process_obj, JSRT_Runtime* r
   if (ipc_fd < 0) {
     JSRT_Debug("Cannot find IPC socket fd");
     uv_close((uv_handle_t*)g_ipc_state->pipe, NULL);
-    free(g_ipc_state->read_buffer);
     free(g_ipc_state);
     g_ipc_state = NULL;
     return;
@@ -437,7 +412,6 @@ void jsrt_process_setup_ipc(JSContext* ctx, JSValue process_obj, JSRT_Runtime* r
   if (result < 0) {
     JSRT_Debug("Failed to open IPC pipe on fd 3: %s", uv_strerror(result));
     uv_close((uv_handle_t*)g_ipc_state->pipe, NULL);
-    free(g_ipc_state->read_buffer);
     free(g_ipc_state);
     g_ipc_state = NULL;
     return;
@@ -476,9 +450,7 @@ void jsrt_process_setup_ipc(JSContext* ctx, JSValue process_obj, JSRT_Runtime* r
 // Cleanup IPC state
 void jsrt_process_cleanup_ipc(JSContext* ctx) {
   if (g_ipc_state) {
-    if (g_ipc_state->read_buffer) {
-      free(g_ipc_state->read_buffer);
-    }
+    jsrt_ipc_read_buffer_free(&g_ipc_state->read_buffer);
     if (g_ipc_state->pipe) {
       if (g_ipc_state->reading) {
         uv_read_stop((uv_stream_t*)g_ipc_state->pipe);
@@ -1,6 +1,9 @@
 #include "process_node.h"
+#include "../../util/macro.h"
+#include "process.h"
 #include <quickjs.h>
 #include <stdlib.h>
+#include <string.h>
 
 #ifdef _WIN32
 #define WIN32_LEAN_AND_MEAN
@@ -14,54 +17,111 @@
 #include <unistd.h>
 #endif
 
-// Global array to store nextTick callbacks
-static JSValue* next_tick_callbacks = NULL;
-static size_t next_tick_count = 0;
-static size_t next_tick_capacity = 0;
-
-// Process nextTick function
-static JSValue js_process_next_tick(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
+// process.nextTick() queue of a runtime: a FIFO ring buffer, grown by doubling
+typedef struct {
+  JSValue callback;
+  JSValue* args;
+  int argc;
+} NextTick;
+
+struct JSRT_NextTickQueue {
+  NextTick* ticks;
+  size_t head;
+  size_t count;
+  size_t capacity;  // Power of two
+};
+
+// process.nextTick(callback[, ...args])
+JSValue js_process_nextTick(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
   if (argc < 1 || !JS_IsFunction(ctx, argv[0])) {
     return JS_ThrowTypeError(ctx, "nextTick requires a function argument");
   }
 
-  // Expand callback array if needed
-  if (next_tick_count >= next_tick_capacity) {
-    size_t new_capacity = next_tick_capacity == 0 ? 8 : next_tick_capacity * 2;
-    JSValue* new_callbacks = realloc(next_tick_callbacks, new_capacity * sizeof(JSValue));
-    if (!new_callbacks) {
+  JSRT_Runtime* rt = JS_GetContextOpaque(ctx);
+  JSRT_NextTickQueue* queue = rt->next_ticks;
+  if (!queue) {
+    queue = calloc(1, sizeof(JSRT_NextTickQueue));
+    if (!queue) {
       return JS_ThrowOutOfMemory(ctx);
     }
-    next_tick_callbacks = new_callbacks;
-    next_tick_capacity = new_capacity;
+    rt->next_ticks = queue;
   }
 
-  // Store the callback (duplicate the value to prevent GC)
-  next_tick_callbacks[next_tick_count] = JS_DupValue(ctx, argv[0]);
-  next_tick_count++;
+  // Expand the ring if needed, unwrapping it into the new array
+  if (queue->count == queue->capacity) {
+    size_t new_capacity = queue->capacity == 0 ? 16 : queue->capacity * 2;
+    NextTick* new_ticks = malloc(new_capacity * sizeof(NextTick));
+    if (!new_ticks) {
+      return JS_ThrowOutOfMemory(ctx);
+    }
+    size_t first = queue->capacity - queue->head;
+    if (first > queue->count) {
+      first = queue->count;
+    }
+    if (queue->count > 0) {
+      memcpy(new_ticks, queue->ticks + queue->head, first * sizeof(NextTick));
+      memcpy(new_ticks + first, queue->ticks, (queue->count - first) * sizeof(NextTick));
+    }
+    free(queue->ticks);
+    queue->ticks = new_ticks;
+    queue->head = 0;
+    queue->capacity = new_capacity;
+  }
+
+  // Store the callback and its arguments (duplicate the values to prevent GC)
+  NextTick* tick = &queue->ticks[(queue->head + queue->count) & (queue->capacity - 1)];
+  tick->argc = argc - 1;
+  tick->args = NULL;
+  if (tick->argc > 0) {
+    tick->args = malloc(tick->argc * sizeof(JSValue));
+    if (!tick->args) {
+      return JS_ThrowOutOfMemory(ctx);
+    }
+    for (int i = 0; i < tick->argc; i++) {
+      tick->args[i] = JS_DupValue(ctx, argv[i + 1]);
+    }
+  }
+  tick->callback = JS_DupValue(ctx, argv[0]);
+  queue->count++;
 
   return JS_UNDEFINED;
 }
 
-// Execute all nextTick callbacks
+static void free_next_tick(JSContext* ctx, NextTick* tick) {
+  JS_FreeValue(ctx, tick->callback);
+  for (int i = 0; i < tick->argc; i++) {
+    JS_FreeValue(ctx, tick->args[i]);
+  }
+  free(tick->args);
+}
+
+// Execute all nextTick callbacks, including those queued while running them
 void jsrt_process_execute_next_tick(JSContext* ctx) {
-  if (next_tick_count == 0) {
+  JSRT_Runtime* rt = JS_GetContextOpaque(ctx);
+  JSRT_NextTickQueue* queue = rt->next_ticks;
+  if (!queue) {
     return;
   }
 
-  // Execute all callbacks
-  for (size_t i = 0; i < next_tick_count; i++) {
-    JSValue result = JS_Call(ctx, next_tick_callbacks[i], JS_UNDEFINED, 0, NULL);
+  while (queue->count > 0) {
+    // Copy the entry out: the callback may grow the ring
+    NextTick tick = queue->ticks[queue->head];
+    queue->head = (queue->head + 1) & (queue->capacity - 1);
+    queue->count--;
+
+    JSValue result = JS_Call(ctx, tick.callback, JS_UNDEFINED, tick.argc, tick.args);
     if (JS_IsException(result)) {
       // Log the exception but continue with other callbacks
       js_std_dump_error(ctx);
     }
     JS_FreeValue(ctx, result);
-    JS_FreeValue(ctx, next_tick_callbacks[i]);
+    free_next_tick(ctx, &tick);
   }
+}
 
-  // Reset the callback array
-  next_tick_count = 0;
+bool jsrt_process_has_next_tick(JSContext* ctx) {
+  JSRT_Runtime* rt = JS_GetContextOpaque(ctx);
+  return rt->next_ticks && rt->next_ticks->count > 0;
 }
 
 // Process memory usage function
@@ -126,7 +186,7 @@ static JSValue js_process_abort(JSContext* ctx, JSValueConst this_val, int argc,
 // Initialize Node.js specific process functions
 void jsrt_process_node_init(JSContext* ctx, JSValue process_obj) {
   // Add nextTick method
-  JS_SetPropertyStr(ctx, process_obj, "nextTick", JS_NewCFunction(ctx, js_process_next_tick, "nextTick", 1));
+  JS_SetPropertyStr(ctx, process_obj, "nextTick", JS_NewCFunction(ctx, js_process_nextTick, "nextTick", 1));
 
   // Add memoryUsage method
   JS_SetPropertyStr(ctx, process_obj, "memoryUsage", JS_NewCFunction(ctx, js_process_memory_usage, "memoryUsage", 0));
@@ -135,12 +195,18 @@ void jsrt_process_node_init(JSContext* ctx, JSValue process_obj) {
   JS_SetPropertyStr(ctx, process_obj, "abort", JS_NewCFunction(ctx, js_process_abort, "abort", 0));
 }
 
-// Cleanup function for nextTick callbacks
-void jsrt_process_node_cleanup(void) {
-  if (next_tick_callbacks) {
-    free(next_tick_callbacks);
-    next_tick_callbacks = NULL;
-    next_tick_count = 0;
-    next_tick_capacity = 0;
+// Drop callbacks still queued when the runtime goes away
+void jsrt_process_node_cleanup(JSContext* ctx) {
+  JSRT_Runtime* rt = JS_GetContextOpaque(ctx);
+  JSRT_NextTickQueue* queue = rt->next_ticks;
+  if (!queue) {
+    return;
   }
-}
\ No newline at end of file
+  for (; queue->count > 0; queue->count--) {
+    free_next_tick(ctx, &queue->ticks[queue->head]);
+    queue->head = (queue->head + 1) & (queue->capacity - 1);
+  }
+  free(queue->ticks);
+  free(queue);
+  rt->next_ticks = NULL;
+}
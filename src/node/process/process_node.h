@@ -2,6 +2,7 @@
 #define JSRT_PROCESS_NODE_H
 
 #include <quickjs.h>
+#include <stdbool.h>
 
 // Initialize Node.js specific process functions on the process object
 void jsrt_process_node_init(JSContext* ctx, JSValue process_obj);
@@ -9,8 +10,11 @@ void jsrt_process_node_init(JSContext* ctx, JSValue process_obj);
 // Execute all queued nextTick callbacks
 void jsrt_process_execute_next_tick(JSContext* ctx);
 
-// Cleanup function for nextTick callbacks
-void jsrt_process_node_cleanup(void);
+// Whether nextTick callbacks are waiting to run
+bool jsrt_process_has_next_tick(JSContext* ctx);
+
+// Free the nextTick queue of the runtime behind ctx
+void jsrt_process_node_cleanup(JSContext* ctx);
 
 // External function declaration for error dumping
 extern void js_std_dump_error(JSContext* ctx);
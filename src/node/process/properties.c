@@ -1,6 +1,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include "../../util/debug.h"
+#include "../../util/macro.h"
 #include "process.h"
 
 #ifdef _WIN32
@@ -14,11 +15,11 @@
 #endif
 
 // Global variables for process properties
-static char* g_exec_path = NULL;
-static JSValue g_exec_argv = {0};  // Will be initialized to array
-static int g_exit_code_set = 0;
-static int g_exit_code = 0;
-static char* g_process_title = NULL;
+static JSRT_THREAD_LOCAL char* g_exec_path = NULL;
+static JSRT_THREAD_LOCAL JSValue g_exec_argv = {0};  // Will be initialized to array
+static JSRT_THREAD_LOCAL int g_exit_code_set = 0;
+static JSRT_THREAD_LOCAL int g_exit_code = 0;
+static JSRT_THREAD_LOCAL char* g_process_title = NULL;
 
 // Helper function to get executable path (platform-specific)
 static const char* get_executable_path(void) {
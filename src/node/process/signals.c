@@ -5,6 +5,7 @@
 #include <string.h>
 #include <uv.h>
 #include "../../util/debug.h"
+#include "../../util/macro.h"
 #include "process.h"
 
 #ifdef _WIN32
@@ -41,10 +42,10 @@ typedef struct SignalHandler {
   struct SignalHandler* next;
 } SignalHandler;
 
-static SignalHandler* g_signal_handlers = NULL;
-static JSValue g_process_obj = {0};        // Reference to process object for emitting events
-static uv_loop_t* g_signal_loop = NULL;    // Event loop used for signal handlers
-static size_t g_signal_handler_count = 0;  // Number of active native signal handlers
+static JSRT_THREAD_LOCAL SignalHandler* g_signal_handlers = NULL;
+static JSRT_THREAD_LOCAL JSValue g_process_obj = {0};        // Reference to process object for emitting events
+static JSRT_THREAD_LOCAL uv_loop_t* g_signal_loop = NULL;    // Event loop used for signal handlers
+static JSRT_THREAD_LOCAL size_t g_signal_handler_count = 0;  // Number of active native signal handlers
 
 // The current libuv integration becomes unstable when too many native signal
 // watchers are created simultaneously. To preserve stability we cap the number
@@ -76,7 +76,7 @@ static JSValue js_resolve_sync(JSContext* ctx, JSValueConst this_val, int argc,
     }
   } else {
     // Bare module specifier - use npm resolver
-    resolved_path = jsrt_find_node_modules(basedir, id);
+    resolved_path = jsrt_find_node_modules(ctx, basedir, id);
 
     if (!resolved_path) {
       // Try resolving as a relative path
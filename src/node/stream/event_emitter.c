@@ -169,12 +169,26 @@ JSValue js_stream_on(JSContext* ctx, JSValueConst this_val, int argc, JSValueCon
   JS_FreeValue(ctx, on_method);
   JS_FreeValue(ctx, emitter);
 
-  // Return this for chaining
-  if (!JS_IsException(result)) {
-    JS_FreeValue(ctx, result);
-    return JS_DupValue(ctx, this_val);
+  if (JS_IsException(result)) {
+    return result;
   }
-  return result;
+  JS_FreeValue(ctx, result);
+
+  // Like Node.js, a 'data' listener switches a Readable to flowing mode and a
+  // 'readable' listener starts reading ahead
+  JSStreamData* stream = js_stream_get_data(ctx, this_val, js_readable_class_id);
+  if (stream && argc > 0 && JS_IsString(argv[0])) {
+    const char* event = JS_ToCString(ctx, argv[0]);
+    if (event && strcmp(event, "data") == 0 && !stream->flowing) {
+      JS_FreeValue(ctx, js_readable_resume(ctx, this_val, 0, NULL));
+    } else if (event && strcmp(event, "readable") == 0 && stream->buffer_size == 0) {
+      js_readable_request_more(ctx, this_val, stream);
+    }
+    JS_FreeCString(ctx, event);
+  }
+
+  // Return this for chaining
+  return JS_DupValue(ctx, this_val);
 }
 
 JSValue js_stream_once(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
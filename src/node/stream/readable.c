@@ -50,6 +50,27 @@ JSValue js_readable_constructor(JSContext* ctx, JSValueConst new_target, int arg
   return obj;
 }
 
+// Ask the implementation for more data by calling this._read(highWaterMark), if one is defined.
+// Sources such as fs.createReadStream() answer asynchronously with push().
+void js_readable_request_more(JSContext* ctx, JSValueConst this_val, JSStreamData* stream) {
+  if (stream->ended || stream->destroyed) {
+    return;
+  }
+
+  JSValue read_fn = JS_GetPropertyStr(ctx, this_val, "_read");
+  if (JS_IsFunction(ctx, read_fn)) {
+    JSValue size = JS_NewInt32(ctx, stream->options.highWaterMark);
+    JSValue result = JS_Call(ctx, read_fn, this_val, 1, &size);
+    if (JS_IsException(result)) {
+      JSValue error = JS_GetException(ctx);
+      stream_emit(ctx, this_val, "error", 1, &error);
+      JS_FreeValue(ctx, error);
+    }
+    JS_FreeValue(ctx, result);
+  }
+  JS_FreeValue(ctx, read_fn);
+}
+
 // Readable.prototype.read([size])
 static JSValue js_readable_read(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
   JSStreamData* stream = js_stream_get_data(ctx, this_val, js_readable_class_id);
@@ -81,6 +102,7 @@ static JSValue js_readable_read(JSContext* ctx, JSValueConst this_val, int argc,
       stream_emit(ctx, this_val, "end", 0, NULL);
     }
 
+    js_readable_request_more(ctx, this_val, stream);
     return JS_NULL;
   }
 
@@ -96,15 +118,17 @@ static JSValue js_readable_read(JSContext* ctx, JSValueConst this_val, int argc,
   // Reset readable_emitted flag so 'readable' can be emitted again
   stream->readable_emitted = false;
 
-  // If buffer is now below highWaterMark, trigger _read()
-  // (For now, we don't have _read() callback, but this is where it would be called)
-
   // If ended and buffer is empty, emit 'end'
   if (stream->ended && stream->buffer_size == 0 && !stream->ended_emitted) {
     stream->ended_emitted = true;
     stream_emit(ctx, this_val, "end", 0, NULL);
   }
 
+  // The buffer is drained, so let the source produce the next chunk
+  if (stream->buffer_size == 0) {
+    js_readable_request_more(ctx, this_val, stream);
+  }
+
   return data;
 }
 
@@ -258,6 +282,10 @@ JSValue js_readable_resume(JSContext* ctx, JSValueConst this_val, int argc, JSVa
       stream->ended_emitted = true;
       stream_emit(ctx, this_val, "end", 0, NULL);
     }
+
+    if (stream->flowing && stream->buffer_size == 0) {
+      js_readable_request_more(ctx, this_val, stream);
+    }
   }
 
   return JS_DupValue(ctx, this_val);  // Return this for chaining
@@ -369,6 +397,10 @@ JSValue js_readable_pipe(JSContext* ctx, JSValueConst this_val, int argc, JSValu
 
       JS_FreeValue(ctx, data);
     }
+
+    if (src->flowing && src->buffer_size == 0) {
+      js_readable_request_more(ctx, this_val, src);
+    }
   }
 
   return JS_DupValue(ctx, dest);  // Return destination for chaining
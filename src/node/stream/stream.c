@@ -2,6 +2,7 @@
 #include <string.h>
 #include <strings.h>  // For memset
 #include "../../util/debug.h"
+#include "../../util/macro.h"
 #include "../node_modules.h"
 #include "stream_internal.h"
 
@@ -13,7 +14,7 @@ JSClassID js_transform_class_id;
 JSClassID js_passthrough_class_id;
 JSClassID js_stream_class_id;
 
-static JSAtom stream_impl_atom = JS_ATOM_NULL;
+static JSRT_THREAD_LOCAL JSAtom stream_impl_atom = JS_ATOM_NULL;
 
 static JSStreamData* js_stream_try_get(JSValueConst obj, JSClassID class_id) {
   if (!JS_IsObject(obj))
@@ -381,7 +382,7 @@ JSValue js_stream_pipe(JSContext* ctx, JSValueConst this_val, int argc, JSValueC
 
 // Initialize stream classes - must be called before creating any streams
 void jsrt_stream_init_classes(JSContext* ctx) {
-  static bool classes_initialized = false;
+  static JSRT_THREAD_LOCAL bool classes_initialized = false;
   if (classes_initialized) {
     return;  // Already initialized
   }
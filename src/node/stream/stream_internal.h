@@ -95,6 +95,7 @@ JSValue js_readable_set_encoding(JSContext* ctx, JSValueConst this_val, int argc
 JSValue js_readable_pipe(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv);
 JSValue js_readable_unpipe(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv);
 JSValue js_readable_push(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv);
+void js_readable_request_more(JSContext* ctx, JSValueConst this_val, JSStreamData* stream);
 
 // writable.c
 JSValue js_writable_constructor(JSContext* ctx, JSValueConst new_target, int argc, JSValueConst* argv);
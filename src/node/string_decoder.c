@@ -1,238 +1,228 @@
 #include <string.h>
 #include "../runtime.h"
-#include "../std/assert.h"
 #include "../util/debug.h"
+#include "../util/macro.h"
+#include "../util/unicode.h"
 #include "node_modules.h"
 
-// StringDecoder implementation - decodes Buffer objects to strings
-// This is a minimal implementation focused on npm package compatibility
+// StringDecoder implementation - decodes Buffer chunks to strings with the Buffer codecs.
+// Bytes of a character cut off at the end of a chunk are held back until the next write() or end().
 
-// Forward declarations
-static JSValue js_string_decoder_write(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv);
-static JSValue js_string_decoder_end(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv);
-static JSValue js_string_decoder_text(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv);
-static JSValue js_string_decoder_fillLast(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv);
+static JSClassID js_string_decoder_class_id;
 
-// StringDecoder structure
 typedef struct {
-  char* remaining;
-  size_t remaining_len;
-  char* charBuffer;
-  size_t charBufferLen;
-  size_t charBufferReceived;
-  int lastChar;
-  int lastNeed;
+  JSRT_BufferEncoding encoding;
+  uint8_t pending[4];  // Start of a character cut off at the end of the last chunk
+  size_t pending_len;
 } StringDecoder;
 
+// Canonical names, indexed by JSRT_BufferEncoding
+static const char* const string_decoder_encoding_names[] = {
+    "utf8", "hex", "base64", "base64url", "latin1", "ascii", "utf16le",
+};
+
+static void js_string_decoder_finalizer(JSRuntime* rt, JSValue val) {
+  StringDecoder* decoder = JS_GetOpaque(val, js_string_decoder_class_id);
+  if (decoder) {
+    js_free_rt(rt, decoder);
+  }
+}
+
+static JSClassDef js_string_decoder_class = {
+    "StringDecoder",
+    .finalizer = js_string_decoder_finalizer,
+};
+
 // StringDecoder constructor
 static JSValue js_string_decoder_ctor(JSContext* ctx, JSValueConst new_target, int argc, JSValueConst* argv) {
-  JSValue encoding = JS_UNDEFINED;
-  const char* encoding_str = "utf8";
-
-  if (argc > 0) {
-    encoding = argv[0];
-    if (!JS_IsUndefined(encoding) && !JS_IsNull(encoding)) {
-      encoding_str = JS_ToCString(ctx, encoding);
-      if (!encoding_str) {
-        return JS_EXCEPTION;
-      }
-    }
+  int encoding = jsrt_node_buffer_encoding(ctx, argc > 0 ? argv[0] : JS_UNDEFINED);
+  if (encoding < 0) {
+    return JS_EXCEPTION;
   }
 
-  // Create StringDecoder object
-  StringDecoder* decoder = js_malloc(ctx, sizeof(StringDecoder));
-  if (!decoder) {
-    if (!JS_IsUndefined(encoding)) {
-      JS_FreeCString(ctx, encoding_str);
-    }
-    return JS_ThrowOutOfMemory(ctx);
+  JSValue proto = JS_GetPropertyStr(ctx, new_target, "prototype");
+  if (JS_IsException(proto)) {
+    return proto;
   }
-
-  // Initialize decoder
-  memset(decoder, 0, sizeof(StringDecoder));
-
-  // Set encoding-specific properties
-  JSValue obj = JS_NewObjectClass(ctx, 1);
+  JSValue obj = JS_NewObjectProtoClass(ctx, proto, js_string_decoder_class_id);
+  JS_FreeValue(ctx, proto);
   if (JS_IsException(obj)) {
-    js_free(ctx, decoder);
-    if (!JS_IsUndefined(encoding)) {
-      JS_FreeCString(ctx, encoding_str);
-    }
     return obj;
   }
 
-  // Store decoder in object
-  JS_SetOpaque(obj, decoder);
-
-  // Add encoding property
-  JS_SetPropertyStr(ctx, obj, "encoding", JS_NewString(ctx, encoding_str));
-
-  // Set methods on the StringDecoder object
-  JS_SetPropertyStr(ctx, obj, "write", JS_NewCFunction(ctx, js_string_decoder_write, "write", 3));
-  JS_SetPropertyStr(ctx, obj, "end", JS_NewCFunction(ctx, js_string_decoder_end, "end", 0));
-  JS_SetPropertyStr(ctx, obj, "text", JS_NewCFunction(ctx, js_string_decoder_text, "text", 3));
-  JS_SetPropertyStr(ctx, obj, "fillLast", JS_NewCFunction(ctx, js_string_decoder_fillLast, "fillLast", 0));
-
-  if (!JS_IsUndefined(encoding)) {
-    JS_FreeCString(ctx, encoding_str);
+  StringDecoder* decoder = js_mallocz(ctx, sizeof(StringDecoder));
+  if (!decoder) {
+    JS_FreeValue(ctx, obj);
+    return JS_EXCEPTION;
   }
+  decoder->encoding = encoding;
+  JS_SetOpaque(obj, decoder);
 
+  JS_DefinePropertyValueStr(ctx, obj, "encoding", JS_NewString(ctx, string_decoder_encoding_names[encoding]),
+                            JS_PROP_C_W_E);
   return obj;
 }
 
-// StringDecoder finalizer
-static void js_string_decoder_finalizer(JSRuntime* rt, JSValue val) {
-  StringDecoder* decoder = JS_GetOpaque(val, 1);
-  if (decoder) {
-    if (decoder->remaining) {
-      js_free_rt(rt, decoder->remaining);
-    }
-    if (decoder->charBuffer) {
-      js_free_rt(rt, decoder->charBuffer);
+// Bytes of data that end on a character boundary; the rest waits for the next chunk
+static size_t string_decoder_complete_length(JSRT_BufferEncoding encoding, const uint8_t* data, size_t len) {
+  switch (encoding) {
+    case JSRT_BUFFER_ENC_UTF8:
+      return JSRT_UTF8CompleteLength(data, len);
+    case JSRT_BUFFER_ENC_UTF16LE: {
+      size_t complete = len & ~(size_t)1;
+      // Keep a high surrogate together with the low surrogate after it
+      if (complete >= 2 && data[complete - 1] >= 0xd8 && data[complete - 1] <= 0xdb) {
+        complete -= 2;
+      }
+      return complete;
     }
-    js_free_rt(rt, decoder);
+    case JSRT_BUFFER_ENC_BASE64:
+    case JSRT_BUFFER_ENC_BASE64URL:
+      return len - len % 3;
+    default:
+      return len;
   }
 }
 
-// Decode buffer to string
-static JSValue js_string_decoder_write(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
-  JSValue buffer;
-  int32_t start = 0;
-  int32_t end = -1;
-
-  if (argc < 1) {
-    return JS_ThrowTypeError(ctx, "write() requires at least one argument");
-  }
-
-  buffer = argv[0];
-
-  // Handle Buffer or Uint8Array
-  if (!JS_IsObject(buffer)) {
-    return JS_ThrowTypeError(ctx, "First argument must be a Buffer or Uint8Array");
-  }
-
-  if (argc > 1) {
-    if (JS_ToInt32(ctx, &start, argv[1])) {
+// Decodes the held-back bytes followed by data; `flush` decodes everything instead of holding back again
+static JSValue string_decoder_decode(JSContext* ctx, StringDecoder* decoder, const uint8_t* data, size_t len,
+                                     bool flush) {
+  uint8_t* joined = NULL;
+  if (decoder->pending_len > 0) {
+    joined = js_malloc(ctx, decoder->pending_len + len);
+    if (!joined) {
       return JS_EXCEPTION;
     }
-  }
-
-  if (argc > 2) {
-    if (JS_ToInt32(ctx, &end, argv[2])) {
-      return JS_EXCEPTION;
+    memcpy(joined, decoder->pending, decoder->pending_len);
+    if (len > 0) {
+      memcpy(joined + decoder->pending_len, data, len);
     }
+    data = joined;
+    len += decoder->pending_len;
   }
 
-  // Get buffer data
-  size_t buf_size;
-  uint8_t* buf_data = JS_GetArrayBuffer(ctx, &buf_size, JS_GetPropertyStr(ctx, buffer, "buffer"));
-  if (!buf_data) {
-    return JS_ThrowTypeError(ctx, "Unable to get buffer data");
+  size_t complete = flush ? len : string_decoder_complete_length(decoder->encoding, data, len);
+  decoder->pending_len = len - complete;
+  if (decoder->pending_len > 0) {
+    memcpy(decoder->pending, data + complete, decoder->pending_len);
   }
 
-  // Get byteOffset and length
-  int32_t byteOffset, length;
-  if (JS_ToInt32(ctx, &byteOffset, JS_GetPropertyStr(ctx, buffer, "byteOffset"))) {
-    byteOffset = 0;
-  }
-  if (JS_ToInt32(ctx, &length, JS_GetPropertyStr(ctx, buffer, "length"))) {
-    length = buf_size - byteOffset;
-  }
+  JSValue result = jsrt_node_buffer_decode(ctx, data, complete, decoder->encoding);
+  js_free(ctx, joined);
+  return result;
+}
 
-  // Adjust for start and end
-  if (end == -1) {
-    end = length;
+static const uint8_t* string_decoder_bytes(JSContext* ctx, JSValueConst buffer, size_t* len) {
+  const uint8_t* data = jsrt_node_buffer_bytes(ctx, buffer, len);
+  if (!data) {
+    JS_ThrowTypeError(ctx, "The \"buf\" argument must be an instance of Buffer, TypedArray, or DataView");
   }
+  return data;
+}
 
-  // Clamp values
-  start = (start < 0) ? 0 : (start > length) ? length : start;
-  end = (end < 0) ? 0 : (end > length) ? length : end;
-
-  if (start >= end) {
-    return JS_NewString(ctx, "");
+// Decode buffer to string
+static JSValue js_string_decoder_write(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
+  StringDecoder* decoder = JS_GetOpaque2(ctx, this_val, js_string_decoder_class_id);
+  if (!decoder) {
+    return JS_EXCEPTION;
   }
 
-  // Convert to string (simplified - just decode as UTF8)
-  const char* data = (const char*)buf_data + byteOffset + start;
-  size_t len = end - start;
+  if (argc < 1) {
+    return JS_ThrowTypeError(ctx, "write() requires at least one argument");
+  }
+  if (JS_IsString(argv[0])) {
+    return JS_DupValue(ctx, argv[0]);
+  }
 
-  return JS_NewStringLen(ctx, data, len);
+  size_t len;
+  const uint8_t* data = string_decoder_bytes(ctx, argv[0], &len);
+  if (!data) {
+    return JS_EXCEPTION;
+  }
+  return string_decoder_decode(ctx, decoder, data, len, false);
 }
 
-// End decoding and return any remaining bytes
+// End decoding: decode an optional last chunk and whatever is still held back
 static JSValue js_string_decoder_end(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
-  StringDecoder* decoder = JS_GetOpaque(this_val, 1);
+  StringDecoder* decoder = JS_GetOpaque2(ctx, this_val, js_string_decoder_class_id);
   if (!decoder) {
-    return JS_ThrowTypeError(ctx, "Invalid StringDecoder object");
+    return JS_EXCEPTION;
   }
 
-  // Return any remaining bytes as string
-  if (decoder->remaining && decoder->remaining_len > 0) {
-    JSValue result = JS_NewStringLen(ctx, decoder->remaining, decoder->remaining_len);
-    // Clear remaining data
-    js_free(ctx, decoder->remaining);
-    decoder->remaining = NULL;
-    decoder->remaining_len = 0;
-    return result;
+  const uint8_t* data = NULL;
+  size_t len = 0;
+  if (argc > 0 && !JS_IsUndefined(argv[0])) {
+    data = string_decoder_bytes(ctx, argv[0], &len);
+    if (!data) {
+      return JS_EXCEPTION;
+    }
   }
-
-  return JS_NewString(ctx, "");
+  return string_decoder_decode(ctx, decoder, data, len, true);
 }
 
-// Get text from buffer (Node.js 12+ method)
+// Get text from buffer starting at offset (Node.js 12+ method)
 static JSValue js_string_decoder_text(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
-  JSValue buffer;
-  int32_t start = 0;
-  int32_t end = -1;
+  StringDecoder* decoder = JS_GetOpaque2(ctx, this_val, js_string_decoder_class_id);
+  if (!decoder) {
+    return JS_EXCEPTION;
+  }
 
   if (argc < 1) {
     return JS_ThrowTypeError(ctx, "text() requires at least one argument");
   }
 
-  buffer = argv[0];
-
-  if (argc > 1) {
-    if (JS_ToInt32(ctx, &start, argv[1])) {
-      return JS_EXCEPTION;
-    }
+  size_t len;
+  const uint8_t* data = string_decoder_bytes(ctx, argv[0], &len);
+  if (!data) {
+    return JS_EXCEPTION;
   }
 
-  if (argc > 2) {
-    if (JS_ToInt32(ctx, &end, argv[2])) {
-      return JS_EXCEPTION;
-    }
+  uint64_t offset = 0;
+  if (argc > 1 && JS_ToIndex(ctx, &offset, argv[1])) {
+    return JS_EXCEPTION;
   }
-
-  // Similar to write but simpler - just decode and return
-  return js_string_decoder_write(ctx, this_val, argc, argv);
+  if (offset > len) {
+    offset = len;
+  }
+  return string_decoder_decode(ctx, decoder, data + offset, len - (size_t)offset, false);
 }
 
 // Fill the buffer (Node.js 12+ method)
 static JSValue js_string_decoder_fillLast(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
-  StringDecoder* decoder = JS_GetOpaque(this_val, 1);
+  StringDecoder* decoder = JS_GetOpaque2(ctx, this_val, js_string_decoder_class_id);
   if (!decoder) {
-    return JS_ThrowTypeError(ctx, "Invalid StringDecoder object");
+    return JS_EXCEPTION;
   }
 
-  // This is a no-op in this simplified implementation
+  // Partial characters are completed by write() itself
   return JS_UNDEFINED;
 }
 
+static const JSCFunctionListEntry js_string_decoder_proto_funcs[] = {
+    JS_CFUNC_DEF("write", 1, js_string_decoder_write),
+    JS_CFUNC_DEF("end", 0, js_string_decoder_end),
+    JS_CFUNC_DEF("text", 2, js_string_decoder_text),
+    JS_CFUNC_DEF("fillLast", 1, js_string_decoder_fillLast),
+};
+
 // StringDecoder module initialization (CommonJS)
 JSValue JSRT_InitNodeStringDecoder(JSContext* ctx) {
+  JSRuntime* rt = JS_GetRuntime(ctx);
   JSValue string_decoder_obj = JS_NewObject(ctx);
 
+  JS_NewClassID(&js_string_decoder_class_id);
+  if (!JS_IsRegisteredClass(rt, js_string_decoder_class_id)) {
+    JS_NewClass(rt, js_string_decoder_class_id, &js_string_decoder_class);
+  }
+
   // StringDecoder constructor
   JSValue ctor = JS_NewCFunction2(ctx, js_string_decoder_ctor, "StringDecoder", 1, JS_CFUNC_constructor, 0);
   JS_SetPropertyStr(ctx, string_decoder_obj, "StringDecoder", ctor);
 
   // StringDecoder prototype methods
   JSValue proto = JS_GetPropertyStr(ctx, ctor, "prototype");
-  JS_SetPropertyStr(ctx, proto, "write", JS_NewCFunction(ctx, js_string_decoder_write, "write", 3));
-  JS_SetPropertyStr(ctx, proto, "end", JS_NewCFunction(ctx, js_string_decoder_end, "end", 0));
-  JS_SetPropertyStr(ctx, proto, "text", JS_NewCFunction(ctx, js_string_decoder_text, "text", 3));
-  JS_SetPropertyStr(ctx, proto, "fillLast", JS_NewCFunction(ctx, js_string_decoder_fillLast, "fillLast", 0));
-  JS_FreeValue(ctx, proto);
+  JS_SetPropertyFunctionList(ctx, proto, js_string_decoder_proto_funcs, countof(js_string_decoder_proto_funcs));
+  JS_SetClassProto(ctx, js_string_decoder_class_id, proto);
 
   return string_decoder_obj;
 }
@@ -247,4 +237,4 @@ int js_node_string_decoder_init(JSContext* ctx, JSModuleDef* m) {
 
   JS_FreeValue(ctx, string_decoder_obj);
   return 0;
-}
\ No newline at end of file
+}
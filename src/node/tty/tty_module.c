@@ -22,6 +22,7 @@
 #include <uv.h>
 #include "../../runtime.h"
 #include "../../util/debug.h"
+#include "../../util/macro.h"
 #include "tty.h"
 
 // Global state for TTY resize handling
@@ -515,7 +516,7 @@ void js_tty_cleanup_global_state(void) {
 }
 
 // Initialize TTY classes (should be called during module initialization)
-static bool tty_classes_initialized = false;
+static JSRT_THREAD_LOCAL bool tty_classes_initialized = false;
 
 void js_tty_init_classes(JSContext* ctx) {
   if (tty_classes_initialized) {
@@ -0,0 +1,2256 @@
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../runtime.h"
+#include "../std/clone.h"
+#include "../util/debug.h"
+#include "../util/macro.h"
+#include "../util/unicode.h"
+#include "node_modules.h"
+
+// v8 module implementation - serialize()/deserialize() and the Serializer/Deserializer classes
+//
+// Values are written in the V8 ValueSerializer wire format (version 15), so
+// data written here or by Node.js reads back in either. The traversal follows
+// structuredClone(): objects are classified and tracked by identity with the
+// helpers from std/clone.c, and each object gets an id the first time it is
+// written so that shared references and cycles become back-references.
+//
+// As in Node.js, serialize() and DefaultSerializer write typed arrays and
+// Buffers as host objects holding only their own bytes, while a plain
+// Serializer writes the whole ArrayBuffer followed by a view into it.
+
+#define V8_WIRE_FORMAT_VERSION 15
+// Deeper structures throw instead of exhausting the C stack
+#define V8_MAX_DEPTH 10000
+
+// Value tags of the wire format
+enum {
+  V8_TAG_VERSION = 0xff,
+  V8_TAG_PADDING = '\0',
+  V8_TAG_VERIFY_OBJECT_COUNT = '?',
+  V8_TAG_THE_HOLE = '-',
+  V8_TAG_UNDEFINED = '_',
+  V8_TAG_NULL = '0',
+  V8_TAG_TRUE = 'T',
+  V8_TAG_FALSE = 'F',
+  V8_TAG_INT32 = 'I',
+  V8_TAG_UINT32 = 'U',
+  V8_TAG_DOUBLE = 'N',
+  V8_TAG_BIGINT = 'Z',
+  V8_TAG_UTF8_STRING = 'S',
+  V8_TAG_ONE_BYTE_STRING = '"',
+  V8_TAG_TWO_BYTE_STRING = 'c',
+  V8_TAG_OBJECT_REFERENCE = '^',
+  V8_TAG_BEGIN_OBJECT = 'o',
+  V8_TAG_END_OBJECT = '{',
+  V8_TAG_BEGIN_SPARSE_ARRAY = 'a',
+  V8_TAG_END_SPARSE_ARRAY = '@',
+  V8_TAG_BEGIN_DENSE_ARRAY = 'A',
+  V8_TAG_END_DENSE_ARRAY = '$',
+  V8_TAG_DATE = 'D',
+  V8_TAG_TRUE_OBJECT = 'y',
+  V8_TAG_FALSE_OBJECT = 'x',
+  V8_TAG_NUMBER_OBJECT = 'n',
+  V8_TAG_BIGINT_OBJECT = 'z',
+  V8_TAG_STRING_OBJECT = 's',
+  V8_TAG_REGEXP = 'R',
+  V8_TAG_BEGIN_MAP = ';',
+  V8_TAG_END_MAP = ':',
+  V8_TAG_BEGIN_SET = '\'',
+  V8_TAG_END_SET = ',',
+  V8_TAG_ARRAY_BUFFER = 'B',
+  V8_TAG_RESIZABLE_ARRAY_BUFFER = '~',
+  V8_TAG_ARRAY_BUFFER_TRANSFER = 't',
+  V8_TAG_ARRAY_BUFFER_VIEW = 'V',
+  V8_TAG_ERROR = 'r',
+  V8_TAG_HOST_OBJECT = '\\',
+};
+
+// Fields of an error, after V8_TAG_ERROR
+enum {
+  V8_ERROR_MESSAGE = 'm',
+  V8_ERROR_CAUSE = 'c',
+  V8_ERROR_STACK = 's',
+  V8_ERROR_END = '.',
+};
+
+// Prototype tags of the native error types; plain Error has none
+static const struct {
+  const char* name;
+  uint8_t tag;
+} v8_error_types[] = {
+    {"EvalError", 'E'}, {"RangeError", 'R'}, {"ReferenceError", 'F'},
+    {"SyntaxError", 'S'}, {"TypeError", 'T'}, {"URIError", 'U'},
+};
+
+// Sub-tag of an ArrayBuffer view, indexed by JSTypedArrayEnum
+static const uint8_t v8_view_tags[] = {
+    [JS_TYPED_ARRAY_UINT8C] = 'C',    [JS_TYPED_ARRAY_INT8] = 'b',       [JS_TYPED_ARRAY_UINT8] = 'B',
+    [JS_TYPED_ARRAY_INT16] = 'w',     [JS_TYPED_ARRAY_UINT16] = 'W',     [JS_TYPED_ARRAY_INT32] = 'd',
+    [JS_TYPED_ARRAY_UINT32] = 'D',    [JS_TYPED_ARRAY_BIG_INT64] = 'q',  [JS_TYPED_ARRAY_BIG_UINT64] = 'Q',
+    [JS_TYPED_ARRAY_FLOAT16] = 'h',   [JS_TYPED_ARRAY_FLOAT32] = 'f',    [JS_TYPED_ARRAY_FLOAT64] = 'F',
+};
+#define V8_VIEW_TAG_DATA_VIEW '?'
+
+// Bytes per element, indexed by JSTypedArrayEnum
+static const uint8_t v8_typed_array_sizes[] = {
+    [JS_TYPED_ARRAY_UINT8C] = 1, [JS_TYPED_ARRAY_INT8] = 1,      [JS_TYPED_ARRAY_UINT8] = 1,
+    [JS_TYPED_ARRAY_INT16] = 2,  [JS_TYPED_ARRAY_UINT16] = 2,    [JS_TYPED_ARRAY_INT32] = 4,
+    [JS_TYPED_ARRAY_UINT32] = 4, [JS_TYPED_ARRAY_BIG_INT64] = 8, [JS_TYPED_ARRAY_BIG_UINT64] = 8,
+    [JS_TYPED_ARRAY_FLOAT16] = 2, [JS_TYPED_ARRAY_FLOAT32] = 4,  [JS_TYPED_ARRAY_FLOAT64] = 8,
+};
+
+// Node's DefaultSerializer host objects start with an index into this list; -1 for DataView, -2 for Buffer
+static const int v8_host_view_types[] = {
+    JS_TYPED_ARRAY_INT8,    JS_TYPED_ARRAY_UINT8,   JS_TYPED_ARRAY_UINT8C,    JS_TYPED_ARRAY_INT16,
+    JS_TYPED_ARRAY_UINT16,  JS_TYPED_ARRAY_INT32,   JS_TYPED_ARRAY_UINT32,    JS_TYPED_ARRAY_FLOAT32,
+    JS_TYPED_ARRAY_FLOAT64, -1,                     -2,                       JS_TYPED_ARRAY_BIG_INT64,
+    JS_TYPED_ARRAY_BIG_UINT64,
+};
+#define V8_HOST_DATA_VIEW 9
+#define V8_HOST_BUFFER 10
+
+// RegExp flags and their bits in the wire format
+static const struct {
+  char flag;
+  uint32_t bit;
+} v8_regexp_flags[] = {
+    {'d', 1 << 7}, {'g', 1 << 0}, {'i', 1 << 1}, {'m', 1 << 2},
+    {'s', 1 << 5}, {'u', 1 << 4}, {'v', 1 << 8}, {'y', 1 << 3},
+};
+
+static JSClassID js_v8_serializer_class_id;
+static JSClassID js_v8_deserializer_class_id;
+
+// ============================================================================
+// Serializer
+// ============================================================================
+
+typedef struct {
+  JSContext* ctx;
+  uint8_t* data;  // Output so far
+  size_t size;
+  size_t capacity;
+  JSRT_CloneMap objects;    // Objects written so far, to their ids
+  uint32_t next_id;
+  JSRT_CloneMap transfers;  // ArrayBuffers passed to transferArrayBuffer(), to their transfer ids
+  bool host_views;          // Typed arrays and DataViews as host objects, as Node's DefaultSerializer does
+  bool busy;                // Inside writeValue()
+  // Set up for the duration of one writeValue()
+  JSRT_CloneTypes types;
+  JSValue array_from;     // Array.from, for snapshots of Map and Set entries
+  JSValueConst delegate;  // Serializer object with _writeHostObject() and _getDataCloneError(), or undefined
+  int depth;
+} V8Writer;
+
+static void v8_writer_init(JSContext* ctx, V8Writer* w, bool host_views) {
+  memset(w, 0, sizeof(*w));
+  w->ctx = ctx;
+  w->host_views = host_views;
+  w->array_from = JS_UNDEFINED;
+  w->delegate = JS_UNDEFINED;
+  JSRT_CloneMapInit(ctx, &w->objects);
+  JSRT_CloneMapInit(ctx, &w->transfers);
+}
+
+static void v8_writer_free_rt(JSRuntime* rt, V8Writer* w) {
+  js_free_rt(rt, w->data);
+  JSRT_CloneMapFreeRT(rt, &w->objects);
+  JSRT_CloneMapFreeRT(rt, &w->transfers);
+}
+
+// Room for n more bytes of output; NULL with an exception when out of memory
+static uint8_t* v8_write_reserve(V8Writer* w, size_t n) {
+  if (n > w->capacity - w->size) {
+    size_t capacity = w->capacity ? w->capacity : 256;
+    while (capacity - w->size < n) {
+      capacity *= 2;
+    }
+    uint8_t* data = js_realloc(w->ctx, w->data, capacity);
+    if (!data) {
+      return NULL;
+    }
+    w->data = data;
+    w->capacity = capacity;
+  }
+  uint8_t* p = w->data + w->size;
+  w->size += n;
+  return p;
+}
+
+static int v8_write_bytes(V8Writer* w, const void* src, size_t n) {
+  if (n == 0) {
+    return 0;
+  }
+  uint8_t* p = v8_write_reserve(w, n);
+  if (!p) {
+    return -1;
+  }
+  memcpy(p, src, n);
+  return 0;
+}
+
+static int v8_write_byte(V8Writer* w, uint8_t byte) {
+  return v8_write_bytes(w, &byte, 1);
+}
+
+// Base-128, least significant group first
+static int v8_write_varint(V8Writer* w, uint64_t value) {
+  uint8_t buf[10];
+  size_t n = 0;
+  do {
+    buf[n++] = (uint8_t)(value & 0x7f) | (value >= 0x80 ? 0x80 : 0);
+    value >>= 7;
+  } while (value);
+  return v8_write_bytes(w, buf, n);
+}
+
+static int v8_write_tag_varint(V8Writer* w, uint8_t tag, uint64_t value) {
+  return v8_write_byte(w, tag) < 0 ? -1 : v8_write_varint(w, value);
+}
+
+static int v8_write_int32(V8Writer* w, int32_t value) {
+  // ZigZag: small magnitudes of either sign stay short
+  return v8_write_tag_varint(w, V8_TAG_INT32, ((uint32_t)value << 1) ^ (uint32_t)(value >> 31));
+}
+
+static int v8_write_double(V8Writer* w, double value) {
+  return v8_write_bytes(w, &value, sizeof(value));
+}
+
+static int v8_write_header(V8Writer* w) {
+  return v8_write_tag_varint(w, V8_TAG_VERSION, V8_WIRE_FORMAT_VERSION);
+}
+
+// Throws Error (or what the Serializer's _getDataCloneError() makes) with message
+static int v8_throw_clone_error(V8Writer* w, const char* message) {
+  JSContext* ctx = w->ctx;
+  JSValue error = JS_UNDEFINED;
+  if (JS_IsObject(w->delegate)) {
+    JSValue ctor = JS_GetPropertyStr(ctx, w->delegate, "_getDataCloneError");
+    if (JS_IsFunction(ctx, ctor)) {
+      JSValue arg = JS_NewString(ctx, message);
+      error = JS_CallConstructor(ctx, ctor, 1, &arg);
+      JS_FreeValue(ctx, arg);
+    }
+    JS_FreeValue(ctx, ctor);
+    if (JS_IsException(error)) {
+      return -1;
+    }
+  }
+  if (JS_IsUndefined(error)) {
+    error = JS_NewError(ctx);
+    JS_SetPropertyStr(ctx, error, "message", JS_NewString(ctx, message));
+  }
+  JS_Throw(ctx, error);
+  return -1;
+}
+
+// String from JS_ToCStringLen: Latin-1 when every character fits, UTF-16LE otherwise
+static int v8_write_utf8(V8Writer* w, const uint8_t* str, size_t len) {
+  size_t ascii = JSRT_ASCIIPrefix(str, len);
+  size_t chars = ascii;
+  bool latin1 = true;
+  for (size_t i = ascii; i < len; i++) {
+    // Only code points up to U+00FF have a lead byte below 0xC4
+    if (str[i] >= 0xc4) {
+      latin1 = false;
+      break;
+    }
+    chars += (str[i] & 0xc0) != 0x80;
+  }
+
+  if (latin1) {
+    if (v8_write_tag_varint(w, V8_TAG_ONE_BYTE_STRING, chars) < 0) {
+      return -1;
+    }
+    if (ascii == len) {
+      return v8_write_bytes(w, str, len);
+    }
+    uint8_t* dst = v8_write_reserve(w, chars);
+    if (!dst) {
+      return -1;
+    }
+    JSRT_UTF8ToLatin1(str, len, dst, chars);
+    return 0;
+  }
+
+  size_t byte_length = JSRT_UTF8UTF16Length(str, len) * 2;
+  uint8_t varint[10];
+  size_t varint_size = 0;
+  for (uint64_t v = byte_length; varint_size == 0 || v; v >>= 7) {
+    varint[varint_size++] = (uint8_t)(v & 0x7f) | (v >= 0x80 ? 0x80 : 0);
+  }
+  // Readers may view the characters in place, so they start at an even offset
+  if (((w->size + 1 + varint_size) & 1) && v8_write_byte(w, V8_TAG_PADDING) < 0) {
+    return -1;
+  }
+  if (v8_write_byte(w, V8_TAG_TWO_BYTE_STRING) < 0 || v8_write_bytes(w, varint, varint_size) < 0) {
+    return -1;
+  }
+  uint8_t* dst = v8_write_reserve(w, byte_length);
+  if (!dst) {
+    return -1;
+  }
+  JSRT_UTF8ToUTF16LE(str, len, dst, byte_length);
+  return 0;
+}
+
+static int v8_write_string(V8Writer* w, JSValueConst value) {
+  size_t len;
+  const char* str = JS_ToCStringLen(w->ctx, &len, value);
+  if (!str) {
+    return -1;
+  }
+  int ret = v8_write_utf8(w, (const uint8_t*)str, len);
+  JS_FreeCString(w->ctx, str);
+  return ret;
+}
+
+static int v8_write_number(V8Writer* w, JSValueConst value) {
+  if (JS_VALUE_GET_TAG(value) == JS_TAG_INT) {
+    return v8_write_int32(w, JS_VALUE_GET_INT(value));
+  }
+  double d;
+  if (JS_ToFloat64(w->ctx, &d, value)) {
+    return -1;
+  }
+  // Integral doubles are Smis to V8
+  if (d >= INT32_MIN && d <= INT32_MAX && (double)(int32_t)d == d && !(d == 0 && signbit(d))) {
+    return v8_write_int32(w, (int32_t)d);
+  }
+  return v8_write_byte(w, V8_TAG_DOUBLE) < 0 ? -1 : v8_write_double(w, d);
+}
+
+// Bit field (byte length << 1 | sign) then the magnitude in little-endian 64-bit digits
+static int v8_write_bigint_digits(V8Writer* w, JSValueConst value) {
+  JSContext* ctx = w->ctx;
+  JSAtom to_string = JS_NewAtom(ctx, "toString");
+  JSValue radix = JS_NewInt32(ctx, 16);
+  JSValue hex_val = JS_Invoke(ctx, value, to_string, 1, &radix);
+  JS_FreeAtom(ctx, to_string);
+  size_t len;
+  const char* hex = JS_IsException(hex_val) ? NULL : JS_ToCStringLen(ctx, &len, hex_val);
+  JS_FreeValue(ctx, hex_val);
+  if (!hex) {
+    return -1;
+  }
+
+  bool negative = hex[0] == '-';
+  const char* digits = hex + negative;
+  size_t ndigits = len - negative;
+  if (ndigits == 1 && digits[0] == '0') {
+    ndigits = 0;
+  }
+  size_t byte_length = ((ndigits + 1) / 2 + 7) / 8 * 8;
+  int ret = v8_write_varint(w, (uint64_t)byte_length << 1 | negative);
+  uint8_t* dst = ret < 0 || byte_length == 0 ? NULL : v8_write_reserve(w, byte_length);
+  if (dst) {
+    memset(dst, 0, byte_length);
+    for (size_t i = 0; i < ndigits; i++) {
+      char c = digits[ndigits - 1 - i];
+      int nibble = c <= '9' ? c - '0' : c - 'a' + 10;
+      dst[i / 2] |= (uint8_t)(nibble << (i % 2 * 4));
+    }
+  } else if (byte_length) {
+    ret = -1;
+  }
+  JS_FreeCString(ctx, hex);
+  return ret;
+}
+
+static int v8_write_value(V8Writer* w, JSValueConst value);
+
+static int v8_assign_id(V8Writer* w, JSValueConst obj) {
+  return JSRT_CloneMapSet(&w->objects, obj, JS_NewInt32(w->ctx, (int32_t)w->next_id++));
+}
+
+// Canonical array index ("0", "17", never "017"), which V8 keeps as a number key
+static bool v8_parse_index(const char* str, size_t len, uint32_t* index) {
+  if (len == 0 || len > 10 || (len > 1 && str[0] == '0')) {
+    return false;
+  }
+  uint64_t value = 0;
+  for (size_t i = 0; i < len; i++) {
+    if (str[i] < '0' || str[i] > '9') {
+      return false;
+    }
+    value = value * 10 + (uint64_t)(str[i] - '0');
+  }
+  if (value >= UINT32_MAX) {
+    return false;
+  }
+  *index = (uint32_t)value;
+  return true;
+}
+
+static int v8_write_key(V8Writer* w, JSAtom atom) {
+  JSContext* ctx = w->ctx;
+  JSValue key = JS_AtomToString(ctx, atom);
+  size_t len;
+  const char* str = JS_IsException(key) ? NULL : JS_ToCStringLen(ctx, &len, key);
+  JS_FreeValue(ctx, key);
+  if (!str) {
+    return -1;
+  }
+
+  int ret;
+  uint32_t index;
+  if (!v8_parse_index(str, len, &index)) {
+    ret = v8_write_utf8(w, (const uint8_t*)str, len);
+  } else if (index <= INT32_MAX) {
+    ret = v8_write_int32(w, (int32_t)index);
+  } else {
+    ret = v8_write_byte(w, V8_TAG_DOUBLE) < 0 ? -1 : v8_write_double(w, index);
+  }
+  JS_FreeCString(ctx, str);
+  return ret;
+}
+
+// Key/value pairs for props[start..count)
+static int v8_write_properties(V8Writer* w, JSValueConst obj, JSPropertyEnum* props, uint32_t start, uint32_t count) {
+  for (uint32_t i = start; i < count; i++) {
+    JSValue value = JS_GetProperty(w->ctx, obj, props[i].atom);
+    if (JS_IsException(value)) {
+      return -1;
+    }
+    int ret = v8_write_key(w, props[i].atom) < 0 ? -1 : v8_write_value(w, value);
+    JS_FreeValue(w->ctx, value);
+    if (ret < 0) {
+      return -1;
+    }
+  }
+  return 0;
+}
+
+static int v8_write_plain_object(V8Writer* w, JSValueConst obj) {
+  JSContext* ctx = w->ctx;
+  if (v8_assign_id(w, obj) < 0 || v8_write_byte(w, V8_TAG_BEGIN_OBJECT) < 0) {
+    return -1;
+  }
+  JSPropertyEnum* props;
+  uint32_t count;
+  if (JS_GetOwnPropertyNames(ctx, &props, &count, obj, JS_GPN_STRING_MASK | JS_GPN_ENUM_ONLY) < 0) {
+    return -1;
+  }
+  int ret = v8_write_properties(w, obj, props, 0, count);
+  JS_FreePropertyEnum(ctx, props, count);
+  return ret < 0 ? -1 : v8_write_tag_varint(w, V8_TAG_END_OBJECT, count);
+}
+
+// Dense when every index below length is an own property, sparse otherwise
+static int v8_write_array(V8Writer* w, JSValueConst array) {
+  JSContext* ctx = w->ctx;
+  JSValue length_val = JS_GetPropertyStr(ctx, array, "length");
+  uint32_t length;
+  if (JS_IsException(length_val) || JS_ToUint32(ctx, &length, length_val)) {
+    JS_FreeValue(ctx, length_val);
+    return -1;
+  }
+
+  JSPropertyEnum* props;
+  uint32_t count;
+  if (JS_GetOwnPropertyNames(ctx, &props, &count, array, JS_GPN_STRING_MASK | JS_GPN_ENUM_ONLY) < 0) {
+    return -1;
+  }
+  // Index keys come first, in ascending order
+  uint32_t dense = 0;
+  while (dense < count && dense < length) {
+    JSAtom atom = JS_NewAtomUInt32(ctx, dense);
+    bool is_index = atom == props[dense].atom;
+    JS_FreeAtom(ctx, atom);
+    if (!is_index) {
+      break;
+    }
+    dense++;
+  }
+
+  int ret = v8_assign_id(w, array);
+  if (ret == 0 && dense == length) {
+    ret = v8_write_tag_varint(w, V8_TAG_BEGIN_DENSE_ARRAY, length);
+    for (uint32_t i = 0; ret == 0 && i < length; i++) {
+      JSValue element = JS_GetPropertyUint32(ctx, array, i);
+      ret = JS_IsException(element) ? -1 : v8_write_value(w, element);
+      JS_FreeValue(ctx, element);
+    }
+    if (ret == 0 && v8_write_properties(w, array, props, dense, count) == 0 &&
+        v8_write_tag_varint(w, V8_TAG_END_DENSE_ARRAY, count - dense) == 0) {
+      ret = v8_write_varint(w, length);
+    } else {
+      ret = -1;
+    }
+  } else if (ret == 0) {
+    if (v8_write_tag_varint(w, V8_TAG_BEGIN_SPARSE_ARRAY, length) == 0 &&
+        v8_write_properties(w, array, props, 0, count) == 0 &&
+        v8_write_tag_varint(w, V8_TAG_END_SPARSE_ARRAY, count) == 0) {
+      ret = v8_write_varint(w, length);
+    } else {
+      ret = -1;
+    }
+  }
+  JS_FreePropertyEnum(ctx, props, count);
+  return ret;
+}
+
+static int v8_write_collection(V8Writer* w, JSValueConst collection, bool is_map) {
+  JSContext* ctx = w->ctx;
+  if (v8_assign_id(w, collection) < 0 || v8_write_byte(w, is_map ? V8_TAG_BEGIN_MAP : V8_TAG_BEGIN_SET) < 0) {
+    return -1;
+  }
+
+  // Snapshot the entries first, as structuredClone() does
+  JSValueConst array_ctor = JSRT_CloneTypesCtor(&w->types, JSRT_CLONE_KIND_ARRAY);
+  if (JS_IsUndefined(w->array_from)) {
+    w->array_from = JS_GetPropertyStr(ctx, array_ctor, "from");
+  }
+  JSValue items = JS_Call(ctx, w->array_from, array_ctor, 1, &collection);
+  JSValue length_val = JS_IsException(items) ? JS_EXCEPTION : JS_GetPropertyStr(ctx, items, "length");
+  uint32_t length = 0;
+  int ret = JS_IsException(length_val) || JS_ToUint32(ctx, &length, length_val) ? -1 : 0;
+  JS_FreeValue(ctx, length_val);
+
+  for (uint32_t i = 0; ret == 0 && i < length; i++) {
+    JSValue item = JS_GetPropertyUint32(ctx, items, i);
+    if (is_map) {
+      JSValue key = JS_GetPropertyUint32(ctx, item, 0);
+      JSValue value = JS_GetPropertyUint32(ctx, item, 1);
+      ret = v8_write_value(w, key) < 0 ? -1 : v8_write_value(w, value);
+      JS_FreeValue(ctx, key);
+      JS_FreeValue(ctx, value);
+    } else {
+      ret = v8_write_value(w, item);
+    }
+    JS_FreeValue(ctx, item);
+  }
+  JS_FreeValue(ctx, items);
+  if (ret < 0) {
+    return -1;
+  }
+  return v8_write_tag_varint(w, is_map ? V8_TAG_END_MAP : V8_TAG_END_SET, is_map ? (uint64_t)length * 2 : length);
+}
+
+static int v8_write_array_buffer(V8Writer* w, JSValueConst buffer) {
+  JSContext* ctx = w->ctx;
+  JSValue transfer_id = JSRT_CloneMapGet(&w->transfers, buffer);
+  if (v8_assign_id(w, buffer) < 0) {
+    return -1;
+  }
+  if (!JS_IsUninitialized(transfer_id)) {
+    return v8_write_tag_varint(w, V8_TAG_ARRAY_BUFFER_TRANSFER, (uint32_t)JS_VALUE_GET_INT(transfer_id));
+  }
+
+  size_t size;
+  uint8_t* data = JS_GetArrayBuffer(ctx, &size, buffer);
+  if (!data && JS_HasException(ctx)) {
+    // Detached
+    JS_FreeValue(ctx, JS_GetException(ctx));
+    return v8_throw_clone_error(w, "An ArrayBuffer is detached and could not be cloned.");
+  }
+  return v8_write_tag_varint(w, V8_TAG_ARRAY_BUFFER, size) < 0 ? -1 : v8_write_bytes(w, data, size);
+}
+
+// True if view was made by the Buffer constructor, which Node's host objects keep apart from Uint8Array
+static bool v8_is_buffer(JSContext* ctx, JSValueConst view) {
+  JSValue global = JS_GetGlobalObject(ctx);
+  JSValue buffer_ctor = JS_GetPropertyStr(ctx, global, "Buffer");
+  JSValue ctor = JS_GetPropertyStr(ctx, view, "constructor");
+  bool is_buffer =
+      JS_IsObject(ctor) && JS_IsObject(buffer_ctor) && JS_VALUE_GET_PTR(ctor) == JS_VALUE_GET_PTR(buffer_ctor);
+  if (JS_IsException(ctor) || JS_IsException(buffer_ctor)) {
+    JS_FreeValue(ctx, JS_GetException(ctx));
+  }
+  JS_FreeValue(ctx, ctor);
+  JS_FreeValue(ctx, buffer_ctor);
+  JS_FreeValue(ctx, global);
+  return is_buffer;
+}
+
+// Node's DefaultSerializer._writeHostObject(): type index, byte length, then just the viewed bytes
+static int v8_write_default_host_object(V8Writer* w, JSValueConst view, JSRT_CloneKind kind) {
+  JSContext* ctx = w->ctx;
+  int index = -1;
+  if (kind == JSRT_CLONE_KIND_DATA_VIEW) {
+    index = V8_HOST_DATA_VIEW;
+  } else if (kind == JSRT_CLONE_KIND_TYPED_ARRAY) {
+    int type = JS_GetTypedArrayType(view);
+    for (int i = 0; i < (int)countof(v8_host_view_types); i++) {
+      if (v8_host_view_types[i] == type) {
+        index = i;
+      }
+    }
+    if (type == JS_TYPED_ARRAY_UINT8 && v8_is_buffer(ctx, view)) {
+      index = V8_HOST_BUFFER;
+    }
+  }
+  if (index < 0) {
+    char message[96];
+    snprintf(message, sizeof(message), "Unserializable host object: %s", JSRT_CloneKindName(kind));
+    return v8_throw_clone_error(w, message);
+  }
+
+  size_t size = 0;
+  uint8_t* bytes = jsrt_node_buffer_bytes(ctx, view, &size);
+  if (!bytes) {
+    if (JS_HasException(ctx)) {
+      return -1;
+    }
+    size = 0;
+  }
+  if (v8_write_varint(w, (uint32_t)index) < 0 || v8_write_varint(w, size) < 0) {
+    return -1;
+  }
+  return v8_write_bytes(w, bytes, size);
+}
+
+static int v8_write_host_object(V8Writer* w, JSValueConst obj, JSRT_CloneKind kind) {
+  JSContext* ctx = w->ctx;
+  if (v8_assign_id(w, obj) < 0 || v8_write_byte(w, V8_TAG_HOST_OBJECT) < 0) {
+    return -1;
+  }
+  if (!JS_IsObject(w->delegate)) {
+    return v8_write_default_host_object(w, obj, kind);
+  }
+
+  // Serializer subclasses write host objects themselves
+  JSValue method = JS_GetPropertyStr(ctx, w->delegate, "_writeHostObject");
+  if (!JS_IsFunction(ctx, method)) {
+    JS_FreeValue(ctx, method);
+    char message[96];
+    snprintf(message, sizeof(message), "Unserializable host object: %s", JSRT_CloneKindName(kind));
+    return v8_throw_clone_error(w, message);
+  }
+  JSValue ret = JS_Call(ctx, method, w->delegate, 1, &obj);
+  JS_FreeValue(ctx, method);
+  if (JS_IsException(ret)) {
+    return -1;
+  }
+  JS_FreeValue(ctx, ret);
+  return 0;
+}
+
+// The viewed ArrayBuffer (or a reference to it) goes first, then the view
+static int v8_write_view(V8Writer* w, JSValueConst view, JSRT_CloneKind kind) {
+  JSContext* ctx = w->ctx;
+  if (w->host_views) {
+    return v8_write_host_object(w, view, kind);
+  }
+
+  JSValue buffer;
+  size_t offset = 0, length = 0;
+  uint8_t subtag = V8_VIEW_TAG_DATA_VIEW;
+  if (kind == JSRT_CLONE_KIND_TYPED_ARRAY) {
+    subtag = v8_view_tags[JS_GetTypedArrayType(view)];
+    buffer = JS_GetTypedArrayBuffer(ctx, view, &offset, &length, NULL);
+  } else {
+    buffer = JS_GetPropertyStr(ctx, view, "buffer");
+    JSValue offset_val = JS_GetPropertyStr(ctx, view, "byteOffset");
+    JSValue length_val = JS_GetPropertyStr(ctx, view, "byteLength");
+    uint64_t offset64 = 0, length64 = 0;
+    if (JS_ToIndex(ctx, &offset64, offset_val) || JS_ToIndex(ctx, &length64, length_val)) {
+      JS_FreeValue(ctx, buffer);
+      buffer = JS_EXCEPTION;
+    }
+    JS_FreeValue(ctx, offset_val);
+    JS_FreeValue(ctx, length_val);
+    offset = (size_t)offset64;
+    length = (size_t)length64;
+  }
+  if (JS_IsException(buffer)) {
+    return -1;
+  }
+  int ret = v8_write_value(w, buffer);
+  JS_FreeValue(ctx, buffer);
+  if (ret < 0 || v8_assign_id(w, view) < 0 || v8_write_byte(w, V8_TAG_ARRAY_BUFFER_VIEW) < 0 ||
+      v8_write_byte(w, subtag) < 0 || v8_write_varint(w, offset) < 0 || v8_write_varint(w, length) < 0) {
+    return -1;
+  }
+  // Flags: not length-tracking, not backed by a resizable buffer
+  return v8_write_varint(w, 0);
+}
+
+// Own property name of obj: 1 with *value set if present, 0 if not, -1 on exception
+static int v8_get_own_property(JSContext* ctx, JSValueConst obj, const char* name, JSValue* value) {
+  JSAtom atom = JS_NewAtom(ctx, name);
+  JSPropertyDescriptor desc;
+  int ret = JS_GetOwnProperty(ctx, &desc, obj, atom);
+  if (ret > 0) {
+    *value = (desc.flags & JS_PROP_GETSET) ? JS_GetProperty(ctx, obj, atom) : JS_DupValue(ctx, desc.value);
+    JS_FreeValue(ctx, desc.value);
+    JS_FreeValue(ctx, desc.getter);
+    JS_FreeValue(ctx, desc.setter);
+    if (JS_IsException(*value)) {
+      ret = -1;
+    }
+  }
+  JS_FreeAtom(ctx, atom);
+  return ret;
+}
+
+static int v8_write_error(V8Writer* w, JSValueConst error) {
+  JSContext* ctx = w->ctx;
+  if (v8_assign_id(w, error) < 0 || v8_write_byte(w, V8_TAG_ERROR) < 0) {
+    return -1;
+  }
+  const char* name = JSRT_CloneErrorName(ctx, error);
+  for (size_t i = 0; i < countof(v8_error_types); i++) {
+    if (strcmp(name, v8_error_types[i].name) == 0 && v8_write_byte(w, v8_error_types[i].tag) < 0) {
+      return -1;
+    }
+  }
+
+  JSValue value;
+  int has = v8_get_own_property(ctx, error, "message", &value);
+  if (has > 0) {
+    JSValue message = JS_ToString(ctx, value);
+    JS_FreeValue(ctx, value);
+    has = JS_IsException(message) || v8_write_byte(w, V8_ERROR_MESSAGE) < 0 ? -1 : v8_write_string(w, message);
+    JS_FreeValue(ctx, message);
+  }
+  if (has < 0) {
+    return -1;
+  }
+
+  has = v8_get_own_property(ctx, error, "cause", &value);
+  if (has > 0) {
+    has = v8_write_byte(w, V8_ERROR_CAUSE) < 0 ? -1 : v8_write_value(w, value);
+    JS_FreeValue(ctx, value);
+  }
+  if (has < 0) {
+    return -1;
+  }
+
+  JSValue stack = JS_GetPropertyStr(ctx, error, "stack");
+  if (JS_IsException(stack)) {
+    return -1;
+  }
+  int ret = 0;
+  if (JS_IsString(stack)) {
+    ret = v8_write_byte(w, V8_ERROR_STACK) < 0 ? -1 : v8_write_string(w, stack);
+  }
+  JS_FreeValue(ctx, stack);
+  return ret < 0 ? -1 : v8_write_byte(w, V8_ERROR_END);
+}
+
+// Date, RegExp and the primitive wrappers
+static int v8_write_wrapper(V8Writer* w, JSValueConst obj, JSRT_CloneKind kind) {
+  JSContext* ctx = w->ctx;
+  if (v8_assign_id(w, obj) < 0) {
+    return -1;
+  }
+
+  if (kind == JSRT_CLONE_KIND_REGEXP) {
+    JSValue source = JS_GetPropertyStr(ctx, obj, "source");
+    JSValue flags_val = JS_GetPropertyStr(ctx, obj, "flags");
+    const char* flags = JS_IsException(flags_val) ? NULL : JS_ToCString(ctx, flags_val);
+    int ret = -1;
+    if (flags && !JS_IsException(source) && v8_write_byte(w, V8_TAG_REGEXP) == 0 && v8_write_string(w, source) == 0) {
+      uint32_t bits = 0;
+      for (const char* f = flags; *f; f++) {
+        for (size_t i = 0; i < countof(v8_regexp_flags); i++) {
+          bits |= v8_regexp_flags[i].flag == *f ? v8_regexp_flags[i].bit : 0;
+        }
+      }
+      ret = v8_write_varint(w, bits);
+    }
+    JS_FreeCString(ctx, flags);
+    JS_FreeValue(ctx, flags_val);
+    JS_FreeValue(ctx, source);
+    return ret;
+  }
+
+  JSAtom method = JS_NewAtom(ctx, kind == JSRT_CLONE_KIND_DATE ? "getTime" : "valueOf");
+  JSValue inner = JS_Invoke(ctx, obj, method, 0, NULL);
+  JS_FreeAtom(ctx, method);
+  if (JS_IsException(inner)) {
+    return -1;
+  }
+
+  int ret;
+  double d;
+  switch (kind) {
+    case JSRT_CLONE_KIND_BOOLEAN:
+      ret = v8_write_byte(w, JS_ToBool(ctx, inner) ? V8_TAG_TRUE_OBJECT : V8_TAG_FALSE_OBJECT);
+      break;
+    case JSRT_CLONE_KIND_STRING:
+      ret = v8_write_byte(w, V8_TAG_STRING_OBJECT) < 0 ? -1 : v8_write_string(w, inner);
+      break;
+    case JSRT_CLONE_KIND_BIGINT:
+      ret = v8_write_byte(w, V8_TAG_BIGINT_OBJECT) < 0 ? -1 : v8_write_bigint_digits(w, inner);
+      break;
+    default: {
+      uint8_t tag = kind == JSRT_CLONE_KIND_DATE ? V8_TAG_DATE : V8_TAG_NUMBER_OBJECT;
+      ret = JS_ToFloat64(ctx, &d, inner) || v8_write_byte(w, tag) < 0 ? -1 : v8_write_double(w, d);
+      break;
+    }
+  }
+  JS_FreeValue(ctx, inner);
+  return ret;
+}
+
+static int v8_write_object(V8Writer* w, JSValueConst obj) {
+  JSValue id = JSRT_CloneMapGet(&w->objects, obj);
+  if (!JS_IsUninitialized(id)) {
+    // Written before: shared references and cycles point back to it
+    return v8_write_tag_varint(w, V8_TAG_OBJECT_REFERENCE, (uint32_t)JS_VALUE_GET_INT(id));
+  }
+  if (w->depth >= V8_MAX_DEPTH) {
+    JS_ThrowRangeError(w->ctx, "Maximum call stack size exceeded");
+    return -1;
+  }
+
+  JSRT_CloneKind kind;
+  if (JSRT_CloneClassify(&w->types, obj, &kind) < 0) {
+    return -1;
+  }
+
+  char message[96];
+  int ret;
+  w->depth++;
+  switch (kind) {
+    case JSRT_CLONE_KIND_ARRAY:
+      ret = v8_write_array(w, obj);
+      break;
+    case JSRT_CLONE_KIND_TYPED_ARRAY:
+    case JSRT_CLONE_KIND_DATA_VIEW:
+      ret = v8_write_view(w, obj, kind);
+      break;
+    case JSRT_CLONE_KIND_ERROR:
+      ret = v8_write_error(w, obj);
+      break;
+    case JSRT_CLONE_KIND_MAP:
+    case JSRT_CLONE_KIND_SET:
+      ret = v8_write_collection(w, obj, kind == JSRT_CLONE_KIND_MAP);
+      break;
+    case JSRT_CLONE_KIND_ARRAY_BUFFER:
+      ret = v8_write_array_buffer(w, obj);
+      break;
+    case JSRT_CLONE_KIND_DATE:
+    case JSRT_CLONE_KIND_REGEXP:
+    case JSRT_CLONE_KIND_BOOLEAN:
+    case JSRT_CLONE_KIND_NUMBER:
+    case JSRT_CLONE_KIND_STRING:
+    case JSRT_CLONE_KIND_BIGINT:
+      ret = v8_write_wrapper(w, obj, kind);
+      break;
+    case JSRT_CLONE_KIND_BLOB:
+      ret = v8_write_host_object(w, obj, kind);
+      break;
+    case JSRT_CLONE_KIND_FUNCTION:
+      ret = v8_throw_clone_error(w, "function could not be cloned.");
+      break;
+    case JSRT_CLONE_KIND_SHARED_ARRAY_BUFFER:
+    case JSRT_CLONE_KIND_PROMISE:
+    case JSRT_CLONE_KIND_WEAK_MAP:
+    case JSRT_CLONE_KIND_WEAK_SET:
+      snprintf(message, sizeof(message), "#<%s> could not be cloned.", JSRT_CloneKindName(kind));
+      ret = v8_throw_clone_error(w, message);
+      break;
+    default:
+      ret = v8_write_plain_object(w, obj);
+      break;
+  }
+  w->depth--;
+  return ret;
+}
+
+static int v8_write_value(V8Writer* w, JSValueConst value) {
+  if (JS_IsObject(value)) {
+    return v8_write_object(w, value);
+  }
+  if (JS_IsNumber(value)) {
+    return v8_write_number(w, value);
+  }
+  if (JS_IsString(value)) {
+    return v8_write_string(w, value);
+  }
+  if (JS_IsBool(value)) {
+    return v8_write_byte(w, JS_VALUE_GET_BOOL(value) ? V8_TAG_TRUE : V8_TAG_FALSE);
+  }
+  if (JS_IsUndefined(value)) {
+    return v8_write_byte(w, V8_TAG_UNDEFINED);
+  }
+  if (JS_IsNull(value)) {
+    return v8_write_byte(w, V8_TAG_NULL);
+  }
+  if (JS_IsBigInt(w->ctx, value)) {
+    return v8_write_byte(w, V8_TAG_BIGINT) < 0 ? -1 : v8_write_bigint_digits(w, value);
+  }
+  return v8_throw_clone_error(w, "Symbol could not be cloned.");
+}
+
+// One writeValue(); delegate is the Serializer object when called through the class
+static int v8_write_top(V8Writer* w, JSValueConst value, JSValueConst delegate) {
+  if (w->busy) {
+    JS_ThrowTypeError(w->ctx, "Serializer is already writing a value");
+    return -1;
+  }
+  w->busy = true;
+  w->delegate = delegate;
+  w->depth = 0;
+  JSRT_CloneTypesInit(w->ctx, &w->types);
+  int ret = v8_write_value(w, value);
+  JSRT_CloneTypesFree(&w->types);
+  JS_FreeValue(w->ctx, w->array_from);
+  w->array_from = JS_UNDEFINED;
+  w->delegate = JS_UNDEFINED;
+  w->busy = false;
+  return ret;
+}
+
+uint8_t* jsrt_v8_serialize(JSContext* ctx, JSValueConst value, size_t* size) {
+  V8Writer w;
+  v8_writer_init(ctx, &w, true);
+  uint8_t* data = NULL;
+  if (v8_write_header(&w) == 0 && v8_write_top(&w, value, JS_UNDEFINED) == 0) {
+    data = w.data;
+    *size = w.size;
+    w.data = NULL;
+  }
+  v8_writer_free_rt(JS_GetRuntime(ctx), &w);
+  return data;
+}
+
+// ============================================================================
+// Deserializer
+// ============================================================================
+
+typedef struct {
+  JSContext* ctx;
+  const uint8_t* data;
+  size_t size;
+  size_t pos;
+  uint8_t* owned_data;  // Copy of the input made by the Deserializer constructor
+  uint32_t version;
+  JSValue* objects;  // By id; undefined while the object is still being read
+  uint32_t object_count;
+  uint32_t object_capacity;
+  JSValue* transfers;  // ArrayBuffers passed to transferArrayBuffer(), by transfer id
+  uint32_t transfer_count;
+  bool busy;  // Inside readValue()
+  // Set up for the duration of one readValue()
+  JSRT_CloneTypes types;
+  JSValueConst delegate;  // Deserializer object with _readHostObject(), or undefined
+  int depth;
+} V8Reader;
+
+static void v8_reader_init(JSContext* ctx, V8Reader* r, const uint8_t* data, size_t size) {
+  memset(r, 0, sizeof(*r));
+  r->ctx = ctx;
+  r->data = data;
+  r->size = size;
+  r->delegate = JS_UNDEFINED;
+}
+
+static void v8_reader_free_rt(JSRuntime* rt, V8Reader* r) {
+  for (uint32_t i = 0; i < r->object_count; i++) {
+    JS_FreeValueRT(rt, r->objects[i]);
+  }
+  for (uint32_t i = 0; i < r->transfer_count; i++) {
+    JS_FreeValueRT(rt, r->transfers[i]);
+  }
+  js_free_rt(rt, r->objects);
+  js_free_rt(rt, r->transfers);
+  js_free_rt(rt, r->owned_data);
+}
+
+static JSValue v8_throw_read_error(JSContext* ctx) {
+  JSValue error = JS_NewError(ctx);
+  JS_SetPropertyStr(ctx, error, "message", JS_NewString(ctx, "Unable to deserialize cloned data."));
+  return JS_Throw(ctx, error);
+}
+
+static bool v8_read_byte(V8Reader* r, uint8_t* byte) {
+  if (r->pos >= r->size) {
+    return false;
+  }
+  *byte = r->data[r->pos++];
+  return true;
+}
+
+static bool v8_read_varint(V8Reader* r, uint64_t* value) {
+  uint64_t result = 0;
+  for (int shift = 0; shift < 64 && r->pos < r->size; shift += 7) {
+    uint8_t byte = r->data[r->pos++];
+    result |= (uint64_t)(byte & 0x7f) << shift;
+    if (!(byte & 0x80)) {
+      *value = result;
+      return true;
+    }
+  }
+  return false;
+}
+
+static bool v8_read_varint32(V8Reader* r, uint32_t* value) {
+  uint64_t v;
+  if (!v8_read_varint(r, &v) || v > UINT32_MAX) {
+    return false;
+  }
+  *value = (uint32_t)v;
+  return true;
+}
+
+static bool v8_read_double(V8Reader* r, double* value) {
+  if (r->size - r->pos < sizeof(*value)) {
+    return false;
+  }
+  memcpy(value, r->data + r->pos, sizeof(*value));
+  r->pos += sizeof(*value);
+  return true;
+}
+
+static bool v8_read_raw(V8Reader* r, size_t n, const uint8_t** bytes) {
+  if (r->size - r->pos < n) {
+    return false;
+  }
+  *bytes = r->data + r->pos;
+  r->pos += n;
+  return true;
+}
+
+// Next tag, skipping padding
+static bool v8_read_tag(V8Reader* r, uint8_t* tag) {
+  do {
+    if (!v8_read_byte(r, tag)) {
+      return false;
+    }
+  } while (*tag == V8_TAG_PADDING);
+  return true;
+}
+
+static bool v8_peek_tag(V8Reader* r, uint8_t* tag) {
+  size_t pos = r->pos;
+  bool ok = v8_read_tag(r, tag);
+  r->pos = pos;
+  return ok;
+}
+
+static int v8_read_header(V8Reader* r) {
+  if (r->pos < r->size && r->data[r->pos] == V8_TAG_VERSION) {
+    r->pos++;
+    if (!v8_read_varint32(r, &r->version) || r->version > V8_WIRE_FORMAT_VERSION) {
+      const char* message = "Unable to deserialize cloned data due to invalid or unsupported version.";
+      JSValue error = JS_NewError(r->ctx);
+      JS_SetPropertyStr(r->ctx, error, "message", JS_NewString(r->ctx, message));
+      JS_Throw(r->ctx, error);
+      return -1;
+    }
+  }
+  return 0;
+}
+
+// Next object id, handed out in the order the writer reached the objects
+static int v8_reserve_id(V8Reader* r, uint32_t* id) {
+  if (r->object_count == r->object_capacity) {
+    uint32_t capacity = r->object_capacity ? r->object_capacity * 2 : 16;
+    JSValue* objects = js_realloc(r->ctx, r->objects, sizeof(JSValue) * capacity);
+    if (!objects) {
+      return -1;
+    }
+    r->objects = objects;
+    r->object_capacity = capacity;
+  }
+  r->objects[r->object_count] = JS_UNDEFINED;
+  *id = r->object_count++;
+  return 0;
+}
+
+static void v8_set_object(V8Reader* r, uint32_t id, JSValueConst obj) {
+  JS_FreeValue(r->ctx, r->objects[id]);
+  r->objects[id] = JS_DupValue(r->ctx, obj);
+}
+
+// Body of a string whose tag has been read
+static JSValue v8_read_string_body(V8Reader* r, uint8_t tag) {
+  JSContext* ctx = r->ctx;
+  uint32_t byte_length;
+  const uint8_t* bytes;
+  if (!v8_read_varint32(r, &byte_length) || !v8_read_raw(r, byte_length, &bytes)) {
+    return v8_throw_read_error(ctx);
+  }
+  if (tag == V8_TAG_UTF8_STRING || JSRT_ASCIIPrefix(bytes, byte_length) == byte_length) {
+    return JS_NewStringLen(ctx, (const char*)bytes, byte_length);
+  }
+  if (tag == V8_TAG_TWO_BYTE_STRING && byte_length % 2) {
+    return v8_throw_read_error(ctx);
+  }
+
+  // Latin-1 takes up to 2 bytes per character in UTF-8, UTF-16 up to 3 per code unit
+  size_t utf8_capacity = tag == V8_TAG_ONE_BYTE_STRING ? (size_t)byte_length * 2 : (size_t)byte_length / 2 * 3;
+  uint8_t* utf8 = js_malloc(ctx, utf8_capacity + 1);
+  if (!utf8) {
+    return JS_EXCEPTION;
+  }
+  size_t utf8_len = tag == V8_TAG_ONE_BYTE_STRING ? JSRT_Latin1ToUTF8(bytes, byte_length, utf8)
+                                                  : JSRT_UTF16ToUTF8(bytes, byte_length / 2, false, utf8);
+  JSValue str = JS_NewStringLen(ctx, (const char*)utf8, utf8_len);
+  js_free(ctx, utf8);
+  return str;
+}
+
+static JSValue v8_read_string(V8Reader* r) {
+  uint8_t tag;
+  if (!v8_read_tag(r, &tag) ||
+      (tag != V8_TAG_ONE_BYTE_STRING && tag != V8_TAG_TWO_BYTE_STRING && tag != V8_TAG_UTF8_STRING)) {
+    return v8_throw_read_error(r->ctx);
+  }
+  return v8_read_string_body(r, tag);
+}
+
+// Bit field and digits written by v8_write_bigint_digits()
+static JSValue v8_read_bigint(V8Reader* r) {
+  JSContext* ctx = r->ctx;
+  uint32_t bitfield;
+  const uint8_t* digits;
+  if (!v8_read_varint32(r, &bitfield) || !v8_read_raw(r, bitfield >> 1, &digits)) {
+    return v8_throw_read_error(ctx);
+  }
+  bool negative = bitfield & 1;
+  size_t byte_length = bitfield >> 1;
+  size_t top = byte_length;
+  while (top > 0 && digits[top - 1] == 0) {
+    top--;
+  }
+
+  if (top <= 8) {
+    uint64_t magnitude = 0;
+    for (size_t i = top; i-- > 0;) {
+      magnitude = magnitude << 8 | digits[i];
+    }
+    if (magnitude <= INT64_MAX) {
+      return JS_NewBigInt64(ctx, negative ? -(int64_t)magnitude : (int64_t)magnitude);
+    }
+  }
+
+  // Larger values go through BigInt("0x..."); a negative one is parsed as its two's complement one byte wider
+  // and narrowed with BigInt.asIntN()
+  char* hex = js_malloc(ctx, top * 2 + 5);
+  if (!hex) {
+    return JS_EXCEPTION;
+  }
+  size_t width = negative ? top + 1 : top;
+  size_t len = 0;
+  hex[len++] = '0';
+  hex[len++] = 'x';
+  unsigned carry = 1;
+  uint8_t* twos = js_malloc(ctx, width);
+  if (!twos) {
+    js_free(ctx, hex);
+    return JS_EXCEPTION;
+  }
+  for (size_t i = 0; i < width; i++) {
+    uint8_t byte = i < top ? digits[i] : 0;
+    if (negative) {
+      unsigned sum = (uint8_t)~byte + carry;
+      byte = (uint8_t)sum;
+      carry = sum >> 8;
+    }
+    twos[i] = byte;
+  }
+  static const char hex_chars[] = "0123456789abcdef";
+  for (size_t i = width; i-- > 0;) {
+    hex[len++] = hex_chars[twos[i] >> 4];
+    hex[len++] = hex_chars[twos[i] & 0xf];
+  }
+  js_free(ctx, twos);
+
+  JSValueConst bigint_ctor = JSRT_CloneTypesCtor(&r->types, JSRT_CLONE_KIND_BIGINT);
+  JSValue str = JS_NewStringLen(ctx, hex, len);
+  js_free(ctx, hex);
+  JSValue value = JS_Call(ctx, bigint_ctor, JS_UNDEFINED, 1, &str);
+  JS_FreeValue(ctx, str);
+  if (negative && !JS_IsException(value)) {
+    JSValue as_int_n = JS_GetPropertyStr(ctx, bigint_ctor, "asIntN");
+    JSValue args[2] = {JS_NewInt64(ctx, (int64_t)width * 8), value};
+    value = JS_Call(ctx, as_int_n, bigint_ctor, 2, args);
+    JS_FreeValue(ctx, args[1]);
+    JS_FreeValue(ctx, as_int_n);
+  }
+  return value;
+}
+
+static JSValue v8_read_value(V8Reader* r);
+
+// Key/value pairs up to end_tag; returns how many were read, or -1
+static int64_t v8_read_properties(V8Reader* r, JSValueConst obj, uint8_t end_tag) {
+  JSContext* ctx = r->ctx;
+  int64_t count = 0;
+  for (;;) {
+    uint8_t tag;
+    if (!v8_peek_tag(r, &tag)) {
+      v8_throw_read_error(ctx);
+      return -1;
+    }
+    if (tag == end_tag) {
+      v8_read_tag(r, &tag);
+      return count;
+    }
+
+    JSValue key = v8_read_value(r);
+    if (JS_IsException(key)) {
+      return -1;
+    }
+    if (!JS_IsString(key) && !JS_IsNumber(key)) {
+      JS_FreeValue(ctx, key);
+      v8_throw_read_error(ctx);
+      return -1;
+    }
+    JSAtom atom = JS_ValueToAtom(ctx, key);
+    JS_FreeValue(ctx, key);
+    if (atom == JS_ATOM_NULL) {
+      return -1;
+    }
+    JSValue value = v8_read_value(r);
+    int ret = JS_IsException(value) ? -1 : JS_DefinePropertyValue(ctx, obj, atom, value, JS_PROP_C_W_E);
+    JS_FreeAtom(ctx, atom);
+    if (ret < 0) {
+      return -1;
+    }
+    count++;
+  }
+}
+
+// Property count after an end tag, checked against what was read
+static bool v8_read_count(V8Reader* r, int64_t expected) {
+  uint32_t count;
+  return expected >= 0 && v8_read_varint32(r, &count) && count == expected;
+}
+
+static JSValue v8_read_object(V8Reader* r) {
+  JSContext* ctx = r->ctx;
+  uint32_t id;
+  if (v8_reserve_id(r, &id) < 0) {
+    return JS_EXCEPTION;
+  }
+  JSValue obj = JS_NewObject(ctx);
+  if (JS_IsException(obj)) {
+    return obj;
+  }
+  v8_set_object(r, id, obj);
+  int64_t count = v8_read_properties(r, obj, V8_TAG_END_OBJECT);
+  if (!v8_read_count(r, count)) {
+    JS_FreeValue(ctx, obj);
+    return count < 0 ? JS_EXCEPTION : v8_throw_read_error(ctx);
+  }
+  return obj;
+}
+
+static JSValue v8_read_array(V8Reader* r, bool dense) {
+  JSContext* ctx = r->ctx;
+  uint32_t length, id;
+  // Every dense element takes at least one byte
+  if (!v8_read_varint32(r, &length) || (dense && length > r->size - r->pos)) {
+    return v8_throw_read_error(ctx);
+  }
+  if (v8_reserve_id(r, &id) < 0) {
+    return JS_EXCEPTION;
+  }
+  JSValue array = JS_NewArray(ctx);
+  if (JS_IsException(array)) {
+    return array;
+  }
+  v8_set_object(r, id, array);
+
+  for (uint32_t i = 0; dense && i < length; i++) {
+    uint8_t tag;
+    if (v8_peek_tag(r, &tag) && tag == V8_TAG_THE_HOLE) {
+      v8_read_tag(r, &tag);
+      continue;
+    }
+    JSValue element = v8_read_value(r);
+    if (JS_IsException(element) || JS_DefinePropertyValueUint32(ctx, array, i, element, JS_PROP_C_W_E) < 0) {
+      JS_FreeValue(ctx, array);
+      return JS_EXCEPTION;
+    }
+  }
+  if (JS_SetPropertyStr(ctx, array, "length", JS_NewUint32(ctx, length)) < 0) {
+    JS_FreeValue(ctx, array);
+    return JS_EXCEPTION;
+  }
+
+  int64_t count = v8_read_properties(r, array, dense ? V8_TAG_END_DENSE_ARRAY : V8_TAG_END_SPARSE_ARRAY);
+  uint32_t end_length;
+  if (!v8_read_count(r, count) || !v8_read_varint32(r, &end_length)) {
+    JS_FreeValue(ctx, array);
+    return count < 0 ? JS_EXCEPTION : v8_throw_read_error(ctx);
+  }
+  return array;
+}
+
+static JSValue v8_read_collection(V8Reader* r, bool is_map) {
+  JSContext* ctx = r->ctx;
+  uint32_t id;
+  if (v8_reserve_id(r, &id) < 0) {
+    return JS_EXCEPTION;
+  }
+  JSValueConst ctor = JSRT_CloneTypesCtor(&r->types, is_map ? JSRT_CLONE_KIND_MAP : JSRT_CLONE_KIND_SET);
+  JSValue collection = JS_CallConstructor(ctx, ctor, 0, NULL);
+  if (JS_IsException(collection)) {
+    return collection;
+  }
+  v8_set_object(r, id, collection);
+
+  JSValue adder = JS_GetPropertyStr(ctx, collection, is_map ? "set" : "add");
+  uint8_t end_tag = is_map ? V8_TAG_END_MAP : V8_TAG_END_SET;
+  int64_t count = JS_IsException(adder) ? -1 : 0;
+  while (count >= 0) {
+    uint8_t tag;
+    if (!v8_peek_tag(r, &tag)) {
+      v8_throw_read_error(ctx);
+      count = -1;
+      break;
+    }
+    if (tag == end_tag) {
+      v8_read_tag(r, &tag);
+      break;
+    }
+    JSValue args[2] = {v8_read_value(r), JS_UNDEFINED};
+    if (is_map && !JS_IsException(args[0])) {
+      args[1] = v8_read_value(r);
+    }
+    if (JS_IsException(args[0]) || JS_IsException(args[1])) {
+      count = -1;
+    } else {
+      JSValue ret = JS_Call(ctx, adder, collection, is_map ? 2 : 1, args);
+      count = JS_IsException(ret) ? -1 : count + (is_map ? 2 : 1);
+      JS_FreeValue(ctx, ret);
+    }
+    JS_FreeValue(ctx, args[0]);
+    JS_FreeValue(ctx, args[1]);
+  }
+  JS_FreeValue(ctx, adder);
+
+  if (!v8_read_count(r, count)) {
+    JS_FreeValue(ctx, collection);
+    return count < 0 ? JS_EXCEPTION : v8_throw_read_error(ctx);
+  }
+  return collection;
+}
+
+// Date, RegExp and the primitive wrappers
+static JSValue v8_read_wrapper(V8Reader* r, uint8_t tag) {
+  JSContext* ctx = r->ctx;
+  uint32_t id;
+  if (v8_reserve_id(r, &id) < 0) {
+    return JS_EXCEPTION;
+  }
+
+  JSValue value = JS_EXCEPTION;
+  JSValue args[2] = {JS_UNDEFINED, JS_UNDEFINED};
+  double d;
+  switch (tag) {
+    case V8_TAG_DATE:
+      value = v8_read_double(r, &d) ? JS_NewDate(ctx, d) : v8_throw_read_error(ctx);
+      break;
+    case V8_TAG_TRUE_OBJECT:
+    case V8_TAG_FALSE_OBJECT:
+      args[0] = JS_NewBool(ctx, tag == V8_TAG_TRUE_OBJECT);
+      value = JS_CallConstructor(ctx, JSRT_CloneTypesCtor(&r->types, JSRT_CLONE_KIND_BOOLEAN), 1, args);
+      break;
+    case V8_TAG_NUMBER_OBJECT:
+      if (!v8_read_double(r, &d)) {
+        value = v8_throw_read_error(ctx);
+        break;
+      }
+      args[0] = JS_NewFloat64(ctx, d);
+      value = JS_CallConstructor(ctx, JSRT_CloneTypesCtor(&r->types, JSRT_CLONE_KIND_NUMBER), 1, args);
+      break;
+    case V8_TAG_BIGINT_OBJECT:
+      args[0] = v8_read_bigint(r);
+      if (!JS_IsException(args[0])) {
+        // new BigInt() throws; Object(bigint) makes the wrapper
+        JSValueConst object_ctor = JSRT_CloneTypesCtor(&r->types, JSRT_CLONE_KIND_OBJECT);
+        value = JS_Call(ctx, object_ctor, JS_UNDEFINED, 1, args);
+      }
+      break;
+    case V8_TAG_STRING_OBJECT:
+      args[0] = v8_read_string(r);
+      if (!JS_IsException(args[0])) {
+        value = JS_CallConstructor(ctx, JSRT_CloneTypesCtor(&r->types, JSRT_CLONE_KIND_STRING), 1, args);
+      }
+      break;
+    case V8_TAG_REGEXP: {
+      uint32_t bits;
+      args[0] = v8_read_string(r);
+      if (JS_IsException(args[0])) {
+        break;
+      }
+      if (!v8_read_varint32(r, &bits)) {
+        value = v8_throw_read_error(ctx);
+        break;
+      }
+      char flags[countof(v8_regexp_flags) + 1];
+      size_t n = 0;
+      for (size_t i = 0; i < countof(v8_regexp_flags); i++) {
+        if (bits & v8_regexp_flags[i].bit) {
+          flags[n++] = v8_regexp_flags[i].flag;
+        }
+      }
+      args[1] = JS_NewStringLen(ctx, flags, n);
+      value = JS_CallConstructor(ctx, JSRT_CloneTypesCtor(&r->types, JSRT_CLONE_KIND_REGEXP), 2, args);
+      break;
+    }
+  }
+  JS_FreeValue(ctx, args[0]);
+  JS_FreeValue(ctx, args[1]);
+  if (!JS_IsException(value)) {
+    v8_set_object(r, id, value);
+  }
+  return value;
+}
+
+static JSValue v8_read_array_buffer(V8Reader* r, bool resizable) {
+  uint32_t byte_length, max_byte_length, id;
+  const uint8_t* bytes;
+  if (!v8_read_varint32(r, &byte_length) || (resizable && !v8_read_varint32(r, &max_byte_length)) ||
+      !v8_read_raw(r, byte_length, &bytes)) {
+    return v8_throw_read_error(r->ctx);
+  }
+  if (v8_reserve_id(r, &id) < 0) {
+    return JS_EXCEPTION;
+  }
+  // A resizable buffer comes back with a fixed length
+  JSValue buffer = JS_NewArrayBufferCopy(r->ctx, bytes, byte_length);
+  if (!JS_IsException(buffer)) {
+    v8_set_object(r, id, buffer);
+  }
+  return buffer;
+}
+
+static JSValue v8_read_transferred_array_buffer(V8Reader* r) {
+  uint32_t transfer_id, id;
+  if (!v8_read_varint32(r, &transfer_id) || transfer_id >= r->transfer_count ||
+      !JS_IsObject(r->transfers[transfer_id])) {
+    return v8_throw_read_error(r->ctx);
+  }
+  if (v8_reserve_id(r, &id) < 0) {
+    return JS_EXCEPTION;
+  }
+  v8_set_object(r, id, r->transfers[transfer_id]);
+  return JS_DupValue(r->ctx, r->transfers[transfer_id]);
+}
+
+// View whose tag follows the ArrayBuffer it looks into
+static JSValue v8_read_view(V8Reader* r, JSValueConst buffer) {
+  JSContext* ctx = r->ctx;
+  uint8_t subtag;
+  uint32_t offset, length, flags, id;
+  if (!v8_read_byte(r, &subtag) || !v8_read_varint32(r, &offset) || !v8_read_varint32(r, &length) ||
+      (r->version >= 14 && !v8_read_varint32(r, &flags))) {
+    return v8_throw_read_error(ctx);
+  }
+  size_t buffer_size;
+  if (!JS_GetArrayBuffer(ctx, &buffer_size, buffer) && JS_HasException(ctx)) {
+    return JS_EXCEPTION;
+  }
+  if ((uint64_t)offset + length > buffer_size) {
+    return v8_throw_read_error(ctx);
+  }
+
+  int type = -1;
+  for (int i = 0; i < (int)countof(v8_view_tags); i++) {
+    if (v8_view_tags[i] == subtag) {
+      type = i;
+    }
+  }
+  if (subtag != V8_VIEW_TAG_DATA_VIEW &&
+      (type < 0 || offset % v8_typed_array_sizes[type] || length % v8_typed_array_sizes[type])) {
+    return v8_throw_read_error(ctx);
+  }
+  if (v8_reserve_id(r, &id) < 0) {
+    return JS_EXCEPTION;
+  }
+
+  JSValue args[3] = {JS_DupValue(ctx, buffer), JS_NewUint32(ctx, offset), JS_NewUint32(ctx, length)};
+  JSValue view;
+  if (subtag == V8_VIEW_TAG_DATA_VIEW) {
+    view = JS_CallConstructor(ctx, JSRT_CloneTypesCtor(&r->types, JSRT_CLONE_KIND_DATA_VIEW), 3, args);
+  } else {
+    JS_FreeValue(ctx, args[2]);
+    args[2] = JS_NewUint32(ctx, length / v8_typed_array_sizes[type]);
+    view = JS_NewTypedArray(ctx, 3, args, (JSTypedArrayEnum)type);
+  }
+  JS_FreeValue(ctx, args[0]);
+  if (!JS_IsException(view)) {
+    v8_set_object(r, id, view);
+  }
+  return view;
+}
+
+static JSValue v8_read_error_object(V8Reader* r) {
+  JSContext* ctx = r->ctx;
+  uint32_t id;
+  if (v8_reserve_id(r, &id) < 0) {
+    return JS_EXCEPTION;
+  }
+
+  // The error only gets its id once complete, so a cause cannot refer back to it
+  const char* ctor_name = "Error";
+  JSValue message = JS_UNDEFINED, stack = JS_UNDEFINED, cause = JS_UNINITIALIZED;
+  bool ok = true, done = false;
+  while (ok && !done) {
+    uint8_t tag;
+    if (!v8_read_tag(r, &tag)) {
+      ok = false;
+      break;
+    }
+    switch (tag) {
+      case V8_ERROR_MESSAGE:
+        JS_FreeValue(ctx, message);
+        message = v8_read_string(r);
+        ok = !JS_IsException(message);
+        break;
+      case V8_ERROR_STACK:
+        JS_FreeValue(ctx, stack);
+        stack = v8_read_string(r);
+        ok = !JS_IsException(stack);
+        break;
+      case V8_ERROR_CAUSE:
+        JS_FreeValue(ctx, cause);
+        cause = v8_read_value(r);
+        ok = !JS_IsException(cause);
+        break;
+      case V8_ERROR_END:
+        done = true;
+        break;
+      default:
+        ok = false;
+        for (size_t i = 0; i < countof(v8_error_types); i++) {
+          if (v8_error_types[i].tag == tag) {
+            ctor_name = v8_error_types[i].name;
+            ok = true;
+          }
+        }
+        break;
+    }
+  }
+
+  JSValue error = JS_EXCEPTION;
+  if (ok) {
+    JSValue global = JS_GetGlobalObject(ctx);
+    JSValue ctor = JS_GetPropertyStr(ctx, global, ctor_name);
+    error = JS_CallConstructor(ctx, ctor, JS_IsUndefined(message) ? 0 : 1, &message);
+    JS_FreeValue(ctx, ctor);
+    JS_FreeValue(ctx, global);
+  } else if (!JS_HasException(ctx)) {
+    v8_throw_read_error(ctx);
+  }
+  if (!JS_IsException(error) && JS_IsString(stack)) {
+    JS_DefinePropertyValueStr(ctx, error, "stack", JS_DupValue(ctx, stack), JS_PROP_WRITABLE | JS_PROP_CONFIGURABLE);
+  }
+  if (!JS_IsException(error) && !JS_IsUninitialized(cause)) {
+    JS_DefinePropertyValueStr(ctx, error, "cause", JS_DupValue(ctx, cause), JS_PROP_WRITABLE | JS_PROP_CONFIGURABLE);
+  }
+  JS_FreeValue(ctx, message);
+  JS_FreeValue(ctx, stack);
+  JS_FreeValue(ctx, cause);
+  if (!JS_IsException(error)) {
+    v8_set_object(r, id, error);
+  }
+  return error;
+}
+
+// Node's DefaultDeserializer._readHostObject(): type index, byte length, bytes
+static JSValue v8_read_default_host_object(V8Reader* r) {
+  JSContext* ctx = r->ctx;
+  uint32_t index, byte_length;
+  const uint8_t* bytes;
+  if (!v8_read_varint32(r, &index) || index >= countof(v8_host_view_types) || !v8_read_varint32(r, &byte_length) ||
+      !v8_read_raw(r, byte_length, &bytes)) {
+    return v8_throw_read_error(ctx);
+  }
+  if (index == V8_HOST_BUFFER) {
+    return jsrt_node_buffer_from_data(ctx, bytes, byte_length);
+  }
+
+  int type = v8_host_view_types[index];
+  size_t element_size = type >= 0 ? v8_typed_array_sizes[type] : 1;
+  if (byte_length % element_size) {
+    return v8_throw_read_error(ctx);
+  }
+  JSValue buffer = JS_NewArrayBufferCopy(ctx, bytes, byte_length);
+  if (JS_IsException(buffer)) {
+    return buffer;
+  }
+  JSValue view;
+  if (index == V8_HOST_DATA_VIEW) {
+    view = JS_CallConstructor(ctx, JSRT_CloneTypesCtor(&r->types, JSRT_CLONE_KIND_DATA_VIEW), 1, &buffer);
+  } else {
+    JSValue args[3] = {buffer, JS_NewInt32(ctx, 0), JS_NewUint32(ctx, byte_length / element_size)};
+    view = JS_NewTypedArray(ctx, 3, args, (JSTypedArrayEnum)type);
+  }
+  JS_FreeValue(ctx, buffer);
+  return view;
+}
+
+static JSValue v8_read_host_object(V8Reader* r) {
+  JSContext* ctx = r->ctx;
+  uint32_t id;
+  if (v8_reserve_id(r, &id) < 0) {
+    return JS_EXCEPTION;
+  }
+
+  JSValue obj;
+  if (JS_IsObject(r->delegate)) {
+    // Deserializer subclasses read host objects themselves
+    JSValue method = JS_GetPropertyStr(ctx, r->delegate, "_readHostObject");
+    obj = JS_IsFunction(ctx, method) ? JS_Call(ctx, method, r->delegate, 0, NULL) : v8_throw_read_error(ctx);
+    JS_FreeValue(ctx, method);
+    if (!JS_IsException(obj) && !JS_IsObject(obj)) {
+      JS_FreeValue(ctx, obj);
+      obj = v8_throw_read_error(ctx);
+    }
+  } else {
+    obj = v8_read_default_host_object(r);
+  }
+  if (!JS_IsException(obj)) {
+    v8_set_object(r, id, obj);
+  }
+  return obj;
+}
+
+static JSValue v8_read_value_tag(V8Reader* r, uint8_t tag) {
+  JSContext* ctx = r->ctx;
+  uint32_t u32;
+  double d;
+  switch (tag) {
+    case V8_TAG_UNDEFINED:
+      return JS_UNDEFINED;
+    case V8_TAG_NULL:
+      return JS_NULL;
+    case V8_TAG_TRUE:
+      return JS_TRUE;
+    case V8_TAG_FALSE:
+      return JS_FALSE;
+    case V8_TAG_INT32:
+      if (!v8_read_varint32(r, &u32)) {
+        return v8_throw_read_error(ctx);
+      }
+      return JS_NewInt32(ctx, (int32_t)((u32 >> 1) ^ (0u - (u32 & 1))));
+    case V8_TAG_UINT32:
+      return v8_read_varint32(r, &u32) ? JS_NewUint32(ctx, u32) : v8_throw_read_error(ctx);
+    case V8_TAG_DOUBLE:
+      return v8_read_double(r, &d) ? JS_NewFloat64(ctx, d) : v8_throw_read_error(ctx);
+    case V8_TAG_BIGINT:
+      return v8_read_bigint(r);
+    case V8_TAG_UTF8_STRING:
+    case V8_TAG_ONE_BYTE_STRING:
+    case V8_TAG_TWO_BYTE_STRING:
+      return v8_read_string_body(r, tag);
+    case V8_TAG_OBJECT_REFERENCE:
+      if (!v8_read_varint32(r, &u32) || u32 >= r->object_count || !JS_IsObject(r->objects[u32])) {
+        return v8_throw_read_error(ctx);
+      }
+      return JS_DupValue(ctx, r->objects[u32]);
+    case V8_TAG_BEGIN_OBJECT:
+      return v8_read_object(r);
+    case V8_TAG_BEGIN_DENSE_ARRAY:
+    case V8_TAG_BEGIN_SPARSE_ARRAY:
+      return v8_read_array(r, tag == V8_TAG_BEGIN_DENSE_ARRAY);
+    case V8_TAG_BEGIN_MAP:
+    case V8_TAG_BEGIN_SET:
+      return v8_read_collection(r, tag == V8_TAG_BEGIN_MAP);
+    case V8_TAG_DATE:
+    case V8_TAG_TRUE_OBJECT:
+    case V8_TAG_FALSE_OBJECT:
+    case V8_TAG_NUMBER_OBJECT:
+    case V8_TAG_BIGINT_OBJECT:
+    case V8_TAG_STRING_OBJECT:
+    case V8_TAG_REGEXP:
+      return v8_read_wrapper(r, tag);
+    case V8_TAG_ARRAY_BUFFER:
+    case V8_TAG_RESIZABLE_ARRAY_BUFFER:
+      return v8_read_array_buffer(r, tag == V8_TAG_RESIZABLE_ARRAY_BUFFER);
+    case V8_TAG_ARRAY_BUFFER_TRANSFER:
+      return v8_read_transferred_array_buffer(r);
+    case V8_TAG_ERROR:
+      return v8_read_error_object(r);
+    case V8_TAG_HOST_OBJECT:
+      return v8_read_host_object(r);
+    default:
+      // Shared memory and WebAssembly objects cannot come from another process
+      return v8_throw_read_error(ctx);
+  }
+}
+
+static JSValue v8_read_value(V8Reader* r) {
+  JSContext* ctx = r->ctx;
+  uint8_t tag;
+  if (!v8_read_tag(r, &tag)) {
+    return v8_throw_read_error(ctx);
+  }
+  // Legacy: counts to skip before the value itself. Any number of them may precede it, so skip them
+  // here rather than recurse once per tag.
+  while (tag == V8_TAG_VERIFY_OBJECT_COUNT) {
+    uint32_t count;
+    if (!v8_read_varint32(r, &count) || !v8_read_tag(r, &tag)) {
+      return v8_throw_read_error(ctx);
+    }
+  }
+  if (r->depth >= V8_MAX_DEPTH) {
+    return JS_ThrowRangeError(ctx, "Maximum call stack size exceeded");
+  }
+  r->depth++;
+  JSValue value = v8_read_value_tag(r, tag);
+  r->depth--;
+
+  // A view follows the ArrayBuffer (or the reference to one) it looks into
+  uint8_t next;
+  if (JS_IsObject(value) && v8_peek_tag(r, &next) && next == V8_TAG_ARRAY_BUFFER_VIEW) {
+    bool is_buffer = tag == V8_TAG_ARRAY_BUFFER || tag == V8_TAG_RESIZABLE_ARRAY_BUFFER ||
+                     tag == V8_TAG_ARRAY_BUFFER_TRANSFER;
+    if (tag == V8_TAG_OBJECT_REFERENCE) {
+      JSValueConst ctor = JSRT_CloneTypesCtor(&r->types, JSRT_CLONE_KIND_ARRAY_BUFFER);
+      is_buffer = JS_IsObject(ctor) && JS_IsInstanceOf(ctx, value, ctor) > 0;
+    }
+    if (is_buffer) {
+      v8_read_tag(r, &next);
+      JSValue view = v8_read_view(r, value);
+      JS_FreeValue(ctx, value);
+      return view;
+    }
+  }
+  return value;
+}
+
+// One readValue(); delegate is the Deserializer object when called through the class
+static JSValue v8_read_top(V8Reader* r, JSValueConst delegate) {
+  if (r->busy) {
+    return JS_ThrowTypeError(r->ctx, "Deserializer is already reading a value");
+  }
+  r->busy = true;
+  r->delegate = delegate;
+  r->depth = 0;
+  JSRT_CloneTypesInit(r->ctx, &r->types);
+  JSValue value = v8_read_value(r);
+  JSRT_CloneTypesFree(&r->types);
+  r->delegate = JS_UNDEFINED;
+  r->busy = false;
+  return value;
+}
+
+JSValue jsrt_v8_deserialize(JSContext* ctx, const uint8_t* data, size_t size) {
+  V8Reader r;
+  v8_reader_init(ctx, &r, data, size);
+  JSValue value = v8_read_header(&r) < 0 ? JS_EXCEPTION : v8_read_top(&r, JS_UNDEFINED);
+  v8_reader_free_rt(JS_GetRuntime(ctx), &r);
+  return value;
+}
+
+// ============================================================================
+// JavaScript API
+// ============================================================================
+
+static void v8_free_buffer_data(JSRuntime* rt, void* opaque, void* ptr) {
+  js_free_rt(rt, ptr);
+}
+
+// Buffer taking ownership of data, which was allocated with js_malloc
+static JSValue v8_new_buffer(JSContext* ctx, uint8_t* data, size_t size) {
+  JSValue array_buffer = JS_NewArrayBuffer(ctx, data, size, v8_free_buffer_data, NULL, false);
+  if (JS_IsException(array_buffer)) {
+    js_free(ctx, data);
+    return array_buffer;
+  }
+  JSValue buffer = jsrt_node_buffer_view(ctx, array_buffer, 0, size);
+  JS_FreeValue(ctx, array_buffer);
+  return buffer;
+}
+
+// Bytes of a Buffer, TypedArray or DataView argument
+static const uint8_t* v8_bytes_arg(JSContext* ctx, JSValueConst val, size_t* size) {
+  const uint8_t* bytes = JS_IsObject(val) ? jsrt_node_buffer_bytes(ctx, val, size) : NULL;
+  if (!bytes && !JS_HasException(ctx)) {
+    JS_ThrowTypeError(ctx, "The \"buffer\" argument must be an instance of Buffer, TypedArray, or DataView");
+  }
+  return bytes;
+}
+
+// v8.serialize(value)
+static JSValue js_v8_serialize(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
+  size_t size;
+  uint8_t* data = jsrt_v8_serialize(ctx, argc > 0 ? argv[0] : JS_UNDEFINED, &size);
+  if (!data) {
+    return JS_EXCEPTION;
+  }
+  // Return the spare capacity before handing the memory to the Buffer
+  uint8_t* shrunk = js_realloc(ctx, data, size);
+  return v8_new_buffer(ctx, shrunk ? shrunk : data, size);
+}
+
+// v8.deserialize(buffer)
+static JSValue js_v8_deserialize(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
+  size_t size = 0;
+  const uint8_t* bytes = v8_bytes_arg(ctx, argc > 0 ? argv[0] : JS_UNDEFINED, &size);
+  if (!bytes) {
+    return JS_EXCEPTION;
+  }
+  // Work on a copy: Map.prototype.set and friends could detach the input while it is read
+  uint8_t* copy = js_malloc(ctx, size ? size : 1);
+  if (!copy) {
+    return JS_EXCEPTION;
+  }
+  memcpy(copy, bytes, size);
+  JSValue value = jsrt_v8_deserialize(ctx, copy, size);
+  js_free(ctx, copy);
+  return value;
+}
+
+static void js_v8_serializer_finalizer(JSRuntime* rt, JSValue val) {
+  V8Writer* w = JS_GetOpaque(val, js_v8_serializer_class_id);
+  if (w) {
+    v8_writer_free_rt(rt, w);
+    js_free_rt(rt, w);
+  }
+}
+
+static void js_v8_serializer_mark(JSRuntime* rt, JSValueConst val, JS_MarkFunc* mark_func) {
+  V8Writer* w = JS_GetOpaque(val, js_v8_serializer_class_id);
+  if (w) {
+    JSRT_CloneMapMark(rt, &w->objects, mark_func);
+    JSRT_CloneMapMark(rt, &w->transfers, mark_func);
+  }
+}
+
+static void js_v8_deserializer_finalizer(JSRuntime* rt, JSValue val) {
+  V8Reader* r = JS_GetOpaque(val, js_v8_deserializer_class_id);
+  if (r) {
+    v8_reader_free_rt(rt, r);
+    js_free_rt(rt, r);
+  }
+}
+
+static void js_v8_deserializer_mark(JSRuntime* rt, JSValueConst val, JS_MarkFunc* mark_func) {
+  V8Reader* r = JS_GetOpaque(val, js_v8_deserializer_class_id);
+  if (r) {
+    for (uint32_t i = 0; i < r->object_count; i++) {
+      JS_MarkValue(rt, r->objects[i], mark_func);
+    }
+    for (uint32_t i = 0; i < r->transfer_count; i++) {
+      JS_MarkValue(rt, r->transfers[i], mark_func);
+    }
+  }
+}
+
+static JSClassDef js_v8_serializer_class = {
+    "Serializer",
+    .finalizer = js_v8_serializer_finalizer,
+    .gc_mark = js_v8_serializer_mark,
+};
+
+static JSClassDef js_v8_deserializer_class = {
+    "Deserializer",
+    .finalizer = js_v8_deserializer_finalizer,
+    .gc_mark = js_v8_deserializer_mark,
+};
+
+// Serializer and DefaultSerializer (magic 1) constructors
+static JSValue js_v8_serializer_ctor(JSContext* ctx, JSValueConst new_target, int argc, JSValueConst* argv,
+                                     int magic) {
+  JSValue proto = JS_GetPropertyStr(ctx, new_target, "prototype");
+  if (JS_IsException(proto)) {
+    return proto;
+  }
+  JSValue obj = JS_NewObjectProtoClass(ctx, proto, js_v8_serializer_class_id);
+  JS_FreeValue(ctx, proto);
+  if (JS_IsException(obj)) {
+    return obj;
+  }
+
+  V8Writer* w = js_malloc(ctx, sizeof(V8Writer));
+  if (!w) {
+    JS_FreeValue(ctx, obj);
+    return JS_EXCEPTION;
+  }
+  v8_writer_init(ctx, w, magic == 1);
+  JS_SetOpaque(obj, w);
+  return obj;
+}
+
+static JSValue js_v8_serializer_write_header(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
+  V8Writer* w = JS_GetOpaque2(ctx, this_val, js_v8_serializer_class_id);
+  if (!w || v8_write_header(w) < 0) {
+    return JS_EXCEPTION;
+  }
+  return JS_UNDEFINED;
+}
+
+static JSValue js_v8_serializer_write_value(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
+  V8Writer* w = JS_GetOpaque2(ctx, this_val, js_v8_serializer_class_id);
+  if (!w || v8_write_top(w, argc > 0 ? argv[0] : JS_UNDEFINED, this_val) < 0) {
+    return JS_EXCEPTION;
+  }
+  return JS_TRUE;
+}
+
+// Returns what was written so far and starts over with an empty buffer
+static JSValue js_v8_serializer_release_buffer(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
+  V8Writer* w = JS_GetOpaque2(ctx, this_val, js_v8_serializer_class_id);
+  if (!w) {
+    return JS_EXCEPTION;
+  }
+  if (!w->data) {
+    return jsrt_node_buffer_from_data(ctx, NULL, 0);
+  }
+  uint8_t* data = js_realloc(ctx, w->data, w->size ? w->size : 1);
+  size_t size = w->size;
+  if (!data) {
+    return JS_EXCEPTION;
+  }
+  w->data = NULL;
+  w->size = w->capacity = 0;
+  return v8_new_buffer(ctx, data, size);
+}
+
+// transferArrayBuffer(id, arrayBuffer): arrayBuffer is written as a reference to transfer id
+static JSValue js_v8_serializer_transfer_array_buffer(JSContext* ctx, JSValueConst this_val, int argc,
+                                                      JSValueConst* argv) {
+  V8Writer* w = JS_GetOpaque2(ctx, this_val, js_v8_serializer_class_id);
+  uint32_t id;
+  size_t size;
+  if (!w || argc < 2 || JS_ToUint32(ctx, &id, argv[0])) {
+    return w && argc < 2 ? JS_ThrowTypeError(ctx, "transferArrayBuffer requires 2 arguments") : JS_EXCEPTION;
+  }
+  if (!JS_GetArrayBuffer(ctx, &size, argv[1]) && JS_HasException(ctx)) {
+    return JS_EXCEPTION;
+  }
+  JSValue existing = JSRT_CloneMapGet(&w->transfers, argv[1]);
+  if (!JS_IsUninitialized(existing)) {
+    return JS_ThrowTypeError(ctx, "ArrayBuffer is already being transferred");
+  }
+  if (JSRT_CloneMapSet(&w->transfers, argv[1], JS_NewInt32(ctx, (int32_t)id)) < 0) {
+    return JS_EXCEPTION;
+  }
+  return JS_UNDEFINED;
+}
+
+static JSValue js_v8_serializer_write_uint32(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
+  V8Writer* w = JS_GetOpaque2(ctx, this_val, js_v8_serializer_class_id);
+  uint32_t value;
+  if (!w || JS_ToUint32(ctx, &value, argc > 0 ? argv[0] : JS_UNDEFINED) || v8_write_varint(w, value) < 0) {
+    return JS_EXCEPTION;
+  }
+  return JS_UNDEFINED;
+}
+
+// writeUint64(hi, lo)
+static JSValue js_v8_serializer_write_uint64(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
+  V8Writer* w = JS_GetOpaque2(ctx, this_val, js_v8_serializer_class_id);
+  uint32_t hi, lo;
+  if (!w || JS_ToUint32(ctx, &hi, argc > 0 ? argv[0] : JS_UNDEFINED) ||
+      JS_ToUint32(ctx, &lo, argc > 1 ? argv[1] : JS_UNDEFINED) || v8_write_varint(w, (uint64_t)hi << 32 | lo) < 0) {
+    return JS_EXCEPTION;
+  }
+  return JS_UNDEFINED;
+}
+
+static JSValue js_v8_serializer_write_double(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
+  V8Writer* w = JS_GetOpaque2(ctx, this_val, js_v8_serializer_class_id);
+  double value;
+  if (!w || JS_ToFloat64(ctx, &value, argc > 0 ? argv[0] : JS_UNDEFINED) || v8_write_double(w, value) < 0) {
+    return JS_EXCEPTION;
+  }
+  return JS_UNDEFINED;
+}
+
+static JSValue js_v8_serializer_write_raw_bytes(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
+  V8Writer* w = JS_GetOpaque2(ctx, this_val, js_v8_serializer_class_id);
+  size_t size = 0;
+  const uint8_t* bytes = w ? v8_bytes_arg(ctx, argc > 0 ? argv[0] : JS_UNDEFINED, &size) : NULL;
+  if (!bytes || v8_write_bytes(w, bytes, size) < 0) {
+    return JS_EXCEPTION;
+  }
+  return JS_UNDEFINED;
+}
+
+static JSValue js_v8_serializer_set_treat_views(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
+  V8Writer* w = JS_GetOpaque2(ctx, this_val, js_v8_serializer_class_id);
+  if (!w) {
+    return JS_EXCEPTION;
+  }
+  w->host_views = argc > 0 && JS_ToBool(ctx, argv[0]);
+  return JS_UNDEFINED;
+}
+
+// DefaultSerializer.prototype._writeHostObject(view)
+static JSValue js_v8_serializer_write_host_object(JSContext* ctx, JSValueConst this_val, int argc,
+                                                  JSValueConst* argv) {
+  V8Writer* w = JS_GetOpaque2(ctx, this_val, js_v8_serializer_class_id);
+  if (!w) {
+    return JS_EXCEPTION;
+  }
+  JSValueConst view = argc > 0 ? argv[0] : JS_UNDEFINED;
+  JSRT_CloneTypes types;
+  JSRT_CloneTypesInit(ctx, &types);
+  JSRT_CloneKind kind = JSRT_CLONE_KIND_OBJECT;
+  int ret = JS_IsObject(view) ? JSRT_CloneClassify(&types, view, &kind) : 0;
+  JSRT_CloneTypesFree(&types);
+  if (ret < 0 || v8_write_default_host_object(w, view, kind) < 0) {
+    return JS_EXCEPTION;
+  }
+  return JS_UNDEFINED;
+}
+
+// Deserializer and DefaultDeserializer constructors: new Deserializer(buffer)
+static JSValue js_v8_deserializer_ctor(JSContext* ctx, JSValueConst new_target, int argc, JSValueConst* argv) {
+  size_t size = 0;
+  JSValueConst input = argc > 0 ? argv[0] : JS_UNDEFINED;
+  const uint8_t* bytes = v8_bytes_arg(ctx, input, &size);
+  if (!bytes) {
+    return JS_EXCEPTION;
+  }
+
+  JSValue proto = JS_GetPropertyStr(ctx, new_target, "prototype");
+  if (JS_IsException(proto)) {
+    return proto;
+  }
+  JSValue obj = JS_NewObjectProtoClass(ctx, proto, js_v8_deserializer_class_id);
+  JS_FreeValue(ctx, proto);
+  if (JS_IsException(obj)) {
+    return obj;
+  }
+
+  // The input is copied so that later writes to it cannot affect reading
+  V8Reader* r = js_malloc(ctx, sizeof(V8Reader));
+  uint8_t* data = js_malloc(ctx, size ? size : 1);
+  if (!r || !data) {
+    js_free(ctx, r);
+    js_free(ctx, data);
+    JS_FreeValue(ctx, obj);
+    return JS_EXCEPTION;
+  }
+  memcpy(data, bytes, size);
+  v8_reader_init(ctx, r, data, size);
+  r->owned_data = data;
+  JS_SetOpaque(obj, r);
+  JS_DefinePropertyValueStr(ctx, obj, "buffer", JS_DupValue(ctx, input), JS_PROP_C_W_E);
+  return obj;
+}
+
+static JSValue js_v8_deserializer_read_header(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
+  V8Reader* r = JS_GetOpaque2(ctx, this_val, js_v8_deserializer_class_id);
+  if (!r || v8_read_header(r) < 0) {
+    return JS_EXCEPTION;
+  }
+  return JS_TRUE;
+}
+
+static JSValue js_v8_deserializer_read_value(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
+  V8Reader* r = JS_GetOpaque2(ctx, this_val, js_v8_deserializer_class_id);
+  if (!r) {
+    return JS_EXCEPTION;
+  }
+  return v8_read_top(r, this_val);
+}
+
+static JSValue js_v8_deserializer_get_wire_format_version(JSContext* ctx, JSValueConst this_val, int argc,
+                                                         JSValueConst* argv) {
+  V8Reader* r = JS_GetOpaque2(ctx, this_val, js_v8_deserializer_class_id);
+  if (!r) {
+    return JS_EXCEPTION;
+  }
+  return JS_NewUint32(ctx, r->version);
+}
+
+// transferArrayBuffer(id, arrayBuffer): transfer id now reads as arrayBuffer
+static JSValue js_v8_deserializer_transfer_array_buffer(JSContext* ctx, JSValueConst this_val, int argc,
+                                                        JSValueConst* argv) {
+  V8Reader* r = JS_GetOpaque2(ctx, this_val, js_v8_deserializer_class_id);
+  uint32_t id;
+  size_t size;
+  if (!r || argc < 2 || JS_ToUint32(ctx, &id, argv[0])) {
+    return r && argc < 2 ? JS_ThrowTypeError(ctx, "transferArrayBuffer requires 2 arguments") : JS_EXCEPTION;
+  }
+  if (!JS_GetArrayBuffer(ctx, &size, argv[1]) && JS_HasException(ctx)) {
+    return JS_EXCEPTION;
+  }
+  if (id >= r->transfer_count) {
+    JSValue* transfers = js_realloc(ctx, r->transfers, sizeof(JSValue) * ((size_t)id + 1));
+    if (!transfers) {
+      return JS_EXCEPTION;
+    }
+    for (uint32_t i = r->transfer_count; i <= id; i++) {
+      transfers[i] = JS_UNDEFINED;
+    }
+    r->transfers = transfers;
+    r->transfer_count = id + 1;
+  }
+  JS_FreeValue(ctx, r->transfers[id]);
+  r->transfers[id] = JS_DupValue(ctx, argv[1]);
+  return JS_UNDEFINED;
+}
+
+static JSValue js_v8_deserializer_read_uint32(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
+  V8Reader* r = JS_GetOpaque2(ctx, this_val, js_v8_deserializer_class_id);
+  uint32_t value;
+  if (!r) {
+    return JS_EXCEPTION;
+  }
+  return v8_read_varint32(r, &value) ? JS_NewUint32(ctx, value) : v8_throw_read_error(ctx);
+}
+
+// readUint64() returns [hi, lo]
+static JSValue js_v8_deserializer_read_uint64(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
+  V8Reader* r = JS_GetOpaque2(ctx, this_val, js_v8_deserializer_class_id);
+  uint64_t value;
+  if (!r) {
+    return JS_EXCEPTION;
+  }
+  if (!v8_read_varint(r, &value)) {
+    return v8_throw_read_error(ctx);
+  }
+  JSValue result = JS_NewArray(ctx);
+  JS_SetPropertyUint32(ctx, result, 0, JS_NewUint32(ctx, (uint32_t)(value >> 32)));
+  JS_SetPropertyUint32(ctx, result, 1, JS_NewUint32(ctx, (uint32_t)value));
+  return result;
+}
+
+static JSValue js_v8_deserializer_read_double(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
+  V8Reader* r = JS_GetOpaque2(ctx, this_val, js_v8_deserializer_class_id);
+  double value;
+  if (!r) {
+    return JS_EXCEPTION;
+  }
+  return v8_read_double(r, &value) ? JS_NewFloat64(ctx, value) : v8_throw_read_error(ctx);
+}
+
+// readRawBytes(length) returns a Buffer (magic 0); _readRawBytes(length) the offset of the bytes (magic 1)
+static JSValue js_v8_deserializer_read_raw_bytes(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv,
+                                                 int magic) {
+  V8Reader* r = JS_GetOpaque2(ctx, this_val, js_v8_deserializer_class_id);
+  uint64_t length;
+  const uint8_t* bytes;
+  if (!r || JS_ToIndex(ctx, &length, argc > 0 ? argv[0] : JS_UNDEFINED)) {
+    return JS_EXCEPTION;
+  }
+  size_t offset = r->pos;
+  if (length > SIZE_MAX || !v8_read_raw(r, (size_t)length, &bytes)) {
+    return v8_throw_read_error(ctx);
+  }
+  return magic ? JS_NewInt64(ctx, (int64_t)offset) : jsrt_node_buffer_from_data(ctx, bytes, (size_t)length);
+}
+
+// DefaultDeserializer.prototype._readHostObject()
+static JSValue js_v8_deserializer_read_host_object(JSContext* ctx, JSValueConst this_val, int argc,
+                                                   JSValueConst* argv) {
+  V8Reader* r = JS_GetOpaque2(ctx, this_val, js_v8_deserializer_class_id);
+  if (!r) {
+    return JS_EXCEPTION;
+  }
+  if (r->busy) {
+    return v8_read_default_host_object(r);
+  }
+  JSRT_CloneTypesInit(ctx, &r->types);
+  JSValue value = v8_read_default_host_object(r);
+  JSRT_CloneTypesFree(&r->types);
+  return value;
+}
+
+static const JSCFunctionListEntry js_v8_serializer_proto_funcs[] = {
+    JS_CFUNC_DEF("writeHeader", 0, js_v8_serializer_write_header),
+    JS_CFUNC_DEF("writeValue", 1, js_v8_serializer_write_value),
+    JS_CFUNC_DEF("releaseBuffer", 0, js_v8_serializer_release_buffer),
+    JS_CFUNC_DEF("transferArrayBuffer", 2, js_v8_serializer_transfer_array_buffer),
+    JS_CFUNC_DEF("writeUint32", 1, js_v8_serializer_write_uint32),
+    JS_CFUNC_DEF("writeUint64", 2, js_v8_serializer_write_uint64),
+    JS_CFUNC_DEF("writeDouble", 1, js_v8_serializer_write_double),
+    JS_CFUNC_DEF("writeRawBytes", 1, js_v8_serializer_write_raw_bytes),
+    JS_CFUNC_DEF("_setTreatArrayBufferViewsAsHostObjects", 1, js_v8_serializer_set_treat_views),
+};
+
+static const JSCFunctionListEntry js_v8_deserializer_proto_funcs[] = {
+    JS_CFUNC_DEF("readHeader", 0, js_v8_deserializer_read_header),
+    JS_CFUNC_DEF("readValue", 0, js_v8_deserializer_read_value),
+    JS_CFUNC_DEF("getWireFormatVersion", 0, js_v8_deserializer_get_wire_format_version),
+    JS_CFUNC_DEF("transferArrayBuffer", 2, js_v8_deserializer_transfer_array_buffer),
+    JS_CFUNC_DEF("readUint32", 0, js_v8_deserializer_read_uint32),
+    JS_CFUNC_DEF("readUint64", 0, js_v8_deserializer_read_uint64),
+    JS_CFUNC_DEF("readDouble", 0, js_v8_deserializer_read_double),
+    JS_CFUNC_MAGIC_DEF("readRawBytes", 1, js_v8_deserializer_read_raw_bytes, 0),
+    JS_CFUNC_MAGIC_DEF("_readRawBytes", 1, js_v8_deserializer_read_raw_bytes, 1),
+};
+
+// Makes sub_ctor extend base_ctor, as `class Sub extends Base` would
+static void v8_inherit(JSContext* ctx, JSValueConst sub_ctor, JSValueConst base_ctor) {
+  JSValue sub_proto = JS_GetPropertyStr(ctx, sub_ctor, "prototype");
+  JSValue base_proto = JS_GetPropertyStr(ctx, base_ctor, "prototype");
+  JS_SetPrototype(ctx, sub_proto, base_proto);
+  JS_SetPrototype(ctx, sub_ctor, base_ctor);
+  JS_FreeValue(ctx, base_proto);
+  JS_FreeValue(ctx, sub_proto);
+}
+
+JSValue JSRT_InitNodeV8(JSContext* ctx) {
+  JSRuntime* rt = JS_GetRuntime(ctx);
+  JSValue v8_obj = JS_NewObject(ctx);
+
+  // Register classes
+  JS_NewClassID(&js_v8_serializer_class_id);
+  JS_NewClassID(&js_v8_deserializer_class_id);
+  if (!JS_IsRegisteredClass(rt, js_v8_serializer_class_id)) {
+    JS_NewClass(rt, js_v8_serializer_class_id, &js_v8_serializer_class);
+  }
+  if (!JS_IsRegisteredClass(rt, js_v8_deserializer_class_id)) {
+    JS_NewClass(rt, js_v8_deserializer_class_id, &js_v8_deserializer_class);
+  }
+
+  // Serializer and DefaultSerializer
+  JSValue serializer = JS_NewCFunctionMagic(ctx, js_v8_serializer_ctor, "Serializer", 0, JS_CFUNC_constructor_magic, 0);
+  JSValue serializer_proto = JS_GetPropertyStr(ctx, serializer, "prototype");
+  JS_SetPropertyFunctionList(ctx, serializer_proto, js_v8_serializer_proto_funcs,
+                             countof(js_v8_serializer_proto_funcs));
+  JSValue global = JS_GetGlobalObject(ctx);
+  JS_SetPropertyStr(ctx, serializer_proto, "_getDataCloneError", JS_GetPropertyStr(ctx, global, "Error"));
+  JS_FreeValue(ctx, global);
+  JS_SetClassProto(ctx, js_v8_serializer_class_id, serializer_proto);
+
+  JSValue default_serializer =
+      JS_NewCFunctionMagic(ctx, js_v8_serializer_ctor, "DefaultSerializer", 0, JS_CFUNC_constructor_magic, 1);
+  v8_inherit(ctx, default_serializer, serializer);
+  JSValue default_serializer_proto = JS_GetPropertyStr(ctx, default_serializer, "prototype");
+  JS_SetPropertyStr(ctx, default_serializer_proto, "_writeHostObject",
+                    JS_NewCFunction(ctx, js_v8_serializer_write_host_object, "_writeHostObject", 1));
+  JS_FreeValue(ctx, default_serializer_proto);
+
+  // Deserializer and DefaultDeserializer
+  JSValue deserializer = JS_NewCFunction2(ctx, js_v8_deserializer_ctor, "Deserializer", 1, JS_CFUNC_constructor, 0);
+  JSValue deserializer_proto = JS_GetPropertyStr(ctx, deserializer, "prototype");
+  JS_SetPropertyFunctionList(ctx, deserializer_proto, js_v8_deserializer_proto_funcs,
+                             countof(js_v8_deserializer_proto_funcs));
+  JS_SetClassProto(ctx, js_v8_deserializer_class_id, deserializer_proto);
+
+  JSValue default_deserializer =
+      JS_NewCFunction2(ctx, js_v8_deserializer_ctor, "DefaultDeserializer", 1, JS_CFUNC_constructor, 0);
+  v8_inherit(ctx, default_deserializer, deserializer);
+  JSValue default_deserializer_proto = JS_GetPropertyStr(ctx, default_deserializer, "prototype");
+  JS_SetPropertyStr(ctx, default_deserializer_proto, "_readHostObject",
+                    JS_NewCFunction(ctx, js_v8_deserializer_read_host_object, "_readHostObject", 0));
+  JS_FreeValue(ctx, default_deserializer_proto);
+
+  JS_SetPropertyStr(ctx, v8_obj, "Serializer", serializer);
+  JS_SetPropertyStr(ctx, v8_obj, "DefaultSerializer", default_serializer);
+  JS_SetPropertyStr(ctx, v8_obj, "Deserializer", deserializer);
+  JS_SetPropertyStr(ctx, v8_obj, "DefaultDeserializer", default_deserializer);
+  JS_SetPropertyStr(ctx, v8_obj, "serialize", JS_NewCFunction(ctx, js_v8_serialize, "serialize", 1));
+  JS_SetPropertyStr(ctx, v8_obj, "deserialize", JS_NewCFunction(ctx, js_v8_deserialize, "deserialize", 1));
+  return v8_obj;
+}
+
+// v8 module initialization (ES Module)
+int js_node_v8_init(JSContext* ctx, JSModuleDef* m) {
+  JSValue v8_obj = JSRT_InitNodeV8(ctx);
+
+  JS_SetModuleExport(ctx, m, "serialize", JS_GetPropertyStr(ctx, v8_obj, "serialize"));
+  JS_SetModuleExport(ctx, m, "deserialize", JS_GetPropertyStr(ctx, v8_obj, "deserialize"));
+  JS_SetModuleExport(ctx, m, "Serializer", JS_GetPropertyStr(ctx, v8_obj, "Serializer"));
+  JS_SetModuleExport(ctx, m, "Deserializer", JS_GetPropertyStr(ctx, v8_obj, "Deserializer"));
+  JS_SetModuleExport(ctx, m, "DefaultSerializer", JS_GetPropertyStr(ctx, v8_obj, "DefaultSerializer"));
+  JS_SetModuleExport(ctx, m, "DefaultDeserializer", JS_GetPropertyStr(ctx, v8_obj, "DefaultDeserializer"));
+  JS_SetModuleExport(ctx, m, "default", JS_DupValue(ctx, v8_obj));
+
+  JS_FreeValue(ctx, v8_obj);
+  return 0;
+}
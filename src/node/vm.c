@@ -1,191 +1,606 @@
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
 #include <string.h>
 #include "../runtime.h"
 #include "../std/assert.h"
 #include "../util/debug.h"
+#include "../util/macro.h"
+#include "../util/sha256.h"
 #include "node_modules.h"
 
 // VM module implementation - provides script compilation and execution in contexts
-// This is a minimal implementation focused on npm package compatibility
+//
+// A vm.Script is compiled once, at construction, to QuickJS function bytecode.
+// Running it in another context reads a serialized copy of that bytecode into
+// the target context instead of parsing the source again.
+//
+// A context created by vm.createContext() is a separate JSContext on the shared
+// runtime, holding only the ECMAScript built-ins. Properties of the sandbox
+// object are copied onto its global object before each run and globals created
+// by the script are copied back onto the sandbox afterwards.
+
+#ifndef QUICKJS_VERSION
+#define QUICKJS_VERSION "unknown"
+#endif
+
+// cachedData layout: magic, FNV-1a hash of QuickJS version and source, SHA-256 of the bytecode, bytecode.
+// QuickJS does not validate bytecode, so only bytes matching their digest reach JS_ReadObject.
+#define VM_CACHED_DATA_MAGIC "JSRTVM02"
+#define VM_CACHED_DATA_DIGEST_OFFSET 16
+#define VM_CACHED_DATA_HEADER_SIZE (VM_CACHED_DATA_DIGEST_OFFSET + JSRT_SHA256_DIGEST_LENGTH)
+
+// FNV-1a hash constants
+#define FNV_OFFSET_BASIS 14695981039346656037ULL
+#define FNV_PRIME 1099511628211ULL
+
+static JSClassID js_vm_script_class_id;
+static JSClassID js_vm_context_class_id;
+
+// Symbol key of the hidden property linking a sandbox to its context
+static JSRT_THREAD_LOCAL JSAtom g_vm_context_atom = JS_ATOM_NULL;
+
+// Compiled vm.Script
+typedef struct {
+  JSContext* ctx;          // Context the script was compiled in
+  JSValue bytecode;        // Function bytecode bound to ctx
+  uint64_t source_hash;    // Hash of the source, checked against cachedData
+  uint8_t* serialized;     // JS_WriteObject() output, made on first run in another context
+  size_t serialized_size;  // Size of serialized
+  JSContext* last_ctx;     // Other context the script last ran in
+  JSValue last_bytecode;   // Bytecode bound to last_ctx
+} JSVMScript;
+
+// Context created by vm.createContext()
+typedef struct {
+  JSContext* ctx;
+} JSVMContext;
+
+static void js_vm_script_finalizer(JSRuntime* rt, JSValue val) {
+  JSVMScript* script = JS_GetOpaque(val, js_vm_script_class_id);
+  if (!script) {
+    return;
+  }
+  JS_FreeValueRT(rt, script->bytecode);
+  JS_FreeValueRT(rt, script->last_bytecode);
+  js_free_rt(rt, script->serialized);
+  js_free_rt(rt, script);
+}
 
-// Forward declarations
-static JSValue js_vm_script_runInContext(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv);
-static JSValue js_vm_script_runInNewContext(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv);
-static JSValue js_vm_script_runInThisContext(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv);
+static void js_vm_context_finalizer(JSRuntime* rt, JSValue val) {
+  JSVMContext* context = JS_GetOpaque(val, js_vm_context_class_id);
+  if (!context) {
+    return;
+  }
+  JS_FreeContext(context->ctx);
+  js_free_rt(rt, context);
+}
 
-// VM Context constructor
-static JSValue js_vm_createContext(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
-  JSValue sandbox;
+static JSClassDef js_vm_script_class = {
+    "Script",
+    .finalizer = js_vm_script_finalizer,
+};
+
+static JSClassDef js_vm_context_class = {
+    "VMContext",
+    .finalizer = js_vm_context_finalizer,
+};
+
+static uint64_t js_vm_hash_source(const char* source, size_t len) {
+  uint64_t hash = FNV_OFFSET_BASIS;
+  for (const char* p = QUICKJS_VERSION; *p; p++) {
+    hash ^= (uint64_t)(unsigned char)*p;
+    hash *= FNV_PRIME;
+  }
+  for (size_t i = 0; i < len; i++) {
+    hash ^= (uint64_t)(unsigned char)source[i];
+    hash *= FNV_PRIME;
+  }
+  return hash;
+}
 
-  if (argc > 0 && !JS_IsUndefined(argv[0]) && !JS_IsNull(argv[0])) {
-    sandbox = JS_DupValue(ctx, argv[0]);
-  } else {
+// Get the bytes of a Buffer, TypedArray or DataView
+static uint8_t* js_vm_get_bytes(JSContext* ctx, JSValueConst val, size_t* len) {
+  size_t byte_offset, byte_length, buffer_size;
+  JSValue array_buffer = JS_GetTypedArrayBuffer(ctx, val, &byte_offset, &byte_length, NULL);
+  if (JS_IsException(array_buffer)) {
+    JS_FreeValue(ctx, JS_GetException(ctx));
+    return NULL;
+  }
+  uint8_t* data = JS_GetArrayBuffer(ctx, &buffer_size, array_buffer);
+  JS_FreeValue(ctx, array_buffer);
+  if (!data) {
+    return NULL;
+  }
+  *len = byte_length;
+  return data + byte_offset;
+}
+
+// Parse the filename from a Script/run options argument (string or { filename })
+static const char* js_vm_get_filename(JSContext* ctx, JSValueConst options) {
+  if (JS_IsString(options)) {
+    return JS_ToCString(ctx, options);
+  }
+  if (!JS_IsObject(options)) {
+    return NULL;
+  }
+  JSValue filename = JS_GetPropertyStr(ctx, options, "filename");
+  const char* result = JS_IsString(filename) ? JS_ToCString(ctx, filename) : NULL;
+  JS_FreeValue(ctx, filename);
+  return result;
+}
+
+static JSAtom js_vm_context_atom(JSContext* ctx) {
+  if (g_vm_context_atom == JS_ATOM_NULL) {
+    JSValue global = JS_GetGlobalObject(ctx);
+    JSValue symbol_ctor = JS_GetPropertyStr(ctx, global, "Symbol");
+    JSValue description = JS_NewString(ctx, "vm.context");
+    JSValue symbol = JS_Call(ctx, symbol_ctor, JS_UNDEFINED, 1, &description);
+    if (!JS_IsException(symbol)) {
+      g_vm_context_atom = JS_ValueToAtom(ctx, symbol);
+    }
+    JS_FreeValue(ctx, symbol);
+    JS_FreeValue(ctx, description);
+    JS_FreeValue(ctx, symbol_ctor);
+    JS_FreeValue(ctx, global);
+  }
+  return g_vm_context_atom;
+}
+
+// Get the context of a contextified sandbox, or NULL
+static JSVMContext* js_vm_get_context(JSContext* ctx, JSValueConst sandbox) {
+  if (!JS_IsObject(sandbox)) {
+    return NULL;
+  }
+  JSAtom atom = js_vm_context_atom(ctx);
+  if (atom == JS_ATOM_NULL) {
+    return NULL;
+  }
+  JSValue holder = JS_GetProperty(ctx, sandbox, atom);
+  JSVMContext* context = JS_GetOpaque(holder, js_vm_context_class_id);
+  JS_FreeValue(ctx, holder);
+  return context;
+}
+
+// Contextify sandbox (a new object if undefined): attach a new JSContext to it
+static JSValue js_vm_contextify(JSContext* ctx, JSValueConst sandbox_arg) {
+  JSValue sandbox;
+  if (JS_IsUndefined(sandbox_arg) || JS_IsNull(sandbox_arg)) {
     sandbox = JS_NewObject(ctx);
+  } else if (JS_IsObject(sandbox_arg)) {
+    sandbox = JS_DupValue(ctx, sandbox_arg);
+  } else {
+    return JS_ThrowTypeError(ctx, "The \"contextObject\" argument must be of type object");
   }
 
-  // Create context object with sandbox as global
-  JSValue context_obj = JS_NewObject(ctx);
-  JS_SetPropertyStr(ctx, context_obj, "global", JS_DupValue(ctx, sandbox));
-  JS_SetPropertyStr(ctx, context_obj, "sandbox", sandbox);
+  if (js_vm_get_context(ctx, sandbox)) {
+    return sandbox;
+  }
 
-  return context_obj;
+  JSAtom atom = js_vm_context_atom(ctx);
+  if (atom == JS_ATOM_NULL) {
+    JS_FreeValue(ctx, sandbox);
+    return JS_EXCEPTION;
+  }
+
+  JSVMContext* context = js_mallocz(ctx, sizeof(JSVMContext));
+  if (!context) {
+    JS_FreeValue(ctx, sandbox);
+    return JS_EXCEPTION;
+  }
+
+  context->ctx = JS_NewContext(JS_GetRuntime(ctx));
+  if (!context->ctx) {
+    js_free(ctx, context);
+    JS_FreeValue(ctx, sandbox);
+    return JS_ThrowOutOfMemory(ctx);
+  }
+  // Share the runtime's opaque so host callbacks reached from the context work
+  JS_SetContextOpaque(context->ctx, JS_GetContextOpaque(ctx));
+
+  JSValue holder = JS_NewObjectClass(ctx, js_vm_context_class_id);
+  if (JS_IsException(holder)) {
+    JS_FreeContext(context->ctx);
+    js_free(ctx, context);
+    JS_FreeValue(ctx, sandbox);
+    return holder;
+  }
+  JS_SetOpaque(holder, context);
+
+  if (JS_DefinePropertyValue(ctx, sandbox, atom, holder, 0) < 0) {
+    JS_FreeValue(ctx, sandbox);
+    return JS_EXCEPTION;
+  }
+  return sandbox;
 }
 
-// VM Script constructor
-static JSValue js_vm_script_ctor(JSContext* ctx, JSValueConst new_target, int argc, JSValueConst* argv) {
-  JSValue code;
-  JSValue options = JS_UNDEFINED;
+// Copy own enumerable string-keyed properties of from onto to
+static int js_vm_copy_properties(JSContext* from_ctx, JSValueConst from, JSContext* to_ctx, JSValueConst to) {
+  JSPropertyEnum* props;
+  uint32_t count;
+  if (JS_GetOwnPropertyNames(from_ctx, &props, &count, from, JS_GPN_STRING_MASK | JS_GPN_ENUM_ONLY) < 0) {
+    return -1;
+  }
 
-  if (argc < 1) {
-    return JS_ThrowTypeError(ctx, "Script constructor requires at least code argument");
+  int ret = 0;
+  for (uint32_t i = 0; i < count; i++) {
+    JSValue value = JS_GetProperty(from_ctx, from, props[i].atom);
+    if (JS_IsException(value) || JS_SetProperty(to_ctx, to, props[i].atom, value) < 0) {
+      ret = -1;
+      break;
+    }
   }
 
-  code = argv[0];
-  if (!JS_IsString(code)) {
-    return JS_ThrowTypeError(ctx, "Script code must be a string");
+  for (uint32_t i = 0; i < count; i++) {
+    JS_FreeAtom(from_ctx, props[i].atom);
   }
+  js_free(from_ctx, props);
+  return ret;
+}
 
-  if (argc > 1) {
-    options = argv[1];
+/**
+ * Get the script's bytecode bound to ctx (new reference). The bytecode of the
+ * compiling context is used directly; for other contexts the serialized form
+ * is read into them, and the result for the most recent one is kept.
+ */
+static JSValue js_vm_script_bytecode(JSContext* ctx, JSVMScript* script) {
+  if (ctx == script->ctx) {
+    return JS_DupValue(ctx, script->bytecode);
+  }
+  if (ctx == script->last_ctx) {
+    return JS_DupValue(ctx, script->last_bytecode);
   }
 
-  JSValue script_obj = JS_NewObjectClass(ctx, 1);
-  if (JS_IsException(script_obj)) {
-    return script_obj;
+  if (!script->serialized) {
+    script->serialized =
+        JS_WriteObject(script->ctx, &script->serialized_size, script->bytecode, JS_WRITE_OBJ_BYTECODE);
+    if (!script->serialized) {
+      return JS_EXCEPTION;
+    }
   }
 
-  // Store code and options
-  JS_SetPropertyStr(ctx, script_obj, "code", JS_DupValue(ctx, code));
-  if (!JS_IsUndefined(options)) {
-    JS_SetPropertyStr(ctx, script_obj, "options", JS_DupValue(ctx, options));
+  JSValue bytecode = JS_ReadObject(ctx, script->serialized, script->serialized_size, JS_READ_OBJ_BYTECODE);
+  if (JS_IsException(bytecode)) {
+    return bytecode;
   }
 
-  // Set methods on the Script object
-  JS_SetPropertyStr(ctx, script_obj, "runInContext",
-                    JS_NewCFunction(ctx, js_vm_script_runInContext, "runInContext", 1));
-  JS_SetPropertyStr(ctx, script_obj, "runInNewContext",
-                    JS_NewCFunction(ctx, js_vm_script_runInNewContext, "runInNewContext", 0));
-  JS_SetPropertyStr(ctx, script_obj, "runInThisContext",
-                    JS_NewCFunction(ctx, js_vm_script_runInThisContext, "runInThisContext", 0));
+  JS_FreeValue(ctx, script->last_bytecode);
+  script->last_ctx = ctx;
+  script->last_bytecode = JS_DupValue(ctx, bytecode);
+  return bytecode;
+}
 
-  return script_obj;
+// Run the script as global code of target_ctx
+static JSValue js_vm_script_run(JSContext* target_ctx, JSVMScript* script) {
+  JSValue bytecode = js_vm_script_bytecode(target_ctx, script);
+  if (JS_IsException(bytecode)) {
+    return bytecode;
+  }
+  return JS_EvalFunction(target_ctx, bytecode);
 }
 
-// Run compiled script in context
-static JSValue js_vm_script_runInContext(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
-  JSValue script_code = JS_GetPropertyStr(ctx, this_val, "code");
-  if (JS_IsException(script_code)) {
+// Run code (a JSVMScript, or source if script is NULL) in a contextified sandbox
+static JSValue js_vm_run_in_sandbox(JSContext* ctx, JSVMScript* script, const char* source, size_t source_len,
+                                    const char* filename, JSValueConst sandbox) {
+  JSVMContext* context = js_vm_get_context(ctx, sandbox);
+  if (!context) {
+    return JS_ThrowTypeError(ctx, "The \"contextifiedObject\" argument must be a vm.Context");
+  }
+
+  JSContext* vm_ctx = context->ctx;
+  JSValue global = JS_GetGlobalObject(vm_ctx);
+  if (js_vm_copy_properties(ctx, sandbox, vm_ctx, global) < 0) {
+    JS_FreeValue(vm_ctx, global);
     return JS_EXCEPTION;
   }
 
-  JSValue context_obj;
-  if (argc > 0) {
-    context_obj = argv[0];
+  JSValue result;
+  if (script) {
+    result = js_vm_script_run(vm_ctx, script);
   } else {
-    JS_FreeValue(ctx, script_code);
-    return JS_ThrowTypeError(ctx, "runInContext requires a context argument");
+    result = JS_Eval(vm_ctx, source, source_len, filename ? filename : "evalmachine.<anonymous>", JS_EVAL_TYPE_GLOBAL);
   }
 
-  JSValue sandbox = JS_GetPropertyStr(ctx, context_obj, "sandbox");
-  if (JS_IsException(sandbox)) {
-    JS_FreeValue(ctx, script_code);
-    return JS_EXCEPTION;
+  // Globals the script created or changed are visible on the sandbox, even if it threw
+  JSValue exception = JS_UNDEFINED;
+  if (JS_IsException(result)) {
+    exception = JS_GetException(vm_ctx);
   }
+  int copied = js_vm_copy_properties(vm_ctx, global, ctx, sandbox);
+  JS_FreeValue(vm_ctx, global);
 
-  // Execute code in sandbox context
-  const char* code_str = JS_ToCString(ctx, script_code);
-  if (!code_str) {
-    JS_FreeValue(ctx, script_code);
-    JS_FreeValue(ctx, sandbox);
+  if (!JS_IsUndefined(exception)) {
+    return JS_Throw(ctx, exception);
+  }
+  if (copied < 0) {
+    JS_FreeValue(ctx, result);
     return JS_EXCEPTION;
   }
+  return result;
+}
 
-  // Create new context with sandbox as globalThis
-  JSValue result = JS_Eval(ctx, code_str, strlen(code_str), "vm_script", JS_EVAL_TYPE_GLOBAL);
-
-  JS_FreeCString(ctx, code_str);
-  JS_FreeValue(ctx, script_code);
-  JS_FreeValue(ctx, sandbox);
+// vm.createContext([contextObject[, options]])
+static JSValue js_vm_createContext(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
+  return js_vm_contextify(ctx, argc > 0 ? argv[0] : JS_UNDEFINED);
+}
 
-  return result;
+// vm.isContext(object)
+static JSValue js_vm_isContext(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
+  if (argc < 1 || !JS_IsObject(argv[0])) {
+    return JS_ThrowTypeError(ctx, "The \"object\" argument must be of type object");
+  }
+  return JS_NewBool(ctx, js_vm_get_context(ctx, argv[0]) != NULL);
 }
 
-// Run script in new context
-static JSValue js_vm_script_runInNewContext(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
-  JSValue script_code = JS_GetPropertyStr(ctx, this_val, "code");
-  if (JS_IsException(script_code)) {
+// VM Script constructor: new vm.Script(code[, options])
+static JSValue js_vm_script_ctor(JSContext* ctx, JSValueConst new_target, int argc, JSValueConst* argv) {
+  JSValue options = JS_UNDEFINED;
+
+  if (argc < 1) {
+    return JS_ThrowTypeError(ctx, "Script constructor requires at least code argument");
+  }
+
+  if (!JS_IsString(argv[0])) {
+    return JS_ThrowTypeError(ctx, "Script code must be a string");
+  }
+
+  if (argc > 1) {
+    options = argv[1];
+  }
+
+  size_t source_len;
+  const char* source = JS_ToCStringLen(ctx, &source_len, argv[0]);
+  if (!source) {
     return JS_EXCEPTION;
   }
 
-  JSValue sandbox = JS_UNDEFINED;
-  if (argc > 0 && !JS_IsUndefined(argv[0]) && !JS_IsNull(argv[0])) {
-    sandbox = argv[0];
+  JSVMScript* script = js_mallocz(ctx, sizeof(JSVMScript));
+  if (!script) {
+    JS_FreeCString(ctx, source);
+    return JS_EXCEPTION;
+  }
+  script->ctx = ctx;
+  script->bytecode = JS_UNDEFINED;
+  script->last_bytecode = JS_UNDEFINED;
+  script->source_hash = js_vm_hash_source(source, source_len);
+
+  JSValue script_obj;
+  if (JS_IsUndefined(new_target)) {
+    script_obj = JS_NewObjectClass(ctx, js_vm_script_class_id);
   } else {
-    sandbox = JS_NewObject(ctx);
+    JSValue proto = JS_GetPropertyStr(ctx, new_target, "prototype");
+    script_obj = JS_NewObjectProtoClass(ctx, proto, js_vm_script_class_id);
+    JS_FreeValue(ctx, proto);
+  }
+  if (JS_IsException(script_obj)) {
+    js_free(ctx, script);
+    JS_FreeCString(ctx, source);
+    return script_obj;
+  }
+  JS_SetOpaque(script_obj, script);
+
+  // Use cachedData if it was produced for this source by this QuickJS version
+  JSValue cached_data = JS_IsObject(options) ? JS_GetPropertyStr(ctx, options, "cachedData") : JS_UNDEFINED;
+  if (!JS_IsUndefined(cached_data)) {
+    size_t cached_len = 0;
+    uint8_t* cached = js_vm_get_bytes(ctx, cached_data, &cached_len);
+    uint64_t cached_hash = 0;
+    bool valid = cached && cached_len > VM_CACHED_DATA_HEADER_SIZE && memcmp(cached, VM_CACHED_DATA_MAGIC, 8) == 0;
+    if (valid) {
+      memcpy(&cached_hash, cached + 8, sizeof(cached_hash));
+    }
+    if (valid && cached_hash == script->source_hash) {
+      uint8_t digest[JSRT_SHA256_DIGEST_LENGTH];
+      JSRT_Sha256Digest(cached + VM_CACHED_DATA_HEADER_SIZE, cached_len - VM_CACHED_DATA_HEADER_SIZE, digest);
+      valid = memcmp(digest, cached + VM_CACHED_DATA_DIGEST_OFFSET, sizeof(digest)) == 0;
+    }
+    if (valid && cached_hash == script->source_hash) {
+      JSValue bytecode = JS_ReadObject(ctx, cached + VM_CACHED_DATA_HEADER_SIZE,
+                                       cached_len - VM_CACHED_DATA_HEADER_SIZE, JS_READ_OBJ_BYTECODE);
+      if (JS_IsException(bytecode)) {
+        JS_FreeValue(ctx, JS_GetException(ctx));
+      } else {
+        script->bytecode = bytecode;
+      }
+    }
+    JS_SetPropertyStr(ctx, script_obj, "cachedDataRejected", JS_NewBool(ctx, JS_IsUndefined(script->bytecode)));
   }
+  JS_FreeValue(ctx, cached_data);
+
+  if (JS_IsUndefined(script->bytecode)) {
+    const char* filename = js_vm_get_filename(ctx, options);
+    script->bytecode = JS_Eval(ctx, source, source_len, filename ? filename : "evalmachine.<anonymous>",
+                               JS_EVAL_TYPE_GLOBAL | JS_EVAL_FLAG_COMPILE_ONLY);
+    if (filename) {
+      JS_FreeCString(ctx, filename);
+    }
+  }
+  JS_FreeCString(ctx, source);
 
-  const char* code_str = JS_ToCString(ctx, script_code);
-  if (!code_str) {
-    JS_FreeValue(ctx, script_code);
+  if (JS_IsException(script->bytecode)) {
+    script->bytecode = JS_UNDEFINED;
+    JS_FreeValue(ctx, script_obj);
     return JS_EXCEPTION;
   }
 
-  // Evaluate code with sandbox as global scope
-  JSValue result = JS_Eval(ctx, code_str, strlen(code_str), "vm_script", JS_EVAL_TYPE_GLOBAL);
+  if (JS_IsObject(options)) {
+    JSValue produce = JS_GetPropertyStr(ctx, options, "produceCachedData");
+    if (JS_ToBool(ctx, produce)) {
+      JSValue create = JS_GetPropertyStr(ctx, script_obj, "createCachedData");
+      JSValue data = JS_Call(ctx, create, script_obj, 0, NULL);
+      JS_FreeValue(ctx, create);
+      bool produced = !JS_IsException(data);
+      if (produced) {
+        JS_SetPropertyStr(ctx, script_obj, "cachedData", data);
+      } else {
+        JS_FreeValue(ctx, JS_GetException(ctx));
+      }
+      JS_SetPropertyStr(ctx, script_obj, "cachedDataProduced", JS_NewBool(ctx, produced));
+    }
+    JS_FreeValue(ctx, produce);
+  }
 
-  JS_FreeCString(ctx, code_str);
-  JS_FreeValue(ctx, script_code);
+  return script_obj;
+}
 
-  return result;
+static void js_vm_free_array_buffer(JSRuntime* rt, void* opaque, void* ptr) {
+  free(ptr);
 }
 
-// Run script in current context (this global)
-static JSValue js_vm_script_runInThisContext(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
-  JSValue script_code = JS_GetPropertyStr(ctx, this_val, "code");
-  if (JS_IsException(script_code)) {
+// script.createCachedData()
+static JSValue js_vm_script_createCachedData(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
+  JSVMScript* script = JS_GetOpaque2(ctx, this_val, js_vm_script_class_id);
+  if (!script) {
     return JS_EXCEPTION;
   }
 
-  const char* code_str = JS_ToCString(ctx, script_code);
-  if (!code_str) {
-    JS_FreeValue(ctx, script_code);
+  size_t bytecode_size;
+  uint8_t* bytecode = JS_WriteObject(script->ctx, &bytecode_size, script->bytecode, JS_WRITE_OBJ_BYTECODE);
+  if (!bytecode) {
     return JS_EXCEPTION;
   }
 
-  JSValue result = JS_Eval(ctx, code_str, strlen(code_str), "vm_script", JS_EVAL_TYPE_GLOBAL);
+  size_t size = VM_CACHED_DATA_HEADER_SIZE + bytecode_size;
+  uint8_t* data = malloc(size);
+  if (!data) {
+    js_free(script->ctx, bytecode);
+    return JS_ThrowOutOfMemory(ctx);
+  }
+  memcpy(data, VM_CACHED_DATA_MAGIC, 8);
+  memcpy(data + 8, &script->source_hash, sizeof(script->source_hash));
+  JSRT_Sha256Digest(bytecode, bytecode_size, data + VM_CACHED_DATA_DIGEST_OFFSET);
+  memcpy(data + VM_CACHED_DATA_HEADER_SIZE, bytecode, bytecode_size);
+  js_free(script->ctx, bytecode);
+
+  JSValue array_buffer = JS_NewArrayBuffer(ctx, data, size, js_vm_free_array_buffer, NULL, false);
+  if (JS_IsException(array_buffer)) {
+    free(data);
+    return array_buffer;
+  }
+  JSValue buffer = jsrt_node_buffer_view(ctx, array_buffer, 0, size);
+  JS_FreeValue(ctx, array_buffer);
+  return buffer;
+}
 
-  JS_FreeCString(ctx, code_str);
-  JS_FreeValue(ctx, script_code);
+// script.runInContext(contextifiedObject[, options])
+static JSValue js_vm_script_runInContext(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
+  JSVMScript* script = JS_GetOpaque2(ctx, this_val, js_vm_script_class_id);
+  if (!script) {
+    return JS_EXCEPTION;
+  }
+  if (argc < 1) {
+    return JS_ThrowTypeError(ctx, "runInContext requires a context argument");
+  }
+  return js_vm_run_in_sandbox(ctx, script, NULL, 0, NULL, argv[0]);
+}
+
+// script.runInNewContext([contextObject[, options]])
+static JSValue js_vm_script_runInNewContext(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
+  JSVMScript* script = JS_GetOpaque2(ctx, this_val, js_vm_script_class_id);
+  if (!script) {
+    return JS_EXCEPTION;
+  }
 
+  JSValue sandbox = js_vm_contextify(ctx, argc > 0 ? argv[0] : JS_UNDEFINED);
+  if (JS_IsException(sandbox)) {
+    return sandbox;
+  }
+  JSValue result = js_vm_run_in_sandbox(ctx, script, NULL, 0, NULL, sandbox);
+  JS_FreeValue(ctx, sandbox);
   return result;
 }
 
+// script.runInThisContext([options])
+static JSValue js_vm_script_runInThisContext(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
+  JSVMScript* script = JS_GetOpaque2(ctx, this_val, js_vm_script_class_id);
+  if (!script) {
+    return JS_EXCEPTION;
+  }
+  return js_vm_script_run(ctx, script);
+}
+
 // Create script from code
 static JSValue js_vm_createScript(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
-  JSValue code;
-  JSValue options = JS_UNDEFINED;
-
   if (argc < 1) {
     return JS_ThrowTypeError(ctx, "createScript requires code argument");
   }
 
-  code = argv[0];
-  if (!JS_IsString(code)) {
-    return JS_ThrowTypeError(ctx, "Script code must be a string");
+  // Use Script constructor
+  JSValue args[2] = {argv[0], argc > 1 ? argv[1] : JS_UNDEFINED};
+  return js_vm_script_ctor(ctx, JS_UNDEFINED, 2, args);
+}
+
+// vm.runInContext(code, contextifiedObject[, options]), vm.runInNewContext(code[, contextObject[, options]])
+static JSValue js_vm_run_code(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv, int new_context) {
+  if (argc < 1 || !JS_IsString(argv[0])) {
+    return JS_ThrowTypeError(ctx, "The \"code\" argument must be of type string");
   }
 
-  if (argc > 1) {
-    options = argv[1];
+  JSValue sandbox;
+  if (new_context) {
+    sandbox = js_vm_contextify(ctx, argc > 1 ? argv[1] : JS_UNDEFINED);
+    if (JS_IsException(sandbox)) {
+      return sandbox;
+    }
+  } else if (argc > 1) {
+    sandbox = JS_DupValue(ctx, argv[1]);
+  } else {
+    return JS_ThrowTypeError(ctx, "runInContext requires a context argument");
   }
 
-  // Use Script constructor
-  JSValue args[2] = {code, options};
-  return js_vm_script_ctor(ctx, JS_UNDEFINED, 2, args);
+  size_t source_len;
+  const char* source = JS_ToCStringLen(ctx, &source_len, argv[0]);
+  const char* filename = argc > 2 ? js_vm_get_filename(ctx, argv[2]) : NULL;
+  JSValue result = source ? js_vm_run_in_sandbox(ctx, NULL, source, source_len, filename, sandbox) : JS_EXCEPTION;
+
+  if (filename) {
+    JS_FreeCString(ctx, filename);
+  }
+  if (source) {
+    JS_FreeCString(ctx, source);
+  }
+  JS_FreeValue(ctx, sandbox);
+  return result;
+}
+
+// vm.runInThisContext(code[, options])
+static JSValue js_vm_runInThisContext(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
+  if (argc < 1 || !JS_IsString(argv[0])) {
+    return JS_ThrowTypeError(ctx, "The \"code\" argument must be of type string");
+  }
+
+  size_t source_len;
+  const char* source = JS_ToCStringLen(ctx, &source_len, argv[0]);
+  if (!source) {
+    return JS_EXCEPTION;
+  }
+  const char* filename = argc > 1 ? js_vm_get_filename(ctx, argv[1]) : NULL;
+
+  JSValue result =
+      JS_Eval(ctx, source, source_len, filename ? filename : "evalmachine.<anonymous>", JS_EVAL_TYPE_GLOBAL);
+
+  if (filename) {
+    JS_FreeCString(ctx, filename);
+  }
+  JS_FreeCString(ctx, source);
+  return result;
 }
 
 // VM module initialization (CommonJS)
 JSValue JSRT_InitNodeVM(JSContext* ctx) {
+  JSRuntime* rt = JS_GetRuntime(ctx);
   JSValue vm_obj = JS_NewObject(ctx);
 
+  // Register classes
+  JS_NewClassID(&js_vm_script_class_id);
+  JS_NewClassID(&js_vm_context_class_id);
+  if (!JS_IsRegisteredClass(rt, js_vm_script_class_id)) {
+    JS_NewClass(rt, js_vm_script_class_id, &js_vm_script_class);
+  }
+  if (!JS_IsRegisteredClass(rt, js_vm_context_class_id)) {
+    JS_NewClass(rt, js_vm_context_class_id, &js_vm_context_class);
+  }
+
   // Script constructor
   JSValue script_ctor = JS_NewCFunction2(ctx, js_vm_script_ctor, "Script", 2, JS_CFUNC_constructor, 0);
   JS_SetPropertyStr(ctx, vm_obj, "Script", script_ctor);
@@ -198,11 +613,20 @@ JSValue JSRT_InitNodeVM(JSContext* ctx) {
                     JS_NewCFunction(ctx, js_vm_script_runInNewContext, "runInNewContext", 0));
   JS_SetPropertyStr(ctx, script_proto, "runInThisContext",
                     JS_NewCFunction(ctx, js_vm_script_runInThisContext, "runInThisContext", 0));
-  JS_FreeValue(ctx, script_proto);
+  JS_SetPropertyStr(ctx, script_proto, "createCachedData",
+                    JS_NewCFunction(ctx, js_vm_script_createCachedData, "createCachedData", 0));
+  JS_SetClassProto(ctx, js_vm_script_class_id, script_proto);
 
   // VM functions
   JS_SetPropertyStr(ctx, vm_obj, "createContext", JS_NewCFunction(ctx, js_vm_createContext, "createContext", 1));
+  JS_SetPropertyStr(ctx, vm_obj, "isContext", JS_NewCFunction(ctx, js_vm_isContext, "isContext", 1));
   JS_SetPropertyStr(ctx, vm_obj, "createScript", JS_NewCFunction(ctx, js_vm_createScript, "createScript", 1));
+  JS_SetPropertyStr(ctx, vm_obj, "runInContext",
+                    JS_NewCFunctionMagic(ctx, js_vm_run_code, "runInContext", 2, JS_CFUNC_generic_magic, 0));
+  JS_SetPropertyStr(ctx, vm_obj, "runInNewContext",
+                    JS_NewCFunctionMagic(ctx, js_vm_run_code, "runInNewContext", 1, JS_CFUNC_generic_magic, 1));
+  JS_SetPropertyStr(ctx, vm_obj, "runInThisContext",
+                    JS_NewCFunction(ctx, js_vm_runInThisContext, "runInThisContext", 1));
 
   // Add Node.js compatibility constants
   JSValue constants_obj = JS_NewObject(ctx);
@@ -223,9 +647,21 @@ int js_node_vm_init(JSContext* ctx, JSModuleDef* m) {
   // Add exports
   JS_SetModuleExport(ctx, m, "Script", JS_GetPropertyStr(ctx, vm_obj, "Script"));
   JS_SetModuleExport(ctx, m, "createContext", JS_GetPropertyStr(ctx, vm_obj, "createContext"));
+  JS_SetModuleExport(ctx, m, "isContext", JS_GetPropertyStr(ctx, vm_obj, "isContext"));
   JS_SetModuleExport(ctx, m, "createScript", JS_GetPropertyStr(ctx, vm_obj, "createScript"));
+  JS_SetModuleExport(ctx, m, "runInContext", JS_GetPropertyStr(ctx, vm_obj, "runInContext"));
+  JS_SetModuleExport(ctx, m, "runInNewContext", JS_GetPropertyStr(ctx, vm_obj, "runInNewContext"));
+  JS_SetModuleExport(ctx, m, "runInThisContext", JS_GetPropertyStr(ctx, vm_obj, "runInThisContext"));
   JS_SetModuleExport(ctx, m, "default", JS_DupValue(ctx, vm_obj));
 
   JS_FreeValue(ctx, vm_obj);
   return 0;
-}
\ No newline at end of file
+}
+
+// Release the vm state of the runtime running on the current thread
+void jsrt_vm_cleanup(JSContext* ctx) {
+  if (g_vm_context_atom != JS_ATOM_NULL) {
+    JS_FreeAtom(ctx, g_vm_context_atom);
+    g_vm_context_atom = JS_ATOM_NULL;
+  }
+}
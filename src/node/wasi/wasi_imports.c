@@ -7,6 +7,7 @@
 
 #include "../../runtime.h"
 #include "../../util/debug.h"
+#include "../../util/macro.h"
 #include "wasi.h"
 
 #include <errno.h>
@@ -690,7 +691,7 @@ static struct {
 } mock_file_storage = {0};
 
 // Store the last resolved host path for file operations
-static char* last_host_path = NULL;
+static JSRT_THREAD_LOCAL char* last_host_path = NULL;
 
 // Store real file handles for file system operations
 static struct {
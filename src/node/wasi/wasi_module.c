@@ -210,9 +210,9 @@ static const JSCFunctionListEntry js_wasi_proto_funcs[] = {
 JSValue JSRT_InitNodeWASI(JSContext* ctx) {
   JSValue wasi_obj = JS_NewObject(ctx);
 
-  // Register WASI class if not already registered
-  if (!jsrt_wasi_class_id) {
-    JS_NewClassID(&jsrt_wasi_class_id);
+  // Register WASI class if not already registered in this runtime
+  JS_NewClassID(&jsrt_wasi_class_id);
+  if (!JS_IsRegisteredClass(JS_GetRuntime(ctx), jsrt_wasi_class_id)) {
     JS_NewClass(JS_GetRuntime(ctx), jsrt_wasi_class_id, &jsrt_wasi_class);
   }
 
@@ -2,241 +2,1609 @@
  * @file worker_threads.c
  * @brief Node.js worker_threads module implementation
  *
- * This is a compatibility shim for the worker_threads module.
- * Since jsrt is a single-threaded runtime, we provide stub implementations
- * that allow packages requiring worker_threads to load without errors.
+ * Every Worker runs on its own OS thread with its own JSRT_Runtime (QuickJS
+ * runtime + libuv loop). The parent and the worker never share JS values:
+ * messages are serialized with JS_WriteObject() into a heap buffer, pushed
+ * onto a mutex-protected queue and announced with uv_async_send() on the
+ * receiving loop, where they are deserialized and emitted as 'message'.
+ *
+ * MessageChannel ports live on a single thread and use the same queue and
+ * uv_async machinery, so delivery is always asynchronous.
  */
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <uv.h>
 
 #include "../../deps/quickjs/quickjs.h"
+#include "../module/module.h"
+#include "../module/resolver/path_util.h"
+#include "../runtime.h"
+#include "../std/clone.h"
+#include "../util/buffer_pin.h"
+#include "../util/file.h"
+#include "../util/macro.h"
+#include "../util/path.h"
+#include "node_modules.h"
+#include "process/process.h"
 #include "util/debug.h"
 #include "worker_threads.h"
 
+// Default JS stack limit for a worker, matching Node's resourceLimits.stackSizeMb
+#define JSRT_WORKER_DEFAULT_STACK_MB 4
+// Native headroom added to the thread stack on top of the JS stack limit
+#define JSRT_WORKER_STACK_HEADROOM (1024 * 1024)
+
 // ============================================================================
-// Worker Class Implementation (Stub)
+// Message queue
 // ============================================================================
 
-// Worker constructor - creates a stub worker object
-static JSValue js_worker_constructor(JSContext* ctx, JSValueConst new_target, int argc, JSValueConst* argv) {
-  JSRT_Debug("Worker constructor called - creating stub worker");
+typedef enum {
+  JSRT_WORKER_MSG_DATA = 0,  // postMessage() payload
+  JSRT_WORKER_MSG_ONLINE,    // worker started executing JS
+  JSRT_WORKER_MSG_ERROR,     // uncaught exception in the worker
+  JSRT_WORKER_MSG_EXIT,      // worker thread finished; always the last message
+} JSRT_WorkerMessageType;
 
-  if (argc < 1) {
-    return JS_ThrowTypeError(ctx, "Worker requires at least 1 argument (script path)");
+typedef struct JSRT_WorkerMessage {
+  struct JSRT_WorkerMessage* next;
+  JSRT_WorkerMessageType type;
+  uint8_t* data;  // JS_WriteObject() output (malloc'd copy), may be NULL
+  size_t size;
+  int exit_code;
+} JSRT_WorkerMessage;
+
+typedef struct {
+  JSRT_WorkerMessage* head;
+  JSRT_WorkerMessage* tail;
+} JSRT_WorkerQueue;
+
+static JSRT_WorkerMessage* jsrt_worker_message_new(JSRT_WorkerMessageType type) {
+  JSRT_WorkerMessage* msg = calloc(1, sizeof(JSRT_WorkerMessage));
+  if (msg) {
+    msg->type = type;
   }
+  return msg;
+}
 
-  // Create worker object
-  JSValue worker_obj = JS_NewObject(ctx);
-  if (JS_IsException(worker_obj)) {
-    return JS_EXCEPTION;
+static void jsrt_worker_message_free(JSRT_WorkerMessage* msg) {
+  if (msg) {
+    free(msg->data);
+    free(msg);
   }
+}
 
-  // Get the script path (first argument)
-  const char* script_path = JS_ToCString(ctx, argv[0]);
-  if (!script_path) {
-    JS_FreeValue(ctx, worker_obj);
-    return JS_ThrowTypeError(ctx, "Invalid script path");
+static void jsrt_worker_queue_push(JSRT_WorkerQueue* queue, JSRT_WorkerMessage* msg) {
+  msg->next = NULL;
+  if (queue->tail) {
+    queue->tail->next = msg;
+  } else {
+    queue->head = msg;
   }
+  queue->tail = msg;
+}
 
-  // Store basic properties (stub implementation)
-  JS_SetPropertyStr(ctx, worker_obj, "threadId", JS_NewInt32(ctx, 1));
-  JS_SetPropertyStr(ctx, worker_obj, "resourceLimits", JS_NULL);
-  JS_SetPropertyStr(ctx, worker_obj, "env", JS_NewObject(ctx));
-  JS_SetPropertyStr(ctx, worker_obj, "eval", JS_NewBool(ctx, 0));
-  JS_SetPropertyStr(ctx, worker_obj, "stdin", JS_NewBool(ctx, 1));
-  JS_SetPropertyStr(ctx, worker_obj, "stdout", JS_NewBool(ctx, 1));
-  JS_SetPropertyStr(ctx, worker_obj, "stderr", JS_NewBool(ctx, 1));
+// Detach the whole queue; the caller owns the returned list
+static JSRT_WorkerMessage* jsrt_worker_queue_take(JSRT_WorkerQueue* queue) {
+  JSRT_WorkerMessage* head = queue->head;
+  queue->head = NULL;
+  queue->tail = NULL;
+  return head;
+}
 
-  // Create stub event emitter functionality
-  JSValue listeners_obj = JS_NewObject(ctx);
-  JS_SetPropertyStr(ctx, worker_obj, "_listeners", listeners_obj);
+static void jsrt_worker_queue_clear(JSRT_WorkerQueue* queue) {
+  JSRT_WorkerMessage* msg = jsrt_worker_queue_take(queue);
+  while (msg) {
+    JSRT_WorkerMessage* next = msg->next;
+    jsrt_worker_message_free(msg);
+    msg = next;
+  }
+}
 
-  JS_FreeCString(ctx, script_path);
-  JSRT_Debug("Stub worker created successfully");
+// Serialize a value into a message payload. Returns false with a pending exception
+// when the value cannot be cloned (functions, symbols, host objects...).
+static bool jsrt_worker_serialize(JSContext* ctx, JSValueConst value, JSRT_WorkerMessage* msg) {
+  size_t size = 0;
+  uint8_t* buf = JS_WriteObject(ctx, &size, value, JS_WRITE_OBJ_REFERENCE);
+  if (!buf) {
+    return false;
+  }
 
-  return worker_obj;
+  msg->data = malloc(size > 0 ? size : 1);
+  if (!msg->data) {
+    js_free(ctx, buf);
+    JS_ThrowOutOfMemory(ctx);
+    return false;
+  }
+  memcpy(msg->data, buf, size);
+  msg->size = size;
+  js_free(ctx, buf);
+  return true;
 }
 
-// Worker.postMessage() - stub implementation
-static JSValue js_worker_post_message(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
-  JSRT_Debug("Worker.postMessage called - stub implementation");
+static JSValue jsrt_worker_deserialize(JSContext* ctx, const uint8_t* data, size_t size) {
+  if (!data) {
+    return JS_UNDEFINED;
+  }
+  return JS_ReadObject(ctx, data, size, JS_READ_OBJ_REFERENCE);
+}
 
-  // In a real implementation, this would serialize and send the message
-  // For our stub, we just acknowledge the message
+// ============================================================================
+// Shared state between a parent Worker object and its thread
+// ============================================================================
 
-  return JS_UNDEFINED;
+typedef struct {
+  uv_mutex_t lock;  // guards the queues and the async pointers below
+
+  int thread_id;
+  char* filename;   // absolute script path (NULL when eval)
+  char* eval_code;  // source for { eval: true }
+  uint8_t* worker_data;
+  size_t worker_data_size;
+  uint8_t* env_data;  // snapshot of the parent's environment data
+  size_t env_data_size;
+
+  size_t memory_limit;  // bytes, 0 = unlimited
+  size_t stack_size;    // JS stack limit in bytes
+  int max_old_mb;
+  int max_young_mb;
+  int code_range_mb;
+  int stack_mb;
+
+  JSRT_WorkerQueue to_worker;
+  JSRT_WorkerQueue to_parent;
+  uv_async_t* worker_async;  // set by the worker thread while its loop is alive
+  uv_async_t* parent_async;  // valid until the parent joins the thread
+
+  volatile int terminate_requested;
+  uv_thread_t tid;
+} JSRT_WorkerShared;
+
+static void jsrt_worker_shared_free(JSRT_WorkerShared* shared) {
+  if (!shared) {
+    return;
+  }
+  jsrt_worker_queue_clear(&shared->to_worker);
+  jsrt_worker_queue_clear(&shared->to_parent);
+  free(shared->filename);
+  free(shared->eval_code);
+  free(shared->worker_data);
+  free(shared->env_data);
+  uv_mutex_destroy(&shared->lock);
+  free(shared);
+}
+
+static void jsrt_worker_post_to_parent(JSRT_WorkerShared* shared, JSRT_WorkerMessage* msg) {
+  uv_mutex_lock(&shared->lock);
+  jsrt_worker_queue_push(&shared->to_parent, msg);
+  uv_async_send(shared->parent_async);
+  uv_mutex_unlock(&shared->lock);
 }
 
-// Callback function for promise resolution
-static JSValue js_promise_resolver(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
-  if (argc > 0 && JS_IsFunction(ctx, argv[0])) {
-    JS_Call(ctx, argv[0], JS_UNDEFINED, 0, NULL);
+static void jsrt_worker_post_to_worker(JSRT_WorkerShared* shared, JSRT_WorkerMessage* msg) {
+  uv_mutex_lock(&shared->lock);
+  jsrt_worker_queue_push(&shared->to_worker, msg);
+  if (shared->worker_async) {
+    uv_async_send(shared->worker_async);
   }
-  return JS_UNDEFINED;
+  uv_mutex_unlock(&shared->lock);
 }
 
-// Worker.terminate() - stub implementation
-static JSValue js_worker_terminate(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
-  JSRT_Debug("Worker.terminate called - stub implementation");
+static int next_thread_id = 1;
+static uv_mutex_t next_thread_id_lock;
+static uv_once_t next_thread_id_once = UV_ONCE_INIT;
 
-  // In a real implementation, this would terminate the worker thread
-  // For our stub, we just return a resolved Promise
-  JSValue promise = JS_NewObject(ctx);
-  JS_SetPropertyStr(ctx, promise, "then", JS_NewCFunction(ctx, js_promise_resolver, "then", 1));
+static void jsrt_worker_init_thread_id_lock(void) {
+  uv_mutex_init(&next_thread_id_lock);
+}
 
-  return promise;
+static int jsrt_worker_alloc_thread_id(void) {
+  uv_once(&next_thread_id_once, jsrt_worker_init_thread_id_lock);
+  uv_mutex_lock(&next_thread_id_lock);
+  int id = next_thread_id++;
+  uv_mutex_unlock(&next_thread_id_lock);
+  return id;
+}
+
+// ============================================================================
+// Per-thread state
+// ============================================================================
+
+typedef struct JSRT_MessagePort JSRT_MessagePort;
+
+// State of the runtime running inside a worker thread
+typedef struct {
+  JSRT_WorkerShared* shared;
+  JSRT_Runtime* rt;
+  uv_async_t async;         // wakes the worker loop for messages and terminate()
+  JSRT_MessagePort* port;   // parentPort, created when the module is first loaded
+  bool exit_requested;      // process.exit() was called
+  bool failed;              // an uncaught exception ended the worker
+  int exit_code;
+} JSRT_WorkerThreadState;
+
+typedef struct JSRT_WorkerHandle JSRT_WorkerHandle;
+
+// NULL on the main thread
+static JSRT_THREAD_LOCAL JSRT_WorkerThreadState* current_worker = NULL;
+// Live Worker objects and MessagePorts created by this thread's runtime
+static JSRT_THREAD_LOCAL JSRT_WorkerHandle* live_workers = NULL;
+static JSRT_THREAD_LOCAL JSRT_MessagePort* live_ports = NULL;
+// Backing object for get/setEnvironmentData()
+static JSRT_THREAD_LOCAL JSValue environment_data;
+static JSRT_THREAD_LOCAL bool environment_data_ready = false;
+
+bool jsrt_worker_is_worker_thread(void) {
+  return current_worker != NULL;
 }
 
-// Worker.addEventListener() - stub implementation
-static JSValue js_worker_add_event_listener(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
-  if (argc < 2) {
-    return JS_ThrowTypeError(ctx, "addEventListener requires at least 2 arguments");
+// ============================================================================
+// Helpers
+// ============================================================================
+
+static JSValue jsrt_worker_event_emitter_proto(JSContext* ctx) {
+  JSValue proto = JS_UNDEFINED;
+  JSValue events_module = JSRT_LoadNodeModuleCommonJS(ctx, "events");
+  if (JS_IsException(events_module)) {
+    JS_FreeValue(ctx, JS_GetException(ctx));
+    return JS_NewObject(ctx);
   }
+  JSValue event_emitter = JS_GetPropertyStr(ctx, events_module, "EventEmitter");
+  if (JS_IsFunction(ctx, event_emitter)) {
+    proto = JS_GetPropertyStr(ctx, event_emitter, "prototype");
+  }
+  JS_FreeValue(ctx, event_emitter);
+  JS_FreeValue(ctx, events_module);
+  if (!JS_IsObject(proto)) {
+    JS_FreeValue(ctx, proto);
+    return JS_NewObject(ctx);
+  }
+  return proto;
+}
 
-  const char* event_type = JS_ToCString(ctx, argv[0]);
-  if (!event_type) {
-    return JS_ThrowTypeError(ctx, "Invalid event type");
+// Call obj.emit(event, ...args); returns the call result (may be JS_EXCEPTION)
+static JSValue jsrt_worker_emit(JSContext* ctx, JSValueConst obj, const char* event, int argc, JSValueConst* args) {
+  JSValue emit = JS_GetPropertyStr(ctx, obj, "emit");
+  if (!JS_IsFunction(ctx, emit)) {
+    JS_FreeValue(ctx, emit);
+    return JS_UNDEFINED;
   }
 
-  JSValue listener = argv[1];
-  if (!JS_IsFunction(ctx, listener)) {
-    JS_FreeCString(ctx, event_type);
-    return JS_ThrowTypeError(ctx, "Listener must be a function");
+  JSValue call_args[2];
+  call_args[0] = JS_NewString(ctx, event);
+  int call_argc = 1;
+  if (argc > 0) {
+    call_args[1] = args[0];
+    call_argc = 2;
   }
+  JSValue result = JS_Call(ctx, emit, obj, call_argc, call_args);
+  JS_FreeValue(ctx, call_args[0]);
+  JS_FreeValue(ctx, emit);
+  return result;
+}
 
-  // Get or create listeners array for this event type
-  JSValue listeners = JS_GetPropertyStr(ctx, this_val, "_listeners");
-  JSValue event_listeners = JS_GetPropertyStr(ctx, listeners, event_type);
+static int jsrt_worker_listener_count(JSContext* ctx, JSValueConst obj, const char* event) {
+  JSValue fn = JS_GetPropertyStr(ctx, obj, "listenerCount");
+  int count = 0;
+  if (JS_IsFunction(ctx, fn)) {
+    JSValue name = JS_NewString(ctx, event);
+    JSValue result = JS_Call(ctx, fn, obj, 1, &name);
+    if (JS_IsException(result)) {
+      JS_FreeValue(ctx, JS_GetException(ctx));
+    } else {
+      JS_ToInt32(ctx, &count, result);
+    }
+    JS_FreeValue(ctx, result);
+    JS_FreeValue(ctx, name);
+  }
+  JS_FreeValue(ctx, fn);
+  return count;
+}
 
-  if (!JS_IsArray(ctx, event_listeners)) {
-    event_listeners = JS_NewArray(ctx);
-    JS_SetPropertyStr(ctx, listeners, event_type, event_listeners);
+// Run promise jobs and nextTick callbacks queued by a message handler
+static void jsrt_worker_drain_jobs(JSContext* ctx) {
+  JSRT_Runtime* rt = JS_GetContextOpaque(ctx);
+  JSRT_RuntimeDrainMicrotasks(rt);
+}
+
+// Build the { name, message, stack } record sent to the parent for 'error'
+static JSValue jsrt_worker_error_record(JSContext* ctx, JSValueConst error) {
+  JSValue record = JS_NewObject(ctx);
+  if (JS_IsError(ctx, error)) {
+    JS_SetPropertyStr(ctx, record, "name", JS_GetPropertyStr(ctx, error, "name"));
+    JS_SetPropertyStr(ctx, record, "message", JS_GetPropertyStr(ctx, error, "message"));
+    JS_SetPropertyStr(ctx, record, "stack", JS_GetPropertyStr(ctx, error, "stack"));
+  } else {
+    JS_SetPropertyStr(ctx, record, "name", JS_NewString(ctx, "Error"));
+    JS_SetPropertyStr(ctx, record, "message", JS_ToString(ctx, error));
   }
+  return record;
+}
 
-  // Add listener to array
-  JSValue length_val = JS_GetPropertyStr(ctx, event_listeners, "length");
-  int32_t length;
-  JS_ToInt32(ctx, &length, length_val);
-  JS_SetPropertyUint32(ctx, event_listeners, length, JS_DupValue(ctx, listener));
-  JS_FreeValue(ctx, length_val);
+// An exception escaped JS running inside a worker: report it to the parent as
+// 'error' and stop this worker with exit code 1, as Node does.
+static void jsrt_worker_fail(JSRT_WorkerThreadState* state, JSContext* ctx, JSValue exception) {
+  if (state->exit_requested || state->shared->terminate_requested || state->failed) {
+    JS_FreeValue(ctx, exception);
+    return;
+  }
+  state->failed = true;
 
-  JS_FreeValue(ctx, event_listeners);
-  JS_FreeValue(ctx, listeners);
-  JS_FreeCString(ctx, event_type);
+  JSRT_WorkerMessage* msg = jsrt_worker_message_new(JSRT_WORKER_MSG_ERROR);
+  if (msg) {
+    JSValue record = jsrt_worker_error_record(ctx, exception);
+    if (!jsrt_worker_serialize(ctx, record, msg)) {
+      JS_FreeValue(ctx, JS_GetException(ctx));
+    }
+    JS_FreeValue(ctx, record);
+    jsrt_worker_post_to_parent(state->shared, msg);
+  }
+  JS_FreeValue(ctx, exception);
+  JSRT_RuntimeStop(state->rt);
+}
 
-  return JS_UNDEFINED;
+// Route an exception thrown by a 'message' listener
+static void jsrt_worker_report_exception(JSContext* ctx) {
+  JSValue exception = JS_GetException(ctx);
+  if (current_worker) {
+    jsrt_worker_fail(current_worker, ctx, exception);
+  } else {
+    JSRT_RuntimeAddExceptionValue(JS_GetContextOpaque(ctx), exception);
+  }
 }
 
 // ============================================================================
-// MessagePort Helper Functions
+// MessagePort
 // ============================================================================
 
-// MessagePort.close() - stub implementation
+typedef enum {
+  JSRT_PORT_LOCAL = 0,  // one end of a MessageChannel
+  JSRT_PORT_PARENT,     // parentPort inside a worker thread
+} JSRT_MessagePortKind;
+
+struct JSRT_MessagePort {
+  JSRT_MessagePortKind kind;
+  JSContext* ctx;
+  JSValue obj;  // weak; becomes a strong reference while 'held'
+  bool held;    // kept alive because it is referenced and has 'message' listeners
+  bool refed;   // false after port.unref()
+  bool closed;
+  bool close_emitted;
+  bool finalized;
+  bool async_closed;
+  uv_async_t* async;      // &local_async, or the worker thread's async for parentPort
+  uv_async_t local_async;
+  JSRT_MessagePort* peer;  // LOCAL only
+  JSRT_WorkerQueue queue;  // LOCAL only: messages posted by the peer
+  JSRT_MessagePort* next;  // live_ports list
+};
+
+static JSClassID js_message_port_class_id;
+
+static void jsrt_message_port_unlink(JSRT_MessagePort* port) {
+  for (JSRT_MessagePort** p = &live_ports; *p; p = &(*p)->next) {
+    if (*p == port) {
+      *p = port->next;
+      return;
+    }
+  }
+}
+
+static void jsrt_message_port_maybe_free(JSRT_MessagePort* port) {
+  if (port->finalized && port->async_closed) {
+    jsrt_worker_queue_clear(&port->queue);
+    free(port);
+  }
+}
+
+static void jsrt_message_port_on_close(uv_handle_t* handle) {
+  JSRT_MessagePort* port = handle->data;
+  port->async_closed = true;
+  jsrt_message_port_maybe_free(port);
+}
+
+static void js_message_port_finalizer(JSRuntime* rt, JSValue val) {
+  JSRT_MessagePort* port = JS_GetOpaque(val, js_message_port_class_id);
+  if (!port) {
+    return;
+  }
+
+  jsrt_message_port_unlink(port);
+  if (port->peer) {
+    port->peer->peer = NULL;
+    port->peer = NULL;
+  }
+  if (current_worker && current_worker->port == port) {
+    current_worker->port = NULL;
+  }
+
+  port->finalized = true;
+  if (!port->async_closed && !uv_is_closing((uv_handle_t*)&port->local_async)) {
+    uv_close((uv_handle_t*)&port->local_async, jsrt_message_port_on_close);
+  }
+  jsrt_message_port_maybe_free(port);
+}
+
+static JSClassDef js_message_port_class = {
+    "MessagePort",
+    .finalizer = js_message_port_finalizer,
+};
+
+// Keep the loop (and the port object) alive only while the port is open,
+// ref()'d and somebody listens for 'message' - the same rule Node applies.
+static void jsrt_message_port_update_ref(JSRT_MessagePort* port) {
+  JSContext* ctx = port->ctx;
+  bool active = !port->closed && port->refed && jsrt_worker_listener_count(ctx, port->obj, "message") > 0;
+
+  if (active) {
+    uv_ref((uv_handle_t*)port->async);
+    if (!port->held) {
+      port->held = true;
+      JS_DupValue(ctx, port->obj);
+    }
+    // Flush messages that arrived before the first listener was attached
+    uv_async_send(port->async);
+  } else {
+    uv_unref((uv_handle_t*)port->async);
+    if (port->held) {
+      port->held = false;
+      JS_FreeValue(ctx, port->obj);
+    }
+  }
+}
+
+// Deliver queued messages; called on the port's own loop
+static void jsrt_message_port_deliver(JSRT_MessagePort* port) {
+  JSContext* ctx = port->ctx;
+
+  if (port->closed) {
+    if (!port->close_emitted) {
+      port->close_emitted = true;
+      JSValue obj = JS_DupValue(ctx, port->obj);
+      JSValue result = jsrt_worker_emit(ctx, obj, "close", 0, NULL);
+      if (JS_IsException(result)) {
+        jsrt_worker_report_exception(ctx);
+      }
+      JS_FreeValue(ctx, result);
+      JS_FreeValue(ctx, obj);
+      jsrt_worker_drain_jobs(ctx);
+    }
+    return;
+  }
+
+  if (jsrt_worker_listener_count(ctx, port->obj, "message") == 0) {
+    return;
+  }
+
+  JSRT_WorkerMessage* msg;
+  if (port->kind == JSRT_PORT_PARENT) {
+    JSRT_WorkerShared* shared = current_worker->shared;
+    uv_mutex_lock(&shared->lock);
+    msg = jsrt_worker_queue_take(&shared->to_worker);
+    uv_mutex_unlock(&shared->lock);
+  } else {
+    msg = jsrt_worker_queue_take(&port->queue);
+  }
+
+  // Keep the port alive across listener calls that may drop the last reference
+  JSValue obj = JS_DupValue(ctx, port->obj);
+  while (msg) {
+    JSRT_WorkerMessage* next = msg->next;
+    JSValue value = jsrt_worker_deserialize(ctx, msg->data, msg->size);
+    if (JS_IsException(value)) {
+      jsrt_worker_report_exception(ctx);
+    } else {
+      JSValue result = jsrt_worker_emit(ctx, obj, "message", 1, (JSValueConst*)&value);
+      if (JS_IsException(result)) {
+        jsrt_worker_report_exception(ctx);
+      }
+      JS_FreeValue(ctx, result);
+      JS_FreeValue(ctx, value);
+    }
+    jsrt_worker_message_free(msg);
+    msg = next;
+    jsrt_worker_drain_jobs(ctx);
+  }
+  JS_FreeValue(ctx, obj);
+}
+
+static void jsrt_message_port_on_async(uv_async_t* handle) {
+  jsrt_message_port_deliver(handle->data);
+}
+
+static JSValue jsrt_message_port_new(JSContext* ctx, JSRT_MessagePortKind kind, uv_async_t* async) {
+  JSValue obj = JS_NewObjectClass(ctx, js_message_port_class_id);
+  if (JS_IsException(obj)) {
+    return obj;
+  }
+
+  JSRT_MessagePort* port = calloc(1, sizeof(JSRT_MessagePort));
+  if (!port) {
+    JS_FreeValue(ctx, obj);
+    return JS_ThrowOutOfMemory(ctx);
+  }
+  port->kind = kind;
+  port->ctx = ctx;
+  port->obj = obj;
+  port->refed = true;
+
+  if (kind == JSRT_PORT_LOCAL) {
+    JSRT_Runtime* rt = JS_GetContextOpaque(ctx);
+    uv_async_init(rt->uv_loop, &port->local_async, jsrt_message_port_on_async);
+    port->local_async.data = port;
+    uv_unref((uv_handle_t*)&port->local_async);
+    port->async = &port->local_async;
+  } else {
+    // parentPort borrows the worker thread's async handle
+    port->async = async;
+    port->async_closed = true;
+  }
+
+  port->next = live_ports;
+  live_ports = port;
+
+  JS_SetOpaque(obj, port);
+  return obj;
+}
+
+static JSRT_MessagePort* jsrt_message_port_get(JSContext* ctx, JSValueConst this_val) {
+  return JS_GetOpaque2(ctx, this_val, js_message_port_class_id);
+}
+
+static JSValue js_message_port_constructor(JSContext* ctx, JSValueConst new_target, int argc, JSValueConst* argv) {
+  return JS_ThrowTypeError(ctx, "Illegal constructor");
+}
+
+// Reads postMessage()'s transferList (an array, or an options object with a `transfer` array).
+// Messages are copied with JS_WriteObject, so ArrayBuffers are transferred by copying them and then
+// detaching the sender's; ports stay on the thread that created them, so MessagePorts are refused.
+// On success *buffers holds the ArrayBuffers to detach once the message is serialized.
+static int jsrt_worker_read_transfer(JSContext* ctx, JSValueConst arg, JSValue** buffers, uint32_t* count) {
+  *buffers = NULL;
+  *count = 0;
+  if (JS_IsUndefined(arg) || JS_IsNull(arg)) {
+    return 0;
+  }
+  if (!JS_IsObject(arg)) {
+    JS_ThrowTypeError(ctx, "The \"transferList\" argument must be an array");
+    return -1;
+  }
+
+  JSValue list = JS_IsArray(ctx, arg) ? JS_DupValue(ctx, arg) : JS_GetPropertyStr(ctx, arg, "transfer");
+  if (JS_IsException(list)) {
+    return -1;
+  }
+  if (JS_IsUndefined(list)) {
+    return 0;
+  }
+
+  uint32_t length = 0;
+  JSValue length_val = JS_IsObject(list) ? JS_GetPropertyStr(ctx, list, "length") : JS_UNDEFINED;
+  if (!JS_IsObject(list) || JS_IsException(length_val) || JS_ToUint32(ctx, &length, length_val)) {
+    JS_FreeValue(ctx, length_val);
+    JS_FreeValue(ctx, list);
+    if (!JS_HasException(ctx)) {
+      JS_ThrowTypeError(ctx, "The \"transfer\" option must be an array");
+    }
+    return -1;
+  }
+  JS_FreeValue(ctx, length_val);
+
+  *buffers = js_mallocz(ctx, sizeof(JSValue) * (length ? length : 1));
+  if (!*buffers) {
+    JS_FreeValue(ctx, list);
+    return -1;
+  }
+
+  int ret = 0;
+  for (uint32_t i = 0; i < length && ret == 0; i++) {
+    JSValue item = JS_GetPropertyUint32(ctx, list, i);
+    size_t size = 0;
+    uint8_t* store = NULL;
+    if (JS_IsException(item)) {
+      ret = -1;
+    } else if (JS_GetOpaque(item, js_message_port_class_id)) {
+      JSRT_CloneThrowError(ctx, "MessagePort cannot be transferred: ports stay on the thread that created them");
+      ret = -1;
+    } else if (!JS_IsObject(item) || !(store = JS_GetArrayBuffer(ctx, &size, item))) {
+      // Not an ArrayBuffer, or a detached one
+      JS_FreeValue(ctx, JS_GetException(ctx));
+      JSRT_CloneThrowError(ctx, "Value not transferable");
+      ret = -1;
+    } else if (JSRT_BufferIsPinned(store)) {
+      JSRT_CloneThrowError(ctx, "Cannot transfer an ArrayBuffer that is in use");
+      ret = -1;
+    } else {
+      for (uint32_t j = 0; j < *count; j++) {
+        if (JS_VALUE_GET_PTR((*buffers)[j]) == JS_VALUE_GET_PTR(item)) {
+          JSRT_CloneThrowError(ctx, "ArrayBuffer appears more than once in the transfer list");
+          ret = -1;
+          break;
+        }
+      }
+    }
+
+    if (ret == 0) {
+      (*buffers)[(*count)++] = item;
+    } else {
+      JS_FreeValue(ctx, item);
+    }
+  }
+  JS_FreeValue(ctx, list);
+  return ret;
+}
+
+// Serialize value into msg, honouring transfer (see jsrt_worker_read_transfer). Returns false with a
+// pending exception; the transferred ArrayBuffers are only detached once the message is built.
+static bool jsrt_worker_serialize_transfer(JSContext* ctx, JSValueConst value, JSValueConst transfer,
+                                           JSRT_WorkerMessage* msg) {
+  JSValue* buffers = NULL;
+  uint32_t count = 0;
+  bool ok = jsrt_worker_read_transfer(ctx, transfer, &buffers, &count) == 0 && jsrt_worker_serialize(ctx, value, msg);
+  for (uint32_t i = 0; i < count; i++) {
+    if (ok) {
+      JS_DetachArrayBuffer(ctx, buffers[i]);
+    }
+    JS_FreeValue(ctx, buffers[i]);
+  }
+  js_free(ctx, buffers);
+  return ok;
+}
+
+// port.postMessage(value[, transferList])
+static JSValue js_message_port_post_message(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
+  JSRT_MessagePort* port = jsrt_message_port_get(ctx, this_val);
+  if (!port) {
+    return JS_EXCEPTION;
+  }
+  if (port->closed) {
+    return JS_UNDEFINED;
+  }
+
+  JSRT_WorkerMessage* msg = jsrt_worker_message_new(JSRT_WORKER_MSG_DATA);
+  if (!msg) {
+    return JS_ThrowOutOfMemory(ctx);
+  }
+  if (!jsrt_worker_serialize_transfer(ctx, argc > 0 ? argv[0] : JS_UNDEFINED, argc > 1 ? argv[1] : JS_UNDEFINED,
+                                      msg)) {
+    jsrt_worker_message_free(msg);
+    return JS_EXCEPTION;
+  }
+
+  if (port->kind == JSRT_PORT_PARENT) {
+    jsrt_worker_post_to_parent(current_worker->shared, msg);
+  } else if (port->peer && !port->peer->closed) {
+    jsrt_worker_queue_push(&port->peer->queue, msg);
+    uv_async_send(port->peer->async);
+  } else {
+    jsrt_worker_message_free(msg);
+  }
+  return JS_UNDEFINED;
+}
+
+static void jsrt_message_port_close_one(JSRT_MessagePort* port) {
+  if (port->closed) {
+    return;
+  }
+  port->closed = true;
+  jsrt_message_port_update_ref(port);
+  // 'close' is emitted asynchronously from the async callback
+  uv_async_send(port->async);
+}
+
+// port.close()
 static JSValue js_message_port_close(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
-  JSRT_Debug("MessagePort.close called - stub implementation");
+  JSRT_MessagePort* port = jsrt_message_port_get(ctx, this_val);
+  if (!port) {
+    return JS_EXCEPTION;
+  }
+  JSRT_MessagePort* peer = port->peer;
+  jsrt_message_port_close_one(port);
+  if (peer) {
+    jsrt_message_port_close_one(peer);
+  }
+  return JS_UNDEFINED;
+}
+
+// port.start() - delivery starts as soon as a 'message' listener exists
+static JSValue js_message_port_start(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
+  JSRT_MessagePort* port = jsrt_message_port_get(ctx, this_val);
+  if (!port) {
+    return JS_EXCEPTION;
+  }
+  if (!port->closed) {
+    uv_async_send(port->async);
+  }
+  return JS_UNDEFINED;
+}
+
+// port.ref() / port.unref()
+static JSValue js_message_port_ref(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv, int magic) {
+  JSRT_MessagePort* port = jsrt_message_port_get(ctx, this_val);
+  if (!port) {
+    return JS_EXCEPTION;
+  }
+  port->refed = magic != 0;
+  jsrt_message_port_update_ref(port);
   return JS_UNDEFINED;
 }
 
+// port.hasRef()
+static JSValue js_message_port_has_ref(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
+  JSRT_MessagePort* port = jsrt_message_port_get(ctx, this_val);
+  if (!port) {
+    return JS_EXCEPTION;
+  }
+  return JS_NewBool(ctx, !port->closed && uv_has_ref((uv_handle_t*)port->async));
+}
+
+static const char* const port_listener_methods[] = {"on",  "addListener",    "once", "prependListener",
+                                                    "off", "removeListener", "removeAllListeners"};
+
+// EventEmitter listener methods, re-evaluating whether the port keeps the loop alive
+static JSValue js_message_port_listener_method(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv,
+                                               int magic) {
+  JSRT_MessagePort* port = jsrt_message_port_get(ctx, this_val);
+  if (!port) {
+    return JS_EXCEPTION;
+  }
+
+  JSValue ee_proto = jsrt_worker_event_emitter_proto(ctx);
+  JSValue method = JS_GetPropertyStr(ctx, ee_proto, port_listener_methods[magic]);
+  JS_FreeValue(ctx, ee_proto);
+  if (!JS_IsFunction(ctx, method)) {
+    JS_FreeValue(ctx, method);
+    return JS_DupValue(ctx, this_val);
+  }
+
+  JSValue result = JS_Call(ctx, method, this_val, argc, argv);
+  JS_FreeValue(ctx, method);
+  if (!JS_IsException(result)) {
+    jsrt_message_port_update_ref(port);
+  }
+  return result;
+}
+
+// receiveMessageOnPort(port): synchronously dequeue one message
+static JSValue js_receive_message_on_port(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
+  if (argc < 1) {
+    return JS_ThrowTypeError(ctx, "The \"port\" argument must be a MessagePort instance");
+  }
+  JSRT_MessagePort* port = jsrt_message_port_get(ctx, argv[0]);
+  if (!port) {
+    return JS_EXCEPTION;
+  }
+
+  JSRT_WorkerMessage* msg = NULL;
+  if (port->kind == JSRT_PORT_PARENT) {
+    JSRT_WorkerShared* shared = current_worker->shared;
+    uv_mutex_lock(&shared->lock);
+    msg = shared->to_worker.head;
+    if (msg) {
+      shared->to_worker.head = msg->next;
+      if (!shared->to_worker.head) {
+        shared->to_worker.tail = NULL;
+      }
+    }
+    uv_mutex_unlock(&shared->lock);
+  } else {
+    msg = port->queue.head;
+    if (msg) {
+      port->queue.head = msg->next;
+      if (!port->queue.head) {
+        port->queue.tail = NULL;
+      }
+    }
+  }
+
+  if (!msg) {
+    return JS_UNDEFINED;
+  }
+
+  JSValue value = jsrt_worker_deserialize(ctx, msg->data, msg->size);
+  jsrt_worker_message_free(msg);
+  if (JS_IsException(value)) {
+    return value;
+  }
+  JSValue result = JS_NewObject(ctx);
+  JS_SetPropertyStr(ctx, result, "message", value);
+  return result;
+}
+
 // ============================================================================
-// MessageChannel Class Implementation (Stub)
+// MessageChannel
 // ============================================================================
 
-// MessageChannel constructor
 static JSValue js_message_channel_constructor(JSContext* ctx, JSValueConst new_target, int argc, JSValueConst* argv) {
-  JSRT_Debug("MessageChannel constructor called - creating stub channel");
+  JSValue port1 = jsrt_message_port_new(ctx, JSRT_PORT_LOCAL, NULL);
+  if (JS_IsException(port1)) {
+    return port1;
+  }
+  JSValue port2 = jsrt_message_port_new(ctx, JSRT_PORT_LOCAL, NULL);
+  if (JS_IsException(port2)) {
+    JS_FreeValue(ctx, port1);
+    return port2;
+  }
+
+  JSRT_MessagePort* p1 = JS_GetOpaque(port1, js_message_port_class_id);
+  JSRT_MessagePort* p2 = JS_GetOpaque(port2, js_message_port_class_id);
+  p1->peer = p2;
+  p2->peer = p1;
 
   JSValue channel_obj = JS_NewObject(ctx);
-  if (JS_IsException(channel_obj)) {
-    return JS_EXCEPTION;
+  JS_DefinePropertyValueStr(ctx, channel_obj, "port1", port1, JS_PROP_ENUMERABLE);
+  JS_DefinePropertyValueStr(ctx, channel_obj, "port2", port2, JS_PROP_ENUMERABLE);
+  return channel_obj;
+}
+
+// ============================================================================
+// Worker (parent side)
+// ============================================================================
+
+struct JSRT_WorkerHandle {
+  JSContext* ctx;
+  JSValue obj;  // strong reference while the thread runs
+  JSRT_WorkerShared* shared;
+  uv_async_t async;
+  bool running;
+  bool finalized;
+  bool async_closed;
+  int exit_code;
+  JSValue* terminate_resolvers;  // resolve functions of pending terminate() promises
+  size_t terminate_resolvers_count;
+  JSRT_WorkerHandle* next;  // live_workers list
+};
+
+static JSClassID js_worker_class_id;
+
+static void jsrt_worker_handle_unlink(JSRT_WorkerHandle* handle) {
+  for (JSRT_WorkerHandle** p = &live_workers; *p; p = &(*p)->next) {
+    if (*p == handle) {
+      *p = handle->next;
+      return;
+    }
   }
+}
 
-  // Create port1 and port2 (stub MessagePort objects)
-  JSValue port1 = JS_NewObject(ctx);
-  JSValue port2 = JS_NewObject(ctx);
+static void jsrt_worker_handle_maybe_free(JSRT_WorkerHandle* handle) {
+  if (handle->finalized && handle->async_closed) {
+    free(handle);
+  }
+}
 
-  // Add basic MessagePort properties and methods
-  JS_SetPropertyStr(ctx, port1, "started", JS_NewBool(ctx, 1));
-  JS_SetPropertyStr(ctx, port1, "close", JS_NewCFunction(ctx, js_message_port_close, "close", 0));
+static void jsrt_worker_handle_on_close(uv_handle_t* uv_handle) {
+  JSRT_WorkerHandle* handle = uv_handle->data;
+  handle->async_closed = true;
+  jsrt_worker_handle_maybe_free(handle);
+}
 
-  JS_SetPropertyStr(ctx, port2, "started", JS_NewBool(ctx, 1));
-  JS_SetPropertyStr(ctx, port2, "close", JS_NewCFunction(ctx, js_message_port_close, "close", 0));
+static void js_worker_finalizer(JSRuntime* rt, JSValue val) {
+  JSRT_WorkerHandle* handle = JS_GetOpaque(val, js_worker_class_id);
+  if (!handle) {
+    return;
+  }
+  // A running worker holds its own object, so the thread is already joined here
+  jsrt_worker_handle_unlink(handle);
+  for (size_t i = 0; i < handle->terminate_resolvers_count; i++) {
+    JS_FreeValueRT(rt, handle->terminate_resolvers[i]);
+  }
+  free(handle->terminate_resolvers);
+  handle->terminate_resolvers = NULL;
+  handle->terminate_resolvers_count = 0;
 
-  JS_SetPropertyStr(ctx, channel_obj, "port1", port1);
-  JS_SetPropertyStr(ctx, channel_obj, "port2", port2);
+  handle->finalized = true;
+  if (!handle->async_closed && !uv_is_closing((uv_handle_t*)&handle->async)) {
+    uv_close((uv_handle_t*)&handle->async, jsrt_worker_handle_on_close);
+  }
+  jsrt_worker_handle_maybe_free(handle);
+}
 
-  return channel_obj;
+static JSClassDef js_worker_class = {
+    "Worker",
+    .finalizer = js_worker_finalizer,
+};
+
+// Join the thread and release everything tied to it. Returns the exit code.
+static void jsrt_worker_handle_finish(JSRT_WorkerHandle* handle, int exit_code) {
+  uv_thread_join(&handle->shared->tid);
+  jsrt_worker_shared_free(handle->shared);
+  handle->shared = NULL;
+  handle->running = false;
+  handle->exit_code = exit_code;
+  if (!uv_is_closing((uv_handle_t*)&handle->async)) {
+    uv_close((uv_handle_t*)&handle->async, jsrt_worker_handle_on_close);
+  }
+}
+
+static JSValue jsrt_worker_error_from_record(JSContext* ctx, JSValueConst record) {
+  JSValue error = JS_NewError(ctx);
+  if (JS_IsObject(record)) {
+    const char* props[] = {"message", "name", "stack"};
+    for (size_t i = 0; i < countof(props); i++) {
+      JSValue v = JS_GetPropertyStr(ctx, record, props[i]);
+      if (!JS_IsUndefined(v)) {
+        JS_DefinePropertyValueStr(ctx, error, props[i], v, JS_PROP_WRITABLE | JS_PROP_CONFIGURABLE);
+      } else {
+        JS_FreeValue(ctx, v);
+      }
+    }
+  }
+  return error;
+}
+
+// Messages from the worker thread: 'online', 'message', 'error', then 'exit'
+static void jsrt_worker_handle_on_async(uv_async_t* uv_handle) {
+  JSRT_WorkerHandle* handle = uv_handle->data;
+  if (!handle->shared) {
+    return;
+  }
+  JSContext* ctx = handle->ctx;
+
+  uv_mutex_lock(&handle->shared->lock);
+  JSRT_WorkerMessage* msg = jsrt_worker_queue_take(&handle->shared->to_parent);
+  uv_mutex_unlock(&handle->shared->lock);
+
+  JSValue obj = JS_DupValue(ctx, handle->obj);
+  while (msg) {
+    JSRT_WorkerMessage* next = msg->next;
+    JSValue result = JS_UNDEFINED;
+
+    switch (msg->type) {
+      case JSRT_WORKER_MSG_ONLINE:
+        result = jsrt_worker_emit(ctx, obj, "online", 0, NULL);
+        break;
+      case JSRT_WORKER_MSG_DATA: {
+        JSValue value = jsrt_worker_deserialize(ctx, msg->data, msg->size);
+        if (JS_IsException(value)) {
+          JSValue error = JS_GetException(ctx);
+          result = jsrt_worker_emit(ctx, obj, "messageerror", 1, (JSValueConst*)&error);
+          JS_FreeValue(ctx, error);
+        } else {
+          result = jsrt_worker_emit(ctx, obj, "message", 1, (JSValueConst*)&value);
+          JS_FreeValue(ctx, value);
+        }
+        break;
+      }
+      case JSRT_WORKER_MSG_ERROR: {
+        JSValue record = jsrt_worker_deserialize(ctx, msg->data, msg->size);
+        if (JS_IsException(record)) {
+          record = JS_GetException(ctx);
+        }
+        JSValue error = jsrt_worker_error_from_record(ctx, record);
+        JS_FreeValue(ctx, record);
+        result = jsrt_worker_emit(ctx, obj, "error", 1, (JSValueConst*)&error);
+        JS_FreeValue(ctx, error);
+        break;
+      }
+      case JSRT_WORKER_MSG_EXIT: {
+        int exit_code = msg->exit_code;
+        jsrt_worker_handle_finish(handle, exit_code);
+
+        JSValue code = JS_NewInt32(ctx, exit_code);
+        result = jsrt_worker_emit(ctx, obj, "exit", 1, (JSValueConst*)&code);
+        for (size_t i = 0; i < handle->terminate_resolvers_count; i++) {
+          JSValue r = JS_Call(ctx, handle->terminate_resolvers[i], JS_UNDEFINED, 1, (JSValueConst*)&code);
+          JS_FreeValue(ctx, r);
+          JS_FreeValue(ctx, handle->terminate_resolvers[i]);
+        }
+        free(handle->terminate_resolvers);
+        handle->terminate_resolvers = NULL;
+        handle->terminate_resolvers_count = 0;
+        JS_FreeValue(ctx, code);
+
+        // Drop the self reference taken when the thread was started
+        JS_FreeValue(ctx, handle->obj);
+        break;
+      }
+    }
+
+    if (JS_IsException(result)) {
+      JSRT_RuntimeAddExceptionValue(JS_GetContextOpaque(ctx), JS_GetException(ctx));
+    }
+    JS_FreeValue(ctx, result);
+    jsrt_worker_message_free(msg);
+    msg = next;
+    jsrt_worker_drain_jobs(ctx);
+  }
+  JS_FreeValue(ctx, obj);
 }
 
 // ============================================================================
-// worker_threads Module Initialization
+// Worker thread
 // ============================================================================
 
-static JSValue js_worker_isMainThread(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
-  // Always return true since jsrt is single-threaded
-  return JS_NewBool(ctx, 1);
+static int jsrt_worker_interrupt_handler(JSRuntime* rt, void* opaque) {
+  JSRT_WorkerThreadState* state = opaque;
+  return state->shared->terminate_requested || state->exit_requested;
+}
+
+static void jsrt_worker_thread_on_async(uv_async_t* handle) {
+  JSRT_WorkerThreadState* state = handle->data;
+  if (state->shared->terminate_requested) {
+    JSRT_RuntimeStop(state->rt);
+    return;
+  }
+  if (state->port) {
+    jsrt_message_port_deliver(state->port);
+  }
+}
+
+JSValue jsrt_worker_exit(JSContext* ctx, int exit_code) {
+  JSRT_WorkerThreadState* state = current_worker;
+  if (!state) {
+    return JS_UNDEFINED;
+  }
+  state->exit_requested = true;
+  state->exit_code = exit_code;
+  JSRT_RuntimeStop(state->rt);
+  // Unwind the current JS stack past any try/catch; the interrupt handler keeps it from resuming
+  JS_ThrowInternalError(ctx, "worker exited");
+  JS_SetUncatchableException(ctx, true);
+  return JS_EXCEPTION;
+}
+
+// Run the worker's entry point. Returns false if it threw.
+static bool jsrt_worker_run_entry(JSRT_WorkerThreadState* state) {
+  JSRT_WorkerShared* shared = state->shared;
+  JSContext* ctx = state->rt->ctx;
+  JSValue result;
+
+  if (shared->eval_code) {
+    result = JS_Eval(ctx, shared->eval_code, strlen(shared->eval_code), "[worker eval]", JS_EVAL_TYPE_GLOBAL);
+  } else {
+    JSRT_ReadFileResult file = JSRT_ReadFile(shared->filename);
+    if (file.error != JSRT_READ_FILE_OK) {
+      JSRT_ReadFileResultFree(&file);
+      result = JS_ThrowReferenceError(ctx, "Cannot find module '%s'", shared->filename);
+    } else if (JSRT_PathHasSuffix(shared->filename, ".mjs") || JS_DetectModule(file.data, file.size)) {
+      result = JS_Eval(ctx, file.data, file.size, shared->filename, JS_EVAL_TYPE_MODULE);
+      JSRT_ReadFileResultFree(&file);
+      // Module evaluation returns a promise; settle synchronous module bodies now
+      if (!JS_IsException(result) && JS_IsPromise(result)) {
+        jsrt_worker_drain_jobs(ctx);
+        if (JS_PromiseState(ctx, result) == JS_PROMISE_REJECTED) {
+          JSValue reason = JS_PromiseResult(ctx, result);
+          JS_FreeValue(ctx, result);
+          result = JS_Throw(ctx, reason);
+        }
+      }
+    } else {
+      JSRT_ReadFileResultFree(&file);
+      JSRT_StdCommonJSSetEntryPath(shared->filename);
+      JSValue require_func = JS_GetPropertyStr(ctx, state->rt->global, "require");
+      JSValue path = JS_NewString(ctx, shared->filename);
+      result = JS_Call(ctx, require_func, state->rt->global, 1, (JSValueConst*)&path);
+      JS_FreeValue(ctx, path);
+      JS_FreeValue(ctx, require_func);
+    }
+  }
+
+  if (JS_IsException(result)) {
+    jsrt_worker_fail(state, ctx, JS_GetException(ctx));
+    return false;
+  }
+  JS_FreeValue(ctx, result);
+  jsrt_worker_drain_jobs(ctx);
+  return !state->failed;
+}
+
+static void jsrt_worker_thread_main(void* arg) {
+  JSRT_WorkerShared* shared = arg;
+  JSRT_WorkerThreadState state;
+  memset(&state, 0, sizeof(state));
+  state.shared = shared;
+  current_worker = &state;
+
+  JSRT_Runtime* rt = JSRT_RuntimeNew();
+  state.rt = rt;
+  if (shared->memory_limit > 0) {
+    JS_SetMemoryLimit(rt->rt, shared->memory_limit);
+  }
+  JS_SetMaxStackSize(rt->rt, shared->stack_size);
+  JS_SetInterruptHandler(rt->rt, jsrt_worker_interrupt_handler, &state);
+
+  uv_async_init(rt->uv_loop, &state.async, jsrt_worker_thread_on_async);
+  state.async.data = &state;
+  uv_unref((uv_handle_t*)&state.async);
+
+  uv_mutex_lock(&shared->lock);
+  shared->worker_async = &state.async;
+  bool terminated = shared->terminate_requested;
+  uv_mutex_unlock(&shared->lock);
+
+  if (!terminated) {
+    jsrt_worker_post_to_parent(shared, jsrt_worker_message_new(JSRT_WORKER_MSG_ONLINE));
+    if (jsrt_worker_run_entry(&state) && !rt->stop_requested) {
+      if (!JSRT_RuntimeRun(rt)) {
+        state.failed = true;
+      }
+    }
+  }
+
+  int exit_code;
+  if (state.exit_requested) {
+    exit_code = state.exit_code;
+  } else if (shared->terminate_requested || state.failed) {
+    exit_code = 1;
+  } else {
+    exit_code = jsrt_process_get_exit_code_internal();
+  }
+
+  uv_mutex_lock(&shared->lock);
+  shared->worker_async = NULL;
+  uv_mutex_unlock(&shared->lock);
+
+  // Don't wait for timers or sockets the script left behind
+  JSRT_RuntimeStop(rt);
+  JSRT_RuntimeFree(rt);
+  current_worker = NULL;
+
+  JSRT_WorkerMessage* msg = jsrt_worker_message_new(JSRT_WORKER_MSG_EXIT);
+  msg->exit_code = exit_code;
+  jsrt_worker_post_to_parent(shared, msg);
+}
+
+// ============================================================================
+// Worker JS API
+// ============================================================================
+
+static int jsrt_worker_get_limit(JSContext* ctx, JSValueConst limits, const char* name, int def) {
+  JSValue v = JS_GetPropertyStr(ctx, limits, name);
+  int32_t n = def;
+  if (JS_IsNumber(v) && JS_ToInt32(ctx, &n, v) == 0 && n <= 0) {
+    n = def;
+  }
+  JS_FreeValue(ctx, v);
+  return n;
+}
+
+static JSValue jsrt_worker_resource_limits(JSContext* ctx, const JSRT_WorkerShared* shared) {
+  JSValue limits = JS_NewObject(ctx);
+  if (shared) {
+    JS_SetPropertyStr(ctx, limits, "maxYoungGenerationSizeMb", JS_NewInt32(ctx, shared->max_young_mb));
+    JS_SetPropertyStr(ctx, limits, "maxOldGenerationSizeMb", JS_NewInt32(ctx, shared->max_old_mb));
+    JS_SetPropertyStr(ctx, limits, "codeRangeSizeMb", JS_NewInt32(ctx, shared->code_range_mb));
+    JS_SetPropertyStr(ctx, limits, "stackSizeMb", JS_NewInt32(ctx, shared->stack_mb));
+  }
+  return limits;
+}
+
+static JSValue jsrt_worker_get_environment_data_object(JSContext* ctx) {
+  if (!environment_data_ready) {
+    environment_data = JS_UNDEFINED;
+    // A worker starts with a copy of its parent's environment data
+    if (current_worker && current_worker->shared->env_data) {
+      environment_data =
+          jsrt_worker_deserialize(ctx, current_worker->shared->env_data, current_worker->shared->env_data_size);
+      if (JS_IsException(environment_data)) {
+        JS_FreeValue(ctx, JS_GetException(ctx));
+        environment_data = JS_UNDEFINED;
+      }
+    }
+    if (!JS_IsObject(environment_data)) {
+      JS_FreeValue(ctx, environment_data);
+      environment_data = JS_NewObject(ctx);
+    }
+    environment_data_ready = true;
+  }
+  return environment_data;
+}
+
+// new Worker(filename[, options])
+static JSValue js_worker_constructor(JSContext* ctx, JSValueConst new_target, int argc, JSValueConst* argv) {
+  if (argc < 1 || JS_IsUndefined(argv[0]) || JS_IsNull(argv[0])) {
+    return JS_ThrowTypeError(ctx, "The \"filename\" argument must be of type string or an instance of URL");
+  }
+  JSValueConst options = argc > 1 ? argv[1] : JS_UNDEFINED;
+
+  bool is_eval = false;
+  if (JS_IsObject(options)) {
+    JSValue eval_val = JS_GetPropertyStr(ctx, options, "eval");
+    is_eval = JS_ToBool(ctx, eval_val);
+    JS_FreeValue(ctx, eval_val);
+  }
+
+  JSRT_WorkerShared* shared = calloc(1, sizeof(JSRT_WorkerShared));
+  if (!shared) {
+    return JS_ThrowOutOfMemory(ctx);
+  }
+  uv_mutex_init(&shared->lock);
+
+  // URL objects stringify to their href
+  const char* spec = JS_ToCString(ctx, argv[0]);
+  if (!spec) {
+    jsrt_worker_shared_free(shared);
+    return JS_EXCEPTION;
+  }
+
+  if (is_eval) {
+    shared->eval_code = strdup(spec);
+  } else {
+    const char* path = spec;
+    if (strncmp(path, "file://", 7) == 0) {
+      path += 7;
+    }
+    if (jsrt_is_absolute_path(path)) {
+      shared->filename = strdup(path);
+    } else if (strncmp(path, "./", 2) == 0 || strncmp(path, "../", 3) == 0) {
+      char cwd[4096];
+      size_t cwd_size = sizeof(cwd);
+      if (uv_cwd(cwd, &cwd_size) == 0) {
+        shared->filename = jsrt_path_join(cwd, path);
+      }
+    } else {
+      JS_FreeCString(ctx, spec);
+      jsrt_worker_shared_free(shared);
+      return JS_ThrowTypeError(ctx,
+                               "The worker script or module filename must be an absolute path or a relative path "
+                               "starting with './' or '../'");
+    }
+  }
+  JS_FreeCString(ctx, spec);
+  if (!shared->eval_code && !shared->filename) {
+    jsrt_worker_shared_free(shared);
+    return JS_ThrowOutOfMemory(ctx);
+  }
+
+  // workerData (with options.transferList) and environment data are cloned up front
+  JSRT_WorkerMessage tmp = {0};
+  if (JS_IsObject(options)) {
+    JSValue worker_data = JS_GetPropertyStr(ctx, options, "workerData");
+    JSValue transfer_list = JS_GetPropertyStr(ctx, options, "transferList");
+    bool ok = !JS_IsException(transfer_list) && jsrt_worker_serialize_transfer(ctx, worker_data, transfer_list, &tmp);
+    JS_FreeValue(ctx, transfer_list);
+    JS_FreeValue(ctx, worker_data);
+    if (!ok) {
+      jsrt_worker_shared_free(shared);
+      return JS_EXCEPTION;
+    }
+    shared->worker_data = tmp.data;
+    shared->worker_data_size = tmp.size;
+  }
+  if (environment_data_ready) {
+    memset(&tmp, 0, sizeof(tmp));
+    if (jsrt_worker_serialize(ctx, environment_data, &tmp)) {
+      shared->env_data = tmp.data;
+      shared->env_data_size = tmp.size;
+    } else {
+      JS_FreeValue(ctx, JS_GetException(ctx));
+    }
+  }
+
+  // resourceLimits: QuickJS has a single heap, so old + young generation sizes
+  // become one memory limit for the worker's runtime.
+  shared->stack_mb = JSRT_WORKER_DEFAULT_STACK_MB;
+  if (JS_IsObject(options)) {
+    JSValue limits = JS_GetPropertyStr(ctx, options, "resourceLimits");
+    if (JS_IsObject(limits)) {
+      shared->max_old_mb = jsrt_worker_get_limit(ctx, limits, "maxOldGenerationSizeMb", 0);
+      shared->max_young_mb = jsrt_worker_get_limit(ctx, limits, "maxYoungGenerationSizeMb", 0);
+      shared->code_range_mb = jsrt_worker_get_limit(ctx, limits, "codeRangeSizeMb", 0);
+      shared->stack_mb = jsrt_worker_get_limit(ctx, limits, "stackSizeMb", JSRT_WORKER_DEFAULT_STACK_MB);
+    }
+    JS_FreeValue(ctx, limits);
+  }
+  shared->memory_limit = (size_t)(shared->max_old_mb + shared->max_young_mb) * 1024 * 1024;
+  shared->stack_size = (size_t)shared->stack_mb * 1024 * 1024;
+  shared->thread_id = jsrt_worker_alloc_thread_id();
+
+  // Create the object with the prototype of new_target so subclasses work
+  JSValue proto = JS_GetPropertyStr(ctx, new_target, "prototype");
+  if (JS_IsException(proto)) {
+    jsrt_worker_shared_free(shared);
+    return JS_EXCEPTION;
+  }
+  JSValue obj = JS_NewObjectProtoClass(ctx, proto, js_worker_class_id);
+  JS_FreeValue(ctx, proto);
+  if (JS_IsException(obj)) {
+    jsrt_worker_shared_free(shared);
+    return obj;
+  }
+
+  JSRT_WorkerHandle* handle = calloc(1, sizeof(JSRT_WorkerHandle));
+  if (!handle) {
+    JS_FreeValue(ctx, obj);
+    jsrt_worker_shared_free(shared);
+    return JS_ThrowOutOfMemory(ctx);
+  }
+  handle->ctx = ctx;
+  handle->obj = obj;
+  handle->shared = shared;
+  handle->exit_code = -1;
+  JS_SetOpaque(obj, handle);
+
+  JSRT_Runtime* rt = JS_GetContextOpaque(ctx);
+  uv_async_init(rt->uv_loop, &handle->async, jsrt_worker_handle_on_async);
+  handle->async.data = handle;
+  shared->parent_async = &handle->async;
+
+  JS_DefinePropertyValueStr(ctx, obj, "threadId", JS_NewInt32(ctx, shared->thread_id), JS_PROP_ENUMERABLE);
+  JS_DefinePropertyValueStr(ctx, obj, "resourceLimits", jsrt_worker_resource_limits(ctx, shared),
+                            JS_PROP_ENUMERABLE);
+
+  uv_thread_options_t thread_options;
+  thread_options.flags = UV_THREAD_HAS_STACK_SIZE;
+  thread_options.stack_size = shared->stack_size + JSRT_WORKER_STACK_HEADROOM;
+  int r = uv_thread_create_ex(&shared->tid, &thread_options, jsrt_worker_thread_main, shared);
+  if (r != 0) {
+    jsrt_worker_shared_free(shared);
+    handle->shared = NULL;
+    JS_FreeValue(ctx, obj);
+    return JS_ThrowInternalError(ctx, "Failed to start worker thread: %s", uv_strerror(r));
+  }
+
+  JSRT_Debug("Worker %d started (%s)", shared->thread_id, shared->filename ? shared->filename : "[worker eval]");
+  handle->running = true;
+  handle->next = live_workers;
+  live_workers = handle;
+
+  // The running thread keeps its Worker object alive until 'exit'
+  return JS_DupValue(ctx, obj);
 }
 
-static JSValue js_worker_parentPort(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
-  // Return null since there's no parent thread in single-threaded mode
-  return JS_NULL;
+static JSRT_WorkerHandle* jsrt_worker_handle_get(JSContext* ctx, JSValueConst this_val) {
+  return JS_GetOpaque2(ctx, this_val, js_worker_class_id);
 }
 
-static JSValue js_worker_threadId(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
-  // Return 0 for main thread
-  return JS_NewInt32(ctx, 0);
+// worker.postMessage(value[, transferList])
+static JSValue js_worker_post_message(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
+  JSRT_WorkerHandle* handle = jsrt_worker_handle_get(ctx, this_val);
+  if (!handle) {
+    return JS_EXCEPTION;
+  }
+  if (!handle->running) {
+    return JS_UNDEFINED;
+  }
+
+  JSRT_WorkerMessage* msg = jsrt_worker_message_new(JSRT_WORKER_MSG_DATA);
+  if (!msg) {
+    return JS_ThrowOutOfMemory(ctx);
+  }
+  if (!jsrt_worker_serialize_transfer(ctx, argc > 0 ? argv[0] : JS_UNDEFINED, argc > 1 ? argv[1] : JS_UNDEFINED,
+                                      msg)) {
+    jsrt_worker_message_free(msg);
+    return JS_EXCEPTION;
+  }
+  jsrt_worker_post_to_worker(handle->shared, msg);
+  return JS_UNDEFINED;
 }
 
-static JSValue js_worker_getEnvironmentData(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
-  // Return empty object for environment data
-  return JS_NewObject(ctx);
+static void jsrt_worker_request_terminate(JSRT_WorkerShared* shared) {
+  uv_mutex_lock(&shared->lock);
+  shared->terminate_requested = 1;
+  if (shared->worker_async) {
+    uv_async_send(shared->worker_async);
+  }
+  uv_mutex_unlock(&shared->lock);
+}
+
+// worker.terminate() -> Promise<exitCode>
+static JSValue js_worker_terminate(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
+  JSRT_WorkerHandle* handle = jsrt_worker_handle_get(ctx, this_val);
+  if (!handle) {
+    return JS_EXCEPTION;
+  }
+
+  JSValue resolving_funcs[2];
+  JSValue promise = JS_NewPromiseCapability(ctx, resolving_funcs);
+  if (JS_IsException(promise)) {
+    return promise;
+  }
+
+  if (!handle->running) {
+    JSValue code = handle->exit_code >= 0 ? JS_NewInt32(ctx, handle->exit_code) : JS_UNDEFINED;
+    JSValue r = JS_Call(ctx, resolving_funcs[0], JS_UNDEFINED, 1, (JSValueConst*)&code);
+    JS_FreeValue(ctx, r);
+    JS_FreeValue(ctx, resolving_funcs[0]);
+    JS_FreeValue(ctx, resolving_funcs[1]);
+    return promise;
+  }
+
+  JSValue* resolvers =
+      realloc(handle->terminate_resolvers, (handle->terminate_resolvers_count + 1) * sizeof(JSValue));
+  if (!resolvers) {
+    JS_FreeValue(ctx, resolving_funcs[0]);
+    JS_FreeValue(ctx, resolving_funcs[1]);
+    JS_FreeValue(ctx, promise);
+    return JS_ThrowOutOfMemory(ctx);
+  }
+  handle->terminate_resolvers = resolvers;
+  handle->terminate_resolvers[handle->terminate_resolvers_count++] = resolving_funcs[0];
+  JS_FreeValue(ctx, resolving_funcs[1]);
+
+  jsrt_worker_request_terminate(handle->shared);
+  return promise;
 }
 
-static JSValue js_worker_setEnvironmentData(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
-  if (argc < 2) {
-    return JS_ThrowTypeError(ctx, "setEnvironmentData requires at least 2 arguments");
+// worker.ref() / worker.unref()
+static JSValue js_worker_ref(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv, int magic) {
+  JSRT_WorkerHandle* handle = jsrt_worker_handle_get(ctx, this_val);
+  if (!handle) {
+    return JS_EXCEPTION;
+  }
+  if (handle->running) {
+    if (magic) {
+      uv_ref((uv_handle_t*)&handle->async);
+    } else {
+      uv_unref((uv_handle_t*)&handle->async);
+    }
   }
-  // Stub implementation - does nothing
   return JS_UNDEFINED;
 }
 
+// ============================================================================
+// Environment data
+// ============================================================================
+
+static JSValue js_worker_get_environment_data(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
+  if (argc < 1) {
+    return JS_UNDEFINED;
+  }
+  JSValue store = jsrt_worker_get_environment_data_object(ctx);
+  JSAtom key = JS_ValueToAtom(ctx, argv[0]);
+  if (key == JS_ATOM_NULL) {
+    return JS_EXCEPTION;
+  }
+  JSValue value = JS_GetProperty(ctx, store, key);
+  JS_FreeAtom(ctx, key);
+  return value;
+}
+
+static JSValue js_worker_set_environment_data(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
+  if (argc < 1) {
+    return JS_ThrowTypeError(ctx, "setEnvironmentData requires a key");
+  }
+  JSValue store = jsrt_worker_get_environment_data_object(ctx);
+  JSAtom key = JS_ValueToAtom(ctx, argv[0]);
+  if (key == JS_ATOM_NULL) {
+    return JS_EXCEPTION;
+  }
+  int ret;
+  if (argc < 2 || JS_IsUndefined(argv[1])) {
+    ret = JS_DeleteProperty(ctx, store, key, 0);
+  } else {
+    ret = JS_SetProperty(ctx, store, key, JS_DupValue(ctx, argv[1]));
+  }
+  JS_FreeAtom(ctx, key);
+  return ret < 0 ? JS_EXCEPTION : JS_UNDEFINED;
+}
+
+// ============================================================================
+// Runtime teardown
+// ============================================================================
+
+void jsrt_worker_threads_cleanup(JSContext* ctx) {
+  // Workers still running when their parent runtime goes away are terminated
+  while (live_workers) {
+    JSRT_WorkerHandle* handle = live_workers;
+    live_workers = handle->next;
+    handle->next = NULL;
+    if (handle->running) {
+      jsrt_worker_request_terminate(handle->shared);
+      jsrt_worker_handle_finish(handle, 1);
+      JS_FreeValue(ctx, handle->obj);
+    }
+  }
+
+  while (live_ports) {
+    JSRT_MessagePort* port = live_ports;
+    live_ports = port->next;
+    port->next = NULL;
+    port->closed = true;
+    port->close_emitted = true;
+    if (port->kind == JSRT_PORT_LOCAL && !uv_is_closing((uv_handle_t*)&port->local_async)) {
+      uv_close((uv_handle_t*)&port->local_async, jsrt_message_port_on_close);
+    }
+    if (port->held) {
+      port->held = false;
+      JS_FreeValue(ctx, port->obj);
+    }
+  }
+
+  if (environment_data_ready) {
+    JS_FreeValue(ctx, environment_data);
+    environment_data_ready = false;
+  }
+}
+
+// ============================================================================
+// worker_threads Module Initialization
+// ============================================================================
+
+static const JSCFunctionListEntry js_message_port_proto_funcs[] = {
+    JS_CFUNC_DEF("postMessage", 1, js_message_port_post_message),
+    JS_CFUNC_DEF("close", 0, js_message_port_close),
+    JS_CFUNC_DEF("start", 0, js_message_port_start),
+    JS_CFUNC_MAGIC_DEF("ref", 0, js_message_port_ref, 1),
+    JS_CFUNC_MAGIC_DEF("unref", 0, js_message_port_ref, 0),
+    JS_CFUNC_DEF("hasRef", 0, js_message_port_has_ref),
+    JS_CFUNC_MAGIC_DEF("on", 2, js_message_port_listener_method, 0),
+    JS_CFUNC_MAGIC_DEF("addListener", 2, js_message_port_listener_method, 1),
+    JS_CFUNC_MAGIC_DEF("once", 2, js_message_port_listener_method, 2),
+    JS_CFUNC_MAGIC_DEF("prependListener", 2, js_message_port_listener_method, 3),
+    JS_CFUNC_MAGIC_DEF("off", 2, js_message_port_listener_method, 4),
+    JS_CFUNC_MAGIC_DEF("removeListener", 2, js_message_port_listener_method, 5),
+    JS_CFUNC_MAGIC_DEF("removeAllListeners", 1, js_message_port_listener_method, 6),
+};
+
+static const JSCFunctionListEntry js_worker_proto_funcs[] = {
+    JS_CFUNC_DEF("postMessage", 1, js_worker_post_message),
+    JS_CFUNC_DEF("terminate", 0, js_worker_terminate),
+    JS_CFUNC_MAGIC_DEF("ref", 0, js_worker_ref, 1),
+    JS_CFUNC_MAGIC_DEF("unref", 0, js_worker_ref, 0),
+};
+
 // Initialize the worker_threads module namespace
 JSValue JSRT_InitNodeWorkerThreads(JSContext* ctx) {
   JSRT_Debug("Initializing worker_threads module");
+  JSRuntime* rt = JS_GetRuntime(ctx);
+
+  JS_NewClassID(&js_message_port_class_id);
+  if (!JS_IsRegisteredClass(rt, js_message_port_class_id)) {
+    JS_NewClass(rt, js_message_port_class_id, &js_message_port_class);
+  }
+  JS_NewClassID(&js_worker_class_id);
+  if (!JS_IsRegisteredClass(rt, js_worker_class_id)) {
+    JS_NewClass(rt, js_worker_class_id, &js_worker_class);
+  }
 
   JSValue worker_threads = JS_NewObject(ctx);
 
-  // Create Worker class
-  JSValue worker_proto = JS_NewObject(ctx);
-  JS_SetPropertyStr(ctx, worker_proto, "postMessage", JS_NewCFunction(ctx, js_worker_post_message, "postMessage", 1));
-  JS_SetPropertyStr(ctx, worker_proto, "terminate", JS_NewCFunction(ctx, js_worker_terminate, "terminate", 0));
-  JS_SetPropertyStr(ctx, worker_proto, "addEventListener",
-                    JS_NewCFunction(ctx, js_worker_add_event_listener, "addEventListener", 2));
-  JS_SetPropertyStr(ctx, worker_proto, "on", JS_NewCFunction(ctx, js_worker_add_event_listener, "on", 2));
-  JS_SetPropertyStr(ctx, worker_proto, "removeEventListener",
-                    JS_NewCFunction(ctx, js_worker_add_event_listener, "removeEventListener", 2));
-
-  JSValue worker_class = JS_NewCFunction2(ctx, js_worker_constructor, "Worker", 1, JS_CFUNC_constructor, 0);
-  JS_SetPropertyStr(ctx, worker_class, "prototype", worker_proto);
+  // MessagePort and Worker both inherit from EventEmitter
+  JSValue ee_proto = jsrt_worker_event_emitter_proto(ctx);
+
+  JSValue port_proto = JS_NewObjectProto(ctx, ee_proto);
+  JS_SetPropertyFunctionList(ctx, port_proto, js_message_port_proto_funcs, countof(js_message_port_proto_funcs));
+  JSValue port_ctor =
+      JS_NewCFunction2(ctx, js_message_port_constructor, "MessagePort", 0, JS_CFUNC_constructor, 0);
+  JS_SetConstructor(ctx, port_ctor, port_proto);
+  JS_SetClassProto(ctx, js_message_port_class_id, port_proto);
+  JS_SetPropertyStr(ctx, worker_threads, "MessagePort", port_ctor);
+
+  JSValue worker_proto = JS_NewObjectProto(ctx, ee_proto);
+  JS_SetPropertyFunctionList(ctx, worker_proto, js_worker_proto_funcs, countof(js_worker_proto_funcs));
+  JSValue worker_class = JS_NewCFunction2(ctx, js_worker_constructor, "Worker", 2, JS_CFUNC_constructor, 0);
+  JS_SetConstructor(ctx, worker_class, worker_proto);
+  JS_SetClassProto(ctx, js_worker_class_id, worker_proto);
   JS_SetPropertyStr(ctx, worker_threads, "Worker", worker_class);
+  JS_FreeValue(ctx, ee_proto);
 
-  // Create MessageChannel class
-  JSValue message_channel_proto = JS_NewObject(ctx);
   JSValue message_channel_class =
       JS_NewCFunction2(ctx, js_message_channel_constructor, "MessageChannel", 0, JS_CFUNC_constructor, 0);
-  JS_SetPropertyStr(ctx, message_channel_class, "prototype", message_channel_proto);
   JS_SetPropertyStr(ctx, worker_threads, "MessageChannel", message_channel_class);
 
-  // Add worker-specific functions and properties
-  JS_SetPropertyStr(ctx, worker_threads, "isMainThread",
-                    JS_NewCFunction(ctx, js_worker_isMainThread, "isMainThread", 0));
-  JS_SetPropertyStr(ctx, worker_threads, "parentPort", JS_NewCFunction(ctx, js_worker_parentPort, "parentPort", 0));
-  JS_SetPropertyStr(ctx, worker_threads, "threadId", JS_NewCFunction(ctx, js_worker_threadId, "threadId", 0));
+  JS_SetPropertyStr(ctx, worker_threads, "receiveMessageOnPort",
+                    JS_NewCFunction(ctx, js_receive_message_on_port, "receiveMessageOnPort", 1));
   JS_SetPropertyStr(ctx, worker_threads, "getEnvironmentData",
-                    JS_NewCFunction(ctx, js_worker_getEnvironmentData, "getEnvironmentData", 0));
+                    JS_NewCFunction(ctx, js_worker_get_environment_data, "getEnvironmentData", 1));
   JS_SetPropertyStr(ctx, worker_threads, "setEnvironmentData",
-                    JS_NewCFunction(ctx, js_worker_setEnvironmentData, "setEnvironmentData", 2));
+                    JS_NewCFunction(ctx, js_worker_set_environment_data, "setEnvironmentData", 2));
+
+  // Thread identity
+  JSRT_WorkerThreadState* state = current_worker;
+  JS_SetPropertyStr(ctx, worker_threads, "isMainThread", JS_NewBool(ctx, state == NULL));
+  JS_SetPropertyStr(ctx, worker_threads, "threadId", JS_NewInt32(ctx, state ? state->shared->thread_id : 0));
+  JS_SetPropertyStr(ctx, worker_threads, "resourceLimits",
+                    jsrt_worker_resource_limits(ctx, state ? state->shared : NULL));
+
+  if (state) {
+    JSValue parent_port = jsrt_message_port_new(ctx, JSRT_PORT_PARENT, &state->async);
+    if (!JS_IsException(parent_port)) {
+      state->port = JS_GetOpaque(parent_port, js_message_port_class_id);
+    }
+    JS_SetPropertyStr(ctx, worker_threads, "parentPort", parent_port);
+
+    JSValue worker_data = jsrt_worker_deserialize(ctx, state->shared->worker_data, state->shared->worker_data_size);
+    if (JS_IsException(worker_data)) {
+      JS_FreeValue(ctx, JS_GetException(ctx));
+      worker_data = JS_NULL;
+    }
+    JS_SetPropertyStr(ctx, worker_threads, "workerData", worker_data);
+  } else {
+    JS_SetPropertyStr(ctx, worker_threads, "parentPort", JS_NULL);
+    JS_SetPropertyStr(ctx, worker_threads, "workerData", JS_NULL);
+  }
 
   // Add constants
   JS_SetPropertyStr(ctx, worker_threads, "SHARE_ENV", JS_NewInt32(ctx, 0));
@@ -247,20 +1615,31 @@ JSValue JSRT_InitNodeWorkerThreads(JSContext* ctx) {
 
 // ES module initialization
 int js_node_worker_threads_init(JSContext* ctx, JSModuleDef* m) {
-  JSValue worker_threads = JSRT_InitNodeWorkerThreads(ctx);
+  // Share the CommonJS instance so parentPort is a single object per thread
+  JSValue worker_threads = JSRT_LoadNodeModuleCommonJS(ctx, "worker_threads");
+  if (JS_IsException(worker_threads)) {
+    return -1;
+  }
 
   // Export individual components
-  JS_SetModuleExport(ctx, m, "Worker", JS_GetPropertyStr(ctx, worker_threads, "Worker"));
-  JS_SetModuleExport(ctx, m, "MessageChannel", JS_GetPropertyStr(ctx, worker_threads, "MessageChannel"));
-  JS_SetModuleExport(ctx, m, "isMainThread", JS_GetPropertyStr(ctx, worker_threads, "isMainThread"));
-  JS_SetModuleExport(ctx, m, "parentPort", JS_GetPropertyStr(ctx, worker_threads, "parentPort"));
-  JS_SetModuleExport(ctx, m, "threadId", JS_GetPropertyStr(ctx, worker_threads, "threadId"));
-  JS_SetModuleExport(ctx, m, "getEnvironmentData", JS_GetPropertyStr(ctx, worker_threads, "getEnvironmentData"));
-  JS_SetModuleExport(ctx, m, "setEnvironmentData", JS_GetPropertyStr(ctx, worker_threads, "setEnvironmentData"));
-  JS_SetModuleExport(ctx, m, "SHARE_ENV", JS_GetPropertyStr(ctx, worker_threads, "SHARE_ENV"));
+  const char* names[] = {"Worker",
+                         "MessageChannel",
+                         "MessagePort",
+                         "isMainThread",
+                         "parentPort",
+                         "threadId",
+                         "workerData",
+                         "resourceLimits",
+                         "receiveMessageOnPort",
+                         "getEnvironmentData",
+                         "setEnvironmentData",
+                         "SHARE_ENV"};
+  for (size_t i = 0; i < countof(names); i++) {
+    JS_SetModuleExport(ctx, m, names[i], JS_GetPropertyStr(ctx, worker_threads, names[i]));
+  }
 
   // Export the whole module as default
   JS_SetModuleExport(ctx, m, "default", worker_threads);
 
   return 0;
-}
\ No newline at end of file
+}
@@ -6,6 +6,7 @@
 #ifndef JSRT_WORKER_THREADS_H
 #define JSRT_WORKER_THREADS_H
 
+#include <stdbool.h>
 #include "../../deps/quickjs/quickjs.h"
 
 // Initialize worker_threads module namespace
@@ -14,4 +15,13 @@ JSValue JSRT_InitNodeWorkerThreads(JSContext* ctx);
 // Initialize worker_threads as a CommonJS module
 int js_node_worker_threads_init(JSContext* ctx, JSModuleDef* m);
 
-#endif  // JSRT_WORKER_THREADS_H
\ No newline at end of file
+// True when the calling thread runs a Worker (not the main thread)
+bool jsrt_worker_is_worker_thread(void);
+
+// process.exit() inside a Worker: stop only this thread's runtime with the given code
+JSValue jsrt_worker_exit(JSContext* ctx, int exit_code);
+
+// Terminate Workers owned by this runtime and release ports (called from JSRT_RuntimeFree)
+void jsrt_worker_threads_cleanup(JSContext* ctx);
+
+#endif  // JSRT_WORKER_THREADS_H
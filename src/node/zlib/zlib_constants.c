@@ -1,5 +1,6 @@
 #include <zlib.h>
 #include "../../util/macro.h"
+#include "../node_modules.h"
 #include "zlib_internal.h"
 
 // Export zlib constants to JavaScript
@@ -76,18 +77,7 @@ static JSValue js_zlib_crc32(JSContext* ctx, JSValueConst this_val, int argc, JS
 
   // Get buffer data
   size_t data_len;
-  uint8_t* data = NULL;
-
-  // Try to get as ArrayBuffer
-  data = JS_GetArrayBuffer(ctx, &data_len, argv[0]);
-  if (!data) {
-    // Try to get as typed array
-    JSValue buffer = JS_GetTypedArrayBuffer(ctx, argv[0], NULL, NULL, NULL);
-    if (!JS_IsException(buffer)) {
-      data = JS_GetArrayBuffer(ctx, &data_len, buffer);
-      JS_FreeValue(ctx, buffer);
-    }
-  }
+  uint8_t* data = jsrt_node_buffer_source_bytes(ctx, argv[0], &data_len);
 
   if (!data) {
     return JS_ThrowTypeError(ctx, "argument must be a Buffer or Uint8Array");
@@ -115,18 +105,7 @@ static JSValue js_zlib_adler32(JSContext* ctx, JSValueConst this_val, int argc,
 
   // Get buffer data
   size_t data_len;
-  uint8_t* data = NULL;
-
-  // Try to get as ArrayBuffer
-  data = JS_GetArrayBuffer(ctx, &data_len, argv[0]);
-  if (!data) {
-    // Try to get as typed array
-    JSValue buffer = JS_GetTypedArrayBuffer(ctx, argv[0], NULL, NULL, NULL);
-    if (!JS_IsException(buffer)) {
-      data = JS_GetArrayBuffer(ctx, &data_len, buffer);
-      JS_FreeValue(ctx, buffer);
-    }
-  }
+  uint8_t* data = jsrt_node_buffer_source_bytes(ctx, argv[0], &data_len);
 
   if (!data) {
     return JS_ThrowTypeError(ctx, "argument must be a Buffer or Uint8Array");
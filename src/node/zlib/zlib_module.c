@@ -6,26 +6,13 @@
 // Helper to get buffer data from JSValue
 static int get_buffer_data(JSContext* ctx, JSValueConst val, const uint8_t** data, size_t* len) {
   size_t size;
-  uint8_t* buf = JS_GetArrayBuffer(ctx, &size, val);
-
+  uint8_t* buf = jsrt_node_buffer_source_bytes(ctx, val, &size);
   if (buf) {
     *data = buf;
     *len = size;
     return 0;
   }
 
-  // Try to get as typed array
-  JSValue buffer = JS_GetTypedArrayBuffer(ctx, val, NULL, NULL, NULL);
-  if (!JS_IsException(buffer)) {
-    buf = JS_GetArrayBuffer(ctx, &size, buffer);
-    JS_FreeValue(ctx, buffer);
-    if (buf) {
-      *data = buf;
-      *len = size;
-      return 0;
-    }
-  }
-
   JS_ThrowTypeError(ctx, "argument must be a Buffer or Uint8Array");
   return -1;
 }
@@ -1,6 +1,7 @@
 #include <string.h>
 #include "../../deps/quickjs/quickjs-libc.h"
 #include "../../util/debug.h"
+#include "../node_modules.h"
 #include "../stream/stream_internal.h"
 #include "zlib_internal.h"
 
@@ -135,38 +136,18 @@ static JSValue zlib_stream_transform(JSContext* ctx, JSValueConst this_val, int
   const uint8_t* input;
   size_t input_len;
   size_t size;
-  uint8_t* buf = JS_GetArrayBuffer(ctx, &size, chunk);
-
-  if (buf) {
-    input = buf;
-    input_len = size;
-  } else {
-    JSValue buffer = JS_GetTypedArrayBuffer(ctx, chunk, NULL, NULL, NULL);
-    if (!JS_IsException(buffer)) {
-      buf = JS_GetArrayBuffer(ctx, &size, buffer);
-      JS_FreeValue(ctx, buffer);
-      if (buf) {
-        input = buf;
-        input_len = size;
-      } else {
-        JSValue args[] = {JS_NewString(ctx, "Invalid chunk type")};
-        JSValue result = JS_Call(ctx, callback, JS_UNDEFINED, 1, args);
-        if (JS_IsException(result)) {
-          js_std_dump_error(ctx);
-        }
-        JS_FreeValue(ctx, args[0]);
-        return result;
-      }
-    } else {
-      JSValue args[] = {JS_NewString(ctx, "Invalid chunk type")};
-      JSValue result = JS_Call(ctx, callback, JS_UNDEFINED, 1, args);
-      if (JS_IsException(result)) {
-        js_std_dump_error(ctx);
-      }
-      JS_FreeValue(ctx, args[0]);
-      return result;
+  uint8_t* buf = jsrt_node_buffer_source_bytes(ctx, chunk, &size);
+  if (!buf) {
+    JSValue args[] = {JS_NewString(ctx, "Invalid chunk type")};
+    JSValue result = JS_Call(ctx, callback, JS_UNDEFINED, 1, args);
+    if (JS_IsException(result)) {
+      js_std_dump_error(ctx);
     }
+    JS_FreeValue(ctx, args[0]);
+    return result;
   }
+  input = buf;
+  input_len = size;
 
   // Process chunk through zlib
   uint8_t* output;
@@ -325,7 +325,7 @@ int JSRT_CmdRunREPL(int argc, char** argv) {
           JSRT_EvalResultFree(&res2);
         }
         JSRT_EvalResultFree(&res);
-        JSRT_RuntimeRunTicket(rt);
+        JSRT_RuntimeDrainMicrotasks(rt);
       }
 
       if (accumulated_input) {
@@ -419,7 +419,7 @@ int JSRT_CmdRunREPL(int argc, char** argv) {
       JSRT_EvalResultFree(&res);
 
       // Run pending async operations
-      JSRT_RuntimeRunTicket(rt);
+      JSRT_RuntimeDrainMicrotasks(rt);
 
       // Clean up and advance to next line
       free(accumulated_input);
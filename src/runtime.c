@@ -16,6 +16,7 @@
 #include "module/module.h"
 #include "module/protocols/file_handler.h"
 #include "module/protocols/protocol_registry.h"
+#include "node/http/http_internal.h"
 #include "node/module/compile_cache.h"
 #include "node/module/error_stack.h"
 #include "node/module/hooks.h"
@@ -23,6 +24,7 @@
 #include "node/net/net_internal.h"
 #include "node/process/process.h"
 #include "node/process/process_node.h"
+#include "node/worker_threads.h"
 
 // Forward declaration to avoid including node_buffer.h which conflicts with system headers
 JSValue JSRT_InitNodeBuffer(JSContext* ctx);
@@ -44,10 +46,13 @@ JSValue JSRT_InitNodeBuffer(JSContext* ctx);
 #include "std/timer.h"
 #include "std/webassembly.h"
 #include "url/url.h"
+#include "util/buffer_pin.h"
+#include "util/conn_pool.h"
 #include "util/debug.h"
 #include "util/file.h"
 #include "util/jsutils.h"
 #include "util/path.h"
+#include "util/read_slab.h"
 
 static void jsrt_debug_dump_handles(uv_loop_t* loop);
 
@@ -110,61 +115,6 @@ static void jsrt_ensure_fetch_prototypes(JSRT_Runtime* rt) {
   jsrt_set_constructor_prototype(rt, "Headers", NULL, 0);
 }
 
-/**
- * Setup Error.stack line number fix for CommonJS modules
- * QuickJS reports line numbers relative to wrapper code which has +1 offset
- */
-static void jsrt_setup_error_stack_fix(JSRT_Runtime* rt) {
-  JSContext* ctx = rt->ctx;
-
-  // Inline Error.stack fix script
-  // QuickJS doesn't use a getter for Error.prototype.stack, it's a regular property
-  // We need to override it when errors are created, not at the prototype level
-  // CommonJS wrapper adds 2 lines (function header + registration), so subtract 2 from line numbers
-  const char* error_stack_fix =
-      "globalThis.__jsrt_cjs_modules=globalThis.__jsrt_cjs_modules||new Set();"
-      // Store cwd for path normalization
-      "const __jsrt_cwd=process.cwd()+'/';"
-      // Wrap Error constructor to fix stack traces
-      "const OrigError=Error;"
-      "globalThis.Error=function Error(...args){"
-      "const err=new OrigError(...args);"
-      "if(err.stack){"
-      "let s=err.stack;"
-      // Always remove wrapper frame from stack trace
-      "s=s.split('\\n').filter(l=>!l.includes('<error_stack_fix_cjs>')).join('\\n');"
-      // Adjust line numbers for CommonJS modules (before path conversion)
-      "if(globalThis.__jsrt_cjs_modules&&globalThis.__jsrt_cjs_modules.size>0){"
-      "for(const f of globalThis.__jsrt_cjs_modules){"
-      "if(s.includes(f)){"
-      "const e=f.replace(/[.*+?^${}()|[\\]\\\\]/g,'\\\\$&');"
-      "const r=new RegExp('('+e+'):(\\\\d+):','g');"
-      "s=s.replace(r,(m,f,l)=>{"
-      "const adjusted=parseInt(l)-2;"
-      "return f+':'+(adjusted>0?adjusted:1)+':';"
-      "});"
-      "}"
-      "}"
-      "}"
-      // Convert absolute paths to relative paths for consistency with ESM
-      "s=s.replace(new RegExp(__jsrt_cwd.replace(/[.*+?^${}()|[\\]\\\\]/g,'\\\\$&'),'g'),'');"
-      "err.stack=s;"
-      "}"
-      "return err;"
-      "};"
-      "Error.prototype=OrigError.prototype;"
-      "Error.prototype.constructor=Error;"
-      // Copy static properties
-      "Object.setPrototypeOf(Error,OrigError);";
-
-  JSValue result = JS_Eval(ctx, error_stack_fix, strlen(error_stack_fix), "<error_stack_fix_cjs>", JS_EVAL_TYPE_GLOBAL);
-  if (JS_IsException(result)) {
-    JSRT_Debug("Failed to setup Error.stack fix for CommonJS");
-    js_std_dump_error(ctx);
-  }
-  JS_FreeValue(ctx, result);
-}
-
 JSRT_Runtime* JSRT_RuntimeNew() {
   JSRT_Runtime* rt = malloc(sizeof(JSRT_Runtime));
   rt->rt = JS_NewRuntime();
@@ -192,8 +142,14 @@ JSRT_Runtime* JSRT_RuntimeNew() {
   rt->uv_loop = malloc(sizeof(uv_loop_t));
   uv_loop_init(rt->uv_loop);
   rt->uv_loop->data = rt;
+  rt->read_slab = JSRT_ReadSlabNew(rt->ctx);
 
   rt->compact_node_mode = false;
+  rt->stop_requested = false;
+  rt->http_pool = NULL;
+  rt->timers = NULL;
+  rt->immediates = NULL;
+  rt->next_ticks = NULL;
 
   // Initialize protocol registry for new module system
   jsrt_init_protocol_handlers();
@@ -213,11 +169,9 @@ JSRT_Runtime* JSRT_RuntimeNew() {
     JSRT_Debug("Failed to create source map cache");
   }
 
-  // Initialize error stack integration with source maps
-  if (rt->source_map_cache) {
-    if (!jsrt_error_stack_init(rt->ctx, rt->source_map_cache)) {
-      JSRT_Debug("Failed to initialize error stack integration");
-    }
+  // Initialize error stack integration (source maps, CommonJS line offsets)
+  if (!jsrt_error_stack_init(rt->ctx, rt->source_map_cache)) {
+    JSRT_Debug("Failed to initialize error stack integration");
   }
 
   // Initialize compilation cache (disabled by default)
@@ -242,6 +196,7 @@ JSRT_Runtime* JSRT_RuntimeNew() {
   JSRT_RuntimeSetupStdURL(rt);
   JSRT_RuntimeSetupStdDOM(rt);
   JSRT_RuntimeSetupStdClone(rt);
+  JSRT_BufferPinSetup(rt->ctx);       // Keep ArrayBuffer.prototype.transfer() off buffers native code uses
   JSRT_RuntimeSetupStdMicrotask(rt);  // Add queueMicrotask for WinterCG compliance
   JSRT_RuntimeSetupNavigator(rt);     // Add navigator for WinterTC compliance
   JSRT_RuntimeSetupStdStreams(rt);
@@ -260,9 +215,6 @@ JSRT_Runtime* JSRT_RuntimeNew() {
   // Initialize Node.js globals for compatibility
   JSRT_RuntimeSetupNodeGlobals(rt);
 
-  // Setup Error.stack line number fix for CommonJS modules
-  jsrt_setup_error_stack_fix(rt);
-
   return rt;
 }
 
@@ -280,6 +232,8 @@ void JSRT_RuntimeFree(JSRT_Runtime* rt) {
     rt->module_loader = NULL;
   }
 
+  jsrt_error_stack_cleanup(rt->ctx);
+
   // Cleanup source map cache
   if (rt->source_map_cache) {
     jsrt_source_map_cache_free(rt->rt, rt->source_map_cache);
@@ -303,6 +257,22 @@ void JSRT_RuntimeFree(JSRT_Runtime* rt) {
   // Cleanup FFI module
   JSRT_RuntimeCleanupStdFFI(rt->ctx);
 
+  // Stop Workers started by this runtime and release MessagePorts
+  jsrt_worker_threads_cleanup(rt->ctx);
+
+  jsrt_vm_cleanup(rt->ctx);
+  jsrt_node_buffer_cleanup(rt->ctx);
+
+  // Drop pending timers, setImmediate() and process.nextTick() callbacks
+  JSRT_RuntimeCleanupStdTimer(rt);
+  jsrt_node_timers_cleanup(rt->ctx);
+  jsrt_process_node_cleanup(rt->ctx);
+
+  // Close idle keep-alive connections kept by fetch() and http.Agent
+  JSRT_ConnPoolFree(rt->http_pool);
+  rt->http_pool = NULL;
+  jsrt_http_agents_cleanup();
+
   JSRT_RuntimeFreeValue(rt, rt->global);
   rt->global = JS_UNDEFINED;
 
@@ -311,8 +281,9 @@ void JSRT_RuntimeFree(JSRT_Runtime* rt) {
   JS_RunGC(rt->rt);
 
   // Run the loop to process all close callbacks from finalizers
-  // This must happen before uv_walk to avoid accessing freed memory
-  uv_run(rt->uv_loop, UV_RUN_DEFAULT);
+  // This must happen before uv_walk to avoid accessing freed memory.
+  // A stopped runtime may still own active timers/sockets, so don't block on them.
+  uv_run(rt->uv_loop, rt->stop_requested ? UV_RUN_NOWAIT : UV_RUN_DEFAULT);
 
   // Now close any remaining handles that weren't managed by finalizers
   // (timers, async handles, etc.)
@@ -341,6 +312,10 @@ void JSRT_RuntimeFree(JSRT_Runtime* rt) {
   // Clean up deferred net module structs after loop is closed
   jsrt_net_cleanup_deferred();
 
+  // Drop the read slab; blocks still viewed from JS are freed with the runtime
+  JSRT_ReadSlabFree(rt->read_slab);
+  rt->read_slab = NULL;
+
   JS_FreeContext(rt->ctx);
   rt->ctx = NULL;
   JS_FreeRuntime(rt->rt);
@@ -622,19 +597,8 @@ JSRT_EvalResult JSRT_RuntimeAwaitEvalResult(JSRT_Runtime* rt, JSRT_EvalResult* r
   JSRT_Debug("await eval result: processing immediate pending JS jobs only");
 
   // Process pending JS jobs (e.g., module initialization, synchronous promises)
-  for (int i = 0; i < 3; i++) {
-    if (!JS_IsJobPending(rt->rt)) {
-      JSRT_Debug("No more pending jobs after %d cycles", i);
-      break;
-    }
-
-    bool js_ret = JSRT_RuntimeRunTicket(rt);
-    JSRT_Debug("await eval result: cycle %d, js_ret=%d", i, js_ret);
-
-    if (!js_ret) {
-      JSRT_Debug("JavaScript execution failed");
-      break;
-    }
+  if (!JSRT_RuntimeDrainMicrotasks(rt)) {
+    JSRT_Debug("JavaScript execution failed");
   }
 
   // Do NOT run uv_run here - it causes hanging when server.listen() is called
@@ -649,23 +613,9 @@ JSRT_EvalResult JSRT_RuntimeAwaitEvalResult(JSRT_Runtime* rt, JSRT_EvalResult* r
 bool JSRT_RuntimeRun(JSRT_Runtime* rt) {
   uint64_t counter = 0;
   for (;; counter++) {
-    // JSRT_Debug("runtime run loop: counter=%d", counter);
-
-    // Check if we have pending JavaScript jobs
-    bool has_js_jobs = JS_IsJobPending(rt->rt);
-
-    // If we have JavaScript jobs, use NOWAIT to process them quickly
-    // If we only have async I/O, use DEFAULT to block and wait efficiently
-    uv_run_mode mode = has_js_jobs ? UV_RUN_NOWAIT : UV_RUN_DEFAULT;
-
-    int ret = uv_run(rt->uv_loop, mode);
-    if (ret < 0) {
-      JSRT_Debug("uv_run error: ret=%d", ret);
-      return false;
-    }
-    // JSRT_Debug("runtime run loop: uv_run ret=%d, mode=%s", ret, has_js_jobs ? "NOWAIT" : "DEFAULT");
-
-    if (!JSRT_RuntimeRunTicket(rt)) {
+    // Whatever just ran (the main script or the callbacks of the last loop iteration) is followed by every
+    // nextTick callback and promise reaction it queued, as in Node.js, before the loop polls again
+    if (!JSRT_RuntimeDrainMicrotasks(rt)) {
       return false;
     }
 
@@ -673,27 +623,34 @@ bool JSRT_RuntimeRun(JSRT_Runtime* rt) {
       return false;
     }
 
-    // Check if we still have work to do
+    // Rejection handlers may have queued more jobs
     if (JS_IsJobPending(rt->rt)) {
-      // JSRT_Debug("runtime run loop: js has pending job, counter=%d", counter);
       continue;
     }
 
-    if (uv_loop_alive(rt->uv_loop)) {
+    if (!uv_loop_alive(rt->uv_loop)) {
+      // No more work to do
+      break;
+    }
+
 #ifdef DEBUG
-      if (counter % 10 == 0) {
-        JSRT_Debug("uv_loop still alive counter=%llu", (unsigned long long)counter);
-        uv_print_active_handles(rt->uv_loop, stderr);
-        fflush(stderr);
-      }
+    if (counter % 10 == 0) {
+      JSRT_Debug("uv_loop still alive counter=%llu", (unsigned long long)counter);
+      uv_print_active_handles(rt->uv_loop, stderr);
+      fflush(stderr);
+    }
 #endif
-      // If we used DEFAULT mode and there are still active handles,
-      // it means we processed some events, continue the loop
-      continue;
+
+    // One loop iteration, blocking for I/O only when there is nothing due
+    int ret = uv_run(rt->uv_loop, UV_RUN_ONCE);
+    if (ret < 0) {
+      JSRT_Debug("uv_run error: ret=%d", ret);
+      return false;
     }
 
-    // No more work to do
-    break;
+    if (rt->stop_requested) {
+      break;
+    }
   }
   return true;
 }
@@ -717,6 +674,33 @@ bool JSRT_RuntimeRunTicket(JSRT_Runtime* rt) {
   return true;
 }
 
+bool JSRT_RuntimeDrainMicrotasks(JSRT_Runtime* rt) {
+  JSContext* ctx1;
+  do {
+    jsrt_process_execute_next_tick(rt->ctx);
+
+    int status;
+    while ((status = JS_ExecutePendingJob(rt->rt, &ctx1)) > 0) {
+    }
+    if (status < 0) {
+      JSValue e = JS_GetException(rt->ctx);
+      char* s = JSRT_RuntimeGetExceptionString(rt, e);
+      fprintf(stderr, "%s\n", s);
+      free(s);
+      JSRT_RuntimeFreeValue(rt, e);
+      return false;
+    }
+    // Promise reactions may have queued nextTick callbacks, which in turn may queue reactions
+  } while (jsrt_process_has_next_tick(rt->ctx));
+
+  return true;
+}
+
+void JSRT_RuntimeStop(JSRT_Runtime* rt) {
+  rt->stop_requested = true;
+  uv_stop(rt->uv_loop);
+}
+
 void JSRT_RuntimeAddDisposeValue(JSRT_Runtime* rt, JSValue value) {
   if (rt->dispose_values_length == rt->dispose_values_capacity) {
     rt->dispose_values_capacity *= 2;
@@ -905,6 +889,9 @@ void JSRT_RuntimeSetupNodeGlobals(JSRT_Runtime* rt) {
     JS_FreeValue(rt->ctx, buffer_module);
   }
 
+  // setImmediate() and clearImmediate()
+  JSRT_AddNodeTimerGlobals(rt->ctx);
+
   // Make process globally available (should already be there, but ensure)
   JSValue process_val = JS_GetPropertyStr(rt->ctx, rt->global, "process");
   if (JS_IsUndefined(process_val)) {
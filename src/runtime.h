@@ -20,6 +20,17 @@ typedef struct JSRT_CompileCacheConfig JSRT_CompileCacheConfig;
 // Forward declaration for hook registry
 typedef struct JSRTHookRegistry JSRTHookRegistry;
 
+// Forward declaration for the read buffer slab allocator
+typedef struct JSRT_ReadSlab JSRT_ReadSlab;
+
+// Forward declaration for the keep-alive connection pool
+typedef struct JSRT_ConnPool JSRT_ConnPool;
+
+// Forward declarations for the timer lists and the setImmediate() and process.nextTick() queues
+typedef struct JSRT_TimerLists JSRT_TimerLists;
+typedef struct JSRT_ImmediateQueue JSRT_ImmediateQueue;
+typedef struct JSRT_NextTickQueue JSRT_NextTickQueue;
+
 typedef struct {
   JSRuntime* rt;
   JSContext* ctx;
@@ -36,6 +47,9 @@ typedef struct {
   uv_loop_t* uv_loop;
   bool compact_node_mode;
 
+  // Set by JSRT_RuntimeStop() to leave JSRT_RuntimeRun() with handles still active
+  bool stop_requested;
+
   // Module loader (new unified system)
   JSRT_ModuleLoader* module_loader;
 
@@ -47,6 +61,19 @@ typedef struct {
 
   // Module hook registry (for module.registerHooks())
   JSRTHookRegistry* hook_registry;
+
+  // Slab allocator shared by libuv read callbacks on this loop
+  JSRT_ReadSlab* read_slab;
+
+  // Keep-alive connections used by fetch(), created on first use
+  JSRT_ConnPool* http_pool;
+
+  // setTimeout()/setInterval() lists, one per distinct duration (std/timer.c)
+  JSRT_TimerLists* timers;
+
+  // setImmediate() and process.nextTick() queues, created on first use
+  JSRT_ImmediateQueue* immediates;
+  JSRT_NextTickQueue* next_ticks;
 } JSRT_Runtime;
 
 JSRT_Runtime* JSRT_RuntimeNew();
@@ -72,6 +99,9 @@ void JSRT_EvalResultFree(JSRT_EvalResult* result);
 JSRT_EvalResult JSRT_RuntimeAwaitEvalResult(JSRT_Runtime* rt, JSRT_EvalResult* result);
 bool JSRT_RuntimeRun(JSRT_Runtime* rt);
 bool JSRT_RuntimeRunTicket(JSRT_Runtime* rt);
+// Run nextTick callbacks and promise jobs until both queues are empty; false (after printing it) on an exception
+bool JSRT_RuntimeDrainMicrotasks(JSRT_Runtime* rt);
+void JSRT_RuntimeStop(JSRT_Runtime* rt);
 
 void JSRT_RuntimeAddDisposeValue(JSRT_Runtime* rt, JSValue value);
 void JSRT_RuntimeFreeDisposeValues(JSRT_Runtime* rt);
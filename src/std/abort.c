@@ -9,6 +9,7 @@
 
 #include "../jsrt.h"
 #include "../util/debug.h"
+#include "../util/macro.h"
 #include "event.h"
 
 // Forward declare class IDs
@@ -432,7 +433,7 @@ static JSValue JSRT_AbortSignalAny(JSContext* ctx, JSValueConst this_val, int ar
 }
 
 // Simplified global flag to prevent infinite recursion
-static bool JSRT_AbortInProgress = false;
+static JSRT_THREAD_LOCAL bool JSRT_AbortInProgress = false;
 
 // Helper function to add a dependent signal to a parent signal
 static void JSRT_AbortSignal_AddDependent(JSContext* ctx, JSValue parent_val, JSValue dependent_val) {
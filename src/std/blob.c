@@ -175,6 +175,45 @@ static JSValue JSRT_BlobSlice(JSContext* ctx, JSValueConst this_val, int argc, J
   return new_obj;
 }
 
+bool JSRT_IsBlob(JSValueConst val) {
+  return JS_GetOpaque(val, JSRT_BlobClassID) != NULL;
+}
+
+// Copy of a Blob with the same bytes and type, for structuredClone()
+JSValue JSRT_BlobClone(JSContext* ctx, JSValueConst val) {
+  JSRT_Blob* blob = JS_GetOpaque(val, JSRT_BlobClassID);
+  if (!blob) {
+    return JS_ThrowTypeError(ctx, "Not a Blob");
+  }
+
+  JSRT_Blob* copy = malloc(sizeof(JSRT_Blob));
+  if (!copy) {
+    return JS_ThrowOutOfMemory(ctx);
+  }
+  copy->size = blob->size;
+  copy->type = strdup(blob->type);
+  copy->data = blob->size > 0 ? malloc(blob->size) : NULL;
+  if (!copy->type || (blob->size > 0 && !copy->data)) {
+    free(copy->data);
+    free(copy->type);
+    free(copy);
+    return JS_ThrowOutOfMemory(ctx);
+  }
+  if (blob->size > 0) {
+    memcpy(copy->data, blob->data, blob->size);
+  }
+
+  JSValue obj = JS_NewObjectClass(ctx, JSRT_BlobClassID);
+  if (JS_IsException(obj)) {
+    free(copy->data);
+    free(copy->type);
+    free(copy);
+    return obj;
+  }
+  JS_SetOpaque(obj, copy);
+  return obj;
+}
+
 static JSValue JSRT_BlobText(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
   JSRT_Blob* blob = JS_GetOpaque(this_val, JSRT_BlobClassID);
   if (!blob) {
@@ -5,4 +5,7 @@
 
 void JSRT_RuntimeSetupStdBlob(JSRT_Runtime* rt);
 
+bool JSRT_IsBlob(JSValueConst val);
+JSValue JSRT_BlobClone(JSContext* ctx, JSValueConst val);
+
 #endif
\ No newline at end of file
@@ -3,278 +3,710 @@
 #include <quickjs.h>
 #include <stdbool.h>
 #include <stdint.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
+#include "../util/buffer_pin.h"
 #include "../util/debug.h"
-#include "../util/list.h"
-
-// Circular reference tracking
-typedef struct JSRT_CloneEntry {
-  JSValue original;
-  JSValue clone;
-  struct JSRT_CloneEntry* next;
-} JSRT_CloneEntry;
+#include "../util/macro.h"
+#include "blob.h"
+
+// Deeper structures throw instead of exhausting the C stack
+#define JSRT_CLONE_MAX_DEPTH 10000
+#define JSRT_CLONE_MIN_CAPACITY 64
+
+// Global names, indexed by JSRT_CloneKind
+static const char* const clone_kind_names[JSRT_CLONE_KIND_COUNT] = {
+    "Object", "Array", "TypedArray", "Error", "Blob", "Function", "Date",
+    "RegExp", "Map", "Set", "ArrayBuffer", "SharedArrayBuffer", "DataView",
+    "Boolean", "Number", "String", "BigInt", "Promise", "WeakMap", "WeakSet",
+};
+
+// Error constructors a cloned error may keep; any other name becomes a plain Error
+static const char* const clone_error_names[] = {
+    "Error", "EvalError", "RangeError", "ReferenceError", "SyntaxError", "TypeError", "URIError",
+};
+
+struct JSRT_CloneEntry {
+  JSValue original;  // Not an object when the slot is free
+  JSValue value;
+};
 
 typedef struct {
-  JSRT_CloneEntry* entries;
-} JSRT_CloneMap;
+  JSContext* ctx;
+  JSRT_CloneMap map;  // Originals to their clones
+  JSRT_CloneTypes types;
+  JSValue array_from;  // Array.from, for snapshots of Map and Set entries
+  int depth;
+} JSRT_CloneState;
+
+void JSRT_CloneMapInit(JSContext* ctx, JSRT_CloneMap* map) {
+  memset(map, 0, sizeof(*map));
+  map->ctx = ctx;
+}
 
-static JSRT_CloneMap* JSRT_CloneMapNew() {
-  JSRT_CloneMap* map = malloc(sizeof(JSRT_CloneMap));
+void JSRT_CloneMapFree(JSRT_CloneMap* map) {
+  JSRT_CloneMapFreeRT(JS_GetRuntime(map->ctx), map);
+}
+
+void JSRT_CloneMapFreeRT(JSRuntime* rt, JSRT_CloneMap* map) {
+  for (uint32_t i = 0; i < map->capacity; i++) {
+    if (JS_IsObject(map->entries[i].original)) {
+      JS_FreeValueRT(rt, map->entries[i].original);
+      JS_FreeValueRT(rt, map->entries[i].value);
+    }
+  }
+  js_free_rt(rt, map->entries);
   map->entries = NULL;
-  return map;
-}
-
-static void JSRT_CloneMapFree(JSContext* ctx, JSRT_CloneMap* map) {
-  if (map) {
-    JSRT_CloneEntry* entry = map->entries;
-    while (entry) {
-      JSRT_CloneEntry* next = entry->next;
-      JS_FreeValue(ctx, entry->original);
-      JS_FreeValue(ctx, entry->clone);
-      free(entry);
-      entry = next;
+  map->capacity = map->count = 0;
+}
+
+void JSRT_CloneMapMark(JSRuntime* rt, JSRT_CloneMap* map, JS_MarkFunc* mark_func) {
+  for (uint32_t i = 0; i < map->capacity; i++) {
+    if (JS_IsObject(map->entries[i].original)) {
+      JS_MarkValue(rt, map->entries[i].original, mark_func);
+      JS_MarkValue(rt, map->entries[i].value, mark_func);
     }
-    free(map);
   }
 }
 
-static JSValue JSRT_CloneMapGet(JSRT_CloneMap* map, JSContext* ctx, JSValue original) {
-  JSRT_CloneEntry* entry = map->entries;
-  while (entry) {
-    if (JS_VALUE_GET_PTR(entry->original) == JS_VALUE_GET_PTR(original)) {
-      return JS_DupValue(ctx, entry->clone);
+// Fibonacci hashing: heap pointers differ mostly in their middle bits
+static inline uint32_t clone_hash(const void* ptr) {
+  return (uint32_t)(((uint64_t)(uintptr_t)ptr * 0x9e3779b97f4a7c15ULL) >> 32);
+}
+
+// Slot holding obj, or the free slot where it belongs
+static struct JSRT_CloneEntry* clone_map_slot(JSRT_CloneMap* map, JSValueConst obj) {
+  void* ptr = JS_VALUE_GET_PTR(obj);
+  uint32_t mask = map->capacity - 1;
+  uint32_t i = clone_hash(ptr) & mask;
+  while (JS_IsObject(map->entries[i].original) && JS_VALUE_GET_PTR(map->entries[i].original) != ptr) {
+    i = (i + 1) & mask;
+  }
+  return &map->entries[i];
+}
+
+static int clone_map_grow(JSRT_CloneMap* map) {
+  struct JSRT_CloneEntry* old_entries = map->entries;
+  uint32_t old_capacity = map->capacity;
+  uint32_t capacity = old_capacity ? old_capacity * 2 : JSRT_CLONE_MIN_CAPACITY;
+
+  // Zeroed slots hold no object, so they read as free
+  struct JSRT_CloneEntry* entries = js_mallocz(map->ctx, sizeof(struct JSRT_CloneEntry) * capacity);
+  if (!entries) {
+    return -1;
+  }
+  map->entries = entries;
+  map->capacity = capacity;
+  for (uint32_t i = 0; i < old_capacity; i++) {
+    if (JS_IsObject(old_entries[i].original)) {
+      *clone_map_slot(map, old_entries[i].original) = old_entries[i];
     }
-    entry = entry->next;
   }
-  return JS_UNDEFINED;
+  js_free(map->ctx, old_entries);
+  return 0;
 }
 
-static void JSRT_CloneMapSet(JSRT_CloneMap* map, JSContext* ctx, JSValue original, JSValue clone) {
-  JSRT_CloneEntry* entry = malloc(sizeof(JSRT_CloneEntry));
-  entry->original = JS_DupValue(ctx, original);
-  entry->clone = JS_DupValue(ctx, clone);
-  entry->next = map->entries;
-  map->entries = entry;
+JSValue JSRT_CloneMapGet(JSRT_CloneMap* map, JSValueConst obj) {
+  if (map->count == 0) {
+    return JS_UNINITIALIZED;
+  }
+  struct JSRT_CloneEntry* slot = clone_map_slot(map, obj);
+  return JS_IsObject(slot->original) ? JS_DupValue(map->ctx, slot->value) : JS_UNINITIALIZED;
 }
 
-// Forward declaration
-static JSValue JSRT_CloneValueInternal(JSContext* ctx, JSValue value, JSRT_CloneMap* map);
+int JSRT_CloneMapSet(JSRT_CloneMap* map, JSValueConst obj, JSValueConst value) {
+  if ((map->count + 1) * 4 > map->capacity * 3 && clone_map_grow(map) < 0) {
+    return -1;
+  }
+  struct JSRT_CloneEntry* slot = clone_map_slot(map, obj);
+  slot->original = JS_DupValue(map->ctx, obj);
+  slot->value = JS_DupValue(map->ctx, value);
+  map->count++;
+  return 0;
+}
 
-static JSValue JSRT_CloneArray(JSContext* ctx, JSValue array, JSRT_CloneMap* map) {
-  JSValue length_val = JS_GetPropertyStr(ctx, array, "length");
-  if (JS_IsException(length_val)) {
+void JSRT_CloneTypesInit(JSContext* ctx, JSRT_CloneTypes* types) {
+  types->ctx = ctx;
+  for (int i = 0; i < JSRT_CLONE_KIND_COUNT; i++) {
+    types->ctors[i] = JS_UNDEFINED;
+  }
+  JSValue object_ctor = JSRT_CloneTypesCtor(types, JSRT_CLONE_KIND_OBJECT);
+  types->object_proto = JS_IsObject(object_ctor) ? JS_GetPropertyStr(ctx, object_ctor, "prototype") : JS_NULL;
+}
+
+void JSRT_CloneTypesFree(JSRT_CloneTypes* types) {
+  JS_FreeValue(types->ctx, types->object_proto);
+  for (int i = 0; i < JSRT_CLONE_KIND_COUNT; i++) {
+    JS_FreeValue(types->ctx, types->ctors[i]);
+  }
+}
+
+JSValueConst JSRT_CloneTypesCtor(JSRT_CloneTypes* types, JSRT_CloneKind kind) {
+  if (JS_IsUndefined(types->ctors[kind])) {
+    JSValue global = JS_GetGlobalObject(types->ctx);
+    JSValue ctor = JS_GetPropertyStr(types->ctx, global, clone_kind_names[kind]);
+    JS_FreeValue(types->ctx, global);
+    if (!JS_IsFunction(types->ctx, ctor)) {
+      if (JS_IsException(ctor)) {
+        JS_FreeValue(types->ctx, JS_GetException(types->ctx));
+      }
+      JS_FreeValue(types->ctx, ctor);
+      ctor = JS_NULL;
+    }
+    types->ctors[kind] = ctor;
+  }
+  return types->ctors[kind];
+}
+
+const char* JSRT_CloneKindName(JSRT_CloneKind kind) {
+  return clone_kind_names[kind];
+}
+
+int JSRT_CloneClassify(JSRT_CloneTypes* types, JSValueConst obj, JSRT_CloneKind* kind) {
+  JSContext* ctx = types->ctx;
+  *kind = JSRT_CLONE_KIND_OBJECT;
+  if (JS_IsFunction(ctx, obj)) {
+    *kind = JSRT_CLONE_KIND_FUNCTION;
+    return 0;
+  }
+
+  int is_array = JS_IsArray(ctx, obj);
+  if (is_array < 0) {
+    return -1;
+  }
+  if (is_array) {
+    *kind = JSRT_CLONE_KIND_ARRAY;
+    return 0;
+  }
+
+  // Plain objects are by far the most common: no instanceof checks for them
+  JSValue proto = JS_GetPrototype(ctx, obj);
+  if (JS_IsException(proto)) {
+    return -1;
+  }
+  bool plain = JS_IsNull(proto) || (JS_IsObject(proto) && JS_IsObject(types->object_proto) &&
+                                    JS_VALUE_GET_PTR(proto) == JS_VALUE_GET_PTR(types->object_proto));
+  JS_FreeValue(ctx, proto);
+  if (plain) {
+    return 0;
+  }
+
+  if (JS_GetTypedArrayType(obj) >= 0) {
+    *kind = JSRT_CLONE_KIND_TYPED_ARRAY;
+  } else if (JS_IsError(ctx, obj)) {
+    *kind = JSRT_CLONE_KIND_ERROR;
+  } else if (JSRT_IsBlob(obj)) {
+    *kind = JSRT_CLONE_KIND_BLOB;
+  } else {
+    for (int k = JSRT_CLONE_KIND_DATE; k < JSRT_CLONE_KIND_COUNT; k++) {
+      JSValueConst ctor = JSRT_CloneTypesCtor(types, k);
+      int r = JS_IsObject(ctor) ? JS_IsInstanceOf(ctx, obj, ctor) : 0;
+      if (r < 0) {
+        return -1;
+      }
+      if (r > 0) {
+        *kind = k;
+        break;
+      }
+    }
+  }
+  return 0;
+}
+
+const char* JSRT_CloneErrorName(JSContext* ctx, JSValueConst error) {
+  const char* result = clone_error_names[0];
+  JSValue name = JS_GetPropertyStr(ctx, error, "name");
+  if (JS_IsString(name)) {
+    const char* name_str = JS_ToCString(ctx, name);
+    for (size_t i = 0; name_str && i < countof(clone_error_names); i++) {
+      if (strcmp(name_str, clone_error_names[i]) == 0) {
+        result = clone_error_names[i];
+      }
+    }
+    JS_FreeCString(ctx, name_str);
+  } else if (JS_IsException(name)) {
+    JS_FreeValue(ctx, JS_GetException(ctx));
+  }
+  JS_FreeValue(ctx, name);
+  return result;
+}
+
+static void clone_state_init(JSContext* ctx, JSRT_CloneState* state) {
+  state->ctx = ctx;
+  state->depth = 0;
+  state->array_from = JS_UNDEFINED;
+  JSRT_CloneMapInit(ctx, &state->map);
+  JSRT_CloneTypesInit(ctx, &state->types);
+}
+
+static void clone_state_free(JSRT_CloneState* state) {
+  JSRT_CloneMapFree(&state->map);
+  JSRT_CloneTypesFree(&state->types);
+  JS_FreeValue(state->ctx, state->array_from);
+}
+
+// Records the clone before its contents are cloned, so that cycles resolve to it
+static inline int clone_map_set(JSRT_CloneState* state, JSValueConst original, JSValueConst clone) {
+  return JSRT_CloneMapSet(&state->map, original, clone);
+}
+
+// Throws a DOMException named DataCloneError, as the HTML spec requires
+JSValue JSRT_CloneThrowError(JSContext* ctx, const char* message) {
+  JSValue global = JS_GetGlobalObject(ctx);
+  JSValue ctor = JS_GetPropertyStr(ctx, global, "DOMException");
+  JS_FreeValue(ctx, global);
+  if (!JS_IsFunction(ctx, ctor)) {
+    JS_FreeValue(ctx, ctor);
+    return JS_ThrowTypeError(ctx, "%s", message);
+  }
+
+  JSValue args[2] = {JS_NewString(ctx, message), JS_NewString(ctx, "DataCloneError")};
+  JSValue error = JS_CallConstructor(ctx, ctor, 2, args);
+  JS_FreeValue(ctx, args[0]);
+  JS_FreeValue(ctx, args[1]);
+  JS_FreeValue(ctx, ctor);
+  if (JS_IsException(error)) {
+    return error;
+  }
+  return JS_Throw(ctx, error);
+}
+
+static JSValue clone_value(JSRT_CloneState* state, JSValueConst value);
+
+// Copies the own enumerable string-keyed properties of src onto dst
+static int clone_properties(JSRT_CloneState* state, JSValueConst src, JSValueConst dst) {
+  JSContext* ctx = state->ctx;
+  JSPropertyEnum* props = NULL;
+  uint32_t count = 0;
+  if (JS_GetOwnPropertyNames(ctx, &props, &count, src, JS_GPN_STRING_MASK | JS_GPN_ENUM_ONLY) < 0) {
+    return -1;
+  }
+
+  int ret = 0;
+  for (uint32_t i = 0; i < count; i++) {
+    JSValue prop = JS_GetProperty(ctx, src, props[i].atom);
+    if (JS_IsException(prop)) {
+      ret = -1;
+      break;
+    }
+    JSValue cloned = clone_value(state, prop);
+    JS_FreeValue(ctx, prop);
+    if (JS_IsException(cloned) || JS_DefinePropertyValue(ctx, dst, props[i].atom, cloned, JS_PROP_C_W_E) < 0) {
+      ret = -1;
+      break;
+    }
+  }
+  JS_FreePropertyEnum(ctx, props, count);
+  return ret;
+}
+
+static JSValue clone_object(JSRT_CloneState* state, JSValueConst object) {
+  JSValue clone = JS_NewObject(state->ctx);
+  if (JS_IsException(clone) || clone_map_set(state, object, clone) < 0 ||
+      clone_properties(state, object, clone) < 0) {
+    JS_FreeValue(state->ctx, clone);
     return JS_EXCEPTION;
   }
+  return clone;
+}
 
+static JSValue clone_array(JSRT_CloneState* state, JSValueConst array) {
+  JSContext* ctx = state->ctx;
+  JSValue length_val = JS_GetPropertyStr(ctx, array, "length");
   uint32_t length;
-  if (JS_ToUint32(ctx, &length, length_val)) {
+  if (JS_IsException(length_val) || JS_ToUint32(ctx, &length, length_val)) {
     JS_FreeValue(ctx, length_val);
     return JS_EXCEPTION;
   }
-  JS_FreeValue(ctx, length_val);
 
-  JSValue cloned_array = JS_NewArray(ctx);
-  if (JS_IsException(cloned_array)) {
+  JSValue clone = JS_NewArray(ctx);
+  if (JS_IsException(clone) || clone_map_set(state, array, clone) < 0) {
+    JS_FreeValue(ctx, clone);
     return JS_EXCEPTION;
   }
 
-  // Add to map before cloning elements to handle circular references
-  JSRT_CloneMapSet(map, ctx, array, cloned_array);
-
   for (uint32_t i = 0; i < length; i++) {
     JSValue element = JS_GetPropertyUint32(ctx, array, i);
     if (JS_IsException(element)) {
-      JS_FreeValue(ctx, cloned_array);
+      JS_FreeValue(ctx, clone);
       return JS_EXCEPTION;
     }
-
-    JSValue cloned_element = JSRT_CloneValueInternal(ctx, element, map);
+    JSValue cloned = clone_value(state, element);
     JS_FreeValue(ctx, element);
-
-    if (JS_IsException(cloned_element)) {
-      JS_FreeValue(ctx, cloned_array);
+    if (JS_IsException(cloned) || JS_DefinePropertyValueUint32(ctx, clone, i, cloned, JS_PROP_C_W_E) < 0) {
+      JS_FreeValue(ctx, clone);
       return JS_EXCEPTION;
     }
+  }
+  return clone;
+}
 
-    if (JS_SetPropertyUint32(ctx, cloned_array, i, cloned_element) < 0) {
-      JS_FreeValue(ctx, cloned_element);
-      JS_FreeValue(ctx, cloned_array);
-      return JS_EXCEPTION;
-    }
+static JSValue clone_array_buffer(JSRT_CloneState* state, JSValueConst buffer) {
+  size_t size;
+  uint8_t* data = JS_GetArrayBuffer(state->ctx, &size, buffer);
+  if (!data && JS_HasException(state->ctx)) {
+    // Detached
+    JS_FreeValue(state->ctx, JS_GetException(state->ctx));
+    return JSRT_CloneThrowError(state->ctx, "An ArrayBuffer is detached and could not be cloned.");
   }
 
-  return cloned_array;
+  JSValue clone = JS_NewArrayBufferCopy(state->ctx, data, size);
+  if (JS_IsException(clone) || clone_map_set(state, buffer, clone) < 0) {
+    JS_FreeValue(state->ctx, clone);
+    return JS_EXCEPTION;
+  }
+  return clone;
 }
 
-static JSValue JSRT_CloneObject(JSContext* ctx, JSValue object, JSRT_CloneMap* map) {
-  JSValue cloned_object = JS_NewObject(ctx);
-  if (JS_IsException(cloned_object)) {
-    return JS_EXCEPTION;
+// The view is rebuilt over the clone of its buffer, so views sharing a buffer still share it
+static JSValue clone_typed_array(JSRT_CloneState* state, JSValueConst array, int type) {
+  JSContext* ctx = state->ctx;
+  size_t offset, length, bytes_per_element;
+  JSValue buffer = JS_GetTypedArrayBuffer(ctx, array, &offset, &length, &bytes_per_element);
+  if (JS_IsException(buffer)) {
+    return buffer;
+  }
+  JSValue buffer_clone = clone_value(state, buffer);
+  JS_FreeValue(ctx, buffer);
+  if (JS_IsException(buffer_clone)) {
+    return buffer_clone;
   }
 
-  // Add to map before cloning properties to handle circular references
-  JSRT_CloneMapSet(map, ctx, object, cloned_object);
+  JSValue args[3] = {buffer_clone, JS_NewInt64(ctx, (int64_t)offset),
+                     JS_NewInt64(ctx, (int64_t)(length / bytes_per_element))};
+  JSValue clone = JS_NewTypedArray(ctx, 3, args, (JSTypedArrayEnum)type);
+  JS_FreeValue(ctx, buffer_clone);
+  if (JS_IsException(clone) || clone_map_set(state, array, clone) < 0) {
+    JS_FreeValue(ctx, clone);
+    return JS_EXCEPTION;
+  }
+  return clone;
+}
 
-  // Get property names
-  JSPropertyEnum* props = NULL;
-  uint32_t prop_count = 0;
+static JSValue clone_data_view(JSRT_CloneState* state, JSValueConst view) {
+  JSContext* ctx = state->ctx;
+  JSValue buffer = JS_GetPropertyStr(ctx, view, "buffer");
+  if (JS_IsException(buffer)) {
+    return buffer;
+  }
+  JSValue args[3] = {clone_value(state, buffer), JS_GetPropertyStr(ctx, view, "byteOffset"),
+                     JS_GetPropertyStr(ctx, view, "byteLength")};
+  JS_FreeValue(ctx, buffer);
 
-  if (JS_GetOwnPropertyNames(ctx, &props, &prop_count, object,
-                             JS_GPN_STRING_MASK | JS_GPN_SYMBOL_MASK | JS_GPN_ENUM_ONLY) < 0) {
-    JS_FreeValue(ctx, cloned_object);
+  JSValue clone = JS_EXCEPTION;
+  if (!JS_IsException(args[0]) && !JS_IsException(args[1]) && !JS_IsException(args[2])) {
+    clone = JS_CallConstructor(ctx, JSRT_CloneTypesCtor(&state->types, JSRT_CLONE_KIND_DATA_VIEW), 3, args);
+  }
+  for (int i = 0; i < 3; i++) {
+    JS_FreeValue(ctx, args[i]);
+  }
+  if (JS_IsException(clone) || clone_map_set(state, view, clone) < 0) {
+    JS_FreeValue(ctx, clone);
     return JS_EXCEPTION;
   }
+  return clone;
+}
 
-  for (uint32_t i = 0; i < prop_count; i++) {
-    JSAtom prop_atom = props[i].atom;
-    JSValue prop_value = JS_GetProperty(ctx, object, prop_atom);
+// Rebuilds Date, RegExp and primitive wrappers from the value they wrap
+static JSValue clone_with_constructor(JSRT_CloneState* state, JSValueConst value, JSRT_CloneKind kind) {
+  JSContext* ctx = state->ctx;
+  JSValue args[2];
+  int argc = 1;
+  if (kind == JSRT_CLONE_KIND_REGEXP) {
+    args[0] = JS_GetPropertyStr(ctx, value, "source");
+    args[1] = JS_GetPropertyStr(ctx, value, "flags");
+    argc = 2;
+  } else {
+    JSAtom method = JS_NewAtom(ctx, kind == JSRT_CLONE_KIND_DATE ? "getTime" : "valueOf");
+    args[0] = JS_Invoke(ctx, value, method, 0, NULL);
+    JS_FreeAtom(ctx, method);
+  }
 
-    if (JS_IsException(prop_value)) {
-      JS_FreeValue(ctx, cloned_object);
-      js_free(ctx, props);
-      return JS_EXCEPTION;
+  JSValue clone = JS_EXCEPTION;
+  if (!JS_IsException(args[0]) && (argc < 2 || !JS_IsException(args[1]))) {
+    if (kind == JSRT_CLONE_KIND_BIGINT) {
+      // new BigInt() throws; Object(bigint) makes the wrapper
+      clone = JS_Call(ctx, JSRT_CloneTypesCtor(&state->types, JSRT_CLONE_KIND_OBJECT), JS_UNDEFINED, 1, args);
+    } else {
+      clone = JS_CallConstructor(ctx, JSRT_CloneTypesCtor(&state->types, kind), argc, args);
     }
+  }
+  for (int i = 0; i < argc; i++) {
+    JS_FreeValue(ctx, args[i]);
+  }
+  if (JS_IsException(clone) || clone_map_set(state, value, clone) < 0) {
+    JS_FreeValue(ctx, clone);
+    return JS_EXCEPTION;
+  }
+  return clone;
+}
 
-    JSValue cloned_value = JSRT_CloneValueInternal(ctx, prop_value, map);
-    JS_FreeValue(ctx, prop_value);
+static JSValue clone_collection(JSRT_CloneState* state, JSValueConst collection, bool is_map) {
+  JSContext* ctx = state->ctx;
+  JSValueConst ctor = JSRT_CloneTypesCtor(&state->types, is_map ? JSRT_CLONE_KIND_MAP : JSRT_CLONE_KIND_SET);
+  JSValue clone = JS_CallConstructor(ctx, ctor, 0, NULL);
+  if (JS_IsException(clone) || clone_map_set(state, collection, clone) < 0) {
+    JS_FreeValue(ctx, clone);
+    return JS_EXCEPTION;
+  }
 
-    if (JS_IsException(cloned_value)) {
-      JS_FreeValue(ctx, cloned_object);
-      js_free(ctx, props);
-      return JS_EXCEPTION;
+  // Snapshot the entries first: getters run while cloning must not change what gets iterated
+  JSValueConst array_ctor = JSRT_CloneTypesCtor(&state->types, JSRT_CLONE_KIND_ARRAY);
+  if (JS_IsUndefined(state->array_from)) {
+    state->array_from = JS_GetPropertyStr(ctx, array_ctor, "from");
+  }
+  JSValue items = JS_Call(ctx, state->array_from, array_ctor, 1, &collection);
+  JSValue adder = JS_GetPropertyStr(ctx, clone, is_map ? "set" : "add");
+  JSValue length_val = JS_IsException(items) ? JS_EXCEPTION : JS_GetPropertyStr(ctx, items, "length");
+  uint32_t length = 0;
+  bool ok = !JS_IsException(adder) && !JS_IsException(length_val) && !JS_ToUint32(ctx, &length, length_val);
+  JS_FreeValue(ctx, length_val);
+
+  for (uint32_t i = 0; ok && i < length; i++) {
+    JSValue item = JS_GetPropertyUint32(ctx, items, i);
+    JSValue args[2] = {JS_UNDEFINED, JS_UNDEFINED};
+    if (is_map) {
+      JSValue key = JS_GetPropertyUint32(ctx, item, 0);
+      JSValue val = JS_GetPropertyUint32(ctx, item, 1);
+      args[0] = clone_value(state, key);
+      args[1] = JS_IsException(args[0]) ? JS_UNDEFINED : clone_value(state, val);
+      JS_FreeValue(ctx, key);
+      JS_FreeValue(ctx, val);
+    } else {
+      args[0] = clone_value(state, item);
     }
+    JS_FreeValue(ctx, item);
 
-    if (JS_SetProperty(ctx, cloned_object, prop_atom, cloned_value) < 0) {
-      JS_FreeValue(ctx, cloned_value);
-      JS_FreeValue(ctx, cloned_object);
-      js_free(ctx, props);
-      return JS_EXCEPTION;
+    ok = !JS_IsException(args[0]) && !JS_IsException(args[1]);
+    if (ok) {
+      JSValue ret = JS_Call(ctx, adder, clone, is_map ? 2 : 1, args);
+      ok = !JS_IsException(ret);
+      JS_FreeValue(ctx, ret);
     }
+    JS_FreeValue(ctx, args[0]);
+    JS_FreeValue(ctx, args[1]);
   }
 
-  js_free(ctx, props);
-  return cloned_object;
+  JS_FreeValue(ctx, adder);
+  JS_FreeValue(ctx, items);
+  if (!ok) {
+    JS_FreeValue(ctx, clone);
+    return JS_EXCEPTION;
+  }
+  return clone;
 }
 
-static JSValue JSRT_CloneDate(JSContext* ctx, JSValue date) {
-  // Get the time value from the Date object
-  JSValue getTime = JS_GetPropertyStr(ctx, date, "getTime");
-  if (JS_IsException(getTime)) {
+static JSValue clone_error(JSRT_CloneState* state, JSValueConst error) {
+  JSContext* ctx = state->ctx;
+  const char* ctor_name = JSRT_CloneErrorName(ctx, error);
+  JSValue message = JS_GetPropertyStr(ctx, error, "message");
+  if (JS_IsException(message)) {
+    return message;
+  }
+  JSValue global = JS_GetGlobalObject(ctx);
+  JSValue ctor = JS_GetPropertyStr(ctx, global, ctor_name);
+  JS_FreeValue(ctx, global);
+  JSValue clone = JS_CallConstructor(ctx, ctor, JS_IsUndefined(message) ? 0 : 1, &message);
+  JS_FreeValue(ctx, ctor);
+  JS_FreeValue(ctx, message);
+  if (JS_IsException(clone) || clone_map_set(state, error, clone) < 0) {
+    JS_FreeValue(ctx, clone);
     return JS_EXCEPTION;
   }
 
-  JSValue time_val = JS_Call(ctx, getTime, date, 0, NULL);
-  JS_FreeValue(ctx, getTime);
+  // Keep the original stack rather than one pointing here
+  JSValue stack = JS_GetPropertyStr(ctx, error, "stack");
+  if (JS_IsString(stack)) {
+    JS_DefinePropertyValueStr(ctx, clone, "stack", stack, JS_PROP_WRITABLE | JS_PROP_CONFIGURABLE);
+  } else {
+    JS_FreeValue(ctx, stack);
+  }
 
-  if (JS_IsException(time_val)) {
+  JSAtom cause_atom = JS_NewAtom(ctx, "cause");
+  int has_cause = JS_HasProperty(ctx, error, cause_atom);
+  if (has_cause > 0) {
+    JSValue cause = JS_GetProperty(ctx, error, cause_atom);
+    JSValue cause_clone = JS_IsException(cause) ? JS_EXCEPTION : clone_value(state, cause);
+    JS_FreeValue(ctx, cause);
+    if (JS_IsException(cause_clone) ||
+        JS_DefinePropertyValue(ctx, clone, cause_atom, cause_clone, JS_PROP_WRITABLE | JS_PROP_CONFIGURABLE) < 0) {
+      has_cause = -1;
+    }
+  }
+  JS_FreeAtom(ctx, cause_atom);
+  if (has_cause < 0) {
+    JS_FreeValue(ctx, clone);
     return JS_EXCEPTION;
   }
+  return clone;
+}
 
-  // Create new Date with the same time
-  JSValue date_ctor = JS_GetPropertyStr(ctx, JS_GetGlobalObject(ctx), "Date");
-  JSValue cloned_date = JS_CallConstructor(ctx, date_ctor, 1, &time_val);
-  JS_FreeValue(ctx, date_ctor);
-  JS_FreeValue(ctx, time_val);
+// Picks the clone algorithm for an object that has not been cloned yet
+static JSValue clone_object_value(JSRT_CloneState* state, JSValueConst value) {
+  JSContext* ctx = state->ctx;
+  JSRT_CloneKind kind;
+  if (JSRT_CloneClassify(&state->types, value, &kind) < 0) {
+    return JS_EXCEPTION;
+  }
 
-  return cloned_date;
+  switch (kind) {
+    case JSRT_CLONE_KIND_ARRAY:
+      return clone_array(state, value);
+    case JSRT_CLONE_KIND_TYPED_ARRAY:
+      return clone_typed_array(state, value, JS_GetTypedArrayType(value));
+    case JSRT_CLONE_KIND_ERROR:
+      return clone_error(state, value);
+    case JSRT_CLONE_KIND_BLOB: {
+      JSValue clone = JSRT_BlobClone(ctx, value);
+      if (!JS_IsException(clone) && clone_map_set(state, value, clone) < 0) {
+        JS_FreeValue(ctx, clone);
+        return JS_EXCEPTION;
+      }
+      return clone;
+    }
+    case JSRT_CLONE_KIND_MAP:
+    case JSRT_CLONE_KIND_SET:
+      return clone_collection(state, value, kind == JSRT_CLONE_KIND_MAP);
+    case JSRT_CLONE_KIND_ARRAY_BUFFER:
+      return clone_array_buffer(state, value);
+    case JSRT_CLONE_KIND_SHARED_ARRAY_BUFFER:
+      // Shared memory stays shared
+      return JS_DupValue(ctx, value);
+    case JSRT_CLONE_KIND_DATA_VIEW:
+      return clone_data_view(state, value);
+    case JSRT_CLONE_KIND_DATE:
+    case JSRT_CLONE_KIND_REGEXP:
+    case JSRT_CLONE_KIND_BOOLEAN:
+    case JSRT_CLONE_KIND_NUMBER:
+    case JSRT_CLONE_KIND_STRING:
+    case JSRT_CLONE_KIND_BIGINT:
+      return clone_with_constructor(state, value, kind);
+    case JSRT_CLONE_KIND_FUNCTION:
+      return JSRT_CloneThrowError(ctx, "function could not be cloned.");
+    case JSRT_CLONE_KIND_PROMISE:
+    case JSRT_CLONE_KIND_WEAK_MAP:
+    case JSRT_CLONE_KIND_WEAK_SET: {
+      char message[64];
+      snprintf(message, sizeof(message), "#<%s> could not be cloned.", JSRT_CloneKindName(kind));
+      return JSRT_CloneThrowError(ctx, message);
+    }
+    default:
+      // Instances of other classes become plain objects with the same own properties
+      return clone_object(state, value);
+  }
 }
 
-static JSValue JSRT_CloneRegExp(JSContext* ctx, JSValue regexp) {
-  // Get source and flags
-  JSValue source = JS_GetPropertyStr(ctx, regexp, "source");
-  JSValue flags = JS_GetPropertyStr(ctx, regexp, "flags");
-
-  if (JS_IsException(source) || JS_IsException(flags)) {
-    JS_FreeValue(ctx, source);
-    JS_FreeValue(ctx, flags);
-    return JS_EXCEPTION;
+static JSValue clone_value(JSRT_CloneState* state, JSValueConst value) {
+  JSContext* ctx = state->ctx;
+  if (!JS_IsObject(value)) {
+    if (JS_IsSymbol(value)) {
+      return JSRT_CloneThrowError(ctx, "Symbol could not be cloned.");
+    }
+    return JS_DupValue(ctx, value);
   }
 
-  // Create new RegExp
-  JSValue regexp_ctor = JS_GetPropertyStr(ctx, JS_GetGlobalObject(ctx), "RegExp");
-  JSValue args[2] = {source, flags};
-  JSValue cloned_regexp = JS_CallConstructor(ctx, regexp_ctor, 2, args);
+  // Already cloned: cycles and shared references point to the same clone
+  JSValue existing = JSRT_CloneMapGet(&state->map, value);
+  if (!JS_IsUninitialized(existing)) {
+    return existing;
+  }
+  if (state->depth >= JSRT_CLONE_MAX_DEPTH) {
+    return JS_ThrowRangeError(ctx, "Maximum call stack size exceeded");
+  }
 
-  JS_FreeValue(ctx, regexp_ctor);
-  JS_FreeValue(ctx, source);
-  JS_FreeValue(ctx, flags);
+  state->depth++;
+  JSValue clone = clone_object_value(state, value);
+  state->depth--;
+  return clone;
+}
 
-  return cloned_regexp;
+// Detaching frees the store, so buffers native code still reads from or that a Buffer pool shares stay put
+static bool clone_array_buffer_is_pinned(JSContext* ctx, JSValueConst buffer) {
+  size_t size = 0;
+  uint8_t* store = JS_GetArrayBuffer(ctx, &size, buffer);
+  if (!store) {
+    // Detached: clone_array_buffer reports it
+    JS_FreeValue(ctx, JS_GetException(ctx));
+    return false;
+  }
+  return JSRT_BufferIsPinned(store);
 }
 
-static JSValue JSRT_CloneValueInternal(JSContext* ctx, JSValue value, JSRT_CloneMap* map) {
-  uint32_t tag = JS_VALUE_GET_NORM_TAG(value);
+// Reads options.transfer: each ArrayBuffer in it gets its clone up front and is detached once cloning succeeds
+static int clone_read_transfer(JSRT_CloneState* state, JSValueConst options, JSValue** buffers, uint32_t* count) {
+  JSContext* ctx = state->ctx;
+  *buffers = NULL;
+  *count = 0;
+  if (JS_IsUndefined(options) || JS_IsNull(options)) {
+    return 0;
+  }
+  if (!JS_IsObject(options)) {
+    JS_ThrowTypeError(ctx, "The \"options\" argument must be an object");
+    return -1;
+  }
 
-  // Check for circular reference
-  JSValue existing = JSRT_CloneMapGet(map, ctx, value);
-  if (!JS_IsUndefined(existing)) {
-    return existing;
+  JSValue transfer = JS_GetPropertyStr(ctx, options, "transfer");
+  if (JS_IsException(transfer)) {
+    return -1;
+  }
+  if (JS_IsUndefined(transfer)) {
+    return 0;
   }
 
-  switch (tag) {
-    case JS_TAG_NULL:
-    case JS_TAG_UNDEFINED:
-    case JS_TAG_BOOL:
-    case JS_TAG_INT:
-    case JS_TAG_FLOAT64:
-    case JS_TAG_STRING:
-      // Primitive values can be directly duplicated
-      return JS_DupValue(ctx, value);
+  uint32_t length = 0;
+  JSValue length_val = JS_IsObject(transfer) ? JS_GetPropertyStr(ctx, transfer, "length") : JS_UNDEFINED;
+  if (!JS_IsObject(transfer) || JS_IsException(length_val) || JS_ToUint32(ctx, &length, length_val)) {
+    JS_FreeValue(ctx, length_val);
+    JS_FreeValue(ctx, transfer);
+    if (!JS_HasException(ctx)) {
+      JS_ThrowTypeError(ctx, "The \"transfer\" option must be an array");
+    }
+    return -1;
+  }
+  JS_FreeValue(ctx, length_val);
 
-    case JS_TAG_OBJECT: {
-      // Check specific object types
-      JSValue constructor = JS_GetPropertyStr(ctx, value, "constructor");
-      if (!JS_IsException(constructor)) {
-        JSValue name = JS_GetPropertyStr(ctx, constructor, "name");
-        if (!JS_IsException(name)) {
-          const char* name_str = JS_ToCString(ctx, name);
-          if (name_str) {
-            if (strcmp(name_str, "Array") == 0) {
-              JS_FreeCString(ctx, name_str);
-              JS_FreeValue(ctx, name);
-              JS_FreeValue(ctx, constructor);
-              return JSRT_CloneArray(ctx, value, map);
-            } else if (strcmp(name_str, "Date") == 0) {
-              JS_FreeCString(ctx, name_str);
-              JS_FreeValue(ctx, name);
-              JS_FreeValue(ctx, constructor);
-              return JSRT_CloneDate(ctx, value);
-            } else if (strcmp(name_str, "RegExp") == 0) {
-              JS_FreeCString(ctx, name_str);
-              JS_FreeValue(ctx, name);
-              JS_FreeValue(ctx, constructor);
-              return JSRT_CloneRegExp(ctx, value);
-            }
-            JS_FreeCString(ctx, name_str);
-          }
-        }
-        JS_FreeValue(ctx, name);
-      }
-      JS_FreeValue(ctx, constructor);
-
-      // Check if it's an array using Array.isArray
-      JSValue array_ctor = JS_GetPropertyStr(ctx, JS_GetGlobalObject(ctx), "Array");
-      JSValue isArray = JS_GetPropertyStr(ctx, array_ctor, "isArray");
-      JSValue is_array_result = JS_Call(ctx, isArray, JS_UNDEFINED, 1, &value);
-      JS_FreeValue(ctx, array_ctor);
-      JS_FreeValue(ctx, isArray);
-
-      if (!JS_IsException(is_array_result) && JS_ToBool(ctx, is_array_result)) {
-        JS_FreeValue(ctx, is_array_result);
-        return JSRT_CloneArray(ctx, value, map);
-      }
-      JS_FreeValue(ctx, is_array_result);
+  *buffers = js_mallocz(ctx, sizeof(JSValue) * (length ? length : 1));
+  if (!*buffers) {
+    JS_FreeValue(ctx, transfer);
+    return -1;
+  }
 
-      // Default to object cloning
-      return JSRT_CloneObject(ctx, value, map);
+  int ret = 0;
+  for (uint32_t i = 0; i < length && ret == 0; i++) {
+    JSValue item = JS_GetPropertyUint32(ctx, transfer, i);
+    JSValueConst array_buffer_ctor = JSRT_CloneTypesCtor(&state->types, JSRT_CLONE_KIND_ARRAY_BUFFER);
+    int is_buffer = JS_IsException(item) ? -1 : JS_IsInstanceOf(ctx, item, array_buffer_ctor);
+    if (is_buffer < 0) {
+      ret = -1;
+    } else if (!is_buffer) {
+      JSRT_CloneThrowError(ctx, "Value not transferable");
+      ret = -1;
+    } else {
+      JSValue existing = JSRT_CloneMapGet(&state->map, item);
+      if (!JS_IsUninitialized(existing)) {
+        JS_FreeValue(ctx, existing);
+        JSRT_CloneThrowError(ctx, "ArrayBuffer appears more than once in the transfer list");
+        ret = -1;
+      } else if (clone_array_buffer_is_pinned(ctx, item)) {
+        JSRT_CloneThrowError(ctx, "Cannot transfer an ArrayBuffer that is in use");
+        ret = -1;
+      } else {
+        JSValue clone = clone_array_buffer(state, item);
+        ret = JS_IsException(clone) ? -1 : 0;
+        JS_FreeValue(ctx, clone);
+      }
     }
 
-    default:
-      // Unsupported type
-      return JS_ThrowTypeError(ctx, "Cannot clone this type of value");
+    if (ret == 0) {
+      (*buffers)[(*count)++] = item;
+    } else {
+      JS_FreeValue(ctx, item);
+    }
   }
+  JS_FreeValue(ctx, transfer);
+  return ret;
 }
 
 static JSValue JSRT_StructuredClone(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
@@ -282,10 +714,26 @@ static JSValue JSRT_StructuredClone(JSContext* ctx, JSValueConst this_val, int a
     return JS_ThrowTypeError(ctx, "structuredClone requires 1 argument");
   }
 
-  JSRT_CloneMap* map = JSRT_CloneMapNew();
-  JSValue result = JSRT_CloneValueInternal(ctx, argv[0], map);
-  JSRT_CloneMapFree(ctx, map);
+  JSRT_CloneState state;
+  clone_state_init(ctx, &state);
 
+  JSValue* transfer = NULL;
+  uint32_t transfer_count = 0;
+  JSValue result = JS_EXCEPTION;
+  if (clone_read_transfer(&state, argc > 1 ? argv[1] : JS_UNDEFINED, &transfer, &transfer_count) == 0) {
+    result = clone_value(&state, argv[0]);
+  }
+
+  // Transferred buffers now belong to the clone; the QuickJS API cannot hand the memory over, so the
+  // clone holds a copy and the original is detached.
+  for (uint32_t i = 0; i < transfer_count; i++) {
+    if (!JS_IsException(result)) {
+      JS_DetachArrayBuffer(ctx, transfer[i]);
+    }
+    JS_FreeValue(ctx, transfer[i]);
+  }
+  js_free(ctx, transfer);
+  clone_state_free(&state);
   return result;
 }
 
@@ -300,4 +748,4 @@ void JSRT_RuntimeSetupStdClone(JSRT_Runtime* rt) {
                     JS_NewCFunction(ctx, JSRT_StructuredClone, "structuredClone", 1));
 
   JSRT_Debug("Structured Clone API setup completed");
-}
\ No newline at end of file
+}
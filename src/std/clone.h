@@ -1,8 +1,80 @@
 #ifndef __JSRT_STD_CLONE_H__
 #define __JSRT_STD_CLONE_H__
 
+#include <quickjs.h>
+#include <stdint.h>
+
 #include "../runtime.h"
 
 void JSRT_RuntimeSetupStdClone(JSRT_Runtime* rt);
 
-#endif
\ No newline at end of file
+// Building blocks of structuredClone(), shared with the node:v8 serializer
+
+// Objects visited so far, keyed by identity, each with a value (its clone, or an id)
+typedef struct {
+  JSContext* ctx;
+  struct JSRT_CloneEntry* entries;  // Open addressing with linear probing
+  uint32_t capacity;                // Power of two, 0 until the first object
+  uint32_t count;
+} JSRT_CloneMap;
+
+void JSRT_CloneMapInit(JSContext* ctx, JSRT_CloneMap* map);
+void JSRT_CloneMapFree(JSRT_CloneMap* map);
+// As JSRT_CloneMapFree, from the finalizer of an object owning the map
+void JSRT_CloneMapFreeRT(JSRuntime* rt, JSRT_CloneMap* map);
+// Marks the entries for the cycle collector, from the gc_mark of an object owning the map
+void JSRT_CloneMapMark(JSRuntime* rt, JSRT_CloneMap* map, JS_MarkFunc* mark_func);
+// Value stored for obj, or JS_UNINITIALIZED
+JSValue JSRT_CloneMapGet(JSRT_CloneMap* map, JSValueConst obj);
+// Stores value for obj (an object not in the map yet); returns -1 when out of memory
+int JSRT_CloneMapSet(JSRT_CloneMap* map, JSValueConst obj, JSValueConst value);
+
+// What the structured clone algorithm makes of an object
+typedef enum {
+  JSRT_CLONE_KIND_OBJECT,  // Own enumerable string-keyed properties, whatever the class
+  JSRT_CLONE_KIND_ARRAY,
+  JSRT_CLONE_KIND_TYPED_ARRAY,
+  JSRT_CLONE_KIND_ERROR,
+  JSRT_CLONE_KIND_BLOB,
+  JSRT_CLONE_KIND_FUNCTION,
+  // Found with instanceof
+  JSRT_CLONE_KIND_DATE,
+  JSRT_CLONE_KIND_REGEXP,
+  JSRT_CLONE_KIND_MAP,
+  JSRT_CLONE_KIND_SET,
+  JSRT_CLONE_KIND_ARRAY_BUFFER,
+  JSRT_CLONE_KIND_SHARED_ARRAY_BUFFER,
+  JSRT_CLONE_KIND_DATA_VIEW,
+  JSRT_CLONE_KIND_BOOLEAN,
+  JSRT_CLONE_KIND_NUMBER,
+  JSRT_CLONE_KIND_STRING,
+  JSRT_CLONE_KIND_BIGINT,
+  JSRT_CLONE_KIND_PROMISE,
+  JSRT_CLONE_KIND_WEAK_MAP,
+  JSRT_CLONE_KIND_WEAK_SET,
+  JSRT_CLONE_KIND_COUNT
+} JSRT_CloneKind;
+
+// Built-ins objects are classified against, looked up once per traversal
+typedef struct {
+  JSContext* ctx;
+  JSValue object_proto;                  // Objects with this prototype (or none) skip the instanceof checks
+  JSValue ctors[JSRT_CLONE_KIND_COUNT];  // Fetched on first use, JS_NULL if missing
+} JSRT_CloneTypes;
+
+void JSRT_CloneTypesInit(JSContext* ctx, JSRT_CloneTypes* types);
+void JSRT_CloneTypesFree(JSRT_CloneTypes* types);
+// Sets *kind for obj; returns -1 if a Proxy trap threw
+int JSRT_CloneClassify(JSRT_CloneTypes* types, JSValueConst obj, JSRT_CloneKind* kind);
+// Constructor of a kind found with instanceof, e.g. Map for JSRT_CLONE_KIND_MAP
+JSValueConst JSRT_CloneTypesCtor(JSRT_CloneTypes* types, JSRT_CloneKind kind);
+// Global name of the built-in behind a kind, for error messages
+const char* JSRT_CloneKindName(JSRT_CloneKind kind);
+
+// Standard error constructor for an error's name: one of the native error types, else "Error"
+const char* JSRT_CloneErrorName(JSContext* ctx, JSValueConst error);
+
+// Throws a DOMException named DataCloneError (a TypeError if DOMException is missing)
+JSValue JSRT_CloneThrowError(JSContext* ctx, const char* message);
+
+#endif
@@ -17,6 +17,7 @@
 
 #include "../util/colorize.h"
 #include "../util/dbuf.h"
+#include "../util/macro.h"
 
 // Platform-specific function implementations
 #ifdef _WIN32
@@ -74,17 +75,17 @@ typedef struct {
   int count;
 } ConsoleCounter;
 
-static ConsoleTimer* timers = NULL;
-static char** timer_labels = NULL;
-static int timer_count = 0;
-static int timer_capacity = 0;
+static JSRT_THREAD_LOCAL ConsoleTimer* timers = NULL;
+static JSRT_THREAD_LOCAL char** timer_labels = NULL;
+static JSRT_THREAD_LOCAL int timer_count = 0;
+static JSRT_THREAD_LOCAL int timer_capacity = 0;
 
-static ConsoleCounter* counters = NULL;
-static char** counter_labels = NULL;
-static int counter_count = 0;
-static int counter_capacity = 0;
+static JSRT_THREAD_LOCAL ConsoleCounter* counters = NULL;
+static JSRT_THREAD_LOCAL char** counter_labels = NULL;
+static JSRT_THREAD_LOCAL int counter_count = 0;
+static JSRT_THREAD_LOCAL int counter_capacity = 0;
 
-static int group_level = 0;
+static JSRT_THREAD_LOCAL int group_level = 0;
 
 void JSRT_RuntimeSetupStdConsole(JSRT_Runtime* rt) {
   // Create a clean prototype for the console namespace object
@@ -9,6 +9,7 @@
 
 #include "../util/dbuf.h"
 #include "../util/debug.h"
+#include "../util/unicode.h"
 
 // Encoding labels table for WPT compatibility
 // Based on https://encoding.spec.whatwg.org/encodings.json
@@ -428,112 +429,6 @@ static const char* get_canonical_encoding(const char* label) {
   return "utf-8";
 }
 
-// UTF-8 validation function with overlong sequence detection
-static int validate_utf8_sequence(const uint8_t* data, size_t len, const uint8_t** next) {
-  if (len == 0) {
-    *next = data;
-    return -1;
-  }
-
-  uint8_t c = data[0];
-
-  if (c < 0x80) {
-    // ASCII character
-    *next = data + 1;
-    return c;
-  }
-
-  // Invalid start bytes
-  if (c == 0xFE || c == 0xFF || (c >= 0xF8 && c <= 0xFD)) {
-    *next = data;
-    return -1;
-  }
-
-  if ((c & 0xE0) == 0xC0) {
-    // 2-byte sequence
-    if (len < 2) {
-      *next = data;
-      return -1;
-    }
-    if ((data[1] & 0xC0) != 0x80) {
-      *next = data;
-      return -1;
-    }
-
-    uint32_t codepoint = ((c & 0x1F) << 6) | (data[1] & 0x3F);
-
-    // Check for overlong encoding: 2-byte sequences must encode >= U+0080
-    if (codepoint < 0x80) {
-      *next = data;
-      return -1;  // Overlong sequence
-    }
-
-    *next = data + 2;
-    return codepoint;
-  }
-
-  if ((c & 0xF0) == 0xE0) {
-    // 3-byte sequence
-    if (len < 3) {
-      *next = data;
-      return -1;
-    }
-    if ((data[1] & 0xC0) != 0x80 || (data[2] & 0xC0) != 0x80) {
-      *next = data;
-      return -1;
-    }
-
-    uint32_t codepoint = ((c & 0x0F) << 12) | ((data[1] & 0x3F) << 6) | (data[2] & 0x3F);
-
-    // Check for overlong encoding: 3-byte sequences must encode >= U+0800
-    if (codepoint < 0x800) {
-      *next = data;
-      return -1;  // Overlong sequence
-    }
-
-    // Check for UTF-16 surrogates (U+D800 to U+DFFF)
-    if (codepoint >= 0xD800 && codepoint <= 0xDFFF) {
-      *next = data;
-      return -1;  // Surrogates not allowed in UTF-8
-    }
-
-    *next = data + 3;
-    return codepoint;
-  }
-
-  if ((c & 0xF8) == 0xF0) {
-    // 4-byte sequence
-    if (len < 4) {
-      *next = data;
-      return -1;
-    }
-    if ((data[1] & 0xC0) != 0x80 || (data[2] & 0xC0) != 0x80 || (data[3] & 0xC0) != 0x80) {
-      *next = data;
-      return -1;
-    }
-
-    uint32_t codepoint = ((c & 0x07) << 18) | ((data[1] & 0x3F) << 12) | ((data[2] & 0x3F) << 6) | (data[3] & 0x3F);
-
-    // Check for overlong encoding: 4-byte sequences must encode >= U+10000
-    if (codepoint < 0x10000) {
-      *next = data;
-      return -1;  // Overlong sequence
-    }
-
-    // Check for codepoints beyond Unicode range (> U+10FFFF)
-    if (codepoint > 0x10FFFF) {
-      *next = data;
-      return -1;  // Beyond Unicode range
-    }
-
-    *next = data + 4;
-    return codepoint;
-  }
-
-  *next = data;
-  return -1;  // Invalid start byte
-}
-
 // Forward declare class IDs so they can be used in finalizers
 static JSClassID JSRT_TextEncoderClassID;
 static JSClassID JSRT_TextDecoderClassID;
@@ -589,94 +484,14 @@ char* JSRT_StringToUTF8WithSurrogateReplacement(JSContext* ctx, JSValue string_v
     return NULL;
   }
 
-  // Process CESU-8 input, replacing surrogate sequences with U+FFFD
-  size_t output_capacity = input_len * 2;
-  uint8_t* output = malloc(output_capacity);
+  // Joining pairs and replacing lone surrogates never makes the string longer
+  uint8_t* output = malloc(input_len + 1);
   if (!output) {
     JS_FreeCString(ctx, input);
     return NULL;
   }
 
-  size_t processed_len = 0;
-  size_t i = 0;
-
-  while (i < input_len) {
-    uint8_t b1 = (uint8_t)input[i];
-
-    if (b1 < 0x80) {
-      // ASCII - copy as-is
-      output[processed_len++] = b1;
-      i++;
-    } else if ((b1 & 0xE0) == 0xC0) {
-      // 2-byte UTF-8 - copy as-is (no surrogates here)
-      if (i + 1 < input_len) {
-        output[processed_len++] = b1;
-        output[processed_len++] = (uint8_t)input[i + 1];
-        i += 2;
-      } else {
-        i++;
-      }
-    } else if ((b1 & 0xF0) == 0xE0) {
-      // 3-byte UTF-8 - check for surrogates (0xED 0xA0-0xAF or 0xED 0xB0-0xBF)
-      if (i + 2 < input_len) {
-        uint8_t b2 = (uint8_t)input[i + 1];
-        uint8_t b3 = (uint8_t)input[i + 2];
-
-        // Check if this is a surrogate in CESU-8
-        if (b1 == 0xED && (b2 & 0xF0) == 0xA0) {
-          // This is a high surrogate (0xED 0xA0-0xAF)
-          // Check if followed by a low surrogate (0xED 0xB0-0xBF)
-          if (i + 5 < input_len && (uint8_t)input[i + 3] == 0xED && ((uint8_t)input[i + 4] & 0xF0) == 0xB0) {
-            // Valid surrogate pair - decode to proper UTF-8
-            uint16_t high = 0xD800 | ((b2 & 0x0F) << 6) | (b3 & 0x3F);
-            uint16_t low = 0xDC00 | (((uint8_t)input[i + 4] & 0x0F) << 6) | ((uint8_t)input[i + 5] & 0x3F);
-            uint32_t codepoint = 0x10000 + ((high & 0x3FF) << 10) + (low & 0x3FF);
-
-            // Encode as 4-byte UTF-8
-            output[processed_len++] = 0xF0 | (codepoint >> 18);
-            output[processed_len++] = 0x80 | ((codepoint >> 12) & 0x3F);
-            output[processed_len++] = 0x80 | ((codepoint >> 6) & 0x3F);
-            output[processed_len++] = 0x80 | (codepoint & 0x3F);
-            i += 6;  // Skip both surrogate sequences
-            continue;
-          } else {
-            // Lone high surrogate - replace with U+FFFD
-            output[processed_len++] = 0xEF;
-            output[processed_len++] = 0xBF;
-            output[processed_len++] = 0xBD;
-          }
-        } else if (b1 == 0xED && (b2 & 0xF0) == 0xB0) {
-          // This is a low surrogate without preceding high surrogate - replace with U+FFFD
-          output[processed_len++] = 0xEF;
-          output[processed_len++] = 0xBF;
-          output[processed_len++] = 0xBD;
-        } else {
-          // Regular 3-byte character - copy as-is
-          output[processed_len++] = b1;
-          output[processed_len++] = b2;
-          output[processed_len++] = b3;
-        }
-        i += 3;
-      } else {
-        i++;
-      }
-    } else if ((b1 & 0xF8) == 0xF0) {
-      // 4-byte UTF-8 - copy as-is (already proper UTF-8)
-      if (i + 3 < input_len) {
-        output[processed_len++] = b1;
-        output[processed_len++] = (uint8_t)input[i + 1];
-        output[processed_len++] = (uint8_t)input[i + 2];
-        output[processed_len++] = (uint8_t)input[i + 3];
-        i += 4;
-      } else {
-        i++;
-      }
-    } else {
-      // Invalid byte - skip
-      i++;
-    }
-  }
-
+  size_t processed_len = JSRT_CESU8ToUTF8((const uint8_t*)input, input_len, output, input_len, NULL);
   JS_FreeCString(ctx, input);
 
   // Null-terminate the result
@@ -686,6 +501,10 @@ char* JSRT_StringToUTF8WithSurrogateReplacement(JSContext* ctx, JSValue string_v
   return (char*)output;
 }
 
+static void JSRT_TextEncoderFreeOutput(JSRuntime* rt, void* opaque, void* ptr) {
+  js_free_rt(rt, ptr);
+}
+
 static JSValue JSRT_TextEncoderEncode(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
   JSRT_TextEncoder* encoder = JS_GetOpaque2(ctx, this_val, JSRT_TextEncoderClassID);
   if (!encoder) {
@@ -694,18 +513,7 @@ static JSValue JSRT_TextEncoderEncode(JSContext* ctx, JSValueConst this_val, int
 
   // Handle default case (no argument or undefined)
   if (argc == 0 || JS_IsUndefined(argv[0])) {
-    JSValue array_buffer = JS_NewArrayBufferCopy(ctx, NULL, 0);
-    if (JS_IsException(array_buffer)) {
-      return JS_EXCEPTION;
-    }
-
-    JSValue global = JS_GetGlobalObject(ctx);
-    JSValue uint8_array_ctor = JS_GetPropertyStr(ctx, global, "Uint8Array");
-    JSValue uint8_array = JS_CallConstructor(ctx, uint8_array_ctor, 1, &array_buffer);
-    JS_FreeValue(ctx, uint8_array_ctor);
-    JS_FreeValue(ctx, global);
-    JS_FreeValue(ctx, array_buffer);
-    return uint8_array;
+    return JS_NewUint8ArrayCopy(ctx, NULL, 0);
   }
 
   // Convert to string first if needed
@@ -717,117 +525,28 @@ static JSValue JSRT_TextEncoderEncode(JSContext* ctx, JSValueConst this_val, int
   // Get string as CESU-8 bytes to detect surrogates
   size_t input_len;
   const char* input = JS_ToCStringLen2(ctx, &input_len, string_val, 1);  // cesu8=1
+  JS_FreeValue(ctx, string_val);
   if (!input) {
-    JS_FreeValue(ctx, string_val);
     return JS_EXCEPTION;
   }
 
-  // Process CESU-8 input, replacing surrogate sequences with U+FFFD
-  size_t output_capacity = input_len * 2;
-  uint8_t* output = malloc(output_capacity);
+  uint8_t* output = js_malloc(ctx, input_len + 1);
   if (!output) {
     JS_FreeCString(ctx, input);
-    JS_FreeValue(ctx, string_val);
     return JS_EXCEPTION;
   }
-
-  size_t output_len = 0;
-  size_t i = 0;
-
-  while (i < input_len) {
-    uint8_t b1 = (uint8_t)input[i];
-
-    if (b1 < 0x80) {
-      // ASCII - copy as-is
-      output[output_len++] = b1;
-      i++;
-    } else if ((b1 & 0xE0) == 0xC0) {
-      // 2-byte UTF-8 - copy as-is (no surrogates here)
-      if (i + 1 < input_len) {
-        output[output_len++] = b1;
-        output[output_len++] = (uint8_t)input[i + 1];
-        i += 2;
-      } else {
-        i++;
-      }
-    } else if ((b1 & 0xF0) == 0xE0) {
-      // 3-byte UTF-8 - check for surrogates (0xED 0xA0-0xAF or 0xED 0xB0-0xBF)
-      if (i + 2 < input_len) {
-        uint8_t b2 = (uint8_t)input[i + 1];
-        uint8_t b3 = (uint8_t)input[i + 2];
-
-        // Check if this is a surrogate in CESU-8
-        if (b1 == 0xED && (b2 & 0xF0) == 0xA0) {
-          // This is a high surrogate (0xED 0xA0-0xAF)
-          // Check if followed by a low surrogate (0xED 0xB0-0xBF)
-          if (i + 5 < input_len && (uint8_t)input[i + 3] == 0xED && ((uint8_t)input[i + 4] & 0xF0) == 0xB0) {
-            // Valid surrogate pair - decode to proper UTF-8
-            uint16_t high = 0xD800 | ((b2 & 0x0F) << 6) | (b3 & 0x3F);
-            uint16_t low = 0xDC00 | (((uint8_t)input[i + 4] & 0x0F) << 6) | ((uint8_t)input[i + 5] & 0x3F);
-            uint32_t codepoint = 0x10000 + ((high & 0x3FF) << 10) + (low & 0x3FF);
-
-            // Encode as 4-byte UTF-8
-            output[output_len++] = 0xF0 | (codepoint >> 18);
-            output[output_len++] = 0x80 | ((codepoint >> 12) & 0x3F);
-            output[output_len++] = 0x80 | ((codepoint >> 6) & 0x3F);
-            output[output_len++] = 0x80 | (codepoint & 0x3F);
-            i += 6;  // Skip both surrogate sequences
-            continue;
-          } else {
-            // Lone high surrogate - replace with U+FFFD
-            output[output_len++] = 0xEF;
-            output[output_len++] = 0xBF;
-            output[output_len++] = 0xBD;
-          }
-        } else if (b1 == 0xED && (b2 & 0xF0) == 0xB0) {
-          // This is a low surrogate without preceding high surrogate - replace with U+FFFD
-          output[output_len++] = 0xEF;
-          output[output_len++] = 0xBF;
-          output[output_len++] = 0xBD;
-        } else {
-          // Regular 3-byte character - copy as-is
-          output[output_len++] = b1;
-          output[output_len++] = b2;
-          output[output_len++] = b3;
-        }
-        i += 3;
-      } else {
-        i++;
-      }
-    } else if ((b1 & 0xF8) == 0xF0) {
-      // 4-byte UTF-8 - copy as-is (already proper UTF-8)
-      if (i + 3 < input_len) {
-        output[output_len++] = b1;
-        output[output_len++] = (uint8_t)input[i + 1];
-        output[output_len++] = (uint8_t)input[i + 2];
-        output[output_len++] = (uint8_t)input[i + 3];
-        i += 4;
-      } else {
-        i++;
-      }
-    } else {
-      // Invalid byte - skip
-      i++;
-    }
-  }
-
-  // Create Uint8Array with the processed UTF-8 bytes
-  JSValue array_buffer = JS_NewArrayBufferCopy(ctx, output, output_len);
-  free(output);
+  size_t output_len = JSRT_CESU8ToUTF8((const uint8_t*)input, input_len, output, input_len, NULL);
   JS_FreeCString(ctx, input);
-  JS_FreeValue(ctx, string_val);
 
+  // The ArrayBuffer takes ownership of the output instead of copying it
+  JSValue array_buffer = JS_NewArrayBuffer(ctx, output, output_len, JSRT_TextEncoderFreeOutput, NULL, false);
   if (JS_IsException(array_buffer)) {
+    js_free(ctx, output);
     return JS_EXCEPTION;
   }
 
-  JSValue global = JS_GetGlobalObject(ctx);
-  JSValue uint8_array_ctor = JS_GetPropertyStr(ctx, global, "Uint8Array");
-  JSValue uint8_array = JS_CallConstructor(ctx, uint8_array_ctor, 1, &array_buffer);
-  JS_FreeValue(ctx, uint8_array_ctor);
-  JS_FreeValue(ctx, global);
+  JSValue uint8_array = JS_NewTypedArray(ctx, 1, &array_buffer, JS_TYPED_ARRAY_UINT8);
   JS_FreeValue(ctx, array_buffer);
-
   return uint8_array;
 }
 
@@ -859,115 +578,71 @@ static JSValue JSRT_TextEncoderEncodeInto(JSContext* ctx, JSValueConst this_val,
   // Get the string as CESU-8 bytes, same as encode() method
   size_t str_len;
   const char* str_data = JS_ToCStringLen2(ctx, &str_len, string_val, 1);  // cesu8=1
+  JS_FreeValue(ctx, string_val);
   if (!str_data) {
-    JS_FreeValue(ctx, string_val);
     return JS_EXCEPTION;
   }
 
-  // Get destination Uint8Array
-  JSValue destination = argv[1];
-  size_t byte_offset, dest_byte_length;
-  JSValue array_buffer = JS_GetTypedArrayBuffer(ctx, destination, &byte_offset, &dest_byte_length, NULL);
-  if (JS_IsException(array_buffer)) {
-    JS_FreeCString(ctx, str_data);
-    JS_FreeValue(ctx, string_val);
-    return JS_ThrowTypeError(ctx, "destination must be a Uint8Array");
-  }
-
-  uint8_t* dest_buffer = JS_GetArrayBuffer(ctx, &dest_byte_length, array_buffer);
+  // Get destination Uint8Array (its own window of the underlying buffer)
+  size_t dest_byte_length;
+  uint8_t* dest_buffer = JS_GetUint8Array(ctx, &dest_byte_length, argv[1]);
   if (!dest_buffer) {
     JS_FreeCString(ctx, str_data);
-    JS_FreeValue(ctx, string_val);
-    JS_FreeValue(ctx, array_buffer);
-    return JS_EXCEPTION;
-  }
-
-  // Apply the same surrogate processing as encode()
-  const uint8_t* input = (const uint8_t*)str_data;
-  size_t input_pos = 0;
-  size_t output_pos = 0;
-  size_t code_units_read = 0;
-
-  while (input_pos < str_len && output_pos < dest_byte_length) {
-    if (input[input_pos] < 0x80) {
-      // ASCII - copy as-is
-      dest_buffer[byte_offset + output_pos++] = input[input_pos++];
-      code_units_read++;
-    } else if ((input[input_pos] & 0xE0) == 0xC0) {
-      // 2-byte UTF-8 - copy as-is
-      if (input_pos + 1 < str_len && output_pos + 1 < dest_byte_length) {
-        dest_buffer[byte_offset + output_pos++] = input[input_pos++];
-        dest_buffer[byte_offset + output_pos++] = input[input_pos++];
-        code_units_read++;
-      } else {
-        break;
-      }
-    } else if ((input[input_pos] & 0xF0) == 0xE0) {
-      // 3-byte UTF-8 - check for surrogates
-      if (input_pos + 2 < str_len) {
-        uint32_t cp =
-            ((input[input_pos] & 0x0F) << 12) | ((input[input_pos + 1] & 0x3F) << 6) | (input[input_pos + 2] & 0x3F);
-        if (cp >= 0xD800 && cp <= 0xDFFF) {
-          // Surrogate - replace with U+FFFD (0xEF 0xBF 0xBD)
-          if (output_pos + 2 < dest_byte_length) {
-            dest_buffer[byte_offset + output_pos++] = 0xEF;
-            dest_buffer[byte_offset + output_pos++] = 0xBF;
-            dest_buffer[byte_offset + output_pos++] = 0xBD;
-            code_units_read++;
-          } else {
-            break;
-          }
-        } else {
-          // Regular character - copy as-is
-          if (output_pos + 2 < dest_byte_length) {
-            dest_buffer[byte_offset + output_pos++] = input[input_pos];
-            dest_buffer[byte_offset + output_pos++] = input[input_pos + 1];
-            dest_buffer[byte_offset + output_pos++] = input[input_pos + 2];
-            code_units_read++;
-          } else {
-            break;
-          }
-        }
-        input_pos += 3;
-      } else {
-        break;
-      }
-    } else if ((input[input_pos] & 0xF8) == 0xF0) {
-      // 4-byte UTF-8 - copy as-is
-      if (input_pos + 3 < str_len && output_pos + 3 < dest_byte_length) {
-        dest_buffer[byte_offset + output_pos++] = input[input_pos++];
-        dest_buffer[byte_offset + output_pos++] = input[input_pos++];
-        dest_buffer[byte_offset + output_pos++] = input[input_pos++];
-        dest_buffer[byte_offset + output_pos++] = input[input_pos++];
-        code_units_read += 2;  // 4-byte UTF-8 represents 2 UTF-16 code units
-      } else {
-        break;
-      }
-    } else {
-      // Invalid byte - skip
-      input_pos++;
-    }
+    return JS_ThrowTypeError(ctx, "destination must be a Uint8Array");
   }
 
+  // Same conversion as encode(), stopping before the first character that does not fit
+  size_t code_units_read;
+  size_t written =
+      JSRT_CESU8ToUTF8((const uint8_t*)str_data, str_len, dest_buffer, dest_byte_length, &code_units_read);
   JS_FreeCString(ctx, str_data);
-  JS_FreeValue(ctx, string_val);
-  JS_FreeValue(ctx, array_buffer);
 
   // Return result object with read and written properties
   JSValue result = JS_NewObject(ctx);
   JS_SetPropertyStr(ctx, result, "read", JS_NewUint32(ctx, code_units_read));
-  JS_SetPropertyStr(ctx, result, "written", JS_NewUint32(ctx, output_pos));
+  JS_SetPropertyStr(ctx, result, "written", JS_NewUint32(ctx, written));
 
   return result;
 }
 
 // TextDecoder implementation
+
+// Decoders that exist; the encoding is resolved once in the constructor
+typedef enum {
+  JSRT_TEXT_DECODER_UTF8,
+  JSRT_TEXT_DECODER_UTF16LE,
+  JSRT_TEXT_DECODER_UTF16BE,
+  JSRT_TEXT_DECODER_WINDOWS_1252,
+} JSRT_TextDecoderKind;
+
 typedef struct {
   const char* encoding;
+  JSRT_TextDecoderKind kind;
   bool fatal;
   bool ignore_bom;
 } JSRT_TextDecoder;
 
+// windows-1252 bytes 0x80-0x9F; the rest of the range maps to the same code point (Latin-1)
+static const uint16_t windows_1252_high[32] = {
+    0x20AC, 0x0081, 0x201A, 0x0192, 0x201E, 0x2026, 0x2020, 0x2021, 0x02C6, 0x2030, 0x0160,
+    0x2039, 0x0152, 0x008D, 0x017D, 0x008F, 0x0090, 0x2018, 0x2019, 0x201C, 0x201D, 0x2022,
+    0x2013, 0x2014, 0x02DC, 0x2122, 0x0161, 0x203A, 0x0153, 0x009D, 0x017E, 0x0178,
+};
+
+static JSRT_TextDecoderKind get_decoder_kind(const char* canonical) {
+  if (strcmp(canonical, "utf-16le") == 0 || strcmp(canonical, "UTF-16LE") == 0) {
+    return JSRT_TEXT_DECODER_UTF16LE;
+  }
+  if (strcmp(canonical, "utf-16be") == 0 || strcmp(canonical, "UTF-16BE") == 0) {
+    return JSRT_TEXT_DECODER_UTF16BE;
+  }
+  if (strcmp(canonical, "windows-1252") == 0) {
+    return JSRT_TEXT_DECODER_WINDOWS_1252;
+  }
+  // Other legacy encodings have no decoder of their own and are read as UTF-8
+  return JSRT_TEXT_DECODER_UTF8;
+}
+
 static void JSRT_TextDecoderFinalize(JSRuntime* rt, JSValue val) {
   JSRT_TextDecoder* decoder = JS_GetOpaque(val, JSRT_TextDecoderClassID);
   if (decoder) {
@@ -1002,6 +677,7 @@ static JSValue JSRT_TextDecoderConstructor(JSContext* ctx, JSValueConst new_targ
   // Get canonical encoding name
   const char* canonical = get_canonical_encoding(encoding_label);
   decoder->encoding = canonical;
+  decoder->kind = get_decoder_kind(canonical);
   decoder->fatal = false;
   decoder->ignore_bom = false;
 
@@ -1049,443 +725,156 @@ static JSValue JSRT_TextDecoderConstructor(JSContext* ctx, JSValueConst new_targ
   return obj;
 }
 
-static JSValue JSRT_TextDecoderDecode(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
-  JSRT_TextDecoder* decoder = JS_GetOpaque2(ctx, this_val, JSRT_TextDecoderClassID);
-  if (!decoder) {
-    return JS_EXCEPTION;
-  }
+// Bytes viewed by an ArrayBuffer, typed array or DataView; throws and returns NULL for anything else
+static const uint8_t* get_decoder_input(JSContext* ctx, JSValueConst input, size_t* len) {
+  size_t byte_offset = 0, buffer_size;
+  JSValue array_buffer;
 
-  if (argc == 0 || JS_IsUndefined(argv[0])) {
-    return JS_NewString(ctx, "");
-  }
-
-  uint8_t* input_data = NULL;
-  size_t input_len = 0;
-
-  // Try to get as ArrayBuffer first
-  input_data = JS_GetArrayBuffer(ctx, &input_len, argv[0]);
-
-  if (input_data) {
-    // ArrayBuffer path
-    if (input_len == 0) {
-      return JS_NewString(ctx, "");
+  if (JS_GetTypedArrayType(input) >= 0) {
+    array_buffer = JS_GetTypedArrayBuffer(ctx, input, &byte_offset, len, NULL);
+    if (JS_IsException(array_buffer)) {
+      return NULL;
     }
-
-    // Skip BOM if not ignoring it and present
-    size_t start_pos = 0;
-    if (!decoder->ignore_bom && input_len >= 3 && input_data[0] == 0xEF && input_data[1] == 0xBB &&
-        input_data[2] == 0xBF) {
-      start_pos = 3;
+  } else {
+    uint8_t* data = JS_GetArrayBuffer(ctx, len, input);
+    if (data) {
+      return data;
     }
+    JS_FreeValue(ctx, JS_GetException(ctx));
 
-    // Validate input if fatal mode is enabled
-    if (decoder->fatal) {
-      if (strcmp(decoder->encoding, "utf-8") == 0) {
-        // Validate UTF-8 sequence
-        const uint8_t* p = input_data + start_pos;
-        const uint8_t* end = input_data + input_len;
-        while (p < end) {
-          const uint8_t* p_next;
-          int c = validate_utf8_sequence(p, end - p, &p_next);
-          if (c < 0) {
-            return JS_ThrowTypeError(ctx, "Invalid UTF-8 sequence");
-          }
-          p = p_next;
-        }
-      } else if (strcmp(decoder->encoding, "utf-16le") == 0) {
-        // Validate UTF-16LE: must have even number of bytes for complete code units
-        size_t remaining_len = input_len - start_pos;
-        if (remaining_len % 2 != 0) {
-          return JS_ThrowTypeError(ctx, "Incomplete UTF-16LE code unit");
-        }
-        // Additional UTF-16LE validation could be added here for surrogate pairs, etc.
-      } else if (strcmp(decoder->encoding, "utf-16be") == 0) {
-        // Validate UTF-16BE: must have even number of bytes for complete code units
-        size_t remaining_len = input_len - start_pos;
-        if (remaining_len % 2 != 0) {
-          return JS_ThrowTypeError(ctx, "Incomplete UTF-16BE code unit");
-        }
-      }
-      // For other encodings, we don't implement strict validation in this server runtime
+    // DataView: get its buffer, byteOffset, and byteLength
+    JSValue global = JS_GetGlobalObject(ctx);
+    JSValue dataview_ctor = JS_GetPropertyStr(ctx, global, "DataView");
+    int is_dataview = JS_IsObject(dataview_ctor) ? JS_IsInstanceOf(ctx, input, dataview_ctor) : 0;
+    JS_FreeValue(ctx, dataview_ctor);
+    JS_FreeValue(ctx, global);
+    if (is_dataview <= 0) {
+      JS_ThrowTypeError(ctx, "input must be an ArrayBuffer, typed array, or DataView");
+      return NULL;
     }
 
-    // Handle different encodings
-    if (strcmp(decoder->encoding, "utf-16le") == 0 || strcmp(decoder->encoding, "UTF-16LE") == 0) {
-      // UTF-16LE decoding
-      size_t remaining_len = input_len - start_pos;
-      const uint8_t* utf16_data = input_data + start_pos;
-
-      size_t utf8_capacity = remaining_len * 3 + 1;
-      char* utf8_output = malloc(utf8_capacity);
-      if (!utf8_output) {
-        return JS_EXCEPTION;
-      }
-
-      size_t utf8_len = 0;
-      size_t i = 0;
-
-      while (i + 1 < remaining_len) {
-        uint16_t code_unit = utf16_data[i] | (utf16_data[i + 1] << 8);
-        i += 2;
-
-        if (code_unit < 0x80) {
-          utf8_output[utf8_len++] = (char)code_unit;
-        } else if (code_unit < 0x800) {
-          utf8_output[utf8_len++] = 0xC0 | (code_unit >> 6);
-          utf8_output[utf8_len++] = 0x80 | (code_unit & 0x3F);
-        } else if (code_unit >= 0xD800 && code_unit <= 0xDBFF) {
-          if (i + 1 < remaining_len) {
-            uint16_t low_surrogate = utf16_data[i] | (utf16_data[i + 1] << 8);
-            if (low_surrogate >= 0xDC00 && low_surrogate <= 0xDFFF) {
-              uint32_t code_point = 0x10000 + ((code_unit & 0x3FF) << 10) + (low_surrogate & 0x3FF);
-              i += 2;
-
-              utf8_output[utf8_len++] = 0xF0 | (code_point >> 18);
-              utf8_output[utf8_len++] = 0x80 | ((code_point >> 12) & 0x3F);
-              utf8_output[utf8_len++] = 0x80 | ((code_point >> 6) & 0x3F);
-              utf8_output[utf8_len++] = 0x80 | (code_point & 0x3F);
-            } else {
-              utf8_output[utf8_len++] = 0xEF;
-              utf8_output[utf8_len++] = 0xBF;
-              utf8_output[utf8_len++] = 0xBD;
-            }
-          } else {
-            utf8_output[utf8_len++] = 0xEF;
-            utf8_output[utf8_len++] = 0xBF;
-            utf8_output[utf8_len++] = 0xBD;
-          }
-        } else if (code_unit >= 0xDC00 && code_unit <= 0xDFFF) {
-          utf8_output[utf8_len++] = 0xEF;
-          utf8_output[utf8_len++] = 0xBF;
-          utf8_output[utf8_len++] = 0xBD;
-        } else {
-          utf8_output[utf8_len++] = 0xE0 | (code_unit >> 12);
-          utf8_output[utf8_len++] = 0x80 | ((code_unit >> 6) & 0x3F);
-          utf8_output[utf8_len++] = 0x80 | (code_unit & 0x3F);
-        }
-      }
-
-      utf8_output[utf8_len] = '\0';
-      JSValue result = JS_NewStringLen(ctx, utf8_output, utf8_len);
-      free(utf8_output);
-      return result;
-    } else if (strcmp(decoder->encoding, "utf-16be") == 0 || strcmp(decoder->encoding, "UTF-16BE") == 0) {
-      // UTF-16BE decoding
-      size_t remaining_len = input_len - start_pos;
-      const uint8_t* utf16_data = input_data + start_pos;
-
-      size_t utf8_capacity = remaining_len * 3 + 1;
-      char* utf8_output = malloc(utf8_capacity);
-      if (!utf8_output) {
-        return JS_EXCEPTION;
-      }
-
-      size_t utf8_len = 0;
-      size_t i = 0;
-
-      while (i + 1 < remaining_len) {
-        uint16_t code_unit = (utf16_data[i] << 8) | utf16_data[i + 1];
-        i += 2;
-
-        if (code_unit < 0x80) {
-          utf8_output[utf8_len++] = (char)code_unit;
-        } else if (code_unit < 0x800) {
-          utf8_output[utf8_len++] = 0xC0 | (code_unit >> 6);
-          utf8_output[utf8_len++] = 0x80 | (code_unit & 0x3F);
-        } else if (code_unit >= 0xD800 && code_unit <= 0xDBFF) {
-          if (i + 1 < remaining_len) {
-            uint16_t low_surrogate = (utf16_data[i] << 8) | utf16_data[i + 1];
-            if (low_surrogate >= 0xDC00 && low_surrogate <= 0xDFFF) {
-              uint32_t code_point = 0x10000 + ((code_unit & 0x3FF) << 10) + (low_surrogate & 0x3FF);
-              i += 2;
-
-              utf8_output[utf8_len++] = 0xF0 | (code_point >> 18);
-              utf8_output[utf8_len++] = 0x80 | ((code_point >> 12) & 0x3F);
-              utf8_output[utf8_len++] = 0x80 | ((code_point >> 6) & 0x3F);
-              utf8_output[utf8_len++] = 0x80 | (code_point & 0x3F);
-            } else {
-              utf8_output[utf8_len++] = 0xEF;
-              utf8_output[utf8_len++] = 0xBF;
-              utf8_output[utf8_len++] = 0xBD;
-            }
-          } else {
-            utf8_output[utf8_len++] = 0xEF;
-            utf8_output[utf8_len++] = 0xBF;
-            utf8_output[utf8_len++] = 0xBD;
-          }
-        } else if (code_unit >= 0xDC00 && code_unit <= 0xDFFF) {
-          utf8_output[utf8_len++] = 0xEF;
-          utf8_output[utf8_len++] = 0xBF;
-          utf8_output[utf8_len++] = 0xBD;
-        } else {
-          utf8_output[utf8_len++] = 0xE0 | (code_unit >> 12);
-          utf8_output[utf8_len++] = 0x80 | ((code_unit >> 6) & 0x3F);
-          utf8_output[utf8_len++] = 0x80 | (code_unit & 0x3F);
-        }
-      }
+    JSValue offset_prop = JS_GetPropertyStr(ctx, input, "byteOffset");
+    JSValue length_prop = JS_GetPropertyStr(ctx, input, "byteLength");
+    int ret = JS_ToIndex(ctx, &byte_offset, offset_prop) || JS_ToIndex(ctx, len, length_prop) ? -1 : 0;
+    JS_FreeValue(ctx, offset_prop);
+    JS_FreeValue(ctx, length_prop);
+    if (ret < 0) {
+      return NULL;
+    }
+    array_buffer = JS_GetPropertyStr(ctx, input, "buffer");
+  }
 
-      utf8_output[utf8_len] = '\0';
-      JSValue result = JS_NewStringLen(ctx, utf8_output, utf8_len);
-      free(utf8_output);
-      return result;
-    } else {
-      // UTF-8 and other encodings
-      return JS_NewStringLen(ctx, (const char*)(input_data + start_pos), input_len - start_pos);
+  uint8_t* buffer = JS_GetArrayBuffer(ctx, &buffer_size, array_buffer);
+  JS_FreeValue(ctx, array_buffer);
+  if (!buffer || byte_offset + *len > buffer_size) {
+    if (buffer) {
+      JS_ThrowTypeError(ctx, "Failed to get buffer from typed array");
     }
+    return NULL;
   }
+  return buffer + byte_offset;
+}
 
-  // Try to get as typed array (including DataView)
-  size_t byte_offset, bytes_per_element;
-  JSValue array_buffer = JS_GetTypedArrayBuffer(ctx, argv[0], &byte_offset, &input_len, &bytes_per_element);
-  if (JS_IsException(array_buffer)) {
-    // Clear the exception and try DataView
-    JS_FreeValue(ctx, array_buffer);
+// Length of the byte order mark the decoder's encoding recognises at the start of data
+static size_t get_decoder_bom_length(JSRT_TextDecoderKind kind, const uint8_t* data, size_t len) {
+  switch (kind) {
+    case JSRT_TEXT_DECODER_UTF8:
+      return len >= 3 && data[0] == 0xEF && data[1] == 0xBB && data[2] == 0xBF ? 3 : 0;
+    case JSRT_TEXT_DECODER_UTF16LE:
+      return len >= 2 && data[0] == 0xFF && data[1] == 0xFE ? 2 : 0;
+    case JSRT_TEXT_DECODER_UTF16BE:
+      return len >= 2 && data[0] == 0xFE && data[1] == 0xFF ? 2 : 0;
+    default:
+      return 0;
+  }
+}
 
-    // Check if it's a DataView
-    JSValue global = JS_GetGlobalObject(ctx);
-    JSValue dataview_ctor = JS_GetPropertyStr(ctx, global, "DataView");
+static JSValue decode_utf16(JSContext* ctx, JSRT_TextDecoder* decoder, const uint8_t* data, size_t len) {
+  bool big_endian = decoder->kind == JSRT_TEXT_DECODER_UTF16BE;
 
-    if (!JS_IsException(dataview_ctor) && !JS_IsUndefined(dataview_ctor)) {
-      int is_dataview = JS_IsInstanceOf(ctx, argv[0], dataview_ctor);
-      JS_FreeValue(ctx, dataview_ctor);
-
-      if (is_dataview > 0) {
-        // Handle DataView: get its buffer, byteOffset, and byteLength
-        JSValue buffer_prop = JS_GetPropertyStr(ctx, argv[0], "buffer");
-        JSValue offset_prop = JS_GetPropertyStr(ctx, argv[0], "byteOffset");
-        JSValue length_prop = JS_GetPropertyStr(ctx, argv[0], "byteLength");
-
-        if (!JS_IsException(buffer_prop) && !JS_IsException(offset_prop) && !JS_IsException(length_prop)) {
-          array_buffer = buffer_prop;
-
-          if (JS_ToIndex(ctx, &byte_offset, offset_prop) == 0) {
-            if (JS_ToIndex(ctx, &input_len, length_prop) != 0) {
-              input_len = 0;
-            }
-          }
-
-          JS_FreeValue(ctx, offset_prop);
-          JS_FreeValue(ctx, length_prop);
-        } else {
-          JS_FreeValue(ctx, global);
-          JS_FreeValue(ctx, buffer_prop);
-          JS_FreeValue(ctx, offset_prop);
-          JS_FreeValue(ctx, length_prop);
-          return JS_ThrowTypeError(ctx, "input must be an ArrayBuffer, typed array, or DataView");
-        }
-      } else {
-        JS_FreeValue(ctx, global);
-        return JS_ThrowTypeError(ctx, "input must be an ArrayBuffer, typed array, or DataView");
-      }
-    } else {
-      JS_FreeValue(ctx, global);
-      JS_FreeValue(ctx, dataview_ctor);
-      return JS_ThrowTypeError(ctx, "input must be an ArrayBuffer, typed array, or DataView");
-    }
-    JS_FreeValue(ctx, global);
+  // Validate input if fatal mode is enabled: must have even number of bytes for complete code units
+  if (decoder->fatal && len % 2 != 0) {
+    return JS_ThrowTypeError(ctx, "Incomplete %s code unit", big_endian ? "UTF-16BE" : "UTF-16LE");
   }
 
-  if (input_len == 0) {
-    JS_FreeValue(ctx, array_buffer);
-    return JS_NewString(ctx, "");
+  // Worst case: 3 bytes per code unit, plus U+FFFD for a trailing odd byte
+  char* utf8_output = js_malloc(ctx, len / 2 * 3 + 3);
+  if (!utf8_output) {
+    return JS_EXCEPTION;
   }
 
-  size_t buffer_size;
-  uint8_t* buffer = JS_GetArrayBuffer(ctx, &buffer_size, array_buffer);
-  if (!buffer) {
-    JS_FreeValue(ctx, array_buffer);
-    return JS_ThrowTypeError(ctx, "Failed to get buffer from typed array");
+  size_t utf8_len = JSRT_UTF16ToUTF8(data, len / 2, big_endian, (uint8_t*)utf8_output);
+  if (len % 2 != 0) {
+    utf8_len += JSRT_UTF8Encode((uint8_t*)utf8_output + utf8_len, 0xFFFD);
   }
 
-  input_data = buffer + byte_offset;
+  JSValue result = JS_NewStringLen(ctx, utf8_output, utf8_len);
+  js_free(ctx, utf8_output);
+  return result;
+}
 
-  // Skip BOM if not ignoring it and present
-  size_t start_pos = 0;
-  if (!decoder->ignore_bom && input_len >= 3 && input_data[0] == 0xEF && input_data[1] == 0xBB &&
-      input_data[2] == 0xBF) {
-    start_pos = 3;
+static JSValue decode_windows_1252(JSContext* ctx, const uint8_t* data, size_t len) {
+  size_t ascii = JSRT_ASCIIPrefix(data, len);
+  if (ascii == len) {
+    return JS_NewStringLen(ctx, (const char*)data, len);
   }
 
-  // Validate input if fatal mode is enabled
-  if (decoder->fatal) {
-    if (strcmp(decoder->encoding, "utf-8") == 0) {
-      // Validate UTF-8 sequence
-      const uint8_t* p = input_data + start_pos;
-      const uint8_t* end = input_data + input_len;
-      while (p < end) {
-        const uint8_t* p_next;
-        int c = validate_utf8_sequence(p, end - p, &p_next);
-        if (c < 0) {
-          JS_FreeValue(ctx, array_buffer);
-          return JS_ThrowTypeError(ctx, "Invalid UTF-8 sequence");
-        }
-        p = p_next;
-      }
-    } else if (strcmp(decoder->encoding, "utf-16le") == 0) {
-      // Validate UTF-16LE: must have even number of bytes for complete code units
-      size_t remaining_len = input_len - start_pos;
-      if (remaining_len % 2 != 0) {
-        JS_FreeValue(ctx, array_buffer);
-        return JS_ThrowTypeError(ctx, "Incomplete UTF-16LE code unit");
-      }
-    } else if (strcmp(decoder->encoding, "utf-16be") == 0) {
-      // Validate UTF-16BE: must have even number of bytes for complete code units
-      size_t remaining_len = input_len - start_pos;
-      if (remaining_len % 2 != 0) {
-        JS_FreeValue(ctx, array_buffer);
-        return JS_ThrowTypeError(ctx, "Incomplete UTF-16BE code unit");
-      }
-    }
+  char* utf8_output = js_malloc(ctx, len * 3);
+  if (!utf8_output) {
+    return JS_EXCEPTION;
   }
 
-  // Handle different encodings
-  JSValue result;
-  if (strcmp(decoder->encoding, "utf-16le") == 0 || strcmp(decoder->encoding, "UTF-16LE") == 0) {
-    // UTF-16LE decoding
-    size_t remaining_len = input_len - start_pos;
-    const uint8_t* utf16_data = input_data + start_pos;
-
-    // Calculate maximum UTF-8 output size (worst case: all non-ASCII characters = 3 bytes each)
-    size_t utf8_capacity = remaining_len * 3 + 1;
-    char* utf8_output = malloc(utf8_capacity);
-    if (!utf8_output) {
-      JS_FreeValue(ctx, array_buffer);
-      return JS_EXCEPTION;
+  memcpy(utf8_output, data, ascii);
+  size_t utf8_len = ascii;
+  for (size_t i = ascii; i < len; i++) {
+    uint32_t c = data[i];
+    if (c >= 0x80 && c < 0xA0) {
+      c = windows_1252_high[c - 0x80];
     }
+    utf8_len += JSRT_UTF8Encode((uint8_t*)utf8_output + utf8_len, c);
+  }
 
-    size_t utf8_len = 0;
-    size_t i = 0;
-
-    while (i + 1 < remaining_len) {
-      // Read UTF-16LE code unit (little-endian)
-      uint16_t code_unit = utf16_data[i] | (utf16_data[i + 1] << 8);
-      i += 2;
-
-      if (code_unit < 0x80) {
-        // ASCII
-        utf8_output[utf8_len++] = (char)code_unit;
-      } else if (code_unit < 0x800) {
-        // 2-byte UTF-8
-        utf8_output[utf8_len++] = 0xC0 | (code_unit >> 6);
-        utf8_output[utf8_len++] = 0x80 | (code_unit & 0x3F);
-      } else if (code_unit >= 0xD800 && code_unit <= 0xDBFF) {
-        // High surrogate - check for low surrogate
-        if (i + 1 < remaining_len) {
-          uint16_t low_surrogate = utf16_data[i] | (utf16_data[i + 1] << 8);
-          if (low_surrogate >= 0xDC00 && low_surrogate <= 0xDFFF) {
-            // Valid surrogate pair - decode to code point
-            uint32_t code_point = 0x10000 + ((code_unit & 0x3FF) << 10) + (low_surrogate & 0x3FF);
-            i += 2;
-
-            // Encode as 4-byte UTF-8
-            utf8_output[utf8_len++] = 0xF0 | (code_point >> 18);
-            utf8_output[utf8_len++] = 0x80 | ((code_point >> 12) & 0x3F);
-            utf8_output[utf8_len++] = 0x80 | ((code_point >> 6) & 0x3F);
-            utf8_output[utf8_len++] = 0x80 | (code_point & 0x3F);
-          } else {
-            // Lone high surrogate - replace with U+FFFD
-            utf8_output[utf8_len++] = 0xEF;
-            utf8_output[utf8_len++] = 0xBF;
-            utf8_output[utf8_len++] = 0xBD;
-          }
-        } else {
-          // Lone high surrogate at end - replace with U+FFFD
-          utf8_output[utf8_len++] = 0xEF;
-          utf8_output[utf8_len++] = 0xBF;
-          utf8_output[utf8_len++] = 0xBD;
-        }
-      } else if (code_unit >= 0xDC00 && code_unit <= 0xDFFF) {
-        // Lone low surrogate - replace with U+FFFD
-        utf8_output[utf8_len++] = 0xEF;
-        utf8_output[utf8_len++] = 0xBF;
-        utf8_output[utf8_len++] = 0xBD;
-      } else {
-        // 3-byte UTF-8
-        utf8_output[utf8_len++] = 0xE0 | (code_unit >> 12);
-        utf8_output[utf8_len++] = 0x80 | ((code_unit >> 6) & 0x3F);
-        utf8_output[utf8_len++] = 0x80 | (code_unit & 0x3F);
-      }
-    }
+  JSValue result = JS_NewStringLen(ctx, utf8_output, utf8_len);
+  js_free(ctx, utf8_output);
+  return result;
+}
 
-    utf8_output[utf8_len] = '\0';
-    result = JS_NewStringLen(ctx, utf8_output, utf8_len);
-    free(utf8_output);
-  } else if (strcmp(decoder->encoding, "utf-16be") == 0 || strcmp(decoder->encoding, "UTF-16BE") == 0) {
-    // UTF-16BE decoding
-    size_t remaining_len = input_len - start_pos;
-    const uint8_t* utf16_data = input_data + start_pos;
-
-    size_t utf8_capacity = remaining_len * 3 + 1;
-    char* utf8_output = malloc(utf8_capacity);
-    if (!utf8_output) {
-      JS_FreeValue(ctx, array_buffer);
-      return JS_EXCEPTION;
-    }
+static JSValue JSRT_TextDecoderDecode(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
+  JSRT_TextDecoder* decoder = JS_GetOpaque2(ctx, this_val, JSRT_TextDecoderClassID);
+  if (!decoder) {
+    return JS_EXCEPTION;
+  }
 
-    size_t utf8_len = 0;
-    size_t i = 0;
-
-    while (i + 1 < remaining_len) {
-      // Read UTF-16BE code unit (big-endian)
-      uint16_t code_unit = (utf16_data[i] << 8) | utf16_data[i + 1];
-      i += 2;
-
-      if (code_unit < 0x80) {
-        // ASCII
-        utf8_output[utf8_len++] = (char)code_unit;
-      } else if (code_unit < 0x800) {
-        // 2-byte UTF-8
-        utf8_output[utf8_len++] = 0xC0 | (code_unit >> 6);
-        utf8_output[utf8_len++] = 0x80 | (code_unit & 0x3F);
-      } else if (code_unit >= 0xD800 && code_unit <= 0xDBFF) {
-        // High surrogate - check for low surrogate
-        if (i + 1 < remaining_len) {
-          uint16_t low_surrogate = (utf16_data[i] << 8) | utf16_data[i + 1];
-          if (low_surrogate >= 0xDC00 && low_surrogate <= 0xDFFF) {
-            // Valid surrogate pair - decode to code point
-            uint32_t code_point = 0x10000 + ((code_unit & 0x3FF) << 10) + (low_surrogate & 0x3FF);
-            i += 2;
-
-            // Encode as 4-byte UTF-8
-            utf8_output[utf8_len++] = 0xF0 | (code_point >> 18);
-            utf8_output[utf8_len++] = 0x80 | ((code_point >> 12) & 0x3F);
-            utf8_output[utf8_len++] = 0x80 | ((code_point >> 6) & 0x3F);
-            utf8_output[utf8_len++] = 0x80 | (code_point & 0x3F);
-          } else {
-            // Lone high surrogate - replace with U+FFFD
-            utf8_output[utf8_len++] = 0xEF;
-            utf8_output[utf8_len++] = 0xBF;
-            utf8_output[utf8_len++] = 0xBD;
-          }
-        } else {
-          // Lone high surrogate at end - replace with U+FFFD
-          utf8_output[utf8_len++] = 0xEF;
-          utf8_output[utf8_len++] = 0xBF;
-          utf8_output[utf8_len++] = 0xBD;
-        }
-      } else if (code_unit >= 0xDC00 && code_unit <= 0xDFFF) {
-        // Lone low surrogate - replace with U+FFFD
-        utf8_output[utf8_len++] = 0xEF;
-        utf8_output[utf8_len++] = 0xBF;
-        utf8_output[utf8_len++] = 0xBD;
-      } else {
-        // 3-byte UTF-8
-        utf8_output[utf8_len++] = 0xE0 | (code_unit >> 12);
-        utf8_output[utf8_len++] = 0x80 | ((code_unit >> 6) & 0x3F);
-        utf8_output[utf8_len++] = 0x80 | (code_unit & 0x3F);
-      }
-    }
+  if (argc == 0 || JS_IsUndefined(argv[0])) {
+    return JS_NewString(ctx, "");
+  }
 
-    utf8_output[utf8_len] = '\0';
-    result = JS_NewStringLen(ctx, utf8_output, utf8_len);
-    free(utf8_output);
-  } else {
-    // UTF-8 and other encodings - create string from the buffer
-    result = JS_NewStringLen(ctx, (const char*)(input_data + start_pos), input_len - start_pos);
+  size_t input_len;
+  const uint8_t* input_data = get_decoder_input(ctx, argv[0], &input_len);
+  if (!input_data) {
+    return JS_EXCEPTION;
   }
 
-  JS_FreeValue(ctx, array_buffer);
-  return result;
+  // Skip BOM if not ignoring it and present
+  if (!decoder->ignore_bom) {
+    size_t bom = get_decoder_bom_length(decoder->kind, input_data, input_len);
+    input_data += bom;
+    input_len -= bom;
+  }
+
+  switch (decoder->kind) {
+    case JSRT_TEXT_DECODER_UTF16LE:
+    case JSRT_TEXT_DECODER_UTF16BE:
+      return decode_utf16(ctx, decoder, input_data, input_len);
+    case JSRT_TEXT_DECODER_WINDOWS_1252:
+      return decode_windows_1252(ctx, input_data, input_len);
+    default:
+      // QuickJS replaces malformed UTF-8 with U+FFFD, so only fatal mode needs a separate pass
+      if (decoder->fatal && !JSRT_UTF8Validate(input_data, input_len)) {
+        return JS_ThrowTypeError(ctx, "Invalid UTF-8 sequence");
+      }
+      return JS_NewStringLen(ctx, (const char*)input_data, input_len);
+  }
 }
 
 // Setup functions
@@ -1523,5 +912,5 @@ void JSRT_RuntimeSetupStdEncoding(JSRT_Runtime* rt) {
 
 // Public UTF-8 validation function for use by other modules
 int JSRT_ValidateUTF8Sequence(const uint8_t* data, size_t len, const uint8_t** next) {
-  return validate_utf8_sequence(data, len, next);
+  return JSRT_UTF8DecodeStrict(data, len, next);
 }
\ No newline at end of file
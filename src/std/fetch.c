@@ -11,6 +11,7 @@
 
 #include "../util/debug.h"
 #include "../util/jsutils.h"
+#include "../util/read_slab.h"
 #include "../util/user_agent.h"
 
 // Forward declare class IDs
@@ -1105,8 +1106,7 @@ static void JSRT_FetchOnWrite(uv_write_t* req, int status) {
 }
 
 static void JSRT_FetchAllocBuffer(uv_handle_t* handle, size_t suggested_size, uv_buf_t* buf) {
-  buf->base = malloc(suggested_size);
-  buf->len = suggested_size;
+  JSRT_ReadSlabAlloc(handle, suggested_size, buf);
 }
 
 static void JSRT_FetchOnRead(uv_stream_t* stream, ssize_t nread, const uv_buf_t* buf) {
@@ -1117,8 +1117,7 @@ static void JSRT_FetchOnRead(uv_stream_t* stream, ssize_t nread, const uv_buf_t*
     if (ctx) {
       uv_close((uv_handle_t*)&ctx->tcp_handle, JSRT_FetchOnClose);
     }
-    if (buf->base)
-      free(buf->base);
+    JSRT_ReadSlabRelease((uv_handle_t*)stream, buf, 0);
     return;
   }
 
@@ -1166,8 +1165,7 @@ static void JSRT_FetchOnRead(uv_stream_t* stream, ssize_t nread, const uv_buf_t*
     }
 
     uv_close((uv_handle_t*)&ctx->tcp_handle, JSRT_FetchOnClose);
-    if (buf->base)
-      free(buf->base);
+    JSRT_ReadSlabRelease((uv_handle_t*)stream, buf, 0);
     return;
   }
 
@@ -1182,8 +1180,7 @@ static void JSRT_FetchOnRead(uv_stream_t* stream, ssize_t nread, const uv_buf_t*
         JS_Call(ctx->rt->ctx, ctx->reject_func, JS_UNDEFINED, 1, &error);
         JS_FreeValue(ctx->rt->ctx, error);
         uv_close((uv_handle_t*)&ctx->tcp_handle, JSRT_FetchOnClose);
-        if (buf->base)
-          free(buf->base);
+        JSRT_ReadSlabRelease((uv_handle_t*)stream, buf, 0);
         return;
       }
     }
@@ -1194,8 +1191,7 @@ static void JSRT_FetchOnRead(uv_stream_t* stream, ssize_t nread, const uv_buf_t*
     ctx->response_buffer[ctx->response_size] = '\0';  // Null terminate for string operations
   }
 
-  if (buf->base)
-    free(buf->base);
+  JSRT_ReadSlabRelease((uv_handle_t*)stream, buf, 0);
 }
 
 // Close callback - safely free the context after handle is closed
@@ -25,6 +25,7 @@
 
 #include "../util/debug.h"
 #include "../util/jsutils.h"
+#include "../util/macro.h"
 
 // Cross-platform macros for dynamic loading
 #ifdef _WIN32
@@ -74,9 +75,9 @@ typedef struct {
 } jsrt_ffi_function_t;
 
 // Global storage for FFI function metadata
-static JSValue ffi_functions_map;
-static int next_function_id = 1;
-static bool ffi_initialized = false;
+static JSRT_THREAD_LOCAL JSValue ffi_functions_map;
+static JSRT_THREAD_LOCAL int next_function_id = 1;
+static JSRT_THREAD_LOCAL bool ffi_initialized = false;
 
 // Function wrapper data structure
 typedef struct {
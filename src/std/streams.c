@@ -41,14 +41,18 @@ typedef struct PendingRead {
 // ReadableStreamDefaultController implementation
 typedef struct {
   JSValue stream;
-  char** queue;  // Simple queue of string chunks
+  JSValue* queue;  // Queued chunks, oldest first
   size_t queue_size;
   size_t queue_capacity;
+  size_t high_water_mark;  // Unread chunks queued before desiredSize reaches zero
   bool closed;
   bool errored;                     // Whether the controller is in error state
   JSValue error_value;              // The error value (if errored)
-  PendingRead* pending_reads_head;  // Linked list of pending read promises
-  JSValue current_reader;           // Reference to the current reader (if any)
+  PendingRead* pending_reads_head;  // Pending read promises, oldest first
+  PendingRead* pending_reads_tail;
+  JSValue current_reader;  // Reference to the current reader (if any)
+  const JSRT_ReadableStreamNativeSource* native;  // Source for streams fed from C
+  void* native_opaque;
 } JSRT_ReadableStreamDefaultController;
 
 static void JSRT_ReadableStreamDefaultControllerFinalize(JSRuntime* rt, JSValue val) {
@@ -65,7 +69,7 @@ static void JSRT_ReadableStreamDefaultControllerFinalize(JSRuntime* rt, JSValue
     }
     // Free queue
     for (size_t i = 0; i < controller->queue_size; i++) {
-      free(controller->queue[i]);
+      JS_FreeValueRT(rt, controller->queue[i]);
     }
     free(controller->queue);
 
@@ -92,80 +96,110 @@ static JSClassDef JSRT_ReadableStreamDefaultControllerClass = {
     .finalizer = JSRT_ReadableStreamDefaultControllerFinalize,
 };
 
-static JSValue JSRT_ReadableStreamDefaultControllerEnqueue(JSContext* ctx, JSValueConst this_val, int argc,
-                                                           JSValueConst* argv) {
-  JSRT_ReadableStreamDefaultController* controller =
-      JS_GetOpaque(this_val, JSRT_ReadableStreamDefaultControllerClassID);
-  if (!controller) {
-    return JS_EXCEPTION;
+static JSValue readable_stream_iter_result(JSContext* ctx, JSValue value, bool done) {
+  JSValue result = JS_NewObject(ctx);
+  JS_SetPropertyStr(ctx, result, "value", value);
+  JS_SetPropertyStr(ctx, result, "done", JS_NewBool(ctx, done));
+  return result;
+}
+
+static PendingRead* readable_controller_shift_pending_read(JSRT_ReadableStreamDefaultController* controller) {
+  PendingRead* pending = controller->pending_reads_head;
+  if (pending) {
+    controller->pending_reads_head = pending->next;
+    if (!pending->next) {
+      controller->pending_reads_tail = NULL;
+    }
   }
+  return pending;
+}
 
-  if (controller->closed) {
-    return JS_ThrowTypeError(ctx, "Cannot enqueue a chunk into a readable stream that is closed or errored");
+static int readable_controller_desired_size(JSRT_ReadableStreamDefaultController* controller) {
+  return (int)controller->high_water_mark - (int)controller->queue_size;
+}
+
+// Hand the chunk to the oldest pending read, or queue it; returns -1 when out of memory
+static int readable_controller_enqueue(JSContext* ctx, JSRT_ReadableStreamDefaultController* controller,
+                                       JSValueConst chunk) {
+  PendingRead* pending = readable_controller_shift_pending_read(controller);
+  if (pending) {
+    JSValue result = readable_stream_iter_result(ctx, JS_DupValue(ctx, chunk), false);
+    JS_FreeValue(ctx, JS_Call(ctx, pending->promise_resolve, JS_UNDEFINED, 1, &result));
+    JS_FreeValue(ctx, result);
+    JS_FreeValue(ctx, pending->promise_resolve);
+    JS_FreeValue(ctx, pending->promise_reject);
+    free(pending);
+    return 0;
   }
 
-  if (argc > 0) {
-    // Convert chunk to string for simplicity
-    const char* chunk_str = JS_ToCString(ctx, argv[0]);
-    if (chunk_str) {
-      // Check if there are pending reads to resolve
-      if (controller->pending_reads_head) {
-        // Resolve the first pending read directly with the chunk
-        PendingRead* pending = controller->pending_reads_head;
-        controller->pending_reads_head = pending->next;
-
-        // Create result object
-        JSValue result = JS_NewObject(ctx);
-        JS_SetPropertyStr(ctx, result, "value", JS_NewString(ctx, chunk_str));
-        JS_SetPropertyStr(ctx, result, "done", JS_NewBool(ctx, false));
-
-        // Resolve the promise
-        if (!JS_IsUndefined(pending->promise_resolve)) {
-          JSValue resolve_args[] = {result};
-          JS_Call(ctx, pending->promise_resolve, JS_UNDEFINED, 1, resolve_args);
-          JS_FreeValue(ctx, pending->promise_resolve);
-        }
-        if (!JS_IsUndefined(pending->promise_reject)) {
-          JS_FreeValue(ctx, pending->promise_reject);
-        }
+  if (controller->queue_size >= controller->queue_capacity) {
+    size_t new_capacity = controller->queue_capacity * 2 + 1;
+    JSValue* new_queue = realloc(controller->queue, new_capacity * sizeof(JSValue));
+    if (!new_queue) {
+      return -1;
+    }
+    controller->queue = new_queue;
+    controller->queue_capacity = new_capacity;
+  }
 
-        JS_FreeValue(ctx, result);
-        free(pending);
-      } else {
-        // No pending reads, add chunk to queue
-        // Expand queue if needed
-        if (controller->queue_size >= controller->queue_capacity) {
-          size_t new_capacity = controller->queue_capacity * 2 + 1;
-          char** new_queue = realloc(controller->queue, new_capacity * sizeof(char*));
-          if (new_queue) {
-            controller->queue = new_queue;
-            controller->queue_capacity = new_capacity;
-          }
-        }
+  controller->queue[controller->queue_size++] = JS_DupValue(ctx, chunk);
+  return 0;
+}
 
-        // Add chunk to queue
-        if (controller->queue_size < controller->queue_capacity) {
-          controller->queue[controller->queue_size] = strdup(chunk_str);
-          controller->queue_size++;
-        }
-      }
+static JSValue readable_controller_dequeue(JSRT_ReadableStreamDefaultController* controller) {
+  JSValue chunk = controller->queue[0];
+  controller->queue_size--;
+  memmove(controller->queue, controller->queue + 1, controller->queue_size * sizeof(JSValue));
+  return chunk;
+}
 
-      JS_FreeCString(ctx, chunk_str);
-    }
+static void readable_controller_clear_queue(JSContext* ctx, JSRT_ReadableStreamDefaultController* controller) {
+  for (size_t i = 0; i < controller->queue_size; i++) {
+    JS_FreeValue(ctx, controller->queue[i]);
   }
+  controller->queue_size = 0;
+}
 
-  return JS_UNDEFINED;
+// Ask a native source for more data once a reader drained the queue below the high-water mark
+static void readable_controller_pull(JSContext* ctx, JSRT_ReadableStreamDefaultController* controller) {
+  if (controller->native && !controller->closed && readable_controller_desired_size(controller) > 0) {
+    controller->native->pull(ctx, controller->native_opaque);
+  }
 }
 
-static JSValue JSRT_ReadableStreamDefaultControllerClose(JSContext* ctx, JSValueConst this_val, int argc,
-                                                         JSValueConst* argv) {
+// The consumer gave up on the stream: drop queued chunks and tell a native source to stop
+static void readable_controller_cancel(JSContext* ctx, JSRT_ReadableStreamDefaultController* controller) {
+  const JSRT_ReadableStreamNativeSource* native = controller->native;
+  controller->native = NULL;
+  controller->closed = true;
+  readable_controller_clear_queue(ctx, controller);
+  if (native) {
+    native->cancel(ctx, controller->native_opaque);
+  }
+}
+
+static JSValue JSRT_ReadableStreamDefaultControllerEnqueue(JSContext* ctx, JSValueConst this_val, int argc,
+                                                           JSValueConst* argv) {
   JSRT_ReadableStreamDefaultController* controller =
       JS_GetOpaque(this_val, JSRT_ReadableStreamDefaultControllerClassID);
   if (!controller) {
     return JS_EXCEPTION;
   }
 
+  if (controller->closed) {
+    return JS_ThrowTypeError(ctx, "Cannot enqueue a chunk into a readable stream that is closed or errored");
+  }
+
+  if (readable_controller_enqueue(ctx, controller, argc > 0 ? argv[0] : JS_UNDEFINED) < 0) {
+    return JS_ThrowOutOfMemory(ctx);
+  }
+
+  return JS_UNDEFINED;
+}
+
+static void readable_controller_close(JSContext* ctx, JSRT_ReadableStreamDefaultController* controller) {
   controller->closed = true;
+  controller->native = NULL;
 
   // Resolve any pending reads with {done: true}
   PendingRead* current = controller->pending_reads_head;
@@ -174,9 +208,7 @@ static JSValue JSRT_ReadableStreamDefaultControllerClose(JSContext* ctx, JSValue
 
     if (!JS_IsUndefined(current->promise_resolve)) {
       // Create result object for closed stream
-      JSValue result = JS_NewObject(ctx);
-      JS_SetPropertyStr(ctx, result, "value", JS_UNDEFINED);
-      JS_SetPropertyStr(ctx, result, "done", JS_NewBool(ctx, true));
+      JSValue result = readable_stream_iter_result(ctx, JS_UNDEFINED, true);
 
       // Resolve the promise
       JSValue resolve_args[] = {result};
@@ -194,6 +226,7 @@ static JSValue JSRT_ReadableStreamDefaultControllerClose(JSContext* ctx, JSValue
 
   // Clear the pending reads list
   controller->pending_reads_head = NULL;
+  controller->pending_reads_tail = NULL;
 
   // Resolve any pending closed promise from the current reader
   if (!JS_IsUndefined(controller->current_reader)) {
@@ -213,11 +246,9 @@ static JSValue JSRT_ReadableStreamDefaultControllerClose(JSContext* ctx, JSValue
       reader->closed_promise_pending = false;
     }
   }
-
-  return JS_UNDEFINED;
 }
 
-static JSValue JSRT_ReadableStreamDefaultControllerError(JSContext* ctx, JSValueConst this_val, int argc,
+static JSValue JSRT_ReadableStreamDefaultControllerClose(JSContext* ctx, JSValueConst this_val, int argc,
                                                          JSValueConst* argv) {
   JSRT_ReadableStreamDefaultController* controller =
       JS_GetOpaque(this_val, JSRT_ReadableStreamDefaultControllerClassID);
@@ -225,11 +256,18 @@ static JSValue JSRT_ReadableStreamDefaultControllerError(JSContext* ctx, JSValue
     return JS_EXCEPTION;
   }
 
+  readable_controller_close(ctx, controller);
+  return JS_UNDEFINED;
+}
+
+static void readable_controller_error(JSContext* ctx, JSRT_ReadableStreamDefaultController* controller,
+                                      JSValueConst error_value) {
   controller->closed = true;   // Error also closes the stream
   controller->errored = true;  // Mark as errored
+  controller->native = NULL;
+  readable_controller_clear_queue(ctx, controller);
 
   // Store the error value (undefined if no argument provided)
-  JSValue error_value = (argc > 0) ? argv[0] : JS_UNDEFINED;
   controller->error_value = JS_DupValue(ctx, error_value);
 
   // Reject any pending reads with the error
@@ -253,6 +291,7 @@ static JSValue JSRT_ReadableStreamDefaultControllerError(JSContext* ctx, JSValue
 
   // Clear the pending reads list
   controller->pending_reads_head = NULL;
+  controller->pending_reads_tail = NULL;
 
   // Reject any pending closed promise from the current reader
   if (!JS_IsUndefined(controller->current_reader)) {
@@ -271,7 +310,17 @@ static JSValue JSRT_ReadableStreamDefaultControllerError(JSContext* ctx, JSValue
       reader->closed_promise_pending = false;
     }
   }
+}
 
+static JSValue JSRT_ReadableStreamDefaultControllerError(JSContext* ctx, JSValueConst this_val, int argc,
+                                                         JSValueConst* argv) {
+  JSRT_ReadableStreamDefaultController* controller =
+      JS_GetOpaque(this_val, JSRT_ReadableStreamDefaultControllerClassID);
+  if (!controller) {
+    return JS_EXCEPTION;
+  }
+
+  readable_controller_error(ctx, controller, argc > 0 ? argv[0] : JS_UNDEFINED);
   return JS_UNDEFINED;
 }
 
@@ -320,11 +369,15 @@ static JSValue JSRT_ReadableStreamConstructor(JSContext* ctx, JSValueConst new_t
   controller_data->queue = NULL;
   controller_data->queue_size = 0;
   controller_data->queue_capacity = 0;
+  controller_data->high_water_mark = 1;
   controller_data->closed = false;
   controller_data->errored = false;
   controller_data->error_value = JS_UNDEFINED;
   controller_data->pending_reads_head = NULL;
+  controller_data->pending_reads_tail = NULL;
   controller_data->current_reader = JS_UNDEFINED;
+  controller_data->native = NULL;
+  controller_data->native_opaque = NULL;
 
   JSValue controller = JS_NewObjectClass(ctx, JSRT_ReadableStreamDefaultControllerClassID);
   JS_SetOpaque(controller, controller_data);
@@ -415,7 +468,7 @@ static JSValue JSRT_ReadableStreamCancel(JSContext* ctx, JSValueConst this_val,
     JSRT_ReadableStreamDefaultController* controller =
         JS_GetOpaque(stream->controller, JSRT_ReadableStreamDefaultControllerClassID);
     if (controller) {
-      controller->closed = true;
+      readable_controller_cancel(ctx, controller);
     }
   }
 
@@ -643,17 +696,8 @@ static JSValue JSRT_ReadableStreamDefaultReaderRead(JSContext* ctx, JSValueConst
   // Check if there are chunks in the queue
   if (controller->queue_size > 0) {
     // Return the first chunk from the queue
-    char* chunk = controller->queue[0];
-    JSValue result = JS_NewObject(ctx);
-    JS_SetPropertyStr(ctx, result, "value", JS_NewString(ctx, chunk));
-    JS_SetPropertyStr(ctx, result, "done", JS_NewBool(ctx, false));
-
-    // Remove the chunk from queue
-    free(chunk);
-    for (size_t i = 1; i < controller->queue_size; i++) {
-      controller->queue[i - 1] = controller->queue[i];
-    }
-    controller->queue_size--;
+    JSValue result = readable_stream_iter_result(ctx, readable_controller_dequeue(controller), false);
+    readable_controller_pull(ctx, controller);
 
     // Return a resolved promise with the result
     JSValue promise_ctor = JS_GetPropertyStr(ctx, JS_GetGlobalObject(ctx), "Promise");
@@ -701,10 +745,15 @@ static JSValue JSRT_ReadableStreamDefaultReaderRead(JSContext* ctx, JSValueConst
     pending->promise_resolve = resolving_funcs[0];
     pending->promise_reject = resolving_funcs[1];
 
-    // Add to the linked list of pending reads
-    pending->next = controller->pending_reads_head;
-    controller->pending_reads_head = pending;
+    // Append to the pending reads so chunks are delivered in order
+    if (controller->pending_reads_tail) {
+      controller->pending_reads_tail->next = pending;
+    } else {
+      controller->pending_reads_head = pending;
+    }
+    controller->pending_reads_tail = pending;
 
+    readable_controller_pull(ctx, controller);
     return promise;
   }
 }
@@ -784,7 +833,7 @@ static JSValue JSRT_ReadableStreamDefaultReaderCancel(JSContext* ctx, JSValueCon
     JSRT_ReadableStreamDefaultController* controller =
         JS_GetOpaque(stream->controller, JSRT_ReadableStreamDefaultControllerClassID);
     if (controller) {
-      controller->closed = true;
+      readable_controller_cancel(ctx, controller);
     }
   }
 
@@ -912,6 +961,7 @@ static JSValue JSRT_ReadableStreamDefaultReaderReleaseLock(JSContext* ctx, JSVal
 
       // Clear the pending reads list
       controller->pending_reads_head = NULL;
+      controller->pending_reads_tail = NULL;
 
       // Clear the reader reference from the controller
       if (!JS_IsUndefined(controller->current_reader)) {
@@ -1569,6 +1619,58 @@ static JSValue JSRT_TransformStreamGetWritable(JSContext* ctx, JSValueConst this
   return JS_DupValue(ctx, stream->writable);
 }
 
+static JSRT_ReadableStreamDefaultController* readable_stream_get_controller(JSValueConst stream_val) {
+  JSRT_ReadableStream* stream = JS_GetOpaque(stream_val, JSRT_ReadableStreamClassID);
+  if (!stream) {
+    return NULL;
+  }
+  return JS_GetOpaque(stream->controller, JSRT_ReadableStreamDefaultControllerClassID);
+}
+
+JSValue JSRT_ReadableStreamNewNative(JSContext* ctx, const JSRT_ReadableStreamNativeSource* source, void* opaque,
+                                     size_t high_water_mark) {
+  JSValue stream = JSRT_ReadableStreamConstructor(ctx, JS_UNDEFINED, 0, NULL);
+  if (JS_IsException(stream)) {
+    return stream;
+  }
+
+  JSRT_ReadableStreamDefaultController* controller = readable_stream_get_controller(stream);
+  controller->native = source;
+  controller->native_opaque = opaque;
+  controller->high_water_mark = high_water_mark > 0 ? high_water_mark : 1;
+  return stream;
+}
+
+int JSRT_ReadableStreamEnqueue(JSContext* ctx, JSValueConst stream, JSValueConst chunk) {
+  JSRT_ReadableStreamDefaultController* controller = readable_stream_get_controller(stream);
+  if (!controller || controller->closed) {
+    return 0;
+  }
+
+  if (readable_controller_enqueue(ctx, controller, chunk) < 0) {
+    JS_ThrowOutOfMemory(ctx);
+    JSValue error = JS_GetException(ctx);
+    readable_controller_error(ctx, controller, error);
+    JS_FreeValue(ctx, error);
+    return 0;
+  }
+  return readable_controller_desired_size(controller);
+}
+
+void JSRT_ReadableStreamClose(JSContext* ctx, JSValueConst stream) {
+  JSRT_ReadableStreamDefaultController* controller = readable_stream_get_controller(stream);
+  if (controller && !controller->closed) {
+    readable_controller_close(ctx, controller);
+  }
+}
+
+void JSRT_ReadableStreamError(JSContext* ctx, JSValueConst stream, JSValueConst error) {
+  JSRT_ReadableStreamDefaultController* controller = readable_stream_get_controller(stream);
+  if (controller && !controller->closed) {
+    readable_controller_error(ctx, controller, error);
+  }
+}
+
 void JSRT_RuntimeSetupStdStreams(JSRT_Runtime* rt) {
   JSRT_Debug("JSRT_RuntimeSetupStdStreams: initializing Streams API");
 
@@ -1,8 +1,29 @@
 #ifndef __JSRT_STD_STREAMS_H__
 #define __JSRT_STD_STREAMS_H__
 
+#include <stddef.h>
+
 #include "../runtime.h"
 
 void JSRT_RuntimeSetupStdStreams(JSRT_Runtime* rt);
 
-#endif
\ No newline at end of file
+// Underlying source for a ReadableStream fed from C (e.g. a fetch() response body)
+typedef struct {
+  void (*pull)(JSContext* ctx, void* opaque);    // The queue has room again and a reader wants more
+  void (*cancel)(JSContext* ctx, void* opaque);  // The consumer cancelled; no more chunks are wanted
+} JSRT_ReadableStreamNativeSource;
+
+// Create a ReadableStream whose chunks are pushed with JSRT_ReadableStreamEnqueue.
+// high_water_mark is the number of unread chunks queued before the producer should pause.
+JSValue JSRT_ReadableStreamNewNative(JSContext* ctx, const JSRT_ReadableStreamNativeSource* source, void* opaque,
+                                     size_t high_water_mark);
+
+// Returns the desired size after queueing chunk; the producer should pause once it is <= 0
+// and wait for the source's pull callback
+int JSRT_ReadableStreamEnqueue(JSContext* ctx, JSValueConst stream, JSValueConst chunk);
+
+// Finish the stream; the native source is detached and receives no more callbacks
+void JSRT_ReadableStreamClose(JSContext* ctx, JSValueConst stream);
+void JSRT_ReadableStreamError(JSContext* ctx, JSValueConst stream, JSValueConst error);
+
+#endif
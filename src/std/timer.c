@@ -7,51 +7,338 @@
 #include "../util/jsutils.h"
 #include "../util/macro.h"
 
-typedef struct {
+// Timers are coalesced Node.js-style: all timers with the same duration share one JSRT_TimerList, a FIFO of
+// timers that is also ordered by expiry, driven by a single uv_timer_t armed for its head. Arming, cancelling
+// and refreshing a timer is O(1) and touches no libuv handle unless its list is created or emptied.
+
+typedef struct JSRT_Timer JSRT_Timer;
+typedef struct JSRT_TimerList JSRT_TimerList;
+
+struct JSRT_Timer {
   JSRT_Runtime* rt;
-  uv_timer_t uv_timer;
   uint64_t timeout;
+  uint64_t expiry;  // uv_now() based, while armed
   bool is_interval;
-  uint64_t timer_id;  // Add our own timer ID field
-  JSValue timer_obj;  // Reference to the JS timer object (for clearing opaque)
+  bool has_ref;
+  bool destroyed;        // Cleared: the callback and arguments are gone
+  uint64_t timer_id;     // Add our own timer ID field
+  JSRT_TimerList* list;  // List the timer is armed in, NULL otherwise
+  JSRT_Timer* prev;
+  JSRT_Timer* next;
+  JSValue timer_obj;  // The JS timer object, held while armed so it outlives its callback
   JSValue this_val;
   int argc;
   JSValue* argv;
   JSValue callback;
-} JSRT_Timer;
+};
 
-// Static counter for generating unique timer IDs
-static uint64_t next_timer_id = 1;
+struct JSRT_TimerList {
+  JSRT_TimerLists* lists;
+  uint64_t duration;
+  uv_timer_t uv_timer;
+  JSRT_Timer* head;
+  JSRT_Timer* tail;
+  size_t ref_count;  // Armed timers keeping the loop alive
+  bool running;      // Inside its uv_timer callback; emptied lists are closed afterwards
+  JSRT_TimerList* hash_next;
+};
+
+// Timer lists of a runtime, hashed by duration
+struct JSRT_TimerLists {
+  JSRT_Runtime* rt;
+  JSRT_TimerList** buckets;
+  size_t bucket_count;  // Power of two
+  size_t count;
+};
 
-static void jsrt_timer_free(JSRT_Timer* timer);
-static void jsrt_timer_close_callback(uv_handle_t* handle);
+// Static counter for generating unique timer IDs
+static JSRT_THREAD_LOCAL uint64_t next_timer_id = 1;
 
 static JSValue jsrt_set_timeout(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv);
 static JSValue jsrt_set_interval(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv);
 static JSValue jsrt_start_timer(bool is_interval, JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv);
 static JSValue jsrt_stop_timer(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv);
-static void jsrt_on_timer_callback(uv_timer_t* timer);
+static void jsrt_on_timer_list_callback(uv_timer_t* uv_timer);
 
 static JSClassID timer_class_id;
+
+// Release the callback and arguments of a timer; it can no longer fire or be refreshed
+static void jsrt_timer_destroy(JSRuntime* qjs_rt, JSRT_Timer* timer) {
+  if (timer->destroyed) {
+    return;
+  }
+  timer->destroyed = true;
+  JS_FreeValueRT(qjs_rt, timer->callback);
+  timer->callback = JS_UNDEFINED;
+  JS_FreeValueRT(qjs_rt, timer->this_val);
+  timer->this_val = JS_UNDEFINED;
+  for (int i = 0; i < timer->argc; i++) {
+    JS_FreeValueRT(qjs_rt, timer->argv[i]);
+  }
+  free(timer->argv);
+  timer->argv = NULL;
+  timer->argc = 0;
+}
+
 static void jsrt_timer_finalizer(JSRuntime* rt, JSValue val) {
+  // Armed timers hold their object, so only idle ones get here
   JSRT_Timer* timer = JS_GetOpaque(val, timer_class_id);
   if (timer) {
-    // Prevent double-free: clear opaque pointer immediately
-    JS_SetOpaque(val, NULL);
-
-    // Stop and close the timer handle
-    // The close callback will check if runtime is still valid before freeing JSValues
-    uv_timer_stop(&timer->uv_timer);
-    if (!uv_is_closing((uv_handle_t*)&timer->uv_timer)) {
-      uv_close((uv_handle_t*)&timer->uv_timer, jsrt_timer_close_callback);
-    }
+    jsrt_timer_destroy(rt, timer);
+    free(timer);
   }
 }
 static JSClassDef timer_class = {
     "Timer",
     .finalizer = jsrt_timer_finalizer,
 };
-static const JSCFunctionListEntry timer_proto_funcs[] = {};
+
+// ===== Timer lists =====
+
+static size_t jsrt_timer_list_bucket(JSRT_TimerLists* lists, uint64_t duration) {
+  return (size_t)((duration * 0x9e3779b97f4a7c15ull) >> 32) & (lists->bucket_count - 1);
+}
+
+static void jsrt_timer_list_close_callback(uv_handle_t* handle) {
+  free(handle->data);
+}
+
+// Unhash an empty list and close its handle
+static void jsrt_timer_list_close(JSRT_TimerList* list) {
+  JSRT_TimerLists* lists = list->lists;
+  JSRT_TimerList** link = &lists->buckets[jsrt_timer_list_bucket(lists, list->duration)];
+  while (*link != list) {
+    link = &(*link)->hash_next;
+  }
+  *link = list->hash_next;
+  lists->count--;
+  uv_close((uv_handle_t*)&list->uv_timer, jsrt_timer_list_close_callback);
+}
+
+static JSRT_TimerList* jsrt_timer_list_get(JSRT_TimerLists* lists, uint64_t duration) {
+  size_t bucket = jsrt_timer_list_bucket(lists, duration);
+  for (JSRT_TimerList* list = lists->buckets[bucket]; list; list = list->hash_next) {
+    if (list->duration == duration) {
+      return list;
+    }
+  }
+
+  // Keep chains short as distinct durations accumulate
+  if (lists->count >= lists->bucket_count) {
+    size_t new_count = lists->bucket_count * 2;
+    JSRT_TimerList** new_buckets = calloc(new_count, sizeof(JSRT_TimerList*));
+    if (new_buckets) {
+      JSRT_TimerList** old_buckets = lists->buckets;
+      size_t old_count = lists->bucket_count;
+      lists->buckets = new_buckets;
+      lists->bucket_count = new_count;
+      for (size_t i = 0; i < old_count; i++) {
+        JSRT_TimerList* list = old_buckets[i];
+        while (list) {
+          JSRT_TimerList* next = list->hash_next;
+          size_t index = jsrt_timer_list_bucket(lists, list->duration);
+          list->hash_next = new_buckets[index];
+          new_buckets[index] = list;
+          list = next;
+        }
+      }
+      free(old_buckets);
+      bucket = jsrt_timer_list_bucket(lists, duration);
+    }
+  }
+
+  JSRT_TimerList* list = calloc(1, sizeof(JSRT_TimerList));
+  if (!list) {
+    return NULL;
+  }
+  list->lists = lists;
+  list->duration = duration;
+  uv_timer_init(lists->rt->uv_loop, &list->uv_timer);
+  list->uv_timer.data = list;
+  uv_unref((uv_handle_t*)&list->uv_timer);
+  list->hash_next = lists->buckets[bucket];
+  lists->buckets[bucket] = list;
+  lists->count++;
+  return list;
+}
+
+// Append a timer to the list for its duration, taking a reference to its JS object
+static int jsrt_timer_arm(JSRT_Timer* timer, JSValueConst timer_obj) {
+  JSRT_TimerList* list = jsrt_timer_list_get(timer->rt->timers, timer->timeout);
+  if (!list) {
+    return -1;
+  }
+
+  uint64_t now = uv_now(timer->rt->uv_loop);
+  timer->expiry = now + timer->timeout;
+  timer->list = list;
+  timer->prev = list->tail;
+  timer->next = NULL;
+  if (list->tail) {
+    list->tail->next = timer;
+  } else {
+    list->head = timer;
+    if (!list->running) {
+      uv_timer_start(&list->uv_timer, jsrt_on_timer_list_callback, timer->timeout, 0);
+    }
+  }
+  list->tail = timer;
+  if (timer->has_ref && list->ref_count++ == 0) {
+    uv_ref((uv_handle_t*)&list->uv_timer);
+  }
+  timer->timer_obj = JS_DupValue(timer->rt->ctx, timer_obj);
+  return 0;
+}
+
+// Take a timer off its list; the caller owns the returned reference to its JS object
+static JSValue jsrt_timer_disarm(JSRT_Timer* timer) {
+  JSRT_TimerList* list = timer->list;
+  if (timer->prev) {
+    timer->prev->next = timer->next;
+  } else {
+    list->head = timer->next;
+  }
+  if (timer->next) {
+    timer->next->prev = timer->prev;
+  } else {
+    list->tail = timer->prev;
+  }
+  timer->list = NULL;
+  timer->prev = NULL;
+  timer->next = NULL;
+  if (timer->has_ref && --list->ref_count == 0) {
+    uv_unref((uv_handle_t*)&list->uv_timer);
+  }
+
+  // A list emptied from outside its own callback goes away now; the uv_timer may still be armed for a removed
+  // head, which only means an early wakeup that re-arms for the new one
+  if (!list->head && !list->running) {
+    jsrt_timer_list_close(list);
+  }
+
+  JSValue timer_obj = timer->timer_obj;
+  timer->timer_obj = JS_UNDEFINED;
+  return timer_obj;
+}
+
+static void jsrt_on_timer_list_callback(uv_timer_t* uv_timer) {
+  JSRT_TimerList* list = uv_timer->data;
+  JSRT_Runtime* rt = list->lists->rt;
+  uint64_t now = uv_now(rt->uv_loop);
+
+  list->running = true;
+  JSRT_Timer* timer;
+  while ((timer = list->head) && timer->expiry <= now) {
+    JSValue timer_obj = jsrt_timer_disarm(timer);
+
+    // Intervals go back to the tail before running, so clearInterval() in the callback finds them armed
+    if (timer->is_interval) {
+      jsrt_timer_arm(timer, timer_obj);
+    }
+
+    // The callback may clear its own timer, so it runs on its own references
+    JSValue callback = JS_DupValue(rt->ctx, timer->callback);
+    JSValue this_val = JS_DupValue(rt->ctx, timer->this_val);
+    int argc = 0;
+    JSValue* argv = NULL;
+    if (timer->argc > 0 && (argv = malloc(timer->argc * sizeof(JSValue)))) {
+      argc = timer->argc;
+      for (int i = 0; i < argc; i++) {
+        argv[i] = JS_DupValue(rt->ctx, timer->argv[i]);
+      }
+    }
+
+    JSValue ret = JS_Call(rt->ctx, callback, this_val, argc, argv);
+    if (JS_IsException(ret)) {
+      JSValue e = JS_GetException(rt->ctx);
+      JSRT_RuntimeAddExceptionValue(rt, e);
+    }
+    JSRT_RuntimeFreeValue(rt, ret);
+    JSRT_RuntimeFreeValue(rt, callback);
+    JSRT_RuntimeFreeValue(rt, this_val);
+    for (int i = 0; i < argc; i++) {
+      JSRT_RuntimeFreeValue(rt, argv[i]);
+    }
+    free(argv);
+    JSRT_RuntimeFreeValue(rt, timer_obj);
+
+    // Drain any microtasks scheduled during the timer callback to ensure
+    // Promise reactions and nextTick handlers run before the next timer.
+    JSRT_RuntimeDrainMicrotasks(rt);
+  }
+  list->running = false;
+
+  if (list->head) {
+    uv_timer_start(&list->uv_timer, jsrt_on_timer_list_callback, list->head->expiry - now, 0);
+  } else {
+    jsrt_timer_list_close(list);
+  }
+}
+
+// ===== Timer objects =====
+
+// Timeout.prototype.ref() / unref()
+static JSValue jsrt_timer_set_ref(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv, int magic) {
+  JSRT_Timer* timer = JS_GetOpaque2(ctx, this_val, timer_class_id);
+  if (!timer) {
+    return JS_EXCEPTION;
+  }
+  bool ref = magic != 0;
+  if (timer->has_ref != ref) {
+    timer->has_ref = ref;
+    JSRT_TimerList* list = timer->list;
+    if (list && ref && list->ref_count++ == 0) {
+      uv_ref((uv_handle_t*)&list->uv_timer);
+    } else if (list && !ref && --list->ref_count == 0) {
+      uv_unref((uv_handle_t*)&list->uv_timer);
+    }
+  }
+  return JS_DupValue(ctx, this_val);
+}
+
+// Timeout.prototype.hasRef()
+static JSValue jsrt_timer_has_ref(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
+  JSRT_Timer* timer = JS_GetOpaque2(ctx, this_val, timer_class_id);
+  if (!timer) {
+    return JS_EXCEPTION;
+  }
+  return JS_NewBool(ctx, timer->has_ref);
+}
+
+// Timeout.prototype.refresh(): restart the countdown from now, re-arming a timeout that already fired
+static JSValue jsrt_timer_refresh(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
+  JSRT_Timer* timer = JS_GetOpaque2(ctx, this_val, timer_class_id);
+  if (!timer) {
+    return JS_EXCEPTION;
+  }
+  if (timer->destroyed) {
+    return JS_DupValue(ctx, this_val);
+  }
+  if (timer->list) {
+    JS_FreeValue(ctx, jsrt_timer_disarm(timer));
+  }
+  if (jsrt_timer_arm(timer, this_val) < 0) {
+    return JS_ThrowOutOfMemory(ctx);
+  }
+  return JS_DupValue(ctx, this_val);
+}
+
+static JSValue jsrt_timer_get_id(JSContext* ctx, JSValueConst this_val) {
+  JSRT_Timer* timer = JS_GetOpaque2(ctx, this_val, timer_class_id);
+  if (!timer) {
+    return JS_EXCEPTION;
+  }
+  // Use our own timer_id instead of potentially problematic uv_timer.start_id
+  return JS_NewInt64(ctx, (int64_t)timer->timer_id);
+}
+
+static const JSCFunctionListEntry timer_proto_funcs[] = {
+    JS_CFUNC_MAGIC_DEF("ref", 0, jsrt_timer_set_ref, 1),
+    JS_CFUNC_MAGIC_DEF("unref", 0, jsrt_timer_set_ref, 0),
+    JS_CFUNC_DEF("hasRef", 0, jsrt_timer_has_ref),
+    JS_CFUNC_DEF("refresh", 0, jsrt_timer_refresh),
+    JS_CGETSET_DEF("id", jsrt_timer_get_id, NULL),
+};
 
 void JSRT_RuntimeSetupStdTimer(JSRT_Runtime* rt) {
   JSValue timer_proto;
@@ -61,6 +348,11 @@ void JSRT_RuntimeSetupStdTimer(JSRT_Runtime* rt) {
   JS_SetPropertyFunctionList(rt->ctx, timer_proto, timer_proto_funcs, countof(timer_proto_funcs));
   JS_SetClassProto(rt->ctx, timer_class_id, timer_proto);
 
+  rt->timers = calloc(1, sizeof(JSRT_TimerLists));
+  rt->timers->rt = rt;
+  rt->timers->bucket_count = 16;
+  rt->timers->buckets = calloc(rt->timers->bucket_count, sizeof(JSRT_TimerList*));
+
   JS_SetPropertyStr(rt->ctx, rt->global, "setTimeout", JS_NewCFunction(rt->ctx, jsrt_set_timeout, "setTimeout", 2));
   JS_SetPropertyStr(rt->ctx, rt->global, "setInterval", JS_NewCFunction(rt->ctx, jsrt_set_interval, "setInterval", 2));
   JS_SetPropertyStr(rt->ctx, rt->global, "clearTimeout", JS_NewCFunction(rt->ctx, jsrt_stop_timer, "clearTimeout", 1));
@@ -68,6 +360,29 @@ void JSRT_RuntimeSetupStdTimer(JSRT_Runtime* rt) {
                     JS_NewCFunction(rt->ctx, jsrt_stop_timer, "clearInterval", 1));
 }
 
+void JSRT_RuntimeCleanupStdTimer(JSRT_Runtime* rt) {
+  JSRT_TimerLists* lists = rt->timers;
+  if (!lists) {
+    return;
+  }
+
+  // Drop the references armed timers hold, then close every list
+  for (size_t i = 0; i < lists->bucket_count; i++) {
+    while (lists->buckets[i]) {
+      JSRT_TimerList* list = lists->buckets[i];
+      list->running = true;  // Keeps the list hashed while it empties
+      while (list->head) {
+        JSRT_RuntimeFreeValue(rt, jsrt_timer_disarm(list->head));
+      }
+      jsrt_timer_list_close(list);
+    }
+  }
+
+  free(lists->buckets);
+  free(lists);
+  rt->timers = NULL;
+}
+
 static JSValue jsrt_set_timeout(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
   return jsrt_start_timer(false, ctx, this_val, argc, argv);
 }
@@ -108,146 +423,62 @@ static JSValue jsrt_start_timer(bool is_interval, JSContext* ctx, JSValueConst t
                              JSRT_GetTypeofJSValue(ctx, callback));
   }
 
-  JSRT_Timer* timer = malloc(sizeof(JSRT_Timer));
+  // Like Node.js, delays below 1ms or beyond a signed 32-bit count are 1ms, so that a timer armed from a
+  // callback of its own list cannot become due again within that callback
+  if (timeout < 1 || timeout > INT32_MAX) {
+    timeout = 1;
+  }
+
+  JSValue result = JS_NewObjectClass(rt->ctx, timer_class_id);
+  if (JS_IsException(result)) {
+    return result;
+  }
+
+  JSRT_Timer* timer = calloc(1, sizeof(JSRT_Timer));
+  if (!timer) {
+    JS_FreeValue(ctx, result);
+    return JS_ThrowOutOfMemory(ctx);
+  }
   timer->rt = rt;
-  timer->uv_timer.data = timer;
   timer->timeout = (uint64_t)timeout;
   timer->is_interval = is_interval;
+  timer->has_ref = true;
   timer->timer_id = next_timer_id++;  // Assign our own timer ID
+  timer->timer_obj = JS_UNDEFINED;
   timer->callback = JS_DupValue(rt->ctx, callback);
   timer->this_val = JS_DupValue(rt->ctx, this_val);
-  timer->argc = argc - 2;
-  if (timer->argc > 0) {
-    timer->argv = malloc(timer->argc * sizeof(JSValue));
-    for (int i = 0; i < timer->argc; i++) {
-      timer->argv[i] = JS_DupValue(rt->ctx, argv[i + 2]);
+  if (argc > 2) {
+    timer->argv = malloc((argc - 2) * sizeof(JSValue));
+    if (timer->argv) {
+      timer->argc = argc - 2;
+      for (int i = 0; i < timer->argc; i++) {
+        timer->argv[i] = JS_DupValue(rt->ctx, argv[i + 2]);
+      }
     }
-  } else {
-    timer->argv = NULL;
   }
+  JS_SetOpaque(result, timer);
 
-  uv_timer_init(rt->uv_loop, &timer->uv_timer);
-
-  // For intervals, ensure repeat interval is at least 1ms (0 means no repeat in libuv)
-  uint64_t repeat_interval = is_interval ? (timer->timeout > 0 ? timer->timeout : 1) : 0;
-  int status = uv_timer_start(&timer->uv_timer, jsrt_on_timer_callback, timer->timeout, repeat_interval);
-  if (status != 0) {
-    return JS_ThrowInternalError(rt->ctx, "uv_timer_start error: status=%d", status);
+  if (!timer->argv && argc > 2) {
+    JS_FreeValue(ctx, result);
+    return JS_ThrowOutOfMemory(ctx);
   }
-
-  JSValueConst result = JS_NewObjectClass(rt->ctx, timer_class_id);
-  if (!JS_IsException(result)) {
-    // Store reference to timer object for clearing opaque later
-    timer->timer_obj = JS_DupValue(rt->ctx, result);
-    JS_SetOpaque(result, timer);
-    // Use our own timer_id instead of potentially problematic uv_timer.start_id
-    JS_SetPropertyStr(rt->ctx, result, "id", JS_NewInt64(rt->ctx, (int64_t)timer->timer_id));
+  if (jsrt_timer_arm(timer, result) < 0) {
+    JS_FreeValue(ctx, result);
+    return JS_ThrowOutOfMemory(ctx);
   }
 
   return result;
 }
 
 static JSValue jsrt_stop_timer(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
-  JSRT_Runtime* rt = JS_GetContextOpaque(ctx);
-
   if (argc > 0) {
     JSRT_Timer* timer = JS_GetOpaque(argv[0], timer_class_id);
     if (timer != NULL) {
-      // Clear opaque pointer BEFORE freeing to prevent finalizer from accessing freed memory
-      JS_SetOpaque(argv[0], NULL);
-      jsrt_timer_free(timer);
+      JSValue timer_obj = timer->list ? jsrt_timer_disarm(timer) : JS_UNDEFINED;
+      jsrt_timer_destroy(JS_GetRuntime(ctx), timer);
+      JS_FreeValue(ctx, timer_obj);
     }
   }
 
   return JS_UNDEFINED;
 }
-
-void jsrt_on_timer_callback(uv_timer_t* uv_timer) {
-  JSRT_Timer* timer = uv_timer->data;
-  if (!timer) {
-    JSRT_Debug("Timer callback called with NULL timer data");
-    return;
-  }
-
-  JSValue this_val = timer->this_val;
-  int argc = timer->argc;
-  JSValue* argv = timer->argv;
-  JSValue callback = timer->callback;
-
-  JSValue ret = JS_Call(timer->rt->ctx, callback, this_val, argc, argv);
-  if (JS_IsException(ret)) {
-    JSValue e = JS_GetException(timer->rt->ctx);
-    JSRT_RuntimeAddExceptionValue(timer->rt, e);
-  }
-  JSRT_RuntimeFreeValue(timer->rt, ret);
-
-  // Drain any microtasks scheduled during the timer callback to ensure
-  // Promise reactions and nextTick handlers run before the event loop continues.
-  if (timer->rt) {
-    JSRuntime* qjs_runtime = JS_GetRuntime(timer->rt->ctx);
-    while (JS_IsJobPending(qjs_runtime)) {
-      if (!JSRT_RuntimeRunTicket(timer->rt)) {
-        break;
-      }
-    }
-  }
-
-  if (!timer->is_interval && !uv_is_closing((uv_handle_t*)&timer->uv_timer)) {
-    // Clear opaque pointer BEFORE freeing to prevent finalizer from accessing freed memory
-    JS_SetOpaque(timer->timer_obj, NULL);
-    jsrt_timer_free(timer);
-  }
-}
-
-// Close callback that safely frees the timer after handle is closed
-static void jsrt_timer_close_callback(uv_handle_t* handle) {
-  if (!handle || !handle->data) {
-    JSRT_Debug("Timer close callback called with NULL handle or data");
-    return;
-  }
-
-  JSRT_Timer* timer = (JSRT_Timer*)handle->data;
-  JSRT_Debug("TimerCloseCallback: timer=%p id=%" PRIu64, timer, timer->timer_id);
-
-  // Only free JSValues if runtime and context are still valid
-  // During runtime teardown, these may already be freed
-  if (timer->rt && timer->rt->ctx) {
-    JSRT_RuntimeFreeValue(timer->rt, timer->timer_obj);
-    timer->timer_obj = JS_UNDEFINED;
-    JSRT_RuntimeFreeValue(timer->rt, timer->callback);
-    timer->callback = JS_UNDEFINED;
-    JSRT_RuntimeFreeValue(timer->rt, timer->this_val);
-    timer->this_val = JS_UNDEFINED;
-
-    // Free the copied arguments
-    if (timer->argv) {
-      for (int i = 0; i < timer->argc; i++) {
-        JSRT_RuntimeFreeValue(timer->rt, timer->argv[i]);
-      }
-      free(timer->argv);
-      timer->argv = NULL;
-    }
-  } else {
-    // Runtime is being torn down, just free the argv array
-    if (timer->argv) {
-      free(timer->argv);
-      timer->argv = NULL;
-    }
-  }
-
-  free(timer);
-}
-
-static void jsrt_timer_free(JSRT_Timer* timer) {
-  if (!timer) {
-    JSRT_Debug("Timer free called with NULL timer");
-    return;
-  }
-
-  JSRT_Debug("TimerFree: timer=%p id=%" PRIu64, timer, timer->timer_id);
-  int status = uv_timer_stop(&timer->uv_timer);
-  JSRT_Debug("uv_timer_stop: id=%" PRIu64 " status=%d", timer->timer_id, status);
-
-  // Close the handle with proper callback to ensure safe cleanup
-  uv_close((uv_handle_t*)&timer->uv_timer, jsrt_timer_close_callback);
-}
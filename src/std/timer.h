@@ -4,5 +4,7 @@
 #include "../runtime.h"
 
 void JSRT_RuntimeSetupStdTimer(JSRT_Runtime* rt);
+// Release armed timers and close the timer lists before the runtime goes away
+void JSRT_RuntimeCleanupStdTimer(JSRT_Runtime* rt);
 
 #endif
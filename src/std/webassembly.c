@@ -1,5 +1,6 @@
 #include "webassembly.h"
 #include "../util/debug.h"
+#include "../util/macro.h"
 #include "../wasm/runtime.h"
 
 #include <quickjs.h>
@@ -132,9 +133,9 @@ struct jsrt_wasm_import_resolver {
 };
 
 // WebAssembly Error constructors (stored for creating error instances)
-static JSValue webassembly_compile_error_ctor;
-static JSValue webassembly_link_error_ctor;
-static JSValue webassembly_runtime_error_ctor;
+static JSRT_THREAD_LOCAL JSValue webassembly_compile_error_ctor;
+static JSRT_THREAD_LOCAL JSValue webassembly_link_error_ctor;
+static JSRT_THREAD_LOCAL JSValue webassembly_runtime_error_ctor;
 
 // Forward declarations
 static JSValue js_webassembly_instance_constructor(JSContext* ctx, JSValueConst new_target, int argc,
@@ -219,15 +220,20 @@ static uint8_t* get_arraybuffer_bytes_safe(JSContext* ctx, JSValueConst val, siz
     return bytes;
   }
 
-  // Try to get TypedArray buffer
-  JSValue buffer = JS_GetTypedArrayBuffer(ctx, val, NULL, NULL, NULL);
+  // Try to get TypedArray buffer (views such as pooled Buffers start at byteOffset)
+  size_t byte_offset, byte_length, buffer_size;
+  JSValue buffer = JS_GetTypedArrayBuffer(ctx, val, &byte_offset, &byte_length, NULL);
   if (JS_IsException(buffer)) {
     return NULL;  // Not an ArrayBuffer or TypedArray
   }
 
-  bytes = JS_GetArrayBuffer(ctx, size, buffer);
+  bytes = JS_GetArrayBuffer(ctx, &buffer_size, buffer);
   JS_FreeValue(ctx, buffer);
-  return bytes;
+  if (!bytes) {
+    return NULL;
+  }
+  *size = byte_length;
+  return bytes + byte_offset;
 }
 
 static JSValue jsrt_wasm_create_module_object(JSContext* ctx, wasm_module_t module, const uint8_t* bytes, size_t size) {
@@ -0,0 +1,356 @@
+#include "base64.h"
+
+#include <string.h>
+
+#include "macro.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define JSRT_BASE64_SSSE3
+#elif defined(__aarch64__) && defined(__ARM_NEON) && !defined(__ARM_BIG_ENDIAN)
+#include <arm_neon.h>
+#define JSRT_BASE64_NEON
+#endif
+
+// Decode tables beyond the two alphabets: LOOSE accepts both
+#define BASE64_DECODE_EITHER 2
+
+static const char base64_chars[2][65] = {
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/",
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_",
+};
+
+// 6-bit value of each ASCII character, 255 when it is not in the alphabet
+static const uint8_t base64_values[3][128] = {
+    {
+        255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,  //
+        255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,  //
+        255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 62,  255, 255, 255, 63,   // '+' '/'
+        52,  53,  54,  55,  56,  57,  58,  59,  60,  61,  255, 255, 255, 255, 255, 255,  // '0'-'9'
+        255, 0,   1,   2,   3,   4,   5,   6,   7,   8,   9,   10,  11,  12,  13,  14,   // 'A'-'O'
+        15,  16,  17,  18,  19,  20,  21,  22,  23,  24,  25,  255, 255, 255, 255, 255,  // 'P'-'Z'
+        255, 26,  27,  28,  29,  30,  31,  32,  33,  34,  35,  36,  37,  38,  39,  40,   // 'a'-'o'
+        41,  42,  43,  44,  45,  46,  47,  48,  49,  50,  51,  255, 255, 255, 255, 255,  // 'p'-'z'
+    },
+    {
+        255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,  //
+        255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,  //
+        255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 62,  255, 255,  // '-'
+        52,  53,  54,  55,  56,  57,  58,  59,  60,  61,  255, 255, 255, 255, 255, 255,  // '0'-'9'
+        255, 0,   1,   2,   3,   4,   5,   6,   7,   8,   9,   10,  11,  12,  13,  14,   // 'A'-'O'
+        15,  16,  17,  18,  19,  20,  21,  22,  23,  24,  25,  255, 255, 255, 255, 63,   // 'P'-'Z' '_'
+        255, 26,  27,  28,  29,  30,  31,  32,  33,  34,  35,  36,  37,  38,  39,  40,   // 'a'-'o'
+        41,  42,  43,  44,  45,  46,  47,  48,  49,  50,  51,  255, 255, 255, 255, 255,  // 'p'-'z'
+    },
+    {
+        255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,  //
+        255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,  //
+        255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 62,  255, 62,  255, 63,   // '+' '-' '/'
+        52,  53,  54,  55,  56,  57,  58,  59,  60,  61,  255, 255, 255, 255, 255, 255,  // '0'-'9'
+        255, 0,   1,   2,   3,   4,   5,   6,   7,   8,   9,   10,  11,  12,  13,  14,   // 'A'-'O'
+        15,  16,  17,  18,  19,  20,  21,  22,  23,  24,  25,  255, 255, 255, 255, 63,   // 'P'-'Z' '_'
+        255, 26,  27,  28,  29,  30,  31,  32,  33,  34,  35,  36,  37,  38,  39,  40,   // 'a'-'o'
+        41,  42,  43,  44,  45,  46,  47,  48,  49,  50,  51,  255, 255, 255, 255, 255,  // 'p'-'z'
+    },
+};
+
+// Vector kernels work on whole blocks only and return how much input they consumed:
+// a multiple of 3 bytes when encoding (4 characters out per 3), of 4 characters when decoding.
+// Decoding stops at the first block holding anything but alphabet characters.
+typedef size_t (*JSRT_Base64EncodeBlocksFunc)(const uint8_t* src, size_t len, char* dst, int alphabet);
+typedef size_t (*JSRT_Base64DecodeBlocksFunc)(const uint8_t* src, size_t len, uint8_t* dst, size_t cap,
+                                              int alphabet);
+
+static size_t encode_blocks_scalar(const uint8_t* src, size_t len, char* dst, int alphabet) {
+  return 0;
+}
+
+static size_t decode_blocks_scalar(const uint8_t* src, size_t len, uint8_t* dst, size_t cap, int alphabet) {
+  return 0;
+}
+
+#if defined(JSRT_BASE64_SSSE3)
+// Muła's multiply-shift packing: 12 input bytes become 16 sextets, one per byte
+__attribute__((target("ssse3"))) static size_t encode_blocks_ssse3(const uint8_t* src, size_t len, char* dst,
+                                                                   int alphabet) {
+  const __m128i spread = _mm_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10);
+  // Offset to add to each sextet, picked by which range it falls in
+  const __m128i offsets = _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                        '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                        alphabet == JSRT_BASE64_URL ? '-' - 62 : '+' - 62,
+                                        alphabet == JSRT_BASE64_URL ? '_' - 63 : '/' - 63, 'A', 0, 0);
+  size_t i = 0;
+  // Each load reads 16 bytes to use 12
+  for (; i + 16 <= len; i += 12) {
+    __m128i in = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(src + i)), spread);
+    __m128i hi = _mm_mulhi_epu16(_mm_and_si128(in, _mm_set1_epi32(0x0fc0fc00)), _mm_set1_epi32(0x04000040));
+    __m128i lo = _mm_mullo_epi16(_mm_and_si128(in, _mm_set1_epi32(0x003f03f0)), _mm_set1_epi32(0x01000010));
+    __m128i sextets = _mm_or_si128(hi, lo);
+
+    __m128i range = _mm_subs_epu8(sextets, _mm_set1_epi8(51));
+    __m128i upper = _mm_cmpgt_epi8(_mm_set1_epi8(26), sextets);
+    range = _mm_or_si128(range, _mm_and_si128(upper, _mm_set1_epi8(13)));
+    __m128i out = _mm_add_epi8(sextets, _mm_shuffle_epi8(offsets, range));
+    _mm_storeu_si128((__m128i*)(dst + i / 3 * 4), out);
+  }
+  return i;
+}
+
+// Nibble-table validation and translation (Muła/Lemire) for the standard alphabet; the URL characters are
+// rewritten to '+' and '/' first
+__attribute__((target("ssse3"))) static size_t decode_blocks_ssse3(const uint8_t* src, size_t len, uint8_t* dst,
+                                                                   size_t cap, int alphabet) {
+  const __m128i lut_lo = _mm_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1a, 0x1b,
+                                       0x1b, 0x1b, 0x1a);
+  const __m128i lut_hi = _mm_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10,
+                                       0x10, 0x10, 0x10);
+  const __m128i lut_roll = _mm_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+  const __m128i mask_2f = _mm_set1_epi8(0x2f);
+  const __m128i pack = _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+  size_t i = 0;
+  size_t n = 0;
+  // Each store writes 16 bytes to produce 12
+  for (; i + 16 <= len && n + 16 <= cap; i += 16, n += 12) {
+    __m128i str = _mm_loadu_si128((const __m128i*)(src + i));
+    if (alphabet != JSRT_BASE64_STANDARD) {
+      if (alphabet == JSRT_BASE64_URL &&
+          _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(str, _mm_set1_epi8('+')),
+                                         _mm_cmpeq_epi8(str, _mm_set1_epi8('/'))))) {
+        break;
+      }
+      __m128i dash = _mm_cmpeq_epi8(str, _mm_set1_epi8('-'));
+      __m128i underscore = _mm_cmpeq_epi8(str, _mm_set1_epi8('_'));
+      str = _mm_add_epi8(str, _mm_and_si128(dash, _mm_set1_epi8('+' - '-')));
+      str = _mm_add_epi8(str, _mm_and_si128(underscore, _mm_set1_epi8('/' - '_')));
+    }
+
+    __m128i hi_nibbles = _mm_and_si128(_mm_srli_epi32(str, 4), mask_2f);
+    __m128i lo_nibbles = _mm_and_si128(str, mask_2f);
+    __m128i hi = _mm_shuffle_epi8(lut_hi, hi_nibbles);
+    __m128i lo = _mm_shuffle_epi8(lut_lo, lo_nibbles);
+    if (_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_and_si128(lo, hi), _mm_setzero_si128()))) {
+      break;
+    }
+    __m128i roll = _mm_shuffle_epi8(lut_roll, _mm_add_epi8(_mm_cmpeq_epi8(str, mask_2f), hi_nibbles));
+    __m128i sextets = _mm_add_epi8(str, roll);
+
+    __m128i pairs = _mm_maddubs_epi16(sextets, _mm_set1_epi32(0x01400140));
+    __m128i triples = _mm_madd_epi16(pairs, _mm_set1_epi32(0x00011000));
+    _mm_storeu_si128((__m128i*)(dst + n), _mm_shuffle_epi8(triples, pack));
+  }
+  return i;
+}
+#endif
+
+#if defined(JSRT_BASE64_NEON)
+static size_t encode_blocks_neon(const uint8_t* src, size_t len, char* dst, int alphabet) {
+  const uint8_t* chars = (const uint8_t*)base64_chars[alphabet];
+  uint8x16x4_t table = {{vld1q_u8(chars), vld1q_u8(chars + 16), vld1q_u8(chars + 32), vld1q_u8(chars + 48)}};
+  const uint8x16_t mask = vdupq_n_u8(0x3f);
+  size_t i = 0;
+  for (; i + 48 <= len; i += 48) {
+    uint8x16x3_t in = vld3q_u8(src + i);
+    uint8x16x4_t out;
+    out.val[0] = vqtbl4q_u8(table, vshrq_n_u8(in.val[0], 2));
+    out.val[1] = vqtbl4q_u8(table, vandq_u8(vorrq_u8(vshlq_n_u8(in.val[0], 4), vshrq_n_u8(in.val[1], 4)), mask));
+    out.val[2] = vqtbl4q_u8(table, vandq_u8(vorrq_u8(vshlq_n_u8(in.val[1], 2), vshrq_n_u8(in.val[2], 6)), mask));
+    out.val[3] = vqtbl4q_u8(table, vandq_u8(in.val[2], mask));
+    vst4q_u8((uint8_t*)dst + i / 3 * 4, out);
+  }
+  return i;
+}
+
+// Looks every character up in the 128-entry table; non-ASCII bytes come out as 255
+static inline uint8x16_t base64_values_neon(uint8x16x4_t lo, uint8x16x4_t hi, uint8x16_t c) {
+  uint8x16_t v = vqtbx4q_u8(vqtbl4q_u8(lo, c), hi, vsubq_u8(c, vdupq_n_u8(64)));
+  return vorrq_u8(v, vcgeq_u8(c, vdupq_n_u8(0x80)));
+}
+
+static size_t decode_blocks_neon(const uint8_t* src, size_t len, uint8_t* dst, size_t cap, int alphabet) {
+  const uint8_t* values = base64_values[alphabet];
+  uint8x16x4_t lo = {{vld1q_u8(values), vld1q_u8(values + 16), vld1q_u8(values + 32), vld1q_u8(values + 48)}};
+  uint8x16x4_t hi = {{vld1q_u8(values + 64), vld1q_u8(values + 80), vld1q_u8(values + 96), vld1q_u8(values + 112)}};
+  size_t i = 0;
+  size_t n = 0;
+  for (; i + 64 <= len && n + 48 <= cap; i += 64, n += 48) {
+    uint8x16x4_t in = vld4q_u8(src + i);
+    uint8x16_t a = base64_values_neon(lo, hi, in.val[0]);
+    uint8x16_t b = base64_values_neon(lo, hi, in.val[1]);
+    uint8x16_t c = base64_values_neon(lo, hi, in.val[2]);
+    uint8x16_t d = base64_values_neon(lo, hi, in.val[3]);
+    if (vmaxvq_u8(vorrq_u8(vorrq_u8(a, b), vorrq_u8(c, d))) > 63) {
+      break;
+    }
+    uint8x16x3_t out;
+    out.val[0] = vorrq_u8(vshlq_n_u8(a, 2), vshrq_n_u8(b, 4));
+    out.val[1] = vorrq_u8(vshlq_n_u8(b, 4), vshrq_n_u8(c, 2));
+    out.val[2] = vorrq_u8(vshlq_n_u8(c, 6), d);
+    vst3q_u8(dst + n, out);
+  }
+  return i;
+}
+#endif
+
+static size_t encode_blocks_resolve(const uint8_t* src, size_t len, char* dst, int alphabet);
+static size_t decode_blocks_resolve(const uint8_t* src, size_t len, uint8_t* dst, size_t cap, int alphabet);
+
+// Picked on first use from what the CPU supports
+static JSRT_THREAD_LOCAL JSRT_Base64EncodeBlocksFunc encode_blocks_impl = encode_blocks_resolve;
+static JSRT_THREAD_LOCAL JSRT_Base64DecodeBlocksFunc decode_blocks_impl = decode_blocks_resolve;
+
+static void base64_resolve(void) {
+#if defined(JSRT_BASE64_SSSE3)
+  bool ssse3 = __builtin_cpu_supports("ssse3");
+  encode_blocks_impl = ssse3 ? encode_blocks_ssse3 : encode_blocks_scalar;
+  decode_blocks_impl = ssse3 ? decode_blocks_ssse3 : decode_blocks_scalar;
+#elif defined(JSRT_BASE64_NEON)
+  encode_blocks_impl = encode_blocks_neon;
+  decode_blocks_impl = decode_blocks_neon;
+#else
+  encode_blocks_impl = encode_blocks_scalar;
+  decode_blocks_impl = decode_blocks_scalar;
+#endif
+}
+
+static size_t encode_blocks_resolve(const uint8_t* src, size_t len, char* dst, int alphabet) {
+  base64_resolve();
+  return encode_blocks_impl(src, len, dst, alphabet);
+}
+
+static size_t decode_blocks_resolve(const uint8_t* src, size_t len, uint8_t* dst, size_t cap, int alphabet) {
+  base64_resolve();
+  return decode_blocks_impl(src, len, dst, cap, alphabet);
+}
+
+size_t JSRT_Base64EncodedLength(size_t len, bool pad) {
+  return pad ? (len + 2) / 3 * 4 : len / 3 * 4 + (len % 3 * 4 + 2) / 3;
+}
+
+size_t JSRT_Base64Encode(const uint8_t* src, size_t len, char* dst, JSRT_Base64Alphabet alphabet, bool pad) {
+  const char* chars = base64_chars[alphabet];
+  size_t i = encode_blocks_impl(src, len, dst, alphabet);
+  size_t n = i / 3 * 4;
+  for (; i + 3 <= len; i += 3) {
+    uint32_t triple = ((uint32_t)src[i] << 16) | ((uint32_t)src[i + 1] << 8) | src[i + 2];
+    dst[n++] = chars[triple >> 18];
+    dst[n++] = chars[(triple >> 12) & 63];
+    dst[n++] = chars[(triple >> 6) & 63];
+    dst[n++] = chars[triple & 63];
+  }
+  if (i < len) {
+    uint32_t triple = (uint32_t)src[i] << 16;
+    if (i + 1 < len) {
+      triple |= (uint32_t)src[i + 1] << 8;
+    }
+    dst[n++] = chars[triple >> 18];
+    dst[n++] = chars[(triple >> 12) & 63];
+    if (i + 1 < len) {
+      dst[n++] = chars[(triple >> 6) & 63];
+    } else if (pad) {
+      dst[n++] = '=';
+    }
+    if (pad) {
+      dst[n++] = '=';
+    }
+  }
+  return n;
+}
+
+static inline bool base64_is_whitespace(uint8_t c) {
+  return c == ' ' || c == '\t' || c == '\n' || c == '\f' || c == '\r';
+}
+
+static inline int base64_table(JSRT_Base64Alphabet alphabet, JSRT_Base64Mode mode) {
+  return mode == JSRT_BASE64_LOOSE ? BASE64_DECODE_EITHER : (int)alphabet;
+}
+
+size_t JSRT_Base64DecodedLength(const char* src, size_t len, JSRT_Base64Alphabet alphabet, JSRT_Base64Mode mode) {
+  const uint8_t* values = base64_values[base64_table(alphabet, mode)];
+  size_t count = 0;
+  for (size_t i = 0; i < len; i++) {
+    uint8_t c = (uint8_t)src[i];
+    if (c == '=' && mode == JSRT_BASE64_LOOSE) {
+      break;
+    }
+    count += c < 128 && values[c] < 64;
+  }
+  return count / 4 * 3 + count % 4 * 3 / 4;
+}
+
+bool JSRT_Base64Decode(const char* src, size_t len, uint8_t* dst, size_t* dst_len, JSRT_Base64Alphabet alphabet,
+                       JSRT_Base64Mode mode) {
+  const uint8_t* in = (const uint8_t*)src;
+  int table = base64_table(alphabet, mode);
+  const uint8_t* values = base64_values[table];
+  size_t cap = *dst_len;
+  size_t n = 0;
+  size_t i = 0;
+  size_t count = 0;    // Alphabet characters so far
+  size_t padding = 0;  // '=' characters so far
+  uint32_t acc = 0;
+
+  while (i < len) {
+    if (n >= cap && mode == JSRT_BASE64_LOOSE) {
+      break;
+    }
+    if ((count & 3) == 0 && padding == 0 && n < cap) {
+      // On a quantum boundary: whole blocks go to the vector kernel, then whole quanta through the table
+      size_t used = decode_blocks_impl(in + i, len - i, dst + n, cap - n, table);
+      i += used;
+      n += used / 4 * 3;
+      count += used;
+      for (; i + 4 <= len && n + 3 <= cap; i += 4, count += 4) {
+        uint32_t a = values[in[i] & 0x7f] | (in[i] & 0x80);
+        uint32_t b = values[in[i + 1] & 0x7f] | (in[i + 1] & 0x80);
+        uint32_t c = values[in[i + 2] & 0x7f] | (in[i + 2] & 0x80);
+        uint32_t d = values[in[i + 3] & 0x7f] | (in[i + 3] & 0x80);
+        if ((a | b | c | d) & 0xc0) {
+          break;
+        }
+        uint32_t triple = (a << 18) | (b << 12) | (c << 6) | d;
+        dst[n++] = (uint8_t)(triple >> 16);
+        dst[n++] = (uint8_t)(triple >> 8);
+        dst[n++] = (uint8_t)triple;
+      }
+      if (i >= len) {
+        break;
+      }
+    }
+
+    uint8_t c = in[i++];
+    uint8_t v = c < 128 ? values[c] : 255;
+    if (v < 64) {
+      if (padding > 0) {
+        return false;
+      }
+      acc = ((acc << 6) | v) & 0xffffff;
+      // The second, third and fourth character of a quantum each complete a byte
+      int shift = (int)(6 - 2 * (count++ & 3)) & 7;
+      if ((count & 3) != 1 && n < cap) {
+        dst[n++] = (uint8_t)(acc >> shift);
+      }
+    } else if (c == '=') {
+      if (mode == JSRT_BASE64_LOOSE) {
+        break;
+      }
+      padding++;
+    } else if (mode != JSRT_BASE64_LOOSE && !(mode == JSRT_BASE64_FORGIVING && base64_is_whitespace(c))) {
+      return false;
+    }
+  }
+
+  *dst_len = n;
+  if (mode == JSRT_BASE64_LOOSE) {
+    return true;
+  }
+  // A lone character carries less than a byte; padding must complete the last quantum
+  if ((count & 3) == 1) {
+    return false;
+  }
+  return padding == 0 || (padding <= 2 && (count + padding) % 4 == 0);
+}
+
+int JSRT_Base64Value(uint8_t c, JSRT_Base64Alphabet alphabet) {
+  uint8_t v = c < 128 ? base64_values[alphabet][c] : 255;
+  return v < 64 ? v : -1;
+}
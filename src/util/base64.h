@@ -0,0 +1,43 @@
+#ifndef __JSRT_UTIL_BASE64_H__
+#define __JSRT_UTIL_BASE64_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Base64 codec shared by atob/btoa, Buffer, WebCrypto JWK and source maps.
+//
+// Whole blocks go through SSSE3 (when the CPU supports it) or NEON on
+// AArch64: 12 bytes to 16 characters and back, or 48 to 64 with NEON.
+// The tail, padding and anything that needs skipping use the scalar code.
+
+typedef enum {
+  JSRT_BASE64_STANDARD,  // A-Z a-z 0-9 + / (RFC 4648 section 4)
+  JSRT_BASE64_URL,       // A-Z a-z 0-9 - _ (RFC 4648 section 5)
+} JSRT_Base64Alphabet;
+
+typedef enum {
+  JSRT_BASE64_STRICT,     // Alphabet characters and optional final padding, nothing else
+  JSRT_BASE64_FORGIVING,  // WHATWG forgiving-base64: as strict, but ASCII whitespace is ignored
+  JSRT_BASE64_LOOSE,      // Node.js Buffer: both alphabets, other characters skipped, stops at the first '='
+} JSRT_Base64Mode;
+
+// Number of characters JSRT_Base64Encode writes for len bytes
+size_t JSRT_Base64EncodedLength(size_t len, bool pad);
+
+// Encodes len bytes of src at dst; returns the number of characters written (no terminator)
+size_t JSRT_Base64Encode(const uint8_t* src, size_t len, char* dst, JSRT_Base64Alphabet alphabet, bool pad);
+
+// Number of bytes JSRT_Base64Decode produces from src when it is valid
+size_t JSRT_Base64DecodedLength(const char* src, size_t len, JSRT_Base64Alphabet alphabet, JSRT_Base64Mode mode);
+
+// Decodes len characters of src into dst, which has room for *dst_len bytes. Bytes past that are dropped
+// (LOOSE stops there). Returns false if src is not valid in `mode`; otherwise sets *dst_len to the
+// number of bytes written.
+bool JSRT_Base64Decode(const char* src, size_t len, uint8_t* dst, size_t* dst_len, JSRT_Base64Alphabet alphabet,
+                       JSRT_Base64Mode mode);
+
+// 6-bit value of character c, or -1 if it is not in the alphabet
+int JSRT_Base64Value(uint8_t c, JSRT_Base64Alphabet alphabet);
+
+#endif
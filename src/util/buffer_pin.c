@@ -0,0 +1,184 @@
+#include "buffer_pin.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "debug.h"
+#include "macro.h"
+
+#define JSRT_BUFFER_PIN_MIN_CAPACITY 64
+
+typedef struct {
+  const void* store;  // NULL marks a free slot
+  size_t count;
+} JSRT_BufferPinEntry;
+
+// Open addressing with linear probing; capacity is a power of two and at most half full
+typedef struct {
+  JSRT_BufferPinEntry* entries;
+  size_t capacity;
+  size_t count;
+} JSRT_BufferPinTable;
+
+static JSRT_THREAD_LOCAL JSRT_BufferPinTable pins;
+
+static inline size_t buffer_pin_hash(const void* store, size_t capacity) {
+  uint64_t h = (uint64_t)(uintptr_t)store * 0x9E3779B97F4A7C15ULL;
+  return (size_t)(h >> 32) & (capacity - 1);
+}
+
+static JSRT_BufferPinEntry* buffer_pin_find(const void* store) {
+  if (!pins.entries) {
+    return NULL;
+  }
+  for (size_t i = buffer_pin_hash(store, pins.capacity);; i = (i + 1) & (pins.capacity - 1)) {
+    JSRT_BufferPinEntry* entry = &pins.entries[i];
+    if (entry->store == store) {
+      return entry;
+    }
+    if (!entry->store) {
+      return NULL;
+    }
+  }
+}
+
+static bool buffer_pin_grow(void) {
+  size_t capacity = pins.capacity ? pins.capacity * 2 : JSRT_BUFFER_PIN_MIN_CAPACITY;
+  JSRT_BufferPinEntry* entries = calloc(capacity, sizeof(JSRT_BufferPinEntry));
+  if (!entries) {
+    return false;
+  }
+
+  for (size_t i = 0; i < pins.capacity; i++) {
+    const JSRT_BufferPinEntry* old = &pins.entries[i];
+    if (old->store) {
+      size_t j = buffer_pin_hash(old->store, capacity);
+      while (entries[j].store) {
+        j = (j + 1) & (capacity - 1);
+      }
+      entries[j] = *old;
+    }
+  }
+
+  free(pins.entries);
+  pins.entries = entries;
+  pins.capacity = capacity;
+  return true;
+}
+
+void JSRT_BufferPin(const void* store) {
+  if (!store) {
+    return;
+  }
+
+  JSRT_BufferPinEntry* entry = buffer_pin_find(store);
+  if (entry) {
+    entry->count++;
+    return;
+  }
+
+  if ((pins.count + 1) * 2 > pins.capacity && !buffer_pin_grow()) {
+    // Out of memory: the store stays transferable, as it was before pinning existed
+    JSRT_Debug("buffer pin: failed to grow the pin table");
+    return;
+  }
+
+  size_t i = buffer_pin_hash(store, pins.capacity);
+  while (pins.entries[i].store) {
+    i = (i + 1) & (pins.capacity - 1);
+  }
+  pins.entries[i].store = store;
+  pins.entries[i].count = 1;
+  pins.count++;
+}
+
+void JSRT_BufferUnpin(const void* store) {
+  JSRT_BufferPinEntry* entry = store ? buffer_pin_find(store) : NULL;
+  if (!entry || --entry->count > 0) {
+    return;
+  }
+
+  // Backward-shift deletion keeps every probe sequence free of holes
+  size_t mask = pins.capacity - 1;
+  size_t hole = (size_t)(entry - pins.entries);
+  for (size_t i = (hole + 1) & mask; pins.entries[i].store; i = (i + 1) & mask) {
+    size_t home = buffer_pin_hash(pins.entries[i].store, pins.capacity);
+    if (((i - home) & mask) >= ((i - hole) & mask)) {
+      pins.entries[hole] = pins.entries[i];
+      hole = i;
+    }
+  }
+  pins.entries[hole].store = NULL;
+  pins.entries[hole].count = 0;
+
+  if (--pins.count == 0) {
+    free(pins.entries);
+    pins.entries = NULL;
+    pins.capacity = 0;
+  }
+}
+
+bool JSRT_BufferIsPinned(const void* store) {
+  return store && buffer_pin_find(store) != NULL;
+}
+
+const void* JSRT_BufferPinValue(JSContext* ctx, JSValueConst val) {
+  if (!JS_IsObject(val)) {
+    return NULL;
+  }
+
+  size_t size = 0;
+  uint8_t* store = JS_GetArrayBuffer(ctx, &size, val);
+  if (!store) {
+    JS_FreeValue(ctx, JS_GetException(ctx));
+    JSValue array_buffer = JS_GetTypedArrayBuffer(ctx, val, NULL, NULL, NULL);
+    if (JS_IsException(array_buffer)) {
+      JS_FreeValue(ctx, JS_GetException(ctx));
+      return NULL;
+    }
+    store = JS_GetArrayBuffer(ctx, &size, array_buffer);
+    JS_FreeValue(ctx, array_buffer);
+    if (!store) {
+      JS_FreeValue(ctx, JS_GetException(ctx));
+      return NULL;
+    }
+  }
+
+  JSRT_BufferPin(store);
+  return store;
+}
+
+// ArrayBuffer.prototype.transfer() and transferToFixedLength(), refusing pinned buffers
+static JSValue buffer_pin_transfer(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv, int magic,
+                                   JSValue* func_data) {
+  size_t size = 0;
+  uint8_t* store = JS_GetArrayBuffer(ctx, &size, this_val);
+  if (!store) {
+    // Not an ArrayBuffer, or detached: the original reports it
+    JS_FreeValue(ctx, JS_GetException(ctx));
+  } else if (JSRT_BufferIsPinned(store)) {
+    return JS_ThrowTypeError(ctx, "Cannot transfer an ArrayBuffer that is in use");
+  }
+  return JS_Call(ctx, func_data[0], this_val, argc, argv);
+}
+
+void JSRT_BufferPinSetup(JSContext* ctx) {
+  static const char* const methods[] = {"transfer", "transferToFixedLength"};
+
+  JSValue global = JS_GetGlobalObject(ctx);
+  JSValue ctor = JS_GetPropertyStr(ctx, global, "ArrayBuffer");
+  JSValue proto = JS_GetPropertyStr(ctx, ctor, "prototype");
+
+  for (size_t i = 0; i < countof(methods); i++) {
+    JSValue original = JS_GetPropertyStr(ctx, proto, methods[i]);
+    if (JS_IsFunction(ctx, original)) {
+      JSValue guard = JS_NewCFunctionData(ctx, buffer_pin_transfer, 0, 0, 1, &original);
+      JS_DefinePropertyValueStr(ctx, proto, methods[i], guard, JS_PROP_WRITABLE | JS_PROP_CONFIGURABLE);
+    }
+    JS_FreeValue(ctx, original);
+  }
+
+  JS_FreeValue(ctx, proto);
+  JS_FreeValue(ctx, ctor);
+  JS_FreeValue(ctx, global);
+}
@@ -0,0 +1,28 @@
+#ifndef __JSRT_UTIL_BUFFER_PIN_H__
+#define __JSRT_UTIL_BUFFER_PIN_H__
+
+#include <quickjs.h>
+#include <stdbool.h>
+
+// ArrayBuffer backing stores that native code still uses after the call that
+// handed them over has returned, such as the payload of a uv_write in flight,
+// or that many Buffers share, such as the allocUnsafe() slab.
+//
+// Detaching an ArrayBuffer frees its store, so every path that lets JS detach
+// one (ArrayBuffer.prototype.transfer(), structuredClone() and postMessage()
+// transfer lists) refuses to while the store is pinned. Pins are counted and
+// keyed by the store's address. Every JSRT runtime is driven by one thread and
+// its ArrayBuffers never leave it, so the table is thread-local.
+
+void JSRT_BufferPin(const void* store);
+void JSRT_BufferUnpin(const void* store);
+bool JSRT_BufferIsPinned(const void* store);
+
+// Pin the store behind val (an ArrayBuffer or a view of one) and return it for JSRT_BufferUnpin.
+// Returns NULL, without an exception, when val has no store.
+const void* JSRT_BufferPinValue(JSContext* ctx, JSValueConst val);
+
+// Make ArrayBuffer.prototype.transfer() and transferToFixedLength() throw on pinned buffers
+void JSRT_BufferPinSetup(JSContext* ctx);
+
+#endif
@@ -0,0 +1,403 @@
+#include "conn_pool.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "debug.h"
+
+typedef struct JSRT_ConnPoolIdle {
+  void* conn;
+  uint64_t since;  // uv_now() when the connection went idle
+  struct JSRT_ConnPoolIdle* next;
+} JSRT_ConnPoolIdle;
+
+typedef struct JSRT_ConnPoolWaiter {
+  JSRT_ConnPoolReadyFn ready_fn;
+  void* waiter;
+  struct JSRT_ConnPoolWaiter* next;
+} JSRT_ConnPoolWaiter;
+
+typedef struct JSRT_ConnPoolOrigin {
+  char* key;
+  int active;
+  int idle_count;
+  JSRT_ConnPoolIdle* idle;  // Most recently used first
+  JSRT_ConnPoolWaiter* waiters_head;
+  JSRT_ConnPoolWaiter* waiters_tail;
+  struct JSRT_ConnPoolOrigin* next;
+} JSRT_ConnPoolOrigin;
+
+struct JSRT_ConnPool {
+  uv_loop_t* loop;
+  JSRT_ConnPoolOptions options;
+  JSRT_ConnPoolCloseFn close_fn;
+  void* opaque;
+  JSRT_ConnPoolOrigin* origins;
+  uv_timer_t* idle_timer;
+  bool idle_timer_running;
+  JSRT_ConnPoolStats stats;  // Only the cumulative counters are kept here
+};
+
+static JSRT_ConnPoolOrigin* conn_pool_find(JSRT_ConnPool* pool, const char* key) {
+  for (JSRT_ConnPoolOrigin* origin = pool->origins; origin; origin = origin->next) {
+    if (strcmp(origin->key, key) == 0) {
+      return origin;
+    }
+  }
+  return NULL;
+}
+
+static JSRT_ConnPoolOrigin* conn_pool_find_or_create(JSRT_ConnPool* pool, const char* key) {
+  JSRT_ConnPoolOrigin* origin = conn_pool_find(pool, key);
+  if (origin) {
+    return origin;
+  }
+
+  origin = calloc(1, sizeof(JSRT_ConnPoolOrigin));
+  if (!origin) {
+    return NULL;
+  }
+  origin->key = strdup(key);
+  if (!origin->key) {
+    free(origin);
+    return NULL;
+  }
+
+  origin->next = pool->origins;
+  pool->origins = origin;
+  return origin;
+}
+
+// Drop the origin once nothing refers to it any more
+static void conn_pool_maybe_remove_origin(JSRT_ConnPool* pool, JSRT_ConnPoolOrigin* origin) {
+  if (origin->active > 0 || origin->idle || origin->waiters_head) {
+    return;
+  }
+
+  for (JSRT_ConnPoolOrigin** link = &pool->origins; *link; link = &(*link)->next) {
+    if (*link == origin) {
+      *link = origin->next;
+      break;
+    }
+  }
+  free(origin->key);
+  free(origin);
+}
+
+static bool conn_pool_has_idle(JSRT_ConnPool* pool) {
+  for (JSRT_ConnPoolOrigin* origin = pool->origins; origin; origin = origin->next) {
+    if (origin->idle) {
+      return true;
+    }
+  }
+  return false;
+}
+
+static void conn_pool_stop_idle_timer(JSRT_ConnPool* pool) {
+  if (pool->idle_timer_running) {
+    uv_timer_stop(pool->idle_timer);
+    pool->idle_timer_running = false;
+  }
+}
+
+static void conn_pool_on_idle_timer(uv_timer_t* timer) {
+  JSRT_ConnPool* pool = timer->data;
+  uint64_t now = uv_now(pool->loop);
+
+  // Unlink every expired connection first; close_fn runs once the lists are consistent again
+  JSRT_ConnPoolIdle* expired = NULL;
+  JSRT_ConnPoolOrigin* origin = pool->origins;
+  while (origin) {
+    JSRT_ConnPoolOrigin* next_origin = origin->next;
+    JSRT_ConnPoolIdle** link = &origin->idle;
+    while (*link) {
+      JSRT_ConnPoolIdle* entry = *link;
+      if (now - entry->since >= pool->options.idle_timeout_ms) {
+        *link = entry->next;
+        origin->idle_count--;
+        entry->next = expired;
+        expired = entry;
+      } else {
+        link = &entry->next;
+      }
+    }
+    conn_pool_maybe_remove_origin(pool, origin);
+    origin = next_origin;
+  }
+
+  if (!conn_pool_has_idle(pool)) {
+    conn_pool_stop_idle_timer(pool);
+  }
+
+  while (expired) {
+    JSRT_ConnPoolIdle* next = expired->next;
+    JSRT_Debug("conn pool: closing idle connection %p after %llu ms", expired->conn,
+               (unsigned long long)(now - expired->since));
+    pool->stats.timed_out++;
+    pool->close_fn(expired->conn, pool->opaque);
+    free(expired);
+    expired = next;
+  }
+}
+
+static void conn_pool_on_timer_close(uv_handle_t* handle) {
+  free(handle);
+}
+
+JSRT_ConnPool* JSRT_ConnPoolNew(uv_loop_t* loop, const JSRT_ConnPoolOptions* options, JSRT_ConnPoolCloseFn close_fn,
+                                void* opaque) {
+  JSRT_ConnPool* pool = calloc(1, sizeof(JSRT_ConnPool));
+  if (!pool) {
+    return NULL;
+  }
+
+  pool->loop = loop;
+  pool->options = *options;
+  pool->close_fn = close_fn;
+  pool->opaque = opaque;
+
+  if (options->idle_timeout_ms > 0) {
+    pool->idle_timer = malloc(sizeof(uv_timer_t));
+    if (!pool->idle_timer) {
+      free(pool);
+      return NULL;
+    }
+    uv_timer_init(loop, pool->idle_timer);
+    pool->idle_timer->data = pool;
+    // Idle connections must never keep the process alive
+    uv_unref((uv_handle_t*)pool->idle_timer);
+  }
+
+  return pool;
+}
+
+void JSRT_ConnPoolFree(JSRT_ConnPool* pool) {
+  if (!pool) {
+    return;
+  }
+
+  if (pool->idle_timer) {
+    conn_pool_stop_idle_timer(pool);
+    uv_close((uv_handle_t*)pool->idle_timer, conn_pool_on_timer_close);
+  }
+
+  JSRT_ConnPoolOrigin* origin = pool->origins;
+  while (origin) {
+    JSRT_ConnPoolOrigin* next_origin = origin->next;
+
+    JSRT_ConnPoolIdle* entry = origin->idle;
+    while (entry) {
+      JSRT_ConnPoolIdle* next = entry->next;
+      pool->close_fn(entry->conn, pool->opaque);
+      free(entry);
+      entry = next;
+    }
+
+    JSRT_ConnPoolWaiter* waiter = origin->waiters_head;
+    while (waiter) {
+      JSRT_ConnPoolWaiter* next = waiter->next;
+      free(waiter);
+      waiter = next;
+    }
+
+    free(origin->key);
+    free(origin);
+    origin = next_origin;
+  }
+
+  free(pool);
+}
+
+int JSRT_ConnPoolAcquire(JSRT_ConnPool* pool, const char* key, void** conn, JSRT_ConnPoolReadyFn ready_fn,
+                         void* waiter) {
+  *conn = NULL;
+
+  JSRT_ConnPoolOrigin* origin = conn_pool_find_or_create(pool, key);
+  if (!origin) {
+    return -1;
+  }
+
+  if (origin->idle) {
+    JSRT_ConnPoolIdle* entry = origin->idle;
+    origin->idle = entry->next;
+    origin->idle_count--;
+    origin->active++;
+    pool->stats.reused++;
+    *conn = entry->conn;
+    free(entry);
+    if (!conn_pool_has_idle(pool)) {
+      conn_pool_stop_idle_timer(pool);
+    }
+    return 1;
+  }
+
+  if (pool->options.max_sockets <= 0 || origin->active < pool->options.max_sockets) {
+    origin->active++;
+    pool->stats.created++;
+    return 1;
+  }
+
+  JSRT_ConnPoolWaiter* entry = malloc(sizeof(JSRT_ConnPoolWaiter));
+  if (!entry) {
+    return -1;
+  }
+  entry->ready_fn = ready_fn;
+  entry->waiter = waiter;
+  entry->next = NULL;
+  if (origin->waiters_tail) {
+    origin->waiters_tail->next = entry;
+  } else {
+    origin->waiters_head = entry;
+  }
+  origin->waiters_tail = entry;
+  return 0;
+}
+
+bool JSRT_ConnPoolCancel(JSRT_ConnPool* pool, const char* key, void* waiter) {
+  JSRT_ConnPoolOrigin* origin = conn_pool_find(pool, key);
+  if (!origin) {
+    return false;
+  }
+
+  JSRT_ConnPoolWaiter* prev = NULL;
+  for (JSRT_ConnPoolWaiter* entry = origin->waiters_head; entry; prev = entry, entry = entry->next) {
+    if (entry->waiter != waiter) {
+      continue;
+    }
+    if (prev) {
+      prev->next = entry->next;
+    } else {
+      origin->waiters_head = entry->next;
+    }
+    if (origin->waiters_tail == entry) {
+      origin->waiters_tail = prev;
+    }
+    free(entry);
+    conn_pool_maybe_remove_origin(pool, origin);
+    return true;
+  }
+  return false;
+}
+
+void JSRT_ConnPoolRelease(JSRT_ConnPool* pool, const char* key, void* conn, bool reusable) {
+  JSRT_ConnPoolOrigin* origin = conn_pool_find(pool, key);
+  if (!origin) {
+    return;
+  }
+
+  // Hand the connection (or just its slot) straight to the oldest queued request
+  JSRT_ConnPoolWaiter* waiter = origin->waiters_head;
+  if (waiter) {
+    origin->waiters_head = waiter->next;
+    if (!origin->waiters_head) {
+      origin->waiters_tail = NULL;
+    }
+
+    void* handoff = reusable ? conn : NULL;
+    if (handoff) {
+      pool->stats.reused++;
+    } else {
+      pool->stats.created++;
+    }
+    JSRT_ConnPoolReadyFn ready_fn = waiter->ready_fn;
+    void* data = waiter->waiter;
+    free(waiter);
+    ready_fn(handoff, data);
+    return;
+  }
+
+  origin->active--;
+  if (!reusable || !conn) {
+    conn_pool_maybe_remove_origin(pool, origin);
+    return;
+  }
+
+  if (origin->idle_count >= pool->options.max_free_sockets) {
+    pool->stats.evicted++;
+    conn_pool_maybe_remove_origin(pool, origin);
+    pool->close_fn(conn, pool->opaque);
+    return;
+  }
+
+  JSRT_ConnPoolIdle* entry = malloc(sizeof(JSRT_ConnPoolIdle));
+  if (!entry) {
+    conn_pool_maybe_remove_origin(pool, origin);
+    pool->close_fn(conn, pool->opaque);
+    return;
+  }
+  entry->conn = conn;
+  entry->since = uv_now(pool->loop);
+  entry->next = origin->idle;
+  origin->idle = entry;
+  origin->idle_count++;
+
+  if (pool->idle_timer && !pool->idle_timer_running) {
+    uv_timer_start(pool->idle_timer, conn_pool_on_idle_timer, pool->options.idle_timeout_ms,
+                   pool->options.idle_timeout_ms);
+    pool->idle_timer_running = true;
+  }
+}
+
+bool JSRT_ConnPoolRemoveIdle(JSRT_ConnPool* pool, const char* key, void* conn) {
+  JSRT_ConnPoolOrigin* origin = conn_pool_find(pool, key);
+  if (!origin) {
+    return false;
+  }
+
+  for (JSRT_ConnPoolIdle** link = &origin->idle; *link; link = &(*link)->next) {
+    JSRT_ConnPoolIdle* entry = *link;
+    if (entry->conn != conn) {
+      continue;
+    }
+    *link = entry->next;
+    origin->idle_count--;
+    free(entry);
+    conn_pool_maybe_remove_origin(pool, origin);
+    if (!conn_pool_has_idle(pool)) {
+      conn_pool_stop_idle_timer(pool);
+    }
+    return true;
+  }
+  return false;
+}
+
+void JSRT_ConnPoolCloseIdle(JSRT_ConnPool* pool) {
+  // Detach the idle lists first so close_fn may safely call back into the pool
+  JSRT_ConnPoolIdle* closing = NULL;
+  JSRT_ConnPoolOrigin* origin = pool->origins;
+  while (origin) {
+    JSRT_ConnPoolOrigin* next_origin = origin->next;
+    while (origin->idle) {
+      JSRT_ConnPoolIdle* entry = origin->idle;
+      origin->idle = entry->next;
+      entry->next = closing;
+      closing = entry;
+    }
+    origin->idle_count = 0;
+    conn_pool_maybe_remove_origin(pool, origin);
+    origin = next_origin;
+  }
+  conn_pool_stop_idle_timer(pool);
+
+  while (closing) {
+    JSRT_ConnPoolIdle* next = closing->next;
+    pool->close_fn(closing->conn, pool->opaque);
+    free(closing);
+    closing = next;
+  }
+}
+
+void JSRT_ConnPoolGetStats(JSRT_ConnPool* pool, JSRT_ConnPoolStats* stats) {
+  *stats = pool->stats;
+  stats->active = 0;
+  stats->idle = 0;
+  stats->waiting = 0;
+
+  for (JSRT_ConnPoolOrigin* origin = pool->origins; origin; origin = origin->next) {
+    stats->active += origin->active;
+    stats->idle += origin->idle_count;
+    for (JSRT_ConnPoolWaiter* waiter = origin->waiters_head; waiter; waiter = waiter->next) {
+      stats->waiting++;
+    }
+  }
+}
@@ -0,0 +1,71 @@
+#ifndef __JSRT_UTIL_CONN_POOL_H__
+#define __JSRT_UTIL_CONN_POOL_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <uv.h>
+
+// Per-origin keep-alive connection pool.
+//
+// The pool only does the bookkeeping: it counts connections per origin key
+// (e.g. "host:port"), keeps released connections idle for reuse, queues
+// requests once maxSockets is reached and closes idle connections that time
+// out or exceed maxFreeSockets. Connections are opaque pointers, so the same
+// pool serves both fetch (raw uv_tcp_t) and http.Agent (net.Socket).
+//
+// JSRT_ConnPoolRelease may call a queued request's ready callback before it
+// returns, so callers must be done with the connection when they release it.
+
+typedef struct JSRT_ConnPool JSRT_ConnPool;
+
+typedef struct {
+  int max_sockets;           // Connections serving requests per origin (<= 0 means unlimited)
+  int max_free_sockets;      // Idle connections kept per origin
+  uint64_t idle_timeout_ms;  // Idle connections are closed after this long (0 disables the timeout)
+} JSRT_ConnPoolOptions;
+
+typedef struct {
+  uint64_t created;    // Connections opened through the pool
+  uint64_t reused;     // Requests served by an idle connection
+  uint64_t timed_out;  // Idle connections closed by the idle timeout
+  uint64_t evicted;    // Released connections closed because maxFreeSockets was reached
+  uint32_t active;     // Connections currently serving a request
+  uint32_t idle;       // Connections waiting for reuse
+  uint32_t waiting;    // Requests queued for a free slot
+} JSRT_ConnPoolStats;
+
+// Closes a connection the pool no longer wants (idle timeout, eviction, pool teardown)
+typedef void (*JSRT_ConnPoolCloseFn)(void* conn, void* opaque);
+
+// A queued request got its turn: conn is an idle connection to reuse, or NULL to open a new one
+typedef void (*JSRT_ConnPoolReadyFn)(void* conn, void* waiter);
+
+JSRT_ConnPool* JSRT_ConnPoolNew(uv_loop_t* loop, const JSRT_ConnPoolOptions* options, JSRT_ConnPoolCloseFn close_fn,
+                                void* opaque);
+
+// Closes every idle connection; requests still queued are dropped
+void JSRT_ConnPoolFree(JSRT_ConnPool* pool);
+
+// Returns 1 with *conn set to an idle connection, 1 with *conn NULL when the caller should open a
+// new connection, 0 when the request was queued for ready_fn, or -1 when out of memory
+int JSRT_ConnPoolAcquire(JSRT_ConnPool* pool, const char* key, void** conn, JSRT_ConnPoolReadyFn ready_fn,
+                         void* waiter);
+
+// Drop a queued request; returns false if it was not queued
+bool JSRT_ConnPoolCancel(JSRT_ConnPool* pool, const char* key, void* waiter);
+
+// A request finished with conn. Reusable connections go idle (or to the next queued request);
+// otherwise the caller closes conn itself and only the slot is returned. conn may be NULL when
+// the connection was never established.
+void JSRT_ConnPoolRelease(JSRT_ConnPool* pool, const char* key, void* conn, bool reusable);
+
+// Forget an idle connection that failed on its own (e.g. the peer closed it); the caller closes it.
+// Returns false if conn was not idle in the pool.
+bool JSRT_ConnPoolRemoveIdle(JSRT_ConnPool* pool, const char* key, void* conn);
+
+// Close every idle connection; connections serving requests and queued requests are kept
+void JSRT_ConnPoolCloseIdle(JSRT_ConnPool* pool);
+
+void JSRT_ConnPoolGetStats(JSRT_ConnPool* pool, JSRT_ConnPoolStats* stats);
+
+#endif
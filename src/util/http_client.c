@@ -144,9 +144,10 @@ static char* extract_location_header(const char* response_data, size_t response_
 }
 
 // Internal function to build HTTP request (now uses shared implementation)
-static char* build_http_request(const char* method, const char* path, const char* host, int port) {
-  // Use the shared HTTP request builder with no custom headers or body
-  return jsrt_http_build_request(method, path, host, port, NULL, 0, NULL);
+static char* build_http_request(const char* method, const char* path, const char* host, int port,
+                                jsrt_http_header_entry_t* headers) {
+  // Use the shared HTTP request builder with no body
+  return jsrt_http_build_request(method, path, host, port, NULL, 0, headers);
 }
 
 // Internal function to parse HTTP response using jsrt_http_parser
@@ -218,13 +219,19 @@ static JSRT_HttpResponse parse_http_response(const char* response_data, size_t r
 }
 
 // Internal function to perform HTTP request with SSL/redirect support
-static JSRT_HttpResponse http_request_internal(const char* url, int redirect_count);
+static JSRT_HttpResponse http_request_internal(const char* url, jsrt_http_header_entry_t* headers,
+                                               int redirect_count);
 
 JSRT_HttpResponse JSRT_HttpGet(const char* url) {
-  return http_request_internal(url, 0);
+  return http_request_internal(url, NULL, 0);
 }
 
-static JSRT_HttpResponse http_request_internal(const char* url, int redirect_count) {
+JSRT_HttpResponse JSRT_HttpGetWithHeaders(const char* url, jsrt_http_header_entry_t* headers) {
+  return http_request_internal(url, headers, 0);
+}
+
+static JSRT_HttpResponse http_request_internal(const char* url, jsrt_http_header_entry_t* headers,
+                                               int redirect_count) {
   JSRT_HttpResponse response = {0};
   char* host = NULL;
   char* path = NULL;
@@ -235,7 +242,6 @@ static JSRT_HttpResponse http_request_internal(const char* url, int redirect_cou
 #else
   int sockfd = -1;
 #endif
-  struct sockaddr_in serv_addr;
   char* http_request = NULL;
   char* response_buffer = NULL;
   size_t response_capacity = 4096;
@@ -272,7 +278,7 @@ static JSRT_HttpResponse http_request_internal(const char* url, int redirect_cou
   }
 
   // Build HTTP request
-  http_request = build_http_request("GET", path, host, port);
+  http_request = build_http_request("GET", path, host, port, headers);
   if (!http_request) {
     response.error = JSRT_HTTP_ERROR_OUT_OF_MEMORY;
     goto cleanup;
@@ -287,48 +293,49 @@ static JSRT_HttpResponse http_request_internal(const char* url, int redirect_cou
     }
   }
 
-  // Create socket
-  sockfd = socket(AF_INET, SOCK_STREAM, 0);
-#ifdef _WIN32
-  if (sockfd == INVALID_SOCKET) {
-#else
-  if (sockfd < 0) {
-#endif
-    response.error = JSRT_HTTP_ERROR_NETWORK;
-    goto cleanup;
-  }
-
-  // Setup server address
-  memset(&serv_addr, 0, sizeof(serv_addr));
-  serv_addr.sin_family = AF_INET;
-  serv_addr.sin_port = htons(port);
-
-  // Resolve hostname
-#ifdef _WIN32
-  struct addrinfo hints, *result = NULL;
+  // Resolve hostname (IPv4 or IPv6; getaddrinfo is also safe to call from worker threads)
+  struct addrinfo hints, *addresses = NULL;
   memset(&hints, 0, sizeof(hints));
-  hints.ai_family = AF_INET;
+  hints.ai_family = AF_UNSPEC;
   hints.ai_socktype = SOCK_STREAM;
 
-  if (getaddrinfo(host, NULL, &hints, &result) != 0 || !result) {
+  char port_str[16];
+  snprintf(port_str, sizeof(port_str), "%d", port);
+  if (getaddrinfo(host, port_str, &hints, &addresses) != 0 || !addresses) {
     response.error = JSRT_HTTP_ERROR_NETWORK;
     goto cleanup;
   }
 
-  struct sockaddr_in* addr_in = (struct sockaddr_in*)result->ai_addr;
-  serv_addr.sin_addr = addr_in->sin_addr;
-  freeaddrinfo(result);
+  // Connect to the first address that accepts
+  for (struct addrinfo* address = addresses; address; address = address->ai_next) {
+    sockfd = socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+#ifdef _WIN32
+    if (sockfd == INVALID_SOCKET) {
+      continue;
+    }
+    if (connect(sockfd, address->ai_addr, (int)address->ai_addrlen) == 0) {
+      break;
+    }
+    closesocket(sockfd);
+    sockfd = INVALID_SOCKET;
 #else
-  struct hostent* server = gethostbyname(host);
-  if (!server) {
-    response.error = JSRT_HTTP_ERROR_NETWORK;
-    goto cleanup;
-  }
-  memcpy(&serv_addr.sin_addr.s_addr, server->h_addr, server->h_length);
+    if (sockfd < 0) {
+      continue;
+    }
+    if (connect(sockfd, address->ai_addr, address->ai_addrlen) == 0) {
+      break;
+    }
+    close(sockfd);
+    sockfd = -1;
 #endif
+  }
+  freeaddrinfo(addresses);
 
-  // Connect to server
-  if (connect(sockfd, (struct sockaddr*)&serv_addr, sizeof(serv_addr)) < 0) {
+#ifdef _WIN32
+  if (sockfd == INVALID_SOCKET) {
+#else
+  if (sockfd < 0) {
+#endif
     response.error = JSRT_HTTP_ERROR_NETWORK;
     goto cleanup;
   }
@@ -420,7 +427,7 @@ static JSRT_HttpResponse http_request_internal(const char* url, int redirect_cou
       JSRT_HttpResponseFree(&response);
 
       // Recursive call to handle redirect
-      response = http_request_internal(location, redirect_count + 1);
+      response = http_request_internal(location, headers, redirect_count + 1);
       free(location);
 
       // Clean up and return redirect result
@@ -3,6 +3,8 @@
 
 #include <stddef.h>
 
+#include "http_request.h"
+
 // HTTP response structure
 typedef struct {
   int status;
@@ -42,6 +44,10 @@ typedef enum {
 // Returns a JSRT_HttpResponse structure that must be freed with JSRT_HttpResponseFree
 JSRT_HttpResponse JSRT_HttpGet(const char* url);
 
+// GET with extra request headers (e.g. If-None-Match); the caller keeps ownership of the list.
+// Any status, including 304 Not Modified, is returned to the caller as-is.
+JSRT_HttpResponse JSRT_HttpGetWithHeaders(const char* url, jsrt_http_header_entry_t* headers);
+
 // Enhanced HTTP GET with custom user agent and timeout
 JSRT_HttpResponse JSRT_HttpGetWithOptions(const char* url, const char* user_agent, int timeout_ms);
 
@@ -8,4 +8,13 @@
 #define countof(x) (sizeof(x) / sizeof((x)[0]))
 #endif
 
+// Storage class for per-runtime state kept in file-scope variables. Every
+// JSRT_Runtime is driven by exactly one thread (the main thread or a
+// worker_threads Worker), so thread-local storage gives each runtime its own copy.
+#if defined(_MSC_VER)
+#define JSRT_THREAD_LOCAL __declspec(thread)
+#else
+#define JSRT_THREAD_LOCAL __thread
+#endif
+
 #endif
@@ -0,0 +1,160 @@
+#include "read_slab.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "../runtime.h"
+#include "debug.h"
+
+typedef struct JSRT_ReadSlabBlock {
+  uint8_t* data;
+  size_t used;  // Bytes handed out so far (bump pointer)
+  int refs;     // One for the allocator while this is the current block, one per ArrayBuffer over it
+} JSRT_ReadSlabBlock;
+
+struct JSRT_ReadSlab {
+  JSContext* ctx;
+  JSRT_ReadSlabBlock* current;
+};
+
+static void read_slab_block_unref(JSRT_ReadSlabBlock* block) {
+  if (--block->refs == 0) {
+    free(block->data);
+    free(block);
+  }
+}
+
+// ArrayBuffer free function: runs when the last view of a read is collected, or early if JS detaches it.
+// A detached buffer is finalized later with ptr == NULL; its reference is already gone by then.
+static void read_slab_array_buffer_free(JSRuntime* rt, void* opaque, void* ptr) {
+  if (ptr) {
+    read_slab_block_unref(opaque);
+  }
+}
+
+static JSRT_ReadSlabBlock* read_slab_block_new(JSRT_ReadSlab* slab) {
+  JSRT_ReadSlabBlock* block = calloc(1, sizeof(JSRT_ReadSlabBlock));
+  if (!block) {
+    return NULL;
+  }
+
+  block->data = malloc(JSRT_READ_SLAB_SIZE);
+  if (!block->data) {
+    free(block);
+    return NULL;
+  }
+
+  block->refs = 1;
+  return block;
+}
+
+// Stop allocating from the current block; views handed out keep it alive
+static void read_slab_retire(JSRT_ReadSlab* slab) {
+  JSRT_ReadSlabBlock* block = slab->current;
+  if (!block) {
+    return;
+  }
+
+  slab->current = NULL;
+  read_slab_block_unref(block);
+}
+
+static JSRT_ReadSlab* read_slab_from_handle(uv_handle_t* handle) {
+  JSRT_Runtime* rt = handle->loop->data;
+  return rt ? rt->read_slab : NULL;
+}
+
+// True when buf is the slice most recently handed out from the current block
+static bool read_slab_owns_last(JSRT_ReadSlab* slab, const uv_buf_t* buf) {
+  JSRT_ReadSlabBlock* block = slab->current;
+  if (!block || !buf->base) {
+    return false;
+  }
+
+  uint8_t* base = (uint8_t*)buf->base;
+  return base >= block->data && base + buf->len == block->data + block->used;
+}
+
+JSRT_ReadSlab* JSRT_ReadSlabNew(JSContext* ctx) {
+  JSRT_ReadSlab* slab = calloc(1, sizeof(JSRT_ReadSlab));
+  if (slab) {
+    slab->ctx = ctx;
+  }
+  return slab;
+}
+
+void JSRT_ReadSlabFree(JSRT_ReadSlab* slab) {
+  if (!slab) {
+    return;
+  }
+
+  read_slab_retire(slab);
+  free(slab);
+}
+
+void JSRT_ReadSlabAlloc(uv_handle_t* handle, size_t suggested_size, uv_buf_t* buf) {
+  buf->base = NULL;
+  buf->len = 0;
+
+  JSRT_ReadSlab* slab = read_slab_from_handle(handle);
+  if (!slab) {
+    return;
+  }
+
+  JSRT_ReadSlabBlock* block = slab->current;
+  if (!block || JSRT_READ_SLAB_SIZE - block->used < JSRT_READ_SLAB_MIN_READ) {
+    read_slab_retire(slab);
+    block = slab->current = read_slab_block_new(slab);
+    if (!block) {
+      JSRT_Debug("read slab: failed to allocate a new block");
+      return;
+    }
+  }
+
+  size_t len = JSRT_READ_SLAB_SIZE - block->used;
+  if (suggested_size < len) {
+    len = suggested_size;
+  }
+
+  buf->base = (char*)block->data + block->used;
+  buf->len = len;
+  block->used += len;
+}
+
+void JSRT_ReadSlabRelease(uv_handle_t* handle, const uv_buf_t* buf, size_t used) {
+  JSRT_ReadSlab* slab = read_slab_from_handle(handle);
+  if (!slab || !read_slab_owns_last(slab, buf)) {
+    return;
+  }
+
+  // Keep the next slice 8-byte aligned so typed array views over it stay valid
+  JSRT_ReadSlabBlock* block = slab->current;
+  size_t end = (size_t)((uint8_t*)buf->base - block->data) + used;
+  block->used = (end + 7) & ~(size_t)7;
+  if (block->used > JSRT_READ_SLAB_SIZE) {
+    block->used = JSRT_READ_SLAB_SIZE;
+  }
+}
+
+JSValue JSRT_ReadSlabTake(uv_handle_t* handle, const uv_buf_t* buf, size_t used) {
+  JSRT_ReadSlab* slab = read_slab_from_handle(handle);
+  JSContext* ctx = slab->ctx;
+
+  // The ArrayBuffer spans just these bytes, so JS cannot reach what other reads put in the block
+  if (read_slab_owns_last(slab, buf)) {
+    JSRT_ReadSlabBlock* block = slab->current;
+    JSValue array_buffer =
+        JS_NewArrayBuffer(ctx, (uint8_t*)buf->base, used, read_slab_array_buffer_free, block, false);
+    if (!JS_IsException(array_buffer)) {
+      block->refs++;
+      JSRT_ReadSlabRelease(handle, buf, used);
+      return array_buffer;
+    }
+    JS_FreeValue(ctx, JS_GetException(ctx));
+  }
+
+  JSValue copy = JS_NewArrayBufferCopy(ctx, (const uint8_t*)buf->base, used);
+  JSRT_ReadSlabRelease(handle, buf, 0);
+  return copy;
+}
@@ -0,0 +1,38 @@
+#ifndef __JSRT_UTIL_READ_SLAB_H__
+#define __JSRT_UTIL_READ_SLAB_H__
+
+#include <quickjs.h>
+#include <stddef.h>
+#include <uv.h>
+
+// Per-runtime slab allocator for libuv read buffers.
+//
+// Reads are carved out of large blocks, so received bytes can be handed to JS
+// with no per-read malloc and no second copy: each read gets its own
+// ArrayBuffer over exactly the bytes it received, which cannot reach what
+// other reads put in the same block. A block lives until the allocator has
+// moved on and the last ArrayBuffer over it has been collected.
+//
+// libuv calls read_cb right after alloc_cb for the same handle, so every read
+// callback must pass its buffer to JSRT_ReadSlabTake or JSRT_ReadSlabRelease
+// before returning. Only handles on a JSRT runtime loop may use these.
+
+#define JSRT_READ_SLAB_SIZE (256 * 1024)
+#define JSRT_READ_SLAB_MIN_READ (16 * 1024)
+
+typedef struct JSRT_ReadSlab JSRT_ReadSlab;
+
+JSRT_ReadSlab* JSRT_ReadSlabNew(JSContext* ctx);
+void JSRT_ReadSlabFree(JSRT_ReadSlab* slab);
+
+// uv_alloc_cb: hands out a slice of the current block (base is NULL on OOM, which libuv reports as UV_ENOBUFS)
+void JSRT_ReadSlabAlloc(uv_handle_t* handle, size_t suggested_size, uv_buf_t* buf);
+
+// Return the part of buf beyond the first `used` bytes to the slab (used == 0 releases the whole slice)
+void JSRT_ReadSlabRelease(uv_handle_t* handle, const uv_buf_t* buf, size_t used);
+
+// Keep the first `used` bytes of buf and return an ArrayBuffer of exactly those bytes.
+// Falls back to a private copy when buf is not the slice last handed out.
+JSValue JSRT_ReadSlabTake(uv_handle_t* handle, const uv_buf_t* buf, size_t used);
+
+#endif
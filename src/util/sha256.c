@@ -0,0 +1,130 @@
+#include "sha256.h"
+
+#include <string.h>
+
+static const uint32_t sha256_k[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,  //
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,  //
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,  //
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,  //
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,  //
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,  //
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,  //
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,  //
+};
+
+#define ROTR(x, n) (((x) >> (n)) | ((x) << (32 - (n))))
+
+static void sha256_compress(uint32_t state[8], const uint8_t block[64]) {
+  uint32_t w[64];
+  for (int i = 0; i < 16; i++) {
+    w[i] = ((uint32_t)block[i * 4] << 24) | ((uint32_t)block[i * 4 + 1] << 16) | ((uint32_t)block[i * 4 + 2] << 8) |
+           (uint32_t)block[i * 4 + 3];
+  }
+  for (int i = 16; i < 64; i++) {
+    uint32_t s0 = ROTR(w[i - 15], 7) ^ ROTR(w[i - 15], 18) ^ (w[i - 15] >> 3);
+    uint32_t s1 = ROTR(w[i - 2], 17) ^ ROTR(w[i - 2], 19) ^ (w[i - 2] >> 10);
+    w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+  }
+
+  uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+  uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+  for (int i = 0; i < 64; i++) {
+    uint32_t t1 = h + (ROTR(e, 6) ^ ROTR(e, 11) ^ ROTR(e, 25)) + ((e & f) ^ (~e & g)) + sha256_k[i] + w[i];
+    uint32_t t2 = (ROTR(a, 2) ^ ROTR(a, 13) ^ ROTR(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+    h = g;
+    g = f;
+    f = e;
+    e = d + t1;
+    d = c;
+    c = b;
+    b = a;
+    a = t1 + t2;
+  }
+
+  state[0] += a;
+  state[1] += b;
+  state[2] += c;
+  state[3] += d;
+  state[4] += e;
+  state[5] += f;
+  state[6] += g;
+  state[7] += h;
+}
+
+void JSRT_Sha256Init(JSRT_Sha256* sha) {
+  static const uint32_t initial[8] = {0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+                                      0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+  memcpy(sha->state, initial, sizeof(initial));
+  sha->length = 0;
+  sha->block_len = 0;
+}
+
+void JSRT_Sha256Update(JSRT_Sha256* sha, const void* data, size_t len) {
+  const uint8_t* p = data;
+  sha->length += len;
+
+  if (sha->block_len > 0) {
+    size_t take = 64 - sha->block_len;
+    if (take > len) {
+      take = len;
+    }
+    memcpy(sha->block + sha->block_len, p, take);
+    sha->block_len += take;
+    p += take;
+    len -= take;
+    if (sha->block_len < 64) {
+      return;
+    }
+    sha256_compress(sha->state, sha->block);
+    sha->block_len = 0;
+  }
+
+  for (; len >= 64; p += 64, len -= 64) {
+    sha256_compress(sha->state, p);
+  }
+
+  memcpy(sha->block, p, len);
+  sha->block_len = len;
+}
+
+void JSRT_Sha256Final(JSRT_Sha256* sha, uint8_t digest[JSRT_SHA256_DIGEST_LENGTH]) {
+  uint64_t bits = sha->length * 8;
+
+  sha->block[sha->block_len++] = 0x80;
+  if (sha->block_len > 56) {
+    memset(sha->block + sha->block_len, 0, 64 - sha->block_len);
+    sha256_compress(sha->state, sha->block);
+    sha->block_len = 0;
+  }
+  memset(sha->block + sha->block_len, 0, 56 - sha->block_len);
+  for (int i = 0; i < 8; i++) {
+    sha->block[56 + i] = (uint8_t)(bits >> (56 - i * 8));
+  }
+  sha256_compress(sha->state, sha->block);
+
+  for (int i = 0; i < 8; i++) {
+    digest[i * 4] = (uint8_t)(sha->state[i] >> 24);
+    digest[i * 4 + 1] = (uint8_t)(sha->state[i] >> 16);
+    digest[i * 4 + 2] = (uint8_t)(sha->state[i] >> 8);
+    digest[i * 4 + 3] = (uint8_t)sha->state[i];
+  }
+}
+
+void JSRT_Sha256Digest(const void* data, size_t len, uint8_t digest[JSRT_SHA256_DIGEST_LENGTH]) {
+  JSRT_Sha256 sha;
+  JSRT_Sha256Init(&sha);
+  JSRT_Sha256Update(&sha, data, len);
+  JSRT_Sha256Final(&sha, digest);
+}
+
+void JSRT_Sha256Hex(const void* data, size_t len, char hex[JSRT_SHA256_DIGEST_LENGTH * 2 + 1]) {
+  static const char digits[] = "0123456789abcdef";
+  uint8_t digest[JSRT_SHA256_DIGEST_LENGTH];
+  JSRT_Sha256Digest(data, len, digest);
+  for (int i = 0; i < JSRT_SHA256_DIGEST_LENGTH; i++) {
+    hex[i * 2] = digits[digest[i] >> 4];
+    hex[i * 2 + 1] = digits[digest[i] & 0xf];
+  }
+  hex[JSRT_SHA256_DIGEST_LENGTH * 2] = '\0';
+}
@@ -0,0 +1,29 @@
+#ifndef __JSRT_UTIL_SHA256_H__
+#define __JSRT_UTIL_SHA256_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+// SHA-256 (FIPS 180-4) for places that must not depend on OpenSSL being loadable,
+// such as cache keys and integrity checks of downloaded modules.
+
+#define JSRT_SHA256_DIGEST_LENGTH 32
+
+typedef struct {
+  uint32_t state[8];
+  uint64_t length;  // bytes hashed so far
+  uint8_t block[64];
+  size_t block_len;
+} JSRT_Sha256;
+
+void JSRT_Sha256Init(JSRT_Sha256* sha);
+void JSRT_Sha256Update(JSRT_Sha256* sha, const void* data, size_t len);
+void JSRT_Sha256Final(JSRT_Sha256* sha, uint8_t digest[JSRT_SHA256_DIGEST_LENGTH]);
+
+// One-shot digest of len bytes at data
+void JSRT_Sha256Digest(const void* data, size_t len, uint8_t digest[JSRT_SHA256_DIGEST_LENGTH]);
+
+// Writes the digest as 64 lowercase hex characters plus a terminator
+void JSRT_Sha256Hex(const void* data, size_t len, char hex[JSRT_SHA256_DIGEST_LENGTH * 2 + 1]);
+
+#endif
@@ -0,0 +1,440 @@
+#include "unicode.h"
+
+#include <string.h>
+
+#include "macro.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define JSRT_UNICODE_SSE2
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define JSRT_UNICODE_AVX2
+#endif
+#elif defined(__aarch64__) && defined(__ARM_NEON) && !defined(__ARM_BIG_ENDIAN)
+#include <arm_neon.h>
+#define JSRT_UNICODE_NEON
+#endif
+
+typedef size_t (*JSRT_ASCIIPrefixFunc)(const uint8_t* data, size_t len);
+
+static size_t ascii_prefix_scalar(const uint8_t* data, size_t len) {
+  size_t i = 0;
+  for (; i + 8 <= len; i += 8) {
+    uint64_t word;
+    memcpy(&word, data + i, sizeof(word));
+    if (word & 0x8080808080808080ULL) {
+      break;
+    }
+  }
+  while (i < len && data[i] < 0x80) {
+    i++;
+  }
+  return i;
+}
+
+#if defined(JSRT_UNICODE_SSE2)
+static size_t ascii_prefix_sse2(const uint8_t* data, size_t len) {
+  size_t i = 0;
+  for (; i + 32 <= len; i += 32) {
+    __m128i a = _mm_loadu_si128((const __m128i*)(data + i));
+    __m128i b = _mm_loadu_si128((const __m128i*)(data + i + 16));
+    if (_mm_movemask_epi8(_mm_or_si128(a, b))) {
+      break;
+    }
+  }
+  for (; i + 16 <= len; i += 16) {
+    int mask = _mm_movemask_epi8(_mm_loadu_si128((const __m128i*)(data + i)));
+    if (mask) {
+      return i + __builtin_ctz(mask);
+    }
+  }
+  return i + ascii_prefix_scalar(data + i, len - i);
+}
+#endif
+
+#if defined(JSRT_UNICODE_AVX2)
+__attribute__((target("avx2"))) static size_t ascii_prefix_avx2(const uint8_t* data, size_t len) {
+  size_t i = 0;
+  for (; i + 64 <= len; i += 64) {
+    __m256i a = _mm256_loadu_si256((const __m256i*)(data + i));
+    __m256i b = _mm256_loadu_si256((const __m256i*)(data + i + 32));
+    if (_mm256_movemask_epi8(_mm256_or_si256(a, b))) {
+      break;
+    }
+  }
+  for (; i + 32 <= len; i += 32) {
+    uint32_t mask = (uint32_t)_mm256_movemask_epi8(_mm256_loadu_si256((const __m256i*)(data + i)));
+    if (mask) {
+      return i + __builtin_ctz(mask);
+    }
+  }
+  return i + ascii_prefix_sse2(data + i, len - i);
+}
+#endif
+
+#if defined(JSRT_UNICODE_NEON)
+static size_t ascii_prefix_neon(const uint8_t* data, size_t len) {
+  size_t i = 0;
+  for (; i + 16 <= len; i += 16) {
+    if (vmaxvq_u8(vld1q_u8(data + i)) >= 0x80) {
+      break;
+    }
+  }
+  return i + ascii_prefix_scalar(data + i, len - i);
+}
+#endif
+
+static size_t ascii_prefix_resolve(const uint8_t* data, size_t len);
+
+// Picked on first use from what the CPU supports
+static JSRT_THREAD_LOCAL JSRT_ASCIIPrefixFunc ascii_prefix_impl = ascii_prefix_resolve;
+
+static size_t ascii_prefix_resolve(const uint8_t* data, size_t len) {
+#if defined(JSRT_UNICODE_AVX2)
+  ascii_prefix_impl = __builtin_cpu_supports("avx2") ? ascii_prefix_avx2 : ascii_prefix_sse2;
+#elif defined(JSRT_UNICODE_SSE2)
+  ascii_prefix_impl = ascii_prefix_sse2;
+#elif defined(JSRT_UNICODE_NEON)
+  ascii_prefix_impl = ascii_prefix_neon;
+#else
+  ascii_prefix_impl = ascii_prefix_scalar;
+#endif
+  return ascii_prefix_impl(data, len);
+}
+
+size_t JSRT_ASCIIPrefix(const uint8_t* data, size_t len) {
+  return ascii_prefix_impl(data, len);
+}
+
+// Copies the leading run of ASCII code units of UTF-16 src to dst, one byte each; returns its length
+static size_t utf16_ascii_copy(const uint8_t* src, size_t units, bool big_endian, uint8_t* dst) {
+  size_t i = 0;
+#if defined(JSRT_UNICODE_SSE2)
+  // Lanes hold the code units byte-swapped when big endian
+  const __m128i mask = _mm_set1_epi16(big_endian ? (short)0x80ff : (short)0xff80);
+  const __m128i zero = _mm_setzero_si128();
+  for (; i + 8 <= units; i += 8) {
+    __m128i v = _mm_loadu_si128((const __m128i*)(src + 2 * i));
+    if (_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(v, mask), zero)) != 0xffff) {
+      break;
+    }
+    if (big_endian) {
+      v = _mm_srli_epi16(v, 8);
+    }
+    _mm_storel_epi64((__m128i*)(dst + i), _mm_packus_epi16(v, v));
+  }
+#elif defined(JSRT_UNICODE_NEON)
+  for (; i + 8 <= units; i += 8) {
+    uint8x16_t bytes = vld1q_u8(src + 2 * i);
+    if (big_endian) {
+      bytes = vrev16q_u8(bytes);
+    }
+    uint16x8_t v = vreinterpretq_u16_u8(bytes);
+    if (vmaxvq_u16(v) >= 0x80) {
+      break;
+    }
+    vst1_u8(dst + i, vmovn_u16(v));
+  }
+#endif
+  int hi = big_endian ? 0 : 1;
+  for (; i < units; i++) {
+    uint8_t lo = src[2 * i + 1 - hi];
+    if (src[2 * i + hi] != 0 || lo >= 0x80) {
+      break;
+    }
+    dst[i] = lo;
+  }
+  return i;
+}
+
+static inline uint32_t utf16_load(const uint8_t* p, bool big_endian) {
+  return big_endian ? ((uint32_t)p[0] << 8) | p[1] : p[0] | ((uint32_t)p[1] << 8);
+}
+
+// Next code point of a string from JS_ToCStringLen (lone surrogates arrive as 3-byte sequences)
+static uint32_t utf8_next(const uint8_t** pp, const uint8_t* end) {
+  const uint8_t* p = *pp;
+  uint32_t c = *p++;
+  if (c >= 0xc0) {
+    int extra = c >= 0xf0 ? 3 : c >= 0xe0 ? 2 : 1;
+    c &= 0x3f >> extra;
+    while (extra-- > 0 && p < end && (*p & 0xc0) == 0x80) {
+      c = (c << 6) | (*p++ & 0x3f);
+    }
+  }
+  *pp = p;
+  return c;
+}
+
+size_t JSRT_UTF8Encode(uint8_t* dst, uint32_t c) {
+  if (c < 0x80) {
+    dst[0] = (uint8_t)c;
+    return 1;
+  }
+  if (c < 0x800) {
+    dst[0] = (uint8_t)(0xc0 | (c >> 6));
+    dst[1] = (uint8_t)(0x80 | (c & 0x3f));
+    return 2;
+  }
+  if (c < 0x10000) {
+    dst[0] = (uint8_t)(0xe0 | (c >> 12));
+    dst[1] = (uint8_t)(0x80 | ((c >> 6) & 0x3f));
+    dst[2] = (uint8_t)(0x80 | (c & 0x3f));
+    return 3;
+  }
+  dst[0] = (uint8_t)(0xf0 | (c >> 18));
+  dst[1] = (uint8_t)(0x80 | ((c >> 12) & 0x3f));
+  dst[2] = (uint8_t)(0x80 | ((c >> 6) & 0x3f));
+  dst[3] = (uint8_t)(0x80 | (c & 0x3f));
+  return 4;
+}
+
+int JSRT_UTF8DecodeStrict(const uint8_t* data, size_t len, const uint8_t** next) {
+  *next = data;
+  if (len == 0) {
+    return -1;
+  }
+
+  uint32_t c = data[0];
+  if (c < 0x80) {
+    *next = data + 1;
+    return (int)c;
+  }
+
+  size_t size;
+  uint32_t min;
+  if ((c & 0xe0) == 0xc0) {
+    size = 2;
+    min = 0x80;
+    c &= 0x1f;
+  } else if ((c & 0xf0) == 0xe0) {
+    size = 3;
+    min = 0x800;
+    c &= 0x0f;
+  } else if ((c & 0xf8) == 0xf0) {
+    size = 4;
+    min = 0x10000;
+    c &= 0x07;
+  } else {
+    return -1;  // Continuation byte or 0xF8-0xFF
+  }
+
+  if (len < size) {
+    return -1;
+  }
+  for (size_t i = 1; i < size; i++) {
+    if ((data[i] & 0xc0) != 0x80) {
+      return -1;
+    }
+    c = (c << 6) | (data[i] & 0x3f);
+  }
+
+  // Overlong forms, UTF-16 surrogates and values beyond Unicode are not UTF-8
+  if (c < min || (c >= 0xd800 && c <= 0xdfff) || c > 0x10ffff) {
+    return -1;
+  }
+
+  *next = data + size;
+  return (int)c;
+}
+
+bool JSRT_UTF8Validate(const uint8_t* data, size_t len) {
+  const uint8_t* p = data;
+  const uint8_t* end = data + len;
+  while (p < end) {
+    if (*p < 0x80) {
+      p += JSRT_ASCIIPrefix(p, end - p);
+    } else if (JSRT_UTF8DecodeStrict(p, end - p, &p) < 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+size_t JSRT_UTF8CompleteLength(const uint8_t* data, size_t len) {
+  // A sequence is at most 4 bytes, so only the last 3 can start a truncated one
+  for (size_t back = 1; back <= 3 && back <= len; back++) {
+    uint8_t c = data[len - back];
+    if ((c & 0xc0) == 0x80) {
+      continue;
+    }
+    size_t size = c >= 0xf0 ? 4 : c >= 0xe0 ? 3 : c >= 0xc0 ? 2 : 1;
+    return size > back ? len - back : len;
+  }
+  return len;
+}
+
+size_t JSRT_UTF8UTF16Length(const uint8_t* src, size_t len) {
+  // Every lead byte starts one code unit and 4-byte sequences need a second one
+  size_t units = 0;
+  for (size_t i = 0; i < len; i++) {
+    units += (src[i] & 0xc0) != 0x80;
+    units += src[i] >= 0xf0;
+  }
+  return units;
+}
+
+size_t JSRT_UTF8ToUTF16LE(const uint8_t* src, size_t len, uint8_t* dst, size_t cap) {
+  const uint8_t* end = src + len;
+  size_t n = 0;
+  while (src < end && n + 2 <= cap) {
+    if (*src < 0x80) {
+      size_t room = (cap - n) / 2;
+      size_t run = JSRT_ASCIIPrefix(src, (size_t)(end - src) < room ? (size_t)(end - src) : room);
+      for (size_t i = 0; i < run; i++) {
+        dst[n + 2 * i] = src[i];
+        dst[n + 2 * i + 1] = 0;
+      }
+      src += run;
+      n += 2 * run;
+      continue;
+    }
+
+    uint32_t c = utf8_next(&src, end);
+    if (c > 0xffff) {
+      if (n + 4 > cap) {
+        break;
+      }
+      c -= 0x10000;
+      uint32_t hi = 0xd800 | (c >> 10);
+      dst[n++] = (uint8_t)hi;
+      dst[n++] = (uint8_t)(hi >> 8);
+      c = 0xdc00 | (c & 0x3ff);
+    }
+    dst[n++] = (uint8_t)c;
+    dst[n++] = (uint8_t)(c >> 8);
+  }
+  return n;
+}
+
+size_t JSRT_UTF8ToLatin1(const uint8_t* src, size_t len, uint8_t* dst, size_t cap) {
+  const uint8_t* end = src + len;
+  size_t n = 0;
+  while (src < end && n < cap) {
+    if (*src < 0x80) {
+      size_t room = cap - n;
+      size_t run = JSRT_ASCIIPrefix(src, (size_t)(end - src) < room ? (size_t)(end - src) : room);
+      memcpy(dst + n, src, run);
+      src += run;
+      n += run;
+      continue;
+    }
+
+    uint32_t c = utf8_next(&src, end);
+    if (c > 0xffff) {
+      c -= 0x10000;
+      dst[n++] = (uint8_t)(0xd800 | (c >> 10));
+      if (n == cap) {
+        break;
+      }
+      c = 0xdc00 | (c & 0x3ff);
+    }
+    dst[n++] = (uint8_t)c;
+  }
+  return n;
+}
+
+size_t JSRT_UTF16ToUTF8(const uint8_t* src, size_t units, bool big_endian, uint8_t* dst) {
+  size_t i = 0;
+  size_t n = 0;
+  while (i < units) {
+    size_t run = utf16_ascii_copy(src + 2 * i, units - i, big_endian, dst + n);
+    i += run;
+    n += run;
+    if (i == units) {
+      break;
+    }
+
+    uint32_t c = utf16_load(src + 2 * i++, big_endian);
+    if (c >= 0xd800 && c <= 0xdfff) {
+      uint32_t low = i < units ? utf16_load(src + 2 * i, big_endian) : 0;
+      if (c <= 0xdbff && low >= 0xdc00 && low <= 0xdfff) {
+        c = 0x10000 + ((c - 0xd800) << 10) + (low - 0xdc00);
+        i++;
+      } else {
+        c = 0xfffd;
+      }
+    }
+    n += JSRT_UTF8Encode(dst + n, c);
+  }
+  return n;
+}
+
+size_t JSRT_Latin1ToUTF8(const uint8_t* src, size_t len, uint8_t* dst) {
+  size_t i = 0;
+  size_t n = 0;
+  while (i < len) {
+    size_t run = JSRT_ASCIIPrefix(src + i, len - i);
+    memcpy(dst + n, src + i, run);
+    i += run;
+    n += run;
+    for (; i < len && src[i] >= 0x80; i++) {
+      dst[n++] = (uint8_t)(0xc0 | (src[i] >> 6));
+      dst[n++] = (uint8_t)(0x80 | (src[i] & 0x3f));
+    }
+  }
+  return n;
+}
+
+size_t JSRT_CESU8ToUTF8(const uint8_t* src, size_t len, uint8_t* dst, size_t cap, size_t* units_read) {
+  static const uint8_t replacement[3] = {0xef, 0xbf, 0xbd};
+  size_t i = 0;
+  size_t n = 0;
+  size_t units = 0;
+
+  while (i < len && n < cap) {
+    uint8_t c = src[i];
+    if (c < 0x80) {
+      size_t run = JSRT_ASCIIPrefix(src + i, len - i < cap - n ? len - i : cap - n);
+      memcpy(dst + n, src + i, run);
+      i += run;
+      n += run;
+      units += run;
+      continue;
+    }
+
+    const uint8_t* out = src + i;
+    size_t in_size, out_size, unit_count = 1;
+    uint8_t pair[4];
+    if (c >= 0xf0) {
+      in_size = out_size = 4;
+      unit_count = 2;
+    } else if (c >= 0xe0) {
+      in_size = out_size = 3;
+      if (c == 0xed && i + 1 < len && src[i + 1] >= 0xa0) {
+        // Surrogate: 0xED 0xA0-0xAF starts a high one, 0xED 0xB0-0xBF a low one
+        if (src[i + 1] < 0xb0 && i + 5 < len && src[i + 3] == 0xed && (src[i + 4] & 0xf0) == 0xb0) {
+          uint32_t hi = ((src[i + 1] & 0x0f) << 6) | (src[i + 2] & 0x3f);
+          uint32_t lo = ((src[i + 4] & 0x0f) << 6) | (src[i + 5] & 0x3f);
+          JSRT_UTF8Encode(pair, 0x10000 + (hi << 10) + lo);
+          out = pair;
+          in_size = 6;
+          out_size = 4;
+          unit_count = 2;
+        } else {
+          out = replacement;
+        }
+      }
+    } else if (c >= 0xc0) {
+      in_size = out_size = 2;
+    } else {
+      // Stray continuation byte
+      i++;
+      continue;
+    }
+
+    if (i + in_size > len || n + out_size > cap) {
+      break;
+    }
+    memcpy(dst + n, out, out_size);
+    i += in_size;
+    n += out_size;
+    units += unit_count;
+  }
+
+  if (units_read) {
+    *units_read = units;
+  }
+  return n;
+}
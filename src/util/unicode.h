@@ -0,0 +1,53 @@
+#ifndef __JSRT_UTIL_UNICODE_H__
+#define __JSRT_UTIL_UNICODE_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// UTF-8 / UTF-16 / Latin-1 transcoding kernels shared by TextEncoder,
+// TextDecoder, Buffer and StringDecoder.
+//
+// ASCII runs are found 16 or 32 bytes at a time (SSE2, AVX2 when the CPU
+// supports it, NEON on AArch64, 8-byte words elsewhere) and copied in bulk;
+// only the bytes around non-ASCII characters go through the scalar code.
+
+// Length of the leading run of ASCII bytes in data
+size_t JSRT_ASCIIPrefix(const uint8_t* data, size_t len);
+
+// Encodes code point c at dst (room for 4 bytes); returns the number of bytes written
+size_t JSRT_UTF8Encode(uint8_t* dst, uint32_t c);
+
+// Decodes one well-formed UTF-8 sequence, rejecting overlongs, surrogates and values past U+10FFFF.
+// Returns the code point and sets *next past it, or returns -1 with *next == data.
+int JSRT_UTF8DecodeStrict(const uint8_t* data, size_t len, const uint8_t** next);
+
+// True if all of data is well-formed UTF-8
+bool JSRT_UTF8Validate(const uint8_t* data, size_t len);
+
+// Length of data without a trailing sequence that is cut short (for decoders fed in chunks)
+size_t JSRT_UTF8CompleteLength(const uint8_t* data, size_t len);
+
+// Number of UTF-16 code units in a string from JS_ToCStringLen
+size_t JSRT_UTF8UTF16Length(const uint8_t* src, size_t len);
+
+// String from JS_ToCStringLen to UTF-16LE; writes at most cap bytes without splitting a character
+size_t JSRT_UTF8ToUTF16LE(const uint8_t* src, size_t len, uint8_t* dst, size_t cap);
+
+// String from JS_ToCStringLen to one byte per UTF-16 code unit (its low byte), as Buffer's latin1 does.
+// Writes at most cap bytes; returns the number of bytes written.
+size_t JSRT_UTF8ToLatin1(const uint8_t* src, size_t len, uint8_t* dst, size_t cap);
+
+// `units` UTF-16 code units at src to UTF-8, lone surrogates becoming U+FFFD.
+// dst needs room for units * 3 bytes; returns the number of bytes written.
+size_t JSRT_UTF16ToUTF8(const uint8_t* src, size_t units, bool big_endian, uint8_t* dst);
+
+// Latin-1 to UTF-8; dst needs room for len * 2 bytes
+size_t JSRT_Latin1ToUTF8(const uint8_t* src, size_t len, uint8_t* dst);
+
+// String from JS_ToCStringLen2 (CESU-8 or not) to well-formed UTF-8: surrogate pairs are joined and lone
+// surrogates become U+FFFD. Writes at most cap bytes without splitting a character (cap >= len always
+// suffices). *units_read, when not NULL, receives the number of UTF-16 code units consumed.
+size_t JSRT_CESU8ToUTF8(const uint8_t* src, size_t len, uint8_t* dst, size_t cap, size_t* units_read);
+
+#endif
@@ -0,0 +1,116 @@
+// structuredClone: built-in types, transfer lists and large graphs
+const assert = require('jsrt:assert');
+
+// Map and Set, with keys and values cloned and identities kept
+const key = { id: 1 };
+const map = new Map([
+  [key, 'one'],
+  ['self', key],
+]);
+const mapClone = structuredClone(map);
+assert.ok(mapClone instanceof Map);
+assert.strictEqual(mapClone.size, 2);
+const [clonedKey] = mapClone.keys();
+assert.notStrictEqual(clonedKey, key);
+assert.strictEqual(mapClone.get(clonedKey), 'one');
+assert.strictEqual(mapClone.get('self'), clonedKey);
+
+const set = new Set([1, 'two', key]);
+const setClone = structuredClone(set);
+assert.ok(setClone instanceof Set);
+assert.deepStrictEqual([...setClone].slice(0, 2), [1, 'two']);
+
+// Views over one buffer still share their (cloned) buffer
+const buffer = new ArrayBuffer(16);
+const bytes = new Uint8Array(buffer);
+bytes.set([1, 2, 3, 4]);
+const words = new Uint16Array(buffer, 4, 2);
+const view = new DataView(buffer, 8, 4);
+const views = structuredClone({ bytes, words, view });
+assert.ok(views.bytes instanceof Uint8Array);
+assert.ok(views.words instanceof Uint16Array);
+assert.ok(views.view instanceof DataView);
+assert.notStrictEqual(views.bytes.buffer, buffer);
+assert.strictEqual(views.bytes.buffer, views.words.buffer);
+assert.strictEqual(views.bytes.buffer, views.view.buffer);
+assert.strictEqual(views.words.byteOffset, 4);
+assert.strictEqual(views.words.length, 2);
+assert.strictEqual(views.view.byteLength, 4);
+assert.deepStrictEqual(Array.from(views.bytes.slice(0, 4)), [1, 2, 3, 4]);
+views.bytes[8] = 42;
+assert.strictEqual(views.view.getUint8(0), 42);
+assert.strictEqual(bytes[8], 0);
+
+// Errors keep their type, message and cause
+const error = new RangeError('out of range', { cause: { code: 7 } });
+const errorClone = structuredClone(error);
+assert.ok(errorClone instanceof RangeError);
+assert.strictEqual(errorClone.message, 'out of range');
+assert.deepStrictEqual(errorClone.cause, { code: 7 });
+assert.strictEqual(errorClone.stack, error.stack);
+
+// Primitive wrappers
+assert.strictEqual(structuredClone(new String('s')).valueOf(), 's');
+assert.strictEqual(structuredClone(new Number(3)).valueOf(), 3);
+
+// Blob
+if (typeof Blob !== 'undefined') {
+  const blob = new Blob(['hello'], { type: 'text/plain' });
+  const blobClone = structuredClone(blob);
+  assert.ok(blobClone instanceof Blob);
+  assert.notStrictEqual(blobClone, blob);
+  assert.strictEqual(blobClone.size, 5);
+  assert.strictEqual(blobClone.type, 'text/plain');
+}
+
+// Values that cannot be cloned
+assert.throws(() => structuredClone(() => {}));
+assert.throws(() => structuredClone(Symbol('s')));
+assert.throws(() => structuredClone(new WeakMap()));
+assert.throws(() => structuredClone(Promise.resolve()));
+
+// Transferred buffers move to the clone and are detached
+const moved = new Uint8Array([9, 8, 7]);
+const movedClone = structuredClone(moved, { transfer: [moved.buffer] });
+assert.deepStrictEqual(Array.from(movedClone), [9, 8, 7]);
+assert.strictEqual(moved.buffer.byteLength, 0);
+assert.throws(() => structuredClone(moved.buffer));
+const twice = new ArrayBuffer(4);
+assert.throws(() => structuredClone(twice, { transfer: [twice, twice] }));
+assert.strictEqual(twice.byteLength, 4);
+assert.throws(() => structuredClone(1, { transfer: [{}] }));
+
+// The allocUnsafe() slab is shared by many Buffers, so it is never detached
+const { Buffer: NodeBuffer } = require('node:buffer');
+const pooled = NodeBuffer.from('pooled');
+const neighbour = NodeBuffer.from('neighbour');
+assert.strictEqual(pooled.buffer, neighbour.buffer);
+assert.throws(
+  () => structuredClone(pooled, { transfer: [pooled.buffer] }),
+  (err) => err.name === 'DataCloneError'
+);
+assert.strictEqual(neighbour.toString(), 'neighbour');
+
+// A large tree with shared nodes clones in linear time
+const nodes = [];
+for (let i = 0; i < 100000; i++) {
+  const node = { id: i, children: [] };
+  if (i > 0) {
+    nodes[(i - 1) >> 1].children.push(node);
+  }
+  nodes.push(node);
+}
+const state = { root: nodes[0], last: nodes[nodes.length - 1] };
+const start = Date.now();
+const stateClone = structuredClone(state);
+const elapsed = Date.now() - start;
+console.log(`Cloned ${nodes.length} nodes in ${elapsed}ms`);
+let node = stateClone.root;
+while (node.children.length > 0) {
+  node = node.children[node.children.length - 1];
+}
+assert.strictEqual(node.id, 65534);
+assert.strictEqual(stateClone.last.id, 99999);
+assert.notStrictEqual(stateClone.last, nodes[99999]);
+
+console.log('✓ structuredClone type tests passed');
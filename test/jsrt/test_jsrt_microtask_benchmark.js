@@ -0,0 +1,74 @@
+// Promise-chain and async/await throughput, plus the ordering guarantees of
+// draining every microtask before the event loop polls again
+const assert = require('jsrt:assert');
+
+console.log('Microtask Benchmark\n');
+console.log('='.repeat(50));
+
+const ITERATIONS = 100000;
+
+function promiseChain(n) {
+  let p = Promise.resolve(0);
+  for (let i = 0; i < n; i++) {
+    p = p.then((v) => v + 1);
+  }
+  return p;
+}
+
+async function awaitLoop(n) {
+  let total = 0;
+  for (let i = 0; i < n; i++) {
+    total += await i;
+  }
+  return total;
+}
+
+async function run() {
+  // A whole chain settles before a timer that was due all along
+  let timerFired = false;
+  setTimeout(() => {
+    timerFired = true;
+  }, 0);
+  const chained = await promiseChain(10000);
+  assert.strictEqual(chained, 10000);
+  assert.strictEqual(timerFired, false, 'timer ran between microtasks');
+
+  // Reactions queued by one timer callback run before the next timer
+  const order = [];
+  await new Promise((resolve) => {
+    setTimeout(() => {
+      order.push('timeout 1');
+      Promise.resolve().then(() => order.push('microtask 1'));
+    }, 1);
+    setTimeout(() => {
+      order.push('timeout 2');
+      resolve();
+    }, 1);
+  });
+  assert.deepStrictEqual(order, ['timeout 1', 'microtask 1', 'timeout 2']);
+
+  let start = Date.now();
+  assert.strictEqual(await promiseChain(ITERATIONS), ITERATIONS);
+  const chainMs = Math.max(Date.now() - start, 1);
+
+  start = Date.now();
+  const expected = (ITERATIONS * (ITERATIONS - 1)) / 2;
+  assert.strictEqual(await awaitLoop(ITERATIONS), expected);
+  const awaitMs = Math.max(Date.now() - start, 1);
+
+  console.log(
+    `promise chain: ${ITERATIONS} reactions in ${chainMs}ms ` +
+      `(${Math.round(ITERATIONS / chainMs)}/ms)`
+  );
+  console.log(
+    `async/await:   ${ITERATIONS} awaits in ${awaitMs}ms ` +
+      `(${Math.round(ITERATIONS / awaitMs)}/ms)`
+  );
+  console.log('='.repeat(50));
+  console.log('✓ microtask benchmark passed');
+}
+
+run().catch((e) => {
+  console.error(e);
+  process.exit(1);
+});
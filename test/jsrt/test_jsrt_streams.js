@@ -55,3 +55,27 @@ console.log('  3. Reading twice on errored stream properly rejects');
 console.log('  4. Pending reads reject when reader is released');
 console.log('');
 // console.log('🎉 Run "make wpt N=streams" to verify WPT compliance!');
+
+// Chunks keep their type and pending reads resolve in order
+(async () => {
+  let controller;
+  const stream = new ReadableStream({
+    start(c) {
+      controller = c;
+    },
+  });
+  const chunkReader = stream.getReader();
+  const first = chunkReader.read();
+  const second = chunkReader.read();
+  const bytes = new Uint8Array([1, 2, 3]);
+  controller.enqueue(bytes);
+  controller.enqueue({ n: 2 });
+  controller.close();
+
+  assert.strictEqual((await first).value, bytes, 'chunk identity preserved');
+  assert.deepStrictEqual((await second).value, { n: 2 });
+  assert.strictEqual((await chunkReader.read()).done, true);
+})().catch((err) => {
+  console.error(err);
+  require('node:process').exit(1);
+});
@@ -0,0 +1,100 @@
+// Timer list behaviour (ordering, refresh, ref/unref) and the cost of
+// creating and cancelling large numbers of timers
+const assert = require('jsrt:assert');
+const process = require('node:process');
+
+console.log('Timer Benchmark\n');
+console.log('='.repeat(50));
+
+function measure(label, count, fn) {
+  const start = Date.now();
+  fn();
+  const elapsed = Math.max(Date.now() - start, 1);
+  console.log(
+    `${label}: ${count} in ${elapsed}ms (${Math.round(count / elapsed)}/ms)`
+  );
+}
+
+// Test 1: timers of the same duration fire in creation order, shorter
+// durations first, and a cleared timer never fires
+const fired = [];
+for (let i = 0; i < 5; i++) {
+  setTimeout(() => fired.push(`30ms #${i}`), 30);
+}
+setTimeout(() => fired.push('10ms'), 10);
+const cancelled = setTimeout(() => fired.push('cancelled'), 30);
+clearTimeout(cancelled);
+
+// Test 2: refresh() restarts the countdown, also after a timeout fired
+let refreshedAt = 0;
+const start = Date.now();
+const refreshed = setTimeout(() => {
+  refreshedAt = Date.now() - start;
+}, 40);
+setTimeout(() => refreshed.refresh(), 25);
+let rearmed = 0;
+const once = setTimeout(() => {
+  rearmed++;
+  if (rearmed === 1) {
+    once.refresh();
+  }
+}, 5);
+
+// Test 3: ref()/unref()/hasRef(); an unref'ed timer does not keep the
+// process alive, so this test would hang if it did
+const idle = setTimeout(() => {
+  throw new Error('unref timer should not fire');
+}, 60000);
+assert.strictEqual(idle.hasRef(), true);
+assert.strictEqual(idle.unref(), idle);
+assert.strictEqual(idle.hasRef(), false);
+const reffed = setTimeout(() => {}, 1).unref().ref();
+assert.strictEqual(reffed.hasRef(), true);
+
+// Test 4: an interval keeps firing until cleared from its own callback
+let ticks = 0;
+const interval = setInterval(() => {
+  if (++ticks === 3) {
+    clearInterval(interval);
+  }
+}, 5);
+
+setTimeout(() => {
+  assert.deepStrictEqual(fired, [
+    '10ms',
+    '30ms #0',
+    '30ms #1',
+    '30ms #2',
+    '30ms #3',
+    '30ms #4',
+  ]);
+  assert.ok(refreshedAt >= 60, `refreshed timer fired at ${refreshedAt}ms`);
+  assert.strictEqual(rearmed, 2);
+  assert.strictEqual(ticks, 3);
+
+  // Test 5: creating, refreshing and cancelling many idle-connection
+  // timeouts. ctest runs 100k, enough to exercise the timer list within
+  // its timeout; JSRT_BENCHMARK=1 runs the full million-timer benchmark
+  const COUNT = process.env.JSRT_BENCHMARK === '1' ? 1000000 : 100000;
+  const timers = new Array(COUNT);
+  measure('setTimeout', COUNT, () => {
+    for (let i = 0; i < COUNT; i++) {
+      timers[i] = setTimeout(() => {
+        throw new Error('cancelled timer fired');
+      }, 30000 + (i % 16) * 1000);
+    }
+  });
+  measure('refresh', COUNT, () => {
+    for (let i = 0; i < COUNT; i++) {
+      timers[i].refresh();
+    }
+  });
+  measure('clearTimeout', COUNT, () => {
+    for (let i = 0; i < COUNT; i++) {
+      clearTimeout(timers[i]);
+    }
+  });
+  timers.length = 0;
+  console.log('='.repeat(50));
+  console.log('✓ timer benchmark passed');
+}, 100);
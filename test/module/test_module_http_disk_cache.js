@@ -0,0 +1,111 @@
+// Test the persistent HTTP module cache against a local server: warm runs
+// skip the download, stale copies are revalidated with If-None-Match and
+// If-Modified-Since, and a corrupted copy is downloaded again
+const assert = require('jsrt:assert');
+const http = require('node:http');
+const fs = require('node:fs');
+const os = require('node:os');
+const path = require('node:path');
+const { execFile } = require('node:child_process');
+
+const dir = fs.mkdtempSync(path.join(os.tmpdir(), 'jsrt-http-cache-'));
+const cacheDir = path.join(dir, 'cache');
+const script = path.join(dir, 'main.mjs');
+const lastModified = 'Wed, 01 Oct 2025 00:00:00 GMT';
+
+let version = 1;
+const requests = [];
+const server = http.createServer((req, res) => {
+  requests.push({
+    ifNoneMatch: req.headers['if-none-match'],
+    ifModifiedSince: req.headers['if-modified-since'],
+  });
+  const etag = `"v${version}"`;
+  if (req.headers['if-none-match'] === etag) {
+    res.writeHead(304, { ETag: etag, Connection: 'close' });
+    res.end();
+    return;
+  }
+  res.writeHead(200, {
+    'Content-Type': 'application/javascript',
+    ETag: etag,
+    'Last-Modified': lastModified,
+    Connection: 'close',
+  });
+  res.end(`export const version = ${version};\n`);
+});
+
+// Runs main.mjs in a fresh process and resolves with what it printed
+function run(ttl) {
+  const env = Object.assign({}, process.env, {
+    JSRT_HTTP_MODULES_ALLOWED: '127.0.0.1',
+    JSRT_HTTP_MODULES_CACHE_DIR: cacheDir,
+    JSRT_HTTP_MODULES_CACHE_TTL: String(ttl),
+  });
+  return new Promise((resolve, reject) => {
+    execFile(process.execPath, [script], { env }, (error, stdout) => {
+      if (error) {
+        reject(error);
+      } else {
+        resolve(stdout.trim());
+      }
+    });
+  });
+}
+
+async function main() {
+  const { port } = server.address();
+  fs.writeFileSync(
+    script,
+    `import { version } from 'http://127.0.0.1:${port}/mod.js';\n` +
+      'console.log(version);\n'
+  );
+
+  // Test 1: a cold start downloads the module and fills the cache
+  assert.strictEqual(await run(3600), '1');
+  assert.strictEqual(requests.length, 1);
+  assert.strictEqual(requests[0].ifNoneMatch, undefined);
+  assert.strictEqual(fs.readdirSync(path.join(cacheDir, 'content')).length, 1);
+
+  // Test 2: a warm start uses the cached source and bytecode, no request
+  assert.strictEqual(await run(3600), '1');
+  assert.strictEqual(requests.length, 1);
+  assert.strictEqual(fs.readdirSync(path.join(cacheDir, 'code')).length, 1);
+
+  // Test 3: a stale copy is revalidated and kept on 304 Not Modified
+  assert.strictEqual(await run(0), '1');
+  assert.strictEqual(requests.length, 2);
+  assert.strictEqual(requests[1].ifNoneMatch, '"v1"');
+  assert.strictEqual(requests[1].ifModifiedSince, lastModified);
+
+  // Test 4: a changed module replaces the cached copy
+  version = 2;
+  assert.strictEqual(await run(0), '2');
+  assert.strictEqual(requests.length, 3);
+  assert.strictEqual(requests[2].ifNoneMatch, '"v1"');
+  assert.strictEqual(await run(3600), '2');
+  assert.strictEqual(requests.length, 3);
+
+  // Test 5: sources failing their integrity check are downloaded again
+  const contentDir = path.join(cacheDir, 'content');
+  for (const name of fs.readdirSync(contentDir)) {
+    fs.writeFileSync(path.join(contentDir, name), 'export const version = 0;');
+  }
+  assert.strictEqual(await run(3600), '2');
+  assert.strictEqual(requests.length, 4);
+  assert.strictEqual(requests[3].ifNoneMatch, undefined);
+
+  console.log('✓ HTTP module disk cache tests passed');
+}
+
+server.listen(0, '127.0.0.1', () => {
+  main()
+    .finally(() => {
+      server.close();
+      fs.rmSync(dir, { recursive: true, force: true });
+    })
+    .catch((error) => {
+      console.error(error);
+      process.exitCode = 1;
+    });
+});
@@ -0,0 +1,127 @@
+// Test that the static import graph of an HTTP module is prefetched: the
+// modules are downloaded concurrently over a few keep-alive connections, each
+// once, and relative, root-relative and absolute specifiers all resolve
+const assert = require('jsrt:assert');
+const http = require('node:http');
+const fs = require('node:fs');
+const os = require('node:os');
+const path = require('node:path');
+const { execFile } = require('node:child_process');
+
+const dir = fs.mkdtempSync(path.join(os.tmpdir(), 'jsrt-http-prefetch-'));
+const script = path.join(dir, 'main.mjs');
+const MODULES = 31;
+const DELAY_MS = 30;
+
+let port;
+let requests = {};
+let connections = 0;
+let inFlight = 0;
+let maxInFlight = 0;
+
+// Module i imports modules 2i+1 and 2i+2 plus a shared one, so the graph is
+// a binary tree with a diamond; its root exports the sum of all indexes
+function moduleSource(i) {
+  const lines = ["import { shared } from '/shared.js';"];
+  const names = ['shared'];
+  for (const child of [2 * i + 1, 2 * i + 2]) {
+    if (child >= MODULES) {
+      continue;
+    }
+    const specifiers = [
+      `./${child}.js`,
+      `../m/${child}.js`,
+      `/m/${child}.js`,
+      `http://127.0.0.1:${port}/m/${child}.js`,
+    ];
+    const specifier = specifiers[child % specifiers.length];
+    lines.push(`import { value as m${child} } from '${specifier}';`);
+    names.push(`m${child}`);
+  }
+  lines.push(`export const value = ${i} + ${names.join(' + ')};`);
+  return lines.join('\n') + '\n';
+}
+
+const server = http.createServer((req, res) => {
+  requests[req.url] = (requests[req.url] || 0) + 1;
+  inFlight++;
+  maxInFlight = Math.max(maxInFlight, inFlight);
+  setTimeout(() => {
+    inFlight--;
+    const match = /^\/m\/(\d+)\.js$/.exec(req.url);
+    let body;
+    if (req.url === '/shared.js') {
+      body = 'export const shared = 0;\n';
+    } else if (match && Number(match[1]) < MODULES) {
+      body = moduleSource(Number(match[1]));
+    } else {
+      res.writeHead(404);
+      res.end();
+      return;
+    }
+    res.writeHead(200, { 'Content-Type': 'application/javascript' });
+    res.end(body);
+  }, DELAY_MS);
+});
+server.on('connection', () => connections++);
+
+// Runs main.mjs in a fresh process and resolves with what it printed
+function run(prefetch) {
+  requests = {};
+  connections = 0;
+  maxInFlight = 0;
+  const env = Object.assign({}, process.env, {
+    JSRT_HTTP_MODULES_ALLOWED: '127.0.0.1',
+    JSRT_HTTP_MODULES_CACHE_DIR: '',
+    JSRT_HTTP_MODULES_PREFETCH: prefetch ? '1' : '0',
+  });
+  return new Promise((resolve, reject) => {
+    execFile(process.execPath, [script], { env }, (error, stdout) => {
+      if (error) {
+        reject(error);
+      } else {
+        resolve(stdout.trim());
+      }
+    });
+  });
+}
+
+async function main() {
+  port = server.address().port;
+  fs.writeFileSync(
+    script,
+    `import { value } from 'http://127.0.0.1:${port}/m/0.js';\n` +
+      'console.log(value);\n'
+  );
+  const expected = String((MODULES * (MODULES - 1)) / 2);
+
+  // Test 1: the graph is downloaded concurrently, every module exactly once
+  assert.strictEqual(await run(true), expected);
+  assert.strictEqual(Object.keys(requests).length, MODULES + 1);
+  for (const [url, count] of Object.entries(requests)) {
+    assert.strictEqual(count, 1, `${url} requested ${count} times`);
+  }
+  assert.ok(maxInFlight > 1, `only ${maxInFlight} request(s) at a time`);
+
+  // Test 2: downloads share keep-alive connections
+  assert.ok(connections < MODULES, `${connections} connections`);
+
+  // Test 3: with prefetching disabled, modules arrive one at a time
+  assert.strictEqual(await run(false), expected);
+  assert.strictEqual(Object.keys(requests).length, MODULES + 1);
+  assert.strictEqual(maxInFlight, 1);
+
+  console.log('✓ HTTP module graph prefetch tests passed');
+}
+
+server.listen(0, '127.0.0.1', () => {
+  main()
+    .finally(() => {
+      server.close();
+      fs.rmSync(dir, { recursive: true, force: true });
+    })
+    .catch((error) => {
+      console.error(error);
+      process.exitCode = 1;
+    });
+});
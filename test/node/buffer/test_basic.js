@@ -119,6 +119,15 @@ try {
     'hello w',
     'Buffer.concat should truncate correctly'
   );
+
+  // Test Buffer.from(arrayBuffer, byteOffset, length) shares memory
+  const backing = new Uint8Array([10, 20, 30, 40, 50]).buffer;
+  const view = Buffer.from(backing, 1, 3);
+  assert.strictEqual(view.length, 3, 'view should cover the given length');
+  assert.strictEqual(view.byteOffset, 1, 'view should start at byteOffset');
+  assert.strictEqual(view[0], 20, 'view should read from the offset');
+  new Uint8Array(backing)[1] = 99;
+  assert.strictEqual(view[0], 99, 'view should share the ArrayBuffer');
 } catch (error) {
   console.error('❌ Buffer test failed:', error.message);
   console.error(error.stack);
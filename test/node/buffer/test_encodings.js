@@ -0,0 +1,169 @@
+// Test Buffer prototype methods, the allocUnsafe pool and native encodings
+const assert = require('jsrt:assert');
+const { Buffer } = require('node:buffer');
+
+// Methods live on a shared prototype that inherits from Uint8Array
+const a = Buffer.from('abc');
+const b = Buffer.alloc(4);
+assert.ok(a instanceof Buffer, 'instances are Buffers');
+assert.ok(a instanceof Uint8Array, 'Buffers are Uint8Arrays');
+assert.strictEqual(Object.getPrototypeOf(a), Buffer.prototype);
+assert.strictEqual(a.toString, b.toString, 'toString is shared');
+assert.ok(!Object.keys(a).includes('toString'), 'no per-instance methods');
+assert.strictEqual(require('node:buffer').Buffer, Buffer, 'one constructor');
+assert.strictEqual(globalThis.Buffer, Buffer, 'global Buffer is the same');
+
+// Small allocations are sliced from one 8 KiB pool
+assert.strictEqual(Buffer.poolSize, 8192);
+const p1 = Buffer.allocUnsafe(10);
+const p2 = Buffer.allocUnsafe(10);
+assert.strictEqual(p1.buffer, p2.buffer, 'small buffers share a slab');
+assert.strictEqual(p1.buffer.byteLength, 8192);
+assert.strictEqual(p2.byteOffset % 8, 0, 'pool offsets are aligned');
+assert.ok(p2.byteOffset >= p1.byteOffset + 10, 'slices do not overlap');
+assert.notStrictEqual(Buffer.allocUnsafe(5000).buffer, p1.buffer);
+assert.notStrictEqual(Buffer.allocUnsafeSlow(10).buffer, p1.buffer);
+assert.strictEqual(Buffer.alloc(10).byteOffset, 0, 'alloc() is not pooled');
+assert.deepStrictEqual([...Buffer.alloc(3)], [0, 0, 0]);
+
+// Encodings
+const bytes = Buffer.from([0x00, 0x7f, 0x80, 0xff, 0x41]);
+assert.strictEqual(bytes.toString('hex'), '007f80ff41');
+assert.strictEqual(bytes.toString('base64'), 'AH+A/0E=');
+assert.strictEqual(bytes.toString('base64url'), 'AH-A_0E');
+assert.strictEqual(bytes.toString('latin1'), '\x00\x7f\x80\xff\x41');
+assert.strictEqual(bytes.toString('binary'), '\x00\x7f\x80\xff\x41');
+assert.strictEqual(bytes.toString('ascii'), '\x00\x7f\x00\x7f\x41');
+assert.strictEqual(bytes.toString('hex', 1, 3), '7f80');
+
+assert.deepStrictEqual([...Buffer.from('007F80ff41', 'hex')], [...bytes]);
+assert.deepStrictEqual([...Buffer.from('AH+A/0E=', 'base64')], [...bytes]);
+assert.deepStrictEqual([...Buffer.from('AH-A_0E', 'base64url')], [...bytes]);
+assert.deepStrictEqual([...Buffer.from('AH+A\n/0E', 'base64')], [...bytes]);
+assert.deepStrictEqual([...Buffer.from('\x00\xff', 'latin1')], [0, 255]);
+assert.strictEqual(Buffer.from('abzz12', 'hex').length, 1, 'hex stops early');
+
+const utf16 = Buffer.from('hé\u{1f600}', 'utf16le');
+assert.deepStrictEqual(
+  [...utf16],
+  [0x68, 0x00, 0xe9, 0x00, 0x3d, 0xd8, 0x00, 0xde]
+);
+assert.strictEqual(utf16.toString('ucs2'), 'hé\u{1f600}');
+
+const text = 'héllo 世界 \u{1f600}';
+assert.strictEqual(Buffer.from(text).toString(), text);
+assert.strictEqual(Buffer.from(text).toString('utf-8'), text);
+assert.strictEqual(Buffer.byteLength(text), Buffer.from(text).length);
+assert.strictEqual(Buffer.byteLength('abcd', 'hex'), 2);
+assert.strictEqual(Buffer.byteLength('AH+A/0E=', 'base64'), 5);
+assert.strictEqual(Buffer.byteLength('é', 'latin1'), 1);
+assert.strictEqual(Buffer.byteLength('é', 'utf16le'), 2);
+assert.ok(Buffer.isEncoding('UTF8'));
+assert.ok(!Buffer.isEncoding('nope'));
+assert.throws(() => a.toString('nope'), TypeError);
+
+// write(): offsets, lengths and no partial UTF-8 characters
+const w = Buffer.alloc(6);
+assert.strictEqual(w.write('ab'), 2);
+assert.strictEqual(w.write('ff00', 2, 'hex'), 2);
+assert.deepStrictEqual([...w], [97, 98, 255, 0, 0, 0]);
+assert.strictEqual(w.write('éé', 3), 2, 'only whole characters');
+assert.strictEqual(w.write('xyz', 4, 1), 1);
+assert.strictEqual(w.toString('latin1', 4), 'x\x00');
+
+// equals / compare
+assert.ok(Buffer.from('abc').equals(a));
+assert.ok(!a.equals(Buffer.from('abd')));
+assert.strictEqual(a.compare(Buffer.from('abd')), -1);
+assert.strictEqual(a.compare(Buffer.from('ab')), 1);
+assert.strictEqual(a.compare(Buffer.from('xbc'), 1, 3, 1, 3), 0);
+assert.strictEqual(Buffer.compare(Buffer.from('b'), a), 1);
+assert.deepStrictEqual(
+  [Buffer.from('c'), Buffer.from('a'), Buffer.from('b')]
+    .sort(Buffer.compare)
+    .map((x) => x.toString()),
+  ['a', 'b', 'c']
+);
+
+// indexOf / lastIndexOf / includes
+const hay = Buffer.from('this is a buffer, a buffer');
+assert.strictEqual(hay.indexOf('buffer'), 10);
+assert.strictEqual(hay.indexOf('buffer', 11), 20);
+assert.strictEqual(hay.indexOf(Buffer.from('a b')), 8);
+assert.strictEqual(hay.indexOf(0x61), 8);
+assert.strictEqual(hay.indexOf('buffer', -6), 20);
+assert.strictEqual(hay.indexOf('6275', 'hex'), 10);
+assert.strictEqual(hay.indexOf('missing'), -1);
+assert.strictEqual(hay.lastIndexOf('buffer'), 20);
+assert.strictEqual(hay.lastIndexOf('buffer', 19), 10);
+assert.strictEqual(hay.lastIndexOf('this', 0), 0);
+assert.ok(hay.includes('is a'));
+assert.ok(!hay.includes('is a', 6));
+
+// Integer and float accessors
+const n = Buffer.alloc(16);
+assert.strictEqual(n.writeUInt16BE(0x1234, 0), 2);
+assert.strictEqual(n.writeUInt32LE(0xdeadbeef, 2), 6);
+assert.strictEqual(n.writeInt8(-2, 6), 7);
+assert.strictEqual(n.writeInt16LE(-300, 7), 9);
+assert.strictEqual(n.readUInt16BE(0), 0x1234);
+assert.strictEqual(n.readUInt16LE(0), 0x3412);
+assert.strictEqual(n.readUint32LE(2), 0xdeadbeef);
+assert.strictEqual(n.readUInt32BE(2), 0xefbeadde);
+assert.strictEqual(n.readInt32LE(2), 0xdeadbeef | 0);
+assert.strictEqual(n.readUInt8(6), 254);
+assert.strictEqual(n.readInt8(6), -2);
+assert.strictEqual(n.readInt16LE(7), -300);
+n.writeDoubleBE(Math.PI, 8);
+assert.strictEqual(n.readDoubleBE(8), Math.PI);
+n.writeFloatLE(1.5, 0);
+assert.strictEqual(n.readFloatLE(0), 1.5);
+n.writeBigInt64LE(-5n, 8);
+assert.strictEqual(n.readBigInt64LE(8), -5n);
+assert.strictEqual(n.readBigUInt64LE(8), 2n ** 64n - 5n);
+assert.throws(() => n.readUInt32LE(13), RangeError);
+assert.throws(() => n.writeUInt8(256, 0), RangeError);
+assert.throws(() => n.writeInt16BE(-32769, 0), RangeError);
+
+// slice()/subarray() share memory and stay Buffers
+const parent = Buffer.from('hello world');
+const slice = parent.slice(-5);
+assert.ok(slice instanceof Buffer);
+assert.strictEqual(slice.toString(), 'world');
+slice[0] = 0x57;
+assert.strictEqual(parent.toString(), 'hello World');
+assert.strictEqual(parent.subarray(0, 5).toString(), 'hello');
+assert.ok(parent.map((x) => x) instanceof Buffer, 'species is Buffer');
+
+// fill / copy
+const f = Buffer.alloc(7);
+f.fill('ab');
+assert.strictEqual(f.toString(), 'abababa');
+f.fill(0x7a, 5);
+assert.strictEqual(f.toString(), 'ababazz');
+f.fill('6162', 0, 4, 'hex');
+assert.strictEqual(f.toString(), 'ababazz');
+assert.strictEqual(Buffer.alloc(4, 'YQ==', 'base64').toString(), 'aaaa');
+const target = Buffer.alloc(5, '.');
+assert.strictEqual(Buffer.from('xyz').copy(target, 1), 3);
+assert.strictEqual(target.toString(), '.xyz.');
+assert.strictEqual(Buffer.from('abcdef').copy(target, 3, 4), 2);
+assert.strictEqual(target.toString(), '.xyef');
+
+// from() copies views and round-trips toJSON()
+const source = new Uint8Array([1, 2, 3]);
+const copy = Buffer.from(source);
+source[0] = 9;
+assert.strictEqual(copy[0], 1, 'from(Uint8Array) copies');
+const json = JSON.parse(JSON.stringify(Buffer.from('hi')));
+assert.deepStrictEqual(json, { type: 'Buffer', data: [104, 105] });
+assert.strictEqual(Buffer.from(json).toString(), 'hi');
+assert.deepStrictEqual([...Buffer.from(new Uint16Array([1, 258]))], [1, 2]);
+assert.strictEqual(Buffer(3).length, 3, 'callable without new');
+
+// concat() zero-fills past the inputs when totalLength is larger
+const joined = Buffer.concat([Buffer.from('ab'), new Uint8Array([99])], 5);
+assert.deepStrictEqual([...joined], [97, 98, 99, 0, 0]);
+assert.throws(() => Buffer.concat(['ab']), TypeError);
+
+console.log('✓ Buffer prototype, pool and encodings');
@@ -0,0 +1,25 @@
+// Child process for serialization: 'advanced' IPC testing
+
+if (typeof process !== 'undefined' && process.send) {
+  process.send({ type: 'ready', pid: process.pid });
+
+  process.on('message', (msg, handle) => {
+    if (msg.type === 'echo') {
+      // Values JSON cannot carry go back as they came
+      process.send({ type: 'echo-response', data: msg.data });
+    } else if (msg.type === 'server') {
+      // Answer connections on the listening server the parent sent
+      handle.on('connection', (socket) => socket.end('child'));
+      process.send({ type: 'listening' });
+    } else if (msg.type === 'exit') {
+      process.exit(0);
+    }
+  });
+
+  process.on('disconnect', () => {
+    process.exit(0);
+  });
+} else {
+  console.error('No IPC channel - not running as forked child');
+  process.exit(1);
+}
@@ -0,0 +1,135 @@
+// Test fork() with serialization: 'advanced' and passing a server handle
+const child_process = require('node:child_process');
+const net = require('node:net');
+const path = require('node:path');
+const { Buffer } = require('node:buffer');
+
+let tests_passed = 0;
+let tests_failed = 0;
+
+function assert(condition, message) {
+  if (condition) {
+    tests_passed++;
+    console.log(`✓ ${message}`);
+  } else {
+    tests_failed++;
+    console.error(`✗ ${message}`);
+  }
+}
+
+function test_fork_advanced(callback) {
+  console.log('\nTest: Advanced serialization and server handle passing');
+
+  const child = child_process.fork(
+    path.join(__dirname, 'fixtures', 'advanced_child.js'),
+    { serialization: 'advanced' }
+  );
+
+  let callbackCalled = false;
+  let port = 0;
+
+  function complete() {
+    if (callbackCalled) return;
+    callbackCalled = true;
+    clearTimeout(timer);
+    child.kill();
+    callback();
+  }
+
+  child.on('message', (msg) => {
+    if (msg.type === 'ready') {
+      child.send({
+        type: 'echo',
+        data: {
+          map: new Map([['key', 1]]),
+          buf: Buffer.from('hi'),
+          date: new Date(1700000000000),
+          floats: new Float64Array([1.5, -2.5]),
+          big: 2n ** 64n,
+        },
+      });
+    } else if (msg.type === 'echo-response') {
+      const data = msg.data;
+      assert(data.map instanceof Map, 'Map survives IPC');
+      assert(data.map.get('key') === 1, 'Map entries survive IPC');
+      assert(Buffer.isBuffer(data.buf), 'Buffer survives IPC');
+      assert(data.buf.toString() === 'hi', 'Buffer bytes survive IPC');
+      assert(data.date.getTime() === 1700000000000, 'Date survives IPC');
+      assert(
+        data.floats instanceof Float64Array && data.floats[1] === -2.5,
+        'Float64Array survives IPC'
+      );
+      assert(data.big === 2n ** 64n, 'BigInt survives IPC');
+
+      // Hand a listening server to the child and stop accepting here
+      const server = net.createServer(() => {
+        assert(false, 'Parent server should not accept after send');
+      });
+      server.listen(0, '127.0.0.1', () => {
+        port = server.address().port;
+        child.send({ type: 'server' }, server, (err) => {
+          assert(!err, 'Server handle sent');
+          server.close();
+        });
+      });
+    } else if (msg.type === 'listening') {
+      const socket = net.connect(port, '127.0.0.1');
+      let reply = '';
+      socket.on('data', (chunk) => {
+        reply += chunk.toString();
+      });
+      socket.on('end', () => {
+        assert(reply === 'child', 'Child answered on the passed server');
+        complete();
+      });
+      socket.on('error', (err) => {
+        assert(false, 'Connection error: ' + err.message);
+        complete();
+      });
+    }
+  });
+
+  child.on('error', (err) => {
+    assert(false, 'Child process error: ' + err.message);
+    complete();
+  });
+
+  // Timeout after 5 seconds
+  const timer = setTimeout(() => {
+    assert(false, 'Test timed out');
+    complete();
+  }, 5000);
+}
+
+function test_fork_invalid_serialization() {
+  console.log('\nTest: Unknown serialization is rejected');
+
+  let threw = false;
+  try {
+    child_process.fork(path.join(__dirname, 'fixtures', 'ipc_child.js'), {
+      serialization: 'binary',
+    });
+  } catch (e) {
+    threw = e instanceof TypeError;
+  }
+  assert(threw, 'fork() throws TypeError for unknown serialization');
+}
+
+// Run tests
+try {
+  test_fork_invalid_serialization();
+
+  test_fork_advanced(() => {
+    console.log(`\n=== Test Results ===`);
+    console.log(`Passed: ${tests_passed}`);
+    console.log(`Failed: ${tests_failed}`);
+
+    if (tests_failed > 0) {
+      process.exit(1);
+    }
+  });
+} catch (error) {
+  console.error('Test error:', error.message);
+  console.error(error.stack);
+  process.exit(1);
+}
@@ -407,59 +407,65 @@ try {
   console.log('FAIL: hkdf async:', e.message);
 }
 
-console.log('\n=== Testing Scrypt (Expected: Not Implemented) ===');
+console.log('\n=== Testing Scrypt ===');
 
-// Test 15: Scrypt Sync - should throw not implemented
-try {
-  const password = 'password';
-  const salt = 'salt';
-  const keylen = 32;
+// RFC 7914 test vector: scrypt("password", "NaCl", N=1024, r=8, p=16, dkLen=64)
+const scryptExpected =
+  'fdbabe1c9d3472007856e7190d01e9fe7c6ad7cbc8237830e77376634b373162' +
+  '2eaf30d92e22a3886ff109279d9830dac727afb94a83ee6d8360cbdfa2cc0640';
 
-  try {
-    const key = crypto.scryptSync(password, salt, keylen);
-    testsFailed++;
-    console.log('FAIL: scryptSync should throw not implemented error');
-  } catch (e) {
-    if (e.message && e.message.includes('not yet implemented')) {
-      testsPassed++;
-      console.log('PASS: scryptSync throws not implemented error');
-    } else {
-      testsFailed++;
-      console.log('FAIL: scryptSync throws wrong error:', e.message);
-    }
-  }
+function toHex(bytes) {
+  return Array.from(bytes)
+    .map((b) => b.toString(16).padStart(2, '0'))
+    .join('');
+}
+
+// Test 15: Scrypt Sync - RFC 7914 test vector
+try {
+  const key = crypto.scryptSync('password', 'NaCl', 64, {
+    N: 1024,
+    r: 8,
+    p: 16,
+  });
+  assert(key instanceof Uint8Array, 'scryptSync returns Uint8Array');
+  assertEquals(toHex(key), scryptExpected, 'scryptSync RFC 7914 test vector');
+  console.log('PASS: scryptSync RFC 7914 test vector');
 } catch (e) {
   testsFailed++;
-  console.log('FAIL: scryptSync test error:', e.message);
+  console.log('FAIL: scryptSync:', e.message);
 }
 
-// Test 16: Scrypt Async - should call callback with error
+// Test 16: Scrypt Async - callback version with Node.js option aliases
 try {
-  const password = 'password';
-  const salt = 'salt';
-  const keylen = 32;
-
   let callbackCalled = false;
-  crypto.scrypt(password, salt, keylen, {}, (err, key) => {
-    callbackCalled = true;
-    if (err && err.message && err.message.includes('not yet implemented')) {
-      testsPassed++;
-      console.log('PASS: scrypt async callback receives not implemented error');
-    } else if (!err) {
-      testsFailed++;
-      console.log('FAIL: scrypt async should return error');
-    } else {
-      testsFailed++;
-      console.log('FAIL: scrypt async wrong error:', err.message);
+  crypto.scrypt(
+    'password',
+    'NaCl',
+    64,
+    { cost: 1024, blockSize: 8, parallelization: 16 },
+    (err, key) => {
+      callbackCalled = true;
+      if (err) {
+        testsFailed++;
+        console.log('FAIL: scrypt async callback received error:', err.message);
+      } else {
+        assertEquals(
+          toHex(key),
+          scryptExpected,
+          'scrypt async RFC 7914 test vector'
+        );
+        console.log('PASS: scrypt async with callback');
+      }
     }
-  });
+  );
+  assert(!callbackCalled, 'scrypt callback is not invoked synchronously');
 
   setTimeout(() => {
     if (!callbackCalled) {
       testsFailed++;
       console.log('FAIL: scrypt async callback was never called');
     }
-  }, 100);
+  }, 400);
 } catch (e) {
   testsFailed++;
   console.log('FAIL: scrypt async test error:', e.message);
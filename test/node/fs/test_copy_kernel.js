@@ -0,0 +1,158 @@
+// Test fs.copyFile()/fs.cp() on top of uv_fs_copyfile()
+const assert = require('jsrt:assert');
+const fs = require('node:fs');
+const path = require('node:path');
+const process = require('node:process');
+
+const tests = [];
+let testsPassed = 0;
+let testsFailed = 0;
+
+function test(name, fn) {
+  tests.push({ name, fn });
+}
+
+const base = `/tmp/jsrt_test_copy_kernel_${Date.now()}`;
+fs.mkdirSync(base, { recursive: true });
+
+function makeTree(root) {
+  fs.mkdirSync(`${root}/a/b`, { recursive: true });
+  fs.writeFileSync(`${root}/top.txt`, 'top');
+  fs.writeFileSync(`${root}/a/mid.txt`, 'mid');
+  fs.writeFileSync(`${root}/a/b/deep.bin`, new Uint8Array(300 * 1024).fill(7));
+  fs.chmodSync(`${root}/top.txt`, 0o751);
+  fs.symlinkSync('top.txt', `${root}/link`);
+}
+
+function checkTree(root) {
+  assert.strictEqual(fs.readFileSync(`${root}/top.txt`, 'utf8'), 'top');
+  assert.strictEqual(fs.readFileSync(`${root}/a/mid.txt`, 'utf8'), 'mid');
+  const deep = fs.readFileSync(`${root}/a/b/deep.bin`);
+  assert.strictEqual(deep.length, 300 * 1024);
+  assert.strictEqual(deep[deep.length - 1], 7);
+  assert.strictEqual(fs.statSync(`${root}/top.txt`).mode & 0o777, 0o751);
+  assert.strictEqual(fs.readlinkSync(`${root}/link`), 'top.txt');
+}
+
+// Test 1: copy modes are exported like Node's
+test('fs.constants exposes COPYFILE_* modes', () => {
+  assert.strictEqual(fs.constants.COPYFILE_EXCL, 1);
+  assert.strictEqual(fs.constants.COPYFILE_FICLONE, 2);
+  assert.strictEqual(fs.constants.COPYFILE_FICLONE_FORCE, 4);
+});
+
+// Test 2: COPYFILE_EXCL refuses to overwrite
+test('copyFileSync honours COPYFILE_EXCL', () => {
+  fs.writeFileSync(`${base}/src.txt`, 'source');
+  fs.writeFileSync(`${base}/dst.txt`, 'existing');
+  assert.throws(
+    () =>
+      fs.copyFileSync(
+        `${base}/src.txt`,
+        `${base}/dst.txt`,
+        fs.constants.COPYFILE_EXCL
+      ),
+    (err) => err.code === 'EEXIST'
+  );
+  fs.copyFileSync(`${base}/src.txt`, `${base}/dst.txt`);
+  assert.strictEqual(fs.readFileSync(`${base}/dst.txt`, 'utf8'), 'source');
+});
+
+// Test 3: the callback form accepts a mode
+test('copyFile with FICLONE falls back to a plain copy', async () => {
+  await new Promise((resolve, reject) => {
+    fs.copyFile(
+      `${base}/src.txt`,
+      `${base}/clone.txt`,
+      fs.constants.COPYFILE_FICLONE,
+      (err) => (err ? reject(err) : resolve())
+    );
+  });
+  assert.strictEqual(fs.readFileSync(`${base}/clone.txt`, 'utf8'), 'source');
+});
+
+// Test 4: fs.cp() copies a whole tree including symlinks and modes
+test('fs.cp copies a directory tree', async () => {
+  makeTree(`${base}/tree`);
+  await new Promise((resolve, reject) => {
+    fs.cp(`${base}/tree`, `${base}/tree_cb`, { recursive: true }, (err) =>
+      err ? reject(err) : resolve()
+    );
+  });
+  checkTree(`${base}/tree_cb`);
+});
+
+// Test 5: the promise form shares the same implementation
+test('fs.promises.cp copies a directory tree', async () => {
+  await fs.promises.cp(`${base}/tree`, `${base}/tree_p`, { recursive: true });
+  checkTree(`${base}/tree_p`);
+});
+
+// Test 6: directories need recursive, and cannot be copied into themselves
+async function cpError(src, dest, options) {
+  try {
+    await fs.promises.cp(src, dest, options);
+  } catch (err) {
+    return err.code;
+  }
+  return 'no error';
+}
+
+test('fs.cp rejects invalid directory copies', async () => {
+  const tree = `${base}/tree`;
+  assert.strictEqual(await cpError(tree, `${base}/tree_nr`), 'EISDIR');
+  const inner = `${tree}/a/inner`;
+  const code = await cpError(tree, inner, { recursive: true });
+  assert.strictEqual(code, 'EINVAL');
+  assert.strictEqual(fs.existsSync(inner), false);
+});
+
+// Test 7: paths are resolved before the check, and errors are never
+// reported before fs.cp() returns
+test('fs.cp resolves paths and reports errors asynchronously', async () => {
+  const tree = `${base}/tree`;
+  const relative = path.relative(process.cwd(), tree);
+  const inner = `./${relative}/a/../a/inner`;
+  const options = { recursive: true };
+  assert.strictEqual(await cpError(relative, inner, options), 'EINVAL');
+  assert.strictEqual(fs.existsSync(`${tree}/a/inner`), false);
+
+  let returned = false;
+  const code = await new Promise((resolve) => {
+    fs.cp(tree, `${tree}/inner`, { recursive: true }, (err) => {
+      assert.ok(returned, 'callback ran before fs.cp() returned');
+      resolve(err && err.code);
+    });
+    returned = true;
+  });
+  assert.strictEqual(code, 'EINVAL');
+});
+
+(async () => {
+  for (const { name, fn } of tests) {
+    try {
+      await fn();
+      testsPassed++;
+      console.log(`✓ ${name}`);
+    } catch (err) {
+      testsFailed++;
+      console.log(`FAIL: ${name}`);
+      if (err && err.stack) {
+        console.log(`  ${err.stack}`);
+      } else {
+        console.log(`  ${err}`);
+      }
+    }
+  }
+
+  try {
+    fs.rmSync(base, { recursive: true, force: true });
+  } catch (e) {
+    // Ignore cleanup errors
+  }
+
+  console.log(`\nTest Results: ${testsPassed} passed, ${testsFailed} failed`);
+  if (testsFailed > 0) {
+    process.exit(1);
+  }
+})();
@@ -0,0 +1,163 @@
+// Test http.Agent keep-alive pooling against a raw keep-alive server
+const assert = require('jsrt:assert');
+const http = require('node:http');
+const net = require('node:net');
+const process = require('node:process');
+
+const tests = [];
+let testsPassed = 0;
+let testsFailed = 0;
+
+function test(name, fn) {
+  tests.push({ name, fn });
+}
+
+// Minimal HTTP/1.1 server that keeps connections open and counts them
+function withKeepAliveServer(onListening) {
+  return new Promise((resolve, reject) => {
+    const sockets = [];
+    let connections = 0;
+    const server = net.createServer((socket) => {
+      connections++;
+      sockets.push(socket);
+      let pending = '';
+      socket.on('data', (chunk) => {
+        pending += chunk.toString();
+        let end;
+        while ((end = pending.indexOf('\r\n\r\n')) !== -1) {
+          pending = pending.slice(end + 4);
+          socket.write(
+            'HTTP/1.1 200 OK\r\n' +
+              'Content-Length: 2\r\n' +
+              'Connection: keep-alive\r\n\r\nok'
+          );
+        }
+      });
+      socket.on('error', () => {});
+    });
+    const timer = setTimeout(() => finish(new Error('Test timeout')), 3000);
+
+    function finish(err) {
+      clearTimeout(timer);
+      sockets.forEach((socket) => socket.destroy());
+      server.close();
+      err ? reject(err) : resolve();
+    }
+
+    server.listen(0, '127.0.0.1', () => {
+      const port = server.address().port;
+      onListening(port, () => connections, finish);
+    });
+  });
+}
+
+function get(port, agent) {
+  return new Promise((resolve, reject) => {
+    const options = { host: '127.0.0.1', port, path: '/', agent };
+    const req = http.get(options, (res) => {
+      let body = '';
+      res.on('data', (chunk) => (body += chunk));
+      res.on('end', () => resolve(body));
+    });
+    req.on('error', reject);
+  });
+}
+
+// Test 1: sequential requests share one connection
+test('keepAlive agent reuses one connection', () => {
+  return withKeepAliveServer(async (port, connections, done) => {
+    const agent = new http.Agent({ keepAlive: true });
+    try {
+      for (let i = 0; i < 3; i++) {
+        assert.strictEqual(await get(port, agent), 'ok');
+      }
+      const stats = agent.getStats();
+      assert.strictEqual(connections(), 1, 'one TCP connection');
+      assert.strictEqual(stats.created, 1);
+      assert.strictEqual(stats.reused, 2);
+      assert.strictEqual(stats.idle, 1);
+      agent.destroy();
+      done();
+    } catch (err) {
+      agent.destroy();
+      done(err);
+    }
+  });
+});
+
+// Test 2: maxSockets queues requests instead of opening more connections
+test('maxSockets queues requests on the same origin', () => {
+  return withKeepAliveServer(async (port, connections, done) => {
+    const agent = new http.Agent({ keepAlive: true, maxSockets: 1 });
+    try {
+      const bodies = await Promise.all([
+        get(port, agent),
+        get(port, agent),
+        get(port, agent),
+      ]);
+      assert.deepStrictEqual(bodies, ['ok', 'ok', 'ok']);
+      assert.strictEqual(connections(), 1, 'requests waited for the socket');
+      assert.strictEqual(agent.getStats().waiting, 0);
+      agent.destroy();
+      done();
+    } catch (err) {
+      agent.destroy();
+      done(err);
+    }
+  });
+});
+
+// Test 3: agent: false opens a fresh connection per request
+test('agent: false does not pool connections', () => {
+  return withKeepAliveServer(async (port, connections, done) => {
+    try {
+      await get(port, false);
+      await get(port, false);
+      assert.strictEqual(connections(), 2);
+      done();
+    } catch (err) {
+      done(err);
+    }
+  });
+});
+
+// Test 4: agents without keepAlive close sockets after each response
+test('agent without keepAlive closes connections', () => {
+  return withKeepAliveServer(async (port, connections, done) => {
+    const agent = new http.Agent();
+    try {
+      await get(port, agent);
+      await get(port, agent);
+      const stats = agent.getStats();
+      assert.strictEqual(connections(), 2);
+      assert.strictEqual(stats.reused, 0);
+      assert.strictEqual(stats.idle, 0);
+      done();
+    } catch (err) {
+      done(err);
+    }
+  });
+});
+
+(async () => {
+  for (const { name, fn } of tests) {
+    try {
+      await fn();
+      testsPassed++;
+      console.log(`✓ ${name}`);
+    } catch (err) {
+      testsFailed++;
+      console.log(`FAIL: ${name}`);
+      if (err && err.stack) {
+        console.log(`  ${err.stack}`);
+      } else {
+        console.log(`  ${err}`);
+      }
+    }
+  }
+
+  console.log(`\nTest Results: ${testsPassed} passed, ${testsFailed} failed`);
+  if (testsFailed > 0) {
+    process.exit(1);
+  }
+})();
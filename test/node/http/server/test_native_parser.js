@@ -0,0 +1,192 @@
+// Test the native HTTP server parser: requests parsed straight from socket
+// reads, headers kept in C and converted to JS only when read
+const assert = require('jsrt:assert');
+const http = require('node:http');
+const net = require('node:net');
+const process = require('node:process');
+
+const tests = [];
+let testsPassed = 0;
+let testsFailed = 0;
+
+function test(name, fn) {
+  tests.push({ name, fn });
+}
+
+// Start a server, send `chunks` over a raw connection (pausing between them)
+// and resolve with everything the server wrote back before closing it
+function exchange(handler, chunks) {
+  return new Promise((resolve, reject) => {
+    const server = http.createServer(handler);
+    const timer = setTimeout(() => finish(new Error('Test timeout')), 3000);
+    let response = '';
+    let client = null;
+
+    function finish(err) {
+      clearTimeout(timer);
+      if (client) {
+        client.destroy();
+      }
+      server.close();
+      if (err) {
+        reject(err);
+      } else {
+        resolve({ server, response });
+      }
+    }
+
+    server.on('clientError', (err) => finish(err));
+    server.listen(0, '127.0.0.1', () => {
+      client = net.connect(server.address().port, '127.0.0.1');
+      client.on('error', finish);
+      client.on('data', (data) => (response += data.toString()));
+      client.on('end', () => finish());
+      client.on('connect', () => {
+        let i = 0;
+        const sendNext = () => {
+          client.write(chunks[i++]);
+          if (i < chunks.length) {
+            setTimeout(sendNext, 20);
+          }
+        };
+        sendNext();
+      });
+    });
+  });
+}
+
+// Test 1: headers/rawHeaders built on first access
+test('headers and rawHeaders are built lazily', async () => {
+  let seen = null;
+  await exchange(
+    (req, res) => {
+      seen = {
+        raw: req.rawHeaders,
+        headers: req.headers,
+        again: req.headers === req.headers,
+        keys: Object.keys(req).includes('headers'),
+      };
+      res.end('ok');
+    },
+    [
+      'GET /a HTTP/1.1\r\nHost: localhost\r\nX-Token: abc\r\n' +
+        'Set-Cookie: a=1\r\nset-cookie: b=2\r\nSET-COOKIE: c=3\r\n' +
+        'X-Empty:\r\n\r\n',
+    ]
+  );
+
+  assert.deepStrictEqual(seen.raw, [
+    'Host',
+    'localhost',
+    'X-Token',
+    'abc',
+    'Set-Cookie',
+    'a=1',
+    'set-cookie',
+    'b=2',
+    'SET-COOKIE',
+    'c=3',
+    'X-Empty',
+    '',
+  ]);
+  assert.strictEqual(seen.headers.host, 'localhost');
+  assert.strictEqual(seen.headers['x-token'], 'abc');
+  assert.deepStrictEqual(seen.headers['set-cookie'], ['a=1', 'b=2', 'c=3']);
+  assert.strictEqual(seen.headers['x-empty'], '');
+  assert.ok(seen.again, 'headers object is cached');
+  assert.ok(seen.keys, 'headers stays enumerable');
+});
+
+// Test 2: header names and values split across socket reads
+test('headers split across reads are joined', async () => {
+  let headers = null;
+  await exchange(
+    (req, res) => {
+      headers = req.headers;
+      res.end('ok');
+    },
+    [
+      'GET / HTTP/1.1\r\nHo',
+      'st: local',
+      'host\r\nX-Lo',
+      'ng: v1',
+      'v2\r\n\r\n',
+    ]
+  );
+  assert.strictEqual(headers.host, 'localhost');
+  assert.strictEqual(headers['x-long'], 'v1v2');
+});
+
+// Test 3: the body is framed by Content-Length, NUL bytes included
+test('request body with NUL bytes', async () => {
+  let received = null;
+  const body = 'a\0b\0c';
+  await exchange(
+    (req, res) => {
+      let data = '';
+      req.on('data', (chunk) => (data += chunk));
+      req.on('end', () => {
+        received = data;
+        res.end('done');
+      });
+    },
+    [
+      `POST /one HTTP/1.1\r\nHost: x\r\nContent-Length: ${body.length}\r\n` +
+        `\r\n${body}`,
+    ]
+  );
+  assert.strictEqual(received.length, body.length);
+  assert.strictEqual(received, body);
+});
+
+// Test 4: headers and rawHeaders stay assignable
+test('headers can be replaced', async () => {
+  let result = null;
+  await exchange(
+    (req, res) => {
+      req.headers = { custom: 'yes' };
+      req.rawHeaders = [];
+      result = [req.headers.custom, req.rawHeaders.length];
+      res.end('ok');
+    },
+    ['GET / HTTP/1.1\r\nHost: x\r\n\r\n']
+  );
+  assert.deepStrictEqual(result, ['yes', 0]);
+});
+
+// Test 5: Connection: close is honoured from the compact header list
+test('Connection: close ends the connection', async () => {
+  let connection = null;
+  const { response } = await exchange(
+    (req, res) => {
+      connection = req.headers.connection;
+      res.end('bye');
+    },
+    ['GET / HTTP/1.1\r\nHost: x\r\nConnection: close\r\n\r\n']
+  );
+  assert.strictEqual(connection, 'close');
+  assert.ok(response.startsWith('HTTP/1.1 200'));
+});
+
+(async () => {
+  for (const { name, fn } of tests) {
+    try {
+      await fn();
+      testsPassed++;
+      console.log(`✓ ${name}`);
+    } catch (err) {
+      testsFailed++;
+      console.log(`FAIL: ${name}`);
+      if (err && err.stack) {
+        console.log(`  ${err.stack}`);
+      } else {
+        console.log(`  ${err}`);
+      }
+    }
+  }
+
+  console.log(`\nTest Results: ${testsPassed} passed, ${testsFailed} failed`);
+  if (testsFailed > 0) {
+    process.exit(1);
+  }
+})();
@@ -0,0 +1,206 @@
+// Test native ServerResponse serialization: header block, chunk framing and
+// body written together, Content-Length for end(body), cached Date header
+const assert = require('jsrt:assert');
+const http = require('node:http');
+const net = require('node:net');
+const process = require('node:process');
+
+const tests = [];
+let testsPassed = 0;
+let testsFailed = 0;
+
+function test(name, fn) {
+  tests.push({ name, fn });
+}
+
+// Run `handler` for one raw request; resolve with the response bytes
+function fetchRaw(handler) {
+  return new Promise((resolve, reject) => {
+    const server = http.createServer(handler);
+    const timer = setTimeout(() => finish(new Error('Test timeout')), 3000);
+    const chunks = [];
+    let client = null;
+
+    function finish(err) {
+      clearTimeout(timer);
+      if (client) {
+        client.destroy();
+      }
+      server.close();
+      if (err) {
+        reject(err);
+      } else {
+        resolve(concat(chunks));
+      }
+    }
+
+    server.listen(0, '127.0.0.1', () => {
+      client = net.connect(server.address().port, '127.0.0.1');
+      client.on('error', finish);
+      client.on('data', (data) => chunks.push(data));
+      client.on('end', () => finish());
+      client.on('connect', () =>
+        client.write('GET / HTTP/1.1\r\nHost: localhost\r\n\r\n')
+      );
+    });
+  });
+}
+
+function concat(parts) {
+  const total = parts.reduce((sum, part) => sum + part.length, 0);
+  const out = new Uint8Array(total);
+  let offset = 0;
+  for (const part of parts) {
+    out.set(part, offset);
+    offset += part.length;
+  }
+  return out;
+}
+
+function latin1(bytes, start = 0) {
+  let text = '';
+  for (let i = start; i < bytes.length; i++) {
+    text += String.fromCharCode(bytes[i]);
+  }
+  return text;
+}
+
+function bytesOf(text) {
+  return Uint8Array.from(text, (ch) => ch.charCodeAt(0));
+}
+
+function split(raw) {
+  const text = latin1(raw);
+  const end = text.indexOf('\r\n\r\n');
+  assert.ok(end > 0, 'response has a header block');
+  const lines = text.slice(0, end).split('\r\n');
+  return { status: lines[0], headers: lines.slice(1), bodyStart: end + 4 };
+}
+
+function header(lines, name) {
+  const prefix = name.toLowerCase() + ':';
+  return lines
+    .filter((line) => line.toLowerCase().startsWith(prefix))
+    .map((line) => line.slice(prefix.length).trim());
+}
+
+// Test 1: end(body) before any write sends Content-Length, not chunks
+test('end(body) sends headers and body with Content-Length', async () => {
+  const raw = await fetchRaw((req, res) => res.end('hello world'));
+  const { status, headers, bodyStart } = split(raw);
+  assert.strictEqual(status, 'HTTP/1.1 200 OK');
+  assert.deepStrictEqual(header(headers, 'content-length'), ['11']);
+  assert.deepStrictEqual(header(headers, 'transfer-encoding'), []);
+  assert.strictEqual(latin1(raw, bodyStart), 'hello world');
+});
+
+// Test 2: Date is an IMF-fixdate unless the handler sets one
+test('Date header is generated unless set', async () => {
+  let raw = await fetchRaw((req, res) => res.end());
+  const date = header(split(raw).headers, 'date');
+  assert.strictEqual(date.length, 1);
+  assert.ok(
+    /^[A-Z][a-z]{2}, \d{2} [A-Z][a-z]{2} \d{4} \d{2}:\d{2}:\d{2} GMT$/.test(
+      date[0]
+    ),
+    `unexpected Date: ${date[0]}`
+  );
+  assert.ok(Math.abs(Date.parse(date[0]) - Date.now()) < 5000);
+  assert.deepStrictEqual(header(split(raw).headers, 'content-length'), ['0']);
+
+  raw = await fetchRaw((req, res) => {
+    res.setHeader('Date', 'Thu, 01 Jan 1970 00:00:00 GMT');
+    res.end();
+  });
+  assert.deepStrictEqual(header(split(raw).headers, 'date'), [
+    'Thu, 01 Jan 1970 00:00:00 GMT',
+  ]);
+});
+
+// Test 3: write() without Content-Length uses chunked framing, binary-safe
+test('binary chunks are framed without corruption', async () => {
+  const binary = new Uint8Array([0, 255, 13, 10, 128, 0]);
+  const raw = await fetchRaw((req, res) => {
+    res.write(binary);
+    res.write('text');
+    res.end();
+  });
+  const { headers, bodyStart } = split(raw);
+  assert.deepStrictEqual(header(headers, 'transfer-encoding'), ['chunked']);
+
+  const body = raw.subarray(bodyStart);
+  const expected = concat([
+    bytesOf('6\r\n'),
+    binary,
+    bytesOf('\r\n4\r\ntext\r\n0\r\n\r\n'),
+  ]);
+  assert.strictEqual(body.length, expected.length);
+  for (let i = 0; i < expected.length; i++) {
+    assert.strictEqual(body[i], expected[i], `byte ${i}`);
+  }
+});
+
+// Test 4: array values become one header line each
+test('array header values are sent as repeated headers', async () => {
+  const raw = await fetchRaw((req, res) => {
+    res.writeHead(201, 'Created', { 'Set-Cookie': ['a=1', 'b=2'] });
+    res.end('x');
+  });
+  const { status, headers } = split(raw);
+  assert.strictEqual(status, 'HTTP/1.1 201 Created');
+  assert.deepStrictEqual(header(headers, 'set-cookie'), ['a=1', 'b=2']);
+});
+
+// Test 5: corked writes are sent in order when the response ends
+test('corked writes keep their order', async () => {
+  const raw = await fetchRaw((req, res) => {
+    res.cork();
+    res.write('one,');
+    res.write('two,');
+    res.end('three');
+  });
+  const { bodyStart } = split(raw);
+  assert.strictEqual(
+    latin1(raw, bodyStart),
+    '4\r\none,\r\n4\r\ntwo,\r\n5\r\nthree\r\n0\r\n\r\n'
+  );
+});
+
+// Test 6: 204 and 304 responses carry no body and no framing headers
+test('204 and 304 responses have no Content-Length or body', async () => {
+  for (const code of [204, 304]) {
+    const raw = await fetchRaw((req, res) => {
+      res.writeHead(code);
+      res.write('dropped');
+      res.end('dropped too');
+    });
+    const { status, headers, bodyStart } = split(raw);
+    assert.ok(status.startsWith(`HTTP/1.1 ${code} `), status);
+    assert.deepStrictEqual(header(headers, 'content-length'), []);
+    assert.deepStrictEqual(header(headers, 'transfer-encoding'), []);
+    assert.strictEqual(raw.length, bodyStart);
+  }
+});
+
+(async () => {
+  for (const { name, fn } of tests) {
+    try {
+      await fn();
+      testsPassed++;
+      console.log(`✓ ${name}`);
+    } catch (err) {
+      testsFailed++;
+      console.log(`FAIL: ${name}`);
+      if (err && err.stack) {
+        console.log(`  ${err.stack}`);
+      } else {
+        console.log(`  ${err}`);
+      }
+    }
+  }
+
+  console.log(`\nTest Results: ${testsPassed} passed, ${testsFailed} failed`);
+  if (testsFailed > 0) {
+    process.exit(1);
+  }
+})();
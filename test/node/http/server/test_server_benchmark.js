@@ -0,0 +1,94 @@
+// Requests/sec benchmark for a hello-world http.Server
+const assert = require('jsrt:assert');
+const http = require('node:http');
+const net = require('node:net');
+const process = require('node:process');
+
+console.log('http.Server Hello World Benchmark\n');
+console.log('='.repeat(50));
+
+const totalRequests = 2000;
+const concurrency = 16;
+const request =
+  'GET /hello HTTP/1.1\r\nHost: 127.0.0.1\r\nUser-Agent: jsrt-bench\r\n' +
+  'Accept: */*\r\n\r\n';
+
+const scenarios = [
+  {
+    name: 'hello world',
+    handler: (req, res) => res.end('Hello World'),
+  },
+  {
+    name: 'reading req.headers',
+    handler: (req, res) => {
+      assert.strictEqual(req.headers['user-agent'], 'jsrt-bench');
+      res.end('Hello World');
+    },
+  },
+];
+
+// Send `totalRequests` requests, one per connection (the server closes the
+// connection after each response), keeping `concurrency` of them in flight
+function run(handler) {
+  return new Promise((resolve, reject) => {
+    const server = http.createServer(handler);
+    server.listen(0, '127.0.0.1', () => {
+      const port = server.address().port;
+      let started = 0;
+      let completed = 0;
+      let received = 0;
+      let failed = false;
+      const start = Date.now();
+
+      const next = () => {
+        if (started >= totalRequests || failed) {
+          return;
+        }
+        started++;
+        const client = net.connect(port, '127.0.0.1');
+        let response = '';
+        client.on('connect', () => client.write(request));
+        client.on('data', (data) => (response += data.toString()));
+        client.on('close', () => {
+          if (response.includes('Hello World')) {
+            received++;
+          }
+          if (++completed === totalRequests) {
+            const elapsed = Math.max(Date.now() - start, 1);
+            server.close();
+            resolve({ elapsed, received });
+          } else {
+            next();
+          }
+        });
+        client.on('error', (err) => {
+          failed = true;
+          server.close();
+          reject(err);
+        });
+      };
+
+      for (let i = 0; i < concurrency; i++) {
+        next();
+      }
+    });
+  });
+}
+
+(async () => {
+  try {
+    for (const { name, handler } of scenarios) {
+      const { elapsed, received } = await run(handler);
+      assert.strictEqual(received, totalRequests, 'all requests answered');
+      const rps = Math.round(received / (elapsed / 1000));
+      console.log(
+        `  ${name}: ${received} requests in ${elapsed}ms (${rps} req/s)`
+      );
+    }
+    console.log('\n' + '='.repeat(50));
+    console.log('✓ http.Server benchmark completed');
+  } catch (err) {
+    console.log('✗ http.Server benchmark failed:', err.message);
+    process.exit(1);
+  }
+})();
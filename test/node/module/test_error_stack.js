@@ -0,0 +1,56 @@
+// Test native Error.stack rewriting: CommonJS line numbers, cwd-relative
+// paths, and the Error wrapper behaving like the built-in constructor
+const assert = require('jsrt:assert');
+const fs = require('node:fs');
+const process = require('node:process');
+
+const root = `/tmp/jsrt_test_error_stack_${Date.now()}`;
+const local = `${process.cwd()}/jsrt_test_error_stack_${Date.now()}.js`;
+const source = [
+  'function make(message) {',
+  '  return new Error(message);',
+  '}',
+  'module.exports = make;',
+].join('\n');
+fs.mkdirSync(root, { recursive: true });
+fs.writeFileSync(`${root}/make.js`, source);
+fs.writeFileSync(local, source);
+
+try {
+  // Test 1: line numbers match the module source, not the wrapper
+  const err = require(`${root}/make.js`)('boom');
+  const frame = err.stack.split('\n')[1];
+  assert.ok(frame.includes(`${root}/make.js:2:`), frame);
+  assert.ok(err.stack.startsWith('Error: boom\n'));
+  assert.ok(!err.stack.includes('at Error (native)'), err.stack);
+
+  // Test 2: frames under the working directory are made relative
+  const relative = local.slice(process.cwd().length + 1);
+  const localErr = require(local)('local');
+  assert.ok(localErr.stack.includes(` ${relative}:2:`), localErr.stack);
+  assert.ok(!localErr.stack.includes(local), localErr.stack);
+
+  // Test 3: stack stays a writable, non-enumerable property
+  const err2 = new Error('x');
+  assert.ok(!Object.keys(err2).includes('stack'));
+  err2.stack = 'custom';
+  assert.strictEqual(err2.stack, 'custom');
+  const err3 = new Error('y');
+  const first = err3.stack;
+  assert.strictEqual(err3.stack, first, 'stack is computed once');
+
+  // Test 4: the wrapper still behaves like Error
+  class MyError extends Error {}
+  const mine = new MyError('sub');
+  assert.ok(mine instanceof MyError);
+  assert.ok(mine instanceof Error);
+  assert.strictEqual(mine.message, 'sub');
+  assert.ok(Error('call') instanceof Error);
+  assert.strictEqual(new Error('c').constructor, Error);
+  assert.strictEqual(typeof Error.captureStackTrace, 'function');
+
+  console.log('✓ Error stack tests passed');
+} finally {
+  fs.rmSync(root, { recursive: true, force: true });
+  fs.rmSync(local, { force: true });
+}
@@ -0,0 +1,46 @@
+// new Error() throughput with 1,000 CommonJS modules loaded
+const assert = require('jsrt:assert');
+const fs = require('node:fs');
+
+console.log('Error Creation Benchmark\n');
+console.log('='.repeat(50));
+
+const moduleCount = 1000;
+const iterations = 20000;
+const root = `/tmp/jsrt_test_error_stack_bench_${Date.now()}`;
+fs.mkdirSync(root, { recursive: true });
+
+function measure(name, fn) {
+  const start = Date.now();
+  for (let i = 0; i < iterations; i++) {
+    fn(i);
+  }
+  const elapsed = Math.max(Date.now() - start, 1);
+  const rate = Math.round(iterations / (elapsed / 1000));
+  console.log(`  ${name}: ${iterations} in ${elapsed}ms (${rate}/s)`);
+}
+
+try {
+  for (let i = 0; i < moduleCount; i++) {
+    fs.writeFileSync(`${root}/m${i}.js`, `module.exports = ${i};`);
+  }
+  for (let i = 0; i < moduleCount; i++) {
+    assert.strictEqual(require(`${root}/m${i}.js`), i);
+  }
+  console.log(`  ${moduleCount} modules loaded`);
+
+  measure('new Error()', () => new Error('bench'));
+  measure('new Error().stack', () => new Error('bench').stack);
+  measure('throw/catch', () => {
+    try {
+      throw new Error('bench');
+    } catch (err) {
+      assert.ok(err instanceof Error);
+    }
+  });
+
+  console.log('\n' + '='.repeat(50));
+  console.log('✓ Error creation benchmark completed');
+} finally {
+  fs.rmSync(root, { recursive: true, force: true });
+}
@@ -0,0 +1,50 @@
+// Test the module resolver's stat, package.json and resolution caches
+const { getStatistics } = require('node:module');
+const assert = require('jsrt:assert');
+const fs = require('node:fs');
+
+const root = `/tmp/jsrt_test_resolve_cache_${Date.now()}`;
+fs.mkdirSync(`${root}/node_modules/dep/lib`, { recursive: true });
+fs.writeFileSync(
+  `${root}/node_modules/dep/package.json`,
+  JSON.stringify({ name: 'dep', main: 'lib/main.js' })
+);
+fs.writeFileSync(
+  `${root}/node_modules/dep/lib/main.js`,
+  'module.exports = "dep";'
+);
+fs.writeFileSync(`${root}/package.json`, JSON.stringify({ type: 'commonjs' }));
+for (let i = 0; i < 5; i++) {
+  fs.writeFileSync(
+    `${root}/m${i}.js`,
+    `module.exports = require('dep') + ${i};`
+  );
+}
+
+try {
+  // Test 1: counters are exposed with the other loader statistics
+  const before = getStatistics().resolveCache;
+  assert.strictEqual(typeof before, 'object');
+  for (const key of ['statHits', 'packageJsonHits', 'resolveHits']) {
+    assert.strictEqual(typeof before[key], 'number', key);
+  }
+
+  // Test 2: sibling modules share the bare-specifier resolution
+  for (let i = 0; i < 5; i++) {
+    assert.strictEqual(require(`${root}/m${i}.js`), `dep${i}`);
+  }
+  const after = getStatistics().resolveCache;
+  assert.ok(after.resolveHits >= before.resolveHits + 4);
+  assert.ok(after.statHits > before.statHits);
+  assert.ok(after.packageJsonHits > before.packageJsonHits);
+  assert.ok(after.resolveEntries > 0);
+
+  // Test 3: a failed resolution does not hide a file created afterwards
+  assert.throws(() => require(`${root}/late`));
+  fs.writeFileSync(`${root}/late.js`, 'module.exports = "late";');
+  assert.strictEqual(require(`${root}/late`), 'late');
+
+  console.log('✓ Resolver cache tests passed');
+} finally {
+  fs.rmSync(root, { recursive: true, force: true });
+}
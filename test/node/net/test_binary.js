@@ -0,0 +1,305 @@
+// Test binary-safe writes and Buffer data events in net module
+const assert = require('jsrt:assert');
+const net = require('node:net');
+const process = require('node:process');
+
+const tests = [];
+let testsPassed = 0;
+let testsFailed = 0;
+
+function test(name, fn) {
+  tests.push({ name, fn });
+}
+
+// Start a server whose connection handler is `onConnection`, then connect a client
+function withConnection(onConnection, onClient) {
+  return new Promise((resolve, reject) => {
+    const server = net.createServer(onConnection);
+    const timer = setTimeout(() => {
+      server.close();
+      reject(new Error('Test timeout'));
+    }, 2000);
+
+    server.listen(0, '127.0.0.1', () => {
+      const client = net.connect(server.address().port, '127.0.0.1');
+      client.on('error', (err) => {
+        clearTimeout(timer);
+        server.close();
+        reject(err);
+      });
+      onClient(client, (err) => {
+        clearTimeout(timer);
+        client.destroy();
+        server.close();
+        err ? reject(err) : resolve();
+      });
+    });
+  });
+}
+
+// Test 1: data events carry Buffers unless an encoding is set
+test('data events emit Buffer chunks by default', () => {
+  return withConnection(
+    (socket) => {
+      socket.write('hello');
+      socket.end();
+    },
+    (client, done) => {
+      client.on('data', (chunk) => {
+        try {
+          assert.ok(chunk instanceof Uint8Array, 'chunk should be a Buffer');
+          assert.ok(Buffer.isBuffer(chunk), 'Buffer.isBuffer(chunk)');
+          assert.strictEqual(chunk.toString(), 'hello');
+          done();
+        } catch (err) {
+          done(err);
+        }
+      });
+    }
+  );
+});
+
+// Test 2: payloads with NUL and high bytes survive a round trip
+test('binary payload with NUL bytes is echoed intact', () => {
+  const payload = new Uint8Array(256);
+  for (let i = 0; i < payload.length; i++) {
+    payload[i] = i;
+  }
+
+  return withConnection(
+    (socket) => {
+      socket.on('data', (chunk) => socket.write(chunk));
+    },
+    (client, done) => {
+      const chunks = [];
+      let received = 0;
+      client.on('data', (chunk) => {
+        chunks.push(chunk);
+        received += chunk.length;
+        if (received < payload.length) {
+          return;
+        }
+        try {
+          const all = Buffer.concat(chunks);
+          assert.strictEqual(all.length, payload.length);
+          for (let i = 0; i < payload.length; i++) {
+            assert.strictEqual(all[i], payload[i], `byte ${i}`);
+          }
+          done();
+        } catch (err) {
+          done(err);
+        }
+      });
+      client.write(payload);
+    }
+  );
+});
+
+// Test 3: a TypedArray view writes only its own window of the backing store
+test('write honours TypedArray byteOffset and length', () => {
+  const backing = new Uint8Array([0x78, 0x61, 0x00, 0x62, 0x78]);
+  const view = backing.subarray(1, 4);
+
+  return withConnection(
+    (socket) => {
+      socket.write(view);
+      socket.write(new Uint16Array([0x6463]).buffer);
+      socket.end();
+    },
+    (client, done) => {
+      const chunks = [];
+      client.on('data', (chunk) => chunks.push(chunk));
+      client.on('end', () => {
+        try {
+          const all = Buffer.concat(chunks);
+          assert.deepStrictEqual(
+            Array.from(all),
+            [0x61, 0x00, 0x62, 0x63, 0x64],
+            'view bytes followed by ArrayBuffer bytes'
+          );
+          assert.strictEqual(client.bytesRead, 5);
+          done();
+        } catch (err) {
+          done(err);
+        }
+      });
+    }
+  );
+});
+
+// Test 4: a buffer being written cannot be transferred away from under libuv
+test('buffers being written cannot be transferred', () => {
+  const payload = new Uint8Array(64 * 1024).fill(0x5a);
+  let transferError = null;
+
+  return withConnection(
+    (socket) => {
+      socket.write(payload);
+      if (typeof ArrayBuffer.prototype.transfer === 'function') {
+        try {
+          payload.buffer.transfer();
+        } catch (err) {
+          transferError = err;
+        }
+      }
+      socket.end();
+    },
+    (client, done) => {
+      const chunks = [];
+      client.on('data', (chunk) => chunks.push(chunk));
+      client.on('end', () => {
+        try {
+          if (typeof ArrayBuffer.prototype.transfer === 'function') {
+            assert.ok(transferError instanceof TypeError, 'transfer threw');
+          }
+          const all = Buffer.concat(chunks);
+          assert.strictEqual(all.length, payload.length);
+          assert.ok(all.every((byte) => byte === 0x5a));
+          done();
+        } catch (err) {
+          done(err);
+        }
+      });
+    }
+  );
+});
+
+// Test 5: chunks retained across reads are never overwritten by later reads,
+// and chunk.buffer exposes nothing but the chunk's own bytes
+test('retained data chunks stay intact across reads', () => {
+  const rounds = 64;
+  const block = (n) => new Uint8Array(1024).fill(n & 0xff);
+
+  return withConnection(
+    (socket) => {
+      // Send one 1KB block per acknowledgement so every block is a separate read
+      let sent = 1;
+      let acked = 0;
+      socket.write(block(0));
+      socket.on('data', (chunk) => {
+        acked += chunk.length / 4;
+        while (sent < rounds && sent <= acked) {
+          socket.write(block(sent++));
+        }
+        if (acked >= rounds) {
+          socket.end();
+        }
+      });
+    },
+    (client, done) => {
+      const chunks = [];
+      let received = 0;
+      let isolated = true;
+      client.on('data', (chunk) => {
+        chunks.push(chunk);
+        isolated = isolated && chunk.buffer.byteLength === chunk.length;
+        const before = Math.floor(received / 1024);
+        received += chunk.length;
+        for (let k = before; k < Math.floor(received / 1024); k++) {
+          client.write('next');
+        }
+      });
+      client.on('end', () => {
+        try {
+          const all = Buffer.concat(chunks);
+          assert.ok(isolated, 'chunk.buffer reaches beyond the chunk');
+          assert.strictEqual(all.length, rounds * 1024);
+          for (let i = 0; i < all.length; i += 1024) {
+            assert.strictEqual(all[i], (i / 1024) & 0xff, `block ${i / 1024}`);
+            assert.strictEqual(all[i + 1023], (i / 1024) & 0xff);
+          }
+          done();
+        } catch (err) {
+          done(err);
+        }
+      });
+    }
+  );
+});
+
+// Test 6: detaching a data chunk's buffer leaves later chunks intact
+test('transferred data chunks do not release later reads', () => {
+  const rounds = 32;
+  const block = (n) => new Uint8Array(512).fill(n & 0xff);
+
+  return withConnection(
+    (socket) => {
+      let sent = 0;
+      socket.write(block(sent++));
+      socket.on('data', () => {
+        if (sent < rounds) {
+          socket.write(block(sent++));
+        } else {
+          socket.end();
+        }
+      });
+    },
+    (client, done) => {
+      const copies = [];
+      let detached = true;
+      client.on('data', (chunk) => {
+        copies.push(Buffer.from(chunk));
+        structuredClone(chunk.buffer, { transfer: [chunk.buffer] });
+        detached = detached && chunk.buffer.byteLength === 0;
+        client.write('next');
+      });
+      client.on('end', () => {
+        try {
+          const all = Buffer.concat(copies);
+          assert.ok(detached, 'chunk.buffer was not transferred');
+          assert.strictEqual(all.length, rounds * 512);
+          for (let i = 0; i < all.length; i++) {
+            assert.strictEqual(all[i], Math.floor(i / 512) & 0xff, `byte ${i}`);
+          }
+          done();
+        } catch (err) {
+          done(err);
+        }
+      });
+    }
+  );
+});
+
+// Test 7: setEncoding switches data events back to strings
+test('setEncoding emits strings', () => {
+  return withConnection(
+    (socket) => {
+      socket.write(Buffer.from('text'));
+      socket.end();
+    },
+    (client, done) => {
+      client.setEncoding('utf8');
+      client.on('data', (chunk) => {
+        try {
+          assert.strictEqual(chunk, 'text');
+          done();
+        } catch (err) {
+          done(err);
+        }
+      });
+    }
+  );
+});
+
+(async () => {
+  for (const { name, fn } of tests) {
+    try {
+      await fn();
+      testsPassed++;
+      console.log(`✓ ${name}`);
+    } catch (err) {
+      testsFailed++;
+      console.log(`FAIL: ${name}`);
+      if (err && err.stack) {
+        console.log(`  ${err.stack}`);
+      } else {
+        console.log(`  ${err}`);
+      }
+    }
+  }
+
+  console.log(`\nTest Results: ${testsPassed} passed, ${testsFailed} failed`);
+  if (testsFailed > 0) {
+    process.exit(1);
+  }
+})();
@@ -0,0 +1,74 @@
+// Throughput benchmark for a binary echo server over net.Socket
+const assert = require('jsrt:assert');
+const net = require('node:net');
+const process = require('node:process');
+
+console.log('net Binary Echo Benchmark\n');
+console.log('='.repeat(50));
+
+const totalBytes = 8 * 1024 * 1024;
+const chunkSizes = [
+  { name: '64B', size: 64 },
+  { name: '1KB', size: 1024 },
+  { name: '16KB', size: 16 * 1024 },
+  { name: '64KB', size: 64 * 1024 },
+];
+
+// Echo `totalBytes` through the server using chunks of `chunkSize` bytes
+function runEcho(chunkSize) {
+  return new Promise((resolve, reject) => {
+    const server = net.createServer((socket) => {
+      socket.on('data', (chunk) => socket.write(chunk));
+    });
+
+    server.listen(0, '127.0.0.1', () => {
+      const client = net.connect(server.address().port, '127.0.0.1');
+      const chunk = new Uint8Array(chunkSize);
+      for (let i = 0; i < chunkSize; i++) {
+        chunk[i] = i & 0xff;
+      }
+
+      let received = 0;
+      const start = Date.now();
+
+      client.on('connect', () => {
+        for (let sent = 0; sent < totalBytes; sent += chunkSize) {
+          client.write(chunk);
+        }
+      });
+
+      client.on('data', (data) => {
+        received += data.length;
+        if (received >= totalBytes) {
+          const elapsed = Math.max(Date.now() - start, 1);
+          client.destroy();
+          server.close();
+          resolve({ elapsed, received });
+        }
+      });
+
+      client.on('error', (err) => {
+        server.close();
+        reject(err);
+      });
+    });
+  });
+}
+
+(async () => {
+  try {
+    for (const { name, size } of chunkSizes) {
+      const { elapsed, received } = await runEcho(size);
+      assert.strictEqual(received, totalBytes, 'all bytes echoed back');
+      const mbps = (received / 1024 / 1024 / (elapsed / 1000)).toFixed(1);
+      console.log(
+        `  ${name} chunks: ${received} bytes in ${elapsed}ms (${mbps} MB/s)`
+      );
+    }
+    console.log('\n' + '='.repeat(50));
+    console.log('✓ net binary echo benchmark completed');
+  } catch (err) {
+    console.log('✗ net binary echo benchmark failed:', err.message);
+    process.exit(1);
+  }
+})();
@@ -0,0 +1,152 @@
+// Test write batching, cork/uncork and backpressure accounting in net module
+const assert = require('jsrt:assert');
+const net = require('node:net');
+const process = require('node:process');
+
+const tests = [];
+let testsPassed = 0;
+let testsFailed = 0;
+
+function test(name, fn) {
+  tests.push({ name, fn });
+}
+
+// Connect a client to an echo-less server that collects everything it receives
+function withCollector(onClient) {
+  return new Promise((resolve, reject) => {
+    const chunks = [];
+    const server = net.createServer((socket) => {
+      socket.on('data', (chunk) => chunks.push(chunk));
+      socket.on('end', () => socket.end());
+    });
+    const timer = setTimeout(() => {
+      server.close();
+      reject(new Error('Test timeout'));
+    }, 2000);
+
+    server.listen(0, '127.0.0.1', () => {
+      const client = net.connect(server.address().port, '127.0.0.1');
+      client.on('error', (err) => {
+        clearTimeout(timer);
+        server.close();
+        reject(err);
+      });
+      // The server only ends after it has seen all of the client's data
+      client.on('end', () => {
+        clearTimeout(timer);
+        client.destroy();
+        server.close();
+        resolve(Buffer.concat(chunks));
+      });
+      onClient(client);
+    });
+  });
+}
+
+// Test 1: many small writes in one tick arrive intact and in order
+test('small writes in one tick are delivered in order', async () => {
+  const received = await withCollector((client) => {
+    client.on('connect', () => {
+      for (let i = 0; i < 1000; i++) {
+        client.write(`${i % 10}`);
+      }
+      client.write(new Uint8Array([0x41, 0x42]));
+      client.end();
+    });
+  });
+
+  let expected = '';
+  for (let i = 0; i < 1000; i++) {
+    expected += `${i % 10}`;
+  }
+  assert.strictEqual(received.toString(), expected + 'AB');
+});
+
+// Test 2: corked writes are buffered and counted until uncork
+test('cork buffers writes and writableLength reports them', async () => {
+  const lengths = [];
+  const received = await withCollector((client) => {
+    client.on('connect', () => {
+      lengths.push(client.writableLength);
+      client.cork();
+      client.write('hello ');
+      client.write(Buffer.from('corked '));
+      client.write('world');
+      lengths.push(client.writableLength, client.bufferSize);
+      client.uncork();
+      setTimeout(() => {
+        lengths.push(client.writableLength);
+        client.end();
+      }, 20);
+    });
+  });
+
+  assert.deepStrictEqual(lengths, [0, 18, 18, 0]);
+  assert.strictEqual(received.toString(), 'hello corked world');
+});
+
+// Test 3: write() signals backpressure past the high-water mark and drains
+test('write returns false past the high-water mark and emits drain', () => {
+  return new Promise((resolve, reject) => {
+    const server = net.createServer((socket) => {
+      socket.on('data', () => {});
+    });
+    const timer = setTimeout(() => {
+      server.close();
+      reject(new Error('Test timeout'));
+    }, 2000);
+
+    server.listen(0, '127.0.0.1', () => {
+      const client = net.connect(server.address().port, '127.0.0.1', () => {
+        const ok = client.write(new Uint8Array(64 * 1024));
+        try {
+          assert.strictEqual(ok, false, 'write should report backpressure');
+          assert.ok(client.writableLength >= 64 * 1024);
+        } catch (err) {
+          clearTimeout(timer);
+          client.destroy();
+          server.close();
+          reject(err);
+          return;
+        }
+        client.on('drain', () => {
+          clearTimeout(timer);
+          try {
+            assert.strictEqual(client.writableLength, 0);
+            client.destroy();
+            server.close();
+            resolve();
+          } catch (err) {
+            client.destroy();
+            server.close();
+            reject(err);
+          }
+        });
+      });
+      client.on('error', reject);
+    });
+  });
+});
+
+(async () => {
+  for (const { name, fn } of tests) {
+    try {
+      await fn();
+      testsPassed++;
+      console.log(`✓ ${name}`);
+    } catch (err) {
+      testsFailed++;
+      console.log(`FAIL: ${name}`);
+      if (err && err.stack) {
+        console.log(`  ${err.stack}`);
+      } else {
+        console.log(`  ${err}`);
+      }
+    }
+  }
+
+  console.log(`\nTest Results: ${testsPassed} passed, ${testsFailed} failed`);
+  if (testsFailed > 0) {
+    process.exit(1);
+  }
+})();
@@ -0,0 +1,188 @@
+// Test threadpool-backed fs.createReadStream()/createWriteStream()
+const assert = require('jsrt:assert');
+const fs = require('node:fs');
+const process = require('node:process');
+
+const tests = [];
+let testsPassed = 0;
+let testsFailed = 0;
+
+function test(name, fn) {
+  tests.push({ name, fn });
+}
+
+const tmpFile = '/tmp/jsrt_test_fs_streams_async.bin';
+const size = 200 * 1024;
+const payload = new Uint8Array(size);
+for (let i = 0; i < size; i++) {
+  payload[i] = (i * 31) & 0xff;
+}
+
+function withTimeout(executor) {
+  return new Promise((resolve, reject) => {
+    const timer = setTimeout(() => reject(new Error('Test timeout')), 2000);
+    executor(
+      (value) => {
+        clearTimeout(timer);
+        resolve(value);
+      },
+      (err) => {
+        clearTimeout(timer);
+        reject(err);
+      }
+    );
+  });
+}
+
+function readAll(options) {
+  return withTimeout((resolve, reject) => {
+    const chunks = [];
+    const rs = fs.createReadStream(tmpFile, options);
+    rs.on('error', reject);
+    rs.on('data', (chunk) => chunks.push(chunk));
+    rs.on('end', () => resolve(chunks));
+  });
+}
+
+// Test 1: writes are queued, report backpressure and drain
+test('write stream applies backpressure and finishes', async () => {
+  const events = await withTimeout((resolve, reject) => {
+    const seen = [];
+    const ws = fs.createWriteStream(tmpFile, { highWaterMark: 16 * 1024 });
+    ws.on('error', reject);
+    ws.on('drain', () => seen.push('drain'));
+    ws.on('close', () => {
+      seen.push('close');
+      resolve(seen);
+    });
+
+    let ok = true;
+    for (let offset = 0; offset < size; offset += 8 * 1024) {
+      ok = ws.write(payload.subarray(offset, offset + 8 * 1024)) && ok;
+    }
+    seen.push(ok ? 'ok' : 'full', ws.writableLength);
+    ws.end(() => seen.push('finish'));
+  });
+
+  assert.deepStrictEqual(events.slice(0, 2), ['full', size]);
+  assert.strictEqual(events[events.length - 2], 'finish');
+  assert.strictEqual(fs.readFileSync(tmpFile).length, size);
+});
+
+// Test 2: reads arrive in highWaterMark-sized Buffers and match the file
+test('read stream delivers the whole file in order', async () => {
+  const chunks = await readAll({ highWaterMark: 16 * 1024 });
+  assert.ok(chunks.length >= size / (16 * 1024));
+  for (const chunk of chunks) {
+    assert.ok(chunk instanceof Uint8Array);
+    assert.ok(chunk.length <= 16 * 1024);
+  }
+  const data = Buffer.concat(chunks);
+  assert.strictEqual(data.length, size);
+  for (let i = 0; i < size; i += 4099) {
+    assert.strictEqual(data[i], payload[i]);
+  }
+});
+
+// Test 3: chunks stay intact while later reads reuse and refill buffers
+test('flowing read stream matches the file byte for byte', async () => {
+  const chunks = await readAll({ highWaterMark: 4096 });
+  assert.ok(chunks.length > 10);
+  const data = Buffer.concat(chunks);
+  assert.strictEqual(data.length, size);
+  for (let i = 0; i < size; i++) {
+    if (data[i] !== payload[i]) {
+      assert.fail(`byte ${i} is ${data[i]}, expected ${payload[i]}`);
+    }
+  }
+});
+
+// Test 4: transferring a chunk's buffer mid-stream leaves later reads intact
+test('transferred chunks do not release buffers still being read', async () => {
+  const copies = await withTimeout((resolve, reject) => {
+    const seen = [];
+    const rs = fs.createReadStream(tmpFile, { highWaterMark: 4096 });
+    rs.on('error', reject);
+    rs.on('data', (chunk) => {
+      seen.push(Buffer.from(chunk));
+      structuredClone(chunk.buffer, { transfer: [chunk.buffer] });
+    });
+    rs.on('end', () => resolve(seen));
+  });
+  const data = Buffer.concat(copies);
+  assert.strictEqual(data.length, size);
+  for (let i = 0; i < size; i++) {
+    if (data[i] !== payload[i]) {
+      assert.fail(`byte ${i} is ${data[i]}, expected ${payload[i]}`);
+    }
+  }
+});
+
+// Test 5: start/end select an inclusive byte range
+test('read stream honours start and end', async () => {
+  const data = Buffer.concat(await readAll({ start: 1000, end: 1999 }));
+  assert.strictEqual(data.length, 1000);
+  assert.strictEqual(data[0], payload[1000]);
+  assert.strictEqual(data[999], payload[1999]);
+});
+
+// Test 6: without a consumer only one highWaterMark of data is read ahead
+test('paused read stream bounds read-ahead', async () => {
+  const rs = fs.createReadStream(tmpFile, { highWaterMark: 4096 });
+  const bytesRead = await withTimeout((resolve, reject) => {
+    rs.on('error', reject);
+    rs.on('readable', () => setTimeout(() => resolve(rs.bytesRead), 50));
+  });
+  assert.strictEqual(bytesRead, 4096);
+
+  // Consuming the buffered chunk lets the stream read the next one
+  assert.strictEqual(rs.read().length, 4096);
+  await withTimeout((resolve) => setTimeout(resolve, 50));
+  assert.strictEqual(rs.bytesRead, 8192);
+  rs.destroy();
+});
+
+// Test 7: an encoding turns chunks into strings
+test('encoding option yields strings', async () => {
+  fs.writeFileSync(tmpFile, 'hello stream');
+  const chunks = await readAll({ encoding: 'utf8' });
+  assert.strictEqual(typeof chunks[0], 'string');
+  assert.strictEqual(chunks.join(''), 'hello stream');
+});
+
+// Test 8: a missing file fails at creation
+test('missing file throws ENOENT', () => {
+  assert.throws(
+    () => fs.createReadStream('/tmp/jsrt_no_such_file_for_streams'),
+    (err) => err.code === 'ENOENT'
+  );
+});
+
+(async () => {
+  for (const { name, fn } of tests) {
+    try {
+      await fn();
+      testsPassed++;
+      console.log(`✓ ${name}`);
+    } catch (err) {
+      testsFailed++;
+      console.log(`FAIL: ${name}`);
+      if (err && err.stack) {
+        console.log(`  ${err.stack}`);
+      } else {
+        console.log(`  ${err}`);
+      }
+    }
+  }
+
+  try {
+    fs.unlinkSync(tmpFile);
+  } catch (e) {
+    // Ignore cleanup errors
+  }
+
+  console.log(`\nTest Results: ${testsPassed} passed, ${testsFailed} failed`);
+  if (testsFailed > 0) {
+    process.exit(1);
+  }
+})();
@@ -0,0 +1,44 @@
+// Test StringDecoder: characters split across chunks are held back until
+// they are complete, end() flushes what is left
+const assert = require('jsrt:assert');
+const { StringDecoder } = require('node:string_decoder');
+
+const utf8 = new StringDecoder('utf8');
+assert.strictEqual(utf8.encoding, 'utf8');
+assert.ok(utf8 instanceof StringDecoder);
+
+// '€' is e2 82 ac, '😀' is f0 9f 98 80
+assert.strictEqual(utf8.write(Buffer.from([0x61, 0xe2])), 'a');
+assert.strictEqual(utf8.write(Buffer.from([0x82])), '');
+assert.strictEqual(utf8.write(Buffer.from([0xac, 0x62])), '€b');
+assert.strictEqual(utf8.write(Buffer.from([0xf0, 0x9f, 0x98])), '');
+assert.strictEqual(utf8.end(Buffer.from([0x80])), '\u{1f600}');
+assert.strictEqual(utf8.write(Buffer.from('plain')), 'plain');
+assert.ok(utf8.write(Buffer.from([0xe2])) === '');
+assert.ok(utf8.end().startsWith('�'), 'end() flushes partial input');
+assert.strictEqual(utf8.end(), '');
+
+// A surrogate pair split between chunks, in UTF-16LE
+const utf16 = new StringDecoder('utf-16le');
+assert.strictEqual(utf16.encoding, 'utf16le');
+const pair = Buffer.from('\u{1f600}!', 'utf16le');
+assert.strictEqual(utf16.write(pair.subarray(0, 2)), '');
+assert.strictEqual(utf16.write(pair.subarray(2, 5)), '\u{1f600}');
+assert.strictEqual(utf16.end(pair.subarray(5)), '!');
+
+// base64 output only for whole 3-byte groups until end()
+const b64 = new StringDecoder('base64');
+assert.strictEqual(b64.write(Buffer.from('abcd')), 'YWJj');
+assert.strictEqual(b64.end(), 'ZA==');
+
+// Single-byte encodings and views with a byte offset
+const latin1 = new StringDecoder('latin1');
+assert.strictEqual(latin1.write(Buffer.from([0x41, 0xe9, 0xff])), 'Aéÿ');
+const bytes = new Uint8Array([0x20, 0x68, 0x69]);
+assert.strictEqual(new StringDecoder().write(bytes.subarray(1)), 'hi');
+assert.strictEqual(new StringDecoder('hex').write(bytes), '206869');
+
+assert.throws(() => new StringDecoder('nope'), TypeError);
+assert.throws(() => utf8.write(42), TypeError);
+
+console.log('✓ StringDecoder');
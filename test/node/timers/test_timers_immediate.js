@@ -0,0 +1,89 @@
+// Test setImmediate()/clearImmediate() queueing and process.nextTick()
+const assert = require('jsrt:assert');
+const timers = require('node:timers');
+const timersPromises = require('node:timers/promises');
+
+const order = [];
+
+// Test 1: nextTick runs before promise reactions and passes its arguments
+process.nextTick((a, b) => order.push(`tick ${a} ${b}`), 1, 2);
+Promise.resolve().then(() => order.push('promise'));
+process.nextTick(() => {
+  order.push('tick 2');
+  process.nextTick(() => order.push('nested tick'));
+});
+
+// Test 2: immediates run in order with their arguments, and microtasks
+// queued by one immediate run before the next
+setImmediate((value) => {
+  order.push(`immediate ${value}`);
+  Promise.resolve().then(() => order.push('immediate microtask'));
+  process.nextTick(() => order.push('immediate tick'));
+  setImmediate(() => {
+    order.push('next iteration');
+    setImmediate(finish);
+  });
+}, 'a');
+const cleared = setImmediate(() => order.push('cleared'));
+setImmediate(() => {
+  order.push('immediate b');
+  clearImmediate(later);
+});
+const later = setImmediate(() => order.push('cleared by callback'));
+clearImmediate(cleared);
+
+// Test 3: Immediate objects
+const handle = setImmediate(() => order.push('unref immediate'));
+assert.strictEqual(typeof handle, 'object');
+assert.strictEqual(handle.hasRef(), true);
+assert.strictEqual(handle.unref(), handle);
+assert.strictEqual(handle.hasRef(), false);
+assert.strictEqual(handle.ref().hasRef(), true);
+clearImmediate(handle);
+assert.strictEqual(handle.hasRef(), false);
+clearImmediate(cleared);
+clearImmediate(undefined);
+assert.strictEqual(timers.setImmediate, setImmediate);
+assert.throws(() => setImmediate('not a function'), TypeError);
+assert.throws(() => process.nextTick(null), TypeError);
+
+async function finish() {
+  assert.deepStrictEqual(order, [
+    'tick 1 2',
+    'tick 2',
+    'nested tick',
+    'promise',
+    'immediate a',
+    'immediate tick',
+    'immediate microtask',
+    'immediate b',
+    'next iteration',
+  ]);
+
+  // Test 4: timers/promises resolves with the given value
+  assert.strictEqual(await timersPromises.setImmediate('value'), 'value');
+
+  // Test 5: tight setImmediate and nextTick loops
+  const COUNT = 100000;
+  let start = Date.now();
+  await new Promise((resolve) => {
+    let n = 0;
+    const step = () => (++n < COUNT ? setImmediate(step) : resolve());
+    setImmediate(step);
+  });
+  const immediateMs = Math.max(Date.now() - start, 1);
+
+  start = Date.now();
+  await new Promise((resolve) => {
+    let n = 0;
+    const step = () => (++n < COUNT ? process.nextTick(step) : resolve());
+    process.nextTick(step);
+  });
+  const tickMs = Math.max(Date.now() - start, 1);
+
+  console.log(
+    `setImmediate: ${COUNT} in ${immediateMs}ms, ` +
+      `nextTick: ${COUNT} in ${tickMs}ms`
+  );
+  console.log('✓ setImmediate/nextTick tests passed');
+}
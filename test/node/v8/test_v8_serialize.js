@@ -0,0 +1,203 @@
+// Test v8.serialize()/deserialize() and the Serializer/Deserializer classes
+// against the V8 wire format Node.js writes
+const assert = require('jsrt:assert');
+const v8 = require('node:v8');
+const { Buffer } = require('node:buffer');
+
+const roundTrip = (value) => v8.deserialize(v8.serialize(value));
+const hex = (value) => v8.serialize(value).toString('hex');
+
+// Test 1: bytes match what Node.js writes
+assert.ok(Buffer.isBuffer(v8.serialize(1)));
+assert.strictEqual(hex(1), 'ff0f4902');
+assert.strictEqual(hex(-1), 'ff0f4901');
+assert.strictEqual(hex(2 ** 31), 'ff0f4e000000000000e041');
+assert.strictEqual(hex(null), 'ff0f30');
+assert.strictEqual(hex(true), 'ff0f54');
+assert.strictEqual(hex('hi'), 'ff0f22026869');
+assert.strictEqual(hex('é'), 'ff0f2201e9');
+assert.strictEqual(hex('€'), 'ff0f6302ac20');
+assert.strictEqual(hex({ a: 1 }), 'ff0f6f22016149027b01');
+assert.strictEqual(hex([1, 2]), 'ff0f410249024904240002');
+assert.strictEqual(hex(10n), 'ff0f5a100a00000000000000');
+assert.strictEqual(hex(new Uint8Array([1, 2])), 'ff0f5c01020102');
+assert.strictEqual(hex(Buffer.from([1])), 'ff0f5c0a0101');
+
+// Test 2: primitives and strings round-trip
+const primitives = [
+  undefined, null, true, false, 0, -0, 1.5, -(2 ** 40), NaN, Infinity,
+  '', 'ascii', 'latin1 ÿ', 'two-byte 😀 €', 0n, 10n, -(2n ** 100n),
+  2n ** 64n, -(2n ** 63n),
+];
+for (const value of primitives) {
+  assert.ok(Object.is(roundTrip(value), value), String(value));
+}
+
+// Test 3: objects, arrays, shared references and cycles
+const shared = { name: 'shared' };
+const graph = { list: [shared, shared], nested: { deep: [1, [2, [3]]] } };
+graph.self = graph;
+const graphCopy = roundTrip(graph);
+assert.strictEqual(graphCopy.self, graphCopy);
+assert.strictEqual(graphCopy.list[0], graphCopy.list[1]);
+assert.deepStrictEqual(graphCopy.nested, graph.nested);
+const sparse = [1, , 3];
+sparse.extra = 'x';
+const sparseCopy = roundTrip(sparse);
+assert.strictEqual(sparseCopy.length, 3);
+assert.ok(!(1 in sparseCopy));
+assert.strictEqual(sparseCopy.extra, 'x');
+assert.deepStrictEqual(roundTrip({ 0: 'a', 10: 'b', k: 'c' }), {
+  0: 'a',
+  10: 'b',
+  k: 'c',
+});
+
+// Test 4: built-in types
+const date = new Date(1700000000000);
+assert.strictEqual(roundTrip(date).getTime(), date.getTime());
+const regexp = roundTrip(/a+b/gi);
+assert.strictEqual(regexp.source, 'a+b');
+assert.strictEqual(regexp.flags, 'gi');
+const map = roundTrip(new Map([[shared, 1], ['k', shared]]));
+const [mapKey] = map.keys();
+assert.strictEqual(map.get('k'), mapKey);
+assert.deepStrictEqual([...roundTrip(new Set([1, 'two']))], [1, 'two']);
+assert.strictEqual(roundTrip(new String('s')).valueOf(), 's');
+assert.strictEqual(roundTrip(new Number(4)).valueOf(), 4);
+assert.strictEqual(roundTrip(Object(5n)).valueOf(), 5n);
+const error = roundTrip(new RangeError('bad', { cause: { code: 1 } }));
+assert.ok(error instanceof RangeError);
+assert.strictEqual(error.message, 'bad');
+assert.deepStrictEqual(error.cause, { code: 1 });
+
+// Test 5: typed arrays, Buffers and DataViews
+const floats = roundTrip(new Float64Array([1.5, -2.25]));
+assert.ok(floats instanceof Float64Array);
+assert.deepStrictEqual(Array.from(floats), [1.5, -2.25]);
+const words = new Uint16Array(new ArrayBuffer(8), 2, 2);
+words.set([0x1234, 0xabcd]);
+const wordsCopy = roundTrip(words);
+assert.deepStrictEqual(Array.from(wordsCopy), [0x1234, 0xabcd]);
+const bufCopy = roundTrip(Buffer.from('buffer'));
+assert.ok(Buffer.isBuffer(bufCopy));
+assert.strictEqual(bufCopy.toString(), 'buffer');
+assert.strictEqual(roundTrip(new DataView(new ArrayBuffer(3))).byteLength, 3);
+const arrayBuffer = roundTrip(new Uint8Array([7, 8]).buffer);
+assert.ok(arrayBuffer instanceof ArrayBuffer);
+assert.deepStrictEqual(Array.from(new Uint8Array(arrayBuffer)), [7, 8]);
+
+// Test 6: what cannot be serialized
+assert.throws(() => v8.serialize(() => {}));
+assert.throws(() => v8.serialize(Symbol('s')));
+assert.throws(() => v8.serialize(new WeakMap()));
+assert.throws(() => v8.serialize(Promise.resolve()));
+assert.throws(() => v8.deserialize(Buffer.from([0xff, 0x0f, 0x6f])));
+assert.throws(() => v8.deserialize(Buffer.from([0xff, 0x7f, 0x30])));
+assert.throws(() => v8.deserialize('not a buffer'), TypeError);
+
+// Test 7: a plain Serializer writes views after their whole buffer
+const ser = new v8.Serializer();
+ser.writeHeader();
+const backing = new Uint8Array([1, 2, 3, 4]);
+ser.writeValue([backing, backing.subarray(2)]);
+ser.writeUint32(300);
+ser.writeUint64(1, 2);
+ser.writeDouble(0.5);
+ser.writeRawBytes(Buffer.from('raw'));
+const written = ser.releaseBuffer();
+const des = new v8.Deserializer(written);
+assert.strictEqual(des.readHeader(), true);
+assert.strictEqual(des.getWireFormatVersion(), 15);
+const [whole, part] = des.readValue();
+assert.strictEqual(whole.buffer, part.buffer);
+assert.strictEqual(part.byteOffset, 2);
+assert.deepStrictEqual(Array.from(part), [3, 4]);
+assert.strictEqual(des.readUint32(), 300);
+assert.deepStrictEqual(des.readUint64(), [1, 2]);
+assert.strictEqual(des.readDouble(), 0.5);
+assert.strictEqual(des.readRawBytes(3).toString(), 'raw');
+
+// Test 8: subclasses write and read their own host objects
+class TaggedSerializer extends v8.DefaultSerializer {
+  _writeHostObject(view) {
+    this.writeUint32(view.length);
+    super._writeHostObject(view);
+  }
+}
+class TaggedDeserializer extends v8.DefaultDeserializer {
+  _readHostObject() {
+    const length = this.readUint32();
+    const view = super._readHostObject();
+    assert.strictEqual(view.length, length);
+    return view;
+  }
+}
+const tagged = new TaggedSerializer();
+tagged.writeHeader();
+tagged.writeValue({ ints: new Int32Array([5, -6]) });
+const taggedReader = new TaggedDeserializer(tagged.releaseBuffer());
+taggedReader.readHeader();
+assert.deepStrictEqual(Array.from(taggedReader.readValue().ints), [5, -6]);
+
+// Test 9: transferred ArrayBuffers are written as references
+const transferred = new ArrayBuffer(4);
+const sender = new v8.Serializer();
+sender.transferArrayBuffer(0, transferred);
+sender.writeHeader();
+sender.writeValue({ transferred });
+const receiver = new v8.Deserializer(sender.releaseBuffer());
+const target = new ArrayBuffer(4);
+receiver.transferArrayBuffer(0, target);
+receiver.readHeader();
+assert.strictEqual(receiver.readValue().transferred, target);
+
+// Test 10: typed-array-heavy payloads are smaller and faster than JSON
+const samples = [];
+for (let i = 0; i < 200; i++) {
+  const values = new Float64Array(256);
+  for (let j = 0; j < values.length; j++) {
+    values[j] = Math.sin(i * 256 + j);
+  }
+  samples.push({ id: i, values });
+}
+const asJSON = () =>
+  JSON.stringify(samples.map((s) => ({ id: s.id, values: [...s.values] })));
+const fromJSON = (text) =>
+  JSON.parse(text).map((s) => ({
+    id: s.id,
+    values: Float64Array.from(s.values),
+  }));
+const measure = (fn) => {
+  const start = Date.now();
+  let result;
+  for (let i = 0; i < 5; i++) {
+    result = fn();
+  }
+  return { result, elapsed: Date.now() - start };
+};
+const binary = measure(() => v8.deserialize(v8.serialize(samples)));
+const text = measure(() => fromJSON(asJSON()));
+assert.deepStrictEqual(
+  Array.from(binary.result[199].values),
+  Array.from(samples[199].values)
+);
+const binarySize = v8.serialize(samples).length;
+const jsonSize = Buffer.byteLength(asJSON());
+console.log(
+  `v8: ${binarySize} bytes in ${binary.elapsed}ms, ` +
+    `JSON: ${jsonSize} bytes in ${text.elapsed}ms`
+);
+assert.ok(binarySize < jsonSize / 2);
+
+// Test 11: long runs of legacy object-count tags do not exhaust the stack
+const counts = Buffer.alloc(2 + 2 * 1000000 + 1, 0);
+counts[0] = 0xff;
+counts[1] = 0x0f;
+for (let i = 2; i < counts.length - 1; i += 2) {
+  counts[i] = 0x3f; // '?' followed by a zero count
+}
+counts[counts.length - 1] = 0x54; // 'T'
+assert.strictEqual(v8.deserialize(counts), true);
+
+console.log('✓ v8 serialize tests passed');
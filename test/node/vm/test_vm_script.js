@@ -0,0 +1,100 @@
+// Test vm.Script compiled once to bytecode, cachedData, and contexts backed
+// by their own JSContext
+const assert = require('jsrt:assert');
+const vm = require('node:vm');
+
+// Test 1: a Script runs repeatedly without being recompiled
+const counter = new vm.Script(
+  'globalThis.__vmRuns = (globalThis.__vmRuns || 0) + 1'
+);
+for (let i = 0; i < 1000; i++) {
+  counter.runInThisContext();
+}
+assert.strictEqual(globalThis.__vmRuns, 1000);
+delete globalThis.__vmRuns;
+
+// Test 2: syntax errors surface at construction
+assert.throws(() => new vm.Script('let = ;'), SyntaxError);
+
+// Test 3: contexts are isolated from the caller's globals and built-ins
+const sandbox = vm.createContext({ x: 2 });
+assert.ok(vm.isContext(sandbox));
+assert.ok(!vm.isContext({}));
+assert.strictEqual(vm.runInContext('x * 21', sandbox), 42);
+vm.runInContext('var created = x + 1; x = 10;', sandbox);
+assert.strictEqual(sandbox.created, 3);
+assert.strictEqual(sandbox.x, 10);
+assert.strictEqual(typeof globalThis.created, 'undefined');
+assert.notStrictEqual(vm.runInNewContext('Array'), Array);
+assert.strictEqual(vm.runInNewContext('typeof require'), 'undefined');
+Array.prototype.__vmPolluted = true;
+assert.strictEqual(vm.runInNewContext('[].__vmPolluted'), undefined);
+delete Array.prototype.__vmPolluted;
+
+// Test 4: one Script runs in many contexts, each with its own globals
+const script = new vm.Script(
+  'count = (typeof count === "number" ? count : 0) + step; count'
+);
+const a = vm.createContext({ step: 1 });
+const b = vm.createContext({ step: 5 });
+for (let i = 0; i < 3; i++) {
+  script.runInContext(a);
+  script.runInContext(b);
+}
+assert.strictEqual(a.count, 3);
+assert.strictEqual(b.count, 15);
+assert.strictEqual(script.runInNewContext({ count: 1, step: 1 }), 2);
+
+// Test 5: sandbox changes made between runs are seen by the next run
+a.step = 100;
+assert.strictEqual(script.runInContext(a), 103);
+
+// Test 6: exceptions propagate and partial writes reach the sandbox
+const failing = vm.createContext({});
+assert.throws(
+  () => vm.runInContext('before = 1; throw new TypeError("bad")', failing),
+  (err) => err.name === 'TypeError' && err.message === 'bad'
+);
+assert.strictEqual(failing.before, 1);
+
+// Test 7: cachedData round trip
+const source = 'value * 2';
+const producer = new vm.Script(source, { produceCachedData: true });
+assert.strictEqual(producer.cachedDataProduced, true);
+assert.ok(producer.cachedData instanceof Uint8Array);
+const data = producer.createCachedData();
+assert.ok(data.length > 48);
+
+const consumer = new vm.Script(source, { cachedData: data });
+assert.strictEqual(consumer.cachedDataRejected, false);
+assert.strictEqual(consumer.runInNewContext({ value: 21 }), 42);
+
+const mismatch = new vm.Script('value * 3', { cachedData: data });
+assert.strictEqual(mismatch.cachedDataRejected, true);
+assert.strictEqual(mismatch.runInNewContext({ value: 2 }), 6);
+
+const garbage = new vm.Script(source, { cachedData: new Uint8Array(8) });
+assert.strictEqual(garbage.cachedDataRejected, true);
+
+// A corrupted or truncated payload behind an intact header is rejected
+const corrupted = Uint8Array.from(data);
+corrupted[corrupted.length - 1] ^= 0xff;
+const flipped = new vm.Script(source, { cachedData: corrupted });
+assert.strictEqual(flipped.cachedDataRejected, true);
+assert.strictEqual(flipped.runInNewContext({ value: 4 }), 8);
+const cut = data.subarray(0, data.length - 1);
+const truncated = new vm.Script(source, { cachedData: cut });
+assert.strictEqual(truncated.cachedDataRejected, true);
+
+// Test 8: filename option is used in stack traces
+try {
+  const thrower = new vm.Script('throw new Error("x")', {
+    filename: 'rule.js',
+  });
+  thrower.runInNewContext();
+  assert.fail('should throw');
+} catch (err) {
+  assert.ok(String(err.stack).includes('rule.js'), err.stack);
+}
+
+console.log('✓ vm.Script tests passed');
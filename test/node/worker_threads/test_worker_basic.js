@@ -0,0 +1,148 @@
+// Basic worker_threads module tests
+const {
+  Worker,
+  MessageChannel,
+  isMainThread,
+  parentPort,
+  threadId,
+  workerData,
+} = require('node:worker_threads');
+const assert = require('jsrt:assert');
+
+console.log('Testing worker_threads module...');
+
+// Test 1: Main thread identity
+assert.strictEqual(isMainThread, true, 'isMainThread should be true');
+assert.strictEqual(parentPort, null, 'parentPort should be null');
+assert.strictEqual(threadId, 0, 'threadId should be 0 on the main thread');
+assert.strictEqual(workerData, null, 'workerData should be null');
+
+// Test 2: Relative paths must be explicit
+assert.throws(() => new Worker('worker.js'), TypeError);
+
+// Test 3: Round trip with workerData
+const echo = new Worker(
+  `
+  const { parentPort, workerData, isMainThread, threadId } = require('node:worker_threads');
+  parentPort.postMessage({ isMainThread, threadId, workerData });
+  parentPort.on('message', (msg) => {
+    if (msg === 'done') {
+      parentPort.close();
+      return;
+    }
+    parentPort.postMessage({ doubled: msg.map((n) => n * 2) });
+  });
+`,
+  { eval: true, workerData: { name: 'echo', list: [1, 2, 3] } }
+);
+
+let online = false;
+const replies = [];
+echo.on('online', () => {
+  online = true;
+});
+echo.on('message', (msg) => {
+  replies.push(msg);
+  if (replies.length === 1) {
+    echo.postMessage([4, 5]);
+  } else {
+    echo.postMessage('done');
+  }
+});
+echo.on('exit', (code) => {
+  assert.ok(online, 'online should be emitted before exit');
+  assert.strictEqual(code, 0, 'worker should exit cleanly');
+  assert.strictEqual(replies[0].isMainThread, false);
+  assert.strictEqual(replies[0].threadId, echo.threadId);
+  assert.deepStrictEqual(replies[0].workerData, {
+    name: 'echo',
+    list: [1, 2, 3],
+  });
+  assert.deepStrictEqual(replies[1], { doubled: [8, 10] });
+  console.log('✓ message round trip');
+});
+
+// Test 4: process.exit() sets the exit code of the worker only
+const exiting = new Worker('process.exit(7);', { eval: true });
+exiting.on('exit', (code) => {
+  assert.strictEqual(code, 7, 'exit code should come from process.exit');
+  console.log('✓ process.exit in worker');
+});
+
+// Test 5: Uncaught exceptions become 'error' events
+const failing = new Worker('throw new RangeError("boom");', { eval: true });
+let failingError = null;
+failing.on('error', (err) => {
+  failingError = err;
+});
+failing.on('exit', (code) => {
+  assert.strictEqual(code, 1);
+  assert.ok(failingError, 'error event should fire');
+  assert.strictEqual(failingError.message, 'boom');
+  assert.strictEqual(failingError.name, 'RangeError');
+  console.log('✓ error event');
+});
+
+// Test 6: terminate() interrupts a busy worker
+const busy = new Worker(
+  `
+  require('node:worker_threads').parentPort.postMessage('spinning');
+  for (;;) {}
+`,
+  { eval: true }
+);
+busy.once('message', () => {
+  busy.terminate().then((code) => {
+    assert.strictEqual(code, 1, 'terminated worker should report code 1');
+    console.log('✓ terminate');
+  });
+});
+
+// Test 7: MessageChannel delivers asynchronously on the same thread
+const { port1, port2 } = new MessageChannel();
+let delivered = false;
+port2.on('message', (msg) => {
+  delivered = true;
+  assert.deepStrictEqual(msg, { hello: 'world' });
+  port2.close();
+  console.log('✓ MessageChannel');
+});
+port1.postMessage({ hello: 'world' });
+assert.strictEqual(delivered, false, 'delivery should be asynchronous');
+
+// Test 8: process.exit() in a worker cannot be caught
+const uncatchable = new Worker(
+  `
+  const { parentPort } = require('node:worker_threads');
+  try {
+    process.exit(3);
+  } catch (err) {
+    parentPort.postMessage('caught');
+  }
+  parentPort.postMessage('kept running');
+`,
+  { eval: true }
+);
+const afterExit = [];
+uncatchable.on('message', (msg) => afterExit.push(msg));
+uncatchable.on('exit', (code) => {
+  assert.strictEqual(code, 3);
+  assert.deepStrictEqual(afterExit, []);
+  console.log('✓ process.exit is not catchable');
+});
+
+// Test 9: transferred ArrayBuffers arrive as copies and are detached
+const channel = new MessageChannel();
+const moved = new Uint8Array([1, 2, 3]);
+channel.port2.on('message', (msg) => {
+  assert.deepStrictEqual(Array.from(msg), [1, 2, 3]);
+  channel.port2.close();
+  console.log('✓ transferList');
+});
+assert.throws(
+  () => channel.port1.postMessage(null, [channel.port2]),
+  (err) => err.name === 'DataCloneError'
+);
+assert.throws(() => channel.port1.postMessage(null, [{}]));
+channel.port1.postMessage(moved, [moved.buffer]);
+assert.strictEqual(moved.buffer.byteLength, 0);
@@ -0,0 +1,65 @@
+// atob/btoa and Buffer base64 throughput, plus the forgiving-base64 rules
+const assert = require('jsrt:assert');
+const { Buffer } = require('node:buffer');
+
+console.log('Base64 Benchmark\n');
+console.log('='.repeat(50));
+
+// atob: ASCII whitespace anywhere is ignored, padding is optional but exact
+assert.strictEqual(atob(' aG Vs\tbG8=\n'), 'hello');
+assert.strictEqual(atob('aGVsbG8'), 'hello');
+assert.strictEqual(atob('YQ= ='), 'a');
+assert.strictEqual(atob('/w=='), '\xff');
+for (const bad of ['aGVsb', 'YQ=', 'YQ===', 'YWI==', 'YQ==YQ==', 'aG-s']) {
+  assert.throws(() => atob(bad));
+}
+assert.throws(() => btoa('Ā'));
+assert.strictEqual(btoa('\xff\xfe'), '//4=');
+
+// Inputs long enough for the vector kernels, every byte value, all lengths
+const bytes = new Uint8Array(1 << 20);
+for (let i = 0; i < bytes.length; i++) {
+  bytes[i] = (i * 131 + (i >> 8)) & 0xff;
+}
+const buf = Buffer.from(bytes.buffer);
+const latin1 = buf.toString('latin1');
+const b64 = buf.toString('base64');
+const b64url = buf.toString('base64url');
+const toURL = (s) =>
+  s.replace(/\+/g, '-').replace(/\//g, '_').replace(/=/g, '');
+assert.ok(btoa(latin1) === b64, 'btoa matches Buffer');
+assert.ok(atob(b64) === latin1, 'atob matches Buffer');
+assert.ok(b64url === toURL(b64), 'base64url is base64 with the URL alphabet');
+assert.ok(Buffer.from(b64url, 'base64url').equals(buf));
+for (let len = 0; len < 100; len++) {
+  const part = buf.subarray(0, len);
+  const encoded = part.toString('base64');
+  assert.strictEqual(btoa(part.toString('latin1')), encoded);
+  assert.ok(Buffer.from(encoded, 'base64').equals(part));
+}
+const wrapped = b64.slice(0, 4096).replace(/.{76}/g, '$&\r\n');
+assert.strictEqual(atob(wrapped), latin1.slice(0, 3072));
+
+function measure(name, iterations, size, fn) {
+  const start = Date.now();
+  for (let i = 0; i < iterations; i++) {
+    fn();
+  }
+  const elapsed = Math.max(Date.now() - start, 1);
+  const rate = Math.round((iterations * size) / 1024 / 1024 / (elapsed / 1000));
+  const total = `${iterations} x ${size} bytes`;
+  console.log(`  ${name}: ${total} in ${elapsed}ms (${rate} MB/s)`);
+}
+
+measure('btoa', 20, bytes.length, () => btoa(latin1));
+measure('atob', 20, bytes.length, () => atob(b64));
+measure("Buffer toString('base64')", 20, bytes.length, () =>
+  buf.toString('base64')
+);
+measure("Buffer.from(str, 'base64')", 20, bytes.length, () =>
+  Buffer.from(b64, 'base64')
+);
+measure('atob (short strings)', 100000, 12, () => atob('aGVsbG8gd29y'));
+
+console.log('\n' + '='.repeat(50));
+console.log('✓ Base64 benchmark completed');
@@ -0,0 +1,66 @@
+// Test that fetch() reuses keep-alive connections to the same origin
+const assert = require('jsrt:assert');
+const net = require('node:net');
+
+let connections = 0;
+let dropReused = false;
+const methods = [];
+const sockets = [];
+const server = net.createServer((socket) => {
+  connections++;
+  sockets.push(socket);
+  let pending = '';
+  let served = 0;
+  socket.on('data', (chunk) => {
+    pending += chunk.toString();
+    let end;
+    while ((end = pending.indexOf('\r\n\r\n')) !== -1) {
+      const method = pending.slice(0, pending.indexOf(' '));
+      methods.push(method);
+      pending = pending.slice(end + 4);
+      // Once dropping is on, a reused connection goes away like a stale one
+      if (dropReused && served > 0) {
+        socket.destroy();
+        return;
+      }
+      served++;
+      socket.write(
+        'HTTP/1.1 200 OK\r\n' +
+          'Content-Length: 5\r\n' +
+          'Connection: keep-alive\r\n\r\nhello'
+      );
+    }
+  });
+  socket.on('error', () => {});
+});
+
+const timer = setTimeout(() => {
+  throw new Error('Test timeout');
+}, 3000);
+
+server.listen(0, '127.0.0.1', async () => {
+  const url = `http://127.0.0.1:${server.address().port}/`;
+  try {
+    for (let i = 0; i < 3; i++) {
+      const response = await fetch(url);
+      assert.strictEqual(response.status, 200);
+      assert.strictEqual(await response.text(), 'hello');
+    }
+    assert.strictEqual(connections, 1, 'fetch should reuse the connection');
+
+    // A GET on a connection that went stale is retried on a fresh one
+    dropReused = true;
+    const retried = await fetch(url);
+    assert.strictEqual(await retried.text(), 'hello');
+    assert.strictEqual(connections, 2);
+
+    // A POST is never sent twice: the server may have handled it already
+    methods.length = 0;
+    await assert.rejects(fetch(url, { method: 'POST', body: 'once' }));
+    assert.deepStrictEqual(methods, ['POST']);
+  } finally {
+    clearTimeout(timer);
+    sockets.forEach((socket) => socket.destroy());
+    server.close();
+  }
+});
@@ -0,0 +1,178 @@
+// Test that fetch() resolves at the headers and streams the response body
+const assert = require('jsrt:assert');
+const net = require('node:net');
+const process = require('node:process');
+
+const tests = [];
+let testsPassed = 0;
+let testsFailed = 0;
+
+function test(name, fn) {
+  tests.push({ name, fn });
+}
+
+// Raw HTTP server: onRequest(socket) writes the response by hand
+function withServer(onRequest, onListening) {
+  return new Promise((resolve, reject) => {
+    const server = net.createServer((socket) => {
+      socket.on('error', () => {});
+      socket.once('data', () => onRequest(socket));
+    });
+    const timer = setTimeout(() => finish(new Error('Test timeout')), 3000);
+
+    function finish(err) {
+      clearTimeout(timer);
+      server.close();
+      err ? reject(err) : resolve();
+    }
+
+    server.listen(0, '127.0.0.1', () => {
+      const url = `http://127.0.0.1:${server.address().port}/`;
+      onListening(url).then(() => finish(), finish);
+    });
+  });
+}
+
+function chunk(data) {
+  return `${data.length.toString(16)}\r\n${data}\r\n`;
+}
+
+// Test 1: the Response arrives before the body is complete
+test('fetch resolves before the body has arrived', () => {
+  let restSent = false;
+  return withServer(
+    (socket) => {
+      socket.write(
+        'HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n' +
+          'Connection: close\r\n\r\n' +
+          chunk('first')
+      );
+      setTimeout(() => {
+        restSent = true;
+        socket.end(chunk('second') + '0\r\n\r\n');
+      }, 100);
+    },
+    async (url) => {
+      const response = await fetch(url);
+      assert.strictEqual(restSent, false, 'resolved at the headers');
+      assert.strictEqual(response.status, 200);
+      assert.strictEqual(response.headers.get('transfer-encoding'), 'chunked');
+
+      const reader = response.body.getReader();
+      const first = await reader.read();
+      assert.ok(first.value instanceof Uint8Array, 'chunks are bytes');
+      assert.strictEqual(new TextDecoder().decode(first.value), 'first');
+      assert.strictEqual(restSent, false, 'first chunk read early');
+
+      const parts = [];
+      for (;;) {
+        const { value, done } = await reader.read();
+        if (done) {
+          break;
+        }
+        parts.push(new TextDecoder().decode(value));
+      }
+      assert.strictEqual(parts.join(''), 'second');
+    }
+  );
+});
+
+// Test 2: binary bodies survive the stream intact
+test('arrayBuffer() returns the exact bytes', () => {
+  const payload = Buffer.alloc(256);
+  for (let i = 0; i < payload.length; i++) {
+    payload[i] = i;
+  }
+  return withServer(
+    (socket) => {
+      socket.write(
+        'HTTP/1.1 200 OK\r\nContent-Length: 256\r\n' +
+          'Connection: close\r\n\r\n'
+      );
+      socket.end(payload);
+    },
+    async (url) => {
+      const response = await fetch(url);
+      const bytes = new Uint8Array(await response.arrayBuffer());
+      assert.strictEqual(bytes.length, 256);
+      for (let i = 0; i < bytes.length; i++) {
+        assert.strictEqual(bytes[i], i, `byte ${i}`);
+      }
+      assert.strictEqual(response.bodyUsed, true);
+      await assert.rejects(() => response.text());
+    }
+  );
+});
+
+// Test 3: bodies delimited by connection close and json() parsing
+test('json() reads a body that ends with the connection', () => {
+  return withServer(
+    (socket) => {
+      socket.write('HTTP/1.1 200 OK\r\nConnection: close\r\n\r\n{"a":');
+      setTimeout(() => socket.end('[1,2]}'), 20);
+    },
+    async (url) => {
+      const response = await fetch(url);
+      assert.deepStrictEqual(await response.json(), { a: [1, 2] });
+    }
+  );
+});
+
+// Test 4: cancelling the body drops the connection
+test('cancelling the body closes the connection', () => {
+  return new Promise((resolve, reject) => {
+    const server = net.createServer((socket) => {
+      socket.on('error', () => {});
+      socket.on('close', () => {
+        clearTimeout(timer);
+        server.close();
+        resolve();
+      });
+      socket.once('data', () => {
+        socket.write(
+          'HTTP/1.1 200 OK\r\nContent-Length: 1000000\r\n\r\n' +
+            'x'.repeat(1000)
+        );
+      });
+    });
+    const timer = setTimeout(() => {
+      server.close();
+      reject(new Error('Connection was not closed'));
+    }, 3000);
+
+    server.listen(0, '127.0.0.1', async () => {
+      try {
+        const url = `http://127.0.0.1:${server.address().port}/`;
+        const response = await fetch(url);
+        await response.body.cancel();
+      } catch (err) {
+        clearTimeout(timer);
+        server.close();
+        reject(err);
+      }
+    });
+  });
+});
+
+(async () => {
+  for (const { name, fn } of tests) {
+    try {
+      await fn();
+      testsPassed++;
+      console.log(`✓ ${name}`);
+    } catch (err) {
+      testsFailed++;
+      console.log(`FAIL: ${name}`);
+      if (err && err.stack) {
+        console.log(`  ${err.stack}`);
+      } else {
+        console.log(`  ${err}`);
+      }
+    }
+  }
+
+  console.log(`\nTest Results: ${testsPassed} passed, ${testsFailed} failed`);
+  if (testsFailed > 0) {
+    process.exit(1);
+  }
+})();
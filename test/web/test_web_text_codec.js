@@ -0,0 +1,104 @@
+// Test TextEncoder/TextDecoder transcoding: ASCII runs longer than one
+// vector block with non-ASCII text at every offset, UTF-16, windows-1252
+const assert = require('jsrt:assert');
+
+const encoder = new TextEncoder();
+const decoder = new TextDecoder();
+const fatal = new TextDecoder('utf-8', { fatal: true });
+
+// Non-ASCII characters at each position of a long ASCII run
+const filler = 'x'.repeat(100);
+for (const ch of ['é', '€', '世', '\u{1f600}']) {
+  for (let i = 0; i <= 70; i += 7) {
+    const text = filler.slice(0, i) + ch + filler.slice(i);
+    const bytes = encoder.encode(text);
+    assert.strictEqual(bytes.length, 100 + encoder.encode(ch).length);
+    assert.strictEqual(decoder.decode(bytes), text);
+    assert.strictEqual(fatal.decode(bytes), text);
+  }
+}
+
+// Lone surrogates are encoded as U+FFFD
+assert.deepStrictEqual(
+  [...encoder.encode('a\ud800b\udc00')],
+  [0x61, 0xef, 0xbf, 0xbd, 0x62, 0xef, 0xbf, 0xbd]
+);
+
+// fatal mode finds a bad byte after a long ASCII prefix
+for (const bad of [[0xff], [0xc0, 0x80], [0xed, 0xa0, 0x80], [0xe4, 0xb8]]) {
+  const bytes = new Uint8Array([...encoder.encode(filler), ...bad]);
+  assert.throws(() => fatal.decode(bytes), TypeError);
+  assert.ok(decoder.decode(bytes).startsWith(filler), 'replaced, not thrown');
+}
+
+// BOM handling and views with a byte offset
+const withBom = new Uint8Array([0xef, 0xbb, 0xbf, 0x68, 0x69]);
+assert.strictEqual(decoder.decode(withBom), 'hi');
+assert.strictEqual(
+  new TextDecoder('utf-8', { ignoreBOM: true }).decode(withBom),
+  '﻿hi'
+);
+assert.strictEqual(decoder.decode(withBom.subarray(3)), 'hi');
+assert.strictEqual(decoder.decode(new DataView(withBom.buffer, 4)), 'i');
+assert.strictEqual(decoder.decode(withBom.buffer), 'hi');
+assert.throws(() => decoder.decode('not a buffer'), TypeError);
+
+// UTF-16: ASCII runs, surrogate pairs, lone surrogates and BOMs
+const utf16Text = filler + 'é\u{1f600}' + filler;
+const le = new Uint8Array(utf16Text.length * 2);
+const be = new Uint8Array(utf16Text.length * 2);
+for (let i = 0; i < utf16Text.length; i++) {
+  const unit = utf16Text.charCodeAt(i);
+  le[2 * i] = be[2 * i + 1] = unit & 0xff;
+  le[2 * i + 1] = be[2 * i] = unit >> 8;
+}
+assert.strictEqual(new TextDecoder('utf-16le').decode(le), utf16Text);
+assert.strictEqual(new TextDecoder('utf-16be').decode(be), utf16Text);
+assert.strictEqual(
+  new TextDecoder('utf-16le').decode(new Uint8Array([0xff, 0xfe, 0x41, 0])),
+  'A'
+);
+assert.strictEqual(
+  new TextDecoder('utf-16be').decode(new Uint8Array([0xfe, 0xff, 0, 0x41])),
+  'A'
+);
+assert.strictEqual(
+  new TextDecoder('utf-16le').decode(new Uint8Array([0x00, 0xd8, 0x41, 0])),
+  '�A'
+);
+assert.strictEqual(
+  new TextDecoder('utf-16le').decode(new Uint8Array([0x41, 0, 0x42])),
+  'A�'
+);
+assert.throws(
+  () =>
+    new TextDecoder('utf-16le', { fatal: true }).decode(new Uint8Array([1])),
+  TypeError
+);
+
+// windows-1252 (also the latin1 and ascii labels)
+const cp1252 = new TextDecoder('windows-1252');
+assert.strictEqual(new TextDecoder('latin1').encoding, 'windows-1252');
+assert.strictEqual(
+  cp1252.decode(new Uint8Array([0x80, 0x41, 0x93, 0x94, 0xe9, 0xff])),
+  '€A“”éÿ'
+);
+
+// encodeInto stops before a character that does not fit
+const target = new Uint8Array(8);
+const window = target.subarray(2, 7);
+assert.deepStrictEqual(encoder.encodeInto('ab\u{1f600}c', window), {
+  read: 2,
+  written: 2,
+});
+assert.deepStrictEqual(encoder.encodeInto('a\u{1f600}', window), {
+  read: 3,
+  written: 5,
+});
+assert.deepStrictEqual([...target], [0, 0, 0x61, 0xf0, 0x9f, 0x98, 0x80, 0]);
+assert.deepStrictEqual(encoder.encodeInto('\ud800', new Uint8Array(3)), {
+  read: 1,
+  written: 3,
+});
+
+console.log('✓ TextEncoder/TextDecoder transcoding');